@@ -150,6 +150,11 @@ static BaseType_t prvABORTCommand( char *pcWriteBuffer, size_t xWriteBufferLen,
  */
 static BaseType_t prvTESTFSCommand( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 
+/*
+ * Implements the BENCH-FS command.
+ */
+static BaseType_t prvBENCHFSCommand( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+
 
 /* Structure that defines the DIR command line command, which lists all the
 files in the current directory. */
@@ -318,6 +323,16 @@ static const CLI_Command_Definition_t xTEST_FS =
 	0 /* No parameters are expected. */
 };
 
+/* Structure that defines the BENCH-FS command line command, which times some
+file system workloads. */
+static const CLI_Command_Definition_t xBENCH_FS =
+{
+	"bench-fs", /* The command string to type. */
+	"\r\nbench-fs:\r\n Executes file system benchmarks.  ALL FILES WILL BE DELETED!\r\n",
+	prvBENCHFSCommand, /* The function to run. */
+	0 /* No parameters are expected. */
+};
+
 /*-----------------------------------------------------------*/
 
 void vRegisterFileSystemCLICommands( void )
@@ -340,6 +355,7 @@ void vRegisterFileSystemCLICommands( void )
 	FreeRTOS_CLIRegisterCommand( &xTRANSMASKSET );
 	FreeRTOS_CLIRegisterCommand( &xABORT );
 	FreeRTOS_CLIRegisterCommand( &xTEST_FS );
+	FreeRTOS_CLIRegisterCommand( &xBENCH_FS );
 }
 /*-----------------------------------------------------------*/
 
@@ -1463,6 +1479,43 @@ FSSTRESSPARAM param;
 }
 /*-----------------------------------------------------------*/
 
+static BaseType_t prvBENCHFSCommand( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+UBaseType_t uxOriginalPriority;
+FSBENCHPARAM param;
+
+	/* Avoid compiler warnings. */
+	( void ) xWriteBufferLen;
+	( void ) pcCommandString;
+
+	/* As for the TEST-FS command, run at a high priority so the timings are
+	not distorted by switches to the idle task. */
+	uxOriginalPriority = uxTaskPriorityGet( NULL );
+	vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1 );
+
+	/* Start from an empty volume, so results can be compared between builds. */
+	red_umount( "" );
+	red_format( "" );
+	red_mount( "" );
+
+	FsbenchDefaultParams( &param );
+	FsbenchStart( &param );
+
+	/* Clean up after the benchmark. */
+	red_umount( "" );
+	red_format( "" );
+	red_mount( "" );
+
+	/* Reset back to the original priority. */
+	vTaskPrioritySet( NULL, uxOriginalPriority );
+
+	sprintf( pcWriteBuffer, "%s", "Benchmark results were sent to Windows console" );
+	strcat( pcWriteBuffer, cliNEW_LINE );
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvPerformCopy( int32_t lSourceFildes,
 									int32_t lDestinationFiledes,
 									char *pxWriteBuffer,
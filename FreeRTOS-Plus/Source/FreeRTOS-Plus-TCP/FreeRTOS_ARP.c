@@ -200,6 +200,15 @@ BaseType_t xMacEntry = -1;
 BaseType_t xUseEntry = 0;
 uint8_t ucMinAgeFound = 0U;
 
+#if( ipconfigUSE_LOOPBACK != 0 )
+	/* The addresses of this node are not stored, eARPGetCacheEntry() resolves
+	them without using the cache. */
+	if( xIsLoopbackAddress( ulIPAddress ) != pdFALSE )
+	{
+		/* Nothing to do. */
+	}
+	else
+#endif
 #if( ipconfigARP_STORES_REMOTE_ADDRESSES == 0 )
 	/* Only process the IP address if it is on the local network.
 	Unless: when '*ipLOCAL_IP_ADDRESS_POINTER' equals zero, the IP-address
@@ -309,6 +318,14 @@ uint8_t ucMinAgeFound = 0U;
 			}
 		}
 
+		#if( ipconfigUDP_DIRECT_SEND != 0 )
+		{
+			/* FreeRTOS_sendto() may read the cache from a user task, don't let
+			it see a half-written entry. */
+			vTaskSuspendAll();
+		}
+		#endif /* ipconfigUDP_DIRECT_SEND */
+
 		if( xMacEntry >= 0 )
 		{
 			xUseEntry = xMacEntry;
@@ -352,6 +369,12 @@ uint8_t ucMinAgeFound = 0U;
 		{
 			/* Nothing will be stored. */
 		}
+
+		#if( ipconfigUDP_DIRECT_SEND != 0 )
+		{
+			( void ) xTaskResumeAll();
+		}
+		#endif /* ipconfigUDP_DIRECT_SEND */
 	}
 }
 /*-----------------------------------------------------------*/
@@ -410,6 +433,15 @@ ulAddressToLookup = *pulIPAddress;
 		( void ) memcpy( pxMACAddress->ucBytes, xBroadcastMACAddress.ucBytes, sizeof( MACAddress_t ) );
 		eReturn = eARPCacheHit;
 	}
+#if( ipconfigUSE_LOOPBACK != 0 )
+	else if( xIsLoopbackAddress( ulAddressToLookup ) != pdFALSE )
+	{
+		/* The packet will be passed back to the IP-task by xLoopbackOutput(),
+		it is addressed to our own MAC address. */
+		( void ) memcpy( pxMACAddress->ucBytes, ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
+		eReturn = eARPCacheHit;
+	}
+#endif
 	else if( *ipLOCAL_IP_ADDRESS_POINTER == 0UL )
 	{
 		/* The IP address has not yet been assigned, so there is nothing that
@@ -74,6 +74,7 @@
 #define dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE	( 54U )
 #define dhcpIPv4_PARAMETER_REQUEST_OPTION_CODE	( 55U )
 #define dhcpIPv4_CLIENT_IDENTIFIER_OPTION_CODE	( 61U )
+#define dhcpIPv4_RAPID_COMMIT_OPTION_CODE		( 80U )
 
 /* The four DHCP message types of interest. */
 #define dhcpMESSAGE_TYPE_DISCOVER				( 1 )
@@ -189,6 +190,12 @@ static void prvSendDHCPRequest( void );
  */
 static void prvInitialiseDHCP( void );
 
+/*
+ * An ACK was received: start using the offered IP address, and set the timer
+ * to renew the lease.
+ */
+static void prvUseLeasedAddress( void );
+
 /*
  * Creates the part of outgoing DHCP messages that are common to all outgoing
  * DHCP messages.
@@ -217,11 +224,28 @@ static void prvCloseDHCPSocket( void );
 	static void prvPrepareLinkLayerIPLookUp( void );
 #endif
 
+/*
+ * Ask the application for the lease that it stored.  When there is one, the
+ * stored parameters are taken over and pdTRUE is returned.
+ */
+#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+	static BaseType_t prvLoadStoredLease( void );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Hold information in between steps in the DHCP state machine. */
 static DHCPData_t xDHCPData;
 
+#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+	/* A copy of the lease that is in storage, used to avoid writing the same
+	lease again after every renewal. */
+	static DHCPLease_t xStoredLease;
+#endif
+
+/* Convert the ticks spent obtaining an address to milliseconds. */
+#define dhcpTICKS_TO_MS( xTicks )	( ( uint32_t ) ( ( ( uint64_t ) ( xTicks ) * 1000ULL ) / ( uint64_t ) configTICK_RATE_HZ ) )
+
 /*-----------------------------------------------------------*/
 
 BaseType_t xIsDHCPSocket( Socket_t xSocket )
@@ -274,13 +298,33 @@ BaseType_t xGivingUp = pdFALSE;
 				}
 				else
 				{
+					if( ( xReset != pdFALSE ) || ( *ipLOCAL_IP_ADDRESS_POINTER != 0UL ) )
+					{
+						/* Obtaining an address starts now, see ulDHCPTimeToAddress. */
+						EP_DHCPData.xStartTime = xTaskGetTickCount();
+					}
 
 					*ipLOCAL_IP_ADDRESS_POINTER = 0UL;
 
-					/* Send the first discover request. */
-					EP_DHCPData.xDHCPTxTime = xTaskGetTickCount();
-					prvSendDHCPDiscover();
-					EP_DHCPData.eDHCPState = eWaitingOffer;
+				#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+					if( ( xReset != pdFALSE ) && ( prvLoadStoredLease() != pdFALSE ) )
+					{
+						/* INIT-REBOOT: ask to keep the stored address with a
+						request that does not name a server. */
+						EP_DHCPData.xInitReboot = pdTRUE;
+						EP_DHCPData.xDHCPTxTime = xTaskGetTickCount();
+						EP_DHCPData.xDHCPTxPeriod = ipconfigDHCP_INIT_REBOOT_TX_PERIOD;
+						prvSendDHCPRequest();
+						EP_DHCPData.eDHCPState = eWaitingAcknowledge;
+					}
+					else
+				#endif /* ipconfigDHCP_USE_LEASE_STORAGE */
+					{
+						/* Send the first discover request. */
+						EP_DHCPData.xDHCPTxTime = xTaskGetTickCount();
+						prvSendDHCPDiscover();
+						EP_DHCPData.eDHCPState = eWaitingOffer;
+					}
 				}
 			}
 		#if( ipconfigUSE_DHCP_HOOK != 0 )
@@ -311,6 +355,17 @@ BaseType_t xGivingUp = pdFALSE;
 				if( eAnswer == eDHCPContinue )
 			#endif	/* ipconfigUSE_DHCP_HOOK */
 				{
+				#if( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+					if( EP_DHCPData.xRapidCommit != pdFALSE )
+					{
+						/* The server did not make an offer but committed the
+						lease right away. */
+						ipSTATS_INCREMENT( ulDHCPRapidCommits );
+						prvUseLeasedAddress();
+						break;
+					}
+				#endif /* ipconfigDHCP_USE_RAPID_COMMIT */
+
 					/* An offer has been made, the user wants to continue,
 					generate the request. */
 					EP_DHCPData.xDHCPTxTime = xTaskGetTickCount();
@@ -394,46 +449,39 @@ BaseType_t xGivingUp = pdFALSE;
 			/* Look for acks coming in. */
 			if( prvProcessDHCPReplies( dhcpMESSAGE_TYPE_ACK ) == pdPASS )
 			{
-				FreeRTOS_debug_printf( ( "vDHCPProcess: acked %lxip\n", FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
-
-				/* DHCP completed.  The IP address can now be used, and the
-				timer set to the lease timeout time. */
-				*ipLOCAL_IP_ADDRESS_POINTER = EP_DHCPData.ulOfferedIPAddress;
-
-				/* Setting the 'local' broadcast address, something like
-				'192.168.1.255'. */
-				EP_IPv4_SETTINGS.ulBroadcastAddress = ( EP_DHCPData.ulOfferedIPAddress & xNetworkAddressing.ulNetMask ) |  ~xNetworkAddressing.ulNetMask;
-				EP_DHCPData.eDHCPState = eLeasedAddress;
-
-				iptraceDHCP_SUCCEDEED( EP_DHCPData.ulOfferedIPAddress );
-
-				/* DHCP failed, the default configured IP-address will be used
-				Now call vIPNetworkUpCalls() to send the network-up event and
-				start the ARP timer. */
-				vIPNetworkUpCalls();
-
-				/* Close socket to ensure packets don't queue on it. */
-				prvCloseDHCPSocket();
-
-				if( EP_DHCPData.ulLeaseTime == 0UL )
-				{
-					EP_DHCPData.ulLeaseTime = ( uint32_t ) dhcpDEFAULT_LEASE_TIME;
-				}
-				else if( EP_DHCPData.ulLeaseTime < dhcpMINIMUM_LEASE_TIME )
-				{
-					EP_DHCPData.ulLeaseTime = dhcpMINIMUM_LEASE_TIME;
-				}
-				else
+				prvUseLeasedAddress();
+			}
+			else if( EP_DHCPData.eDHCPState == eWaitingSendFirstDiscover )
+			{
+				/* The server answered with a NAK, the address may not be
+				used any longer. */
+				#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
 				{
-					/* The lease time is already valid. */
+					if( xStoredLease.ulIPAddress != 0UL )
+					{
+						( void ) memset( &( xStoredLease ), 0, sizeof( xStoredLease ) );
+						vApplicationDHCPStoreLease( NULL );
+					}
 				}
+				#endif /* ipconfigDHCP_USE_LEASE_STORAGE */
 
-				/* Check for clashes. */
-				vARPSendGratuitous();
-				vIPReloadDHCPTimer( EP_DHCPData.ulLeaseTime );
+				/* Start again without waiting for the DHCP timer. */
+				( void ) xSendEventToIPTask( eDHCPEvent );
 			}
 			else
 			{
+			TickType_t xMaximumPeriod = ( TickType_t ) ipconfigMAXIMUM_DISCOVER_TX_PERIOD;
+
+				#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+				{
+					if( EP_DHCPData.xInitReboot != pdFALSE )
+					{
+						/* A stored lease is not worth waiting long for. */
+						xMaximumPeriod = ( TickType_t ) ipconfigDHCP_INIT_REBOOT_TX_PERIOD << ( ipconfigDHCP_INIT_REBOOT_ATTEMPTS - 1U );
+					}
+				}
+				#endif /* ipconfigDHCP_USE_LEASE_STORAGE */
+
 				/* Is it time to send another Discover? */
 				if( ( xTaskGetTickCount() - EP_DHCPData.xDHCPTxTime ) > EP_DHCPData.xDHCPTxPeriod )
 				{
@@ -441,15 +489,18 @@ BaseType_t xGivingUp = pdFALSE;
 					point of giving up - send another request. */
 					EP_DHCPData.xDHCPTxPeriod <<= 1;
 
-					if( EP_DHCPData.xDHCPTxPeriod <= ( TickType_t ) ipconfigMAXIMUM_DISCOVER_TX_PERIOD )
+					if( EP_DHCPData.xDHCPTxPeriod <= xMaximumPeriod )
 					{
 						EP_DHCPData.xDHCPTxTime = xTaskGetTickCount();
 						prvSendDHCPRequest();
 					}
 					else
 					{
-						/* Give up, start again. */
+						/* Give up, start again without waiting for the DHCP
+						timer. */
+						FreeRTOS_debug_printf( ( "vDHCPProcess: no ACK, start again\n" ) );
 						EP_DHCPData.eDHCPState = eWaitingSendFirstDiscover;
+						( void ) xSendEventToIPTask( eDHCPEvent );
 					}
 				}
 			}
@@ -546,6 +597,110 @@ BaseType_t xGivingUp = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
+static void prvUseLeasedAddress( void )
+{
+	FreeRTOS_debug_printf( ( "vDHCPProcess: acked %lxip\n", FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
+
+	if( *ipLOCAL_IP_ADDRESS_POINTER == 0UL )
+	{
+		/* This is not a renewal, the device had no address until now. */
+		ipSTATS_SET( ulDHCPTimeToAddress, dhcpTICKS_TO_MS( xTaskGetTickCount() - EP_DHCPData.xStartTime ) );
+
+		if( EP_DHCPData.xInitReboot != pdFALSE )
+		{
+			ipSTATS_INCREMENT( ulDHCPInitReboots );
+		}
+	}
+
+	/* From now on, the ACK must come from the server that granted the lease. */
+	EP_DHCPData.xInitReboot = pdFALSE;
+
+	/* DHCP completed.  The IP address can now be used, and the
+	timer set to the lease timeout time. */
+	*ipLOCAL_IP_ADDRESS_POINTER = EP_DHCPData.ulOfferedIPAddress;
+
+	/* Setting the 'local' broadcast address, something like
+	'192.168.1.255'. */
+	EP_IPv4_SETTINGS.ulBroadcastAddress = ( EP_DHCPData.ulOfferedIPAddress & xNetworkAddressing.ulNetMask ) |  ~xNetworkAddressing.ulNetMask;
+	EP_DHCPData.eDHCPState = eLeasedAddress;
+
+	iptraceDHCP_SUCCEDEED( EP_DHCPData.ulOfferedIPAddress );
+
+	/* Now call vIPNetworkUpCalls() to send the network-up event and
+	start the ARP timer. */
+	vIPNetworkUpCalls();
+
+	/* Close socket to ensure packets don't queue on it. */
+	prvCloseDHCPSocket();
+
+	if( EP_DHCPData.ulLeaseTime == 0UL )
+	{
+		EP_DHCPData.ulLeaseTime = ( uint32_t ) dhcpDEFAULT_LEASE_TIME;
+	}
+	else if( EP_DHCPData.ulLeaseTime < dhcpMINIMUM_LEASE_TIME )
+	{
+		EP_DHCPData.ulLeaseTime = dhcpMINIMUM_LEASE_TIME;
+	}
+	else
+	{
+		/* The lease time is already valid. */
+	}
+
+	#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+	{
+	DHCPLease_t xLease;
+
+		xLease.ulIPAddress = EP_DHCPData.ulOfferedIPAddress;
+		xLease.ulNetMask = EP_IPv4_SETTINGS.ulNetMask;
+		xLease.ulGatewayAddress = EP_IPv4_SETTINGS.ulGatewayAddress;
+		xLease.ulDNSServerAddress = EP_IPv4_SETTINGS.ulDNSServerAddress;
+		xLease.ulServerAddress = EP_DHCPData.ulDHCPServerAddress;
+		xLease.ulRenewalTime = EP_DHCPData.ulLeaseTime / ( uint32_t ) configTICK_RATE_HZ;
+
+		if( memcmp( &( xLease ), &( xStoredLease ), sizeof( xLease ) ) != 0 )
+		{
+			( void ) memcpy( &( xStoredLease ), &( xLease ), sizeof( xStoredLease ) );
+			vApplicationDHCPStoreLease( &( xLease ) );
+		}
+	}
+	#endif /* ipconfigDHCP_USE_LEASE_STORAGE */
+
+	/* Check for clashes. */
+	vARPSendGratuitous();
+	vIPReloadDHCPTimer( EP_DHCPData.ulLeaseTime );
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+
+	static BaseType_t prvLoadStoredLease( void )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		( void ) memset( &( xStoredLease ), 0, sizeof( xStoredLease ) );
+
+		if( ( xApplicationDHCPLoadLease( &( xStoredLease ) ) != pdFALSE ) && ( xStoredLease.ulIPAddress != 0UL ) )
+		{
+			FreeRTOS_debug_printf( ( "vDHCPProcess: INIT-REBOOT %lxip\n", FreeRTOS_ntohl( xStoredLease.ulIPAddress ) ) );
+
+			/* The stored parameters are used, unless the ACK brings new ones. */
+			EP_DHCPData.ulOfferedIPAddress = xStoredLease.ulIPAddress;
+			EP_IPv4_SETTINGS.ulNetMask = xStoredLease.ulNetMask;
+			EP_IPv4_SETTINGS.ulGatewayAddress = xStoredLease.ulGatewayAddress;
+			EP_IPv4_SETTINGS.ulDNSServerAddress = xStoredLease.ulDNSServerAddress;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			( void ) memset( &( xStoredLease ), 0, sizeof( xStoredLease ) );
+		}
+
+		return xReturn;
+	}
+
+#endif /* ipconfigDHCP_USE_LEASE_STORAGE */
+/*-----------------------------------------------------------*/
+
 static void prvCloseDHCPSocket( void )
 {
 	if( xDHCPSocket != NULL )
@@ -604,6 +759,8 @@ static void prvInitialiseDHCP( void )
 	if( xApplicationGetRandomNumber( &( EP_DHCPData.ulTransactionId ) ) != pdFALSE )
 	{
 		EP_DHCPData.xUseBroadcast = 0;
+		EP_DHCPData.xInitReboot = pdFALSE;
+		EP_DHCPData.xRapidCommit = pdFALSE;
 		EP_DHCPData.ulOfferedIPAddress = 0UL;
 		EP_DHCPData.ulDHCPServerAddress = 0UL;
 		EP_DHCPData.xDHCPTxPeriod = dhcpINITIAL_DHCP_TX_PERIOD;
@@ -630,6 +787,9 @@ uint8_t ucOptionCode;
 uint32_t ulProcessed, ulParameter;
 BaseType_t xReturn = pdFALSE;
 const uint32_t ulMandatoryOptions = 2UL; /* DHCP server address, and the correct DHCP message type must be present in the options. */
+#if( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+	BaseType_t xIsAck = pdFALSE, xHasRapidCommit = pdFALSE;
+#endif
 
 	/* Passing the address of a pointer (pucUDPPayload) because FREERTOS_ZERO_COPY is used. */
 	lBytes = FreeRTOS_recvfrom( xDHCPSocket, &pucUDPPayload, 0UL, FREERTOS_ZERO_COPY, NULL, NULL );
@@ -741,6 +901,16 @@ const uint32_t ulMandatoryOptions = 2UL; /* DHCP server address, and the correct
 								state machine is expecting. */
 								ulProcessed++;
 							}
+						#if( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+							else if( ( xExpectedMessageType == ( BaseType_t ) dhcpMESSAGE_TYPE_OFFER ) &&
+									 ( pucByte[ uxIndex ] == ( uint8_t ) dhcpMESSAGE_TYPE_ACK ) )
+							{
+								/* An ACK to a DISCOVER, it is only accepted
+								when it also has the Rapid Commit option. */
+								xIsAck = pdTRUE;
+								ulProcessed++;
+							}
+						#endif /* ipconfigDHCP_USE_RAPID_COMMIT */
 							else
 							{
 								if( pucByte[ uxIndex ] == ( uint8_t ) dhcpMESSAGE_TYPE_NACK )
@@ -792,6 +962,14 @@ const uint32_t ulMandatoryOptions = 2UL; /* DHCP server address, and the correct
 									ulProcessed++;
 									EP_DHCPData.ulDHCPServerAddress = ulParameter;
 								}
+								else if( EP_DHCPData.xInitReboot != pdFALSE )
+								{
+									/* The stored lease may have been granted
+									by another server, the one that answers
+									takes it over. */
+									ulProcessed++;
+									EP_DHCPData.ulDHCPServerAddress = ulParameter;
+								}
 								else
 								{
 									/* The ack must come from the expected server. */
@@ -822,6 +1000,15 @@ const uint32_t ulMandatoryOptions = 2UL; /* DHCP server address, and the correct
 							}
 							break;
 
+					#if( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+						case dhcpIPv4_RAPID_COMMIT_OPTION_CODE :
+
+							/* This option has no data, 'uxLength' is zero
+							and 'uxIndex' already points to the next option. */
+							xHasRapidCommit = pdTRUE;
+							break;
+					#endif /* ipconfigDHCP_USE_RAPID_COMMIT */
+
 						default :
 
 							/* Not interested in this field. */
@@ -829,14 +1016,33 @@ const uint32_t ulMandatoryOptions = 2UL; /* DHCP server address, and the correct
 							break;
 					}
 
-					/* Jump over the data to find the next option code. */
+					/* Jump over the data to find the next option code.  A
+					length of zero stops the parsing, except for an option
+					that never carries data, like Rapid Commit. */
 					if( uxLength == 0U )
 					{
+					#if( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+						if( ucOptionCode == ( uint8_t ) dhcpIPv4_RAPID_COMMIT_OPTION_CODE )
+						{
+							continue;
+						}
+					#endif /* ipconfigDHCP_USE_RAPID_COMMIT */
 						break;
 					}
 					uxIndex = uxIndex + uxLength;
 				}
 
+				#if( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+				{
+					if( ( xIsAck != pdFALSE ) && ( xHasRapidCommit == pdFALSE ) )
+					{
+						/* Not a valid answer to a DISCOVER. */
+						ulProcessed = 0UL;
+					}
+					EP_DHCPData.xRapidCommit = xIsAck;
+				}
+				#endif /* ipconfigDHCP_USE_RAPID_COMMIT */
+
 				/* Were all the mandatory options received? */
 				if( ulProcessed >= ulMandatoryOptions )
 				{
@@ -952,11 +1158,35 @@ static const uint8_t ucDHCPRequestOptions[] =
 	dhcpIPv4_SERVER_IP_ADDRESS_OPTION_CODE, 4, 0, 0, 0, 0,				/* The IP address of the DHCP server. */
 	dhcpOPTION_END_BYTE
 };
+#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+	static const uint8_t ucDHCPInitRebootOptions[] =
+	{
+		/* Do not change the ordering without also changing
+		dhcpCLIENT_IDENTIFIER_OFFSET and dhcpREQUESTED_IP_ADDRESS_OFFSET.  In
+		the INIT-REBOOT state, the server identifier must not be sent. */
+		dhcpIPv4_MESSAGE_TYPE_OPTION_CODE, 1, dhcpMESSAGE_TYPE_REQUEST,		/* Message type option. */
+		dhcpIPv4_CLIENT_IDENTIFIER_OPTION_CODE, 7, 1, 0, 0, 0, 0, 0, 0,		/* Client identifier. */
+		dhcpIPv4_REQUEST_IP_ADDRESS_OPTION_CODE, 4, 0, 0, 0, 0,				/* The IP address being requested. */
+		dhcpIPv4_PARAMETER_REQUEST_OPTION_CODE, 3, dhcpIPv4_SUBNET_MASK_OPTION_CODE, dhcpIPv4_GATEWAY_OPTION_CODE, dhcpIPv4_DNS_SERVER_OPTIONS_CODE,	/* Parameter request option. */
+		dhcpOPTION_END_BYTE
+	};
+#endif /* ipconfigDHCP_USE_LEASE_STORAGE */
+const uint8_t *pucOptions = ucDHCPRequestOptions;
 size_t uxOptionsLength = sizeof( ucDHCPRequestOptions );
 
+	#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+	{
+		if( EP_DHCPData.xInitReboot != pdFALSE )
+		{
+			pucOptions = ucDHCPInitRebootOptions;
+			uxOptionsLength = sizeof( ucDHCPInitRebootOptions );
+		}
+	}
+	#endif /* ipconfigDHCP_USE_LEASE_STORAGE */
+
 	pucUDPPayloadBuffer = prvCreatePartDHCPMessage( &xAddress,
 													( BaseType_t ) dhcpREQUEST_OPCODE,
-													ucDHCPRequestOptions,
+													pucOptions,
 													&( uxOptionsLength ) );
 
 	/* Copy in the IP address being requested. */
@@ -964,10 +1194,13 @@ size_t uxOptionsLength = sizeof( ucDHCPRequestOptions );
 					 &( EP_DHCPData.ulOfferedIPAddress ),
 					 sizeof( EP_DHCPData.ulOfferedIPAddress ) );
 
-	/* Copy in the address of the DHCP server being used. */
-	( void ) memcpy( &( pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpDHCP_SERVER_IP_ADDRESS_OFFSET ] ),
-					 &( EP_DHCPData.ulDHCPServerAddress ),
-					 sizeof( EP_DHCPData.ulDHCPServerAddress ) );
+	if( EP_DHCPData.xInitReboot == pdFALSE )
+	{
+		/* Copy in the address of the DHCP server being used. */
+		( void ) memcpy( &( pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpDHCP_SERVER_IP_ADDRESS_OFFSET ] ),
+						 &( EP_DHCPData.ulDHCPServerAddress ),
+						 sizeof( EP_DHCPData.ulDHCPServerAddress ) );
+	}
 
 	FreeRTOS_debug_printf( ( "vDHCPProcess: reply %lxip\n", FreeRTOS_ntohl( EP_DHCPData.ulOfferedIPAddress ) ) );
 	iptraceSENDING_DHCP_REQUEST();
@@ -991,6 +1224,9 @@ static const uint8_t ucDHCPDiscoverOptions[] =
 	dhcpIPv4_MESSAGE_TYPE_OPTION_CODE, 1, dhcpMESSAGE_TYPE_DISCOVER,					/* Message type option. */
 	dhcpIPv4_CLIENT_IDENTIFIER_OPTION_CODE, 7, 1, 0, 0, 0, 0, 0, 0,						/* Client identifier. */
 	dhcpIPv4_PARAMETER_REQUEST_OPTION_CODE, 3, dhcpIPv4_SUBNET_MASK_OPTION_CODE, dhcpIPv4_GATEWAY_OPTION_CODE, dhcpIPv4_DNS_SERVER_OPTIONS_CODE,	/* Parameter request option. */
+#if( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+	dhcpIPv4_RAPID_COMMIT_OPTION_CODE, 0,												/* Rapid Commit option, RFC 4039. */
+#endif
 	dhcpOPTION_END_BYTE
 };
 size_t uxOptionsLength = sizeof( ucDHCPDiscoverOptions );
@@ -1065,3 +1301,10 @@ size_t uxOptionsLength = sizeof( ucDHCPDiscoverOptions );
 /*-----------------------------------------------------------*/
 
 #endif /* ipconfigUSE_DHCP != 0 */
+
+/*-----------------------------------------------------------*/
+
+/* Provide access to private members for testing. */
+#ifdef FREERTOS_ENABLE_UNIT_TESTS
+	#include "freertos_tcp_test_access_dhcp_define.h"
+#endif
@@ -112,18 +112,21 @@ type. */
 	#endif
 #endif
 
-/*
- * Create a socket and bind it to the standard DNS port number.  Return the
- * the created socket - or NULL if the socket could not be created or bound.
- */
-static Socket_t prvCreateDNSSocket( void );
+#if( ipconfigDNS_USE_ASYNC == 0 )
+	/*
+	 * Create a socket and bind it to the standard DNS port number.  Return the
+	 * the created socket - or NULL if the socket could not be created or bound.
+	 */
+	static Socket_t prvCreateDNSSocket( void );
+#endif
 
 /*
  * Create the DNS message in the zero copy buffer passed in the first parameter.
  */
 static size_t prvCreateDNSMessage( uint8_t *pucUDPPayloadBuffer,
 								   const char *pcHostName,
-								   TickType_t uxIdentifier );
+								   TickType_t uxIdentifier,
+								   uint16_t usType );
 
 /*
  * Simple routine that jumps over the NAME field of a resource record.
@@ -141,39 +144,73 @@ static uint32_t prvParseDNSReply( uint8_t *pucUDPPayloadBuffer,
 								  size_t uxBufferLength,
 								  BaseType_t xExpected );
 
-/*
- * Check if hostname is already known. If not, call prvGetHostByName() to send a DNS request.
- */
-#if( ipconfigDNS_USE_CALLBACKS == 1 )
-	static uint32_t prvPrepareLookup( const char *pcHostName,
-									  FOnDNSEvent pCallback,
-									  void *pvSearchID,
-									  TickType_t uxTimeout );
-#else
-	static uint32_t prvPrepareLookup( const char *pcHostName );
-#endif
+#if( ipconfigDNS_USE_ASYNC == 0 )
+	/*
+	 * Check if hostname is already known. If not, call prvGetHostByName() to send a DNS request.
+	 */
+	#if( ipconfigDNS_USE_CALLBACKS == 1 )
+		static uint32_t prvPrepareLookup( const char *pcHostName,
+										  FOnDNSEvent pCallback,
+										  void *pvSearchID,
+										  TickType_t uxTimeout );
+	#else
+		static uint32_t prvPrepareLookup( const char *pcHostName );
+	#endif
 
-/*
- * Prepare and send a message to a DNS server.  'uxReadTimeOut_ticks' will be passed as
- * zero, in case the user has supplied a call-back function.
- */
-static uint32_t prvGetHostByName( const char *pcHostName,
-								  TickType_t uxIdentifier,
-								  TickType_t uxReadTimeOut_ticks );
+	/*
+	 * Prepare and send a message to a DNS server.  'uxReadTimeOut_ticks' will be passed as
+	 * zero, in case the user has supplied a call-back function.
+	 */
+	static uint32_t prvGetHostByName( const char *pcHostName,
+									  TickType_t uxIdentifier,
+									  TickType_t uxReadTimeOut_ticks );
+#endif /* ipconfigDNS_USE_ASYNC == 0 */
 
-#if( ipconfigDNS_USE_CALLBACKS != 0 )
+#if( ipconfigDNS_USE_CALLBACKS != 0 ) && ( ipconfigDNS_USE_ASYNC == 0 )
 	static void vDNSSetCallBack( const char *pcHostName,
 								 void *pvSearchID,
 								 FOnDNSEvent pCallbackFunction,
 								 TickType_t uxTimeout,
 								 TickType_t uxIdentifier );
-#endif	/* ipconfigDNS_USE_CALLBACKS */
 
-#if( ipconfigDNS_USE_CALLBACKS != 0 )
 	static BaseType_t xDNSDoCallback( TickType_t uxIdentifier,
 									  const char *pcName,
 									  uint32_t ulIPAddress );
-#endif	/* ipconfigDNS_USE_CALLBACKS */
+#endif	/* ipconfigDNS_USE_CALLBACKS && !ipconfigDNS_USE_ASYNC */
+
+#if( ipconfigDNS_USE_ASYNC != 0 )
+	/*
+	 * Called by the IP-task for every message that is received on the socket
+	 * of the resolver.
+	 */
+	static BaseType_t prvResolverReceive( Socket_t xSocket,
+										  void *pvData,
+										  size_t uxLength,
+										  const struct freertos_sockaddr *pxFrom,
+										  const struct freertos_sockaddr *pxDest );
+
+	/*
+	 * Read the name at uxOffset in a DNS message, following compression
+	 * pointers.  Returns pdFALSE when the name is malformed or too long.
+	 */
+	static BaseType_t prvReadCompressedName( const uint8_t *pucMessage,
+											 size_t uxLength,
+											 size_t uxOffset,
+											 char *pcName,
+											 size_t uxDestLen );
+
+	/*
+	 * Copy the records of type usType from the answer section, which starts at
+	 * uxOffset, to pxAnswers.  Returns the number of records copied.
+	 */
+	static BaseType_t prvParseAnswers( const uint8_t *pucMessage,
+									   size_t uxLength,
+									   size_t uxOffset,
+									   uint16_t usAnswers,
+									   uint16_t usType,
+									   DNSAnswer_t *pxAnswers,
+									   BaseType_t xMaxAnswers );
+#endif /* ipconfigDNS_USE_ASYNC */
 
 /*
  * The NBNS and the LLMNR protocol share this reply function.
@@ -259,245 +296,1393 @@ struct xDNSTail
 #include "pack_struct_end.h"
 typedef struct xDNSTail DNSTail_t;
 
-/* DNS answer record header. */
-#include "pack_struct_start.h"
-struct xDNSAnswerRecord
-{
-	uint16_t usType;
-	uint16_t usClass;
-	uint32_t ulTTL;
-	uint16_t usDataLength;
-}
-#include "pack_struct_end.h"
-typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
+/* DNS answer record header. */
+#include "pack_struct_start.h"
+struct xDNSAnswerRecord
+{
+	uint16_t usType;
+	uint16_t usClass;
+	uint32_t ulTTL;
+	uint16_t usDataLength;
+}
+#include "pack_struct_end.h"
+typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
+
+#if( ipconfigUSE_LLMNR == 1 )
+
+	#include "pack_struct_start.h"
+	struct xLLMNRAnswer
+	{
+		uint8_t ucNameCode;
+		uint8_t ucNameOffset;   /* The name is not repeated in the answer, only the offset is given with "0xc0 <offs>" */
+		uint16_t usType;
+		uint16_t usClass;
+		uint32_t ulTTL;
+		uint16_t usDataLength;
+		uint32_t ulIPAddress;
+	}
+	#include "pack_struct_end.h"
+	typedef struct xLLMNRAnswer LLMNRAnswer_t;
+
+#endif /* ipconfigUSE_LLMNR == 1 */
+
+#if( ipconfigUSE_NBNS == 1 )
+
+	#include "pack_struct_start.h"
+	struct xNBNSRequest
+	{
+		uint16_t usRequestId;
+		uint16_t usFlags;
+		uint16_t ulRequestCount;
+		uint16_t usAnswerRSS;
+		uint16_t usAuthRSS;
+		uint16_t usAdditionalRSS;
+		uint8_t ucNameSpace;
+		uint8_t ucName[ dnsNBNS_ENCODED_NAME_LENGTH ];
+		uint8_t ucNameZero;
+		uint16_t usType;
+		uint16_t usClass;
+	}
+	#include "pack_struct_end.h"
+	typedef struct xNBNSRequest NBNSRequest_t;
+
+	#include "pack_struct_start.h"
+	struct xNBNSAnswer
+	{
+		uint16_t usType;
+		uint16_t usClass;
+		uint32_t ulTTL;
+		uint16_t usDataLength;
+		uint16_t usNbFlags;     /* NetBIOS flags 0x6000 : IP-address, big-endian */
+		uint32_t ulIPAddress;
+	}
+	#include "pack_struct_end.h"
+	typedef struct xNBNSAnswer NBNSAnswer_t;
+
+	#endif /* ipconfigUSE_NBNS == 1 */
+
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_DNS_CACHE == 1 )
+
+	/* MISRA c 2012 rule 8.7: Below function may be used by 
+	external callees as well			        */
+	uint32_t FreeRTOS_dnslookup( const char *pcHostName )
+	{
+	uint32_t ulIPAddress = 0UL;
+
+		( void ) prvProcessDNSCache( pcHostName, &ulIPAddress, 0, pdTRUE );
+		return ulIPAddress;
+	}
+#endif /* ipconfigUSE_DNS_CACHE == 1 */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigDNS_USE_CALLBACKS == 1 ) && ( ipconfigDNS_USE_ASYNC == 0 )
+
+	typedef struct xDNS_Callback
+	{
+		TickType_t uxRemaningTime;		/* Timeout in ms */
+		FOnDNSEvent pCallbackFunction;	/* Function to be called when the address has been found or when a timeout has beeen reached */
+		TimeOut_t uxTimeoutState;
+		void *pvSearchID;
+		struct xLIST_ITEM xListItem;
+		char pcName[ 1 ];
+	} DNSCallback_t;
+
+	static List_t xCallbackList;
+
+	/* Define FreeRTOS_gethostbyname() as a normal blocking call. */
+	uint32_t FreeRTOS_gethostbyname( const char *pcHostName )
+	{
+		return FreeRTOS_gethostbyname_a( pcHostName, NULL, ( void * ) NULL, 0 );
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Initialise the list of call-back structures. */
+	void vDNSInitialise( void )
+	{
+		vListInitialise( &xCallbackList );
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Iterate through the list of call-back structures and remove
+	old entries which have reached a timeout.
+	As soon as the list hase become empty, the DNS timer will be stopped
+	In case pvSearchID is supplied, the user wants to cancel a DNS request
+	*/
+	void vDNSCheckCallBack( void *pvSearchID )
+	{
+	const ListItem_t * pxIterator;
+	const ListItem_t * xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xCallbackList ) );
+
+		vTaskSuspendAll();
+		{
+			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
+				 pxIterator != xEnd;
+				 )
+			{
+				DNSCallback_t *pxCallback = ipPOINTER_CAST( DNSCallback_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+				/* Move to the next item because we might remove this item */
+				pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator );
+				if( ( pvSearchID != NULL ) && ( pvSearchID == pxCallback->pvSearchID ) )
+				{
+					( void ) uxListRemove( &( pxCallback->xListItem ) );
+					vPortFree( pxCallback );
+				}
+				else if( xTaskCheckForTimeOut( &pxCallback->uxTimeoutState, &pxCallback->uxRemaningTime ) != pdFALSE )
+				{
+					pxCallback->pCallbackFunction( pxCallback->pcName, pxCallback->pvSearchID, 0 );
+					( void ) uxListRemove( &( pxCallback->xListItem ) );
+					vPortFree( pxCallback );
+				}
+				else
+				{
+					/* This call-back is still waiting for a reply or a time-out. */
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
+		{
+			vIPSetDnsTimerEnableState( pdFALSE );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void FreeRTOS_gethostbyname_cancel( void *pvSearchID )
+	{
+		/* _HT_ Should better become a new API call to have the IP-task remove the callback */
+		vDNSCheckCallBack( pvSearchID );
+	}
+	/*-----------------------------------------------------------*/
+
+	/* FreeRTOS_gethostbyname_a() was called along with callback parameters.
+	Store them in a list for later reference. */
+	static void vDNSSetCallBack( const char *pcHostName,
+								 void *pvSearchID,
+								 FOnDNSEvent pCallbackFunction,
+								 TickType_t uxTimeout,
+								 TickType_t uxIdentifier )
+	{
+	size_t lLength = strlen( pcHostName );
+	DNSCallback_t *pxCallback = ipPOINTER_CAST( DNSCallback_t *, pvPortMalloc( sizeof( *pxCallback ) + lLength ) );
+
+		/* Translate from ms to number of clock ticks. */
+		uxTimeout /= portTICK_PERIOD_MS;
+
+		if( pxCallback != NULL )
+		{
+			if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
+			{
+				/* This is the first one, start the DNS timer to check for timeouts */
+				vIPReloadDNSTimer( FreeRTOS_min_uint32( 1000U, uxTimeout ) );
+			}
+
+			( void ) strcpy( pxCallback->pcName, pcHostName );
+			pxCallback->pCallbackFunction = pCallbackFunction;
+			pxCallback->pvSearchID = pvSearchID;
+			pxCallback->uxRemaningTime = uxTimeout;
+			vTaskSetTimeOutState( &pxCallback->uxTimeoutState );
+			listSET_LIST_ITEM_OWNER( &( pxCallback->xListItem ), ipPOINTER_CAST( void *, pxCallback ) );
+			listSET_LIST_ITEM_VALUE( &( pxCallback->xListItem ), uxIdentifier );
+			vTaskSuspendAll();
+			{
+				vListInsertEnd( &xCallbackList, &pxCallback->xListItem );
+			}
+			( void ) xTaskResumeAll();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	/* A DNS reply was received, see if there is any matching entry and
+	call the handler.  Returns pdTRUE if uxIdentifier was recognised. */
+	static BaseType_t xDNSDoCallback( TickType_t uxIdentifier,
+									  const char *pcName,
+									  uint32_t ulIPAddress )
+	{
+	BaseType_t xResult = pdFALSE;
+	const ListItem_t * pxIterator;
+	const ListItem_t * xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xCallbackList ) );
+
+		vTaskSuspendAll();
+		{
+			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
+				 pxIterator != ( const ListItem_t * ) xEnd;
+				 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+			{
+				if( listGET_LIST_ITEM_VALUE( pxIterator ) == uxIdentifier )
+				{
+				DNSCallback_t *pxCallback = ipPOINTER_CAST( DNSCallback_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+					pxCallback->pCallbackFunction( pcName, pxCallback->pvSearchID, ulIPAddress );
+					( void ) uxListRemove( &pxCallback->xListItem );
+					vPortFree( pxCallback );
+
+					if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
+					{
+						/* The list of outstanding requests is empty. No need for periodic polling. */
+						vIPSetDnsTimerEnableState( pdFALSE );
+					}
+
+					xResult = pdTRUE;
+					break;
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+		return xResult;
+	}
+
+#endif /* ( ipconfigDNS_USE_CALLBACKS == 1 ) && ( ipconfigDNS_USE_ASYNC == 0 ) */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigDNS_USE_ASYNC != 0 )
+
+	/* The server that is configured by FreeRTOS_IPInit() or DHCP, plus the
+	servers set with FreeRTOS_dnsservers(). */
+	#define dnsASYNC_SERVER_COUNT		( ipconfigDNS_MAX_SERVERS + 1 )
+
+	/* The period of the DNS timer while queries are outstanding. */
+	#define dnsASYNC_CHECK_TICKS		pdMS_TO_TICKS( 100U )
+
+	/* Fields in the flags of a DNS message, in host byte order. */
+	#define dnsFLAGS_RESPONSE			0x8000U
+	#define dnsFLAGS_TRUNCATED			0x0200U
+	#define dnsFLAGS_RCODE_MASK			0x000FU
+	#define dnsRCODE_NO_ERROR			0U
+	#define dnsRCODE_NAME_ERROR			3U
+
+	/* A malicious message could contain a loop of compression pointers. */
+	#define dnsMAX_NAME_POINTERS		16
+
+	/* A task or a call-back that is waiting for the result of a query. */
+	typedef struct xDNS_WAITER
+	{
+		struct xLIST_ITEM xListItem;	/* Item in the waiter list of the query. */
+		FOnDNSEvent pCallbackFunction;	/* Set by FreeRTOS_gethostbyname_a(). */
+		FOnDNSResult pxResultFunction;	/* Set by FreeRTOS_dnsquery_a(). */
+		SemaphoreHandle_t xSemaphore;	/* Set by a blocking look-up, the waiter lives on the stack of that task. */
+		DNSAnswer_t *pxAnswers;			/* Where a blocking look-up wants the answers. */
+		BaseType_t xMaxAnswers;
+		BaseType_t xCount;				/* The number of answers copied to pxAnswers. */
+		void *pvSearchID;
+		TimeOut_t xTimeOutState;
+		TickType_t uxRemainingTime;
+	} DNSWaiter_t;
+
+	/* A question that has been sent to the DNS servers. */
+	typedef struct xDNS_QUERY
+	{
+		struct xLIST_ITEM xListItem;	/* Item in xQueryList, the value is the identifier. */
+		List_t xWaiterList;
+		uint16_t usType;
+		uint16_t usPort;				/* The DNS or the LLMNR port, in network byte order. */
+		BaseType_t xAttempts;			/* The number of times that the query was sent. */
+		TimeOut_t xRetryState;
+		TickType_t uxRetryTime;
+		uint32_t ulServers[ dnsASYNC_SERVER_COUNT ];	/* The servers that may still give an answer, 0 when unused. */
+		BaseType_t xCount;				/* The number of valid entries in xAnswers. */
+		DNSAnswer_t xAnswers[ ipconfigDNS_ASYNC_MAX_ANSWERS ];
+		char pcName[ ipconfigDNS_ASYNC_NAME_LENGTH ];
+	} DNSQuery_t;
+
+	/* The outstanding queries.  The lists are only changed while the scheduler
+	is suspended.  Queries are created by any task, but they are only freed by
+	the IP-task. */
+	static List_t xQueryList;
+
+	static uint32_t ulExtraDNSServers[ ipconfigDNS_MAX_SERVERS ];
+
+	/* The socket on which all queries are sent and all replies are received.
+	It is created by the IP-task when the network goes up for the first time. */
+	static Socket_t xResolverSocket = NULL;
+
+	/*-----------------------------------------------------------*/
+
+	/* Initialise the resolver, called by the IP-task every time the network
+	goes up. */
+	void vDNSInitialise( void )
+	{
+	Socket_t xSocket;
+	struct freertos_sockaddr xAddress;
+	F_TCP_UDP_Handler_t xHandler;
+	TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
+
+		if( xResolverSocket == NULL )
+		{
+			vListInitialise( &xQueryList );
+
+			xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+
+			if( xSocket != FREERTOS_INVALID_SOCKET )
+			{
+				( void ) memset( &( xHandler ), 0, sizeof( xHandler ) );
+				xHandler.pxOnUDPReceive = prvResolverReceive;
+				( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_UDP_RECV_HANDLER, &( xHandler ), sizeof( xHandler ) );
+				( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, &( uxWriteTimeOut_ticks ), sizeof( TickType_t ) );
+
+				/* The IP-task can not call FreeRTOS_bind(), which waits for
+				the IP-task.  A port number of 0 selects a random port. */
+				xAddress.sin_port = 0U;
+
+				if( vSocketBind( ipPOINTER_CAST( FreeRTOS_Socket_t *, xSocket ), &( xAddress ), sizeof( xAddress ), pdFALSE ) == 0 )
+				{
+					xResolverSocket = xSocket;
+				}
+				else
+				{
+					( void ) vSocketClose( ipPOINTER_CAST( FreeRTOS_Socket_t *, xSocket ) );
+				}
+			}
+
+			if( xResolverSocket == NULL )
+			{
+				FreeRTOS_printf( ( "vDNSInitialise: can not create the resolver socket\n" ) );
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void FreeRTOS_dnsservers( const uint32_t *pulAddresses,
+							  BaseType_t xCount )
+	{
+	BaseType_t xIndex;
+
+		for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigDNS_MAX_SERVERS; xIndex++ )
+		{
+			if( ( pulAddresses != NULL ) && ( xIndex < xCount ) )
+			{
+				ulExtraDNSServers[ xIndex ] = pulAddresses[ xIndex ];
+			}
+			else
+			{
+				ulExtraDNSServers[ xIndex ] = 0UL;
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Fill in the list of distinct servers that will be asked, and return
+	their number. */
+	static BaseType_t prvGetServers( uint32_t *pulServers )
+	{
+	BaseType_t xCount = 0;
+	BaseType_t xIndex, xOther;
+	uint32_t ulAddress;
+
+		( void ) memset( pulServers, 0, sizeof( uint32_t ) * ( size_t ) dnsASYNC_SERVER_COUNT );
+
+		for( xIndex = 0; xIndex < ( BaseType_t ) dnsASYNC_SERVER_COUNT; xIndex++ )
+		{
+			if( xIndex == 0 )
+			{
+				ulAddress = FreeRTOS_GetDNSServerAddress();
+			}
+			else
+			{
+				ulAddress = ulExtraDNSServers[ xIndex - 1 ];
+			}
+
+			if( ulAddress != 0UL )
+			{
+				for( xOther = 0; xOther < xCount; xOther++ )
+				{
+					if( pulServers[ xOther ] == ulAddress )
+					{
+						break;
+					}
+				}
+
+				if( xOther == xCount )
+				{
+					pulServers[ xCount ] = ulAddress;
+					xCount++;
+				}
+			}
+		}
+
+		return xCount;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Send the question to all servers in pulServers.  Called by any task,
+	so the parameters are copies and not the fields of a query. */
+	static void prvSendQuery( const char *pcName,
+							  uint16_t usType,
+							  uint16_t usIdentifier,
+							  uint16_t usPort,
+							  const uint32_t *pulServers )
+	{
+	uint8_t ucMessage[ sizeof( DNSMessage_t ) + ipconfigDNS_ASYNC_NAME_LENGTH + 1U + sizeof( DNSTail_t ) ];
+	struct freertos_sockaddr xAddress;
+	size_t uxLength;
+	BaseType_t xIndex;
+
+		uxLength = prvCreateDNSMessage( ucMessage, pcName, ( TickType_t ) usIdentifier, usType );
+
+		#if( ipconfigUSE_LLMNR == 1 )
+		{
+			if( usPort != ( uint16_t ) dnsDNS_PORT )
+			{
+				/* LLMNR does not use recursion. */
+				( ipPOINTER_CAST( DNSMessage_t *, ucMessage ) )->usFlags = 0;
+			}
+		}
+		#endif /* ipconfigUSE_LLMNR == 1 */
+
+		for( xIndex = 0; xIndex < ( BaseType_t ) dnsASYNC_SERVER_COUNT; xIndex++ )
+		{
+			if( pulServers[ xIndex ] != 0UL )
+			{
+				xAddress.sin_addr = pulServers[ xIndex ];
+				xAddress.sin_port = usPort;
+
+				iptraceSENDING_DNS_REQUEST();
+				( void ) FreeRTOS_sendto( xResolverSocket, ucMessage, uxLength, 0, &( xAddress ), sizeof( xAddress ) );
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Must be called with the scheduler suspended. */
+	static DNSQuery_t *prvFindQuery( uint16_t usIdentifier )
+	{
+	const ListItem_t *pxIterator;
+	const ListItem_t *xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xQueryList ) );
+	DNSQuery_t *pxResult = NULL;
+
+		for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
+			 pxIterator != xEnd;
+			 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+		{
+			if( listGET_LIST_ITEM_VALUE( pxIterator ) == ( TickType_t ) usIdentifier )
+			{
+				pxResult = ipPOINTER_CAST( DNSQuery_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+				break;
+			}
+		}
+
+		return pxResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* DNS names are not case-sensitive. */
+	static BaseType_t prvNameEquals( const char *pcName1,
+									 const char *pcName2 )
+	{
+	size_t uxIndex = 0U;
+	char cChar1, cChar2;
+	BaseType_t xResult;
+
+		for( ;; )
+		{
+			cChar1 = pcName1[ uxIndex ];
+			cChar2 = pcName2[ uxIndex ];
+
+			if( ( cChar1 >= 'A' ) && ( cChar1 <= 'Z' ) )
+			{
+				cChar1 += 'a' - 'A';
+			}
+
+			if( ( cChar2 >= 'A' ) && ( cChar2 <= 'Z' ) )
+			{
+				cChar2 += 'a' - 'A';
+			}
+
+			if( cChar1 != cChar2 )
+			{
+				xResult = pdFALSE;
+				break;
+			}
+
+			if( cChar1 == '\0' )
+			{
+				xResult = pdTRUE;
+				break;
+			}
+
+			uxIndex++;
+		}
+
+		return xResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Must be called with the scheduler suspended. */
+	static DNSQuery_t *prvFindQueryByName( const char *pcName,
+										   uint16_t usType )
+	{
+	const ListItem_t *pxIterator;
+	const ListItem_t *xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xQueryList ) );
+	DNSQuery_t *pxQuery;
+	DNSQuery_t *pxResult = NULL;
+
+		for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
+			 pxIterator != xEnd;
+			 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+		{
+			pxQuery = ipPOINTER_CAST( DNSQuery_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+			if( ( pxQuery->usType == usType ) && ( prvNameEquals( pxQuery->pcName, pcName ) != pdFALSE ) )
+			{
+				pxResult = pxQuery;
+				break;
+			}
+		}
+
+		return pxResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Attach a waiter to the query for pcName and usType, and start a new query
+	if there is none yet.  uxTimeout is in clock ticks, 0 means: wait until the
+	query has ended. */
+	static BaseType_t prvStartLookup( const char *pcName,
+									  uint16_t usType,
+									  DNSWaiter_t *pxWaiter,
+									  TickType_t uxTimeout )
+	{
+	DNSQuery_t *pxQuery;
+	DNSQuery_t *pxNewQuery = NULL;
+	uint32_t ulServers[ dnsASYNC_SERVER_COUNT ];
+	uint32_t ulNumber = 0UL;
+	uint16_t usPort = ( uint16_t ) dnsDNS_PORT;
+	uint16_t usIdentifier = 0U;
+	BaseType_t xSend = pdFALSE;
+	BaseType_t xReturn = pdFAIL;
+	size_t uxNameLength = strlen( pcName );
+
+		if( ( xResolverSocket != NULL ) && ( uxNameLength > 0U ) && ( uxNameLength < ( size_t ) ipconfigDNS_ASYNC_NAME_LENGTH ) )
+		{
+			#if( ipconfigUSE_LLMNR == 1 )
+			if( strchr( pcName, ( int ) '.' ) == NULL )
+			{
+				/* A name without a dot is looked up with LLMNR. */
+				( void ) memset( ulServers, 0, sizeof( ulServers ) );
+				ulServers[ 0 ] = ipLLMNR_IP_ADDR;
+				usPort = FreeRTOS_ntohs( ipLLMNR_PORT );
+			}
+			else
+			#endif /* ipconfigUSE_LLMNR == 1 */
+			{
+				( void ) prvGetServers( ulServers );
+			}
+
+			/* A new query is prepared, in case no query for this name is
+			outstanding yet. */
+			if( ( ulServers[ 0 ] != 0UL ) && ( xApplicationGetRandomNumber( &( ulNumber ) ) != pdFALSE ) )
+			{
+				pxNewQuery = ipPOINTER_CAST( DNSQuery_t *, pvPortMalloc( sizeof( *pxNewQuery ) ) );
+			}
+		}
+
+		if( pxNewQuery != NULL )
+		{
+			( void ) memset( pxNewQuery, 0, sizeof( *pxNewQuery ) );
+			( void ) strcpy( pxNewQuery->pcName, pcName );
+			pxNewQuery->usType = usType;
+			pxNewQuery->usPort = usPort;
+			pxNewQuery->xAttempts = 1;
+			pxNewQuery->uxRetryTime = pdMS_TO_TICKS( ipconfigDNS_ASYNC_RETRY_MS );
+			vTaskSetTimeOutState( &( pxNewQuery->xRetryState ) );
+			( void ) memcpy( pxNewQuery->ulServers, ulServers, sizeof( ulServers ) );
+			vListInitialise( &( pxNewQuery->xWaiterList ) );
+			listSET_LIST_ITEM_OWNER( &( pxNewQuery->xListItem ), ipPOINTER_CAST( void *, pxNewQuery ) );
+
+			pxWaiter->uxRemainingTime = ( uxTimeout != 0U ) ? uxTimeout : portMAX_DELAY;
+			vTaskSetTimeOutState( &( pxWaiter->xTimeOutState ) );
+			listSET_LIST_ITEM_OWNER( &( pxWaiter->xListItem ), ipPOINTER_CAST( void *, pxWaiter ) );
+
+			vTaskSuspendAll();
+			{
+				pxQuery = prvFindQueryByName( pcName, usType );
+
+				/* The statistics may be updated here because the IP-task can
+				not run while the scheduler is suspended. */
+				if( pxQuery == NULL )
+				{
+					/* DNS identifiers are 16-bit. */
+					usIdentifier = ( uint16_t ) ulNumber;
+
+					while( prvFindQuery( usIdentifier ) != NULL )
+					{
+						usIdentifier++;
+					}
+
+					if( listLIST_IS_EMPTY( &xQueryList ) != pdFALSE )
+					{
+						/* This is the first one, start the DNS timer. */
+						vIPReloadDNSTimer( dnsASYNC_CHECK_TICKS );
+					}
+
+					listSET_LIST_ITEM_VALUE( &( pxNewQuery->xListItem ), ( TickType_t ) usIdentifier );
+					vListInsertEnd( &xQueryList, &( pxNewQuery->xListItem ) );
+					pxQuery = pxNewQuery;
+					pxNewQuery = NULL;
+					xSend = pdTRUE;
+					ipSTATS_INCREMENT( ulDNSQueries );
+				}
+				else
+				{
+					/* The same question has already been asked. */
+					ipSTATS_INCREMENT( ulDNSQueriesCoalesced );
+				}
+
+				vListInsertEnd( &( pxQuery->xWaiterList ), &( pxWaiter->xListItem ) );
+			}
+			( void ) xTaskResumeAll();
+
+			if( pxNewQuery != NULL )
+			{
+				vPortFree( pxNewQuery );
+			}
+
+			if( xSend != pdFALSE )
+			{
+				prvSendQuery( pcName, usType, usIdentifier, usPort, ulServers );
+			}
+
+			xReturn = pdPASS;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Tell the waiters of a query about the result, either all waiters or only
+	the ones whose time-out has expired.  The answers of the query are only
+	passed when xCount is non-zero.  Called by the IP-task. */
+	static void prvWakeWaiters( DNSQuery_t *pxQuery,
+								BaseType_t xCount,
+								BaseType_t xExpiredOnly )
+	{
+	const ListItem_t *pxIterator;
+	const ListItem_t *xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &( pxQuery->xWaiterList ) ) );
+	DNSWaiter_t *pxWaiter;
+	DNSWaiter_t *pxCallWaiter;
+	uint32_t ulIPAddress;
+	BaseType_t xIndex;
+
+		ulIPAddress = ( ( xCount != 0 ) && ( pxQuery->usType == ( uint16_t ) ipDNS_TYPE_A ) ) ? pxQuery->xAnswers[ 0 ].u.ulIPAddress : 0UL;
+
+		/* The user call-backs are called without suspending the scheduler,
+		so the list is searched again after each call. */
+		do
+		{
+			pxCallWaiter = NULL;
+
+			vTaskSuspendAll();
+			{
+				pxIterator = ( const ListItem_t * ) listGET_NEXT( xEnd );
+
+				while( pxIterator != xEnd )
+				{
+					pxWaiter = ipPOINTER_CAST( DNSWaiter_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+					pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator );
+
+					if( ( xExpiredOnly == pdFALSE ) ||
+						( xTaskCheckForTimeOut( &( pxWaiter->xTimeOutState ), &( pxWaiter->uxRemainingTime ) ) != pdFALSE ) )
+					{
+						( void ) uxListRemove( &( pxWaiter->xListItem ) );
+
+						if( pxWaiter->xSemaphore != NULL )
+						{
+							/* A task is blocked in prvBlockingLookup(). */
+							for( xIndex = 0; ( xIndex < xCount ) && ( xIndex < pxWaiter->xMaxAnswers ); xIndex++ )
+							{
+								( void ) memcpy( &( pxWaiter->pxAnswers[ xIndex ] ), &( pxQuery->xAnswers[ xIndex ] ), sizeof( DNSAnswer_t ) );
+							}
+
+							pxWaiter->xCount = xIndex;
+							( void ) xSemaphoreGive( pxWaiter->xSemaphore );
+						}
+						else
+						{
+							pxCallWaiter = pxWaiter;
+							break;
+						}
+					}
+				}
+			}
+			( void ) xTaskResumeAll();
+
+			if( pxCallWaiter != NULL )
+			{
+				if( pxCallWaiter->pxResultFunction != NULL )
+				{
+					pxCallWaiter->pxResultFunction( pxQuery->pcName, pxCallWaiter->pvSearchID, xCount, pxQuery->xAnswers );
+				}
+				else
+				{
+					pxCallWaiter->pCallbackFunction( pxQuery->pcName, pxCallWaiter->pvSearchID, ulIPAddress );
+				}
+
+				vPortFree( pxCallWaiter );
+			}
+		} while( pxCallWaiter != NULL );
+	}
+	/*-----------------------------------------------------------*/
+
+	/* The query has ended, remove it and inform all its waiters.  Called by
+	the IP-task. */
+	static void prvEndQuery( DNSQuery_t *pxQuery )
+	{
+		vTaskSuspendAll();
+		{
+			( void ) uxListRemove( &( pxQuery->xListItem ) );
+
+			if( listLIST_IS_EMPTY( &xQueryList ) != pdFALSE )
+			{
+				/* No more need for periodic checks. */
+				vIPSetDnsTimerEnableState( pdFALSE );
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		prvWakeWaiters( pxQuery, pxQuery->xCount, pdFALSE );
+		vPortFree( pxQuery );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCancelLookup( void *pvSearchID )
+	{
+	const ListItem_t *pxQueryIterator;
+	const ListItem_t *pxIterator;
+	const ListItem_t *xQueryEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xQueryList ) );
+	const ListItem_t *xEnd;
+	DNSQuery_t *pxQuery;
+	DNSWaiter_t *pxWaiter;
+
+		/* A query that loses all its waiters will be removed by the IP-task. */
+		vTaskSuspendAll();
+		{
+			for( pxQueryIterator  = ( const ListItem_t * ) listGET_NEXT( xQueryEnd );
+				 pxQueryIterator != xQueryEnd;
+				 pxQueryIterator  = ( const ListItem_t * ) listGET_NEXT( pxQueryIterator ) )
+			{
+				pxQuery = ipPOINTER_CAST( DNSQuery_t *, listGET_LIST_ITEM_OWNER( pxQueryIterator ) );
+				xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &( pxQuery->xWaiterList ) ) );
+
+				for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
+					 pxIterator != xEnd;
+					 )
+				{
+					pxWaiter = ipPOINTER_CAST( DNSWaiter_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+					/* Move to the next item because we might remove this item */
+					pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator );
+
+					if( ( pxWaiter->pvSearchID == pvSearchID ) && ( pxWaiter->xSemaphore == NULL ) )
+					{
+						( void ) uxListRemove( &( pxWaiter->xListItem ) );
+						vPortFree( pxWaiter );
+					}
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Send queries again, and end the ones that have run out of attempts or
+	waiters.  In case pvSearchID is supplied, the user wants to cancel the
+	look-ups with that ID. */
+	void vDNSCheckCallBack( void *pvSearchID )
+	{
+	const ListItem_t *pxIterator;
+	const ListItem_t *xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xQueryList ) );
+	DNSQuery_t *pxQuery;
+	BaseType_t xEnded;
+
+		if( pvSearchID != NULL )
+		{
+			prvCancelLookup( pvSearchID );
+		}
+		else
+		{
+			/* Only the IP-task removes queries, so the iterator remains
+			valid while the scheduler is running. */
+			vTaskSuspendAll();
+			{
+				pxIterator = ( const ListItem_t * ) listGET_NEXT( xEnd );
+			}
+			( void ) xTaskResumeAll();
+
+			while( pxIterator != xEnd )
+			{
+				pxQuery = ipPOINTER_CAST( DNSQuery_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+				vTaskSuspendAll();
+				{
+					pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator );
+				}
+				( void ) xTaskResumeAll();
+
+				/* Waiters with a shorter time-out than the query. */
+				prvWakeWaiters( pxQuery, 0, pdTRUE );
+				xEnded = pdFALSE;
+
+				if( xTaskCheckForTimeOut( &( pxQuery->xRetryState ), &( pxQuery->uxRetryTime ) ) != pdFALSE )
+				{
+					if( pxQuery->xAttempts < ( BaseType_t ) ipconfigDNS_REQUEST_ATTEMPTS )
+					{
+						/* Double the time for every next attempt. */
+						pxQuery->uxRetryTime = pdMS_TO_TICKS( ipconfigDNS_ASYNC_RETRY_MS ) << pxQuery->xAttempts;
+						pxQuery->xAttempts++;
+						vTaskSetTimeOutState( &( pxQuery->xRetryState ) );
+						ipSTATS_INCREMENT( ulDNSRetransmissions );
+
+						prvSendQuery( pxQuery->pcName,
+									  pxQuery->usType,
+									  ( uint16_t ) listGET_LIST_ITEM_VALUE( &( pxQuery->xListItem ) ),
+									  pxQuery->usPort,
+									  pxQuery->ulServers );
+					}
+					else
+					{
+						xEnded = pdTRUE;
+					}
+				}
+
+				if( xEnded == pdFALSE )
+				{
+					vTaskSuspendAll();
+					{
+						xEnded = listLIST_IS_EMPTY( &( pxQuery->xWaiterList ) );
+					}
+					( void ) xTaskResumeAll();
+				}
+
+				if( xEnded != pdFALSE )
+				{
+					/* xCount is still zero: the query has failed. */
+					prvEndQuery( pxQuery );
+				}
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void FreeRTOS_gethostbyname_cancel( void *pvSearchID )
+	{
+		vDNSCheckCallBack( pvSearchID );
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvReadCompressedName( const uint8_t *pucMessage,
+											 size_t uxLength,
+											 size_t uxOffset,
+											 char *pcName,
+											 size_t uxDestLen )
+	{
+	size_t uxIndex = uxOffset;
+	size_t uxNameLength = 0U;
+	size_t uxCount;
+	BaseType_t xPointers = 0;
+	BaseType_t xReturn = pdFALSE;
+
+		while( uxIndex < uxLength )
+		{
+			uxCount = ( size_t ) pucMessage[ uxIndex ];
+
+			if( uxCount == 0U )
+			{
+				pcName[ uxNameLength ] = '\0';
+				xReturn = pdTRUE;
+				break;
+			}
+			else if( ( pucMessage[ uxIndex ] & dnsNAME_IS_OFFSET ) == dnsNAME_IS_OFFSET )
+			{
+				/* A pointer must point backwards, so following pointers
+				always ends. */
+				if( ( ( uxIndex + 1U ) >= uxLength ) || ( xPointers >= dnsMAX_NAME_POINTERS ) )
+				{
+					break;
+				}
+
+				uxCount = ( ( uxCount & 0x3FU ) << 8 ) | ( size_t ) pucMessage[ uxIndex + 1U ];
+
+				if( uxCount >= uxIndex )
+				{
+					break;
+				}
+
+				uxIndex = uxCount;
+				xPointers++;
+			}
+			else if( ( pucMessage[ uxIndex ] & dnsNAME_IS_OFFSET ) != 0U )
+			{
+				/* Reserved label type. */
+				break;
+			}
+			else
+			{
+				/* Room for the label, a dot and the null terminator. */
+				if( ( ( uxIndex + 1U + uxCount ) > uxLength ) || ( ( uxNameLength + uxCount + 2U ) > uxDestLen ) )
+				{
+					break;
+				}
+
+				if( uxNameLength > 0U )
+				{
+					pcName[ uxNameLength ] = '.';
+					uxNameLength++;
+				}
+
+				( void ) memcpy( &( pcName[ uxNameLength ] ), &( pucMessage[ uxIndex + 1U ] ), uxCount );
+				uxNameLength += uxCount;
+				uxIndex += uxCount + 1U;
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvParseAnswers( const uint8_t *pucMessage,
+									   size_t uxLength,
+									   size_t uxOffset,
+									   uint16_t usAnswers,
+									   uint16_t usType,
+									   DNSAnswer_t *pxAnswers,
+									   BaseType_t xMaxAnswers )
+	{
+	const DNSAnswerRecord_t *pxRecord;
+	const uint8_t *pucData;
+	DNSAnswer_t *pxAnswer;
+	size_t uxIndex = uxOffset;
+	size_t uxResult;
+	uint16_t x, usRecordType, usDataLength;
+	BaseType_t xCount = 0;
+	BaseType_t xValid;
+
+		for( x = 0U; ( x < usAnswers ) && ( xCount < xMaxAnswers ) && ( uxIndex < uxLength ); x++ )
+		{
+			uxResult = prvSkipNameField( &( pucMessage[ uxIndex ] ), uxLength - uxIndex );
+
+			if( ( uxResult == 0U ) || ( ( uxLength - uxIndex - uxResult ) < sizeof( DNSAnswerRecord_t ) ) )
+			{
+				break;
+			}
+
+			uxIndex += uxResult;
+			pxRecord = ipPOINTER_CAST( const DNSAnswerRecord_t *, &( pucMessage[ uxIndex ] ) );
+			usRecordType = FreeRTOS_ntohs( pxRecord->usType );
+			usDataLength = FreeRTOS_ntohs( pxRecord->usDataLength );
+			uxIndex += sizeof( DNSAnswerRecord_t );
+
+			if( ( uxLength - uxIndex ) < ( size_t ) usDataLength )
+			{
+				break;
+			}
+
+			pucData = &( pucMessage[ uxIndex ] );
+
+			/* Records of other types, such as the CNAME records that lead to
+			the answer, are skipped. */
+			if( usRecordType == usType )
+			{
+				pxAnswer = &( pxAnswers[ xCount ] );
+				pxAnswer->usType = usType;
+				pxAnswer->ulTTL = FreeRTOS_ntohl( pxRecord->ulTTL );
+				xValid = pdFALSE;
+
+				switch( usType )
+				{
+					case ipDNS_TYPE_A:
+						if( usDataLength == ( uint16_t ) ipSIZE_OF_IPv4_ADDRESS )
+						{
+							( void ) memcpy( &( pxAnswer->u.ulIPAddress ), pucData, ipSIZE_OF_IPv4_ADDRESS );
+							xValid = pdTRUE;
+						}
+						break;
+
+				#if( ipconfigUSE_IPv6 != 0 )
+					case ipDNS_TYPE_AAAA:
+						if( usDataLength == ( uint16_t ) ipSIZE_OF_IPv6_ADDRESS )
+						{
+							( void ) memcpy( pxAnswer->u.xIPv6Address.ucBytes, pucData, ipSIZE_OF_IPv6_ADDRESS );
+							xValid = pdTRUE;
+						}
+						break;
+				#endif /* ipconfigUSE_IPv6 */
+
+					case ipDNS_TYPE_SRV:
+						/* Priority, weight and port, followed by the target,
+						which may be compressed. */
+						if( ( usDataLength > ( uint16_t ) ( 3U * sizeof( uint16_t ) ) ) &&
+							( prvReadCompressedName( pucMessage,
+													 uxIndex + ( size_t ) usDataLength,
+													 uxIndex + ( 3U * sizeof( uint16_t ) ),
+													 pxAnswer->u.xService.pcTarget,
+													 sizeof( pxAnswer->u.xService.pcTarget ) ) != pdFALSE ) )
+						{
+							pxAnswer->u.xService.usPriority = usChar2u16( pucData );
+							pxAnswer->u.xService.usWeight = usChar2u16( &( pucData[ 2 ] ) );
+							pxAnswer->u.xService.usPort = usChar2u16( &( pucData[ 4 ] ) );
+							xValid = pdTRUE;
+						}
+						break;
+
+					default:
+						/* Not a supported type. */
+						break;
+				}
+
+				if( xValid != pdFALSE )
+				{
+					xCount++;
+				}
+			}
+
+			uxIndex += ( size_t ) usDataLength;
+		}
+
+		return xCount;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* A message was received on the resolver socket.  Called by the IP-task. */
+	static void prvHandleAsyncReply( const uint8_t *pucMessage,
+									 size_t uxLength,
+									 const struct freertos_sockaddr *pxFrom )
+	{
+	const DNSMessage_t *pxHeader = ipPOINTER_CAST( const DNSMessage_t *, pucMessage );
+	DNSQuery_t *pxQuery;
+	char pcName[ ipconfigDNS_ASYNC_NAME_LENGTH ];
+	size_t uxOffset, uxResult;
+	uint16_t usFlags, usRcode, usType;
+	BaseType_t xServer = -1;
+	BaseType_t xIndex;
+	BaseType_t xEnded = pdFALSE;
+
+		if( uxLength < sizeof( DNSMessage_t ) )
+		{
+			return;
+		}
+
+		usFlags = FreeRTOS_ntohs( pxHeader->usFlags );
+
+		if( ( ( usFlags & dnsFLAGS_RESPONSE ) == 0U ) || ( FreeRTOS_ntohs( pxHeader->usQuestions ) != 1U ) )
+		{
+			return;
+		}
+
+		/* Only the IP-task frees queries, the pointer remains valid after
+		resuming the scheduler. */
+		vTaskSuspendAll();
+		{
+			pxQuery = prvFindQuery( pxHeader->usIdentifier );
+		}
+		( void ) xTaskResumeAll();
+
+		if( ( pxQuery == NULL ) || ( pxFrom->sin_port != pxQuery->usPort ) )
+		{
+			return;
+		}
+
+		if( pxQuery->usPort != ( uint16_t ) dnsDNS_PORT )
+		{
+			/* An LLMNR query was multicast, any host may answer. */
+			xServer = 0;
+		}
+		else
+		{
+			for( xIndex = 0; xIndex < ( BaseType_t ) dnsASYNC_SERVER_COUNT; xIndex++ )
+			{
+				if( ( pxQuery->ulServers[ xIndex ] != 0UL ) && ( pxQuery->ulServers[ xIndex ] == pxFrom->sin_addr ) )
+				{
+					xServer = xIndex;
+					break;
+				}
+			}
+		}
+
+		if( xServer < 0 )
+		{
+			/* Not from a server that was asked, or from a server that has
+			already given up. */
+			return;
+		}
+
+		/* The question must be the one that was asked. */
+		uxOffset = sizeof( DNSMessage_t );
+		uxResult = prvReadNameField( &( pucMessage[ uxOffset ] ), uxLength - uxOffset, pcName, sizeof( pcName ) );
+
+		if( ( uxResult == 0U ) || ( ( uxLength - uxOffset - uxResult ) < sizeof( DNSTail_t ) ) )
+		{
+			return;
+		}
+
+		uxOffset += uxResult;
+		usType = usChar2u16( &( pucMessage[ uxOffset ] ) );
+		uxOffset += sizeof( DNSTail_t );
+
+		if( ( usType != pxQuery->usType ) || ( prvNameEquals( pcName, pxQuery->pcName ) == pdFALSE ) )
+		{
+			return;
+		}
+
+		usRcode = usFlags & dnsFLAGS_RCODE_MASK;
 
-#if( ipconfigUSE_LLMNR == 1 )
+		if( usRcode == dnsRCODE_NO_ERROR )
+		{
+			pxQuery->xCount = prvParseAnswers( pucMessage,
+											   uxLength,
+											   uxOffset,
+											   FreeRTOS_ntohs( pxHeader->usAnswers ),
+											   pxQuery->usType,
+											   pxQuery->xAnswers,
+											   ( BaseType_t ) ipconfigDNS_ASYNC_MAX_ANSWERS );
+		}
 
-	#include "pack_struct_start.h"
-	struct xLLMNRAnswer
-	{
-		uint8_t ucNameCode;
-		uint8_t ucNameOffset;   /* The name is not repeated in the answer, only the offset is given with "0xc0 <offs>" */
-		uint16_t usType;
-		uint16_t usClass;
-		uint32_t ulTTL;
-		uint16_t usDataLength;
-		uint32_t ulIPAddress;
-	}
-	#include "pack_struct_end.h"
-	typedef struct xLLMNRAnswer LLMNRAnswer_t;
+		if( ( pxQuery->xCount != 0 ) ||
+			( ( usRcode == dnsRCODE_NO_ERROR ) && ( ( usFlags & dnsFLAGS_TRUNCATED ) == 0U ) ) ||
+			( usRcode == dnsRCODE_NAME_ERROR ) )
+		{
+			/* A conclusive answer, the first one wins the race. */
+			xEnded = pdTRUE;
+		}
+		else
+		{
+			/* This server can not help, e.g. it failed or the reply was
+			truncated.  Retrying over TCP is not supported, the other servers
+			may still answer. */
+			pxQuery->ulServers[ xServer ] = 0UL;
+			xEnded = pdTRUE;
 
-#endif /* ipconfigUSE_LLMNR == 1 */
+			for( xIndex = 0; xIndex < ( BaseType_t ) dnsASYNC_SERVER_COUNT; xIndex++ )
+			{
+				if( pxQuery->ulServers[ xIndex ] != 0UL )
+				{
+					xEnded = pdFALSE;
+					break;
+				}
+			}
+		}
 
-#if( ipconfigUSE_NBNS == 1 )
+		if( xEnded != pdFALSE )
+		{
+			#if( ipconfigUSE_DNS_CACHE == 1 )
+			{
+				for( xIndex = 0; xIndex < pxQuery->xCount; xIndex++ )
+				{
+					if( pxQuery->xAnswers[ xIndex ].usType == ( uint16_t ) ipDNS_TYPE_A )
+					{
+						/* The cache keeps the TTL in network byte order. */
+						( void ) prvProcessDNSCache( pxQuery->pcName,
+													 &( pxQuery->xAnswers[ xIndex ].u.ulIPAddress ),
+													 FreeRTOS_htonl( pxQuery->xAnswers[ xIndex ].ulTTL ),
+													 pdFALSE );
+					}
+				}
+			}
+			#endif /* ipconfigUSE_DNS_CACHE */
 
-	#include "pack_struct_start.h"
-	struct xNBNSRequest
-	{
-		uint16_t usRequestId;
-		uint16_t usFlags;
-		uint16_t ulRequestCount;
-		uint16_t usAnswerRSS;
-		uint16_t usAuthRSS;
-		uint16_t usAdditionalRSS;
-		uint8_t ucNameSpace;
-		uint8_t ucName[ dnsNBNS_ENCODED_NAME_LENGTH ];
-		uint8_t ucNameZero;
-		uint16_t usType;
-		uint16_t usClass;
+			FreeRTOS_debug_printf( ( "DNS[0x%04X]: '%s' type %u: %ld answer(s)\n",
+									 ( unsigned ) pxHeader->usIdentifier,
+									 pxQuery->pcName,
+									 ( unsigned ) pxQuery->usType,
+									 ( long ) pxQuery->xCount ) );
+			prvEndQuery( pxQuery );
+		}
 	}
-	#include "pack_struct_end.h"
-	typedef struct xNBNSRequest NBNSRequest_t;
+	/*-----------------------------------------------------------*/
 
-	#include "pack_struct_start.h"
-	struct xNBNSAnswer
+	static BaseType_t prvResolverReceive( Socket_t xSocket,
+										  void *pvData,
+										  size_t uxLength,
+										  const struct freertos_sockaddr *pxFrom,
+										  const struct freertos_sockaddr *pxDest )
 	{
-		uint16_t usType;
-		uint16_t usClass;
-		uint32_t ulTTL;
-		uint16_t usDataLength;
-		uint16_t usNbFlags;     /* NetBIOS flags 0x6000 : IP-address, big-endian */
-		uint32_t ulIPAddress;
-	}
-	#include "pack_struct_end.h"
-	typedef struct xNBNSAnswer NBNSAnswer_t;
-
-	#endif /* ipconfigUSE_NBNS == 1 */
+		( void ) xSocket;
+		( void ) pxDest;
 
-/*-----------------------------------------------------------*/
+		prvHandleAsyncReply( ( const uint8_t * ) pvData, uxLength, pxFrom );
 
-#if( ipconfigUSE_DNS_CACHE == 1 )
+		/* The message has been consumed, it will not be queued to the socket. */
+		return 1;
+	}
+	/*-----------------------------------------------------------*/
 
-	/* MISRA c 2012 rule 8.7: Below function may be used by 
-	external callees as well			        */
-	uint32_t FreeRTOS_dnslookup( const char *pcHostName )
+	/* An IP-address or a name in the DNS cache does not need a query. */
+	static uint32_t prvKnownAddress( const char *pcHostName )
 	{
 	uint32_t ulIPAddress = 0UL;
 
-		( void ) prvProcessDNSCache( pcHostName, &ulIPAddress, 0, pdTRUE );
+		#if( ipconfigINCLUDE_FULL_INET_ADDR == 1 )
+		{
+			ulIPAddress = FreeRTOS_inet_addr( pcHostName );
+		}
+		#endif /* ipconfigINCLUDE_FULL_INET_ADDR == 1 */
+
+		#if( ipconfigUSE_DNS_CACHE == 1 )
+		{
+			if( ulIPAddress == 0UL )
+			{
+				ulIPAddress = FreeRTOS_dnslookup( pcHostName );
+			}
+		}
+		#endif /* ipconfigUSE_DNS_CACHE == 1 */
+
 		return ulIPAddress;
 	}
-#endif /* ipconfigUSE_DNS_CACHE == 1 */
-/*-----------------------------------------------------------*/
-
-#if( ipconfigDNS_USE_CALLBACKS == 1 )
+	/*-----------------------------------------------------------*/
 
-	typedef struct xDNS_Callback
+	/* uxTimeout is in clock ticks. */
+	static BaseType_t prvBlockingLookup( const char *pcName,
+										 uint16_t usType,
+										 DNSAnswer_t *pxAnswers,
+										 BaseType_t xMaxAnswers,
+										 TickType_t uxTimeout )
 	{
-		TickType_t uxRemaningTime;		/* Timeout in ms */
-		FOnDNSEvent pCallbackFunction;	/* Function to be called when the address has been found or when a timeout has beeen reached */
-		TimeOut_t uxTimeoutState;
-		void *pvSearchID;
-		struct xLIST_ITEM xListItem;
-		char pcName[ 1 ];
-	} DNSCallback_t;
+	DNSWaiter_t xWaiter;
+	BaseType_t xCount = 0;
 
-	static List_t xCallbackList;
+		/* The IP-task gives the answer, it can not wait for it. */
+		configASSERT( xIsCallingFromIPTask() == pdFALSE );
 
-	/* Define FreeRTOS_gethostbyname() as a normal blocking call. */
-	uint32_t FreeRTOS_gethostbyname( const char *pcHostName )
-	{
-		return FreeRTOS_gethostbyname_a( pcHostName, NULL, ( void * ) NULL, 0 );
-	}
-	/*-----------------------------------------------------------*/
+		( void ) memset( &( xWaiter ), 0, sizeof( xWaiter ) );
+		xWaiter.xSemaphore = xSemaphoreCreateBinary();
 
-	/* Initialise the list of call-back structures. */
-	void vDNSInitialise( void )
-	{
-		vListInitialise( &xCallbackList );
+		if( xWaiter.xSemaphore != NULL )
+		{
+			xWaiter.pxAnswers = pxAnswers;
+			xWaiter.xMaxAnswers = xMaxAnswers;
+
+			if( prvStartLookup( pcName, usType, &( xWaiter ), uxTimeout ) != pdFAIL )
+			{
+				/* The IP-task gives the semaphore when the query has ended, or
+				when uxTimeout has expired, whichever comes first. */
+				( void ) xSemaphoreTake( xWaiter.xSemaphore, portMAX_DELAY );
+				xCount = xWaiter.xCount;
+			}
+
+			vSemaphoreDelete( xWaiter.xSemaphore );
+		}
+
+		return xCount;
 	}
 	/*-----------------------------------------------------------*/
 
-	/* Iterate through the list of call-back structures and remove
-	old entries which have reached a timeout.
-	As soon as the list hase become empty, the DNS timer will be stopped
-	In case pvSearchID is supplied, the user wants to cancel a DNS request
-	*/
-	void vDNSCheckCallBack( void *pvSearchID )
+	BaseType_t FreeRTOS_dnsquery_a( const char *pcName,
+									uint16_t usType,
+									FOnDNSResult pxCallback,
+									void *pvSearchID,
+									TickType_t uxTimeout )
 	{
-	const ListItem_t * pxIterator;
-	const ListItem_t * xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xCallbackList ) );
+	DNSWaiter_t *pxWaiter;
+	BaseType_t xReturn = pdFAIL;
 
-		vTaskSuspendAll();
+		if( ( pcName != NULL ) && ( pxCallback != NULL ) )
 		{
-			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
-				 pxIterator != xEnd;
-				 )
+			pxWaiter = ipPOINTER_CAST( DNSWaiter_t *, pvPortMalloc( sizeof( *pxWaiter ) ) );
+
+			if( pxWaiter != NULL )
 			{
-				DNSCallback_t *pxCallback = ipPOINTER_CAST( DNSCallback_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
-				/* Move to the next item because we might remove this item */
-				pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator );
-				if( ( pvSearchID != NULL ) && ( pvSearchID == pxCallback->pvSearchID ) )
-				{
-					( void ) uxListRemove( &( pxCallback->xListItem ) );
-					vPortFree( pxCallback );
-				}
-				else if( xTaskCheckForTimeOut( &pxCallback->uxTimeoutState, &pxCallback->uxRemaningTime ) != pdFALSE )
-				{
-					pxCallback->pCallbackFunction( pxCallback->pcName, pxCallback->pvSearchID, 0 );
-					( void ) uxListRemove( &( pxCallback->xListItem ) );
-					vPortFree( pxCallback );
-				}
-				else
+				( void ) memset( pxWaiter, 0, sizeof( *pxWaiter ) );
+				pxWaiter->pxResultFunction = pxCallback;
+				pxWaiter->pvSearchID = pvSearchID;
+
+				/* Translate from ms to number of clock ticks. */
+				xReturn = prvStartLookup( pcName, usType, pxWaiter, uxTimeout / portTICK_PERIOD_MS );
+
+				if( xReturn == pdFAIL )
 				{
-					/* This call-back is still waiting for a reply or a time-out. */
+					vPortFree( pxWaiter );
 				}
 			}
 		}
-		( void ) xTaskResumeAll();
 
-		if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
-		{
-			vIPSetDnsTimerEnableState( pdFALSE );
-		}
+		return xReturn;
 	}
 	/*-----------------------------------------------------------*/
 
-	void FreeRTOS_gethostbyname_cancel( void *pvSearchID )
+	BaseType_t FreeRTOS_dnsquery( const char *pcName,
+								  uint16_t usType,
+								  DNSAnswer_t *pxAnswers,
+								  BaseType_t xMaxAnswers,
+								  TickType_t uxTimeout )
 	{
-		/* _HT_ Should better become a new API call to have the IP-task remove the callback */
-		vDNSCheckCallBack( pvSearchID );
+	BaseType_t xCount = 0;
+
+		if( ( pcName != NULL ) && ( pxAnswers != NULL ) && ( xMaxAnswers > 0 ) )
+		{
+			xCount = prvBlockingLookup( pcName, usType, pxAnswers, xMaxAnswers, uxTimeout / portTICK_PERIOD_MS );
+		}
+
+		return xCount;
 	}
 	/*-----------------------------------------------------------*/
 
-	/* FreeRTOS_gethostbyname_a() was called along with callback parameters.
-	Store them in a list for later reference. */
-	static void vDNSSetCallBack( const char *pcHostName,
-								 void *pvSearchID,
-								 FOnDNSEvent pCallbackFunction,
-								 TickType_t uxTimeout,
-								 TickType_t uxIdentifier )
+	uint32_t FreeRTOS_gethostbyname( const char *pcHostName )
 	{
-	size_t lLength = strlen( pcHostName );
-	DNSCallback_t *pxCallback = ipPOINTER_CAST( DNSCallback_t *, pvPortMalloc( sizeof( *pxCallback ) + lLength ) );
-
-		/* Translate from ms to number of clock ticks. */
-		uxTimeout /= portTICK_PERIOD_MS;
+	uint32_t ulIPAddress = 0UL;
+	DNSAnswer_t xAnswer;
 
-		if( pxCallback != NULL )
+		if( pcHostName != NULL )
 		{
-			if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
-			{
-				/* This is the first one, start the DNS timer to check for timeouts */
-				vIPReloadDNSTimer( FreeRTOS_min_uint32( 1000U, uxTimeout ) );
-			}
+			ulIPAddress = prvKnownAddress( pcHostName );
 
-			( void ) strcpy( pxCallback->pcName, pcHostName );
-			pxCallback->pCallbackFunction = pCallbackFunction;
-			pxCallback->pvSearchID = pvSearchID;
-			pxCallback->uxRemaningTime = uxTimeout;
-			vTaskSetTimeOutState( &pxCallback->uxTimeoutState );
-			listSET_LIST_ITEM_OWNER( &( pxCallback->xListItem ), ipPOINTER_CAST( void *, pxCallback ) );
-			listSET_LIST_ITEM_VALUE( &( pxCallback->xListItem ), uxIdentifier );
-			vTaskSuspendAll();
+			/* Wait as long as the synchronous resolver would have waited. */
+			if( ( ulIPAddress == 0UL ) &&
+				( prvBlockingLookup( pcHostName, ( uint16_t ) ipDNS_TYPE_A, &( xAnswer ), 1, ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS * ( TickType_t ) ipconfigDNS_REQUEST_ATTEMPTS ) != 0 ) )
 			{
-				vListInsertEnd( &xCallbackList, &pxCallback->xListItem );
+				ulIPAddress = xAnswer.u.ulIPAddress;
 			}
-			( void ) xTaskResumeAll();
 		}
+
+		return ulIPAddress;
 	}
 	/*-----------------------------------------------------------*/
 
-	/* A DNS reply was received, see if there is any matching entry and
-	call the handler.  Returns pdTRUE if uxIdentifier was recognised. */
-	static BaseType_t xDNSDoCallback( TickType_t uxIdentifier,
-									  const char *pcName,
-									  uint32_t ulIPAddress )
+	uint32_t FreeRTOS_gethostbyname_a( const char *pcHostName,
+									   FOnDNSEvent pCallback,
+									   void *pvSearchID,
+									   TickType_t uxTimeout )
 	{
-	BaseType_t xResult = pdFALSE;
-	const ListItem_t * pxIterator;
-	const ListItem_t * xEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xCallbackList ) );
+	uint32_t ulIPAddress = 0UL;
+	DNSWaiter_t *pxWaiter;
 
-		vTaskSuspendAll();
+		if( pcHostName != NULL )
 		{
-			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
-				 pxIterator != ( const ListItem_t * ) xEnd;
-				 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+			ulIPAddress = prvKnownAddress( pcHostName );
+
+			if( pCallback == NULL )
 			{
-				if( listGET_LIST_ITEM_VALUE( pxIterator ) == uxIdentifier )
+				if( ulIPAddress == 0UL )
 				{
-				DNSCallback_t *pxCallback = ipPOINTER_CAST( DNSCallback_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+					ulIPAddress = FreeRTOS_gethostbyname( pcHostName );
+				}
+			}
+			else if( ulIPAddress != 0UL )
+			{
+				/* The IP address is known, do the call-back now. */
+				pCallback( pcHostName, pvSearchID, ulIPAddress );
+			}
+			else
+			{
+				pxWaiter = ipPOINTER_CAST( DNSWaiter_t *, pvPortMalloc( sizeof( *pxWaiter ) ) );
 
-					pxCallback->pCallbackFunction( pcName, pxCallback->pvSearchID, ulIPAddress );
-					( void ) uxListRemove( &pxCallback->xListItem );
-					vPortFree( pxCallback );
+				if( pxWaiter != NULL )
+				{
+					( void ) memset( pxWaiter, 0, sizeof( *pxWaiter ) );
+					pxWaiter->pCallbackFunction = pCallback;
+					pxWaiter->pvSearchID = pvSearchID;
 
-					if( listLIST_IS_EMPTY( &xCallbackList ) != pdFALSE )
+					/* Translate from ms to number of clock ticks. */
+					if( prvStartLookup( pcHostName, ( uint16_t ) ipDNS_TYPE_A, pxWaiter, uxTimeout / portTICK_PERIOD_MS ) == pdFAIL )
 					{
-						/* The list of outstanding requests is empty. No need for periodic polling. */
-						vIPSetDnsTimerEnableState( pdFALSE );
+						vPortFree( pxWaiter );
 					}
-
-					xResult = pdTRUE;
-					break;
 				}
 			}
 		}
-		( void ) xTaskResumeAll();
-		return xResult;
+
+		return ulIPAddress;
 	}
 
-#endif /* ipconfigDNS_USE_CALLBACKS == 1 */
+#endif /* ipconfigDNS_USE_ASYNC != 0 */
 /*-----------------------------------------------------------*/
 
 #if( ipconfigDNS_USE_CALLBACKS == 0 )
@@ -507,7 +1692,7 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 	{
 		return prvPrepareLookup( pcHostName );
 	}
-#else
+#elif( ipconfigDNS_USE_ASYNC == 0 )
 	uint32_t FreeRTOS_gethostbyname_a( const char *pcHostName,
 									   FOnDNSEvent pCallback,
 									   void *pvSearchID,
@@ -517,6 +1702,8 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 	}
 #endif
 
+#if( ipconfigDNS_USE_ASYNC == 0 )
+
 #if( ipconfigDNS_USE_CALLBACKS == 1 )
 	static uint32_t prvPrepareLookup( const char *pcHostName,
 									  FOnDNSEvent pCallback,
@@ -673,7 +1860,7 @@ TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
 			if( pucUDPPayloadBuffer != NULL )
 			{
 				/* Create the message in the obtained buffer. */
-				uxPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pcHostName, uxIdentifier );
+				uxPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pcHostName, uxIdentifier, ( uint16_t ) dnsTYPE_A_HOST );
 
 				iptraceSENDING_DNS_REQUEST();
 
@@ -766,11 +1953,14 @@ TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
 
 	return ulIPAddress;
 }
+
+#endif /* ipconfigDNS_USE_ASYNC == 0 */
 /*-----------------------------------------------------------*/
 
 static size_t prvCreateDNSMessage( uint8_t *pucUDPPayloadBuffer,
 								   const char *pcHostName,
-								   TickType_t uxIdentifier )
+								   TickType_t uxIdentifier,
+								   uint16_t usType )
 {
 DNSMessage_t *pxDNSMessageHeader;
 uint8_t *pucStart, *pucByte;
@@ -836,7 +2026,7 @@ static const DNSMessage_t xDefaultPartDNSHeader =
 	#if defined( _lint ) || defined( __COVERITY__ )
 	( void ) pxTail;
 	#else
-	vSetField16( pxTail, DNSTail_t, usType, dnsTYPE_A_HOST );
+	vSetField16( pxTail, DNSTail_t, usType, usType );
 	vSetField16( pxTail, DNSTail_t, usClass, dnsCLASS_IN );
 	#endif
 
@@ -1241,7 +2431,7 @@ uint16_t usType = 0U;
 										 &( pucByte[ sizeof( DNSAnswerRecord_t ) ] ),
 										 sizeof( uint32_t ) );
 
-						#if( ipconfigDNS_USE_CALLBACKS == 1 )
+						#if( ipconfigDNS_USE_CALLBACKS == 1 ) && ( ipconfigDNS_USE_ASYNC == 0 )
 						{
 							/* See if any asynchronous call was made to FreeRTOS_gethostbyname_a() */
 							if( xDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, ulIPAddress ) != pdFALSE )
@@ -1556,6 +2746,8 @@ uint16_t usType = 0U;
 #endif /* ipconfigUSE_NBNS */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigDNS_USE_ASYNC == 0 )
+
 static Socket_t prvCreateDNSSocket( void )
 {
 Socket_t xSocket;
@@ -1587,6 +2779,8 @@ BaseType_t xReturn;
 
 	return xSocket;
 }
+
+#endif /* ipconfigDNS_USE_ASYNC == 0 */
 /*-----------------------------------------------------------*/
 
 #if( ( ipconfigUSE_NBNS == 1 ) || ( ipconfigUSE_LLMNR == 1 ) )
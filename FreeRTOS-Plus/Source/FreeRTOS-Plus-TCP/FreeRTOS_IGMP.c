@@ -0,0 +1,854 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_IGMP.h"
+
+/* Exclude the entire file if IGMP is not enabled. */
+#if( ipconfigUSE_IGMP != 0 )
+
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+#if( ipconfigIGMP_MAX_GROUPS < 1 )
+	#error ipconfigIGMP_MAX_GROUPS must be at least 1
+#endif
+
+#if( ipconfigIGMP_MAX_SOCKET_GROUPS < 1 )
+	#error ipconfigIGMP_MAX_SOCKET_GROUPS must be at least 1
+#endif
+
+/* 224.0.0.1, the group of all systems.  It is joined implicitly and it is
+never reported. */
+#define igmpALL_SYSTEMS_GROUP			FreeRTOS_inet_addr_quick( 224, 0, 0, 1 )
+
+/* IGMPv2 leave messages are sent to all routers. */
+#define igmpALL_ROUTERS_GROUP			FreeRTOS_inet_addr_quick( 224, 0, 0, 2 )
+
+/* IGMPv3 reports are sent to all IGMPv3-capable routers. */
+#define igmpV3_REPORTS_GROUP			FreeRTOS_inet_addr_quick( 224, 0, 0, 22 )
+
+/* IGMP messages carry the Router Alert option (RFC 2113), which makes the IP
+header 4 bytes longer. */
+#define igmpIP_HEADER_LENGTH			( ipSIZE_OF_IPv4_HEADER + 4U )
+
+/* IGMP is sent with the "internetwork control" precedence, and a TTL of 1. */
+#define igmpTYPE_OF_SERVICE				( ( uint8_t ) 0xC0U )
+#define igmpTIME_TO_LIVE				( ( uint8_t ) 1U )
+
+/* The shortest IGMPv3 query. */
+#define igmpV3_QUERY_MIN_LENGTH			( 12U )
+
+/* IGMPv1 queries leave the max response time zero, it is 10 seconds. */
+#define igmpV1_MAX_RESPONSE_TIME		( 100U )
+
+/* A report is sent twice after joining a group (the "robustness variable"),
+the second one after a random delay of at most one second. */
+#define igmpUNSOLICITED_REPORTS			( 2U )
+#define igmpUNSOLICITED_INTERVAL		( 10U )
+
+/* After an IGMPv1 or v2 query was heard, IGMPv2 messages are sent during the
+"older version querier present timeout": 2 x 125 seconds + 10 seconds. */
+#define igmpV2_QUERIER_TIMEOUT_MS		( 260000U )
+
+/* The types of the IGMPv3 group records that are used.  This node joins groups
+for all sources, which is mode EXCLUDE with an empty source list. */
+#define igmpRECORD_MODE_IS_EXCLUDE		( ( uint8_t ) 2U )
+#define igmpRECORD_CHANGE_TO_INCLUDE	( ( uint8_t ) 3U )
+#define igmpRECORD_CHANGE_TO_EXCLUDE	( ( uint8_t ) 4U )
+
+/* The lower 23 bits of a group address, which are also the lower 23 bits of
+its MAC address. */
+#define igmpGROUP_LOW_BITS( ulGroupAddress )	( FreeRTOS_ntohl( ulGroupAddress ) & 0x007FFFFFUL )
+
+/* A group joined by one or more sockets. */
+typedef struct xIGMP_GROUP
+{
+	uint32_t ulGroupAddress;		/* Network byte order, 0 when the entry is not used. */
+	uint16_t usReportTimer;			/* Time until the next report, in units of 100 ms, 0 when none is scheduled. */
+	uint8_t ucUnsolicitedReports;	/* The number of unsolicited reports that must still be sent. */
+} IGMPGroup_t;
+
+/*
+ * Return the bit of a 32-bit hash filter that belongs to a group, from the
+ * lower 23 bits of its address.
+ */
+static uint32_t prvGroupHashBit( uint32_t ulLowBits );
+
+/*
+ * Find a group in xIGMPGroups[], or NULL.
+ */
+static IGMPGroup_t *prvFindGroup( uint32_t ulGroupAddress );
+
+/*
+ * Returns pdTRUE while IGMPv2 messages must be sent because an older querier
+ * is present.
+ */
+static BaseType_t prvUseIGMPv2( void );
+
+/*
+ * Return a random delay between 1 and 'ulMaximum', in units of 100 ms.
+ */
+static uint16_t prvRandomDelay( uint32_t ulMaximum );
+
+/*
+ * Schedule reports for a general query (group 0) or a group-specific query,
+ * to be sent within 'ulMaxResponse' units of 100 ms.
+ */
+static void prvScheduleReports( uint32_t ulGroupAddress, uint32_t ulMaxResponse );
+
+/*
+ * Send a membership report or a leave message for a group.
+ */
+static void prvSendReport( uint32_t ulGroupAddress, uint8_t ucRecordType );
+static void prvSendLeave( uint32_t ulGroupAddress );
+
+/*
+ * Build and send an IGMP message.  'ucRecordType' is only used for IGMPv3
+ * reports.
+ */
+static void prvSendIGMPMessage( uint32_t ulDestination, uint8_t ucMessageType, uint32_t ulGroupAddress, uint8_t ucRecordType );
+
+/*
+ * Start the IGMP timer when reports are scheduled, or stop it when none are.
+ */
+static void prvUpdateTimer( void );
+
+/*
+ * Recalculate ulIGMPGroupFilter from xIGMPGroups[].
+ */
+static void prvUpdateGroupFilter( void );
+
+#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+	/*
+	 * Let the driver accept or drop the MAC address of a group.  Up to 32
+	 * groups share a MAC address, it is only dropped when none of the other
+	 * groups uses it.
+	 */
+	static void prvUpdateMACFilter( uint32_t ulGroupAddress, BaseType_t xAdd );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The groups joined by the sockets of this node.  Only accessed by the
+IP-task. */
+static IGMPGroup_t xIGMPGroups[ ipconfigIGMP_MAX_GROUPS ];
+
+/* A hash filter with one bit for every group in xIGMPGroups[].  It is also
+read by xIGMPIsMulticastMACAccepted(), which may be called by the driver. */
+static volatile uint32_t ulIGMPGroupFilter = 0U;
+
+/* The last time an IGMPv1 or v2 query was received. */
+static TickType_t xV2QueryTime = 0U;
+static BaseType_t xV2QuerierSeen = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGroupHashBit( uint32_t ulLowBits )
+{
+uint32_t ulHash;
+
+	ulHash = ulLowBits ^ ( ulLowBits >> 5 ) ^ ( ulLowBits >> 10 ) ^ ( ulLowBits >> 15 ) ^ ( ulLowBits >> 20 );
+
+	return ( uint32_t ) 1U << ( ulHash & 0x1FU );
+}
+/*-----------------------------------------------------------*/
+
+static IGMPGroup_t *prvFindGroup( uint32_t ulGroupAddress )
+{
+IGMPGroup_t *pxReturn = NULL;
+UBaseType_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+	{
+		if( xIGMPGroups[ uxIndex ].ulGroupAddress == ulGroupAddress )
+		{
+			pxReturn = &( xIGMPGroups[ uxIndex ] );
+			break;
+		}
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUseIGMPv2( void )
+{
+	if( xV2QuerierSeen != pdFALSE )
+	{
+		if( ( xTaskGetTickCount() - xV2QueryTime ) >= pdMS_TO_TICKS( igmpV2_QUERIER_TIMEOUT_MS ) )
+		{
+			xV2QuerierSeen = pdFALSE;
+		}
+	}
+
+	return xV2QuerierSeen;
+}
+/*-----------------------------------------------------------*/
+
+static uint16_t prvRandomDelay( uint32_t ulMaximum )
+{
+uint32_t ulRandom = 0U;
+
+	( void ) xApplicationGetRandomNumber( &( ulRandom ) );
+
+	return ( uint16_t ) ( 1U + ( ulRandom % ulMaximum ) );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIGMPIsMemberOf( uint32_t ulGroupAddress )
+{
+BaseType_t xReturn = pdFALSE;
+
+	if( ulGroupAddress == igmpALL_SYSTEMS_GROUP )
+	{
+		xReturn = pdTRUE;
+	}
+	else if( ( ulIGMPGroupFilter & prvGroupHashBit( igmpGROUP_LOW_BITS( ulGroupAddress ) ) ) != 0U )
+	{
+		if( ( ulGroupAddress != 0U ) && ( prvFindGroup( ulGroupAddress ) != NULL ) )
+		{
+			xReturn = pdTRUE;
+		}
+	}
+	else
+	{
+		/* Not a member, decided by the hash filter. */
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIGMPIsMulticastMACAccepted( const MACAddress_t *pxMACAddress )
+{
+BaseType_t xReturn = pdFALSE;
+uint32_t ulLowBits;
+
+	/* IPv4 multicast MAC addresses are 01:00:5e followed by a zero bit and the
+	lower 23 bits of the group address. */
+	if( ( pxMACAddress->ucBytes[ 0 ] == 0x01U ) &&
+		( pxMACAddress->ucBytes[ 1 ] == 0x00U ) &&
+		( pxMACAddress->ucBytes[ 2 ] == 0x5EU ) &&
+		( ( pxMACAddress->ucBytes[ 3 ] & 0x80U ) == 0U ) )
+	{
+		ulLowBits = ( ( ( uint32_t ) pxMACAddress->ucBytes[ 3 ] ) << 16 ) |
+					( ( ( uint32_t ) pxMACAddress->ucBytes[ 4 ] ) << 8 ) |
+					( ( uint32_t ) pxMACAddress->ucBytes[ 5 ] );
+
+		if( ( ulLowBits == igmpGROUP_LOW_BITS( igmpALL_SYSTEMS_GROUP ) ) ||
+			( ( ulIGMPGroupFilter & prvGroupHashBit( ulLowBits ) ) != 0U ) )
+		{
+			xReturn = pdTRUE;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIGMPSocketIsMember( const FreeRTOS_Socket_t *pxSocket, uint32_t ulGroupAddress )
+{
+BaseType_t xReturn = pdFALSE;
+UBaseType_t uxIndex;
+
+	if( ( pxSocket->u.xUDP.ulMulticastFilter & prvGroupHashBit( igmpGROUP_LOW_BITS( ulGroupAddress ) ) ) != 0U )
+	{
+		for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_SOCKET_GROUPS; uxIndex++ )
+		{
+			if( pxSocket->u.xUDP.ulMulticastGroups[ uxIndex ] == ulGroupAddress )
+			{
+				xReturn = pdTRUE;
+				break;
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIGMPSocketSetMembership( FreeRTOS_Socket_t *pxSocket, uint32_t ulGroupAddress, BaseType_t xJoin )
+{
+BaseType_t xReturn = 0;
+BaseType_t xFound = -1;
+BaseType_t xFree = -1;
+BaseType_t xIndex;
+uint32_t ulFilter = 0U;
+
+	if( xIsIPv4Multicast( ulGroupAddress ) == 0 )
+	{
+		xReturn = -pdFREERTOS_ERRNO_EINVAL;
+	}
+	else
+	{
+		/* The IP-task reads the list while it delivers packets. */
+		vTaskSuspendAll();
+		{
+			for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigIGMP_MAX_SOCKET_GROUPS; xIndex++ )
+			{
+				if( pxSocket->u.xUDP.ulMulticastGroups[ xIndex ] == ulGroupAddress )
+				{
+					xFound = xIndex;
+				}
+				else if( ( pxSocket->u.xUDP.ulMulticastGroups[ xIndex ] == 0U ) && ( xFree < 0 ) )
+				{
+					xFree = xIndex;
+				}
+				else
+				{
+					/* Another group. */
+				}
+			}
+
+			if( xJoin != pdFALSE )
+			{
+				if( xFound >= 0 )
+				{
+					xReturn = -pdFREERTOS_ERRNO_EADDRINUSE;
+				}
+				else if( xFree < 0 )
+				{
+					xReturn = -pdFREERTOS_ERRNO_ENOBUFS;
+				}
+				else
+				{
+					pxSocket->u.xUDP.ulMulticastGroups[ xFree ] = ulGroupAddress;
+				}
+			}
+			else
+			{
+				if( xFound < 0 )
+				{
+					xReturn = -pdFREERTOS_ERRNO_EADDRNOTAVAIL;
+				}
+				else
+				{
+					pxSocket->u.xUDP.ulMulticastGroups[ xFound ] = 0U;
+				}
+			}
+
+			for( xIndex = 0; xIndex < ( BaseType_t ) ipconfigIGMP_MAX_SOCKET_GROUPS; xIndex++ )
+			{
+				if( pxSocket->u.xUDP.ulMulticastGroups[ xIndex ] != 0U )
+				{
+					ulFilter |= prvGroupHashBit( igmpGROUP_LOW_BITS( pxSocket->u.xUDP.ulMulticastGroups[ xIndex ] ) );
+				}
+			}
+			pxSocket->u.xUDP.ulMulticastFilter = ulFilter;
+		}
+		( void ) xTaskResumeAll();
+
+		if( xReturn == 0 )
+		{
+			/* Let the IP-task send the reports, or the leave messages. */
+			( void ) xSendEventToIPTask( eIGMPEvent );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vIGMPUpdateGroups( void )
+{
+uint32_t ulWanted[ ipconfigIGMP_MAX_GROUPS ];
+UBaseType_t uxWantedCount, uxIndex, uxWanted;
+IGMPGroup_t *pxGroup;
+uint32_t ulGroupAddress;
+
+	uxWantedCount = uxSocketGetMulticastGroups( ulWanted, ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS );
+
+	/* First leave the groups that are not used by any socket anymore. */
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+	{
+		ulGroupAddress = xIGMPGroups[ uxIndex ].ulGroupAddress;
+
+		if( ulGroupAddress != 0U )
+		{
+			for( uxWanted = 0U; uxWanted < uxWantedCount; uxWanted++ )
+			{
+				if( ulWanted[ uxWanted ] == ulGroupAddress )
+				{
+					break;
+				}
+			}
+
+			if( uxWanted == uxWantedCount )
+			{
+				( void ) memset( &( xIGMPGroups[ uxIndex ] ), 0, sizeof( xIGMPGroups[ uxIndex ] ) );
+				prvUpdateGroupFilter();
+				#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+				{
+					prvUpdateMACFilter( ulGroupAddress, pdFALSE );
+				}
+				#endif
+				prvSendLeave( ulGroupAddress );
+			}
+		}
+	}
+
+	/* Then join the new groups.  There is a free entry for each of them. */
+	for( uxWanted = 0U; uxWanted < uxWantedCount; uxWanted++ )
+	{
+		ulGroupAddress = ulWanted[ uxWanted ];
+
+		if( prvFindGroup( ulGroupAddress ) == NULL )
+		{
+			pxGroup = prvFindGroup( 0U );
+			configASSERT( pxGroup != NULL );
+
+			if( pxGroup != NULL )
+			{
+				#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+				{
+					prvUpdateMACFilter( ulGroupAddress, pdTRUE );
+				}
+				#endif
+				pxGroup->ulGroupAddress = ulGroupAddress;
+				prvUpdateGroupFilter();
+
+				/* Report now, and once more after a short random delay. */
+				prvSendReport( ulGroupAddress, igmpRECORD_CHANGE_TO_EXCLUDE );
+				pxGroup->ucUnsolicitedReports = ( uint8_t ) ( igmpUNSOLICITED_REPORTS - 1U );
+				pxGroup->usReportTimer = prvRandomDelay( igmpUNSOLICITED_INTERVAL );
+			}
+		}
+	}
+
+	prvUpdateTimer();
+}
+/*-----------------------------------------------------------*/
+
+void vIGMPNetworkUp( void )
+{
+UBaseType_t uxIndex;
+IGMPGroup_t *pxGroup;
+
+	#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+	{
+	MACAddress_t xMACAddress;
+
+		/* The driver may have been reset. */
+		vSetMultiCastIPv4MacAddress( igmpALL_SYSTEMS_GROUP, &( xMACAddress ) );
+		vNetworkInterfaceAddAllowedMAC( &( xMACAddress ) );
+	}
+	#endif
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+	{
+		pxGroup = &( xIGMPGroups[ uxIndex ] );
+
+		if( pxGroup->ulGroupAddress != 0U )
+		{
+			#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+			{
+			MACAddress_t xMACAddress;
+
+				vSetMultiCastIPv4MacAddress( pxGroup->ulGroupAddress, &( xMACAddress ) );
+				vNetworkInterfaceAddAllowedMAC( &( xMACAddress ) );
+			}
+			#endif
+
+			/* The IP address may have changed, announce the group again. */
+			pxGroup->ucUnsolicitedReports = ( uint8_t ) igmpUNSOLICITED_REPORTS;
+			pxGroup->usReportTimer = prvRandomDelay( igmpUNSOLICITED_INTERVAL );
+		}
+	}
+
+	prvUpdateTimer();
+}
+/*-----------------------------------------------------------*/
+
+eFrameProcessingResult_t eProcessIGMPPacket( const NetworkBufferDescriptor_t * const pxNetworkBuffer, UBaseType_t uxHeaderLength )
+{
+const IPHeader_t *pxIPHeader;
+const IGMPHeader_t *pxIGMPHeader;
+IGMPGroup_t *pxGroup;
+size_t uxIGMPLength;
+uint32_t ulMaxResponse = 0U;
+uint8_t ucCode;
+
+	pxIPHeader = ipPOINTER_CAST( const IPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+	pxIGMPHeader = ipPOINTER_CAST( const IGMPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ] ) );
+
+	/* The IP options have been removed from the packet, but they are still
+	counted in the length field. */
+	uxIGMPLength = ( size_t ) FreeRTOS_ntohs( pxIPHeader->usLength );
+
+	if( ( uxIGMPLength >= ( ( size_t ) uxHeaderLength + sizeof( IGMPHeader_t ) ) ) &&
+		( pxNetworkBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + sizeof( IGMPHeader_t ) ) ) )
+	{
+		uxIGMPLength -= ( size_t ) uxHeaderLength;
+		ucCode = pxIGMPHeader->ucMaxResponseTime;
+
+		switch( pxIGMPHeader->ucMessageType )
+		{
+			case ipIGMP_MEMBERSHIP_QUERY:
+				if( uxIGMPLength == sizeof( IGMPHeader_t ) )
+				{
+					/* An IGMPv1 or v2 query.  Answer with IGMPv2 messages for
+					a while. */
+					xV2QueryTime = xTaskGetTickCount();
+					xV2QuerierSeen = pdTRUE;
+					ulMaxResponse = ( ucCode != 0U ) ? ( uint32_t ) ucCode : igmpV1_MAX_RESPONSE_TIME;
+				}
+				else if( uxIGMPLength >= igmpV3_QUERY_MIN_LENGTH )
+				{
+					/* An IGMPv3 query.  Codes from 128 have a floating point
+					format: 1 bit, 3 bits exponent and 4 bits mantissa. */
+					if( ucCode < 128U )
+					{
+						ulMaxResponse = ( uint32_t ) ucCode;
+					}
+					else
+					{
+						ulMaxResponse = ( ( uint32_t ) ( ucCode & 0x0FU ) | 0x10U ) << ( ( ( ucCode >> 4 ) & 0x07U ) + 3U );
+					}
+
+					if( ulMaxResponse == 0U )
+					{
+						ulMaxResponse = 1U;
+					}
+				}
+				else
+				{
+					/* Invalid length, ignore it. */
+				}
+
+				if( ulMaxResponse != 0U )
+				{
+					/* Source-specific queries are answered like group-specific
+					ones: all sources are accepted. */
+					prvScheduleReports( pxIGMPHeader->ulGroupAddress, ulMaxResponse );
+				}
+				break;
+
+			case ipIGMP_V1_MEMBERSHIP_REPORT:
+			case ipIGMP_V2_MEMBERSHIP_REPORT:
+				/* Another member reported the group.  An IGMPv2 host then
+				suppresses its own pending report (RFC 2236). */
+				if( prvUseIGMPv2() != pdFALSE )
+				{
+					pxGroup = prvFindGroup( pxIGMPHeader->ulGroupAddress );
+
+					if( ( pxGroup != NULL ) && ( pxIGMPHeader->ulGroupAddress != 0U ) && ( pxGroup->ucUnsolicitedReports == 0U ) )
+					{
+						pxGroup->usReportTimer = 0U;
+						prvUpdateTimer();
+					}
+				}
+				break;
+
+			default:
+				/* Messages for routers, or unknown. */
+				break;
+		}
+	}
+
+	return eReleaseBuffer;
+}
+/*-----------------------------------------------------------*/
+
+static void prvScheduleReports( uint32_t ulGroupAddress, uint32_t ulMaxResponse )
+{
+UBaseType_t uxIndex;
+IGMPGroup_t *pxGroup;
+uint16_t usDelay;
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+	{
+		pxGroup = &( xIGMPGroups[ uxIndex ] );
+
+		if( ( pxGroup->ulGroupAddress != 0U ) &&
+			( ( ulGroupAddress == 0U ) || ( ulGroupAddress == pxGroup->ulGroupAddress ) ) )
+		{
+			/* A report that is already scheduled earlier stays. */
+			usDelay = prvRandomDelay( ulMaxResponse );
+
+			if( ( pxGroup->usReportTimer == 0U ) || ( pxGroup->usReportTimer > usDelay ) )
+			{
+				pxGroup->usReportTimer = usDelay;
+			}
+		}
+	}
+
+	prvUpdateTimer();
+}
+/*-----------------------------------------------------------*/
+
+void vIGMPCheckTimers( void )
+{
+UBaseType_t uxIndex;
+IGMPGroup_t *pxGroup;
+uint8_t ucRecordType;
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+	{
+		pxGroup = &( xIGMPGroups[ uxIndex ] );
+
+		if( pxGroup->usReportTimer != 0U )
+		{
+			pxGroup->usReportTimer--;
+
+			if( pxGroup->usReportTimer == 0U )
+			{
+				if( pxGroup->ucUnsolicitedReports != 0U )
+				{
+					ucRecordType = igmpRECORD_CHANGE_TO_EXCLUDE;
+					pxGroup->ucUnsolicitedReports--;
+
+					if( pxGroup->ucUnsolicitedReports != 0U )
+					{
+						pxGroup->usReportTimer = prvRandomDelay( igmpUNSOLICITED_INTERVAL );
+					}
+				}
+				else
+				{
+					ucRecordType = igmpRECORD_MODE_IS_EXCLUDE;
+				}
+
+				prvSendReport( pxGroup->ulGroupAddress, ucRecordType );
+			}
+		}
+	}
+
+	prvUpdateTimer();
+}
+/*-----------------------------------------------------------*/
+
+static void prvUpdateTimer( void )
+{
+BaseType_t xPending = pdFALSE;
+UBaseType_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+	{
+		if( xIGMPGroups[ uxIndex ].usReportTimer != 0U )
+		{
+			xPending = pdTRUE;
+			break;
+		}
+	}
+
+	vIPSetIGMPTimerEnableState( xPending );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUpdateGroupFilter( void )
+{
+uint32_t ulFilter = 0U;
+UBaseType_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+	{
+		if( xIGMPGroups[ uxIndex ].ulGroupAddress != 0U )
+		{
+			ulFilter |= prvGroupHashBit( igmpGROUP_LOW_BITS( xIGMPGroups[ uxIndex ].ulGroupAddress ) );
+		}
+	}
+
+	ulIGMPGroupFilter = ulFilter;
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+
+	static void prvUpdateMACFilter( uint32_t ulGroupAddress, BaseType_t xAdd )
+	{
+	MACAddress_t xMACAddress;
+	BaseType_t xShared = pdFALSE;
+	UBaseType_t uxIndex;
+
+		/* The group has been removed from xIGMPGroups[] already, or it has not
+		been added yet. */
+		for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_GROUPS; uxIndex++ )
+		{
+			if( ( xIGMPGroups[ uxIndex ].ulGroupAddress != 0U ) &&
+				( igmpGROUP_LOW_BITS( xIGMPGroups[ uxIndex ].ulGroupAddress ) == igmpGROUP_LOW_BITS( ulGroupAddress ) ) )
+			{
+				xShared = pdTRUE;
+				break;
+			}
+		}
+
+		if( xShared == pdFALSE )
+		{
+			vSetMultiCastIPv4MacAddress( ulGroupAddress, &( xMACAddress ) );
+
+			if( xAdd != pdFALSE )
+			{
+				vNetworkInterfaceAddAllowedMAC( &( xMACAddress ) );
+			}
+			else
+			{
+				vNetworkInterfaceRemoveAllowedMAC( &( xMACAddress ) );
+			}
+		}
+	}
+
+#endif /* ipconfigIGMP_DRIVER_MAC_FILTER */
+/*-----------------------------------------------------------*/
+
+static void prvSendReport( uint32_t ulGroupAddress, uint8_t ucRecordType )
+{
+	if( ulGroupAddress != igmpALL_SYSTEMS_GROUP )
+	{
+		if( prvUseIGMPv2() != pdFALSE )
+		{
+			prvSendIGMPMessage( ulGroupAddress, ipIGMP_V2_MEMBERSHIP_REPORT, ulGroupAddress, 0U );
+		}
+		else
+		{
+			prvSendIGMPMessage( igmpV3_REPORTS_GROUP, ipIGMP_V3_MEMBERSHIP_REPORT, ulGroupAddress, ucRecordType );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendLeave( uint32_t ulGroupAddress )
+{
+	if( ulGroupAddress != igmpALL_SYSTEMS_GROUP )
+	{
+		if( prvUseIGMPv2() != pdFALSE )
+		{
+			prvSendIGMPMessage( igmpALL_ROUTERS_GROUP, ipIGMP_V2_LEAVE_GROUP, ulGroupAddress, 0U );
+		}
+		else
+		{
+			/* Change to INCLUDE with no sources: no longer interested. */
+			prvSendIGMPMessage( igmpV3_REPORTS_GROUP, ipIGMP_V3_MEMBERSHIP_REPORT, ulGroupAddress, igmpRECORD_CHANGE_TO_INCLUDE );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendIGMPMessage( uint32_t ulDestination, uint8_t ucMessageType, uint32_t ulGroupAddress, uint8_t ucRecordType )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+EthernetHeader_t *pxEthernetHeader;
+IPHeader_t *pxIPHeader;
+IGMPHeader_t *pxIGMPHeader;
+IGMPv3Report_t *pxReport;
+uint8_t *pucOption;
+size_t uxIGMPLength;
+uint16_t usChecksum;
+
+	if( ucMessageType == ipIGMP_V3_MEMBERSHIP_REPORT )
+	{
+		uxIGMPLength = sizeof( IGMPv3Report_t );
+	}
+	else
+	{
+		uxIGMPLength = sizeof( IGMPHeader_t );
+	}
+
+	/* Nothing can be sent while the network is down, vIGMPNetworkUp() will
+	schedule the reports again. */
+	if( FreeRTOS_IsNetworkUp() != pdFALSE )
+	{
+		pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( ipSIZE_OF_ETH_HEADER + igmpIP_HEADER_LENGTH + uxIGMPLength, ( TickType_t ) 0U );
+	}
+	else
+	{
+		pxNetworkBuffer = NULL;
+	}
+
+	if( pxNetworkBuffer != NULL )
+	{
+		pxNetworkBuffer->xDataLength = ipSIZE_OF_ETH_HEADER + igmpIP_HEADER_LENGTH + uxIGMPLength;
+
+		pxEthernetHeader = ipPOINTER_CAST( EthernetHeader_t *, pxNetworkBuffer->pucEthernetBuffer );
+		pxIPHeader = ipPOINTER_CAST( IPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+		pucOption = &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER ] );
+		pxIGMPHeader = ipPOINTER_CAST( IGMPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + igmpIP_HEADER_LENGTH ] ) );
+
+		vSetMultiCastIPv4MacAddress( ulDestination, &( pxEthernetHeader->xDestinationAddress ) );
+		( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
+		pxEthernetHeader->usFrameType = ipIPv4_FRAME_TYPE;
+
+		pxIPHeader->ucVersionHeaderLength = ( uint8_t ) ( 0x40U | ( igmpIP_HEADER_LENGTH >> 2 ) );
+		pxIPHeader->ucDifferentiatedServicesCode = igmpTYPE_OF_SERVICE;
+		pxIPHeader->usLength = FreeRTOS_htons( ( uint16_t ) ( igmpIP_HEADER_LENGTH + uxIGMPLength ) );
+		pxIPHeader->usIdentification = FreeRTOS_htons( usPacketIdentifier );
+		usPacketIdentifier++;
+		pxIPHeader->usFragmentOffset = 0U;
+		pxIPHeader->ucTimeToLive = igmpTIME_TO_LIVE;
+		pxIPHeader->ucProtocol = ( uint8_t ) ipPROTOCOL_IGMP;
+		pxIPHeader->ulSourceIPAddress = *ipLOCAL_IP_ADDRESS_POINTER;
+		pxIPHeader->ulDestinationIPAddress = ulDestination;
+
+		/* Router Alert: type 148, length 4, value 0. */
+		pucOption[ 0 ] = 0x94U;
+		pucOption[ 1 ] = 0x04U;
+		pucOption[ 2 ] = 0x00U;
+		pucOption[ 3 ] = 0x00U;
+
+		( void ) memset( pxIGMPHeader, 0, uxIGMPLength );
+
+		if( ucMessageType == ipIGMP_V3_MEMBERSHIP_REPORT )
+		{
+			pxReport = ipPOINTER_CAST( IGMPv3Report_t *, pxIGMPHeader );
+			pxReport->ucMessageType = ucMessageType;
+			pxReport->usNumberOfRecords = FreeRTOS_htons( 1U );
+			pxReport->ucRecordType = ucRecordType;
+			pxReport->ulGroupAddress = ulGroupAddress;
+		}
+		else
+		{
+			pxIGMPHeader->ucMessageType = ucMessageType;
+			pxIGMPHeader->ulGroupAddress = ulGroupAddress;
+		}
+
+		/* The IGMP checksum covers the IGMP message only.  Drivers do not
+		offload it. */
+		usChecksum = usGenerateChecksum( 0U, ( const uint8_t * ) pxIGMPHeader, uxIGMPLength );
+		pxIGMPHeader->usChecksum = ~FreeRTOS_htons( usChecksum );
+
+		#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+		{
+			pxIPHeader->usHeaderChecksum = 0U;
+			usChecksum = usGenerateChecksum( 0U, ( const uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), igmpIP_HEADER_LENGTH );
+			pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( usChecksum );
+		}
+		#endif
+
+		( void ) xNetworkInterfaceOutput( pxNetworkBuffer, pdTRUE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_IGMP != 0 */
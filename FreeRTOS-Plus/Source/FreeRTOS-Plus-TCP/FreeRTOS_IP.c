@@ -44,6 +44,9 @@
 #include "NetworkInterface.h"
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_IP_Reassembly.h"
+#include "FreeRTOS_IGMP.h"
+#include "FreeRTOS_IPv6.h"
 
 
 /* Used to ensure the structure packing is having the desired effect.  The
@@ -56,6 +59,7 @@ a constant. */
 	#define ipEXPECTED_IGMPHeader_t_SIZE		( ( size_t ) 8 )
 	#define ipEXPECTED_ICMPHeader_t_SIZE		( ( size_t ) 8 )
 	#define ipEXPECTED_UDPHeader_t_SIZE			( ( size_t ) 8 )
+	#define ipEXPECTED_IPHeader_IPv6_t_SIZE		( ( size_t ) 40 )
 	#define ipEXPECTED_TCPHeader_t_SIZE			( ( size_t ) 20 )
 #endif
 
@@ -170,6 +174,13 @@ static void prvProcessEthernetPacket( NetworkBufferDescriptor_t * const pxNetwor
  */
 static eFrameProcessingResult_t prvProcessIPPacket( IPPacket_t * pxIPPacket, NetworkBufferDescriptor_t * const pxNetworkBuffer );
 
+#if( ipconfigUSE_IPv6 != 0 )
+	/*
+	 * Process incoming IPv6 packets.
+	 */
+	static eFrameProcessingResult_t prvProcessIPv6Packet( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+#endif /* ipconfigUSE_IPv6 */
+
 #if ( ipconfigREPLY_TO_INCOMING_PINGS == 1 ) || ( ipconfigSUPPORT_OUTGOING_PINGS == 1 )
 	/*
 	 * Process incoming ICMP packets.
@@ -228,14 +239,48 @@ static eFrameProcessingResult_t prvAllowIPPacket( const IPPacket_t * const pxIPP
 												  const NetworkBufferDescriptor_t * const pxNetworkBuffer,
 												  UBaseType_t uxHeaderLength );
 
+#if( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 )
+	/*
+	 * Check the IP header checksum and the protocol checksum of a received
+	 * IPv4 packet.
+	 */
+	static eFrameProcessingResult_t prvCheckIPChecksums( const IPHeader_t * const pxIPHeader,
+														 const NetworkBufferDescriptor_t * const pxNetworkBuffer,
+														 UBaseType_t uxHeaderLength );
+#endif
+
+/*
+ * Returns the number of events waiting for the IP-task.
+ */
+static UBaseType_t prvEventsWaiting( void );
+
+#if( ipconfigEVENT_QUEUE_LANES != 0 )
+	/*
+	 * Returns the lane through which an event is passed to the IP-task.
+	 */
+	static BaseType_t prvEventLane( eIPEvent_t eEvent );
+
+	/*
+	 * Take the next event from the lanes, without blocking.  Returns the lane
+	 * of the event, or -1 when all lanes are empty.
+	 */
+	static BaseType_t prvReceiveFromLanes( IPStackEvent_t *pxEvent );
+#endif /* ipconfigEVENT_QUEUE_LANES */
+
 /*-----------------------------------------------------------*/
 
-/* The queue used to pass events into the IP-task for processing. */
+/* The queue used to pass events into the IP-task for processing.  When
+ipconfigEVENT_QUEUE_LANES is set, this is the control lane. */
 QueueHandle_t xNetworkEventQueue = NULL;
 
 /*_RB_ Requires comment. */
 uint16_t usPacketIdentifier = 0U;
 
+#if( ipconfigUSE_IP_STATISTICS != 0 )
+	/* The stack wide counters, see FreeRTOS_IP_Stats.h. */
+	IPStackStats_t xIPStackStats;
+#endif
+
 /* For convenience, a MAC address of all 0xffs is defined const for quick
 reference. */
 const MACAddress_t xBroadcastMACAddress = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
@@ -277,6 +322,7 @@ regular basis:
 	2. DPHC, to send requests and to renew a reservation
 	3. TCP, to check for timeouts, resends
 	4. DNS, to check for timeouts when looking-up a domain.
+	5. IP reassembly, to drop incomplete datagrams.
  */
 static IPTimer_t xARPTimer;
 #if( ipconfigUSE_DHCP != 0 )
@@ -288,17 +334,64 @@ static IPTimer_t xARPTimer;
 #if( ipconfigDNS_USE_CALLBACKS != 0 )
 	static IPTimer_t xDNSTimer;
 #endif
+#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+	static IPTimer_t xReassemblyTimer;
+#endif
+#if( ipconfigUSE_IGMP != 0 )
+	static IPTimer_t xIGMPTimer;
+#endif
+#if( ipconfigUSE_IPv6 != 0 )
+	static IPTimer_t xIPv6Timer;
+#endif
 
 /* Set to pdTRUE when the IP task is ready to start processing packets. */
 /* coverity[misra_c_2012_rule_8_9_violation] */
 /* "xIPTaskInitialised" should be defined at block scope. */
 static BaseType_t xIPTaskInitialised = pdFALSE;
 
-#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 ) && ( ipconfigEVENT_QUEUE_LANES == 0 )
 	/* Keep track of the lowest amount of space in 'xNetworkEventQueue'. */
 	static UBaseType_t uxQueueMinimumSpace = ipconfigEVENT_QUEUE_LENGTH;
 #endif
 
+#if( ipconfigEVENT_QUEUE_LANES != 0 )
+	/* The lanes: xNetworkEventQueue and the TX and RX queues. */
+	static QueueHandle_t xEventLanes[ ipEVENT_LANE_COUNT ];
+
+	/* The number of events that may be taken from a lane in a row. */
+	static const UBaseType_t uxEventLaneWeights[ ipEVENT_LANE_COUNT ] =
+	{
+		ipconfigEVENT_LANE_WEIGHT_CONTROL,
+		ipconfigEVENT_LANE_WEIGHT_TX,
+		ipconfigEVENT_LANE_WEIGHT_RX
+	};
+
+	/* The lane that the IP-task is reading from, and the number of events it
+	may still take from it. */
+	static BaseType_t xCurrentLane = ipEVENT_LANE_CONTROL;
+	static UBaseType_t uxCurrentLaneCredit = ipconfigEVENT_LANE_WEIGHT_CONTROL;
+
+	#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+		/* The lowest amount of space seen in each lane. */
+		static UBaseType_t uxLaneMinimumSpace[ ipEVENT_LANE_COUNT ] =
+		{
+			ipconfigEVENT_QUEUE_LENGTH,
+			ipconfigEVENT_TX_LANE_LENGTH,
+			ipconfigEVENT_RX_LANE_LENGTH
+		};
+
+		/* The number of events that could not be added to each lane. */
+		static uint32_t ulLaneDropCount[ ipEVENT_LANE_COUNT ];
+	#endif /* ipconfigCHECK_IP_QUEUE_SPACE */
+#endif /* ipconfigEVENT_QUEUE_LANES */
+
+
+#if( ipconfigUSE_LOOPBACK != 0 )
+	/* Set by the IP-task while it handles a packet that was sent by this node
+	to itself.  Such packets are not filtered and have no valid checksums. */
+	static BaseType_t xLoopbackFrame = pdFALSE;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Coverity want to make pvParameters const, which would make it incompatible. */
@@ -346,28 +439,63 @@ struct freertos_sockaddr xAddress;
 		/* Calculate the acceptable maximum sleep time. */
 		xNextIPSleep = prvCalculateSleepTime();
 
-		/* Wait until there is something to do. If the following call exits
-		 * due to a time out rather than a message being received, set a
-		 * 'NoEvent' value. */
-		if ( xQueueReceive( xNetworkEventQueue, ipPOINTER_CAST( void *, &xReceivedEvent ), xNextIPSleep ) == pdFALSE ) 
+		#if( ipconfigEVENT_QUEUE_LANES != 0 )
 		{
-			xReceivedEvent.eEventType = eNoEvent;
-		}
+		BaseType_t xLane;
 
-		#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
-		{
-			if( xReceivedEvent.eEventType != eNoEvent )
+			/* Take an event from one of the lanes.  When all lanes are empty,
+			wait for a sender to give a notification. */
+			xLane = prvReceiveFromLanes( &xReceivedEvent );
+
+			if( xLane < 0 )
+			{
+				( void ) ulTaskNotifyTake( pdTRUE, xNextIPSleep );
+				xLane = prvReceiveFromLanes( &xReceivedEvent );
+			}
+
+			if( xLane < 0 )
+			{
+				xReceivedEvent.eEventType = eNoEvent;
+			}
+			#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+			else
 			{
 			UBaseType_t uxCount;
 
-				uxCount = uxQueueSpacesAvailable( xNetworkEventQueue );
-				if( uxQueueMinimumSpace > uxCount )
+				uxCount = uxQueueSpacesAvailable( xEventLanes[ xLane ] );
+				if( uxLaneMinimumSpace[ xLane ] > uxCount )
 				{
-					uxQueueMinimumSpace = uxCount;
+					uxLaneMinimumSpace[ xLane ] = uxCount;
 				}
 			}
+			#endif /* ipconfigCHECK_IP_QUEUE_SPACE */
 		}
-		#endif /* ipconfigCHECK_IP_QUEUE_SPACE */
+		#else
+		{
+			/* Wait until there is something to do. If the following call exits
+			 * due to a time out rather than a message being received, set a
+			 * 'NoEvent' value. */
+			if ( xQueueReceive( xNetworkEventQueue, ipPOINTER_CAST( void *, &xReceivedEvent ), xNextIPSleep ) == pdFALSE )
+			{
+				xReceivedEvent.eEventType = eNoEvent;
+			}
+
+			#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+			{
+				if( xReceivedEvent.eEventType != eNoEvent )
+				{
+				UBaseType_t uxCount;
+
+					uxCount = uxQueueSpacesAvailable( xNetworkEventQueue );
+					if( uxQueueMinimumSpace > uxCount )
+					{
+						uxQueueMinimumSpace = uxCount;
+					}
+				}
+			}
+			#endif /* ipconfigCHECK_IP_QUEUE_SPACE */
+		}
+		#endif /* ipconfigEVENT_QUEUE_LANES */
 
 		iptraceNETWORK_EVENT_RECEIVED( xReceivedEvent.eEventType );
 
@@ -386,15 +514,57 @@ struct freertos_sockaddr xAddress;
 				prvHandleEthernetPacket( ipPOINTER_CAST( NetworkBufferDescriptor_t *, xReceivedEvent.pvData ) );
 				break;
 
+			case eLoopbackRxEvent:
+				/* A packet that was sent to this node has been passed back by
+				xLoopbackOutput().  Process it as a received packet. */
+				#if( ipconfigUSE_LOOPBACK != 0 )
+				{
+					xLoopbackFrame = pdTRUE;
+					prvHandleEthernetPacket( ipPOINTER_CAST( NetworkBufferDescriptor_t *, xReceivedEvent.pvData ) );
+					xLoopbackFrame = pdFALSE;
+				}
+				#endif /* ipconfigUSE_LOOPBACK */
+				break;
+
+			case eIGMPEvent:
+				/* A socket has joined or left a multicast group. */
+				#if( ipconfigUSE_IGMP != 0 )
+				{
+					vIGMPUpdateGroups();
+				}
+				#endif /* ipconfigUSE_IGMP */
+				break;
+
+			case eIPv6TxEvent:
+				/* Send an IPv6 packet, once the MAC address of its next hop
+				has been looked up. */
+				#if( ipconfigUSE_IPv6 != 0 )
+				{
+					vIPv6SendPacket( ipPOINTER_CAST( NetworkBufferDescriptor_t *, xReceivedEvent.pvData ) );
+				}
+				#endif /* ipconfigUSE_IPv6 */
+				break;
+
 			case eNetworkTxEvent:
 				/* Send a network packet. The ownership will  be transferred to
 				the driver, which will release it after delivery. */
-				( void ) xNetworkInterfaceOutput( ipPOINTER_CAST( NetworkBufferDescriptor_t *, xReceivedEvent.pvData ), pdTRUE );
+				#if( ipconfigUSE_LOOPBACK != 0 )
+				if( xLoopbackOutput( ipPOINTER_CAST( NetworkBufferDescriptor_t *, xReceivedEvent.pvData ), pdTRUE ) == pdFALSE )
+				#endif
+				{
+					( void ) xNetworkInterfaceOutput( ipPOINTER_CAST( NetworkBufferDescriptor_t *, xReceivedEvent.pvData ), pdTRUE );
+				}
 				break;
 
 			case eARPTimerEvent :
 				/* The ARP timer has expired, process the ARP cache. */
 				vARPAgeCache();
+				#if( ipconfigUSE_IPv6 != 0 )
+				{
+					/* The neighbour cache ages at the same pace. */
+					vNDAgeCache();
+				}
+				#endif /* ipconfigUSE_IPv6 */
 				break;
 
 			case eSocketBindEvent:
@@ -554,6 +724,14 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
 		/* When ipconfigUSE_LINKED_RX_MESSAGES is not set to 0 then only one
 		buffer will be sent at a time.  This is the default way for +TCP to pass
 		messages from the MAC to the TCP/IP stack. */
+		#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+		{
+			/* The reassembly links fragments through pxNextBuffer, make sure
+			it starts as NULL. */
+			pxBuffer->pxNextBuffer = NULL;
+		}
+		#endif
+
 		prvProcessEthernetPacket( pxBuffer );
 	}
 	#else /* ipconfigUSE_LINKED_RX_MESSAGES */
@@ -633,6 +811,42 @@ TickType_t xMaximumSleepTime;
 	}
 	#endif
 
+	#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+	{
+		if( xReassemblyTimer.bActive != pdFALSE_UNSIGNED )
+		{
+			if( xReassemblyTimer.ulRemainingTime < xMaximumSleepTime )
+			{
+				xMaximumSleepTime = xReassemblyTimer.ulRemainingTime;
+			}
+		}
+	}
+	#endif
+
+	#if( ipconfigUSE_IGMP != 0 )
+	{
+		if( xIGMPTimer.bActive != pdFALSE_UNSIGNED )
+		{
+			if( xIGMPTimer.ulRemainingTime < xMaximumSleepTime )
+			{
+				xMaximumSleepTime = xIGMPTimer.ulRemainingTime;
+			}
+		}
+	}
+	#endif
+
+	#if( ipconfigUSE_IPv6 != 0 )
+	{
+		if( xIPv6Timer.bActive != pdFALSE_UNSIGNED )
+		{
+			if( xIPv6Timer.ulRemainingTime < xMaximumSleepTime )
+			{
+				xMaximumSleepTime = xIPv6Timer.ulRemainingTime;
+			}
+		}
+	}
+	#endif
+
 	return xMaximumSleepTime;
 }
 /*-----------------------------------------------------------*/
@@ -665,6 +879,36 @@ static void prvCheckNetworkTimers( void )
 	}
 	#endif /* ipconfigDNS_USE_CALLBACKS */
 
+	#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+	{
+		/* Is it time to look for expired datagrams? */
+		if( prvIPTimerCheck( &xReassemblyTimer ) != pdFALSE )
+		{
+			vIPReassemblyAgeDatagrams();
+		}
+	}
+	#endif /* ipconfigUSE_IP_REASSEMBLY */
+
+	#if( ipconfigUSE_IGMP != 0 )
+	{
+		/* Are there membership reports to be sent? */
+		if( prvIPTimerCheck( &xIGMPTimer ) != pdFALSE )
+		{
+			vIGMPCheckTimers();
+		}
+	}
+	#endif /* ipconfigUSE_IGMP */
+
+	#if( ipconfigUSE_IPv6 != 0 )
+	{
+		/* Router solicitations and the lifetimes of addresses. */
+		if( prvIPTimerCheck( &xIPv6Timer ) != pdFALSE )
+		{
+			vIPv6CheckTimers();
+		}
+	}
+	#endif /* ipconfigUSE_IPv6 */
+
 	#if( ipconfigUSE_TCP == 1 )
 	{
 	BaseType_t xWillSleep;
@@ -673,7 +917,7 @@ static void prvCheckNetworkTimers( void )
 
 		/* If the IP task has messages waiting to be processed then
 		it will not sleep in any case. */
-		if( uxQueueMessagesWaiting( xNetworkEventQueue ) == 0U )
+		if( prvEventsWaiting() == 0U )
 		{
 			xWillSleep = pdTRUE;
 		}
@@ -694,6 +938,14 @@ static void prvCheckNetworkTimers( void )
 
 		if( xCheckTCPSockets != pdFALSE )
 		{
+			#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+			{
+				/* Send keep-alive messages and close the connections that
+				are hanging, before the sockets are visited. */
+				vTCPAliveTimerCheck();
+			}
+			#endif
+
 			/* Attend to the sockets, returning the period after which the
 			check must be repeated. */
 			xNextTime = xTCPTimerCheck( xWillSleep );
@@ -792,7 +1044,7 @@ static const IPStackEvent_t xNetworkDownEvent = { eNetworkDownEvent, NULL };
 BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
 	/* Simply send the network task the appropriate event. */
-	if( xQueueSendToBackFromISR( xNetworkEventQueue, &xNetworkDownEvent, &xHigherPriorityTaskWoken ) != pdPASS )
+	if( xSendEventStructToIPTaskFromISR( &xNetworkDownEvent, &xHigherPriorityTaskWoken ) != pdPASS )
 	{
 		xNetworkDownEventPending = pdTRUE;
 	}
@@ -971,6 +1223,16 @@ BaseType_t xReturn = pdFALSE;
 		configASSERT( sizeof( ARPHeader_t ) == ipEXPECTED_ARPHeader_t_SIZE );
 		configASSERT( sizeof( IPHeader_t ) == ipEXPECTED_IPHeader_t_SIZE );
 		configASSERT( sizeof( ICMPHeader_t ) == ipEXPECTED_ICMPHeader_t_SIZE );
+		#if( ipconfigUSE_IGMP != 0 )
+		{
+			configASSERT( sizeof( IGMPHeader_t ) == ipEXPECTED_IGMPHeader_t_SIZE );
+		}
+		#endif
+		#if( ipconfigUSE_IPv6 != 0 )
+		{
+			configASSERT( sizeof( IPHeader_IPv6_t ) == ipEXPECTED_IPHeader_IPv6_t_SIZE );
+		}
+		#endif
 		configASSERT( sizeof( UDPHeader_t ) == ipEXPECTED_UDPHeader_t_SIZE );
 	}
 	#endif
@@ -989,6 +1251,24 @@ BaseType_t xReturn = pdFALSE;
 		}
 		#endif /* configQUEUE_REGISTRY_SIZE */
 
+		#if( ipconfigEVENT_QUEUE_LANES != 0 )
+		{
+			/* The event queue created above is the control lane. */
+			xEventLanes[ ipEVENT_LANE_CONTROL ] = xNetworkEventQueue;
+			xEventLanes[ ipEVENT_LANE_TX ] = xQueueCreate( ( UBaseType_t ) ipconfigEVENT_TX_LANE_LENGTH, ( UBaseType_t ) sizeof( IPStackEvent_t ) );
+			xEventLanes[ ipEVENT_LANE_RX ] = xQueueCreate( ( UBaseType_t ) ipconfigEVENT_RX_LANE_LENGTH, ( UBaseType_t ) sizeof( IPStackEvent_t ) );
+			configASSERT( xEventLanes[ ipEVENT_LANE_TX ] != NULL );
+			configASSERT( xEventLanes[ ipEVENT_LANE_RX ] != NULL );
+
+			#if ( configQUEUE_REGISTRY_SIZE > 0 )
+			{
+				vQueueAddToRegistry( xEventLanes[ ipEVENT_LANE_TX ], "NetEvTx" );
+				vQueueAddToRegistry( xEventLanes[ ipEVENT_LANE_RX ], "NetEvRx" );
+			}
+			#endif /* configQUEUE_REGISTRY_SIZE */
+		}
+		#endif /* ipconfigEVENT_QUEUE_LANES */
+
 		if( xNetworkBuffersInitialise() == pdPASS )
 		{
 			/* Store the local IP and MAC address. */
@@ -1211,6 +1491,11 @@ BaseType_t xSendEventStructToIPTask( const IPStackEvent_t *pxEvent, TickType_t u
 BaseType_t xReturn, xSendMessage;
 TickType_t uxUseTimeout = uxTimeout;
 
+	if( pxEvent->eEventType == eNetworkRxEvent )
+	{
+		iptraceRX_HANDOFF_TO_IP_TASK( ipPOINTER_CAST( NetworkBufferDescriptor_t *, pxEvent->pvData ) );
+	}
+
 	if( ( xIPIsNetworkTaskReady() == pdFALSE ) && ( pxEvent->eEventType != eNetworkDownEvent ) )
 	{
 		/* Only allow eNetworkDownEvent events if the IP task is not ready
@@ -1230,7 +1515,7 @@ TickType_t uxUseTimeout = uxTimeout;
 				IP task is already awake processing other message. */
 				xTCPTimer.bExpired = pdTRUE_UNSIGNED;
 
-				if( uxQueueMessagesWaiting( xNetworkEventQueue ) != 0U )
+				if( prvEventsWaiting() != 0U )
 				{
 					/* Not actually going to send the message but this is not a
 					failure as the message didn't need to be sent. */
@@ -1249,13 +1534,50 @@ TickType_t uxUseTimeout = uxTimeout;
 				uxUseTimeout = ( TickType_t ) 0;
 			}
 
-			xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxUseTimeout );
+			#if( ipconfigEVENT_QUEUE_LANES != 0 )
+			{
+			BaseType_t xLane = prvEventLane( pxEvent->eEventType );
+
+				if( ( xLane == ipEVENT_LANE_RX ) &&
+					( uxQueueMessagesWaiting( xEventLanes[ xLane ] ) >= ( UBaseType_t ) ipconfigEVENT_RX_LANE_DROP_LEVEL ) )
+				{
+					/* The IP-task can not keep up with the reception.  Refuse
+					the packet now, so the network buffers are available for
+					other work. */
+					xReturn = pdFAIL;
+				}
+				else
+				{
+					xReturn = xQueueSendToBack( xEventLanes[ xLane ], pxEvent, uxUseTimeout );
+				}
+
+				if( xReturn != pdFAIL )
+				{
+					/* The IP-task might be waiting for a notification. */
+					if( xIPTaskHandle != NULL )
+					{
+						( void ) xTaskNotifyGive( xIPTaskHandle );
+					}
+				}
+				#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+				else
+				{
+					ulLaneDropCount[ xLane ]++;
+				}
+				#endif /* ipconfigCHECK_IP_QUEUE_SPACE */
+			}
+			#else
+			{
+				xReturn = xQueueSendToBack( xNetworkEventQueue, pxEvent, uxUseTimeout );
+			}
+			#endif /* ipconfigEVENT_QUEUE_LANES */
 
 			if( xReturn == pdFAIL )
 			{
 				/* A message should have been sent to the IP task, but wasn't. */
 				FreeRTOS_debug_printf( ( "xSendEventStructToIPTask: CAN NOT ADD %d\n", pxEvent->eEventType ) );
 				iptraceSTACK_TX_EVENT_LOST( pxEvent->eEventType );
+				ipSTATS_INCREMENT_SHARED( ulEventQueueOverflows );
 			}
 		}
 		else
@@ -1270,6 +1592,122 @@ TickType_t uxUseTimeout = uxTimeout;
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t xSendEventStructToIPTaskFromISR( const IPStackEvent_t *pxEvent, BaseType_t *pxHigherPriorityTaskWoken )
+{
+BaseType_t xReturn;
+
+	if( pxEvent->eEventType == eNetworkRxEvent )
+	{
+		iptraceRX_HANDOFF_TO_IP_TASK( ipPOINTER_CAST( NetworkBufferDescriptor_t *, pxEvent->pvData ) );
+	}
+
+	#if( ipconfigEVENT_QUEUE_LANES != 0 )
+	{
+	BaseType_t xLane = prvEventLane( pxEvent->eEventType );
+
+		xReturn = xQueueSendToBackFromISR( xEventLanes[ xLane ], pxEvent, pxHigherPriorityTaskWoken );
+
+		if( xReturn != pdFAIL )
+		{
+			if( xIPTaskHandle != NULL )
+			{
+				vTaskNotifyGiveFromISR( xIPTaskHandle, pxHigherPriorityTaskWoken );
+			}
+		}
+		#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+		else
+		{
+			ulLaneDropCount[ xLane ]++;
+		}
+		#endif /* ipconfigCHECK_IP_QUEUE_SPACE */
+	}
+	#else
+	{
+		xReturn = xQueueSendToBackFromISR( xNetworkEventQueue, pxEvent, pxHigherPriorityTaskWoken );
+	}
+	#endif /* ipconfigEVENT_QUEUE_LANES */
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvEventsWaiting( void )
+{
+UBaseType_t uxCount;
+
+	#if( ipconfigEVENT_QUEUE_LANES != 0 )
+	{
+		uxCount = uxQueueMessagesWaiting( xEventLanes[ ipEVENT_LANE_CONTROL ] ) +
+				  uxQueueMessagesWaiting( xEventLanes[ ipEVENT_LANE_TX ] ) +
+				  uxQueueMessagesWaiting( xEventLanes[ ipEVENT_LANE_RX ] );
+	}
+	#else
+	{
+		uxCount = uxQueueMessagesWaiting( xNetworkEventQueue );
+	}
+	#endif /* ipconfigEVENT_QUEUE_LANES */
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigEVENT_QUEUE_LANES != 0 )
+
+	static BaseType_t prvEventLane( eIPEvent_t eEvent )
+	{
+	BaseType_t xLane;
+
+		switch( eEvent )
+		{
+			case eNetworkRxEvent:
+			case eLoopbackRxEvent:
+				xLane = ipEVENT_LANE_RX;
+				break;
+
+			case eNetworkTxEvent:
+			case eStackTxEvent:
+			case eIPv6TxEvent:
+				xLane = ipEVENT_LANE_TX;
+				break;
+
+			default:
+				xLane = ipEVENT_LANE_CONTROL;
+				break;
+		}
+
+		return xLane;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvReceiveFromLanes( IPStackEvent_t *pxEvent )
+	{
+	BaseType_t xReturn = -1;
+	BaseType_t xTries;
+
+		/* Weighted round-robin: take up to uxEventLaneWeights[] events from
+		the current lane, then move on to the next lane.  A lane that is empty
+		is skipped.  One extra round is made, so the current lane is visited
+		again with a fresh credit when the other lanes are empty. */
+		for( xTries = 0; xTries <= ipEVENT_LANE_COUNT; xTries++ )
+		{
+			if( ( uxCurrentLaneCredit > 0U ) &&
+				( xQueueReceive( xEventLanes[ xCurrentLane ], ipPOINTER_CAST( void *, pxEvent ), ( TickType_t ) 0U ) != pdFALSE ) )
+			{
+				uxCurrentLaneCredit--;
+				xReturn = xCurrentLane;
+				break;
+			}
+
+			xCurrentLane = ( xCurrentLane + 1 ) % ipEVENT_LANE_COUNT;
+			uxCurrentLaneCredit = uxEventLaneWeights[ xCurrentLane ];
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ipconfigEVENT_QUEUE_LANES */
+
 eFrameProcessingResult_t eConsiderFrameForProcessing( const uint8_t * const pucEthernetBuffer )
 {
 eFrameProcessingResult_t eReturn;
@@ -1296,6 +1734,24 @@ const EthernetHeader_t *pxEthernetHeader;
 	}
 	else
 #endif /* ipconfigUSE_LLMNR */
+#if( ipconfigUSE_IGMP != 0 )
+	if( xIGMPIsMulticastMACAccepted( &( pxEthernetHeader->xDestinationAddress ) ) != pdFALSE )
+	{
+		/* The packet may be for a multicast group that was joined.  The
+		group address is checked in prvAllowIPPacket(). */
+		eReturn = eProcessBuffer;
+	}
+	else
+#endif /* ipconfigUSE_IGMP */
+#if( ipconfigUSE_IPv6 != 0 )
+	if( ( pxEthernetHeader->xDestinationAddress.ucBytes[ 0 ] == 0x33U ) &&
+		( pxEthernetHeader->xDestinationAddress.ucBytes[ 1 ] == 0x33U ) )
+	{
+		/* An IPv6 multicast, the group is checked by xIPv6IsForThisNode(). */
+		eReturn = eProcessBuffer;
+	}
+	else
+#endif /* ipconfigUSE_IPv6 */
 	{
 		/* The packet was not a broadcast, or for this node, just release
 		the buffer without taking any other action. */
@@ -1349,6 +1805,14 @@ static void prvProcessNetworkDownEvent( void )
 	interface. */
 	FreeRTOS_ClearARP( );
 
+	#if( ipconfigUSE_IPv6 != 0 )
+	{
+		/* The same goes for the neighbour cache. */
+		vNDClearCache();
+		vIPSetIPv6TimerEnableState( pdFALSE );
+	}
+	#endif /* ipconfigUSE_IPv6 */
+
 	/* The network has been disconnected (or is being initialised for the first
 	time).  Perform whatever hardware processing is necessary to bring it up
 	again, or wait for it to be available again.  This is hardware dependent. */
@@ -1398,6 +1862,18 @@ void vIPNetworkUpCalls( void )
 	}
 	#endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 
+	#if( ipconfigUSE_IGMP != 0 )
+	{
+		vIGMPNetworkUp();
+	}
+	#endif /* ipconfigUSE_IGMP */
+
+	#if( ipconfigUSE_IPv6 != 0 )
+	{
+		vIPv6NetworkUp();
+	}
+	#endif /* ipconfigUSE_IPv6 */
+
 	/* Set remaining time to 0 so it will become active immediately. */
 	prvIPTimerReload( &xARPTimer, pdMS_TO_TICKS( ipARP_TIMER_PERIOD_MS ) );
 }
@@ -1410,6 +1886,9 @@ eFrameProcessingResult_t eReturned = eReleaseBuffer;
 
 	configASSERT( pxNetworkBuffer != NULL );
 
+	ipSTATS_INCREMENT( ulRxFrames );
+	iptraceRX_PROCESSING_STARTED( pxNetworkBuffer );
+
 	/* Interpret the Ethernet frame. */
 	if( pxNetworkBuffer->xDataLength >= sizeof( EthernetHeader_t ) )
 	{
@@ -1448,6 +1927,20 @@ eFrameProcessingResult_t eReturned = eReleaseBuffer;
 				}
 				break;
 
+		#if( ipconfigUSE_IPv6 != 0 )
+			case ipIPv6_FRAME_TYPE:
+				/* The Ethernet frame contains an IPv6 packet. */
+				if( pxNetworkBuffer->xDataLength >= sizeof( IPPacket_IPv6_t ) )
+				{
+					eReturned = prvProcessIPv6Packet( pxNetworkBuffer );
+				}
+				else
+				{
+					eReturned = eReleaseBuffer;
+				}
+				break;
+		#endif /* ipconfigUSE_IPv6 */
+
 			default:
 				/* No other packet types are handled.  Nothing to do. */
 				eReturned = eReleaseBuffer;
@@ -1479,6 +1972,7 @@ eFrameProcessingResult_t eReturned = eReleaseBuffer;
 			/* The frame is not being used anywhere, and the
 			NetworkBufferDescriptor_t structure containing the frame should
 			just be	released back to the list of free buffers. */
+			ipSTATS_INCREMENT( ulRxFramesDropped );
 			vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 			break;
 	}
@@ -1535,10 +2029,19 @@ eFrameProcessingResult_t eReturn = eProcessBuffer;
 		This method may decrease the usage of sparse network buffers. */
 		uint32_t ulDestinationIPAddress = pxIPHeader->ulDestinationIPAddress;
 
+			#if( ipconfigUSE_LOOPBACK != 0 )
+			if( xLoopbackFrame != pdFALSE )
+			{
+				/* Sent by this node to itself, the headers were made here. */
+			}
+			else
+			#endif
 			/* Ensure that the incoming packet is not fragmented (only outgoing
 			packets can be fragmented) as these are the only handled IP frames
-			currently. */
-			if( ( pxIPHeader->usFragmentOffset & ipFRAGMENT_OFFSET_BIT_MASK ) != 0U )
+			currently.  When reassembly is used, fragments are passed on to
+			prvProcessIPPacket(). */
+			if( ( ipconfigUSE_IP_REASSEMBLY == 0 ) &&
+				( ( pxIPHeader->usFragmentOffset & ipFRAGMENT_OFFSET_BIT_MASK ) != 0U ) )
 			{
 				/* Can not handle, fragmented packet. */
 				eReturn = eReleaseBuffer;
@@ -1559,6 +2062,10 @@ eFrameProcessingResult_t eReturn = eProcessBuffer;
 			#if( ipconfigUSE_LLMNR == 1 )
 				/* Is it the LLMNR multicast address? */
 				( ulDestinationIPAddress != ipLLMNR_IP_ADDR ) &&
+			#endif
+			#if( ipconfigUSE_IGMP != 0 )
+				/* Is it a multicast group that was joined, or 224.0.0.1 ? */
+				( xIGMPIsMemberOf( ulDestinationIPAddress ) == pdFALSE ) &&
 			#endif
 				/* Or (during DHCP negotiation) we have no IP-address yet? */
 				( *ipLOCAL_IP_ADDRESS_POINTER != 0UL ) )
@@ -1579,22 +2086,12 @@ eFrameProcessingResult_t eReturn = eProcessBuffer;
 		define, so that the checksum won't be checked again here */
 		if (eReturn == eProcessBuffer )
 		{
-			/* Is the IP header checksum correct? */
-			if( ( pxIPHeader->ucProtocol != ( uint8_t ) ipPROTOCOL_ICMP ) &&
-				( usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ( size_t ) uxHeaderLength ) != ipCORRECT_CRC ) )
-			{
-				/* Check sum in IP-header not correct. */
-				eReturn = eReleaseBuffer;
-			}
-			/* Is the upper-layer checksum (TCP/UDP/ICMP) correct? */
-			else if( usGenerateProtocolChecksum( ( uint8_t * )( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
-			{
-				/* Protocol checksum not accepted. */
-				eReturn = eReleaseBuffer;
-			}
-			else
+			#if( ipconfigUSE_LOOPBACK != 0 )
+			/* No checksums were calculated for packets sent to this node. */
+			if( xLoopbackFrame == pdFALSE )
+			#endif
 			{
-				/* The checksum of the received packet is OK. */
+				eReturn = prvCheckIPChecksums( pxIPHeader, pxNetworkBuffer, uxHeaderLength );
 			}
 		}
 	}
@@ -1610,6 +2107,47 @@ eFrameProcessingResult_t eReturn = eProcessBuffer;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 )
+	static eFrameProcessingResult_t prvCheckIPChecksums( const IPHeader_t * const pxIPHeader,
+														 const NetworkBufferDescriptor_t * const pxNetworkBuffer,
+														 UBaseType_t uxHeaderLength )
+	{
+	eFrameProcessingResult_t eReturn;
+
+		/* Is the IP header checksum correct? */
+		if( ( pxIPHeader->ucProtocol != ( uint8_t ) ipPROTOCOL_ICMP ) &&
+			( usGenerateChecksum( 0U, ( const uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ( size_t ) uxHeaderLength ) != ipCORRECT_CRC ) )
+		{
+			/* Check sum in IP-header not correct. */
+			ipSTATS_INCREMENT( ulIPChecksumErrors );
+			eReturn = eReleaseBuffer;
+		}
+		#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+		else if( ipREASSEMBLY_IS_FRAGMENT( pxIPHeader->usFragmentOffset ) )
+		{
+			/* The protocol checksum covers the whole datagram, it will be
+			checked after reassembly. */
+			eReturn = eProcessBuffer;
+		}
+		#endif /* ipconfigUSE_IP_REASSEMBLY */
+		/* Is the upper-layer checksum (TCP/UDP/ICMP) correct? */
+		else if( usGenerateProtocolChecksum( ( uint8_t * )( pxNetworkBuffer->pucEthernetBuffer ), pxNetworkBuffer->xDataLength, pdFALSE ) != ipCORRECT_CRC )
+		{
+			/* Protocol checksum not accepted. */
+			ipSTATS_INCREMENT( ulProtocolChecksumErrors );
+			eReturn = eReleaseBuffer;
+		}
+		else
+		{
+			/* The checksum of the received packet is OK. */
+			eReturn = eProcessBuffer;
+		}
+
+		return eReturn;
+	}
+#endif /* ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 */
+/*-----------------------------------------------------------*/
+
 static eFrameProcessingResult_t prvProcessIPPacket( IPPacket_t * pxIPPacket, NetworkBufferDescriptor_t * const pxNetworkBuffer )
 {
 eFrameProcessingResult_t eReturn;
@@ -1631,6 +2169,17 @@ uint8_t ucProtocol;
 	/* Check if the IP headers are acceptable and if it has our destination. */
 	eReturn = prvAllowIPPacket( pxIPPacket, pxNetworkBuffer, uxHeaderLength );
 
+	#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+	{
+		if( ( eReturn == eProcessBuffer ) && ipREASSEMBLY_IS_FRAGMENT( pxIPHeader->usFragmentOffset ) )
+		{
+			/* The fragment is kept until its datagram is complete, or it is
+			released here if it can not be used. */
+			eReturn = eIPReassemblyAddFragment( pxNetworkBuffer, uxHeaderLength );
+		}
+	}
+	#endif /* ipconfigUSE_IP_REASSEMBLY */
+
 	if( eReturn == eProcessBuffer )
 	{
 		if( uxHeaderLength > ipSIZE_OF_IPv4_HEADER )
@@ -1692,6 +2241,15 @@ uint8_t ucProtocol;
 				#endif /* ( ipconfigREPLY_TO_INCOMING_PINGS == 1 ) || ( ipconfigSUPPORT_OUTGOING_PINGS == 1 ) */
 				break;
 
+			#if( ipconfigUSE_IGMP != 0 )
+				case ipPROTOCOL_IGMP :
+					/* A query, or a report of another member.  The options
+					have been removed already, 'uxHeaderLength' is the length
+					of the original IP header. */
+					eReturn = eProcessIGMPPacket( pxNetworkBuffer, uxHeaderLength );
+					break;
+			#endif /* ipconfigUSE_IGMP */
+
 			case ipPROTOCOL_UDP :
 				{
 				/* The IP packet contained a UDP frame. */
@@ -1769,6 +2327,120 @@ uint8_t ucProtocol;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_IPv6 != 0 )
+
+	static eFrameProcessingResult_t prvProcessIPv6Packet( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+	{
+	eFrameProcessingResult_t eReturn = eReleaseBuffer;
+	const IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( const IPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+	const IPHeader_IPv6_t *pxIPHeader = &( pxIPPacket->xIPHeader );
+	size_t uxPayloadLength = ( size_t ) FreeRTOS_ntohs( pxIPHeader->usPayloadLength );
+
+		if( ( pxIPHeader->ucVersionTrafficClass & 0xF0U ) != 0x60U )
+		{
+			/* Not IPv6. */
+		}
+		else if( ( sizeof( IPPacket_IPv6_t ) + uxPayloadLength ) > pxNetworkBuffer->xDataLength )
+		{
+			/* The packet claims to be longer than what was received. */
+		}
+		else if( xIPv6IsForThisNode( &( pxIPHeader->xDestinationAddress ) ) == pdFALSE )
+		{
+			/* Packet is not for this node, release it. */
+		}
+		else
+		{
+			/* Remove the Ethernet padding. */
+			pxNetworkBuffer->xDataLength = sizeof( IPPacket_IPv6_t ) + uxPayloadLength;
+			eReturn = eProcessBuffer;
+
+			#if( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 )
+			{
+				/* IPv6 has no header checksum, but the checksum of ICMPv6,
+				UDP and TCP is mandatory. */
+				#if( ipconfigUSE_LOOPBACK != 0 )
+				if( xLoopbackFrame == pdFALSE )
+				#endif
+				{
+					if( usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdFALSE ) != 0xffffU )
+					{
+						/* Also drops packets with extension headers. */
+						ipSTATS_INCREMENT( ulProtocolChecksumErrors );
+						eReturn = eReleaseBuffer;
+					}
+				}
+			}
+			#endif /* ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 */
+		}
+
+		if( eReturn == eProcessBuffer )
+		{
+			eReturn = eReleaseBuffer;
+
+			switch( pxIPHeader->ucNextHeader )
+			{
+				case ipPROTOCOL_ICMP_IPv6 :
+					if( uxPayloadLength >= ipSIZE_OF_ICMPv6_HEADER )
+					{
+						eReturn = eProcessICMPv6Packet( pxNetworkBuffer );
+					}
+					break;
+
+				case ipPROTOCOL_UDP :
+					{
+					const UDPPacket_IPv6_t *pxUDPPacket = ipPOINTER_CAST( const UDPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+
+						if( ( pxNetworkBuffer->xDataLength >= sizeof( UDPPacket_IPv6_t ) ) &&
+							( ( size_t ) FreeRTOS_ntohs( pxUDPPacket->xUDPHeader.usLength ) == uxPayloadLength ) )
+						{
+							/* The source address is read from the IPv6 header
+							when the packet is received, only the port is
+							stored. */
+							pxNetworkBuffer->usPort = pxUDPPacket->xUDPHeader.usSourcePort;
+							pxNetworkBuffer->ulIPAddress = 0UL;
+
+							if( xProcessReceivedUDPPacket_IPv6( pxNetworkBuffer, pxUDPPacket->xUDPHeader.usDestinationPort ) == pdPASS )
+							{
+								eReturn = eFrameConsumed;
+							}
+						}
+					}
+					break;
+
+			#if ipconfigUSE_TCP == 1
+				case ipPROTOCOL_TCP :
+					/* TCPPacket_IPv6_t includes room for options, a segment
+					without options is shorter. */
+					if( uxPayloadLength >= ipSIZE_OF_TCP_HEADER )
+					{
+						/* Refresh the neighbour cache, as is done for IPv4. */
+						vNDRefreshCacheEntry( &( pxIPPacket->xEthernetHeader.xSourceAddress ), &( pxIPHeader->xSourceAddress ) );
+
+						if( xProcessReceivedTCPPacket( pxNetworkBuffer ) == pdPASS )
+						{
+							eReturn = eFrameConsumed;
+						}
+
+						/* Setting this variable will cause xTCPTimerCheck()
+						to be called just before the IP-task blocks. */
+						xProcessedTCPMessage++;
+					}
+					break;
+			#endif /* ipconfigUSE_TCP */
+
+				default	:
+					/* Extension headers and other protocols are not
+					supported. */
+					break;
+			}
+		}
+
+		return eReturn;
+	}
+
+#endif /* ipconfigUSE_IPv6 */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigSUPPORT_OUTGOING_PINGS == 1 )
 
 	static void prvProcessICMPEchoReply( ICMPPacket_t * const pxICMPPacket )
@@ -2346,7 +3018,12 @@ EthernetHeader_t *pxEthernetHeader;
 		( void ) memcpy( &( pxEthernetHeader->xSourceAddress) , ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
 
 		/* Send! */
-		( void ) xNetworkInterfaceOutput( pxNetworkBuffer, xReleaseAfterSend );
+		#if( ipconfigUSE_LOOPBACK != 0 )
+		if( xLoopbackOutput( pxNetworkBuffer, xReleaseAfterSend ) == pdFALSE )
+		#endif
+		{
+			( void ) xNetworkInterfaceOutput( pxNetworkBuffer, xReleaseAfterSend );
+		}
 	}
 }
 /*-----------------------------------------------------------*/
@@ -2454,6 +3131,122 @@ void FreeRTOS_SetGatewayAddress ( uint32_t ulGatewayAddress )
 #endif /* ipconfigDNS_USE_CALLBACKS != 0 */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+	void vIPSetReassemblyTimerEnableState( BaseType_t xEnableState )
+	{
+		if( xEnableState != pdFALSE )
+		{
+			prvIPTimerReload( &xReassemblyTimer, pdMS_TO_TICKS( ipREASSEMBLY_TIMER_PERIOD_MS ) );
+		}
+		else
+		{
+			xReassemblyTimer.bActive = pdFALSE_UNSIGNED;
+		}
+	}
+#endif /* ipconfigUSE_IP_REASSEMBLY */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_IGMP != 0 )
+	void vIPSetIGMPTimerEnableState( BaseType_t xEnableState )
+	{
+		if( xEnableState != pdFALSE )
+		{
+			/* A running timer keeps its phase. */
+			if( xIGMPTimer.bActive == pdFALSE_UNSIGNED )
+			{
+				prvIPTimerReload( &xIGMPTimer, pdMS_TO_TICKS( ipIGMP_TIMER_PERIOD_MS ) );
+			}
+		}
+		else
+		{
+			xIGMPTimer.bActive = pdFALSE_UNSIGNED;
+		}
+	}
+#endif /* ipconfigUSE_IGMP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_IPv6 != 0 )
+	void vIPSetIPv6TimerEnableState( BaseType_t xEnableState )
+	{
+		if( xEnableState != pdFALSE )
+		{
+			prvIPTimerReload( &xIPv6Timer, pdMS_TO_TICKS( ipIPv6_TIMER_PERIOD_MS ) );
+		}
+		else
+		{
+			xIPv6Timer.bActive = pdFALSE_UNSIGNED;
+		}
+	}
+#endif /* ipconfigUSE_IPv6 */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_LOOPBACK != 0 )
+	BaseType_t xIsLoopbackAddress( uint32_t ulIPAddress )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		if( ipIS_LOOPBACK_NETWORK( ulIPAddress ) )
+		{
+			xReturn = pdTRUE;
+		}
+		else if( ( ulIPAddress == *ipLOCAL_IP_ADDRESS_POINTER ) && ( ulIPAddress != 0UL ) )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			/* The packet will leave this node. */
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xLoopbackOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t xReleaseAfterSend )
+	{
+	const IPPacket_t *pxIPPacket = ipPOINTER_CAST( const IPPacket_t *, pxNetworkBuffer->pucEthernetBuffer );
+	NetworkBufferDescriptor_t *pxDescriptor = pxNetworkBuffer;
+	IPStackEvent_t xLoopbackEvent;
+	BaseType_t xReturn = pdFALSE;
+
+		if( ( pxIPPacket->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE ) &&
+			( xIsLoopbackAddress( pxIPPacket->xIPHeader.ulDestinationIPAddress ) != pdFALSE ) )
+		{
+			/* The packet is not given to the driver, neither now nor when it
+			can not be delivered. */
+			xReturn = pdTRUE;
+
+			if( xReleaseAfterSend == pdFALSE )
+			{
+				/* The caller will use its buffer again, so it can only be
+				passed as a copy.  In all other cases, the descriptor itself
+				travels to the receiving side. */
+				pxDescriptor = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, pxNetworkBuffer->xDataLength );
+			}
+
+			if( pxDescriptor != NULL )
+			{
+				xLoopbackEvent.eEventType = eLoopbackRxEvent;
+				xLoopbackEvent.pvData = ( void * ) pxDescriptor;
+
+				/* Don't block: the caller is often the IP-task itself. */
+				if( xSendEventStructToIPTask( &xLoopbackEvent, ( TickType_t ) 0 ) != pdPASS )
+				{
+					vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+					iptraceETHERNET_RX_EVENT_LOST();
+				}
+			}
+			else
+			{
+				iptraceETHERNET_RX_EVENT_LOST();
+			}
+		}
+
+		return xReturn;
+	}
+#endif /* ipconfigUSE_LOOPBACK */
+/*-----------------------------------------------------------*/
+
 BaseType_t xIPIsNetworkTaskReady( void )
 {
 	return xIPTaskInitialised;
@@ -2469,11 +3262,52 @@ BaseType_t FreeRTOS_IsNetworkUp( void )
 #if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
 	UBaseType_t uxGetMinimumIPQueueSpace( void )
 	{
-		return uxQueueMinimumSpace;
+	UBaseType_t uxReturn;
+
+		#if( ipconfigEVENT_QUEUE_LANES != 0 )
+		{
+			/* xNetworkEventQueue is the control lane. */
+			uxReturn = uxLaneMinimumSpace[ ipEVENT_LANE_CONTROL ];
+		}
+		#else
+		{
+			uxReturn = uxQueueMinimumSpace;
+		}
+		#endif /* ipconfigEVENT_QUEUE_LANES */
+
+		return uxReturn;
 	}
 #endif
 /*-----------------------------------------------------------*/
 
+#if( ipconfigEVENT_QUEUE_LANES != 0 ) && ( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+	UBaseType_t uxGetMinimumIPLaneSpace( BaseType_t xLane )
+	{
+	UBaseType_t uxReturn = 0U;
+
+		if( ( xLane >= 0 ) && ( xLane < ipEVENT_LANE_COUNT ) )
+		{
+			uxReturn = uxLaneMinimumSpace[ xLane ];
+		}
+
+		return uxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	uint32_t ulGetIPLaneDropCount( BaseType_t xLane )
+	{
+	uint32_t ulReturn = 0UL;
+
+		if( ( xLane >= 0 ) && ( xLane < ipEVENT_LANE_COUNT ) )
+		{
+			ulReturn = ulLaneDropCount[ xLane ];
+		}
+
+		return ulReturn;
+	}
+#endif /* ( ipconfigEVENT_QUEUE_LANES != 0 ) && ( ipconfigCHECK_IP_QUEUE_SPACE != 0 ) */
+/*-----------------------------------------------------------*/
+
 const char *FreeRTOS_strerror_r( BaseType_t xErrnum, char *pcBuffer, size_t uxLength )
 {
 const char *pcName;
@@ -0,0 +1,763 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_IP_Reassembly.h"
+
+/* Exclude the entire file if IP reassembly is not enabled. */
+#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+
+#include "NetworkBufferManagement.h"
+
+#if( ipconfigIP_REASSEMBLY_MAX_DATAGRAMS < 1 )
+	#error ipconfigIP_REASSEMBLY_MAX_DATAGRAMS must be at least 1
+#endif
+
+#if( ipconfigIP_REASSEMBLY_MAX_BUFFERS < 2 )
+	#error ipconfigIP_REASSEMBLY_MAX_BUFFERS must be at least 2
+#endif
+
+/* The number of hash buckets in which the datagrams are looked up, must be a
+power of 2. */
+#define ipREASSEMBLY_HASH_BUCKETS		( 8U )
+
+/* The largest IP payload: the IP length field is 16 bits wide and includes the
+IP header. */
+#define ipREASSEMBLY_MAX_PAYLOAD		( ( size_t ) 0xFFFFU - ipSIZE_OF_IPv4_HEADER )
+
+/* A datagram with at most this many bytes of IP payload is copied into a
+single network buffer when it is complete. */
+#define ipREASSEMBLY_MAX_FLAT_PAYLOAD	( ( size_t ) ipconfigNETWORK_MTU - ipSIZE_OF_IPv4_HEADER )
+
+/* The sum over a UDP packet and its pseudo header that indicates a correct
+checksum. */
+#define ipREASSEMBLY_CORRECT_SUM		( ( uint16_t ) 0xFFFFU )
+
+/* A datagram that is being reassembled. */
+typedef struct xIP_REASSEMBLY_DATAGRAM
+{
+	struct xIP_REASSEMBLY_DATAGRAM *pxNextInBucket;	/* The next datagram in the same hash bucket. */
+	NetworkBufferDescriptor_t *pxFragments;		/* The fragments received so far, sorted by offset and linked through 'pxNextBuffer'. */
+	uint32_t ulSourceAddress;					/* The key: source address, destination address, identification and protocol, all in network order. */
+	uint32_t ulDestinationAddress;
+	uint16_t usIdentification;
+	uint8_t ucProtocol;
+	uint8_t ucInUse;							/* pdTRUE_UNSIGNED when the record is being used. */
+	size_t uxReceivedBytes;						/* The number of payload bytes received so far. */
+	size_t uxTotalLength;						/* The length of the IP payload, known when the last fragment has been received, zero before that. */
+	UBaseType_t uxBufferCount;					/* The number of network buffers in 'pxFragments'. */
+	TickType_t xStartTime;						/* The time at which the first fragment was received. */
+} IPReassemblyDatagram_t;
+
+/*
+ * Return the hash bucket for the key of a datagram.
+ */
+static UBaseType_t prvHashBucket( uint32_t ulSourceAddress, uint32_t ulDestinationAddress, uint16_t usIdentification, uint8_t ucProtocol );
+
+/*
+ * Find the datagram that the fragment belongs to.  If there is none, a new
+ * datagram is started, if necessary at the cost of the oldest one.
+ */
+static IPReassemblyDatagram_t *prvFindDatagram( const IPHeader_t *pxIPHeader );
+
+/*
+ * Return the oldest datagram other than 'pxExclude', or NULL.
+ */
+static IPReassemblyDatagram_t *prvOldestDatagram( const IPReassemblyDatagram_t *pxExclude );
+
+/*
+ * Remove a datagram from its hash bucket and free the record.  Returns the
+ * fragments, which are now owned by the caller.
+ */
+static NetworkBufferDescriptor_t *prvTakeDatagram( IPReassemblyDatagram_t *pxDatagram );
+
+/*
+ * Drop an incomplete datagram and release its network buffers.
+ */
+static void prvDiscardDatagram( IPReassemblyDatagram_t *pxDatagram );
+
+/*
+ * Remove IP options from a fragment, and strip any Ethernet padding.
+ * Afterwards the fragment has a 20-byte IP header and 'xDataLength' covers
+ * exactly the headers plus 'uxLength' bytes of payload.
+ */
+static void prvNormaliseFragment( NetworkBufferDescriptor_t *pxNetworkBuffer, UBaseType_t uxHeaderLength, size_t uxLength );
+
+/*
+ * Insert a normalised fragment into a datagram.  If it completes the
+ * datagram, the datagram is delivered.
+ */
+static eFrameProcessingResult_t prvInsertFragment( IPReassemblyDatagram_t *pxDatagram, NetworkBufferDescriptor_t *pxNetworkBuffer,
+	size_t uxOffset, size_t uxLength, BaseType_t xLastFragment );
+
+/*
+ * Check and pass a complete datagram to the UDP layer.
+ */
+static void prvDeliverDatagram( NetworkBufferDescriptor_t *pxHead, size_t uxTotalLength );
+
+/*
+ * Verify the UDP checksum of a complete datagram, summing fragment by
+ * fragment.
+ */
+static BaseType_t prvChecksumIsValid( const NetworkBufferDescriptor_t *pxHead, size_t uxTotalLength );
+
+/*
+ * Returns pdTRUE if the UDP packet will be handled by code that can only
+ * read contiguous data: a reception call-back or the DNS/LLMNR/NBNS parser.
+ */
+static BaseType_t prvNeedsContiguousData( uint16_t usDestinationPort );
+
+/*
+ * The offset and the payload length of a normalised fragment.
+ */
+static size_t prvFragmentOffset( const NetworkBufferDescriptor_t *pxNetworkBuffer );
+static size_t prvFragmentLength( const NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+/*-----------------------------------------------------------*/
+
+/* The records of the datagrams being reassembled. */
+static IPReassemblyDatagram_t xDatagrams[ ipconfigIP_REASSEMBLY_MAX_DATAGRAMS ];
+
+/* The in-use records, hashed on their key. */
+static IPReassemblyDatagram_t *pxDatagramBuckets[ ipREASSEMBLY_HASH_BUCKETS ];
+
+/* The number of records in use, and the number of network buffers that they
+hold together. */
+static UBaseType_t uxActiveDatagrams = 0U;
+static UBaseType_t uxHeldBuffers = 0U;
+
+/*-----------------------------------------------------------*/
+
+eFrameProcessingResult_t eIPReassemblyAddFragment( NetworkBufferDescriptor_t * const pxNetworkBuffer, UBaseType_t uxHeaderLength )
+{
+eFrameProcessingResult_t eReturn = eReleaseBuffer;
+const IPHeader_t *pxIPHeader = &( ipPOINTER_CAST( const IPPacket_t *, pxNetworkBuffer->pucEthernetBuffer )->xIPHeader );
+uint16_t usFragmentField = FreeRTOS_ntohs( pxIPHeader->usFragmentOffset );
+size_t uxOffset = ( ( size_t ) ( usFragmentField & ipREASSEMBLY_OFFSET_MASK ) ) << 3;
+size_t uxIPLength = ( size_t ) FreeRTOS_ntohs( pxIPHeader->usLength );
+BaseType_t xLastFragment;
+size_t uxLength;
+IPReassemblyDatagram_t *pxDatagram;
+IPReassemblyDatagram_t *pxOldest;
+
+	if( ( usFragmentField & ipREASSEMBLY_MORE_FRAGMENTS ) == 0U )
+	{
+		xLastFragment = pdTRUE;
+	}
+	else
+	{
+		xLastFragment = pdFALSE;
+	}
+
+	if( pxIPHeader->ucProtocol != ( uint8_t ) ipPROTOCOL_UDP )
+	{
+		/* Only UDP datagrams are reassembled. */
+	}
+	else if( ( uxIPLength <= ( size_t ) uxHeaderLength ) ||
+			 ( ( uxIPLength + ipSIZE_OF_ETH_HEADER ) > pxNetworkBuffer->xDataLength ) )
+	{
+		/* The IP length is not plausible. */
+	}
+	else
+	{
+		uxLength = uxIPLength - ( size_t ) uxHeaderLength;
+
+		if( ( ( xLastFragment == pdFALSE ) && ( ( uxLength & 0x07U ) != 0U ) ) ||
+			( ( uxOffset + uxLength ) > ipREASSEMBLY_MAX_PAYLOAD ) )
+		{
+			/* All fragments but the last carry a multiple of 8 bytes, and the
+			datagram may not grow beyond the largest IP packet. */
+		}
+		else
+		{
+			prvNormaliseFragment( pxNetworkBuffer, uxHeaderLength, uxLength );
+
+			pxDatagram = prvFindDatagram( pxIPHeader );
+
+			/* Stay within the number of network buffers that may be held,
+			dropping the oldest datagrams first. */
+			while( uxHeldBuffers >= ( UBaseType_t ) ipconfigIP_REASSEMBLY_MAX_BUFFERS )
+			{
+				pxOldest = prvOldestDatagram( pxDatagram );
+
+				if( pxOldest == NULL )
+				{
+					break;
+				}
+
+				FreeRTOS_debug_printf( ( "IP reassembly: out of buffers, dropping datagram %u\n",
+					FreeRTOS_ntohs( pxOldest->usIdentification ) ) );
+				prvDiscardDatagram( pxOldest );
+			}
+
+			if( uxHeldBuffers >= ( UBaseType_t ) ipconfigIP_REASSEMBLY_MAX_BUFFERS )
+			{
+				/* This datagram alone has used up all buffers. */
+				prvDiscardDatagram( pxDatagram );
+			}
+			else
+			{
+				eReturn = prvInsertFragment( pxDatagram, pxNetworkBuffer, uxOffset, uxLength, xLastFragment );
+			}
+		}
+	}
+
+	return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vIPReassemblyAgeDatagrams( void )
+{
+TickType_t xNow = xTaskGetTickCount();
+UBaseType_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIP_REASSEMBLY_MAX_DATAGRAMS; uxIndex++ )
+	{
+		if( ( xDatagrams[ uxIndex ].ucInUse != pdFALSE_UNSIGNED ) &&
+			( ( xNow - xDatagrams[ uxIndex ].xStartTime ) >= pdMS_TO_TICKS( ipconfigIP_REASSEMBLY_TIMEOUT_MS ) ) )
+		{
+			FreeRTOS_debug_printf( ( "IP reassembly: datagram %u timed out, %u bytes received\n",
+				FreeRTOS_ntohs( xDatagrams[ uxIndex ].usIdentification ),
+				( unsigned ) xDatagrams[ uxIndex ].uxReceivedBytes ) );
+			prvDiscardDatagram( &( xDatagrams[ uxIndex ] ) );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t uxIPReassemblyPayloadLength( const NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+const NetworkBufferDescriptor_t *pxBuffer;
+size_t uxLength = pxNetworkBuffer->xDataLength - ipUDP_PAYLOAD_OFFSET_IPv4;
+
+	for( pxBuffer = pxNetworkBuffer->pxNextBuffer; pxBuffer != NULL; pxBuffer = pxBuffer->pxNextBuffer )
+	{
+		uxLength += prvFragmentLength( pxBuffer );
+	}
+
+	return uxLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t uxIPReassemblyCopyPayload( const NetworkBufferDescriptor_t *pxNetworkBuffer, uint8_t *pucTarget, size_t uxMaxLength )
+{
+const NetworkBufferDescriptor_t *pxBuffer = pxNetworkBuffer;
+size_t uxStart = ipUDP_PAYLOAD_OFFSET_IPv4;
+size_t uxCopied = 0U;
+size_t uxCount;
+
+	/* The first buffer has a UDP header, the others start with payload right
+	after the IP header. */
+	while( ( pxBuffer != NULL ) && ( uxCopied < uxMaxLength ) )
+	{
+		uxCount = pxBuffer->xDataLength - uxStart;
+
+		if( uxCount > ( uxMaxLength - uxCopied ) )
+		{
+			uxCount = uxMaxLength - uxCopied;
+		}
+
+		( void ) memcpy( &( pucTarget[ uxCopied ] ), &( pxBuffer->pucEthernetBuffer[ uxStart ] ), uxCount );
+		uxCopied += uxCount;
+		uxStart = ipIP_PAYLOAD_OFFSET;
+		pxBuffer = pxBuffer->pxNextBuffer;
+	}
+
+	return uxCopied;
+}
+/*-----------------------------------------------------------*/
+
+void vIPReassemblyReleaseDatagram( NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+NetworkBufferDescriptor_t *pxBuffer = pxNetworkBuffer;
+NetworkBufferDescriptor_t *pxNext;
+
+	while( pxBuffer != NULL )
+	{
+		pxNext = pxBuffer->pxNextBuffer;
+		pxBuffer->pxNextBuffer = NULL;
+		vReleaseNetworkBufferAndDescriptor( pxBuffer );
+		pxBuffer = pxNext;
+	}
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t *pxIPReassemblyFlattenDatagram( NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+NetworkBufferDescriptor_t *pxReturn = pxNetworkBuffer;
+const NetworkBufferDescriptor_t *pxBuffer;
+size_t uxTotalLength;
+size_t uxPosition;
+
+	if( pxNetworkBuffer->pxNextBuffer != NULL )
+	{
+		/* The length of the UDP header and payload. */
+		uxTotalLength = ipSIZE_OF_UDP_HEADER + uxIPReassemblyPayloadLength( pxNetworkBuffer );
+
+		/* A network buffer of a fixed size can only hold a datagram that
+		would also fit in a single frame. */
+		if( ( xBufferAllocFixedSize == pdFALSE ) || ( uxTotalLength <= ipREASSEMBLY_MAX_FLAT_PAYLOAD ) )
+		{
+			pxReturn = pxGetNetworkBufferWithDescriptor( ipIP_PAYLOAD_OFFSET + uxTotalLength, ( TickType_t ) 0U );
+		}
+
+		if( pxReturn == pxNetworkBuffer )
+		{
+			/* The datagram is too long for a network buffer. */
+		}
+		else if( pxReturn == NULL )
+		{
+			/* No network buffer available, keep the chain. */
+			pxReturn = pxNetworkBuffer;
+		}
+		else
+		{
+			/* The first fragment brings the headers. */
+			uxPosition = pxNetworkBuffer->xDataLength;
+			( void ) memcpy( pxReturn->pucEthernetBuffer, pxNetworkBuffer->pucEthernetBuffer, uxPosition );
+
+			for( pxBuffer = pxNetworkBuffer->pxNextBuffer; pxBuffer != NULL; pxBuffer = pxBuffer->pxNextBuffer )
+			{
+				( void ) memcpy( &( pxReturn->pucEthernetBuffer[ uxPosition ] ),
+								 &( pxBuffer->pucEthernetBuffer[ ipIP_PAYLOAD_OFFSET ] ),
+								 prvFragmentLength( pxBuffer ) );
+				uxPosition += prvFragmentLength( pxBuffer );
+			}
+
+			pxReturn->xDataLength = uxPosition;
+			pxReturn->usPort = pxNetworkBuffer->usPort;
+			pxReturn->ulIPAddress = pxNetworkBuffer->ulIPAddress;
+			vIPReassemblyReleaseDatagram( pxNetworkBuffer );
+		}
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHashBucket( uint32_t ulSourceAddress, uint32_t ulDestinationAddress, uint16_t usIdentification, uint8_t ucProtocol )
+{
+uint32_t ulHash;
+
+	ulHash = ulSourceAddress ^ ulDestinationAddress;
+	ulHash ^= ( ( uint32_t ) usIdentification ) ^ ( ( ( uint32_t ) ucProtocol ) << 16 );
+	ulHash ^= ulHash >> 16;
+	ulHash ^= ulHash >> 8;
+
+	return ( UBaseType_t ) ( ulHash & ( ipREASSEMBLY_HASH_BUCKETS - 1U ) );
+}
+/*-----------------------------------------------------------*/
+
+static IPReassemblyDatagram_t *prvFindDatagram( const IPHeader_t *pxIPHeader )
+{
+UBaseType_t uxBucket = prvHashBucket( pxIPHeader->ulSourceIPAddress, pxIPHeader->ulDestinationIPAddress,
+										pxIPHeader->usIdentification, pxIPHeader->ucProtocol );
+IPReassemblyDatagram_t *pxDatagram;
+UBaseType_t uxIndex;
+
+	for( pxDatagram = pxDatagramBuckets[ uxBucket ]; pxDatagram != NULL; pxDatagram = pxDatagram->pxNextInBucket )
+	{
+		if( ( pxDatagram->ulSourceAddress == pxIPHeader->ulSourceIPAddress ) &&
+			( pxDatagram->ulDestinationAddress == pxIPHeader->ulDestinationIPAddress ) &&
+			( pxDatagram->usIdentification == pxIPHeader->usIdentification ) &&
+			( pxDatagram->ucProtocol == pxIPHeader->ucProtocol ) )
+		{
+			break;
+		}
+	}
+
+	if( pxDatagram == NULL )
+	{
+		/* The first fragment of a new datagram.  Look for a free record. */
+		for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIP_REASSEMBLY_MAX_DATAGRAMS; uxIndex++ )
+		{
+			if( xDatagrams[ uxIndex ].ucInUse == pdFALSE_UNSIGNED )
+			{
+				pxDatagram = &( xDatagrams[ uxIndex ] );
+				break;
+			}
+		}
+
+		if( pxDatagram == NULL )
+		{
+			/* All records are in use, give up the oldest datagram. */
+			pxDatagram = prvOldestDatagram( NULL );
+			configASSERT( pxDatagram != NULL );
+			FreeRTOS_debug_printf( ( "IP reassembly: too many datagrams, dropping datagram %u\n",
+				FreeRTOS_ntohs( pxDatagram->usIdentification ) ) );
+			prvDiscardDatagram( pxDatagram );
+		}
+
+		( void ) memset( pxDatagram, 0, sizeof( *pxDatagram ) );
+		pxDatagram->ulSourceAddress = pxIPHeader->ulSourceIPAddress;
+		pxDatagram->ulDestinationAddress = pxIPHeader->ulDestinationIPAddress;
+		pxDatagram->usIdentification = pxIPHeader->usIdentification;
+		pxDatagram->ucProtocol = pxIPHeader->ucProtocol;
+		pxDatagram->ucInUse = pdTRUE_UNSIGNED;
+		pxDatagram->xStartTime = xTaskGetTickCount();
+		pxDatagram->pxNextInBucket = pxDatagramBuckets[ uxBucket ];
+		pxDatagramBuckets[ uxBucket ] = pxDatagram;
+
+		if( uxActiveDatagrams == 0U )
+		{
+			vIPSetReassemblyTimerEnableState( pdTRUE );
+		}
+		uxActiveDatagrams++;
+	}
+
+	return pxDatagram;
+}
+/*-----------------------------------------------------------*/
+
+static IPReassemblyDatagram_t *prvOldestDatagram( const IPReassemblyDatagram_t *pxExclude )
+{
+IPReassemblyDatagram_t *pxOldest = NULL;
+TickType_t xNow = xTaskGetTickCount();
+TickType_t xAge, xOldestAge = 0U;
+UBaseType_t uxIndex;
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIP_REASSEMBLY_MAX_DATAGRAMS; uxIndex++ )
+	{
+		if( ( xDatagrams[ uxIndex ].ucInUse != pdFALSE_UNSIGNED ) && ( &( xDatagrams[ uxIndex ] ) != pxExclude ) )
+		{
+			xAge = xNow - xDatagrams[ uxIndex ].xStartTime;
+
+			if( ( pxOldest == NULL ) || ( xAge > xOldestAge ) )
+			{
+				pxOldest = &( xDatagrams[ uxIndex ] );
+				xOldestAge = xAge;
+			}
+		}
+	}
+
+	return pxOldest;
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvTakeDatagram( IPReassemblyDatagram_t *pxDatagram )
+{
+IPReassemblyDatagram_t **ppxLink;
+NetworkBufferDescriptor_t *pxFragments = pxDatagram->pxFragments;
+UBaseType_t uxBucket = prvHashBucket( pxDatagram->ulSourceAddress, pxDatagram->ulDestinationAddress,
+										pxDatagram->usIdentification, pxDatagram->ucProtocol );
+
+	for( ppxLink = &( pxDatagramBuckets[ uxBucket ] );
+		 *ppxLink != NULL;
+		 ppxLink = &( ( *ppxLink )->pxNextInBucket ) )
+	{
+		if( *ppxLink == pxDatagram )
+		{
+			*ppxLink = pxDatagram->pxNextInBucket;
+			break;
+		}
+	}
+
+	uxHeldBuffers -= pxDatagram->uxBufferCount;
+	pxDatagram->pxFragments = NULL;
+	pxDatagram->uxBufferCount = 0U;
+	pxDatagram->ucInUse = pdFALSE_UNSIGNED;
+	uxActiveDatagrams--;
+
+	if( uxActiveDatagrams == 0U )
+	{
+		vIPSetReassemblyTimerEnableState( pdFALSE );
+	}
+
+	return pxFragments;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDiscardDatagram( IPReassemblyDatagram_t *pxDatagram )
+{
+	vIPReassemblyReleaseDatagram( prvTakeDatagram( pxDatagram ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvNormaliseFragment( NetworkBufferDescriptor_t *pxNetworkBuffer, UBaseType_t uxHeaderLength, size_t uxLength )
+{
+IPHeader_t *pxIPHeader = &( ipPOINTER_CAST( IPPacket_t *, pxNetworkBuffer->pucEthernetBuffer )->xIPHeader );
+
+	if( uxHeaderLength > ipSIZE_OF_IPv4_HEADER )
+	{
+		/* Move the payload to the usual offset, just as prvProcessIPPacket()
+		does for unfragmented packets. */
+		( void ) memmove( &( pxNetworkBuffer->pucEthernetBuffer[ ipIP_PAYLOAD_OFFSET ] ),
+						  &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ( size_t ) uxHeaderLength ] ),
+						  uxLength );
+		pxIPHeader->ucVersionHeaderLength = ( uint8_t ) ( ( pxIPHeader->ucVersionHeaderLength & 0xF0U ) |
+														  ( ( ipSIZE_OF_IPv4_HEADER >> 2 ) & 0x0FU ) );
+		pxIPHeader->usLength = FreeRTOS_htons( ( uint16_t ) ( ipSIZE_OF_IPv4_HEADER + uxLength ) );
+	}
+
+	/* Short frames may have been padded by the MAC. */
+	pxNetworkBuffer->xDataLength = ipIP_PAYLOAD_OFFSET + uxLength;
+	pxNetworkBuffer->pxNextBuffer = NULL;
+}
+/*-----------------------------------------------------------*/
+
+static eFrameProcessingResult_t prvInsertFragment( IPReassemblyDatagram_t *pxDatagram, NetworkBufferDescriptor_t *pxNetworkBuffer,
+	size_t uxOffset, size_t uxLength, BaseType_t xLastFragment )
+{
+eFrameProcessingResult_t eReturn = eFrameConsumed;
+NetworkBufferDescriptor_t *pxPrevious = NULL;
+NetworkBufferDescriptor_t *pxCurrent = pxDatagram->pxFragments;
+BaseType_t xValid = pdTRUE;
+size_t uxTotalLength;
+
+	/* Find the first fragment that does not start before this one. */
+	while( ( pxCurrent != NULL ) && ( prvFragmentOffset( pxCurrent ) < uxOffset ) )
+	{
+		pxPrevious = pxCurrent;
+		pxCurrent = pxCurrent->pxNextBuffer;
+	}
+
+	if( ( pxCurrent != NULL ) && ( prvFragmentOffset( pxCurrent ) == uxOffset ) && ( prvFragmentLength( pxCurrent ) == uxLength ) )
+	{
+		/* A duplicate, probably a retransmission.  Keep the first copy. */
+		eReturn = eReleaseBuffer;
+	}
+	else
+	{
+		if( ( pxPrevious != NULL ) && ( ( prvFragmentOffset( pxPrevious ) + prvFragmentLength( pxPrevious ) ) > uxOffset ) )
+		{
+			/* Overlaps with the previous fragment. */
+			xValid = pdFALSE;
+		}
+		else if( ( pxCurrent != NULL ) && ( ( uxOffset + uxLength ) > prvFragmentOffset( pxCurrent ) ) )
+		{
+			/* Overlaps with the next fragment. */
+			xValid = pdFALSE;
+		}
+		else if( xLastFragment != pdFALSE )
+		{
+			/* The last fragment sets the length of the datagram.  There may
+			not be a second last fragment, nor data beyond it. */
+			if( ( pxDatagram->uxTotalLength != 0U ) || ( pxCurrent != NULL ) )
+			{
+				xValid = pdFALSE;
+			}
+			else
+			{
+				pxDatagram->uxTotalLength = uxOffset + uxLength;
+			}
+		}
+		else if( ( pxDatagram->uxTotalLength != 0U ) && ( ( uxOffset + uxLength ) > pxDatagram->uxTotalLength ) )
+		{
+			/* Beyond the end of the datagram. */
+			xValid = pdFALSE;
+		}
+		else
+		{
+			/* The fragment fits in. */
+		}
+
+		if( xValid == pdFALSE )
+		{
+			/* Overlapping fragments are only sent by broken or malicious
+			peers, there is no point in guessing which copy is right. */
+			FreeRTOS_debug_printf( ( "IP reassembly: inconsistent fragment, dropping datagram %u\n",
+				FreeRTOS_ntohs( pxDatagram->usIdentification ) ) );
+			prvDiscardDatagram( pxDatagram );
+			eReturn = eReleaseBuffer;
+		}
+		else
+		{
+			pxNetworkBuffer->pxNextBuffer = pxCurrent;
+
+			if( pxPrevious == NULL )
+			{
+				pxDatagram->pxFragments = pxNetworkBuffer;
+			}
+			else
+			{
+				pxPrevious->pxNextBuffer = pxNetworkBuffer;
+			}
+
+			pxDatagram->uxReceivedBytes += uxLength;
+			pxDatagram->uxBufferCount++;
+			uxHeldBuffers++;
+
+			/* As overlaps are refused, all bytes are present when their
+			number equals the length. */
+			if( ( pxDatagram->uxTotalLength != 0U ) && ( pxDatagram->uxReceivedBytes == pxDatagram->uxTotalLength ) )
+			{
+				uxTotalLength = pxDatagram->uxTotalLength;
+				prvDeliverDatagram( prvTakeDatagram( pxDatagram ), uxTotalLength );
+			}
+		}
+	}
+
+	return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeliverDatagram( NetworkBufferDescriptor_t *pxHead, size_t uxTotalLength )
+{
+UDPPacket_t *pxUDPPacket = ipPOINTER_CAST( UDPPacket_t *, pxHead->pucEthernetBuffer );
+NetworkBufferDescriptor_t *pxBuffer = pxHead;
+uint16_t usDestinationPort = pxUDPPacket->xUDPHeader.usDestinationPort;
+BaseType_t xDelivered = pdFALSE;
+
+	if( ( prvFragmentLength( pxHead ) < sizeof( UDPHeader_t ) ) ||
+		( ( size_t ) FreeRTOS_ntohs( pxUDPPacket->xUDPHeader.usLength ) != uxTotalLength ) )
+	{
+		/* The first fragment must hold the UDP header, and the UDP length
+		must agree with the reassembled length. */
+	}
+	else if( prvChecksumIsValid( pxHead, uxTotalLength ) == pdFALSE )
+	{
+		/* A NIC can not check the checksum of a fragmented packet, so it is
+		always checked here. */
+		FreeRTOS_debug_printf( ( "IP reassembly: bad UDP checksum in datagram %u\n",
+			FreeRTOS_ntohs( pxUDPPacket->xIPHeader.usIdentification ) ) );
+	}
+	else
+	{
+		/* From here on the headers describe the complete datagram. */
+		pxUDPPacket->xIPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( ipSIZE_OF_IPv4_HEADER + uxTotalLength ) );
+		pxUDPPacket->xIPHeader.usFragmentOffset = 0U;
+
+		/* Fields in pxNetworkBuffer (usPort, ulIPAddress) are network order. */
+		pxHead->usPort = pxUDPPacket->xUDPHeader.usSourcePort;
+		pxHead->ulIPAddress = pxUDPPacket->xIPHeader.ulSourceIPAddress;
+
+		if( ( uxTotalLength <= ipREASSEMBLY_MAX_FLAT_PAYLOAD ) ||
+			( prvNeedsContiguousData( usDestinationPort ) != pdFALSE ) )
+		{
+			/* A datagram that fits in a normal network buffer is copied, the
+			copy is cheap and gives zero-copy readers what they expect.  A
+			larger one is only copied for the code that can not read a chain,
+			e.g. the DNS parser that receives an EDNS0 reply. */
+			pxBuffer = pxIPReassemblyFlattenDatagram( pxHead );
+		}
+
+		if( ( pxBuffer->pxNextBuffer != NULL ) && ( prvNeedsContiguousData( usDestinationPort ) != pdFALSE ) )
+		{
+			/* Only possible with fixed-size network buffers, or when no
+			network buffer was available. */
+			FreeRTOS_debug_printf( ( "IP reassembly: datagram of %u bytes can not be passed to port %u\n",
+				( unsigned ) uxTotalLength, FreeRTOS_ntohs( usDestinationPort ) ) );
+		}
+		else if( xProcessReceivedUDPPacket( pxBuffer, usDestinationPort ) == pdPASS )
+		{
+			xDelivered = pdTRUE;
+		}
+		else
+		{
+			/* Not accepted by a socket. */
+		}
+	}
+
+	if( xDelivered == pdFALSE )
+	{
+		vIPReassemblyReleaseDatagram( pxBuffer );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvChecksumIsValid( const NetworkBufferDescriptor_t *pxHead, size_t uxTotalLength )
+{
+const UDPPacket_t *pxUDPPacket = ipPOINTER_CAST( const UDPPacket_t *, pxHead->pucEthernetBuffer );
+const NetworkBufferDescriptor_t *pxBuffer;
+uint16_t usSum;
+BaseType_t xReturn = pdTRUE;
+
+	/* A zero checksum means that the sender did not calculate it. */
+	if( pxUDPPacket->xUDPHeader.usChecksum != 0U )
+	{
+		/* The pseudo header: protocol and length, then the IP addresses. */
+		usSum = ( uint16_t ) ( uxTotalLength + ( size_t ) ipPROTOCOL_UDP );
+		usSum = usGenerateChecksum( usSum,
+									ipPOINTER_CAST( const uint8_t *, &( pxUDPPacket->xIPHeader.ulSourceIPAddress ) ),
+									( size_t ) ( 2U * ipSIZE_OF_IPv4_ADDRESS ) );
+
+		/* The UDP header and payload.  All fragments but the last have an even
+		length, so the partial sums can be chained. */
+		for( pxBuffer = pxHead; pxBuffer != NULL; pxBuffer = pxBuffer->pxNextBuffer )
+		{
+			usSum = usGenerateChecksum( usSum, &( pxBuffer->pucEthernetBuffer[ ipIP_PAYLOAD_OFFSET ] ), prvFragmentLength( pxBuffer ) );
+		}
+
+		if( usSum != ipREASSEMBLY_CORRECT_SUM )
+		{
+			xReturn = pdFALSE;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvNeedsContiguousData( uint16_t usDestinationPort )
+{
+const FreeRTOS_Socket_t *pxSocket = pxUDPSocketLookup( ( UBaseType_t ) usDestinationPort );
+BaseType_t xReturn = pdFALSE;
+
+	if( pxSocket == NULL )
+	{
+		/* It may still be a DNS, LLMNR or NBNS packet. */
+		xReturn = pdTRUE;
+	}
+	#if( ipconfigUSE_CALLBACKS == 1 )
+	else if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleReceive ) )
+	{
+		xReturn = pdTRUE;
+	}
+	#endif /* ipconfigUSE_CALLBACKS */
+	else
+	{
+		/* FreeRTOS_recvfrom() knows how to read a chain. */
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvFragmentOffset( const NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+const IPHeader_t *pxIPHeader = &( ipPOINTER_CAST( const IPPacket_t *, pxNetworkBuffer->pucEthernetBuffer )->xIPHeader );
+
+	return ( ( size_t ) ( FreeRTOS_ntohs( pxIPHeader->usFragmentOffset ) & ipREASSEMBLY_OFFSET_MASK ) ) << 3;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvFragmentLength( const NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+	return pxNetworkBuffer->xDataLength - ipIP_PAYLOAD_OFFSET;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_IP_REASSEMBLY != 0 */
@@ -0,0 +1,914 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
+#include "FreeRTOS_IPv6.h"
+
+/* Exclude the entire file if IPv6 is not enabled. */
+#if( ipconfigUSE_IPv6 != 0 )
+
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* Returned by usGenerateProtocolChecksumIPv6() for a correct incoming packet. */
+#define ipv6CORRECT_CRC					( 0xffffU )
+
+/* Returned when the length of a packet is not correct. */
+#define ipv6INVALID_LENGTH				( 0x1234U )
+
+/* The version nibble of an IPv6 header. */
+#define ipv6VERSION_6					( ( uint8_t ) 0x60U )
+
+/* Neighbour discovery messages are sent with a hop limit of 255, and a
+received message with another hop limit did not originate from the link. */
+#define ipv6ND_HOP_LIMIT				( ( uint8_t ) 255U )
+
+/* A host sends at most 3 router solicitations, 4 seconds apart (RFC 4861). */
+#define ipv6MAX_ROUTER_SOLICITATIONS	( 3U )
+#define ipv6ROUTER_SOLICITATION_INTERVAL ( 4U )
+
+/* A lifetime of all ones means infinity. */
+#define ipv6INFINITE_LIFETIME			( 0xffffffffUL )
+
+/* SLAAC only handles prefixes of 64 bits, followed by the interface ID. */
+#define ipv6SLAAC_PREFIX_LENGTH			( 64U )
+
+/*
+ * Form the link-local address fe80::/64 with the modified EUI-64 interface ID
+ * that is derived from the MAC address.
+ */
+static void prvSetLinkLocalAddress( void );
+
+/*
+ * Handle the different ND messages.  The buffer is never kept.
+ */
+static void prvProcessNeighbourSolicitation( const NetworkBufferDescriptor_t * const pxNetworkBuffer );
+static void prvProcessNeighbourAdvertisement( const NetworkBufferDescriptor_t * const pxNetworkBuffer );
+static void prvProcessRouterAdvertisement( const NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+/*
+ * Look for an ND option of the given type in 'uxLength' bytes of options.
+ * Returns a pointer to the option or NULL.
+ */
+static const uint8_t *prvFindNDOption( const uint8_t *pucOptions, size_t uxLength, uint8_t ucType );
+
+#if( ipconfigREPLY_TO_INCOMING_PINGS == 1 )
+	/*
+	 * Turn an echo request into an echo reply.
+	 */
+	static eFrameProcessingResult_t prvProcessEchoRequest( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The addresses of this node.  They are written by the IP-task and read by all
+tasks, always within a critical section. */
+static IPv6_Address_t xIPv6LinkLocalAddress;
+static IPv6_Address_t xIPv6GlobalAddress;
+static BaseType_t xIPv6HasGlobalAddress = pdFALSE;
+
+/* The number of bits of the on-link prefix of the global address. */
+static UBaseType_t uxIPv6PrefixLength = 0U;
+
+/* A static address does not expire, an address from SLAAC expires after
+'ulIPv6GlobalLifetime' seconds. */
+static BaseType_t xIPv6GlobalIsStatic = pdFALSE;
+static uint32_t ulIPv6GlobalLifetime = 0U;
+
+/* The default router, and the number of seconds that it may be used. */
+static IPv6_Address_t xIPv6RouterAddress;
+static BaseType_t xIPv6HasRouter = pdFALSE;
+static BaseType_t xIPv6RouterIsStatic = pdFALSE;
+static uint32_t ulIPv6RouterLifetime = 0U;
+
+/* The hop limit of outgoing packets, may be changed by a router. */
+static uint8_t ucIPv6HopLimit = ( uint8_t ) ipconfigIPv6_HOP_LIMIT;
+
+/* The number of router solicitations to be sent, and the seconds until the
+next one. */
+static UBaseType_t uxRouterSolicitations = 0U;
+static UBaseType_t uxRouterSolicitationTimer = 0U;
+
+/* ff02::1, the group of all nodes. */
+static const IPv6_Address_t xAllNodesAddress = { { 0xffU, 0x02U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0x01U } };
+
+/*-----------------------------------------------------------*/
+
+static void prvSetLinkLocalAddress( void )
+{
+IPv6_Address_t xAddress;
+const uint8_t *pucMAC = ipLOCAL_MAC_ADDRESS;
+
+	( void ) memset( xAddress.ucBytes, 0, sizeof( xAddress.ucBytes ) );
+	xAddress.ucBytes[ 0 ] = 0xfeU;
+	xAddress.ucBytes[ 1 ] = 0x80U;
+
+	/* The modified EUI-64: the universal/local bit is inverted and ff:fe is
+	inserted in the middle of the MAC address. */
+	xAddress.ucBytes[  8 ] = pucMAC[ 0 ] ^ 0x02U;
+	xAddress.ucBytes[  9 ] = pucMAC[ 1 ];
+	xAddress.ucBytes[ 10 ] = pucMAC[ 2 ];
+	xAddress.ucBytes[ 11 ] = 0xffU;
+	xAddress.ucBytes[ 12 ] = 0xfeU;
+	xAddress.ucBytes[ 13 ] = pucMAC[ 3 ];
+	xAddress.ucBytes[ 14 ] = pucMAC[ 4 ];
+	xAddress.ucBytes[ 15 ] = pucMAC[ 5 ];
+
+	taskENTER_CRITICAL();
+	{
+		xIPv6LinkLocalAddress = xAddress;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void FreeRTOS_SetIPv6Address( const IPv6_Address_t *pxAddress, UBaseType_t uxPrefixLength, const IPv6_Address_t *pxGateway )
+{
+	taskENTER_CRITICAL();
+	{
+		if( pxAddress != NULL )
+		{
+			xIPv6GlobalAddress = *pxAddress;
+			uxIPv6PrefixLength = uxPrefixLength;
+			xIPv6HasGlobalAddress = pdTRUE;
+			xIPv6GlobalIsStatic = pdTRUE;
+		}
+		else
+		{
+			xIPv6HasGlobalAddress = pdFALSE;
+			xIPv6GlobalIsStatic = pdFALSE;
+		}
+
+		if( pxGateway != NULL )
+		{
+			xIPv6RouterAddress = *pxGateway;
+			xIPv6HasRouter = pdTRUE;
+			xIPv6RouterIsStatic = pdTRUE;
+		}
+		else
+		{
+			xIPv6RouterIsStatic = pdFALSE;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t FreeRTOS_GetIPv6Address( IPv6_Address_t *pxLinkLocal, IPv6_Address_t *pxGlobal )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		if( pxLinkLocal != NULL )
+		{
+			*pxLinkLocal = xIPv6LinkLocalAddress;
+		}
+
+		if( pxGlobal != NULL )
+		{
+			*pxGlobal = xIPv6GlobalAddress;
+		}
+
+		xReturn = xIPv6HasGlobalAddress;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIPv6IsForThisNode( const IPv6_Address_t *pxAddress )
+{
+BaseType_t xReturn = pdFALSE;
+
+	/* Called by the IP-task, which is the only writer of the addresses. */
+	if( xIPv6IsMulticast( pxAddress ) )
+	{
+		if( memcmp( pxAddress->ucBytes, xAllNodesAddress.ucBytes, sizeof( xAllNodesAddress.ucBytes ) ) == 0 )
+		{
+			xReturn = pdTRUE;
+		}
+		/* The solicited-node group ff02::1:ffXX:XXXX, of which the last 24
+		bits are those of the address that is being resolved. */
+		else if( ( pxAddress->ucBytes[ 1 ] == 0x02U ) &&
+				 ( pxAddress->ucBytes[ 11 ] == 0x01U ) &&
+				 ( pxAddress->ucBytes[ 12 ] == 0xffU ) )
+		{
+			if( memcmp( &( pxAddress->ucBytes[ 13 ] ), &( xIPv6LinkLocalAddress.ucBytes[ 13 ] ), 3U ) == 0 )
+			{
+				xReturn = pdTRUE;
+			}
+			else if( ( xIPv6HasGlobalAddress != pdFALSE ) &&
+					 ( memcmp( &( pxAddress->ucBytes[ 13 ] ), &( xIPv6GlobalAddress.ucBytes[ 13 ] ), 3U ) == 0 ) )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				/* A solicitation for another node. */
+			}
+		}
+		else
+		{
+			/* A group that was not joined. */
+		}
+	}
+	else if( memcmp( pxAddress->ucBytes, xIPv6LinkLocalAddress.ucBytes, sizeof( pxAddress->ucBytes ) ) == 0 )
+	{
+		xReturn = pdTRUE;
+	}
+	else if( ( xIPv6HasGlobalAddress != pdFALSE ) &&
+			 ( memcmp( pxAddress->ucBytes, xIPv6GlobalAddress.ucBytes, sizeof( pxAddress->ucBytes ) ) == 0 ) )
+	{
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		/* Not for this node. */
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIPv6IsOnLink( const IPv6_Address_t *pxAddress )
+{
+BaseType_t xReturn = pdFALSE;
+UBaseType_t uxBytes, uxBits;
+
+	if( xIPv6IsLinkLocal( pxAddress ) || xIPv6IsMulticast( pxAddress ) )
+	{
+		xReturn = pdTRUE;
+	}
+	else if( ( xIPv6HasGlobalAddress != pdFALSE ) && ( uxIPv6PrefixLength <= 128U ) )
+	{
+		/* Compare the prefix, first the whole bytes and then the remaining
+		bits. */
+		uxBytes = uxIPv6PrefixLength / 8U;
+		uxBits = uxIPv6PrefixLength % 8U;
+
+		if( memcmp( pxAddress->ucBytes, xIPv6GlobalAddress.ucBytes, uxBytes ) == 0 )
+		{
+			if( uxBits == 0U )
+			{
+				xReturn = pdTRUE;
+			}
+			else if( ( ( pxAddress->ucBytes[ uxBytes ] ^ xIPv6GlobalAddress.ucBytes[ uxBytes ] ) & ( uint8_t ) ( 0xffU << ( 8U - uxBits ) ) ) == 0U )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				/* The prefix differs in the last bits. */
+			}
+		}
+	}
+	else
+	{
+		/* There is no global prefix, only link-local addresses are on-link. */
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIPv6GetNextHop( IPv6_Address_t *pxAddress )
+{
+BaseType_t xReturn = pdPASS;
+
+	if( xIPv6IsOnLink( pxAddress ) == pdFALSE )
+	{
+		if( xIPv6HasRouter != pdFALSE )
+		{
+			*pxAddress = xIPv6RouterAddress;
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vIPv6SelectSourceAddress( IPv6_Address_t *pxSource, const IPv6_Address_t *pxDestination )
+{
+	taskENTER_CRITICAL();
+	{
+		if( ( xIPv6HasGlobalAddress != pdFALSE ) &&
+			( xIPv6IsLinkLocal( pxDestination ) == pdFALSE ) &&
+			( xIPv6IsMulticast( pxDestination ) == pdFALSE ) )
+		{
+			*pxSource = xIPv6GlobalAddress;
+		}
+		else
+		{
+			*pxSource = xIPv6LinkLocalAddress;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+uint8_t ucIPv6GetHopLimit( void )
+{
+	return ucIPv6HopLimit;
+}
+/*-----------------------------------------------------------*/
+
+uint16_t usGenerateProtocolChecksumIPv6( uint8_t * const pucEthernetBuffer, size_t uxBufferLength, BaseType_t xOutgoingPacket )
+{
+IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( IPPacket_IPv6_t *, pucEthernetBuffer );
+uint8_t *pucPayload = &( pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] );
+uint16_t *pusChecksum = NULL;
+uint16_t usChecksum = ipv6INVALID_LENGTH;
+size_t uxPayloadLength = 0U;
+uint8_t ucProtocol = 0U;
+size_t uxMinimumLength = 0U;
+
+	if( uxBufferLength >= sizeof( IPPacket_IPv6_t ) )
+	{
+		uxPayloadLength = ( size_t ) FreeRTOS_ntohs( pxIPPacket->xIPHeader.usPayloadLength );
+		ucProtocol = pxIPPacket->xIPHeader.ucNextHeader;
+
+		switch( ucProtocol )
+		{
+			case ipPROTOCOL_UDP:
+				pusChecksum = ipPOINTER_CAST( uint16_t *, &( pucPayload[ offsetof( UDPHeader_t, usChecksum ) ] ) );
+				uxMinimumLength = ipSIZE_OF_UDP_HEADER;
+				break;
+
+			case ipPROTOCOL_TCP:
+				pusChecksum = ipPOINTER_CAST( uint16_t *, &( pucPayload[ offsetof( TCPHeader_t, usChecksum ) ] ) );
+				uxMinimumLength = ipSIZE_OF_TCP_HEADER;
+				break;
+
+			case ipPROTOCOL_ICMP_IPv6:
+				pusChecksum = ipPOINTER_CAST( uint16_t *, &( pucPayload[ offsetof( ICMPHeader_t, usChecksum ) ] ) );
+				uxMinimumLength = ipSIZE_OF_ICMPv6_HEADER;
+				break;
+
+			default:
+				/* Extension headers are not supported, pusChecksum stays
+				NULL. */
+				break;
+		}
+	}
+
+	if( ( pusChecksum != NULL ) &&
+		( uxPayloadLength >= uxMinimumLength ) &&
+		( ( sizeof( IPPacket_IPv6_t ) + uxPayloadLength ) <= uxBufferLength ) )
+	{
+		if( xOutgoingPacket != pdFALSE )
+		{
+			*( pusChecksum ) = 0U;
+		}
+
+		/* The pseudo header is made of the source and destination addresses,
+		the upper-layer length and the protocol.  The two addresses are the
+		last fields of the IPv6 header, so they are summed in one go with the
+		payload. */
+		usChecksum = ( uint16_t ) ( uxPayloadLength + ( size_t ) ucProtocol );
+		usChecksum = ( uint16_t ) ( ~usGenerateChecksum( usChecksum,
+														 pxIPPacket->xIPHeader.xSourceAddress.ucBytes,
+														 ( 2U * ipSIZE_OF_IPv6_ADDRESS ) + uxPayloadLength ) );
+
+		if( xOutgoingPacket == pdFALSE )
+		{
+			/* If the checksum is correct, the result is zero. */
+			if( usChecksum == 0U )
+			{
+				usChecksum = ipv6CORRECT_CRC;
+			}
+		}
+		else
+		{
+			/* A UDP checksum of zero is sent as 0xffff, in IPv6 it is
+			mandatory. */
+			if( usChecksum == 0U )
+			{
+				usChecksum = 0xffffU;
+			}
+			*( pusChecksum ) = FreeRTOS_htons( usChecksum );
+		}
+	}
+
+	return usChecksum;
+}
+/*-----------------------------------------------------------*/
+
+static const uint8_t *prvFindNDOption( const uint8_t *pucOptions, size_t uxLength, uint8_t ucType )
+{
+const uint8_t *pucReturn = NULL;
+size_t uxOffset = 0U;
+size_t uxOptionLength;
+
+	/* Every option starts with a type and a length in units of 8 bytes. */
+	while( ( uxOffset + 2U ) <= uxLength )
+	{
+		uxOptionLength = ( ( size_t ) pucOptions[ uxOffset + 1U ] ) * 8U;
+
+		if( ( uxOptionLength == 0U ) || ( ( uxOffset + uxOptionLength ) > uxLength ) )
+		{
+			/* A malformed option, ignore the rest. */
+			break;
+		}
+
+		if( pucOptions[ uxOffset ] == ucType )
+		{
+			pucReturn = &( pucOptions[ uxOffset ] );
+			break;
+		}
+
+		uxOffset += uxOptionLength;
+	}
+
+	return pucReturn;
+}
+/*-----------------------------------------------------------*/
+
+eFrameProcessingResult_t eProcessICMPv6Packet( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+eFrameProcessingResult_t eReturn = eReleaseBuffer;
+const ICMPPacket_IPv6_t *pxICMPPacket = ipPOINTER_CAST( const ICMPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+
+	/* The caller has checked the length and the checksum. */
+	switch( pxICMPPacket->xICMPHeader.ucTypeOfMessage )
+	{
+		case ipICMPv6_ECHO_REQUEST:
+			#if( ipconfigREPLY_TO_INCOMING_PINGS == 1 )
+			{
+				eReturn = prvProcessEchoRequest( pxNetworkBuffer );
+			}
+			#endif /* ipconfigREPLY_TO_INCOMING_PINGS */
+			break;
+
+		case ipICMPv6_NEIGHBOUR_SOLICITATION:
+			prvProcessNeighbourSolicitation( pxNetworkBuffer );
+			break;
+
+		case ipICMPv6_NEIGHBOUR_ADVERTISEMENT:
+			prvProcessNeighbourAdvertisement( pxNetworkBuffer );
+			break;
+
+		case ipICMPv6_ROUTER_ADVERTISEMENT:
+			prvProcessRouterAdvertisement( pxNetworkBuffer );
+			break;
+
+		default:
+			/* Echo replies, errors, router solicitations and MLD messages
+			are not handled. */
+			break;
+	}
+
+	return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigREPLY_TO_INCOMING_PINGS == 1 )
+
+	static eFrameProcessingResult_t prvProcessEchoRequest( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+	{
+	ICMPPacket_IPv6_t *pxICMPPacket = ipPOINTER_CAST( ICMPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+	IPHeader_IPv6_t *pxIPHeader = &( pxICMPPacket->xIPHeader );
+	IPv6_Address_t xSource;
+
+		/* A request to a group is answered from a unicast address. */
+		if( xIPv6IsMulticast( &( pxIPHeader->xDestinationAddress ) ) )
+		{
+			vIPv6SelectSourceAddress( &xSource, &( pxIPHeader->xSourceAddress ) );
+		}
+		else
+		{
+			xSource = pxIPHeader->xDestinationAddress;
+		}
+
+		pxIPHeader->xDestinationAddress = pxIPHeader->xSourceAddress;
+		pxIPHeader->xSourceAddress = xSource;
+		pxIPHeader->ucHopLimit = ucIPv6HopLimit;
+		pxICMPPacket->xICMPHeader.ucTypeOfMessage = ipICMPv6_ECHO_REPLY;
+
+		#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+		{
+			( void ) usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
+		}
+		#endif
+
+		return eReturnEthernetFrame;
+	}
+
+#endif /* ipconfigREPLY_TO_INCOMING_PINGS */
+/*-----------------------------------------------------------*/
+
+static void prvProcessNeighbourSolicitation( const NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+const IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( const IPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+const ICMPNeighbour_IPv6_t *pxMessage = ipPOINTER_CAST( const ICMPNeighbour_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] ) );
+const size_t uxLength = pxNetworkBuffer->xDataLength - sizeof( IPPacket_IPv6_t );
+const size_t uxFixedLength = offsetof( ICMPNeighbour_IPv6_t, ucOptionType );
+const uint8_t *pucOption;
+BaseType_t xFromUnspecified;
+size_t uxIndex;
+
+	if( ( uxLength < uxFixedLength ) ||
+		( pxIPPacket->xIPHeader.ucHopLimit != ipv6ND_HOP_LIMIT ) ||
+		( xIPv6IsMulticast( &( pxMessage->xTargetAddress ) ) ) ||
+		( xIPv6IsForThisNode( &( pxMessage->xTargetAddress ) ) == pdFALSE ) )
+	{
+		/* Not a valid solicitation, or not for one of our addresses. */
+	}
+	else
+	{
+		xFromUnspecified = pdTRUE;
+		for( uxIndex = 0U; uxIndex < sizeof( pxIPPacket->xIPHeader.xSourceAddress.ucBytes ); uxIndex++ )
+		{
+			if( pxIPPacket->xIPHeader.xSourceAddress.ucBytes[ uxIndex ] != 0U )
+			{
+				xFromUnspecified = pdFALSE;
+				break;
+			}
+		}
+
+		if( xFromUnspecified != pdFALSE )
+		{
+			/* Another node is probing for one of our addresses (DAD).  Defend
+			it with an unsolicited advertisement to all nodes. */
+			vNDSendNeighbourAdvertisement( &( pxMessage->xTargetAddress ), &xAllNodesAddress, NULL, ipND_FLAG_OVERRIDE );
+		}
+		else
+		{
+			pucOption = prvFindNDOption( &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) + uxFixedLength ] ),
+										 uxLength - uxFixedLength,
+										 ipND_OPTION_SOURCE_LINK_LAYER );
+
+			if( pucOption != NULL )
+			{
+				vNDRefreshCacheEntry( ipPOINTER_CAST( const MACAddress_t *, &( pucOption[ 2 ] ) ), &( pxIPPacket->xIPHeader.xSourceAddress ) );
+			}
+
+			/* Reply to the sender, at the MAC address that it used. */
+			vNDSendNeighbourAdvertisement( &( pxMessage->xTargetAddress ),
+										   &( pxIPPacket->xIPHeader.xSourceAddress ),
+										   &( pxIPPacket->xEthernetHeader.xSourceAddress ),
+										   ipND_FLAG_SOLICITED | ipND_FLAG_OVERRIDE );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessNeighbourAdvertisement( const NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+const IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( const IPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+const ICMPNeighbour_IPv6_t *pxMessage = ipPOINTER_CAST( const ICMPNeighbour_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] ) );
+const size_t uxLength = pxNetworkBuffer->xDataLength - sizeof( IPPacket_IPv6_t );
+const size_t uxFixedLength = offsetof( ICMPNeighbour_IPv6_t, ucOptionType );
+const uint8_t *pucOption;
+
+	if( ( uxLength < uxFixedLength ) ||
+		( pxIPPacket->xIPHeader.ucHopLimit != ipv6ND_HOP_LIMIT ) ||
+		( xIPv6IsMulticast( &( pxMessage->xTargetAddress ) ) ) )
+	{
+		/* Not a valid advertisement. */
+	}
+	else if( ( xIPv6IsForThisNode( &( pxMessage->xTargetAddress ) ) != pdFALSE ) &&
+			 ( memcmp( pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes, ipLOCAL_MAC_ADDRESS, ipMAC_ADDRESS_LENGTH_BYTES ) != 0 ) )
+	{
+		/* Another node claims one of our addresses.  The addresses are used
+		optimistically (RFC 4429), so the conflict can only be reported.  An
+		address obtained with SLAAC is given up. */
+		if( ( xIPv6HasGlobalAddress != pdFALSE ) &&
+			( xIPv6GlobalIsStatic == pdFALSE ) &&
+			( memcmp( pxMessage->xTargetAddress.ucBytes, xIPv6GlobalAddress.ucBytes, sizeof( xIPv6GlobalAddress.ucBytes ) ) == 0 ) )
+		{
+			taskENTER_CRITICAL();
+			{
+				xIPv6HasGlobalAddress = pdFALSE;
+			}
+			taskEXIT_CRITICAL();
+		}
+
+		FreeRTOS_printf( ( "IPv6: duplicate address detected, claimed by %02x:%02x:%02x:%02x:%02x:%02x\n",
+			pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes[ 0 ],
+			pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes[ 1 ],
+			pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes[ 2 ],
+			pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes[ 3 ],
+			pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes[ 4 ],
+			pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes[ 5 ] ) );
+	}
+	else
+	{
+		pucOption = prvFindNDOption( &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) + uxFixedLength ] ),
+									 uxLength - uxFixedLength,
+									 ipND_OPTION_TARGET_LINK_LAYER );
+
+		if( pucOption != NULL )
+		{
+			vNDRefreshCacheEntry( ipPOINTER_CAST( const MACAddress_t *, &( pucOption[ 2 ] ) ), &( pxMessage->xTargetAddress ) );
+		}
+		else
+		{
+			/* Without the option, the MAC address is the one that sent the
+			advertisement. */
+			vNDRefreshCacheEntry( &( pxIPPacket->xEthernetHeader.xSourceAddress ), &( pxMessage->xTargetAddress ) );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessRouterAdvertisement( const NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+const IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( const IPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+const ICMPRouterAdvertisement_IPv6_t *pxAdvertisement = ipPOINTER_CAST( const ICMPRouterAdvertisement_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] ) );
+const size_t uxLength = pxNetworkBuffer->xDataLength - sizeof( IPPacket_IPv6_t );
+const uint8_t *pucOptions = &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) + sizeof( ICMPRouterAdvertisement_IPv6_t ) ] );
+const uint8_t *pucOption;
+const NDPrefixOption_IPv6_t *pxPrefix;
+size_t uxOptionsLength;
+size_t uxOffset;
+uint16_t usLifetime;
+uint32_t ulValidLifetime;
+IPv6_Address_t xAddress;
+
+	if( ( uxLength < sizeof( ICMPRouterAdvertisement_IPv6_t ) ) ||
+		( pxIPPacket->xIPHeader.ucHopLimit != ipv6ND_HOP_LIMIT ) ||
+		( xIPv6IsLinkLocal( &( pxIPPacket->xIPHeader.xSourceAddress ) ) == pdFALSE ) )
+	{
+		/* A router advertisement must come from a link-local address. */
+		return;
+	}
+
+	uxOptionsLength = uxLength - sizeof( ICMPRouterAdvertisement_IPv6_t );
+
+	/* A router answered, stop soliciting. */
+	uxRouterSolicitations = 0U;
+
+	if( pxAdvertisement->ucHopLimit != 0U )
+	{
+		ucIPv6HopLimit = pxAdvertisement->ucHopLimit;
+	}
+
+	pucOption = prvFindNDOption( pucOptions, uxOptionsLength, ipND_OPTION_SOURCE_LINK_LAYER );
+	if( pucOption != NULL )
+	{
+		vNDRefreshCacheEntry( ipPOINTER_CAST( const MACAddress_t *, &( pucOption[ 2 ] ) ), &( pxIPPacket->xIPHeader.xSourceAddress ) );
+	}
+
+	if( xIPv6RouterIsStatic == pdFALSE )
+	{
+		usLifetime = FreeRTOS_ntohs( pxAdvertisement->usLifetime );
+
+		if( usLifetime != 0U )
+		{
+			xIPv6RouterAddress = pxIPPacket->xIPHeader.xSourceAddress;
+			ulIPv6RouterLifetime = ( uint32_t ) usLifetime;
+			xIPv6HasRouter = pdTRUE;
+		}
+		else if( memcmp( xIPv6RouterAddress.ucBytes, pxIPPacket->xIPHeader.xSourceAddress.ucBytes, sizeof( xIPv6RouterAddress.ucBytes ) ) == 0 )
+		{
+			/* The router stops being a default router. */
+			xIPv6HasRouter = pdFALSE;
+		}
+		else
+		{
+			/* Another router that is not a default router. */
+		}
+	}
+
+	/* Look at all prefix options, a router may advertise several of them. */
+	uxOffset = 0U;
+	while( ( xIPv6GlobalIsStatic == pdFALSE ) && ( uxOffset < uxOptionsLength ) )
+	{
+		pucOption = prvFindNDOption( &( pucOptions[ uxOffset ] ), uxOptionsLength - uxOffset, ipND_OPTION_PREFIX_INFO );
+		if( pucOption == NULL )
+		{
+			break;
+		}
+
+		uxOffset = ( size_t ) ( pucOption - pucOptions ) + ( ( size_t ) pucOption[ 1 ] * 8U );
+		pxPrefix = ipPOINTER_CAST( const NDPrefixOption_IPv6_t *, pucOption );
+
+		if( ( ( size_t ) pxPrefix->ucLength * 8U ) < sizeof( NDPrefixOption_IPv6_t ) )
+		{
+			continue;
+		}
+
+		ulValidLifetime = FreeRTOS_ntohl( pxPrefix->ulValidLifeTime );
+
+		if( ( ( pxPrefix->ucFlags & ipND_PREFIX_FLAG_AUTONOMOUS ) != 0U ) &&
+			( pxPrefix->ucPrefixLength == ( uint8_t ) ipv6SLAAC_PREFIX_LENGTH ) &&
+			( xIPv6IsLinkLocal( &( pxPrefix->xPrefix ) ) == pdFALSE ) &&
+			( ulValidLifetime != 0U ) &&
+			( ulValidLifetime >= FreeRTOS_ntohl( pxPrefix->ulPreferredLifeTime ) ) )
+		{
+			/* The prefix followed by the interface ID of the link-local
+			address. */
+			( void ) memcpy( xAddress.ucBytes, pxPrefix->xPrefix.ucBytes, ipv6SLAAC_PREFIX_LENGTH / 8U );
+			( void ) memcpy( &( xAddress.ucBytes[ ipv6SLAAC_PREFIX_LENGTH / 8U ] ),
+							 &( xIPv6LinkLocalAddress.ucBytes[ ipv6SLAAC_PREFIX_LENGTH / 8U ] ),
+							 ipSIZE_OF_IPv6_ADDRESS - ( ipv6SLAAC_PREFIX_LENGTH / 8U ) );
+
+			if( ( xIPv6HasGlobalAddress == pdFALSE ) ||
+				( memcmp( xAddress.ucBytes, xIPv6GlobalAddress.ucBytes, sizeof( xAddress.ucBytes ) ) != 0 ) )
+			{
+				taskENTER_CRITICAL();
+				{
+					xIPv6GlobalAddress = xAddress;
+					uxIPv6PrefixLength = ipv6SLAAC_PREFIX_LENGTH;
+					xIPv6HasGlobalAddress = pdTRUE;
+				}
+				taskEXIT_CRITICAL();
+
+				/* The new address is used right away, a conflict will be
+				noticed when another node defends it. */
+				vNDSendNeighbourSolicitation( &xAddress, pdTRUE );
+				FreeRTOS_printf( ( "IPv6: SLAAC address configured\n" ) );
+			}
+
+			ulIPv6GlobalLifetime = ulValidLifetime;
+
+			/* Only one global address is maintained. */
+			break;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vIPv6PrepareUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer, const IPv6_Address_t *pxDestination, uint16_t usDestinationPort, uint16_t usSourcePort, BaseType_t xCalculateChecksum )
+{
+UDPPacket_IPv6_t *pxUDPPacket = ipPOINTER_CAST( UDPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+uint16_t usPayloadLength = ( uint16_t ) ( pxNetworkBuffer->xDataLength - sizeof( IPPacket_IPv6_t ) );
+
+	( void ) memcpy( pxUDPPacket->xEthernetHeader.xSourceAddress.ucBytes, ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
+	pxUDPPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+
+	pxUDPPacket->xIPHeader.ucVersionTrafficClass = ipv6VERSION_6;
+	pxUDPPacket->xIPHeader.ucTrafficClassFlow = 0U;
+	pxUDPPacket->xIPHeader.usFlowLabel = 0U;
+	pxUDPPacket->xIPHeader.usPayloadLength = FreeRTOS_htons( usPayloadLength );
+	pxUDPPacket->xIPHeader.ucNextHeader = ( uint8_t ) ipPROTOCOL_UDP;
+	pxUDPPacket->xIPHeader.ucHopLimit = ucIPv6HopLimit;
+	pxUDPPacket->xIPHeader.xDestinationAddress = *pxDestination;
+	vIPv6SelectSourceAddress( &( pxUDPPacket->xIPHeader.xSourceAddress ), pxDestination );
+
+	pxUDPPacket->xUDPHeader.usSourcePort = usSourcePort;
+	pxUDPPacket->xUDPHeader.usDestinationPort = usDestinationPort;
+	pxUDPPacket->xUDPHeader.usLength = FreeRTOS_htons( usPayloadLength );
+	pxUDPPacket->xUDPHeader.usChecksum = 0U;
+
+	/* The UDP checksum is not optional in IPv6, FREERTOS_SO_UDPCKSUM_OUT only
+	matters when the driver can calculate it. */
+	#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+	{
+		( void ) xCalculateChecksum;
+		( void ) usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
+	}
+	#else
+	{
+		if( xCalculateChecksum != pdFALSE )
+		{
+			( void ) usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
+		}
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void vIPv6SendPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( IPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+IPv6_Address_t xNextHop = pxIPPacket->xIPHeader.xDestinationAddress;
+eARPLookupResult_t eResult;
+
+	eResult = eNDGetCacheEntry( &xNextHop, &( pxIPPacket->xEthernetHeader.xDestinationAddress ) );
+
+	if( eResult == eARPCacheHit )
+	{
+		( void ) xNetworkInterfaceOutput( pxNetworkBuffer, pdTRUE );
+	}
+	else
+	{
+		if( eResult == eARPCacheMiss )
+		{
+			/* As with ARP, the packet is dropped.  The neighbour will be known
+			when the packet is sent again. */
+			vNDSendNeighbourSolicitation( &xNextHop, pdFALSE );
+		}
+		ipSTATS_INCREMENT( ulARPCacheMisses );
+		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vIPv6NetworkUp( void )
+{
+	prvSetLinkLocalAddress();
+
+	/* Probe the link-local address, and ask the routers to advertise
+	themselves. */
+	vNDSendNeighbourSolicitation( &xIPv6LinkLocalAddress, pdTRUE );
+
+	if( xIPv6GlobalIsStatic != pdFALSE )
+	{
+		vNDSendNeighbourSolicitation( &xIPv6GlobalAddress, pdTRUE );
+	}
+	else
+	{
+		/* An address from SLAAC must be confirmed by a router again. */
+		xIPv6HasGlobalAddress = pdFALSE;
+	}
+
+	if( xIPv6RouterIsStatic == pdFALSE )
+	{
+		xIPv6HasRouter = pdFALSE;
+	}
+
+	vNDSendRouterSolicitation();
+	uxRouterSolicitations = ipv6MAX_ROUTER_SOLICITATIONS - 1U;
+	uxRouterSolicitationTimer = ipv6ROUTER_SOLICITATION_INTERVAL;
+
+	vIPSetIPv6TimerEnableState( pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void vIPv6CheckTimers( void )
+{
+	if( uxRouterSolicitations != 0U )
+	{
+		uxRouterSolicitationTimer--;
+		if( uxRouterSolicitationTimer == 0U )
+		{
+			vNDSendRouterSolicitation();
+			uxRouterSolicitations--;
+			uxRouterSolicitationTimer = ipv6ROUTER_SOLICITATION_INTERVAL;
+		}
+	}
+
+	if( ( xIPv6HasGlobalAddress != pdFALSE ) &&
+		( xIPv6GlobalIsStatic == pdFALSE ) &&
+		( ulIPv6GlobalLifetime != ipv6INFINITE_LIFETIME ) )
+	{
+		ulIPv6GlobalLifetime--;
+		if( ulIPv6GlobalLifetime == 0U )
+		{
+			taskENTER_CRITICAL();
+			{
+				xIPv6HasGlobalAddress = pdFALSE;
+			}
+			taskEXIT_CRITICAL();
+			FreeRTOS_printf( ( "IPv6: SLAAC address expired\n" ) );
+		}
+	}
+
+	if( ( xIPv6HasRouter != pdFALSE ) && ( xIPv6RouterIsStatic == pdFALSE ) )
+	{
+		ulIPv6RouterLifetime--;
+		if( ulIPv6RouterLifetime == 0U )
+		{
+			xIPv6HasRouter = pdFALSE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_IPv6 != 0 */
+
+/* Provide access to private members for testing. */
+#ifdef FREERTOS_ENABLE_UNIT_TESTS
+	#include "freertos_tcp_test_access_ipv6_define.h"
+#endif
@@ -0,0 +1,417 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
+#include "FreeRTOS_IPv6.h"
+
+/* Exclude the entire file if IPv6 is not enabled. */
+#if( ipconfigUSE_IPv6 != 0 )
+
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* The neighbour cache is 4-way set associative: an address is hashed to a
+bucket of ndCACHE_WAYS entries, and only that bucket is searched. */
+#define ndCACHE_WAYS			( 4 )
+#define ndCACHE_BUCKETS			( ipconfigND_CACHE_ENTRIES / ndCACHE_WAYS )
+
+#if( ( ipconfigND_CACHE_ENTRIES % ndCACHE_WAYS ) != 0 ) || ( ipconfigND_CACHE_ENTRIES < ndCACHE_WAYS )
+	#error ipconfigND_CACHE_ENTRIES must be a non-zero multiple of 4
+#endif
+
+/* When the age of an entry drops to this value, a solicitation is sent to
+refresh it, as is done for ARP. */
+#define ndMAX_AGE_BEFORE_NEW_SOLICITATION	( 3U )
+
+/* The hop limit of all ND messages. */
+#define ndHOP_LIMIT				( ( uint8_t ) 255U )
+
+/* The length of a link-layer address option, in units of 8 bytes. */
+#define ndLINK_LAYER_OPTION_LENGTH	( ( uint8_t ) 1U )
+
+/*
+ * Returns the index of the first entry of the bucket of 'pxAddress'.
+ */
+static BaseType_t prvBucketOf( const IPv6_Address_t *pxAddress );
+
+/*
+ * Fill in the Ethernet and IPv6 headers of an ND message of 'uxICMPLength'
+ * bytes, calculate its checksum, and pass it to the driver.
+ */
+static void prvSendNDMessage( NetworkBufferDescriptor_t * const pxNetworkBuffer, const IPv6_Address_t *pxSource, const IPv6_Address_t *pxDestination, const MACAddress_t *pxDestinationMAC, size_t uxICMPLength );
+
+/*
+ * Add an entry that waits for an advertisement, unless 'pxAddress' is already
+ * in the cache.
+ */
+static void prvAddPendingEntry( const IPv6_Address_t *pxAddress );
+
+/*
+ * Map a multicast address to its MAC address 33:33:xx:xx:xx:xx.
+ */
+static void prvMulticastMAC( const IPv6_Address_t *pxAddress, MACAddress_t *pxMACAddress );
+
+/*-----------------------------------------------------------*/
+
+/* The neighbour cache. */
+static NDCacheRow_t xNDCache[ ipconfigND_CACHE_ENTRIES ];
+
+/* ff02::2, the group of all routers. */
+static const IPv6_Address_t xAllRoutersAddress = { { 0xffU, 0x02U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0x02U } };
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvBucketOf( const IPv6_Address_t *pxAddress )
+{
+uint32_t ulHash;
+
+	/* The interface ID is the part that differs between neighbours. */
+	ulHash = ( ( uint32_t ) pxAddress->ucBytes[ 12 ] << 24 ) |
+			 ( ( uint32_t ) pxAddress->ucBytes[ 13 ] << 16 ) |
+			 ( ( uint32_t ) pxAddress->ucBytes[ 14 ] << 8 ) |
+			 ( ( uint32_t ) pxAddress->ucBytes[ 15 ] );
+	ulHash ^= ulHash >> 16;
+	ulHash ^= ulHash >> 8;
+
+	return ( BaseType_t ) ( ( ulHash % ( uint32_t ) ndCACHE_BUCKETS ) * ( uint32_t ) ndCACHE_WAYS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMulticastMAC( const IPv6_Address_t *pxAddress, MACAddress_t *pxMACAddress )
+{
+	pxMACAddress->ucBytes[ 0 ] = 0x33U;
+	pxMACAddress->ucBytes[ 1 ] = 0x33U;
+	( void ) memcpy( &( pxMACAddress->ucBytes[ 2 ] ), &( pxAddress->ucBytes[ 12 ] ), 4U );
+}
+/*-----------------------------------------------------------*/
+
+void vNDRefreshCacheEntry( const MACAddress_t * pxMACAddress, const IPv6_Address_t *pxAddress )
+{
+BaseType_t xFirst, x;
+BaseType_t xUseEntry;
+uint8_t ucMinAgeFound = 0xffU;
+
+	if( ( xIPv6IsMulticast( pxAddress ) ) || ( xIPv6IsOnLink( pxAddress ) == pdFALSE ) )
+	{
+		/* Only neighbours are stored. */
+		return;
+	}
+
+	xFirst = prvBucketOf( pxAddress );
+	xUseEntry = xFirst;
+
+	for( x = xFirst; x < ( xFirst + ndCACHE_WAYS ); x++ )
+	{
+		if( memcmp( xNDCache[ x ].xIPAddress.ucBytes, pxAddress->ucBytes, sizeof( pxAddress->ucBytes ) ) == 0 )
+		{
+			/* Refresh the existing entry. */
+			xUseEntry = x;
+			break;
+		}
+
+		/* Otherwise use the oldest entry, an empty entry has age zero. */
+		if( xNDCache[ x ].ucAge < ucMinAgeFound )
+		{
+			ucMinAgeFound = xNDCache[ x ].ucAge;
+			xUseEntry = x;
+		}
+	}
+
+	xNDCache[ xUseEntry ].xIPAddress = *pxAddress;
+	xNDCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
+
+	if( pxMACAddress != NULL )
+	{
+		xNDCache[ xUseEntry ].xMACAddress = *pxMACAddress;
+		xNDCache[ xUseEntry ].ucValid = ( uint8_t ) pdTRUE;
+	}
+	else
+	{
+		/* A solicitation is outstanding. */
+		xNDCache[ xUseEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_RETRANSMISSIONS;
+		xNDCache[ xUseEntry ].ucValid = ( uint8_t ) pdFALSE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddPendingEntry( const IPv6_Address_t *pxAddress )
+{
+BaseType_t xFirst, x;
+BaseType_t xFound = pdFALSE;
+
+	xFirst = prvBucketOf( pxAddress );
+
+	for( x = xFirst; x < ( xFirst + ndCACHE_WAYS ); x++ )
+	{
+		if( ( xNDCache[ x ].ucAge != 0U ) &&
+			( memcmp( xNDCache[ x ].xIPAddress.ucBytes, pxAddress->ucBytes, sizeof( pxAddress->ucBytes ) ) == 0 ) )
+		{
+			xFound = pdTRUE;
+			break;
+		}
+	}
+
+	if( xFound == pdFALSE )
+	{
+		vNDRefreshCacheEntry( NULL, pxAddress );
+	}
+}
+/*-----------------------------------------------------------*/
+
+eARPLookupResult_t eNDGetCacheEntry( IPv6_Address_t *pxAddress, MACAddress_t * const pxMACAddress )
+{
+eARPLookupResult_t eReturn = eARPCacheMiss;
+BaseType_t xFirst, x;
+
+	if( xIPv6IsMulticast( pxAddress ) )
+	{
+		prvMulticastMAC( pxAddress, pxMACAddress );
+		eReturn = eARPCacheHit;
+	}
+	else if( xIPv6GetNextHop( pxAddress ) == pdFAIL )
+	{
+		/* Off-link, and there is no router. */
+		eReturn = eCantSendPacket;
+	}
+	else
+	{
+		xFirst = prvBucketOf( pxAddress );
+
+		for( x = xFirst; x < ( xFirst + ndCACHE_WAYS ); x++ )
+		{
+			if( ( xNDCache[ x ].ucAge != 0U ) &&
+				( memcmp( xNDCache[ x ].xIPAddress.ucBytes, pxAddress->ucBytes, sizeof( pxAddress->ucBytes ) ) == 0 ) )
+			{
+				if( xNDCache[ x ].ucValid != ( uint8_t ) pdFALSE )
+				{
+					*pxMACAddress = xNDCache[ x ].xMACAddress;
+					eReturn = eARPCacheHit;
+				}
+				break;
+			}
+		}
+	}
+
+	return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vNDAgeCache( void )
+{
+BaseType_t x;
+
+	for( x = 0; x < ipconfigND_CACHE_ENTRIES; x++ )
+	{
+		if( xNDCache[ x ].ucAge > 0U )
+		{
+			( xNDCache[ x ].ucAge )--;
+
+			/* Retransmit an unanswered solicitation, or try to refresh an
+			entry that is about to expire. */
+			if( ( xNDCache[ x ].ucValid == ( uint8_t ) pdFALSE ) ||
+				( xNDCache[ x ].ucAge <= ( uint8_t ) ndMAX_AGE_BEFORE_NEW_SOLICITATION ) )
+			{
+				if( xNDCache[ x ].ucAge != 0U )
+				{
+					vNDSendNeighbourSolicitation( &( xNDCache[ x ].xIPAddress ), pdFALSE );
+				}
+			}
+
+			if( xNDCache[ x ].ucAge == 0U )
+			{
+				/* The entry is no longer valid.  Wipe it out. */
+				( void ) memset( &( xNDCache[ x ] ), 0, sizeof( xNDCache[ x ] ) );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vNDClearCache( void )
+{
+	( void ) memset( xNDCache, 0, sizeof( xNDCache ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendNDMessage( NetworkBufferDescriptor_t * const pxNetworkBuffer, const IPv6_Address_t *pxSource, const IPv6_Address_t *pxDestination, const MACAddress_t *pxDestinationMAC, size_t uxICMPLength )
+{
+IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( IPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+
+	if( pxDestinationMAC != NULL )
+	{
+		pxIPPacket->xEthernetHeader.xDestinationAddress = *pxDestinationMAC;
+	}
+	else
+	{
+		prvMulticastMAC( pxDestination, &( pxIPPacket->xEthernetHeader.xDestinationAddress ) );
+	}
+	( void ) memcpy( pxIPPacket->xEthernetHeader.xSourceAddress.ucBytes, ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
+	pxIPPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+
+	pxIPPacket->xIPHeader.ucVersionTrafficClass = 0x60U;
+	pxIPPacket->xIPHeader.ucTrafficClassFlow = 0U;
+	pxIPPacket->xIPHeader.usFlowLabel = 0U;
+	pxIPPacket->xIPHeader.usPayloadLength = FreeRTOS_htons( ( uint16_t ) uxICMPLength );
+	pxIPPacket->xIPHeader.ucNextHeader = ( uint8_t ) ipPROTOCOL_ICMP_IPv6;
+	pxIPPacket->xIPHeader.ucHopLimit = ndHOP_LIMIT;
+	pxIPPacket->xIPHeader.xSourceAddress = *pxSource;
+	pxIPPacket->xIPHeader.xDestinationAddress = *pxDestination;
+
+	pxNetworkBuffer->xDataLength = sizeof( IPPacket_IPv6_t ) + uxICMPLength;
+
+	/* ND messages are built here, so the checksum is always calculated. */
+	( void ) usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
+
+	#if defined( ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+	{
+		if( pxNetworkBuffer->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+		{
+			( void ) memset( &( pxNetworkBuffer->pucEthernetBuffer[ pxNetworkBuffer->xDataLength ] ), 0, ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES - pxNetworkBuffer->xDataLength );
+			pxNetworkBuffer->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+		}
+	}
+	#endif
+
+	/* Only the IP-task sends ND messages. */
+	( void ) xNetworkInterfaceOutput( pxNetworkBuffer, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void vNDSendNeighbourSolicitation( const IPv6_Address_t *pxTarget, BaseType_t xForDAD )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+ICMPNeighbour_IPv6_t *pxMessage;
+IPv6_Address_t xSource, xDestination;
+size_t uxLength = sizeof( ICMPNeighbour_IPv6_t );
+
+	pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( sizeof( IPPacket_IPv6_t ) + sizeof( ICMPNeighbour_IPv6_t ), ( TickType_t ) 0U );
+
+	if( pxNetworkBuffer != NULL )
+	{
+		pxMessage = ipPOINTER_CAST( ICMPNeighbour_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] ) );
+
+		/* The solicited-node group ff02::1:ffXX:XXXX of the target. */
+		( void ) memset( xDestination.ucBytes, 0, sizeof( xDestination.ucBytes ) );
+		xDestination.ucBytes[ 0 ] = 0xffU;
+		xDestination.ucBytes[ 1 ] = 0x02U;
+		xDestination.ucBytes[ 11 ] = 0x01U;
+		xDestination.ucBytes[ 12 ] = 0xffU;
+		( void ) memcpy( &( xDestination.ucBytes[ 13 ] ), &( pxTarget->ucBytes[ 13 ] ), 3U );
+
+		( void ) memset( pxMessage, 0, sizeof( *pxMessage ) );
+		pxMessage->ucTypeOfMessage = ipICMPv6_NEIGHBOUR_SOLICITATION;
+		pxMessage->xTargetAddress = *pxTarget;
+
+		if( xForDAD != pdFALSE )
+		{
+			/* A DAD probe is sent from the unspecified address, without a
+			source link-layer address option. */
+			( void ) memset( xSource.ucBytes, 0, sizeof( xSource.ucBytes ) );
+			uxLength = offsetof( ICMPNeighbour_IPv6_t, ucOptionType );
+		}
+		else
+		{
+			vIPv6SelectSourceAddress( &xSource, pxTarget );
+			pxMessage->ucOptionType = ipND_OPTION_SOURCE_LINK_LAYER;
+			pxMessage->ucOptionLength = ndLINK_LAYER_OPTION_LENGTH;
+			( void ) memcpy( pxMessage->ucOptionBytes, ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
+
+			/* Remember that a solicitation is outstanding, so that it will be
+			repeated by vNDAgeCache(). */
+			prvAddPendingEntry( pxTarget );
+		}
+
+		prvSendNDMessage( pxNetworkBuffer, &xSource, &xDestination, NULL, uxLength );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vNDSendNeighbourAdvertisement( const IPv6_Address_t *pxTarget, const IPv6_Address_t *pxDestination, const MACAddress_t *pxDestinationMAC, uint32_t ulFlags )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+ICMPNeighbour_IPv6_t *pxMessage;
+
+	pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( sizeof( IPPacket_IPv6_t ) + sizeof( ICMPNeighbour_IPv6_t ), ( TickType_t ) 0U );
+
+	if( pxNetworkBuffer != NULL )
+	{
+		pxMessage = ipPOINTER_CAST( ICMPNeighbour_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] ) );
+
+		( void ) memset( pxMessage, 0, sizeof( *pxMessage ) );
+		pxMessage->ucTypeOfMessage = ipICMPv6_NEIGHBOUR_ADVERTISEMENT;
+		pxMessage->ulFlags = FreeRTOS_htonl( ulFlags );
+		pxMessage->xTargetAddress = *pxTarget;
+		pxMessage->ucOptionType = ipND_OPTION_TARGET_LINK_LAYER;
+		pxMessage->ucOptionLength = ndLINK_LAYER_OPTION_LENGTH;
+		( void ) memcpy( pxMessage->ucOptionBytes, ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
+
+		/* The advertisement is sent from the address that is advertised. */
+		prvSendNDMessage( pxNetworkBuffer, pxTarget, pxDestination, pxDestinationMAC, sizeof( ICMPNeighbour_IPv6_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vNDSendRouterSolicitation( void )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+ICMPRouterSolicitation_IPv6_t *pxMessage;
+IPv6_Address_t xSource;
+
+	pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( sizeof( IPPacket_IPv6_t ) + sizeof( ICMPRouterSolicitation_IPv6_t ), ( TickType_t ) 0U );
+
+	if( pxNetworkBuffer != NULL )
+	{
+		pxMessage = ipPOINTER_CAST( ICMPRouterSolicitation_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] ) );
+
+		( void ) memset( pxMessage, 0, sizeof( *pxMessage ) );
+		pxMessage->ucTypeOfMessage = ipICMPv6_ROUTER_SOLICITATION;
+		pxMessage->ucOptionType = ipND_OPTION_SOURCE_LINK_LAYER;
+		pxMessage->ucOptionLength = ndLINK_LAYER_OPTION_LENGTH;
+		( void ) memcpy( pxMessage->ucOptionBytes, ipLOCAL_MAC_ADDRESS, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
+
+		vIPv6SelectSourceAddress( &xSource, &xAllRoutersAddress );
+		prvSendNDMessage( pxNetworkBuffer, &xSource, &xAllRoutersAddress, NULL, sizeof( ICMPRouterSolicitation_IPv6_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_IPv6 != 0 */
+
+/* Provide access to private members for testing. */
+#ifdef FREERTOS_ENABLE_UNIT_TESTS
+	#include "freertos_tcp_test_access_nd_define.h"
+#endif
@@ -39,6 +39,10 @@
 #include "FreeRTOS_Sockets.h"
 #include "FreeRTOS_IP_Private.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_IP_Reassembly.h"
+#include "FreeRTOS_IGMP.h"
+#include "FreeRTOS_ARP.h"
+#include "FreeRTOS_IPv6.h"
 #include "NetworkBufferManagement.h"
 
 /* A tool to measure RAM usage. By default, it is disabled
@@ -121,6 +125,14 @@ static BaseType_t prvSockopt_so_buffer( FreeRTOS_Socket_t *pxSocket, int32_t lOp
  */
 static BaseType_t prvDetermineSocketSize( BaseType_t xDomain, BaseType_t xType, BaseType_t xProtocol, size_t *pxSocketSize );
 
+#if( ipconfigUSE_IP_STATISTICS != 0 )
+	/*
+	 * Copy the counters and the connection state of a socket.  Must be called
+	 * while the scheduler is suspended.
+	 */
+	static void prvFillSocketStats( const FreeRTOS_Socket_t *pxSocket, SocketStats_t *pxStats );
+#endif /* ipconfigUSE_IP_STATISTICS */
+
 #if( ipconfigUSE_TCP == 1 )
 	/*
 	 * Create a txStream or a rxStream, depending on the parameter 'xIsInputStream'
@@ -159,6 +171,25 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain, BaseType_t xType,
 	static BaseType_t bMayConnect( FreeRTOS_Socket_t const * pxSocket );
 #endif /* ipconfigUSE_TCP */
 
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * Called by the API: give the socket a time-out of 1 tick and ask the
+	 * IP-task to add it to xTCPTimerSocketsList.
+	 */
+	static void prvTCPTimerRequest( FreeRTOS_Socket_t *pxSocket );
+
+	/*
+	 * Executed by the IP-task: move the sockets requested by the API to
+	 * xTCPTimerSocketsList.
+	 */
+	static void prvTCPTimerCollect( void );
+
+	/*
+	 * Executed by the IP-task when a TCP socket is closed.
+	 */
+	static void prvTCPTimerRemove( FreeRTOS_Socket_t *pxSocket );
+#endif /* ipconfigUSE_TCP */
+
 #if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 
 	/* Executed by the IP-task, it will check all sockets belonging to a set */
@@ -173,6 +204,16 @@ static List_t xBoundUDPSocketsList;
 
 #if ipconfigUSE_TCP == 1
 	List_t xBoundTCPSocketsList;
+
+	/* The TCP sockets that have a time-out running, or events for their
+	owner.  xTCPTimerCheck() only visits these sockets.  The list is only
+	accessed by the IP-task. */
+	static List_t xTCPTimerSocketsList;
+
+	/* Sockets for which the API has requested a check, to be moved to
+	xTCPTimerSocketsList by the IP-task.  Accesses are protected by critical
+	sections. */
+	static FreeRTOS_Socket_t *pxTCPTimerRequests = NULL;
 #endif /* ipconfigUSE_TCP == 1 */
 
 /*-----------------------------------------------------------*/
@@ -211,6 +252,13 @@ void vNetworkSocketsInit( void )
 	#if( ipconfigUSE_TCP == 1 )
 	{
 		vListInitialise( &xBoundTCPSocketsList );
+		vListInitialise( &xTCPTimerSocketsList );
+
+		#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+		{
+			vTCPAliveTimerInit();
+		}
+		#endif
 	}
 	#endif  /* ipconfigUSE_TCP == 1 */
 }
@@ -230,7 +278,15 @@ FreeRTOS_Socket_t const *pxSocket = NULL;
 	else
 	{
 		/* Only Ethernet is currently supported. */
-		configASSERT( xDomain == FREERTOS_AF_INET );
+		#if( ipconfigUSE_IPv6 != 0 )
+		{
+			configASSERT( ( xDomain == FREERTOS_AF_INET ) || ( xDomain == FREERTOS_AF_INET6 ) );
+		}
+		#else
+		{
+			configASSERT( xDomain == FREERTOS_AF_INET );
+		}
+		#endif /* ipconfigUSE_IPv6 */
 
 		/* Check if the UDP socket-list has been initialised. */
 		configASSERT( listLIST_IS_INITIALISED( &xBoundUDPSocketsList ) );
@@ -349,6 +405,12 @@ Socket_t xReturn;
 				pxSocket->ucSocketOptions   = ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT;
 				pxSocket->ucProtocol		= ( uint8_t ) xProtocol; /* protocol: UDP or TCP */
 
+				#if( ipconfigUSE_IPv6 != 0 )
+				{
+					pxSocket->xIsIPv6 = ( xDomain == FREERTOS_AF_INET6 ) ? pdTRUE : pdFALSE;
+				}
+				#endif /* ipconfigUSE_IPv6 */
+
 				#if( ipconfigUSE_TCP == 1 )
 				{
 					if( xProtocol == FREERTOS_IPPROTO_TCP )
@@ -374,6 +436,25 @@ Socket_t xReturn;
 						/* The above values are just defaults, and can be overridden by
 						calling FreeRTOS_setsockopt().  No buffers will be allocated until a
 						socket is connected and data is exchanged. */
+
+						#if( ipconfigTCP_KEEP_ALIVE == 1 )
+						{
+							pxSocket->u.xTCP.ucKeepEnabled = pdTRUE_UNSIGNED;
+							pxSocket->u.xTCP.usKeepIdle = ( uint16_t ) ipconfigTCP_KEEP_ALIVE_INTERVAL;
+							pxSocket->u.xTCP.usKeepInterval = ( uint16_t ) ipconfigTCP_KEEP_ALIVE_PROBE_INTERVAL;
+							pxSocket->u.xTCP.ucKeepCount = ( uint8_t ) ipconfigTCP_KEEP_ALIVE_PROBE_COUNT;
+						}
+						#endif /* ipconfigTCP_KEEP_ALIVE */
+
+						vListInitialiseItem( &( pxSocket->u.xTCP.xTimerListItem ) );
+						listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xTimerListItem ), ipPOINTER_CAST( void *, pxSocket ) );
+
+						#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+						{
+							vListInitialiseItem( &( pxSocket->u.xTCP.xAliveListItem ) );
+							listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xAliveListItem ), ipPOINTER_CAST( void *, pxSocket ) );
+						}
+						#endif
 					}
 				}
 				#endif  /* ipconfigUSE_TCP == 1 */
@@ -645,12 +726,28 @@ BaseType_t xTimed = pdFALSE;
 TimeOut_t xTimeOut;
 int32_t lReturn;
 EventBits_t xEventBits = ( EventBits_t ) 0;
+size_t uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv4;
 
 	if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdTRUE ) == pdFALSE )
 	{
 		return -pdFREERTOS_ERRNO_EINVAL;
 	}
 
+	#if( ipconfigUSE_IPv6 != 0 )
+	{
+		if( socketIS_IPv6( pxSocket ) )
+		{
+			/* FreeRTOS_ReleaseUDPPayloadBuffer() can only find the network
+			buffer of an IPv4 payload, so IPv6 sockets don't do zero-copy. */
+			if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) != 0U )
+			{
+				return -pdFREERTOS_ERRNO_EINVAL;
+			}
+			uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv6;
+		}
+	}
+	#endif /* ipconfigUSE_IPv6 */
+
 	lPacketCount = ( BaseType_t ) listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
 
 	/* The function prototype is designed to maintain the expected Berkeley
@@ -743,12 +840,43 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 		}
 		taskEXIT_CRITICAL();
 
+		if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_PEEK ) == 0U )
+		{
+			iptraceRX_RECEIVED_BY_APPLICATION( pxNetworkBuffer );
+		}
+
 		/* The returned value is the length of the payload data, which is
 		calculated at the total packet size minus the headers.
 		The validity of `xDataLength` prvProcessIPPacket has been confirmed
 		in 'prvProcessIPPacket()'. */
-		lReturn = ( int32_t ) ( pxNetworkBuffer->xDataLength - sizeof( UDPPacket_t ) );
+		lReturn = ( int32_t ) ( pxNetworkBuffer->xDataLength - uxPayloadOffset );
 
+		#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+		{
+			if( pxNetworkBuffer->pxNextBuffer != NULL )
+			{
+				/* A reassembled datagram, stored in a chain of network
+				buffers. */
+				lReturn = ( int32_t ) uxIPReassemblyPayloadLength( pxNetworkBuffer );
+			}
+		}
+		#endif /* ipconfigUSE_IP_REASSEMBLY */
+
+		#if( ipconfigUSE_IPv6 != 0 )
+		if( ( pxSourceAddress != NULL ) && socketIS_IPv6( pxSocket ) )
+		{
+		struct freertos_sockaddr6 *pxSourceAddress6 = ipPOINTER_CAST( struct freertos_sockaddr6 *, pxSourceAddress );
+		const IPPacket_IPv6_t *pxIPPacket = ipPOINTER_CAST( const IPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+
+			/* The caller passed a 'struct freertos_sockaddr6'. */
+			pxSourceAddress6->sin_len = ( uint8_t ) sizeof( *pxSourceAddress6 );
+			pxSourceAddress6->sin_family = FREERTOS_AF_INET6;
+			pxSourceAddress6->sin_port = pxNetworkBuffer->usPort;
+			pxSourceAddress6->sin_flowinfo = 0UL;
+			pxSourceAddress6->sin_addr6 = pxIPPacket->xIPHeader.xSourceAddress;
+		}
+		else
+		#endif /* ipconfigUSE_IPv6 */
 		if( pxSourceAddress != NULL )
 		{
 			pxSourceAddress->sin_port = pxNetworkBuffer->usPort;
@@ -767,13 +895,56 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 
 			/* Copy the received data into the provided buffer, then release the
 			network buffer. */
-			( void ) memcpy( pvBuffer, &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ), ( size_t )lReturn );
+			#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+			if( pxNetworkBuffer->pxNextBuffer != NULL )
+			{
+				( void ) uxIPReassemblyCopyPayload( pxNetworkBuffer, ( uint8_t * ) pvBuffer, ( size_t ) lReturn );
+
+				if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_PEEK ) == 0U )
+				{
+					vIPReassemblyReleaseDatagram( pxNetworkBuffer );
+				}
+			}
+			else
+			#endif /* ipconfigUSE_IP_REASSEMBLY */
+			{
+				( void ) memcpy( pvBuffer, &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ), ( size_t )lReturn );
 
+				if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_PEEK ) == 0U )
+				{
+					vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+				}
+			}
+		}
+		#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+		else if( pxNetworkBuffer->pxNextBuffer != NULL )
+		{
+			/* A datagram that spans several network buffers can not be passed
+			as a single pointer, copy it into a single network buffer.  When
+			peeking, the chain must stay in the list of the socket, so it can
+			only be read with a copy. */
 			if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_PEEK ) == 0U )
 			{
-				vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+				pxNetworkBuffer = pxIPReassemblyFlattenDatagram( pxNetworkBuffer );
+
+				if( pxNetworkBuffer->pxNextBuffer != NULL )
+				{
+					/* Too long for a network buffer of a fixed size, or no
+					network buffer available. */
+					vIPReassemblyReleaseDatagram( pxNetworkBuffer );
+					lReturn = -pdFREERTOS_ERRNO_ENOBUFS;
+				}
+				else
+				{
+					*( ( void** ) pvBuffer ) = ipPOINTER_CAST( void *, &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ) );
+				}
+			}
+			else
+			{
+				lReturn = -pdFREERTOS_ERRNO_ENOBUFS;
 			}
 		}
+		#endif /* ipconfigUSE_IP_REASSEMBLY */
 		else
 		{
 			/* The zero copy flag was set.  pvBuffer is not a buffer into which
@@ -782,7 +953,7 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 			placed. */
 			/* 9079: (Note -- conversion from pointer to void to pointer to other type [MISRA 2012 Rule 11.5, advisory]) */
 			/* 9087: (Note -- cast performed between a pointer to object type and a pointer to a different object type [MISRA 2012 Rule 11.3, required]) */
-			*( ( void** ) pvBuffer ) = ipPOINTER_CAST( void *, &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ) );
+			*( ( void** ) pvBuffer ) = ipPOINTER_CAST( void *, &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ) );
 		}
 
 	}
@@ -810,9 +981,10 @@ IPStackEvent_t xStackTxEvent = { eStackTxEvent, NULL };
 TimeOut_t xTimeOut;
 TickType_t xTicksToWait;
 int32_t lReturn = 0;
-FreeRTOS_Socket_t const * pxSocket;
-const size_t uxMaxPayloadLength = ( size_t ) ipMAX_UDP_PAYLOAD_LENGTH;
-const size_t uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv4;
+BaseType_t xSent = pdPASS;
+FreeRTOS_Socket_t * pxSocket;
+size_t uxMaxPayloadLength = ( size_t ) ipMAX_UDP_PAYLOAD_LENGTH;
+size_t uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv4;
 
 
 	pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
@@ -823,6 +995,21 @@ const size_t uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv4;
 	( void ) xDestinationAddressLength;
 	configASSERT( pvBuffer != NULL );
 
+	#if( ipconfigUSE_IPv6 != 0 )
+	{
+		if( socketIS_IPv6( pxSocket ) )
+		{
+			/* See FreeRTOS_recvfrom(), IPv6 sockets don't do zero-copy. */
+			if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) != 0U )
+			{
+				return -pdFREERTOS_ERRNO_EINVAL;
+			}
+			uxMaxPayloadLength = ( size_t ) ipMAX_UDP_PAYLOAD_LENGTH_IPv6;
+			uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv6;
+		}
+	}
+	#endif /* ipconfigUSE_IPv6 */
+
 	if( uxTotalDataLength <= ( size_t ) uxMaxPayloadLength )
 	{
 		/* If the socket is not already bound to an address, bind it now.
@@ -882,7 +1069,7 @@ const size_t uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv4;
 			if( pxNetworkBuffer != NULL )
 			{
 				/* xDataLength is the size of the total packet, including the Ethernet header. */
-				pxNetworkBuffer->xDataLength = uxTotalDataLength + sizeof( UDPPacket_t );
+				pxNetworkBuffer->xDataLength = uxTotalDataLength + uxPayloadOffset;
 				pxNetworkBuffer->usPort = pxDestinationAddress->sin_port;
 				pxNetworkBuffer->usBoundPort = ( uint16_t ) socketGET_SOCKET_PORT( pxSocket );
 				pxNetworkBuffer->ulIPAddress = pxDestinationAddress->sin_addr;
@@ -894,11 +1081,41 @@ const size_t uxPayloadOffset = ( size_t ) ipUDP_PAYLOAD_OFFSET_IPv4;
 				/* Tell the networking task that the packet needs sending. */
 				xStackTxEvent.pvData = pxNetworkBuffer;
 
-				/* Ask the IP-task to send this packet */
-				if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) == pdPASS )
+				#if( ipconfigUSE_IPv6 != 0 )
+				if( socketIS_IPv6( pxSocket ) )
+				{
+				const struct freertos_sockaddr6 *pxDestination6 = ipPOINTER_CAST( const struct freertos_sockaddr6 *, pxDestinationAddress );
+
+					/* The headers are filled in by this task, the IP-task only
+					looks up the MAC address of the next hop. */
+					vIPv6PrepareUDPPacket( pxNetworkBuffer,
+										   &( pxDestination6->sin_addr6 ),
+										   pxDestination6->sin_port,
+										   pxNetworkBuffer->usBoundPort,
+										   ( ( pxSocket->ucSocketOptions & ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT ) != 0U ) ? pdTRUE : pdFALSE );
+					xStackTxEvent.eEventType = eIPv6TxEvent;
+					xSent = xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait );
+				}
+				else
+				#endif /* ipconfigUSE_IPv6 */
+				#if( ipconfigUDP_DIRECT_SEND != 0 )
+				/* With FREERTOS_SO_UDP_DIRECT_SEND, the packet is passed to the
+				driver by this task, unless the destination MAC address is not
+				known yet. */
+				if( ( pxSocket->u.xUDP.xDirectSend == pdFALSE ) ||
+					( xSendUDPPacketDirect( pxNetworkBuffer ) == pdFAIL ) )
+				#endif /* ipconfigUDP_DIRECT_SEND */
+				{
+					/* Ask the IP-task to send this packet */
+					xSent = xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait );
+				}
+
+				if( xSent == pdPASS )
 				{
 					/* The packet was successfully sent to the IP task. */
 					lReturn = ( int32_t ) uxTotalDataLength;
+					ipSOCKET_STATS_ADD( pxSocket, ulTxPackets, 1U );
+					ipSOCKET_STATS_ADD( pxSocket, ulTxBytes, uxTotalDataLength );
 					#if( ipconfigUSE_CALLBACKS == 1 )
 					{
 						if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
@@ -1124,6 +1341,17 @@ struct freertos_sockaddr * pxAddress = pxBindAddress;
 				}
 				#endif /* ipconfigETHERNET_DRIVER_FILTERS_PACKETS */
 			}
+
+			#if( ipconfigUSE_IGMP != 0 )
+			{
+				/* Groups joined before the bind become active now. */
+				if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_UDP ) &&
+					( pxSocket->u.xUDP.ulMulticastFilter != 0U ) )
+				{
+					vIGMPUpdateGroups();
+				}
+			}
+			#endif /* ipconfigUSE_IGMP */
 		}
 	}
 	#if( ipconfigALLOW_SOCKET_SEND_WITHOUT_BIND == 0 )
@@ -1236,6 +1464,14 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 			/* In case this is a child socket, make sure the child-count of the
 			parent socket is decreased. */
 			prvTCPSetSocketCount( pxSocket );
+
+			prvTCPTimerRemove( pxSocket );
+
+			#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+			{
+				vTCPAliveTimerRemove( pxSocket );
+			}
+			#endif
 		}
 	}
 	#endif  /* ipconfigUSE_TCP == 1 */
@@ -1260,6 +1496,17 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 			( void ) xTaskResumeAll();
 		}
 		#endif /* ipconfigETHERNET_DRIVER_FILTERS_PACKETS */
+
+		#if( ipconfigUSE_IGMP != 0 )
+		{
+			/* Leave the groups that were only joined by this socket. */
+			if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_UDP ) &&
+				( pxSocket->u.xUDP.ulMulticastFilter != 0U ) )
+			{
+				vIGMPUpdateGroups();
+			}
+		}
+		#endif /* ipconfigUSE_IGMP */
 	}
 
 	/* Now the socket is not bound the list of waiting packets can be
@@ -1270,7 +1517,15 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 		{
 			pxNetworkBuffer = ipPOINTER_CAST( NetworkBufferDescriptor_t *, listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) );
 			( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
-			vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+			#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+			{
+				vIPReassemblyReleaseDatagram( pxNetworkBuffer );
+			}
+			#else
+			{
+				vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+			}
+			#endif
 		}
 	}
 
@@ -1454,6 +1709,52 @@ FreeRTOS_Socket_t *pxSocket;
 			xReturn = 0;
 			break;
 
+		#if( ipconfigUDP_DIRECT_SEND != 0 )
+			case FREERTOS_SO_UDP_DIRECT_SEND:
+				if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_UDP )
+				{
+					break;	/* will return -pdFREERTOS_ERRNO_EINVAL */
+				}
+				/* Like FREERTOS_SO_UDPCKSUM_OUT, the value is passed in the
+				pointer itself. */
+				lOptionValue = ipNUMERIC_CAST( BaseType_t, pvOptionValue );
+				if( lOptionValue == 0 )
+				{
+					pxSocket->u.xUDP.xDirectSend = pdFALSE;
+					xReturn = 0;
+				}
+				else if( xUDPDirectSendIsSupported() == pdFALSE )
+				{
+					/* The network driver did not declare that it can be called
+					by several tasks at the same time. */
+					xReturn = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+				}
+				else
+				{
+					pxSocket->u.xUDP.xDirectSend = pdTRUE;
+					xReturn = 0;
+				}
+				break;
+		#endif /* ipconfigUDP_DIRECT_SEND */
+
+		#if( ipconfigUSE_IGMP != 0 )
+			case FREERTOS_SO_IP_ADD_MEMBERSHIP:
+			case FREERTOS_SO_IP_DROP_MEMBERSHIP:
+				{
+				const struct freertos_ip_mreq *pxRequest;
+
+					if( ( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_UDP ) ||
+						( uxOptionLength < sizeof( struct freertos_ip_mreq ) ) )
+					{
+						break;	/* will return -pdFREERTOS_ERRNO_EINVAL */
+					}
+					pxRequest = ipPOINTER_CAST( const struct freertos_ip_mreq *, pvOptionValue );
+					xReturn = xIGMPSocketSetMembership( pxSocket, pxRequest->imr_multiaddr,
+						( lOptionName == FREERTOS_SO_IP_ADD_MEMBERSHIP ) ? pdTRUE : pdFALSE );
+				}
+				break;
+		#endif /* ipconfigUSE_IGMP */
+
 		#if( ipconfigUSE_CALLBACKS == 1 )
 			#if( ipconfigUSE_TCP == 1 )
 				case FREERTOS_SO_TCP_CONN_HANDLER:	/* Set a callback for (dis)connection events */
@@ -1685,7 +1986,7 @@ FreeRTOS_Socket_t *pxSocket;
 						( pxSocket->u.xTCP.ucTCPState >= ( uint8_t ) eESTABLISHED ) &&
 						( FreeRTOS_outstanding( pxSocket ) != 0 ) )
 					{
-						pxSocket->u.xTCP.usTimeout = 1U; /* to set/clear bSendFullSize */
+						prvTCPTimerRequest( pxSocket ); /* to set/clear bSendFullSize */
 						( void ) xSendEventToIPTask( eTCPTimerEvent );
 					}
 				}
@@ -1708,12 +2009,63 @@ FreeRTOS_Socket_t *pxSocket;
 					}
 
 					pxSocket->u.xTCP.bits.bWinChange = pdTRUE;
-					pxSocket->u.xTCP.usTimeout = 1U; /* to set/clear bRxStopped */
+					prvTCPTimerRequest( pxSocket ); /* to set/clear bRxStopped */
 					( void ) xSendEventToIPTask( eTCPTimerEvent );
 				}
 				xReturn = 0;
 				break;
 
+			#if( ipconfigTCP_KEEP_ALIVE == 1 )
+				/* A change of the keep-alive settings becomes effective at the
+				next keep-alive check of the connection, or immediately when it
+				is not connected yet. */
+				case FREERTOS_SO_KEEPALIVE:
+				case FREERTOS_SO_TCP_KEEPIDLE:
+				case FREERTOS_SO_TCP_KEEPINTVL:
+				case FREERTOS_SO_TCP_KEEPCNT:
+					{
+					BaseType_t xValue;
+
+						if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP )
+						{
+							break;	/* will return -pdFREERTOS_ERRNO_EINVAL */
+						}
+
+						xValue = *( ipPOINTER_CAST( const BaseType_t *, pvOptionValue ) );
+
+						if( lOptionName == FREERTOS_SO_KEEPALIVE )
+						{
+							pxSocket->u.xTCP.ucKeepEnabled = ( xValue != 0 ) ? pdTRUE_UNSIGNED : pdFALSE_UNSIGNED;
+						}
+						else if( lOptionName == FREERTOS_SO_TCP_KEEPCNT )
+						{
+							if( ( xValue < 1 ) || ( xValue > 255 ) )
+							{
+								break;	/* will return -pdFREERTOS_ERRNO_EINVAL */
+							}
+							pxSocket->u.xTCP.ucKeepCount = ( uint8_t ) xValue;
+						}
+						else
+						{
+							if( ( xValue < 1 ) || ( xValue > 65535 ) )
+							{
+								break;	/* will return -pdFREERTOS_ERRNO_EINVAL */
+							}
+
+							if( lOptionName == FREERTOS_SO_TCP_KEEPIDLE )
+							{
+								pxSocket->u.xTCP.usKeepIdle = ( uint16_t ) xValue;
+							}
+							else
+							{
+								pxSocket->u.xTCP.usKeepInterval = ( uint16_t ) xValue;
+							}
+						}
+					}
+					xReturn = 0;
+					break;
+			#endif /* ipconfigTCP_KEEP_ALIVE */
+
 		#endif  /* ipconfigUSE_TCP == 1 */
 
 		default :
@@ -1815,6 +2167,61 @@ const ListItem_t * pxResult = NULL;
 
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_IGMP != 0 )
+
+	UBaseType_t uxSocketGetMulticastGroups( uint32_t *pulGroups, UBaseType_t uxMaxGroups )
+	{
+	const ListItem_t *pxIterator;
+	const ListItem_t *pxEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xBoundUDPSocketsList ) );
+	const FreeRTOS_Socket_t *pxSocket;
+	UBaseType_t uxCount = 0U;
+	UBaseType_t uxIndex, uxGroup;
+	uint32_t ulGroupAddress;
+
+		for( pxIterator = listGET_NEXT( pxEnd );
+			 pxIterator != pxEnd;
+			 pxIterator = listGET_NEXT( pxIterator ) )
+		{
+			pxSocket = ipPOINTER_CAST( const FreeRTOS_Socket_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+			for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipconfigIGMP_MAX_SOCKET_GROUPS; uxIndex++ )
+			{
+				ulGroupAddress = pxSocket->u.xUDP.ulMulticastGroups[ uxIndex ];
+
+				if( ulGroupAddress == 0U )
+				{
+					continue;
+				}
+
+				for( uxGroup = 0U; uxGroup < uxCount; uxGroup++ )
+				{
+					if( pulGroups[ uxGroup ] == ulGroupAddress )
+					{
+						break;
+					}
+				}
+
+				if( uxGroup == uxCount )
+				{
+					if( uxCount < uxMaxGroups )
+					{
+						pulGroups[ uxCount ] = ulGroupAddress;
+						uxCount++;
+					}
+					else
+					{
+						FreeRTOS_debug_printf( ( "uxSocketGetMulticastGroups: ipconfigIGMP_MAX_GROUPS too small\n" ) );
+					}
+				}
+			}
+		}
+
+		return uxCount;
+	}
+
+#endif /* ipconfigUSE_IGMP */
+/*-----------------------------------------------------------*/
+
 FreeRTOS_Socket_t *pxUDPSocketLookup( UBaseType_t uxLocalPort )
 {
 const ListItem_t *pxListItem;
@@ -2071,14 +2478,44 @@ uint32_t ulReturn = 0UL;
 size_t FreeRTOS_GetLocalAddress( Socket_t xSocket, struct freertos_sockaddr *pxAddress )
 {
 const FreeRTOS_Socket_t *pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+size_t uxReturn = sizeof( *pxAddress );
+
+	#if( ipconfigUSE_IPv6 != 0 )
+	if( socketIS_IPv6( pxSocket ) )
+	{
+	struct freertos_sockaddr6 *pxAddress6 = ipPOINTER_CAST( struct freertos_sockaddr6 *, pxAddress );
+	IPv6_Address_t xDestination;
+
+		/* The address that is used as the source for the peer of a TCP socket,
+		otherwise the link-local address. */
+		( void ) memset( xDestination.ucBytes, 0xff, sizeof( xDestination.ucBytes ) );
+		#if( ipconfigUSE_TCP == 1 )
+		{
+			if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+			{
+				xDestination = pxSocket->u.xTCP.xRemoteIPv6Address;
+			}
+		}
+		#endif /* ipconfigUSE_TCP */
 
-	/* IP address of local machine. */
-	pxAddress->sin_addr = *ipLOCAL_IP_ADDRESS_POINTER;
+		pxAddress6->sin_len = ( uint8_t ) sizeof( *pxAddress6 );
+		pxAddress6->sin_family = FREERTOS_AF_INET6;
+		pxAddress6->sin_port = FreeRTOS_htons( pxSocket->usLocalPort );
+		pxAddress6->sin_flowinfo = 0UL;
+		vIPv6SelectSourceAddress( &( pxAddress6->sin_addr6 ), &xDestination );
+		uxReturn = sizeof( *pxAddress6 );
+	}
+	else
+	#endif /* ipconfigUSE_IPv6 */
+	{
+		/* IP address of local machine. */
+		pxAddress->sin_addr = *ipLOCAL_IP_ADDRESS_POINTER;
 
-	/* Local port on this machine. */
-	pxAddress->sin_port = FreeRTOS_htons( pxSocket->usLocalPort );
+		/* Local port on this machine. */
+		pxAddress->sin_port = FreeRTOS_htons( pxSocket->usLocalPort );
+	}
 
-	return sizeof( *pxAddress );
+	return uxReturn;
 }
 
 /*-----------------------------------------------------------*/
@@ -2233,20 +2670,32 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 				pxSocket->u.xTCP.bits.bConnPrepared = pdFALSE;
 				pxSocket->u.xTCP.ucRepCount = 0U;
 
-				FreeRTOS_debug_printf( ( "FreeRTOS_connect: %u to %lxip:%u\n",
-					pxSocket->usLocalPort, FreeRTOS_ntohl( pxAddress->sin_addr ), FreeRTOS_ntohs( pxAddress->sin_port ) ) );
-
 				/* Port on remote machine. */
 				pxSocket->u.xTCP.usRemotePort = FreeRTOS_ntohs( pxAddress->sin_port );
 
-				/* IP address of remote machine. */
-				pxSocket->u.xTCP.ulRemoteIP = FreeRTOS_ntohl( pxAddress->sin_addr );
+				#if( ipconfigUSE_IPv6 != 0 )
+				if( socketIS_IPv6( pxSocket ) )
+				{
+					/* The caller passed a 'struct freertos_sockaddr6'.  An
+					IPv6 socket has no IPv4 address. */
+					pxSocket->u.xTCP.xRemoteIPv6Address = ipPOINTER_CAST( const struct freertos_sockaddr6 *, pxAddress )->sin_addr6;
+					pxSocket->u.xTCP.ulRemoteIP = 0UL;
+				}
+				else
+				#endif /* ipconfigUSE_IPv6 */
+				{
+					FreeRTOS_debug_printf( ( "FreeRTOS_connect: %u to %lxip:%u\n",
+						pxSocket->usLocalPort, FreeRTOS_ntohl( pxAddress->sin_addr ), FreeRTOS_ntohs( pxAddress->sin_port ) ) );
+
+					/* IP address of remote machine. */
+					pxSocket->u.xTCP.ulRemoteIP = FreeRTOS_ntohl( pxAddress->sin_addr );
+				}
 
 				/* (client) internal state: socket wants to send a connect. */
 				vTCPStateChange( pxSocket, eCONNECT_SYN );
 
 				/* To start an active connect. */
-				pxSocket->u.xTCP.usTimeout = 1U;
+				prvTCPTimerRequest( pxSocket );
 
 				if( xSendEventToIPTask( eTCPTimerEvent ) != pdPASS )
 				{
@@ -2398,17 +2847,34 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 
 				if( pxClientSocket != NULL )
 				{
-					if( pxAddress != NULL )
+					#if( ipconfigUSE_IPv6 != 0 )
+					if( socketIS_IPv6( pxClientSocket ) )
 					{
-						/* IP address of remote machine. */
-						pxAddress->sin_addr = FreeRTOS_ntohl( pxClientSocket->u.xTCP.ulRemoteIP );
-
-						/* Port on remote machine. */
-						pxAddress->sin_port = FreeRTOS_ntohs( pxClientSocket->u.xTCP.usRemotePort );
+						/* The caller passed a 'struct freertos_sockaddr6'. */
+						if( pxAddress != NULL )
+						{
+							( void ) FreeRTOS_GetRemoteAddress( pxClientSocket, pxAddress );
+						}
+						if( pxAddressLength != NULL )
+						{
+							*pxAddressLength = sizeof( struct freertos_sockaddr6 );
+						}
 					}
-					if( pxAddressLength != NULL )
+					else
+					#endif /* ipconfigUSE_IPv6 */
 					{
-						*pxAddressLength = sizeof( *pxAddress );
+						if( pxAddress != NULL )
+						{
+							/* IP address of remote machine. */
+							pxAddress->sin_addr = FreeRTOS_ntohl( pxClientSocket->u.xTCP.ulRemoteIP );
+
+							/* Port on remote machine. */
+							pxAddress->sin_port = FreeRTOS_ntohs( pxClientSocket->u.xTCP.usRemotePort );
+						}
+						if( pxAddressLength != NULL )
+						{
+							*pxAddressLength = sizeof( *pxAddress );
+						}
 					}
 
 					if( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED )
@@ -2629,7 +3095,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 						{
 							pxSocket->u.xTCP.bits.bLowWater = pdFALSE;
 							pxSocket->u.xTCP.bits.bWinChange = pdTRUE;
-							pxSocket->u.xTCP.usTimeout = 1U; /* because bLowWater is cleared. */
+							prvTCPTimerRequest( pxSocket ); /* because bLowWater is cleared. */
 							( void ) xSendEventToIPTask( eTCPTimerEvent );
 						}
 					}
@@ -2820,7 +3286,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 
 					/* Send a message to the IP-task so it can work on this
 					socket.  Data is sent, let the IP-task work on it. */
-					pxSocket->u.xTCP.usTimeout = 1U;
+					prvTCPTimerRequest( pxSocket );
 
 					if( xIsCallingFromIPTask() == pdFALSE )
 					{
@@ -3009,7 +3475,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 			pxSocket->u.xTCP.bits.bUserShutdown = pdTRUE_UNSIGNED;
 
 			/* Let the IP-task perform the shutdown of the connection. */
-			pxSocket->u.xTCP.usTimeout = 1U;
+			prvTCPTimerRequest( pxSocket );
 			( void ) xSendEventToIPTask( eTCPTimerEvent );
 			xResult = 0;
 		}
@@ -3023,13 +3489,115 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 
 #if( ipconfigUSE_TCP == 1 )
 
+	static void prvTCPTimerRequest( FreeRTOS_Socket_t *pxSocket )
+	{
+		taskENTER_CRITICAL();
+		{
+			pxSocket->u.xTCP.usTimeout = 1U;
+
+			if( pxSocket->u.xTCP.ucTimerRequested == pdFALSE_UNSIGNED )
+			{
+				pxSocket->u.xTCP.ucTimerRequested = pdTRUE_UNSIGNED;
+				pxSocket->u.xTCP.pxTimerRequestNext = pxTCPTimerRequests;
+				pxTCPTimerRequests = pxSocket;
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTCPTimerCollect( void )
+	{
+	FreeRTOS_Socket_t *pxSocket;
+	FreeRTOS_Socket_t *pxNext;
+
+		taskENTER_CRITICAL();
+		{
+			pxSocket = pxTCPTimerRequests;
+			pxTCPTimerRequests = NULL;
+		}
+		taskEXIT_CRITICAL();
+
+		while( pxSocket != NULL )
+		{
+			taskENTER_CRITICAL();
+			{
+				pxNext = pxSocket->u.xTCP.pxTimerRequestNext;
+				pxSocket->u.xTCP.pxTimerRequestNext = NULL;
+				pxSocket->u.xTCP.ucTimerRequested = pdFALSE_UNSIGNED;
+			}
+			taskEXIT_CRITICAL();
+
+			if( socketSOCKET_IS_BOUND( pxSocket ) )
+			{
+				vTCPTimerAdd( pxSocket );
+			}
+
+			pxSocket = pxNext;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTCPTimerRemove( FreeRTOS_Socket_t *pxSocket )
+	{
+	FreeRTOS_Socket_t *pxPrevious = NULL;
+	FreeRTOS_Socket_t *pxIterator;
+
+		if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xTimerListItem ) ) != NULL )
+		{
+			( void ) uxListRemove( &( pxSocket->u.xTCP.xTimerListItem ) );
+		}
+
+		taskENTER_CRITICAL();
+		{
+			if( pxSocket->u.xTCP.ucTimerRequested != pdFALSE_UNSIGNED )
+			{
+				pxIterator = pxTCPTimerRequests;
+
+				while( ( pxIterator != NULL ) && ( pxIterator != pxSocket ) )
+				{
+					pxPrevious = pxIterator;
+					pxIterator = pxIterator->u.xTCP.pxTimerRequestNext;
+				}
+
+				if( pxIterator != NULL )
+				{
+					if( pxPrevious == NULL )
+					{
+						pxTCPTimerRequests = pxSocket->u.xTCP.pxTimerRequestNext;
+					}
+					else
+					{
+						pxPrevious->u.xTCP.pxTimerRequestNext = pxSocket->u.xTCP.pxTimerRequestNext;
+					}
+				}
+
+				pxSocket->u.xTCP.pxTimerRequestNext = NULL;
+				pxSocket->u.xTCP.ucTimerRequested = pdFALSE_UNSIGNED;
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTCPTimerAdd( FreeRTOS_Socket_t *pxSocket )
+	{
+		if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xTimerListItem ) ) == NULL )
+		{
+			vListInsertEnd( &xTCPTimerSocketsList, &( pxSocket->u.xTCP.xTimerListItem ) );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
 	/*
-	 * A TCP timer has expired, now check all TCP sockets for:
+	 * A TCP timer has expired, now check the TCP sockets in
+	 * xTCPTimerSocketsList for:
 	 * - Active connect
 	 * - Send a delayed ACK
 	 * - Send new data
-	 * - Send a keep-alive packet
-	 * - Check for timeout (in non-connected states only)
+	 * - Pending events for the socket owner
+	 * Idle sockets are not in the list, keep-alive messages and the anti-hang
+	 * protection are handled by vTCPAliveTimerCheck().
 	 */
 	TickType_t xTCPTimerCheck( BaseType_t xWillSleep )
 	{
@@ -3038,8 +3606,8 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 	TickType_t xNow = xTaskGetTickCount();
 	static TickType_t xLastTime = 0U;
 	TickType_t xDelta = xNow - xLastTime;
-	const ListItem_t* pxEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xBoundTCPSocketsList ) );
-	const ListItem_t *pxIterator = ( const ListItem_t * ) listGET_HEAD_ENTRY( &xBoundTCPSocketsList );
+	const ListItem_t* pxEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xTCPTimerSocketsList ) );
+	const ListItem_t *pxIterator;
 
 		xLastTime = xNow;
 
@@ -3048,34 +3616,36 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 			xDelta = 1U;
 		}
 
+		/* Sockets that got a new time-out from the API. */
+		prvTCPTimerCollect();
+
+		pxIterator = ( const ListItem_t * ) listGET_HEAD_ENTRY( &xTCPTimerSocketsList );
+
 		while( pxIterator != pxEnd )
 		{
 			pxSocket = ipPOINTER_CAST( FreeRTOS_Socket_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
 			pxIterator = ( ListItem_t * ) listGET_NEXT( pxIterator );
 
-			/* Sockets with 'tmout == 0' do not need any regular attention. */
-			if( pxSocket->u.xTCP.usTimeout == 0U )
-			{
-				continue;
-			}
-
-			if( xDelta < ( TickType_t ) pxSocket->u.xTCP.usTimeout )
+			if( pxSocket->u.xTCP.usTimeout != 0U )
 			{
-				pxSocket->u.xTCP.usTimeout = ( uint16_t ) ( ( ( TickType_t ) pxSocket->u.xTCP.usTimeout ) - xDelta );
-			}
-			else
-			{
-			BaseType_t xRc;
+				if( xDelta < ( TickType_t ) pxSocket->u.xTCP.usTimeout )
+				{
+					pxSocket->u.xTCP.usTimeout = ( uint16_t ) ( ( ( TickType_t ) pxSocket->u.xTCP.usTimeout ) - xDelta );
+				}
+				else
+				{
+				BaseType_t xRc;
 
-				pxSocket->u.xTCP.usTimeout = 0U;
-				xRc = xTCPSocketCheck( pxSocket );
+					pxSocket->u.xTCP.usTimeout = 0U;
+					xRc = xTCPSocketCheck( pxSocket );
 
-				/* Within this function, the socket might want to send a delayed
-				ack or send out data or whatever it needs to do. */
-				if( xRc < 0 )
-				{
-					/* Continue because the socket was deleted. */
-					continue;
+					/* Within this function, the socket might want to send a delayed
+					ack or send out data or whatever it needs to do. */
+					if( xRc < 0 )
+					{
+						/* Continue because the socket was deleted. */
+						continue;
+					}
 				}
 			}
 
@@ -3098,9 +3668,21 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 				}
 			}
 
-			if( ( pxSocket->u.xTCP.usTimeout != 0U ) && ( xShortest > ( TickType_t ) pxSocket->u.xTCP.usTimeout ) )
+			if( pxSocket->u.xTCP.usTimeout != 0U )
+			{
+				if( xShortest > ( TickType_t ) pxSocket->u.xTCP.usTimeout )
+				{
+					xShortest = ( TickType_t ) pxSocket->u.xTCP.usTimeout;
+				}
+			}
+			else if( pxSocket->xEventBits == 0U )
 			{
-				xShortest = ( TickType_t ) pxSocket->u.xTCP.usTimeout;
+				/* Sockets with 'tmout == 0' do not need any regular attention. */
+				( void ) uxListRemove( &( pxSocket->u.xTCP.xTimerListItem ) );
+			}
+			else
+			{
+				/* Stay in the list until the owner has been woken up. */
 			}
 		}
 
@@ -3133,7 +3715,8 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 		{
 			FreeRTOS_Socket_t *pxSocket = ipPOINTER_CAST( FreeRTOS_Socket_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
 
-			if( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort )
+			/* IPv4 and IPv6 sockets share the port numbers. */
+			if( ( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort ) && ( socketIS_IPv6( pxSocket ) == pdFALSE ) )
 			{
 				if( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN )
 				{
@@ -3167,6 +3750,49 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_IPv6 != 0 )
+
+	FreeRTOS_Socket_t *pxTCPSocketLookup_IPv6( UBaseType_t uxLocalPort, const IPv6_Address_t *pxRemoteAddress, UBaseType_t uxRemotePort )
+	{
+	const ListItem_t *pxIterator;
+	FreeRTOS_Socket_t *pxResult = NULL, *pxListenSocket = NULL;
+	const ListItem_t *pxEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( &xBoundTCPSocketsList ) );
+
+		for( pxIterator  = listGET_NEXT( pxEnd );
+			 pxIterator != pxEnd;
+			 pxIterator  = listGET_NEXT( pxIterator ) )
+		{
+			FreeRTOS_Socket_t *pxSocket = ipPOINTER_CAST( FreeRTOS_Socket_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+			if( ( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort ) && socketIS_IPv6( pxSocket ) )
+			{
+				if( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN )
+				{
+					pxListenSocket = pxSocket;
+				}
+				else if( ( pxSocket->u.xTCP.usRemotePort == ( uint16_t ) uxRemotePort ) &&
+						 ( memcmp( pxSocket->u.xTCP.xRemoteIPv6Address.ucBytes, pxRemoteAddress->ucBytes, sizeof( pxRemoteAddress->ucBytes ) ) == 0 ) )
+				{
+					pxResult = pxSocket;
+					break;
+				}
+				else
+				{
+					/* This 'pxSocket' doesn't match. */
+				}
+			}
+		}
+		if( pxResult == NULL )
+		{
+			pxResult = pxListenSocket;
+		}
+
+		return pxResult;
+	}
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_IPv6 != 0 ) */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigUSE_TCP == 1 )
 
 	const struct xSTREAM_BUFFER *FreeRTOS_get_rx_buf( Socket_t xSocket )
@@ -3402,6 +4028,21 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 		{
 			xResult = -pdFREERTOS_ERRNO_EINVAL;
 		}
+		#if( ipconfigUSE_IPv6 != 0 )
+		else if( socketIS_IPv6( pxSocket ) )
+		{
+		struct freertos_sockaddr6 *pxAddress6 = ipPOINTER_CAST( struct freertos_sockaddr6 *, pxAddress );
+
+			/* The caller passed a 'struct freertos_sockaddr6'. */
+			pxAddress6->sin_len = ( uint8_t ) sizeof( *pxAddress6 );
+			pxAddress6->sin_family = FREERTOS_AF_INET6;
+			pxAddress6->sin_port = FreeRTOS_htons( pxSocket->u.xTCP.usRemotePort );
+			pxAddress6->sin_flowinfo = 0UL;
+			pxAddress6->sin_addr6 = pxSocket->u.xTCP.xRemoteIPv6Address;
+
+			xResult = ( BaseType_t ) sizeof( *pxAddress6 );
+		}
+		#endif /* ipconfigUSE_IPv6 */
 		else
 		{
 			/* BSD style sockets communicate IP and port addresses in network
@@ -3737,6 +4378,133 @@ BaseType_t FreeRTOS_udp_rx_size( Socket_t xSocket )
 #endif /* ( ( ipconfigHAS_PRINTF != 0 ) && ( ipconfigUSE_TCP == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_IP_STATISTICS != 0 )
+
+	static void prvFillSocketStats( const FreeRTOS_Socket_t *pxSocket, SocketStats_t *pxStats )
+	{
+		( void ) memset( pxStats, 0, sizeof( *pxStats ) );
+
+		pxStats->ucProtocol = pxSocket->ucProtocol;
+		pxStats->usLocalPort = pxSocket->usLocalPort;
+		pxStats->xCounters = pxSocket->xCounters;
+
+		#if( ipconfigUSE_TCP == 1 )
+		if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+		{
+			pxStats->ucTCPState = pxSocket->u.xTCP.ucTCPState;
+			pxStats->usRemotePort = pxSocket->u.xTCP.usRemotePort;
+			pxStats->ulRemoteIP = pxSocket->u.xTCP.ulRemoteIP;
+			pxStats->ulSRTT = ( uint32_t ) pxSocket->u.xTCP.xTCPWindow.lSRTT;
+			pxStats->ulRetransmits = pxSocket->u.xTCP.xTCPWindow.ulRetransmitCount;
+			pxStats->ulRxWindow = pxSocket->u.xTCP.xTCPWindow.xSize.ulRxWindowLength;
+			pxStats->ulTxWindow = pxSocket->u.xTCP.ulWindowSize;
+
+			if( pxSocket->u.xTCP.rxStream != NULL )
+			{
+				pxStats->uxRxWaiting = uxStreamBufferGetSize( pxSocket->u.xTCP.rxStream );
+			}
+
+			if( pxSocket->u.xTCP.txStream != NULL )
+			{
+				pxStats->uxTxWaiting = uxStreamBufferGetSize( pxSocket->u.xTCP.txStream );
+			}
+		}
+		else
+		#endif /* ipconfigUSE_TCP */
+		{
+			pxStats->uxRxWaiting = ( size_t ) listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void FreeRTOS_GetIPStackStats( IPStackStats_t *pxStats )
+	{
+		taskENTER_CRITICAL();
+		{
+			/* A short copy of a few words, this also protects against a
+			counter that is being incremented in ipSTATS_INCREMENT_SHARED(). */
+			*pxStats = xIPStackStats;
+		}
+		taskEXIT_CRITICAL();
+
+		pxStats->uxNetworkBuffersFree = uxGetNumberOfFreeNetworkBuffers();
+		pxStats->uxNetworkBuffersMinimum = uxGetMinimumFreeNetworkBuffers();
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t FreeRTOS_GetSocketStats( Socket_t xSocket, SocketStats_t *pxStats )
+	{
+	const FreeRTOS_Socket_t *pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+	BaseType_t xReturn;
+
+		if( ( pxSocket == NULL ) || ( pxSocket == FREERTOS_INVALID_SOCKET ) || ( pxStats == NULL ) )
+		{
+			xReturn = -pdFREERTOS_ERRNO_EINVAL;
+		}
+		else
+		{
+			/* All counters are written by tasks, so with the scheduler
+			suspended the copy is consistent. */
+			vTaskSuspendAll();
+			{
+				prvFillSocketStats( pxSocket, pxStats );
+			}
+			( void ) xTaskResumeAll();
+			xReturn = 0;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t FreeRTOS_GetAllSocketStats( SocketStats_t *pxStats, UBaseType_t uxMaxCount )
+	{
+	const List_t *pxLists[ 2 ];
+	const ListItem_t *pxIterator;
+	const ListItem_t *pxEnd;
+	const FreeRTOS_Socket_t *pxSocket;
+	UBaseType_t uxCount = 0U;
+	BaseType_t xIndex;
+
+		#if( ipconfigUSE_TCP == 1 )
+			pxLists[ 0 ] = &xBoundTCPSocketsList;
+		#else
+			pxLists[ 0 ] = NULL;
+		#endif
+		pxLists[ 1 ] = &xBoundUDPSocketsList;
+
+		/* The bound socket lists are only changed by the IP-task, which can
+		not run while the scheduler is suspended.  The IP-task does not have
+		to do anything for the snapshot. */
+		vTaskSuspendAll();
+		{
+			for( xIndex = 0; xIndex < 2; xIndex++ )
+			{
+				if( ( pxLists[ xIndex ] == NULL ) || !listLIST_IS_INITIALISED( pxLists[ xIndex ] ) )
+				{
+					continue;
+				}
+
+				pxEnd = ipPOINTER_CAST( const ListItem_t *, listGET_END_MARKER( pxLists[ xIndex ] ) );
+
+				for( pxIterator = listGET_HEAD_ENTRY( pxLists[ xIndex ] );
+					 ( pxIterator != pxEnd ) && ( uxCount < uxMaxCount );
+					 pxIterator = listGET_NEXT( pxIterator ) )
+				{
+					pxSocket = ipPOINTER_CAST( const FreeRTOS_Socket_t *, listGET_LIST_ITEM_OWNER( pxIterator ) );
+					prvFillSocketStats( pxSocket, &( pxStats[ uxCount ] ) );
+					uxCount++;
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxCount;
+	}
+
+#endif /* ipconfigUSE_IP_STATISTICS */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 
 	void vSocketSelect( SocketSelect_t *pxSocketSet )
@@ -3961,7 +4729,7 @@ BaseType_t FreeRTOS_udp_rx_size( Socket_t xSocket )
 		xEvent.pvData = pxSocket;
 
 		/* The IP-task will call FreeRTOS_SignalSocket for this socket. */
-		xReturn = xQueueSendToBackFromISR( xNetworkEventQueue, &xEvent, pxHigherPriorityTaskWoken );
+		xReturn = xSendEventStructToIPTaskFromISR( &xEvent, pxHigherPriorityTaskWoken );
 
 		return xReturn;
 	}
@@ -52,6 +52,7 @@
 #include "NetworkInterface.h"
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_ARP.h"
+#include "FreeRTOS_IPv6.h"
 
 
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
@@ -151,9 +152,29 @@
 	#define	tcpMAXIMUM_TCP_WAKEUP_TIME_MS		20000U
 #endif
 
+/*
+ * The keep-alive and anti-hang deadlines are kept in a timer wheel of
+ * tcpALIVE_WHEEL_SLOTS lists, each covering tcpALIVE_WHEEL_RESOLUTION_MS.
+ * The number of slots must be a power of 2.  A deadline that lies more than
+ * one revolution ahead is simply visited and put back.
+ */
+#ifndef tcpALIVE_WHEEL_SLOTS
+	#define tcpALIVE_WHEEL_SLOTS				64U
+#endif
+
+#ifndef tcpALIVE_WHEEL_RESOLUTION_MS
+	#define tcpALIVE_WHEEL_RESOLUTION_MS		1000U
+#endif
+
 /* Two macro's that were introduced to work with both IPv4 and IPv6. */
-#define xIPHeaderSize( pxNetworkBuffer )	( ipSIZE_OF_IPv4_HEADER )
-#define uxIPHeaderSizeSocket( pxSocket )	( ipSIZE_OF_IPv4_HEADER )
+#if( ipconfigUSE_IPv6 != 0 )
+	#define xIPHeaderSize( pxNetworkBuffer )	\
+		( ( ipPOINTER_CAST( const EthernetHeader_t *, ( pxNetworkBuffer )->pucEthernetBuffer )->usFrameType == ipIPv6_FRAME_TYPE ) ? ipSIZE_OF_IPv6_HEADER : ipSIZE_OF_IPv4_HEADER )
+	#define uxIPHeaderSizeSocket( pxSocket )	( socketIS_IPv6( pxSocket ) ? ipSIZE_OF_IPv6_HEADER : ipSIZE_OF_IPv4_HEADER )
+#else
+	#define xIPHeaderSize( pxNetworkBuffer )	( ipSIZE_OF_IPv4_HEADER )
+	#define uxIPHeaderSizeSocket( pxSocket )	( ipSIZE_OF_IPv4_HEADER )
+#endif
 
 /*
  * Returns true if the socket must be checked.  Non-active sockets are waiting
@@ -188,6 +209,13 @@ static void prvTCPCreateWindow( FreeRTOS_Socket_t *pxSocket );
  */
 static BaseType_t prvTCPPrepareConnect( FreeRTOS_Socket_t *pxSocket );
 
+#if( ipconfigUSE_IPv6 != 0 )
+	/*
+	 * Fold an IPv6 address into 32 bits for the sequence number hook.
+	 */
+	static uint32_t prvFoldIPv6Address( const IPv6_Address_t *pxAddress );
+#endif
+
 #if( ipconfigHAS_DEBUG_PRINTF != 0 )
 	/*
 	 * For logging and debugging: make a string showing the TCP flags.
@@ -245,6 +273,11 @@ static int32_t prvTCPPrepareSend( FreeRTOS_Socket_t *pxSocket, NetworkBufferDesc
  */
 static TickType_t prvTCPNextTimeout( FreeRTOS_Socket_t *pxSocket );
 
+/*
+ * Returns pdTRUE if the socket does not need a time-out.
+ */
+static BaseType_t prvTCPSocketIsIdle( const FreeRTOS_Socket_t *pxSocket );
+
 /*
  * The API FreeRTOS_send() adds data to the TX stream.  Add
  * this data to the windowing system to it can be transmitted.
@@ -344,6 +377,21 @@ static BaseType_t prvTCPSocketCopy( FreeRTOS_Socket_t *pxNewSocket, FreeRTOS_Soc
  */
 #if( ipconfigTCP_HANG_PROTECTION == 1 )
 	static BaseType_t prvTCPStatusAgeCheck( FreeRTOS_Socket_t *pxSocket );
+	static BaseType_t prvTCPStateIsProtected( eIPTCPState_t eState );
+#endif
+
+#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+	/*
+	 * Put the socket in the timer wheel at the time of its next keep-alive or
+	 * anti-hang check, or take it out when it does not need any.
+	 */
+	static void prvTCPAliveSchedule( FreeRTOS_Socket_t *pxSocket );
+
+	/*
+	 * Returns pdTRUE and fills in the time of the next check when the socket
+	 * needs one.
+	 */
+	static BaseType_t prvTCPAliveDeadline( const FreeRTOS_Socket_t *pxSocket, TickType_t *pxDeadline );
 #endif
 
 static NetworkBufferDescriptor_t *prvTCPBufferResize( const FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer,
@@ -385,12 +433,43 @@ BaseType_t xResult;
 }
 /*-----------------------------------------------------------*/
 
+/* prvTCPSocketIsIdle() returns true if the socket has nothing to send or to
+ * retransmit, so it does not need a time-out.  A received packet or an API
+ * call will give it a new one, keep-alive messages and the anti-hang
+ * protection are driven by their own timer wheel. */
+static BaseType_t prvTCPSocketIsIdle( const FreeRTOS_Socket_t *pxSocket )
+{
+BaseType_t xResult = pdFALSE;
+
+	if( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN )
+	{
+		xResult = pdTRUE;
+	}
+	else if( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eESTABLISHED )
+	{
+		if( ( xTCPWindowTxDone( &( pxSocket->u.xTCP.xTCPWindow ) ) != pdFALSE ) &&
+			( ( pxSocket->u.xTCP.txStream == NULL ) || ( uxStreamBufferMidSpace( pxSocket->u.xTCP.txStream ) == 0U ) ) &&
+			( pxSocket->u.xTCP.bits.bUserShutdown == pdFALSE_UNSIGNED ) &&
+			( pxSocket->u.xTCP.bits.bWinChange == pdFALSE_UNSIGNED ) )
+		{
+			xResult = pdTRUE;
+		}
+	}
+	else
+	{
+		/* The other states are either short-lived, or do not get a time-out
+		at all. */
+	}
+
+	return xResult;
+}
+/*-----------------------------------------------------------*/
+
 #if( ipconfigTCP_HANG_PROTECTION == 1 )
 
-	static BaseType_t prvTCPStatusAgeCheck( FreeRTOS_Socket_t *pxSocket )
+	static BaseType_t prvTCPStateIsProtected( eIPTCPState_t eState )
 	{
 	BaseType_t xResult;
-	eIPTCPState_t eState = ipNUMERIC_CAST( eIPTCPState_t, pxSocket->u.xTCP.ucTCPState );
 
 		switch( eState )
 		{
@@ -419,6 +498,16 @@ BaseType_t xResult;
 			xResult = pdTRUE;
 			break;
 		}
+		return xResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvTCPStatusAgeCheck( FreeRTOS_Socket_t *pxSocket )
+	{
+	BaseType_t xResult;
+
+		xResult = prvTCPStateIsProtected( ipNUMERIC_CAST( eIPTCPState_t, pxSocket->u.xTCP.ucTCPState ) );
+
 		if( xResult != pdFALSE )
 		{
 			/* How much time has past since the last active moment which is
@@ -438,6 +527,8 @@ BaseType_t xResult;
 				}
 				#endif /* ipconfigHAS_DEBUG_PRINTF */
 
+				ipSTATS_INCREMENT( ulTCPConnectionsReaped );
+
 				/* Move to eCLOSE_WAIT, user may close the socket. */
 				vTCPStateChange( pxSocket, eCLOSE_WAIT );
 
@@ -454,7 +545,7 @@ BaseType_t xResult;
 						( void ) vSocketClose( pxSocket );
 					}
 					/* Return a negative value to tell to inform the caller
-					xTCPTimerCheck()
+					vTCPAliveTimerCheck()
 					that the socket got closed and may not be accessed anymore. */
 					xResult = -1;
 				}
@@ -466,13 +557,244 @@ BaseType_t xResult;
 
 #endif
 
+#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+
+	static List_t xAliveWheel[ tcpALIVE_WHEEL_SLOTS ];
+
+	/* The start time of the next slot to be checked. */
+	static TickType_t xAliveWheelTime;
+
+	#define tcpALIVE_WHEEL_TICKS		( ( TickType_t ) pdMS_TO_TICKS( tcpALIVE_WHEEL_RESOLUTION_MS ) )
+	#define tcpALIVE_WHEEL_SLOT( xTime )	( ( UBaseType_t ) ( ( ( xTime ) / tcpALIVE_WHEEL_TICKS ) & ( tcpALIVE_WHEEL_SLOTS - 1U ) ) )
+
+	/* Returns pdTRUE if xTime is not later than xNow, also when the clock has
+	wrapped around. */
+	static BaseType_t prvTimeReached( TickType_t xNow, TickType_t xTime )
+	{
+	BaseType_t xResult = pdFALSE;
+
+		if( ( TickType_t ) ( xNow - xTime ) <= ( ( ( TickType_t ) ~( ( TickType_t ) 0U ) ) >> 1 ) )
+		{
+			xResult = pdTRUE;
+		}
+
+		return xResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTCPAliveTimerInit( void )
+	{
+	UBaseType_t uxSlot;
+
+		for( uxSlot = 0U; uxSlot < tcpALIVE_WHEEL_SLOTS; uxSlot++ )
+		{
+			vListInitialise( &( xAliveWheel[ uxSlot ] ) );
+		}
+
+		xAliveWheelTime = ( xTaskGetTickCount() / tcpALIVE_WHEEL_TICKS ) * tcpALIVE_WHEEL_TICKS;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvTCPAliveDeadline( const FreeRTOS_Socket_t *pxSocket, TickType_t *pxDeadline )
+	{
+	BaseType_t xResult = pdFALSE;
+	eIPTCPState_t eState = ipNUMERIC_CAST( eIPTCPState_t, pxSocket->u.xTCP.ucTCPState );
+
+		#if( ipconfigTCP_KEEP_ALIVE == 1 )
+		{
+			if( ( eState == eESTABLISHED ) && ( pxSocket->u.xTCP.ucKeepEnabled != pdFALSE_UNSIGNED ) )
+			{
+				/* The first message is sent after a period of silence, the
+				next ones when the previous one was not answered. */
+				if( pxSocket->u.xTCP.ucKeepRepCount == 0U )
+				{
+					*pxDeadline = pxSocket->u.xTCP.xLastAliveTime + ( ( TickType_t ) pxSocket->u.xTCP.usKeepIdle * ( TickType_t ) configTICK_RATE_HZ );
+				}
+				else
+				{
+					*pxDeadline = pxSocket->u.xTCP.xLastAliveTime + ( ( TickType_t ) pxSocket->u.xTCP.usKeepInterval * ( TickType_t ) configTICK_RATE_HZ );
+				}
+				xResult = pdTRUE;
+			}
+		}
+		#endif /* ipconfigTCP_KEEP_ALIVE */
+
+		#if( ipconfigTCP_HANG_PROTECTION == 1 )
+		{
+			if( prvTCPStateIsProtected( eState ) != pdFALSE )
+			{
+				/* prvTCPStatusAgeCheck() closes the socket when the age is
+				more than the protection time. */
+				*pxDeadline = pxSocket->u.xTCP.xLastActTime + ( ( TickType_t ) ipconfigTCP_HANG_PROTECTION_TIME * ( TickType_t ) configTICK_RATE_HZ ) + 1U;
+				xResult = pdTRUE;
+			}
+		}
+		#endif /* ipconfigTCP_HANG_PROTECTION */
+
+		( void ) eState;
+
+		return xResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTCPAliveSchedule( FreeRTOS_Socket_t *pxSocket )
+	{
+	ListItem_t *pxItem = &( pxSocket->u.xTCP.xAliveListItem );
+	TickType_t xDeadline = 0U;
+	TickType_t xSlotTime;
+
+		if( listLIST_ITEM_CONTAINER( pxItem ) != NULL )
+		{
+			( void ) uxListRemove( pxItem );
+		}
+
+		if( prvTCPAliveDeadline( pxSocket, &xDeadline ) != pdFALSE )
+		{
+			/* A deadline in a slot that has been checked already is put in
+			the next slot to be checked. */
+			xSlotTime = xDeadline;
+			if( prvTimeReached( xAliveWheelTime, xDeadline ) != pdFALSE )
+			{
+				xSlotTime = xAliveWheelTime;
+			}
+
+			listSET_LIST_ITEM_VALUE( pxItem, xDeadline );
+			vListInsertEnd( &( xAliveWheel[ tcpALIVE_WHEEL_SLOT( xSlotTime ) ] ), pxItem );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTCPAliveTimerRemove( FreeRTOS_Socket_t *pxSocket )
+	{
+		if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xAliveListItem ) ) != NULL )
+		{
+			( void ) uxListRemove( &( pxSocket->u.xTCP.xAliveListItem ) );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( ipconfigTCP_KEEP_ALIVE == 1 )
+
+		static void prvTCPKeepAliveExpired( FreeRTOS_Socket_t *pxSocket )
+		{
+			if( pxSocket->u.xTCP.ucKeepRepCount >= pxSocket->u.xTCP.ucKeepCount )
+			{
+				FreeRTOS_debug_printf( ( "keep-alive: giving up %lxip:%u\n",
+					pxSocket->u.xTCP.ulRemoteIP,			/* IP address of remote machine. */
+					pxSocket->u.xTCP.usRemotePort ) );	/* Port on remote machine. */
+				ipSTATS_INCREMENT( ulTCPConnectionsReaped );
+				vTCPStateChange( pxSocket, eCLOSE_WAIT );
+			}
+			else if( xTCPWindowTxDone( &( pxSocket->u.xTCP.xTCPWindow ) ) == pdFALSE )
+			{
+				/* Data is outstanding, the retransmissions will show whether
+				the peer is still there. */
+				pxSocket->u.xTCP.xLastAliveTime = xTaskGetTickCount();
+			}
+			else
+			{
+				if( xTCPWindowLoggingLevel != 0 )
+				{
+					FreeRTOS_debug_printf( ( "keep-alive: %lxip:%u count %u\n",
+						pxSocket->u.xTCP.ulRemoteIP,
+						pxSocket->u.xTCP.usRemotePort,
+						pxSocket->u.xTCP.ucKeepRepCount ) );
+				}
+
+				pxSocket->u.xTCP.xLastAliveTime = xTaskGetTickCount();
+				pxSocket->u.xTCP.ucKeepRepCount++;
+				pxSocket->u.xTCP.bits.bSendKeepAlive = pdTRUE_UNSIGNED;
+				ipSTATS_INCREMENT( ulTCPKeepAliveProbes );
+
+				/* prvTCPPrepareSend() sees bSendKeepAlive and sends an empty
+				segment with the sequence number minus 1. */
+				( void ) prvTCPSendPacket( pxSocket );
+			}
+		}
+		/*-----------------------------------------------------------*/
+
+	#endif /* ipconfigTCP_KEEP_ALIVE */
+
+	void vTCPAliveTimerCheck( void )
+	{
+	TickType_t xNow = xTaskGetTickCount();
+	TickType_t xDeadline;
+	UBaseType_t uxSlots = 0U;
+	UBaseType_t uxCount;
+	List_t *pxList;
+	FreeRTOS_Socket_t *pxSocket;
+	BaseType_t xDeleted;
+
+		/* A slot is checked once all of its time has passed. */
+		while( ( uxSlots < tcpALIVE_WHEEL_SLOTS ) && ( prvTimeReached( xNow, xAliveWheelTime + tcpALIVE_WHEEL_TICKS ) != pdFALSE ) )
+		{
+			pxList = &( xAliveWheel[ tcpALIVE_WHEEL_SLOT( xAliveWheelTime ) ] );
+
+			/* Advance first, a socket that must be checked again right away
+			will go into the next slot. */
+			xAliveWheelTime += tcpALIVE_WHEEL_TICKS;
+			uxSlots++;
+
+			/* Sockets that are put back in this slot are appended, only look
+			at the ones that are present now. */
+			uxCount = listCURRENT_LIST_LENGTH( pxList );
+
+			while( ( uxCount > 0U ) && ( listLIST_IS_EMPTY( pxList ) == pdFALSE ) )
+			{
+				uxCount--;
+				pxSocket = ipPOINTER_CAST( FreeRTOS_Socket_t *, listGET_OWNER_OF_HEAD_ENTRY( pxList ) );
+				( void ) uxListRemove( &( pxSocket->u.xTCP.xAliveListItem ) );
+				xDeleted = pdFALSE;
+
+				/* The alive times are updated by prvTCPTouchSocket() without
+				moving the socket, so the deadline may have moved. */
+				if( ( prvTCPAliveDeadline( pxSocket, &xDeadline ) != pdFALSE ) &&
+					( prvTimeReached( xNow, xDeadline ) != pdFALSE ) )
+				{
+					#if( ipconfigTCP_HANG_PROTECTION == 1 )
+					if( prvTCPStateIsProtected( ipNUMERIC_CAST( eIPTCPState_t, pxSocket->u.xTCP.ucTCPState ) ) != pdFALSE )
+					{
+						if( prvTCPStatusAgeCheck( pxSocket ) < 0 )
+						{
+							xDeleted = pdTRUE;
+						}
+					}
+					else
+					#endif /* ipconfigTCP_HANG_PROTECTION */
+					{
+						#if( ipconfigTCP_KEEP_ALIVE == 1 )
+						{
+							prvTCPKeepAliveExpired( pxSocket );
+						}
+						#endif /* ipconfigTCP_KEEP_ALIVE */
+					}
+				}
+
+				if( xDeleted == pdFALSE )
+				{
+					prvTCPAliveSchedule( pxSocket );
+				}
+			}
+		}
+
+		if( uxSlots == tcpALIVE_WHEEL_SLOTS )
+		{
+			/* The wheel was not checked for a full revolution, all slots have
+			been visited now. */
+			xAliveWheelTime = ( xNow / tcpALIVE_WHEEL_TICKS ) * tcpALIVE_WHEEL_TICKS;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 ) */
+
 /*
  * As soon as a TCP socket timer expires, this function xTCPSocketCheck
  * will be called (from xTCPTimerCheck)
  * It can send a delayed ACK or new data
  * Sequence of calling (normally) :
  * IP-Task:
- *		xTCPTimerCheck()				// Check all sockets ( declared in FreeRTOS_Sockets.c )
+ *		xTCPTimerCheck()				// Check the sockets with a time-out ( declared in FreeRTOS_Sockets.c )
  *		xTCPSocketCheck()				// Either send a delayed ACK or call prvTCPSendPacket()
  *		prvTCPSendPacket()				// Either send a SYN or call prvTCPSendRepeated ( regular messages )
  *		prvTCPSendRepeated()			// Send at most 8 messages on a row
@@ -511,10 +833,10 @@ BaseType_t xReady = pdFALSE;
 							pxSocket->u.xTCP.usRemotePort,
 							pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber - pxSocket->u.xTCP.xTCPWindow.rx.ulFirstSequenceNumber,
 							pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber   - pxSocket->u.xTCP.xTCPWindow.tx.ulFirstSequenceNumber,
-							( unsigned ) ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ) );
+							( unsigned ) uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER ) );
 					}
 
-					prvTCPReturnPacket( pxSocket, pxSocket->u.xTCP.pxAckMessage, ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER, ipconfigZERO_COPY_TX_DRIVER );
+					prvTCPReturnPacket( pxSocket, pxSocket->u.xTCP.pxAckMessage, uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER, ipconfigZERO_COPY_TX_DRIVER );
 
 					#if( ipconfigZERO_COPY_TX_DRIVER != 0 )
 					{
@@ -524,7 +846,7 @@ BaseType_t xReady = pdFALSE;
 					}
 					#endif /* ipconfigZERO_COPY_TX_DRIVER */
 				}
-				if( prvTCPNextTimeout( pxSocket ) > 1U )
+				if( prvTCPNextTimeout( pxSocket ) != 1U )
 				{
 					/* Tell the code below that this function is ready. */
 					xReady = pdTRUE;
@@ -557,15 +879,18 @@ BaseType_t xReady = pdFALSE;
 
 		/* Set the time-out for the next wakeup for this socket. */
 		( void ) prvTCPNextTimeout( pxSocket );
+	}
 
-		#if( ipconfigTCP_HANG_PROTECTION == 1 )
+	#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+	{
+		/* A state change made by an API call, e.g. FreeRTOS_connect(), can not
+		access the timer wheel.  The socket is added here, in the IP-task. */
+		if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xAliveListItem ) ) == NULL )
 		{
-			/* In all (non-connected) states in which keep-alive messages can not be sent
-			the anti-hang protocol will close sockets that are 'hanging'. */
-			xResult = prvTCPStatusAgeCheck( pxSocket );
+			prvTCPAliveSchedule( pxSocket );
 		}
-		#endif
 	}
+	#endif
 
 	return xResult;
 }
@@ -610,7 +935,7 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 		else if( ( pxSocket->u.xTCP.bits.bConnPrepared != pdFALSE_UNSIGNED ) || ( prvTCPPrepareConnect( pxSocket ) == pdTRUE ) )
 		{
 		ProtocolHeaders_t *pxProtocolHeaders;
-		const UBaseType_t uxHeaderSize = ipSIZE_OF_IPv4_HEADER;
+		const UBaseType_t uxHeaderSize = uxIPHeaderSizeSocket( pxSocket );
 			/* Or else, if the connection has been prepared, or can be prepared
 			now, proceed to send the packet with the SYN flag.
 			prvTCPPrepareConnect() prepares 'xPacket' and returns pdTRUE if
@@ -698,6 +1023,7 @@ int32_t xSendLength;
 static void prvTCPReturnPacket( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxDescriptor, uint32_t ulLen, BaseType_t xReleaseAfterSend )
 {
 TCPPacket_t * pxTCPPacket;
+TCPHeader_t *pxTCPHeader;
 IPHeader_t *pxIPHeader;
 BaseType_t xDoRelease = xReleaseAfterSend;
 EthernetHeader_t *pxEthernetHeader;
@@ -705,6 +1031,10 @@ uint32_t ulFrontSpace, ulSpace, ulSourceAddress, ulWinSize;
 const TCPWindow_t *pxTCPWindow;
 NetworkBufferDescriptor_t *pxNetworkBuffer = pxDescriptor;	/* To avoid error: "function parameter modified [MISRA 2012 Rule 17.8, advisory]" */
 NetworkBufferDescriptor_t xTempBuffer;
+#if( ipconfigUSE_IPv6 != 0 )
+	IPHeader_IPv6_t *pxIPHeader6 = NULL;
+	IPv6_Address_t xLocalAddress;
+#endif
 /* For sending, a pseudo network buffer will be used, as explained above. */
 
 	if( pxNetworkBuffer == NULL )
@@ -742,6 +1072,7 @@ NetworkBufferDescriptor_t xTempBuffer;
 		pxTCPPacket = ipPOINTER_CAST( TCPPacket_t *, pxNetworkBuffer->pucEthernetBuffer );
 		pxIPHeader = &pxTCPPacket->xIPHeader;
 		pxEthernetHeader = &pxTCPPacket->xEthernetHeader;
+		pxTCPHeader = ipPOINTER_CAST( TCPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
 
 		/* Fill the packet, using hton translations. */
 		if( pxSocket != NULL )
@@ -798,7 +1129,7 @@ NetworkBufferDescriptor_t xTempBuffer;
 				ulWinSize = 0xfffcUL;
 			}
 
-			pxTCPPacket->xTCPHeader.usWindow = FreeRTOS_htons( ( uint16_t ) ulWinSize );
+			pxTCPHeader->usWindow = FreeRTOS_htons( ( uint16_t ) ulWinSize );
 
 			/* The new window size has been advertised, switch off the flag. */
 			pxSocket->u.xTCP.bits.bWinChange = pdFALSE_UNSIGNED;
@@ -817,22 +1148,22 @@ NetworkBufferDescriptor_t xTempBuffer;
 				pxSocket->u.xTCP.bits.bSendKeepAlive = pdFALSE_UNSIGNED;
 				pxSocket->u.xTCP.bits.bWaitKeepAlive = pdTRUE_UNSIGNED;
 
-				pxTCPPacket->xTCPHeader.ulSequenceNumber = pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber - 1UL;
-				pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
+				pxTCPHeader->ulSequenceNumber = pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber - 1UL;
+				pxTCPHeader->ulSequenceNumber = FreeRTOS_htonl( pxTCPHeader->ulSequenceNumber );
 			}
 			else
 		#endif
 			{
-				pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber );
+				pxTCPHeader->ulSequenceNumber = FreeRTOS_htonl( pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber );
 
-				if( ( pxTCPPacket->xTCPHeader.ucTCPFlags & ( uint8_t ) tcpTCP_FLAG_FIN ) != 0U )
+				if( ( pxTCPHeader->ucTCPFlags & ( uint8_t ) tcpTCP_FLAG_FIN ) != 0U )
 				{
 					/* Suppress FIN in case this packet carries earlier data to be
 					retransmitted. */
-					uint32_t ulDataLen = ( uint32_t ) ( ulLen - ( ipSIZE_OF_TCP_HEADER + ipSIZE_OF_IPv4_HEADER ) );
+					uint32_t ulDataLen = ( uint32_t ) ( ulLen - ( ipSIZE_OF_TCP_HEADER + xIPHeaderSize( pxNetworkBuffer ) ) );
 					if( ( pxTCPWindow->ulOurSequenceNumber + ulDataLen ) != pxTCPWindow->tx.ulFINSequenceNumber )
 					{
-						pxTCPPacket->xTCPHeader.ucTCPFlags &= ( ( uint8_t ) ~tcpTCP_FLAG_FIN );
+						pxTCPHeader->ucTCPFlags &= ( ( uint8_t ) ~tcpTCP_FLAG_FIN );
 						FreeRTOS_debug_printf( ( "Suppress FIN for %lu + %lu < %lu\n",
 							pxTCPWindow->ulOurSequenceNumber - pxTCPWindow->tx.ulFirstSequenceNumber,
 							ulDataLen,
@@ -842,56 +1173,94 @@ NetworkBufferDescriptor_t xTempBuffer;
 			}
 
 			/* Tell which sequence number is expected next time */
-			pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( pxTCPWindow->rx.ulCurrentSequenceNumber );
+			pxTCPHeader->ulAckNr = FreeRTOS_htonl( pxTCPWindow->rx.ulCurrentSequenceNumber );
 		}
 		else
 		{
 			/* Sending data without a socket, probably replying with a RST flag
 			Just swap the two sequence numbers. */
-			vFlip_32( pxTCPPacket->xTCPHeader.ulSequenceNumber, pxTCPPacket->xTCPHeader.ulAckNr );
+			vFlip_32( pxTCPHeader->ulSequenceNumber, pxTCPHeader->ulAckNr );
 		}
 
-		pxIPHeader->ucTimeToLive		   = ( uint8_t ) ipconfigTCP_TIME_TO_LIVE;
-		pxIPHeader->usLength			   = FreeRTOS_htons( ulLen );
-		if( ( pxSocket == NULL ) || ( *ipLOCAL_IP_ADDRESS_POINTER == 0UL ) )
-		{
-			/* When pxSocket is NULL, this function is called by prvTCPSendReset()
-			and the IP-addresses must be swapped.
-			Also swap the IP-addresses in case the IP-tack doesn't have an
-			IP-address yet, i.e. when ( *ipLOCAL_IP_ADDRESS_POINTER == 0UL ). */
-			ulSourceAddress = pxIPHeader->ulDestinationIPAddress;
-		}
-		else
+		#if( ipconfigUSE_IPv6 != 0 )
+		if( pxEthernetHeader->usFrameType == ipIPv6_FRAME_TYPE )
 		{
-			ulSourceAddress = *ipLOCAL_IP_ADDRESS_POINTER;
-		}
-		pxIPHeader->ulDestinationIPAddress = pxIPHeader->ulSourceIPAddress;
-		pxIPHeader->ulSourceIPAddress = ulSourceAddress;
-		vFlip_16( pxTCPPacket->xTCPHeader.usSourcePort, pxTCPPacket->xTCPHeader.usDestinationPort );
+			pxIPHeader6 = ipPOINTER_CAST( IPHeader_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
 
-		/* Just an increasing number. */
-		pxIPHeader->usIdentification = FreeRTOS_htons( usPacketIdentifier );
-		usPacketIdentifier++;
-		pxIPHeader->usFragmentOffset = 0U;
+			/* Both in a received packet and in the socket's template, the
+			destination is the local address. */
+			xLocalAddress = pxIPHeader6->xDestinationAddress;
+			pxIPHeader6->usPayloadLength = FreeRTOS_htons( ( uint16_t ) ( ulLen - ipSIZE_OF_IPv6_HEADER ) );
+			pxIPHeader6->ucHopLimit = ucIPv6GetHopLimit();
+			pxIPHeader6->xDestinationAddress = pxIPHeader6->xSourceAddress;
+			pxIPHeader6->xSourceAddress = xLocalAddress;
+			vFlip_16( pxTCPHeader->usSourcePort, pxTCPHeader->usDestinationPort );
 
-		#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+			#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+			{
+				/* IPv6 has no header checksum, only the TCP checksum. */
+				( void ) usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, ( size_t ) ulLen + ipSIZE_OF_ETH_HEADER, pdTRUE );
+			}
+			#endif
+		}
+		else
+		#endif /* ipconfigUSE_IPv6 */
 		{
-			/* calculate the IP header checksum, in case the driver won't do that. */
-			pxIPHeader->usHeaderChecksum = 0x00U;
-			pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
-			pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+			pxIPHeader->ucTimeToLive		   = ( uint8_t ) ipconfigTCP_TIME_TO_LIVE;
+			pxIPHeader->usLength			   = FreeRTOS_htons( ulLen );
+			if( ( pxSocket == NULL ) || ( *ipLOCAL_IP_ADDRESS_POINTER == 0UL ) )
+			{
+				/* When pxSocket is NULL, this function is called by prvTCPSendReset()
+				and the IP-addresses must be swapped.
+				Also swap the IP-addresses in case the IP-tack doesn't have an
+				IP-address yet, i.e. when ( *ipLOCAL_IP_ADDRESS_POINTER == 0UL ). */
+				ulSourceAddress = pxIPHeader->ulDestinationIPAddress;
+			}
+			else
+			{
+				ulSourceAddress = *ipLOCAL_IP_ADDRESS_POINTER;
+			}
+			pxIPHeader->ulDestinationIPAddress = pxIPHeader->ulSourceIPAddress;
+			#if( ipconfigUSE_LOOPBACK != 0 )
+			{
+				/* A connection with 127.x.x.x uses that address at both ends. */
+				if( ipIS_LOOPBACK_NETWORK( pxIPHeader->ulDestinationIPAddress ) )
+				{
+					ulSourceAddress = pxIPHeader->ulDestinationIPAddress;
+				}
+			}
+			#endif
+			pxIPHeader->ulSourceIPAddress = ulSourceAddress;
+			vFlip_16( pxTCPHeader->usSourcePort, pxTCPHeader->usDestinationPort );
+
+			/* Just an increasing number. */
+			pxIPHeader->usIdentification = FreeRTOS_htons( usPacketIdentifier );
+			usPacketIdentifier++;
+			pxIPHeader->usFragmentOffset = 0U;
+
+			#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+			#if( ipconfigUSE_LOOPBACK != 0 )
+			/* No checksums are needed when the packet stays in this node. */
+			if( xIsLoopbackAddress( pxIPHeader->ulDestinationIPAddress ) == pdFALSE )
+			#endif
+			{
+				/* calculate the IP header checksum, in case the driver won't do that. */
+				pxIPHeader->usHeaderChecksum = 0x00U;
+				pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+				pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
 
-			/* calculate the TCP checksum for an outgoing packet. */
-			( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxTCPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
+				/* calculate the TCP checksum for an outgoing packet. */
+				( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxTCPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
 
-			/* A calculated checksum of 0 must be inverted as 0 means the checksum
-			is disabled. */
-			if( pxTCPPacket->xTCPHeader.usChecksum == 0U )
-			{
-				pxTCPPacket->xTCPHeader.usChecksum = 0xffffU;
+				/* A calculated checksum of 0 must be inverted as 0 means the checksum
+				is disabled. */
+				if( pxTCPHeader->usChecksum == 0U )
+				{
+					pxTCPHeader->usChecksum = 0xffffU;
+				}
 			}
+			#endif
 		}
-		#endif
 
 		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
 		{
@@ -925,15 +1294,40 @@ NetworkBufferDescriptor_t xTempBuffer;
 		}
 		#endif
 
+		#if( ipconfigUSE_IP_STATISTICS != 0 )
+		{
+			if( pxSocket != NULL )
+			{
+				ipSOCKET_STATS_ADD( pxSocket, ulTxPackets, 1U );
+				ipSOCKET_STATS_ADD( pxSocket, ulTxBytes, ulLen - ( ( uint32_t ) xIPHeaderSize( pxNetworkBuffer ) + ( ( ( uint32_t ) pxTCPHeader->ucTCPOffset & 0xf0U ) >> 2 ) ) );
+			}
+		}
+		#endif /* ipconfigUSE_IP_STATISTICS */
+
 		/* Send! */
-		( void ) xNetworkInterfaceOutput( pxNetworkBuffer, xDoRelease );
+		#if( ipconfigUSE_LOOPBACK != 0 )
+		if( xLoopbackOutput( pxNetworkBuffer, xDoRelease ) == pdFALSE )
+		#endif
+		{
+			( void ) xNetworkInterfaceOutput( pxNetworkBuffer, xDoRelease );
+		}
 
 		if( xDoRelease == pdFALSE )
 		{
 			/* Swap-back some fields, as pxBuffer probably points to a socket field
 			containing the packet header. */
-			vFlip_16( pxTCPPacket->xTCPHeader.usSourcePort, pxTCPPacket->xTCPHeader.usDestinationPort);
-			pxTCPPacket->xIPHeader.ulSourceIPAddress = pxTCPPacket->xIPHeader.ulDestinationIPAddress;
+			vFlip_16( pxTCPHeader->usSourcePort, pxTCPHeader->usDestinationPort);
+			#if( ipconfigUSE_IPv6 != 0 )
+			if( pxEthernetHeader->usFrameType == ipIPv6_FRAME_TYPE )
+			{
+				pxIPHeader6->xSourceAddress = pxIPHeader6->xDestinationAddress;
+				pxIPHeader6->xDestinationAddress = xLocalAddress;
+			}
+			else
+			#endif /* ipconfigUSE_IPv6 */
+			{
+				pxTCPPacket->xIPHeader.ulSourceIPAddress = pxTCPPacket->xIPHeader.ulDestinationIPAddress;
+			}
 			( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, pxEthernetHeader->xDestinationAddress.ucBytes, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
 		}
 		else
@@ -976,15 +1370,40 @@ static void prvTCPCreateWindow( FreeRTOS_Socket_t *pxSocket )
  * target IP address is not within the netmask, the hardware address of the
  * gateway will be used.
  */
+#if( ipconfigUSE_IPv6 != 0 )
+
+	static uint32_t prvFoldIPv6Address( const IPv6_Address_t *pxAddress )
+	{
+	uint32_t ulWord, ulResult = 0UL;
+	BaseType_t x;
+
+		for( x = 0; x < ( BaseType_t ) ipSIZE_OF_IPv6_ADDRESS; x += 4 )
+		{
+			( void ) memcpy( &ulWord, &( pxAddress->ucBytes[ x ] ), sizeof( ulWord ) );
+			ulResult ^= ulWord;
+		}
+
+		return ulResult;
+	}
+
+#endif /* ipconfigUSE_IPv6 */
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvTCPPrepareConnect( FreeRTOS_Socket_t *pxSocket )
 {
 TCPPacket_t *pxTCPPacket;
+TCPHeader_t *pxTCPHeader;
 IPHeader_t *pxIPHeader;
 eARPLookupResult_t eReturned;
 uint32_t ulRemoteIP;
 MACAddress_t xEthAddress;
 BaseType_t xReturn = pdTRUE;
 uint32_t ulInitialSequenceNumber = 0;
+#if( ipconfigUSE_IPv6 != 0 )
+	IPv6_Address_t xNextHop;
+	IPv6_Address_t xLocalAddress;
+	IPHeader_IPv6_t *pxIPHeader6;
+#endif
 
 	#if( ipconfigHAS_PRINTF != 0 )
 	{
@@ -993,45 +1412,83 @@ uint32_t ulInitialSequenceNumber = 0;
 	}
 	#endif /* ipconfigHAS_PRINTF != 0 */
 
-	ulRemoteIP = FreeRTOS_htonl( pxSocket->u.xTCP.ulRemoteIP );
+	#if( ipconfigUSE_IPv6 != 0 )
+	if( socketIS_IPv6( pxSocket ) )
+	{
+		/* Look up the neighbour, which is the router for an off-link peer. */
+		xNextHop = pxSocket->u.xTCP.xRemoteIPv6Address;
+		eReturned = eNDGetCacheEntry( &xNextHop, &xEthAddress );
 
-	/* Determine the ARP cache status for the requested IP address. */
-	eReturned = eARPGetCacheEntry( &( ulRemoteIP ), &( xEthAddress ) );
+		if( eReturned != eARPCacheHit )
+		{
+			pxSocket->u.xTCP.ucRepCount++;
 
-	switch( eReturned )
+			if( eReturned == eARPCacheMiss )
+			{
+				vNDSendNeighbourSolicitation( &xNextHop, pdFALSE );
+			}
+			ipSTATS_INCREMENT( ulARPCacheMisses );
+			xReturn = pdFALSE;
+		}
+	}
+	else
+	#endif /* ipconfigUSE_IPv6 */
 	{
-	case eARPCacheHit:		/* An ARP table lookup found a valid entry. */
-		break;				/* We can now prepare the SYN packet. */
-	case eARPCacheMiss:		/* An ARP table lookup did not find a valid entry. */
-	case eCantSendPacket:	/* There is no IP address, or an ARP is still in progress. */
-	default:
-		/* Count the number of times it couldn't find the ARP address. */
-		pxSocket->u.xTCP.ucRepCount++;
-
-		FreeRTOS_debug_printf( ( "ARP for %lxip (using %lxip): rc=%d %02X:%02X:%02X %02X:%02X:%02X\n",
-			pxSocket->u.xTCP.ulRemoteIP,
-			FreeRTOS_htonl( ulRemoteIP ),
-			eReturned,
-			xEthAddress.ucBytes[ 0 ],
-			xEthAddress.ucBytes[ 1 ],
-			xEthAddress.ucBytes[ 2 ],
-			xEthAddress.ucBytes[ 3 ],
-			xEthAddress.ucBytes[ 4 ],
-			xEthAddress.ucBytes[ 5 ] ) );
-
-		/* And issue a (new) ARP request */
-		FreeRTOS_OutputARPRequest( ulRemoteIP );
-		xReturn = pdFALSE;
-		break;
+		ulRemoteIP = FreeRTOS_htonl( pxSocket->u.xTCP.ulRemoteIP );
+
+		/* Determine the ARP cache status for the requested IP address. */
+		eReturned = eARPGetCacheEntry( &( ulRemoteIP ), &( xEthAddress ) );
+
+		switch( eReturned )
+		{
+		case eARPCacheHit:		/* An ARP table lookup found a valid entry. */
+			break;				/* We can now prepare the SYN packet. */
+		case eARPCacheMiss:		/* An ARP table lookup did not find a valid entry. */
+		case eCantSendPacket:	/* There is no IP address, or an ARP is still in progress. */
+		default:
+			/* Count the number of times it couldn't find the ARP address. */
+			pxSocket->u.xTCP.ucRepCount++;
+
+			FreeRTOS_debug_printf( ( "ARP for %lxip (using %lxip): rc=%d %02X:%02X:%02X %02X:%02X:%02X\n",
+				pxSocket->u.xTCP.ulRemoteIP,
+				FreeRTOS_htonl( ulRemoteIP ),
+				eReturned,
+				xEthAddress.ucBytes[ 0 ],
+				xEthAddress.ucBytes[ 1 ],
+				xEthAddress.ucBytes[ 2 ],
+				xEthAddress.ucBytes[ 3 ],
+				xEthAddress.ucBytes[ 4 ],
+				xEthAddress.ucBytes[ 5 ] ) );
+
+			/* And issue a (new) ARP request */
+			FreeRTOS_OutputARPRequest( ulRemoteIP );
+			ipSTATS_INCREMENT( ulARPCacheMisses );
+			xReturn = pdFALSE;
+			break;
+		}
 	}
 
 	if( xReturn != pdFALSE )
 	{
 		/* Get a difficult-to-predict initial sequence number for this 4-tuple. */
-		ulInitialSequenceNumber = ulApplicationGetNextSequenceNumber( *ipLOCAL_IP_ADDRESS_POINTER,
-																	  pxSocket->usLocalPort,
-																	  pxSocket->u.xTCP.ulRemoteIP,
-																	  pxSocket->u.xTCP.usRemotePort );
+		#if( ipconfigUSE_IPv6 != 0 )
+		if( socketIS_IPv6( pxSocket ) )
+		{
+			/* The hook takes IPv4 addresses, pass the folded IPv6 addresses. */
+			vIPv6SelectSourceAddress( &xLocalAddress, &( pxSocket->u.xTCP.xRemoteIPv6Address ) );
+			ulInitialSequenceNumber = ulApplicationGetNextSequenceNumber( prvFoldIPv6Address( &xLocalAddress ),
+																		  pxSocket->usLocalPort,
+																		  prvFoldIPv6Address( &( pxSocket->u.xTCP.xRemoteIPv6Address ) ),
+																		  pxSocket->u.xTCP.usRemotePort );
+		}
+		else
+		#endif /* ipconfigUSE_IPv6 */
+		{
+			ulInitialSequenceNumber = ulApplicationGetNextSequenceNumber( *ipLOCAL_IP_ADDRESS_POINTER,
+																		  pxSocket->usLocalPort,
+																		  pxSocket->u.xTCP.ulRemoteIP,
+																		  pxSocket->u.xTCP.usRemotePort );
+		}
 
 		/* Check for a random number generation error. */
 		if( ulInitialSequenceNumber == 0UL )
@@ -1063,23 +1520,45 @@ uint32_t ulInitialSequenceNumber = 0;
 		prvTCPReturnPacket(). */
 		( void ) memcpy( &pxTCPPacket->xEthernetHeader.xSourceAddress, &xEthAddress, sizeof( xEthAddress ) );
 
-		/* 'ipIPv4_FRAME_TYPE' is already in network-byte-order. */
-		pxTCPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+		#if( ipconfigUSE_IPv6 != 0 )
+		if( socketIS_IPv6( pxSocket ) )
+		{
+			pxIPHeader6 = ipPOINTER_CAST( IPHeader_IPv6_t *, &( pxSocket->u.xTCP.xPacket.u.ucLastPacket[ ipSIZE_OF_ETH_HEADER ] ) );
+
+			pxTCPPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+
+			pxIPHeader6->ucVersionTrafficClass = 0x60U;
+			pxIPHeader6->usPayloadLength = FreeRTOS_htons( ( uint16_t ) ipSIZE_OF_TCP_HEADER );
+			pxIPHeader6->ucNextHeader = ( uint8_t ) ipPROTOCOL_TCP;
+			pxIPHeader6->ucHopLimit = ucIPv6GetHopLimit();
 
-		pxIPHeader->ucVersionHeaderLength = 0x45U;
-		usLength = ( uint16_t ) ( sizeof( TCPPacket_t ) - sizeof( pxTCPPacket->xEthernetHeader ) );
-		pxIPHeader->usLength = FreeRTOS_htons( usLength );
-		pxIPHeader->ucTimeToLive = ( uint8_t ) ipconfigTCP_TIME_TO_LIVE;
+			/* Addresses will be stored swapped because prvTCPReturnPacket
+			will swap them back while replying. */
+			pxIPHeader6->xDestinationAddress = xLocalAddress;
+			pxIPHeader6->xSourceAddress = pxSocket->u.xTCP.xRemoteIPv6Address;
+		}
+		else
+		#endif /* ipconfigUSE_IPv6 */
+		{
+			/* 'ipIPv4_FRAME_TYPE' is already in network-byte-order. */
+			pxTCPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
 
-		pxIPHeader->ucProtocol = ( uint8_t ) ipPROTOCOL_TCP;
+			pxIPHeader->ucVersionHeaderLength = 0x45U;
+			usLength = ( uint16_t ) ( sizeof( TCPPacket_t ) - sizeof( pxTCPPacket->xEthernetHeader ) );
+			pxIPHeader->usLength = FreeRTOS_htons( usLength );
+			pxIPHeader->ucTimeToLive = ( uint8_t ) ipconfigTCP_TIME_TO_LIVE;
 
-		/* Addresses and ports will be stored swapped because prvTCPReturnPacket
-		will swap them back while replying. */
-		pxIPHeader->ulDestinationIPAddress = *ipLOCAL_IP_ADDRESS_POINTER;
-		pxIPHeader->ulSourceIPAddress = FreeRTOS_htonl( pxSocket->u.xTCP.ulRemoteIP );
+			pxIPHeader->ucProtocol = ( uint8_t ) ipPROTOCOL_TCP;
 
-		pxTCPPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( pxSocket->u.xTCP.usRemotePort );
-		pxTCPPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( pxSocket->usLocalPort );
+			/* Addresses and ports will be stored swapped because prvTCPReturnPacket
+			will swap them back while replying. */
+			pxIPHeader->ulDestinationIPAddress = *ipLOCAL_IP_ADDRESS_POINTER;
+			pxIPHeader->ulSourceIPAddress = FreeRTOS_htonl( pxSocket->u.xTCP.ulRemoteIP );
+		}
+
+		pxTCPHeader = ipPOINTER_CAST( TCPHeader_t *, &( pxSocket->u.xTCP.xPacket.u.ucLastPacket[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) ] ) );
+		pxTCPHeader->usSourcePort = FreeRTOS_htons( pxSocket->u.xTCP.usRemotePort );
+		pxTCPHeader->usDestinationPort = FreeRTOS_htons( pxSocket->usLocalPort );
 
 		/* We are actively connecting, so the peer's Initial Sequence Number (ISN)
 		isn't known yet. */
@@ -1090,10 +1569,10 @@ uint32_t ulInitialSequenceNumber = 0;
 
 		/* The TCP header size is 20 bytes, divided by 4 equals 5, which is put in
 		the high nibble of the TCP offset field. */
-		pxTCPPacket->xTCPHeader.ucTCPOffset = 0x50U;
+		pxTCPHeader->ucTCPOffset = 0x50U;
 
 		/* Only set the SYN flag. */
-		pxTCPPacket->xTCPHeader.ucTCPFlags = tcpTCP_FLAG_SYN;
+		pxTCPHeader->ucTCPFlags = tcpTCP_FLAG_SYN;
 
 		/* Set the values of usInitMSS / usCurMSS for this socket. */
 		prvSocketSetMSS( pxSocket );
@@ -1626,6 +2105,18 @@ BaseType_t bAfter  = ipNUMERIC_CAST( BaseType_t, tcpNOW_CONNECTED( ( BaseType_t
 	/* Touch the alive timers because moving to another state. */
 	prvTCPTouchSocket( pxSocket );
 
+	#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+	{
+		/* The new state may need another check, or none at all.  Only the
+		IP-task may access the timer wheel, xTCPSocketCheck() will schedule
+		the socket in the other cases. */
+		if( xIsCallingFromIPTask() != pdFALSE )
+		{
+			prvTCPAliveSchedule( pxSocket );
+		}
+	}
+	#endif
+
 	#if( ipconfigHAS_DEBUG_PRINTF == 1 )
 	{
 		if( ( xTCPWindowLoggingLevel >= 0 ) && ( ipconfigTCP_MAY_LOG_PORT( pxSocket->usLocalPort ) ) )
@@ -1867,39 +2358,12 @@ int32_t lStreamPos;
 
 		#if( ipconfigTCP_KEEP_ALIVE != 0 )
 		{
-			if( pxSocket->u.xTCP.ucKeepRepCount > 3U ) /*_RB_ Magic number. */
+			/* Keep-alive messages are scheduled by vTCPAliveTimerCheck().  A
+			keep-alive message is an empty segment, when there is data to be
+			sent, the data will serve the same purpose. */
+			if( lDataLen != 0 )
 			{
-				FreeRTOS_debug_printf( ( "keep-alive: giving up %lxip:%u\n",
-					pxSocket->u.xTCP.ulRemoteIP,			/* IP address of remote machine. */
-					pxSocket->u.xTCP.usRemotePort ) );	/* Port on remote machine. */
-				vTCPStateChange( pxSocket, eCLOSE_WAIT );
-				lDataLen = -1;
-			}
-			if( ( lDataLen == 0 ) && ( pxSocket->u.xTCP.bits.bWinChange == pdFALSE_UNSIGNED ) )
-			{
-				/* If there is no data to be sent, and no window-update message,
-				we might want to send a keep-alive message. */
-				TickType_t xAge = xTaskGetTickCount( ) - pxSocket->u.xTCP.xLastAliveTime;
-				TickType_t xMax;
-				xMax = ( ( TickType_t ) ipconfigTCP_KEEP_ALIVE_INTERVAL * ( TickType_t ) configTICK_RATE_HZ );
-				if( pxSocket->u.xTCP.ucKeepRepCount != ( uint8_t ) 0U )
-				{
-					xMax = ( TickType_t ) ( 3U * configTICK_RATE_HZ );
-				}
-				if( xAge > xMax )
-				{
-					pxSocket->u.xTCP.xLastAliveTime = xTaskGetTickCount( );
-					if( xTCPWindowLoggingLevel != 0 )
-					{
-						FreeRTOS_debug_printf( ( "keep-alive: %lxip:%u count %u\n",
-							pxSocket->u.xTCP.ulRemoteIP,
-							pxSocket->u.xTCP.usRemotePort,
-							pxSocket->u.xTCP.ucKeepRepCount ) );
-					}
-					pxSocket->u.xTCP.bits.bSendKeepAlive = pdTRUE_UNSIGNED;
-					pxSocket->u.xTCP.usTimeout = ( ( uint16_t ) pdMS_TO_TICKS( 2500U ) );
-					pxSocket->u.xTCP.ucKeepRepCount++;
-				}
+				pxSocket->u.xTCP.bits.bSendKeepAlive = pdFALSE_UNSIGNED;
 			}
 		}
 		#endif /* ipconfigTCP_KEEP_ALIVE */
@@ -1981,7 +2445,17 @@ TickType_t ulDelayMs = ( TickType_t ) tcpMAXIMUM_TCP_WAKEUP_TIME_MS;
 		{
 			/* ulDelayMs contains the time to wait before a re-transmission. */
 		}
-		pxSocket->u.xTCP.usTimeout = ( uint16_t ) ipMS_TO_MIN_TICKS( ulDelayMs );
+
+		if( ( xResult == ( BaseType_t )0 ) && ( prvTCPSocketIsIdle( pxSocket ) != pdFALSE ) )
+		{
+			/* No need to wake up an idle connection every
+			tcpMAXIMUM_TCP_WAKEUP_TIME_MS. */
+			pxSocket->u.xTCP.usTimeout = 0U;
+		}
+		else
+		{
+			pxSocket->u.xTCP.usTimeout = ( uint16_t ) ipMS_TO_MIN_TICKS( ulDelayMs );
+		}
 	}
 	else
 	{
@@ -1989,6 +2463,12 @@ TickType_t ulDelayMs = ( TickType_t ) tcpMAXIMUM_TCP_WAKEUP_TIME_MS;
 		keep-alive/delayed-ACK mechanism). */
 	}
 
+	if( ( pxSocket->u.xTCP.usTimeout != 0U ) || ( pxSocket->xEventBits != 0U ) )
+	{
+		/* Make sure that xTCPTimerCheck() will visit this socket. */
+		vTCPTimerAdd( pxSocket );
+	}
+
 	/* Return the number of clock ticks before the timer expires. */
 	return ( TickType_t ) pxSocket->u.xTCP.usTimeout;
 }
@@ -2131,12 +2611,12 @@ uint32_t ulAckNr = FreeRTOS_ntohl( pxTCPHeader->ulAckNr );
  */
 static BaseType_t prvCheckRxData( const NetworkBufferDescriptor_t *pxNetworkBuffer, uint8_t **ppucRecvData )
 {
+const size_t xIPHeaderLength = xIPHeaderSize( pxNetworkBuffer );
 const ProtocolHeaders_t *pxProtocolHeaders = ipPOINTER_CAST( ProtocolHeaders_t *,
-	&( pxNetworkBuffer->pucEthernetBuffer[ ( size_t ) ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
+	&( pxNetworkBuffer->pucEthernetBuffer[ ( size_t ) ipSIZE_OF_ETH_HEADER + xIPHeaderLength ] ) );
 const TCPHeader_t *pxTCPHeader = &( pxProtocolHeaders->xTCPHeader );
 int32_t lLength, lTCPHeaderLength, lReceiveLength, lUrgentLength;
 const IPHeader_t *pxIPHeader = ipPOINTER_CAST( const IPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
-const size_t xIPHeaderLength = ipSIZE_OF_IPv4_HEADER;
 uint16_t usLength;
 
 	/* Determine the length and the offset of the user-data sent to this
@@ -2154,8 +2634,21 @@ uint16_t usLength;
 	( LinkLayer length (14) + IP header length (20) + size of TCP header(20 +) ).*/
 	lReceiveLength = ipNUMERIC_CAST( int32_t, pxNetworkBuffer->xDataLength ) - ( int32_t ) ipSIZE_OF_ETH_HEADER;
 
-	usLength = FreeRTOS_htons( pxIPHeader->usLength );
-	lLength =  ( int32_t ) usLength;
+	#if( ipconfigUSE_IPv6 != 0 )
+	if( xIPHeaderLength == ipSIZE_OF_IPv6_HEADER )
+	{
+		/* The IPv6 length field does not include the fixed header. */
+		const IPHeader_IPv6_t *pxIPHeader6 = ipPOINTER_CAST( const IPHeader_IPv6_t *, pxIPHeader );
+
+		usLength = FreeRTOS_htons( pxIPHeader6->usPayloadLength );
+		lLength = ( int32_t ) usLength + ( int32_t ) ipSIZE_OF_IPv6_HEADER;
+	}
+	else
+	#endif /* ipconfigUSE_IPv6 */
+	{
+		usLength = FreeRTOS_htons( pxIPHeader->usLength );
+		lLength =  ( int32_t ) usLength;
+	}
 
 	if( lReceiveLength > lLength )
 	{
@@ -2242,6 +2735,7 @@ BaseType_t xResult = 0;
 			if( lStored != ( int32_t ) ulReceiveLength )
 			{
 				FreeRTOS_debug_printf( ( "lTCPAddRxdata: stored %ld / %lu bytes? ?\n", lStored, ulReceiveLength ) );
+				ipSOCKET_STATS_ADD( pxSocket, ulRxDropped, 1U );
 
 				/* Received data could not be stored.  The socket's flag
 				bMallocError has been set.  The socket now has the status
@@ -2249,6 +2743,11 @@ BaseType_t xResult = 0;
 				( void ) prvTCPSendReset( pxNetworkBuffer );
 				xResult = -1;
 			}
+			else
+			{
+				ipSOCKET_STATS_ADD( pxSocket, ulRxBytes, ulReceiveLength );
+				iptraceRX_DELIVERED_TO_SOCKET( pxNetworkBuffer );
+			}
 		}
 
 		/* After a missing packet has come in, higher packets may be passed to
@@ -2947,12 +3446,13 @@ static BaseType_t prvTCPSendSpecialPacketHelper( NetworkBufferDescriptor_t *pxNe
 	( void ) ucTCPFlags;
 #else
 	{
-		TCPPacket_t *pxTCPPacket = ipPOINTER_CAST( TCPPacket_t *, pxNetworkBuffer->pucEthernetBuffer );
+		TCPHeader_t *pxTCPHeader = ipPOINTER_CAST( TCPHeader_t *,
+			&( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
 		const BaseType_t xSendLength = ( BaseType_t )
-			( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ); /* Plus 0 options. */
+			( xIPHeaderSize( pxNetworkBuffer ) + ipSIZE_OF_TCP_HEADER ); /* Plus 0 options. */
 
-		pxTCPPacket->xTCPHeader.ucTCPFlags = ucTCPFlags;
-		pxTCPPacket->xTCPHeader.ucTCPOffset = ( ipSIZE_OF_TCP_HEADER ) << 2;
+		pxTCPHeader->ucTCPFlags = ucTCPFlags;
+		pxTCPHeader->ucTCPOffset = ( ipSIZE_OF_TCP_HEADER ) << 2;
 
 		prvTCPReturnPacket( NULL, pxNetworkBuffer, ( uint32_t )xSendLength, pdFALSE );
 	}
@@ -2980,6 +3480,20 @@ static void prvSocketSetMSS( FreeRTOS_Socket_t *pxSocket )
 {
 uint32_t ulMSS = ipconfigTCP_MSS;
 
+	#if( ipconfigUSE_IPv6 != 0 )
+	if( socketIS_IPv6( pxSocket ) )
+	{
+		/* ipconfigTCP_MSS assumes a 20-byte IPv4 header, the IPv6 header is
+		20 bytes longer. */
+		ulMSS -= ( uint32_t ) ( ipSIZE_OF_IPv6_HEADER - ipSIZE_OF_IPv4_HEADER );
+
+		if( xIPv6IsOnLink( &( pxSocket->u.xTCP.xRemoteIPv6Address ) ) == pdFALSE )
+		{
+			ulMSS = FreeRTOS_min_uint32( ( uint32_t ) tcpREDUCED_MSS_THROUGH_INTERNET, ulMSS );
+		}
+	}
+	else
+	#endif /* ipconfigUSE_IPv6 */
 	if( ( ( FreeRTOS_ntohl( pxSocket->u.xTCP.ulRemoteIP ) ^ *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) != 0UL )
 	{
 		/* Data for this peer will pass through a router, and maybe through
@@ -3009,8 +3523,10 @@ BaseType_t xProcessReceivedTCPPacket( NetworkBufferDescriptor_t *pxDescriptor )
 {
 /* Function might modify the parameter. */
 NetworkBufferDescriptor_t *pxNetworkBuffer = pxDescriptor;
+/* With IPv6, the size of the IP header is looked up in the frame, do it once. */
+const size_t uxIPHeaderLength = xIPHeaderSize( pxNetworkBuffer );
 const ProtocolHeaders_t *pxProtocolHeaders = ipPOINTER_CAST( const ProtocolHeaders_t *,
-	&( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
+	&( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderLength ] ) );
 FreeRTOS_Socket_t *pxSocket;
 uint16_t ucTCPFlags = pxProtocolHeaders->xTCPHeader.ucTCPFlags;
 uint32_t ulLocalIP;
@@ -3025,18 +3541,33 @@ configASSERT( pxNetworkBuffer->pucEthernetBuffer != NULL );
 const IPHeader_t *pxIPHeader;
 
 	/* Check for a minimum packet size. */
-	if( pxNetworkBuffer->xDataLength < ( ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) + ipSIZE_OF_TCP_HEADER ) )
+	if( pxNetworkBuffer->xDataLength < ( ipSIZE_OF_ETH_HEADER + uxIPHeaderLength + ipSIZE_OF_TCP_HEADER ) )
 	{
 		return pdFAIL;
 	}
 
 	pxIPHeader = ipPOINTER_CAST( const IPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
-	ulLocalIP = FreeRTOS_htonl( pxIPHeader->ulDestinationIPAddress );
-	ulRemoteIP = FreeRTOS_htonl( pxIPHeader->ulSourceIPAddress );
 
-	/* Find the destination socket, and if not found: return a socket listing to
-	the destination PORT. */
-	pxSocket = ( FreeRTOS_Socket_t * ) pxTCPSocketLookup( ulLocalIP, xLocalPort, ulRemoteIP, xRemotePort );
+	#if( ipconfigUSE_IPv6 != 0 )
+	if( uxIPHeaderLength == ipSIZE_OF_IPv6_HEADER )
+	{
+		const IPHeader_IPv6_t *pxIPHeader6 = ipPOINTER_CAST( const IPHeader_IPv6_t *, pxIPHeader );
+
+		/* IPv6 peers are only logged by port. */
+		ulLocalIP = 0UL;
+		ulRemoteIP = 0UL;
+		pxSocket = pxTCPSocketLookup_IPv6( xLocalPort, &( pxIPHeader6->xSourceAddress ), xRemotePort );
+	}
+	else
+	#endif /* ipconfigUSE_IPv6 */
+	{
+		ulLocalIP = FreeRTOS_htonl( pxIPHeader->ulDestinationIPAddress );
+		ulRemoteIP = FreeRTOS_htonl( pxIPHeader->ulSourceIPAddress );
+
+		/* Find the destination socket, and if not found: return a socket listing to
+		the destination PORT. */
+		pxSocket = ( FreeRTOS_Socket_t * ) pxTCPSocketLookup( ulLocalIP, xLocalPort, ulRemoteIP, xRemotePort );
+	}
 
 	if( ( pxSocket == NULL ) || ( prvTCPSocketIsActive( ipNUMERIC_CAST( eIPTCPState_t, pxSocket->u.xTCP.ucTCPState ) ) == pdFALSE ) )
 	{
@@ -3046,6 +3577,7 @@ const IPHeader_t *pxIPHeader;
 		eTIME_WAIT. */
 
 		FreeRTOS_debug_printf( ( "TCP: No active socket on port %d (%lxip:%d)\n", xLocalPort, ulRemoteIP, xRemotePort ) );
+		ipSTATS_INCREMENT( ulTCPNoSocket );
 
 		/* Send a RST to all packets that can not be handled.  As a result
 		the other party will get a ECONN error.  There are two exceptions:
@@ -3170,6 +3702,7 @@ const IPHeader_t *pxIPHeader;
 
 		/* pxSocket is not NULL when xResult != pdFAIL. */
 		configASSERT( pxSocket != NULL );
+		ipSOCKET_STATS_ADD( pxSocket, ulRxPackets, 1U );
 		/* Touch the alive timers because we received a message	for this
 		socket. */
 		prvTCPTouchSocket( pxSocket );
@@ -3240,13 +3773,30 @@ static FreeRTOS_Socket_t *prvHandleListen( FreeRTOS_Socket_t *pxSocket, NetworkB
 const TCPPacket_t * pxTCPPacket = ipPOINTER_CAST( const TCPPacket_t *, pxNetworkBuffer->pucEthernetBuffer );
 FreeRTOS_Socket_t *pxReturn = NULL;
 uint32_t ulInitialSequenceNumber;
+const ProtocolHeaders_t *pxProtocolHeaders = ipPOINTER_CAST( const ProtocolHeaders_t *,
+	&( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
+#if( ipconfigUSE_IPv6 != 0 )
+	const IPHeader_IPv6_t *pxIPHeader6 = ipPOINTER_CAST( const IPHeader_IPv6_t *, &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+#endif
 
 	/* Assume that a new Initial Sequence Number will be required. Request
 	it now in order to fail out if necessary. */
-	ulInitialSequenceNumber = ulApplicationGetNextSequenceNumber( *ipLOCAL_IP_ADDRESS_POINTER,
-																  pxSocket->usLocalPort,
-																  pxTCPPacket->xIPHeader.ulSourceIPAddress,
-																  pxTCPPacket->xTCPHeader.usSourcePort );
+	#if( ipconfigUSE_IPv6 != 0 )
+	if( socketIS_IPv6( pxSocket ) )
+	{
+		ulInitialSequenceNumber = ulApplicationGetNextSequenceNumber( prvFoldIPv6Address( &( pxIPHeader6->xDestinationAddress ) ),
+																	  pxSocket->usLocalPort,
+																	  prvFoldIPv6Address( &( pxIPHeader6->xSourceAddress ) ),
+																	  pxProtocolHeaders->xTCPHeader.usSourcePort );
+	}
+	else
+	#endif /* ipconfigUSE_IPv6 */
+	{
+		ulInitialSequenceNumber = ulApplicationGetNextSequenceNumber( *ipLOCAL_IP_ADDRESS_POINTER,
+																	  pxSocket->usLocalPort,
+																	  pxTCPPacket->xIPHeader.ulSourceIPAddress,
+																	  pxTCPPacket->xTCPHeader.usSourcePort );
+	}
 
 	/* A pure SYN (without ACK) has come in, create a new socket to answer
 	it. */
@@ -3277,8 +3827,19 @@ uint32_t ulInitialSequenceNumber;
 			}
 			else
 			{
-				FreeRTOS_Socket_t *pxNewSocket = ( FreeRTOS_Socket_t * )
-					FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+				BaseType_t xDomain = FREERTOS_AF_INET;
+				FreeRTOS_Socket_t *pxNewSocket;
+
+				#if( ipconfigUSE_IPv6 != 0 )
+				{
+					if( socketIS_IPv6( pxSocket ) )
+					{
+						xDomain = FREERTOS_AF_INET6;
+					}
+				}
+				#endif /* ipconfigUSE_IPv6 */
+
+				pxNewSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket( xDomain, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
 
 				if( ( pxNewSocket == NULL ) || ( pxNewSocket == FREERTOS_INVALID_SOCKET ) )
 				{
@@ -3303,11 +3864,19 @@ uint32_t ulInitialSequenceNumber;
 
 	if( ( ulInitialSequenceNumber != 0U ) && ( pxReturn != NULL ) )
 	{
-	const ProtocolHeaders_t *pxProtocolHeaders = ipPOINTER_CAST( const ProtocolHeaders_t *,
-		&( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + xIPHeaderSize( pxNetworkBuffer ) ] ) );
+		pxReturn->u.xTCP.usRemotePort = FreeRTOS_htons( pxProtocolHeaders->xTCPHeader.usSourcePort );
 
-		pxReturn->u.xTCP.usRemotePort = FreeRTOS_htons( pxTCPPacket->xTCPHeader.usSourcePort );
-		pxReturn->u.xTCP.ulRemoteIP = FreeRTOS_htonl( pxTCPPacket->xIPHeader.ulSourceIPAddress );
+		#if( ipconfigUSE_IPv6 != 0 )
+		if( socketIS_IPv6( pxReturn ) )
+		{
+			pxReturn->u.xTCP.xRemoteIPv6Address = pxIPHeader6->xSourceAddress;
+			pxReturn->u.xTCP.ulRemoteIP = 0UL;
+		}
+		else
+		#endif /* ipconfigUSE_IPv6 */
+		{
+			pxReturn->u.xTCP.ulRemoteIP = FreeRTOS_htonl( pxTCPPacket->xIPHeader.ulSourceIPAddress );
+		}
 		pxReturn->u.xTCP.xTCPWindow.ulOurSequenceNumber = ulInitialSequenceNumber;
 
 		/* Here is the SYN action. */
@@ -3344,6 +3913,15 @@ BaseType_t xResult;
 	pxNewSocket->u.xTCP.uxRxWinSize  = pxSocket->u.xTCP.uxRxWinSize;
 	pxNewSocket->u.xTCP.uxTxWinSize  = pxSocket->u.xTCP.uxTxWinSize;
 
+	#if( ipconfigTCP_KEEP_ALIVE == 1 )
+	{
+		pxNewSocket->u.xTCP.ucKeepEnabled = pxSocket->u.xTCP.ucKeepEnabled;
+		pxNewSocket->u.xTCP.usKeepIdle = pxSocket->u.xTCP.usKeepIdle;
+		pxNewSocket->u.xTCP.usKeepInterval = pxSocket->u.xTCP.usKeepInterval;
+		pxNewSocket->u.xTCP.ucKeepCount = pxSocket->u.xTCP.ucKeepCount;
+	}
+	#endif /* ipconfigTCP_KEEP_ALIVE */
+
 	#if( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
 	{
 		pxNewSocket->pxUserSemaphore = pxSocket->pxUserSemaphore;
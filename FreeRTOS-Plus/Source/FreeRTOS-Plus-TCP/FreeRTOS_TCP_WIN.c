@@ -1452,6 +1452,14 @@ const int32_t l500ms = 500;
 
 			/* Administer the transmit count, needed for fast
 			retransmissions. */
+			#if( ipconfigUSE_IP_STATISTICS != 0 )
+			{
+				if( pxSegment->u.bits.ucTransmitCount != 0U )
+				{
+					pxWindow->ulRetransmitCount++;
+				}
+			}
+			#endif /* ipconfigUSE_IP_STATISTICS */
 			( pxSegment->u.bits.ucTransmitCount )++;
 
 			/* If there have been several retransmissions (4), decrease the
@@ -1674,6 +1682,14 @@ const int32_t l500ms = 500;
 					{
 						pxSegment->u.bits.ucTransmitCount = ( uint8_t ) pdFALSE;
 
+						#if( ipconfigUSE_IP_STATISTICS != 0 )
+						{
+							/* The transmit count was cleared, count the fast
+							retransmission here. */
+							pxWindow->ulRetransmitCount++;
+						}
+						#endif /* ipconfigUSE_IP_STATISTICS */
+
 						/* Not clearing 'ucDupAckCount' yet as more SACK's might come in
 						which might lead to a second fast rexmit. */
 						if( ( xTCPWindowLoggingLevel >= 0 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
@@ -1872,6 +1888,14 @@ const int32_t l500ms = 500;
 
 			if( ulLength != 0UL )
 			{
+				#if( ipconfigUSE_IP_STATISTICS != 0 )
+				{
+					if( pxSegment->u.bits.ucTransmitCount != 0U )
+					{
+						pxWindow->ulRetransmitCount++;
+					}
+				}
+				#endif /* ipconfigUSE_IP_STATISTICS */
 				pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
 				pxSegment->u.bits.ucTransmitCount++;
 				vTCPTimerSet (&pxSegment->xTransmitTimer);
@@ -26,6 +26,7 @@
 /* Standard includes. */
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
@@ -42,6 +43,8 @@
 #include "FreeRTOS_DHCP.h"
 #include "NetworkInterface.h"
 #include "NetworkBufferManagement.h"
+#include "FreeRTOS_IGMP.h"
+#include "FreeRTOS_IPv6.h"
 
 #if( ipconfigUSE_DNS == 1 )
 	#include "FreeRTOS_DNS.h"
@@ -71,15 +74,76 @@ UDPPacketHeader_t xDefaultPartUDPPacketHeader =
 		0x00, 0x00, 0x00, 0x00 					/* Source IP address. */
 	}
 };
+
+/*
+ * Fill in the headers of a generated UDP (or ICMP) packet and pass it to the
+ * driver.  When xDirectSend is pdTRUE, the function is called from a user task,
+ * and it returns pdFAIL if the IP-task must handle the packet.
+ */
+static BaseType_t prvProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t xDirectSend );
+
+/*
+ * Add a received packet to the list of waiting packets of 'pxSocket', and
+ * wake up the socket.  Returns pdFAIL when the socket has no space, in which
+ * case the caller still owns the buffer.
+ */
+static BaseType_t prvQueueUDPPacket( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer );
+
 /*-----------------------------------------------------------*/
 
 void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+	( void ) prvProcessGeneratedUDPPacket( pxNetworkBuffer, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUDP_DIRECT_SEND != 0 )
+
+	/* Set by the network driver when its xNetworkInterfaceOutput() may be
+	called by several tasks at the same time. */
+	static BaseType_t xDriverAllowsDirectSend = pdFALSE;
+
+	void vUDPDirectSendSetDriverSupport( BaseType_t xSupported )
+	{
+		xDriverAllowsDirectSend = xSupported;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xUDPDirectSendIsSupported( void )
+	{
+		return xDriverAllowsDirectSend;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xSendUDPPacketDirect( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+	{
+	BaseType_t xReturn;
+
+		if( xDriverAllowsDirectSend == pdFALSE )
+		{
+			/* The option was set before the driver was initialised, or by a
+			driver that withdrew its support.  Only the IP-task may call it. */
+			xReturn = pdFAIL;
+		}
+		else
+		{
+			xReturn = prvProcessGeneratedUDPPacket( pxNetworkBuffer, pdTRUE );
+		}
+
+		return xReturn;
+	}
+
+#endif /* ipconfigUDP_DIRECT_SEND */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t xDirectSend )
 {
 UDPPacket_t *pxUDPPacket;
 IPHeader_t *pxIPHeader;
 eARPLookupResult_t eReturned;
 uint32_t ulIPAddress = pxNetworkBuffer->ulIPAddress;
 size_t uxPayloadSize;
+BaseType_t xReturn = pdPASS;
 
 	/* Map the UDP packet onto the start of the frame. */
 	pxUDPPacket = ipPOINTER_CAST( UDPPacket_t *, pxNetworkBuffer->pucEthernetBuffer );
@@ -95,10 +159,28 @@ size_t uxPayloadSize;
 		uxPayloadSize = pxNetworkBuffer->xDataLength - sizeof( UDPPacket_t );
 	}
 
-	/* Determine the ARP cache status for the requested IP address. */
+	/* Determine the ARP cache status for the requested IP address.  The ARP
+	cache is updated by the IP-task, which may not run while a user task reads
+	it. */
+	if( xDirectSend != pdFALSE )
+	{
+		vTaskSuspendAll();
+	}
+
 	eReturned = eARPGetCacheEntry( &( ulIPAddress ), &( pxUDPPacket->xEthernetHeader.xDestinationAddress ) );
 
-	if( eReturned != eCantSendPacket )
+	if( xDirectSend != pdFALSE )
+	{
+		( void ) xTaskResumeAll();
+	}
+
+	if( ( xDirectSend != pdFALSE ) && ( eReturned != eARPCacheHit ) )
+	{
+		/* Generating an ARP request, or dropping the packet, is left to the
+		IP-task. */
+		xReturn = pdFAIL;
+	}
+	else if( eReturned != eCantSendPacket )
 	{
 		if( eReturned == eARPCacheHit )
 		{
@@ -171,6 +253,17 @@ size_t uxPayloadSize;
 			pxIPHeader->usLength = FreeRTOS_htons( pxIPHeader->usLength );
 			pxIPHeader->ulDestinationIPAddress = pxNetworkBuffer->ulIPAddress;
 
+			#if( ipconfigUSE_LOOPBACK != 0 )
+			{
+				/* A packet to 127.x.x.x is also sent from that address, so
+				that the reply will take the same way back. */
+				if( ipIS_LOOPBACK_NETWORK( pxIPHeader->ulDestinationIPAddress ) )
+				{
+					pxIPHeader->ulSourceIPAddress = pxIPHeader->ulDestinationIPAddress;
+				}
+			}
+			#endif
+
 			#if( ipconfigUSE_LLMNR == 1 )
 			{
 				/* LLMNR messages are typically used on a LAN and they're
@@ -183,6 +276,11 @@ size_t uxPayloadSize;
 			#endif
 
 			#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+			#if( ipconfigUSE_LOOPBACK != 0 )
+			/* The checksums of a packet that stays in this node are not
+			checked. */
+			if( xIsLoopbackAddress( pxIPHeader->ulDestinationIPAddress ) == pdFALSE )
+			#endif
 			{
 				pxIPHeader->usHeaderChecksum = 0U;
 				pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
@@ -208,6 +306,7 @@ size_t uxPayloadSize;
 
 			/* Generate an ARP for the required IP address. */
 			iptracePACKET_DROPPED_TO_GENERATE_ARP( pxNetworkBuffer->ulIPAddress );
+			ipSTATS_INCREMENT( ulARPCacheMisses );
 			pxNetworkBuffer->ulIPAddress = ulIPAddress;
 			vARPGenerateRequestPacket( pxNetworkBuffer );
 		}
@@ -215,11 +314,16 @@ size_t uxPayloadSize;
 		{
 			/* The lookup indicated that an ARP request has already been
 			sent out for the queried IP address. */
+			ipSTATS_INCREMENT( ulARPCacheMisses );
 			eReturned = eCantSendPacket;
 		}
 	}
 
-	if( eReturned != eCantSendPacket )
+	if( xReturn == pdFAIL )
+	{
+		/* The caller still owns the network buffer. */
+	}
+	else if( eReturned != eCantSendPacket )
 	{
 		/* The network driver is responsible for freeing the network buffer
 		after the packet has been sent. */
@@ -239,7 +343,12 @@ size_t uxPayloadSize;
 		}
 		#endif
 
-		( void ) xNetworkInterfaceOutput( pxNetworkBuffer, pdTRUE );
+		#if( ipconfigUSE_LOOPBACK != 0 )
+		if( xLoopbackOutput( pxNetworkBuffer, pdTRUE ) == pdFALSE )
+		#endif
+		{
+			( void ) xNetworkInterfaceOutput( pxNetworkBuffer, pdTRUE );
+		}
 	}
 	else
 	{
@@ -247,6 +356,101 @@ size_t uxPayloadSize;
 		packet. */
 		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvQueueUDPPacket( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+BaseType_t xReturn = pdPASS;
+
+	#if( ipconfigUDP_MAX_RX_PACKETS > 0U )
+	{
+		if ( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) >= pxSocket->u.xUDP.uxMaxPackets )
+		{
+			FreeRTOS_debug_printf( ( "xProcessReceivedUDPPacket: buffer full %ld >= %ld port %u\n",
+				listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ),
+				pxSocket->u.xUDP.uxMaxPackets, pxSocket->usLocalPort ) );
+			ipSOCKET_STATS_ADD( pxSocket, ulRxDropped, 1U );
+			xReturn = pdFAIL; /* we did not consume or release the buffer */
+		}
+	}
+	#endif
+
+	#if( ipconfigUDP_MAX_RX_PACKETS > 0U )
+	if( xReturn == pdPASS )
+	#endif
+	{
+		#if( ipconfigUSE_IP_STATISTICS != 0 )
+		{
+		size_t uxHeaderOffset = ipUDP_PAYLOAD_OFFSET_IPv4 - ipSIZE_OF_UDP_HEADER;
+		const UDPHeader_t *pxUDPHeader;
+
+			#if( ipconfigUSE_IPv6 != 0 )
+			if( socketIS_IPv6( pxSocket ) )
+			{
+				uxHeaderOffset = ipUDP_PAYLOAD_OFFSET_IPv6 - ipSIZE_OF_UDP_HEADER;
+			}
+			#endif /* ipconfigUSE_IPv6 */
+
+			/* The UDP length also covers the fragments of a reassembled
+			datagram. */
+			pxUDPHeader = ipPOINTER_CAST( const UDPHeader_t *, &( pxNetworkBuffer->pucEthernetBuffer[ uxHeaderOffset ] ) );
+			ipSOCKET_STATS_ADD( pxSocket, ulRxPackets, 1U );
+			ipSOCKET_STATS_ADD( pxSocket, ulRxBytes, FreeRTOS_ntohs( pxUDPHeader->usLength ) - ipSIZE_OF_UDP_HEADER );
+		}
+		#endif /* ipconfigUSE_IP_STATISTICS */
+
+		iptraceRX_DELIVERED_TO_SOCKET( pxNetworkBuffer );
+
+		vTaskSuspendAll();
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Add the network packet to the list of packets to be
+				processed by the socket. */
+				vListInsertEnd( &( pxSocket->u.xUDP.xWaitingPacketsList ), &( pxNetworkBuffer->xBufferListItem ) );
+			}
+			taskEXIT_CRITICAL();
+		}
+		( void ) xTaskResumeAll();
+
+		/* Set the socket's receive event */
+		if( pxSocket->xEventGroup != NULL )
+		{
+			( void ) xEventGroupSetBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_RECEIVE );
+		}
+
+		#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+		{
+			if( ( pxSocket->pxSocketSet != NULL ) && ( ( pxSocket->xSelectBits & ( ( EventBits_t ) eSELECT_READ ) ) != 0U ) )
+			{
+				( void ) xEventGroupSetBits( pxSocket->pxSocketSet->xSelectGroup, ( EventBits_t ) eSELECT_READ );
+			}
+		}
+		#endif
+
+		#if( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
+		{
+			if( pxSocket->pxUserSemaphore != NULL )
+			{
+				( void ) xSemaphoreGive( pxSocket->pxUserSemaphore );
+			}
+		}
+		#endif
+
+		#if( ipconfigUSE_DHCP == 1 )
+		{
+			if( xIsDHCPSocket( pxSocket ) != 0 )
+			{
+				( void ) xSendEventToIPTask( eDHCPEvent );
+			}
+		}
+		#endif
+	}
+
+	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
@@ -263,6 +467,29 @@ const UDPPacket_t *pxUDPPacket = ipPOINTER_CAST( const UDPPacket_t *, pxNetworkB
 	/* Caller must check for minimum packet size. */
 	pxSocket = pxUDPSocketLookup( usPort );
 
+	#if( ipconfigUSE_IGMP != 0 )
+	{
+		/* A multicast packet is only for a socket that joined the group.
+		Otherwise LLMNR packets fall through to the handler below. */
+		if( ( pxSocket != NULL ) &&
+			( xIsIPv4Multicast( pxUDPPacket->xIPHeader.ulDestinationIPAddress ) != 0 ) &&
+			( xIGMPSocketIsMember( pxSocket, pxUDPPacket->xIPHeader.ulDestinationIPAddress ) == pdFALSE ) )
+		{
+			pxSocket = NULL;
+		}
+	}
+	#endif /* ipconfigUSE_IGMP */
+
+	#if( ipconfigUSE_IPv6 != 0 )
+	{
+		/* IPv4 and IPv6 sockets share the port numbers. */
+		if( ( pxSocket != NULL ) && socketIS_IPv6( pxSocket ) )
+		{
+			pxSocket = NULL;
+		}
+	}
+	#endif /* ipconfigUSE_IPv6 */
+
 	if( pxSocket != NULL )
 	{
 
@@ -297,71 +524,9 @@ const UDPPacket_t *pxUDPPacket = ipPOINTER_CAST( const UDPPacket_t *, pxNetworkB
 		}
 		#endif /* ipconfigUSE_CALLBACKS */
 
-		#if( ipconfigUDP_MAX_RX_PACKETS > 0U )
+		if( xReturn == pdPASS )
 		{
-			if( xReturn == pdPASS )
-			{
-				if ( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) >= pxSocket->u.xUDP.uxMaxPackets )
-				{
-					FreeRTOS_debug_printf( ( "xProcessReceivedUDPPacket: buffer full %ld >= %ld port %u\n",
-						listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ),
-						pxSocket->u.xUDP.uxMaxPackets, pxSocket->usLocalPort ) );
-					xReturn = pdFAIL; /* we did not consume or release the buffer */
-				}
-			}
-		}
-		#endif
-
-		#if( ipconfigUSE_CALLBACKS == 1 ) || ( ipconfigUDP_MAX_RX_PACKETS > 0U )
-		if( xReturn == pdPASS )	/*lint !e774: Boolean within 'if' always evaluates to True, depending on configuration. [MISRA 2012 Rule 14.3, required. */
-		#else
-		/* xReturn is still pdPASS. */
-		#endif
-		{
-			vTaskSuspendAll();
-			{
-				taskENTER_CRITICAL();
-				{
-					/* Add the network packet to the list of packets to be
-					processed by the socket. */
-					vListInsertEnd( &( pxSocket->u.xUDP.xWaitingPacketsList ), &( pxNetworkBuffer->xBufferListItem ) );
-				}
-				taskEXIT_CRITICAL();
-			}
-			( void ) xTaskResumeAll();
-
-			/* Set the socket's receive event */
-			if( pxSocket->xEventGroup != NULL )
-			{
-				( void ) xEventGroupSetBits( pxSocket->xEventGroup, ( EventBits_t ) eSOCKET_RECEIVE );
-			}
-
-			#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
-			{
-				if( ( pxSocket->pxSocketSet != NULL ) && ( ( pxSocket->xSelectBits & ( ( EventBits_t ) eSELECT_READ ) ) != 0U ) )
-				{
-					( void ) xEventGroupSetBits( pxSocket->pxSocketSet->xSelectGroup, ( EventBits_t ) eSELECT_READ );
-				}
-			}
-			#endif
-
-			#if( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
-			{
-				if( pxSocket->pxUserSemaphore != NULL )
-				{
-					( void ) xSemaphoreGive( pxSocket->pxUserSemaphore );
-				}
-			}
-			#endif
-
-			#if( ipconfigUSE_DHCP == 1 )
-			{
-				if( xIsDHCPSocket( pxSocket ) != 0 )
-				{
-					( void ) xSendEventToIPTask( eDHCPEvent );
-				}
-			}
-			#endif
+			xReturn = prvQueueUDPPacket( pxSocket, pxNetworkBuffer );
 		}
 	}
 	else
@@ -404,6 +569,7 @@ const UDPPacket_t *pxUDPPacket = ipPOINTER_CAST( const UDPPacket_t *, pxNetworkB
 			else
 		#endif /* ipconfigUSE_NBNS */
 			{
+				ipSTATS_INCREMENT( ulUDPNoSocket );
 				xReturn = pdFAIL;
 			}
 	}
@@ -411,3 +577,70 @@ const UDPPacket_t *pxUDPPacket = ipPOINTER_CAST( const UDPPacket_t *, pxNetworkB
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_IPv6 != 0 )
+
+	BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t *pxNetworkBuffer, uint16_t usPort )
+	{
+	BaseType_t xReturn = pdFAIL;
+	FreeRTOS_Socket_t *pxSocket;
+	const UDPPacket_IPv6_t *pxUDPPacket = ipPOINTER_CAST( const UDPPacket_IPv6_t *, pxNetworkBuffer->pucEthernetBuffer );
+
+		/* Caller must check for minimum packet size. */
+		pxSocket = pxUDPSocketLookup( usPort );
+
+		if( ( pxSocket != NULL ) && socketIS_IPv6( pxSocket ) )
+		{
+			/* Only handled packets refresh the neighbour cache. */
+			vNDRefreshCacheEntry( &( pxUDPPacket->xEthernetHeader.xSourceAddress ), &( pxUDPPacket->xIPHeader.xSourceAddress ) );
+			xReturn = pdPASS;
+
+			#if( ipconfigUSE_CALLBACKS == 1 )
+			{
+				/* Did the owner of this socket register a reception handler ? */
+				if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleReceive ) )
+				{
+					struct freertos_sockaddr6 xSourceAddress, xDestinationAddress;
+					void *pcData = &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv6 ] );
+					FOnUDPReceive_t xHandler = ( FOnUDPReceive_t ) pxSocket->u.xUDP.pxHandleReceive;
+
+					( void ) memset( &xSourceAddress, 0, sizeof( xSourceAddress ) );
+					( void ) memset( &xDestinationAddress, 0, sizeof( xDestinationAddress ) );
+					xSourceAddress.sin_len = ( uint8_t ) sizeof( xSourceAddress );
+					xSourceAddress.sin_family = FREERTOS_AF_INET6;
+					xSourceAddress.sin_port = pxNetworkBuffer->usPort;
+					xSourceAddress.sin_addr6 = pxUDPPacket->xIPHeader.xSourceAddress;
+					xDestinationAddress.sin_len = ( uint8_t ) sizeof( xDestinationAddress );
+					xDestinationAddress.sin_family = FREERTOS_AF_INET6;
+					xDestinationAddress.sin_port = usPort;
+					xDestinationAddress.sin_addr6 = pxUDPPacket->xIPHeader.xDestinationAddress;
+
+					/* The handler sees IPv6 addresses, as announced by
+					'sin_family'. */
+					if( xHandler( ( Socket_t ) pxSocket,
+								  ( void* ) pcData,
+								  ( size_t ) ( pxNetworkBuffer->xDataLength - ipUDP_PAYLOAD_OFFSET_IPv6 ),
+								  ipPOINTER_CAST( struct freertos_sockaddr *, &( xSourceAddress ) ),
+								  ipPOINTER_CAST( struct freertos_sockaddr *, &( xDestinationAddress ) ) ) != 0 )
+					{
+						xReturn = pdFAIL; /* xHandler has consumed the data, do not add it to .xWaitingPacketsList'. */
+					}
+				}
+			}
+			#endif /* ipconfigUSE_CALLBACKS */
+
+			if( xReturn == pdPASS )
+			{
+				xReturn = prvQueueUDPPacket( pxSocket, pxNetworkBuffer );
+			}
+		}
+		else
+		{
+			ipSTATS_INCREMENT( ulUDPNoSocket );
+		}
+
+		return xReturn;
+	}
+
+#endif /* ipconfigUSE_IPv6 */
+/*-----------------------------------------------------------*/
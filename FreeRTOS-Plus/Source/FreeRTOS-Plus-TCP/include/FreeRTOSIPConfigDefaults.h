@@ -313,6 +313,153 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigEVENT_QUEUE_LENGTH		( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS + 5 )
 #endif
 
+/* When ipconfigEVENT_QUEUE_LANES is set to 1, the events for the IP-task are
+passed through three queues ("lanes") in stead of one:
+	- control: timers, bind, close, select, signals ( length ipconfigEVENT_QUEUE_LENGTH )
+	- TX: packets to be sent ( length ipconfigEVENT_TX_LANE_LENGTH )
+	- RX: received packets ( length ipconfigEVENT_RX_LANE_LENGTH )
+The IP-task visits the lanes in turn, taking at most ipconfigEVENT_LANE_WEIGHT_xxx
+events from a lane before moving to the next one.  A flood of received packets
+can therefore not hold up the timers or the user API.  Received packets are
+refused as soon as ipconfigEVENT_RX_LANE_DROP_LEVEL of them are waiting. */
+#ifndef ipconfigEVENT_QUEUE_LANES
+	#define ipconfigEVENT_QUEUE_LANES		0
+#endif
+
+#ifndef ipconfigEVENT_TX_LANE_LENGTH
+	#define ipconfigEVENT_TX_LANE_LENGTH	ipconfigEVENT_QUEUE_LENGTH
+#endif
+
+#ifndef ipconfigEVENT_RX_LANE_LENGTH
+	#define ipconfigEVENT_RX_LANE_LENGTH	ipconfigEVENT_QUEUE_LENGTH
+#endif
+
+#ifndef ipconfigEVENT_RX_LANE_DROP_LEVEL
+	#define ipconfigEVENT_RX_LANE_DROP_LEVEL	ipconfigEVENT_RX_LANE_LENGTH
+#endif
+
+#ifndef ipconfigEVENT_LANE_WEIGHT_CONTROL
+	#define ipconfigEVENT_LANE_WEIGHT_CONTROL	4
+#endif
+
+#ifndef ipconfigEVENT_LANE_WEIGHT_TX
+	#define ipconfigEVENT_LANE_WEIGHT_TX		2
+#endif
+
+#ifndef ipconfigEVENT_LANE_WEIGHT_RX
+	#define ipconfigEVENT_LANE_WEIGHT_RX		2
+#endif
+
+/* When ipconfigUDP_DIRECT_SEND is set to 1, a UDP socket can be given the
+option FREERTOS_SO_UDP_DIRECT_SEND.  FreeRTOS_sendto() on such a socket will
+then build the packet and call xNetworkInterfaceOutput() from the calling task,
+as long as the ARP cache holds the MAC address of the destination.  Only when
+the address must be resolved is the packet passed to the IP-task.  This saves
+two task switches per datagram, but xNetworkInterfaceOutput() will be called
+from several tasks at the same time.  A driver that allows that declares it by
+calling vUDPDirectSendSetDriverSupport( pdTRUE ), as the linux_tap and
+linux_af_packet drivers do.  With any other driver FreeRTOS_setsockopt()
+refuses the option with -pdFREERTOS_ERRNO_EOPNOTSUPP. */
+#ifndef ipconfigUDP_DIRECT_SEND
+	#define ipconfigUDP_DIRECT_SEND		0
+#endif
+
+/* When ipconfigUSE_IP_REASSEMBLY is set to 1, fragmented IPv4 datagrams are
+reassembled instead of dropped.  The fragments stay in the network buffers in
+which they were received; a complete datagram is passed to the UDP socket as a
+chain of those buffers.  At most ipconfigIP_REASSEMBLY_MAX_DATAGRAMS datagrams
+are reassembled at the same time, and together they may hold no more than
+ipconfigIP_REASSEMBLY_MAX_BUFFERS network buffers.  When a limit is reached,
+the oldest incomplete datagram is dropped.  A datagram that is not complete
+within ipconfigIP_REASSEMBLY_TIMEOUT_MS is dropped as well.  Only UDP is
+reassembled, fragmented TCP and ICMP packets are still dropped.
+A reception call-back, the DNS/LLMNR/NBNS parser and a FREERTOS_ZERO_COPY read
+need contiguous data, for them the chain is copied into a single network buffer.
+With BufferAllocation_1.c the network buffers have a fixed size, and a datagram
+that is longer than ipconfigNETWORK_MTU can then only be read by calling
+FreeRTOS_recvfrom() without FREERTOS_ZERO_COPY: a zero-copy read returns
+-pdFREERTOS_ERRNO_ENOBUFS and drops it, while a call-back or the DNS parser will
+never see it.  A zero-copy read that also sets FREERTOS_MSG_PEEK always returns
+-pdFREERTOS_ERRNO_ENOBUFS for a chain, without dropping it. */
+#ifndef ipconfigUSE_IP_REASSEMBLY
+	#define ipconfigUSE_IP_REASSEMBLY		0
+#endif
+
+#ifndef ipconfigIP_REASSEMBLY_MAX_DATAGRAMS
+	#define ipconfigIP_REASSEMBLY_MAX_DATAGRAMS	4
+#endif
+
+#ifndef ipconfigIP_REASSEMBLY_MAX_BUFFERS
+	#define ipconfigIP_REASSEMBLY_MAX_BUFFERS	( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS / 4 )
+#endif
+
+#ifndef ipconfigIP_REASSEMBLY_TIMEOUT_MS
+	#define ipconfigIP_REASSEMBLY_TIMEOUT_MS	5000U
+#endif
+
+/* When ipconfigUSE_LOOPBACK is set to 1, packets sent to 127.0.0.0/8 or to
+the IP address of this node are not passed to the network driver.  They are
+handed back to the IP-task as they are, without ARP, without copying and without
+calculating or checking checksums.  A packet sent to a 127.x.x.x address will
+also have that address as its source address. */
+#ifndef ipconfigUSE_LOOPBACK
+	#define ipconfigUSE_LOOPBACK		0
+#endif
+
+/* When ipconfigUSE_IGMP is set to 1, UDP sockets can join IPv4 multicast groups
+with the socket options FREERTOS_SO_IP_ADD_MEMBERSHIP and
+FREERTOS_SO_IP_DROP_MEMBERSHIP.  The stack answers IGMPv2 and IGMPv3 queries.
+Multicast packets are only delivered to the sockets that joined the group. */
+#ifndef ipconfigUSE_IGMP
+	#define ipconfigUSE_IGMP			0
+#endif
+
+/* The maximum number of different groups joined by all sockets together. */
+#ifndef ipconfigIGMP_MAX_GROUPS
+	#define ipconfigIGMP_MAX_GROUPS		8
+#endif
+
+/* The maximum number of groups a single UDP socket can join. */
+#ifndef ipconfigIGMP_MAX_SOCKET_GROUPS
+	#define ipconfigIGMP_MAX_SOCKET_GROUPS	4
+#endif
+
+/* Set ipconfigIGMP_DRIVER_MAC_FILTER to 1 if the network driver implements
+vNetworkInterfaceAddAllowedMAC() and vNetworkInterfaceRemoveAllowedMAC().  The
+IP-task calls them to program the multicast filter of the EMAC, so that frames
+of other groups are dropped in hardware. */
+#ifndef ipconfigIGMP_DRIVER_MAC_FILTER
+	#define ipconfigIGMP_DRIVER_MAC_FILTER	0
+#endif
+
+/* When ipconfigUSE_IPv6 is set to 1, the stack also handles IPv6: neighbour
+discovery, ICMPv6 echo, stateless address autoconfiguration (SLAAC), and UDP
+and TCP sockets created with FREERTOS_AF_INET6.  IPv4 packets are processed
+as before, the IPv6 code is only entered for frames of type 0x86DD. */
+#ifndef ipconfigUSE_IPv6
+	#define ipconfigUSE_IPv6			0
+#endif
+
+/* The number of entries in the IPv6 neighbour cache.  The cache is a hash
+table with 4 entries per bucket, so the value must be a multiple of 4. */
+#ifndef ipconfigND_CACHE_ENTRIES
+	#define ipconfigND_CACHE_ENTRIES	16
+#endif
+
+/* The hop limit of outgoing IPv6 packets, unless a router advertisement
+defines a different value. */
+#ifndef ipconfigIPv6_HOP_LIMIT
+	#define ipconfigIPv6_HOP_LIMIT		64
+#endif
+
+/* When ipconfigUSE_IP_STATISTICS is set to 1, the stack maintains counters
+per socket and for the stack as a whole.  A copy of the counters can be
+obtained at any time with FreeRTOS_GetIPStackStats() and
+FreeRTOS_GetSocketStats(), see FreeRTOS_IP_Stats.h. */
+#ifndef ipconfigUSE_IP_STATISTICS
+	#define ipconfigUSE_IP_STATISTICS	0
+#endif
+
 #ifndef ipconfigALLOW_SOCKET_SEND_WITHOUT_BIND
 	#define ipconfigALLOW_SOCKET_SEND_WITHOUT_BIND 1
 #endif
@@ -350,6 +497,40 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigDHCP_FALL_BACK_AUTO_IP		( 0 )
 #endif
 
+#ifndef ipconfigDHCP_USE_LEASE_STORAGE
+	/*
+	 * When set to 1, the application keeps the last lease in storage that
+	 * survives a reboot, and provides xApplicationDHCPLoadLease() and
+	 * vApplicationDHCPStoreLease(), see FreeRTOS_DHCP.h.  When DHCP starts
+	 * and a stored lease is found, the client first asks to keep the same
+	 * address in the INIT-REBOOT state (RFC 2131, 4.3.2), which takes a
+	 * single exchange instead of the two of a DISCOVER.
+	 */
+	#define ipconfigDHCP_USE_LEASE_STORAGE		0
+#endif
+
+#ifndef ipconfigDHCP_INIT_REBOOT_TX_PERIOD
+	/* The time to wait for an answer to the first INIT-REBOOT request.  The
+	period is doubled for every next attempt. */
+	#define ipconfigDHCP_INIT_REBOOT_TX_PERIOD	( pdMS_TO_TICKS( 250U ) )
+#endif
+
+#ifndef ipconfigDHCP_INIT_REBOOT_ATTEMPTS
+	/* The number of INIT-REBOOT requests after which the client gives up on
+	the stored lease and starts over with a DISCOVER. */
+	#define ipconfigDHCP_INIT_REBOOT_ATTEMPTS	3U
+#endif
+
+#ifndef ipconfigDHCP_USE_RAPID_COMMIT
+	/*
+	 * When set to 1, the DISCOVER carries the Rapid Commit option (RFC 4039).
+	 * A server that supports it answers with an ACK right away, and the
+	 * REQUEST / ACK exchange is skipped.  Servers that do not support it
+	 * answer with a normal OFFER.
+	 */
+	#define ipconfigDHCP_USE_RAPID_COMMIT		0
+#endif
+
 #if( ipconfigDHCP_FALL_BACK_AUTO_IP != 0 )
 	#define ipconfigARP_USE_CLASH_DETECTION		1
 #endif
@@ -536,10 +717,66 @@ answers on successive calls to FreeRTOS_gethostbyname(). */
 	#define ipconfigTCP_KEEP_ALIVE 0
 #endif
 
+/* The default keep-alive settings of a TCP socket, they can be changed per
+socket with the options FREERTOS_SO_TCP_KEEPIDLE, FREERTOS_SO_TCP_KEEPINTVL and
+FREERTOS_SO_TCP_KEEPCNT.  The idle time and the interval are in seconds. */
+#ifndef ipconfigTCP_KEEP_ALIVE_INTERVAL
+	#define ipconfigTCP_KEEP_ALIVE_INTERVAL			20U
+#endif
+
+#ifndef ipconfigTCP_KEEP_ALIVE_PROBE_INTERVAL
+	#define ipconfigTCP_KEEP_ALIVE_PROBE_INTERVAL	3U
+#endif
+
+#ifndef ipconfigTCP_KEEP_ALIVE_PROBE_COUNT
+	#define ipconfigTCP_KEEP_ALIVE_PROBE_COUNT		4U
+#endif
+
 #ifndef ipconfigDNS_USE_CALLBACKS
 	#define ipconfigDNS_USE_CALLBACKS 0
 #endif
 
+/* When ipconfigDNS_USE_ASYNC is set to 1, FreeRTOS_gethostbyname() and
+FreeRTOS_gethostbyname_a() are served by a resolver that is driven by the
+IP-task.  All look-ups share a single UDP socket, concurrent look-ups of the
+same name share a single query, and every query is sent to all known DNS
+servers at once.  FreeRTOS_dnsquery() and FreeRTOS_dnsquery_a() also look up
+AAAA and SRV records.  The resolver uses the call-back mechanisms of the
+stack. */
+#ifndef ipconfigDNS_USE_ASYNC
+	#define ipconfigDNS_USE_ASYNC				0
+#endif
+
+#if( ipconfigDNS_USE_ASYNC != 0 )
+	#if( ipconfigDNS_USE_CALLBACKS == 0 ) || ( ipconfigUSE_CALLBACKS == 0 )
+		#error ipconfigDNS_USE_ASYNC requires both ipconfigDNS_USE_CALLBACKS and ipconfigUSE_CALLBACKS
+	#endif
+
+	/* The number of DNS servers that can be set with FreeRTOS_dnsservers(),
+	next to the one that is configured by FreeRTOS_IPInit() or by DHCP. */
+	#ifndef ipconfigDNS_MAX_SERVERS
+		#define ipconfigDNS_MAX_SERVERS			2
+	#endif
+
+	/* The longest name that can be looked up, the null terminator included.
+	Also the space for the target name of a SRV record. */
+	#ifndef ipconfigDNS_ASYNC_NAME_LENGTH
+		#define ipconfigDNS_ASYNC_NAME_LENGTH	128
+	#endif
+
+	/* The maximum number of records that is kept from a reply. */
+	#ifndef ipconfigDNS_ASYNC_MAX_ANSWERS
+		#define ipconfigDNS_ASYNC_MAX_ANSWERS	4
+	#endif
+
+	/* The time before a query is sent for the second time.  The time doubles
+	for every next attempt, until ipconfigDNS_REQUEST_ATTEMPTS have been
+	made. */
+	#ifndef ipconfigDNS_ASYNC_RETRY_MS
+		#define ipconfigDNS_ASYNC_RETRY_MS		500U
+	#endif
+#endif /* ipconfigDNS_USE_ASYNC */
+
 #ifndef ipconfigSUPPORT_SIGNALS
 	#define ipconfigSUPPORT_SIGNALS				0
 #endif
@@ -128,7 +128,9 @@ in NetworkInterface.c as follows:
 		return pdTRUE;
 	}
 	/ * Send the packet as usual. * /
-*/
+
+When ipconfigUSE_LOOPBACK is defined as 1, such packets never reach the driver:
+they are passed back at the IP layer by xLoopbackOutput(). */
 BaseType_t xCheckLoopback( NetworkBufferDescriptor_t * const pxDescriptor, BaseType_t bReleaseAfterSend );
 
 #ifdef __cplusplus
@@ -76,6 +76,12 @@ struct xDHCP_DATA
 	TickType_t xDHCPTxPeriod;
 	/* Try both without and with the broadcast flag */
 	BaseType_t xUseBroadcast;
+	/* The time at which obtaining the current address started. */
+	TickType_t xStartTime;
+	/* Set while a stored lease is being confirmed in the INIT-REBOOT state. */
+	BaseType_t xInitReboot;
+	/* Set when the last reply was an ACK to a DISCOVER (RFC 4039). */
+	BaseType_t xRapidCommit;
 	/* Maintains the DHCP state machine state. */
 	eDHCPState_t eDHCPState;
 };
@@ -99,6 +105,33 @@ BaseType_t xIsDHCPSocket( Socket_t xSocket );
 	eDHCPCallbackAnswer_t xApplicationDHCPHook( eDHCPCallbackPhase_t eDHCPPhase, uint32_t ulIPAddress );
 #endif	/* ( ipconfigUSE_DHCP_HOOK != 0 ) */
 
+#if( ipconfigDHCP_USE_LEASE_STORAGE != 0 )
+	/* A lease as it is kept in storage by the application.  The addresses are
+	stored in network-endian format. */
+	typedef struct xDHCP_LEASE
+	{
+		uint32_t ulIPAddress;
+		uint32_t ulNetMask;
+		uint32_t ulGatewayAddress;
+		uint32_t ulDNSServerAddress;
+		uint32_t ulServerAddress;	/* The DHCP server that granted the lease. */
+		uint32_t ulRenewalTime;		/* Seconds after which the stack renews the lease. */
+	} DHCPLease_t;
+
+	/* Must be provided by the application if ipconfigDHCP_USE_LEASE_STORAGE is
+	set to 1.  Fill in the lease that was last stored and return pdTRUE, or
+	return pdFALSE when there is none, or when it is known to have expired.
+	Called from the IP-task whenever DHCP starts. */
+	BaseType_t xApplicationDHCPLoadLease( DHCPLease_t *pxLease );
+
+	/* Must be provided by the application if ipconfigDHCP_USE_LEASE_STORAGE is
+	set to 1.  Called from the IP-task when a lease was bound that differs from
+	the one in storage, and with NULL when the server refused the stored lease
+	and it must be forgotten.  A renewal of the same lease is not stored again,
+	so the storage can be flash memory. */
+	void vApplicationDHCPStoreLease( const DHCPLease_t *pxLease );
+#endif	/* ( ipconfigDHCP_USE_LEASE_STORAGE != 0 ) */
+
 #ifdef __cplusplus
 }	/* extern "C" */
 #endif
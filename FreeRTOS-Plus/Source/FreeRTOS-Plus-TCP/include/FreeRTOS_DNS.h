@@ -113,6 +113,65 @@ uint32_t ulDNSHandlePacket( const NetworkBufferDescriptor_t *pxNetworkBuffer );
 
 #endif
 
+#if( ipconfigDNS_USE_ASYNC != 0 )
+
+	/* The record types that can be looked up with FreeRTOS_dnsquery(). */
+	#define ipDNS_TYPE_A		1U	/* IPv4 address. */
+	#define ipDNS_TYPE_AAAA		28U	/* IPv6 address, needs ipconfigUSE_IPv6. */
+	#define ipDNS_TYPE_SRV		33U	/* Service location, RFC 2782. */
+
+	typedef struct xDNS_ANSWER
+	{
+		uint16_t usType;		/* One of the ipDNS_TYPE_ values. */
+		uint32_t ulTTL;			/* Time-to-live of the record in seconds. */
+		union
+		{
+			uint32_t ulIPAddress;			/* ipDNS_TYPE_A, in network byte order. */
+			#if( ipconfigUSE_IPv6 != 0 )
+				IPv6_Address_t xIPv6Address;	/* ipDNS_TYPE_AAAA */
+			#endif
+			struct
+			{
+				uint16_t usPriority;
+				uint16_t usWeight;
+				uint16_t usPort;			/* In host byte order. */
+				char pcTarget[ ipconfigDNS_ASYNC_NAME_LENGTH ];
+			} xService;						/* ipDNS_TYPE_SRV */
+		} u;
+	} DNSAnswer_t;
+
+	/*
+	 * Called from the IP-task when a query has been answered, or when it has
+	 * failed or timed out, in which case xCount is 0.  The answers are only
+	 * valid during the call.
+	 */
+	typedef void (* FOnDNSResult ) ( const char * /* pcName */, void * /* pvSearchID */, BaseType_t /* xCount */, const DNSAnswer_t * /* pxAnswers */ );
+
+	/*
+	 * Look up the records of type usType for pcName.  The call-back will be
+	 * called exactly once, unless the look-up is cancelled with
+	 * FreeRTOS_gethostbyname_cancel( pvSearchID ).  uxTimeout is in units of
+	 * ms.  Returns pdFAIL when the look-up could not be started.
+	 */
+	BaseType_t FreeRTOS_dnsquery_a( const char *pcName, uint16_t usType, FOnDNSResult pxCallback, void *pvSearchID, TickType_t uxTimeout );
+
+	/*
+	 * Blocking version of FreeRTOS_dnsquery_a().  Copies at most xMaxAnswers
+	 * records to pxAnswers and returns the number of records copied, 0 when
+	 * none were found.
+	 */
+	BaseType_t FreeRTOS_dnsquery( const char *pcName, uint16_t usType, DNSAnswer_t *pxAnswers, BaseType_t xMaxAnswers, TickType_t uxTimeout );
+
+	/*
+	 * Set the DNS servers that are asked next to the one that was configured
+	 * by FreeRTOS_IPInit() or by DHCP.  The addresses are in network byte
+	 * order, at most ipconfigDNS_MAX_SERVERS will be used.  Passing a count
+	 * of 0 removes them.
+	 */
+	void FreeRTOS_dnsservers( const uint32_t *pulAddresses, BaseType_t xCount );
+
+#endif /* ipconfigDNS_USE_ASYNC */
+
 /*
  * Lookup a IPv4 node in a blocking-way.
  * It returns a 32-bit IP-address, 0 when not found.
@@ -0,0 +1,139 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_IGMP_H
+#define FREERTOS_IGMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Application level configuration options. */
+#include "FreeRTOSIPConfig.h"
+#include "FreeRTOSIPConfigDefaults.h"
+#include "IPTraceMacroDefaults.h"
+
+#if( ipconfigUSE_IGMP != 0 )
+
+/* IGMP message types. */
+#define ipIGMP_MEMBERSHIP_QUERY			( ( uint8_t ) 0x11U )
+#define ipIGMP_V1_MEMBERSHIP_REPORT		( ( uint8_t ) 0x12U )
+#define ipIGMP_V2_MEMBERSHIP_REPORT		( ( uint8_t ) 0x16U )
+#define ipIGMP_V2_LEAVE_GROUP			( ( uint8_t ) 0x17U )
+#define ipIGMP_V3_MEMBERSHIP_REPORT		( ( uint8_t ) 0x22U )
+
+/* The IGMP timers count in units of 100 ms, which is also the unit of the
+"max response time" field of a query. */
+#define ipIGMP_TIMER_PERIOD_MS			( 100U )
+
+#include "pack_struct_start.h"
+struct xIGMP_HEADER
+{
+	uint8_t ucMessageType;		/* 0 + 1 = 1 */
+	uint8_t ucMaxResponseTime;	/* 1 + 1 = 2 */
+	uint16_t usChecksum;		/* 2 + 2 = 4 */
+	uint32_t ulGroupAddress;	/* 4 + 4 = 8 */
+}
+#include "pack_struct_end.h"
+typedef struct xIGMP_HEADER IGMPHeader_t;
+
+/* An IGMPv3 membership report with a single group record without sources. */
+#include "pack_struct_start.h"
+struct xIGMPv3_REPORT
+{
+	uint8_t ucMessageType;		/*  0 + 1 =  1 */
+	uint8_t ucReserved1;		/*  1 + 1 =  2 */
+	uint16_t usChecksum;		/*  2 + 2 =  4 */
+	uint16_t usReserved2;		/*  4 + 2 =  6 */
+	uint16_t usNumberOfRecords;	/*  6 + 2 =  8 */
+	uint8_t ucRecordType;		/*  8 + 1 =  9 */
+	uint8_t ucAuxDataLength;	/*  9 + 1 = 10 */
+	uint16_t usNumberOfSources;	/* 10 + 2 = 12 */
+	uint32_t ulGroupAddress;	/* 12 + 4 = 16 */
+}
+#include "pack_struct_end.h"
+typedef struct xIGMPv3_REPORT IGMPv3Report_t;
+
+/*
+ * Called by the IP-task for every IGMP message that is addressed to this node.
+ * 'uxHeaderLength' is the length of the IP header as it was received,
+ * including options.  Queries schedule membership reports.  The buffer is
+ * never kept, eReleaseBuffer is returned.
+ */
+eFrameProcessingResult_t eProcessIGMPPacket( const NetworkBufferDescriptor_t * const pxNetworkBuffer, UBaseType_t uxHeaderLength );
+
+/*
+ * Called by the IP-task from its IGMP timer, every ipIGMP_TIMER_PERIOD_MS,
+ * to send the scheduled membership reports.
+ */
+void vIGMPCheckTimers( void );
+
+/*
+ * Called by the IP-task after the groups joined by its sockets have changed:
+ * reports are sent for the new groups, and leave messages for the groups
+ * that are not used any more.
+ */
+void vIGMPUpdateGroups( void );
+
+/*
+ * Called by the IP-task when the network goes up: the driver filters are
+ * programmed and unsolicited reports are sent for all groups.
+ */
+void vIGMPNetworkUp( void );
+
+/*
+ * Returns pdTRUE if the group (network byte order) was joined by any socket,
+ * or if it is 224.0.0.1.
+ */
+BaseType_t xIGMPIsMemberOf( uint32_t ulGroupAddress );
+
+/*
+ * Returns pdTRUE if an IPv4 multicast MAC address may belong to a group that
+ * was joined.  This is a hash filter, like the ones in Ethernet hardware:
+ * some frames of other groups will pass.  It may be called by the driver.
+ */
+BaseType_t xIGMPIsMulticastMACAccepted( const MACAddress_t *pxMACAddress );
+
+/*
+ * Returns pdTRUE if the UDP socket joined the group.  The socket's hash
+ * filter is tested first, most packets for other groups are rejected
+ * without looking at the group list.
+ */
+BaseType_t xIGMPSocketIsMember( const FreeRTOS_Socket_t *pxSocket, uint32_t ulGroupAddress );
+
+/*
+ * Implements FREERTOS_SO_IP_ADD_MEMBERSHIP and FREERTOS_SO_IP_DROP_MEMBERSHIP
+ * for a UDP socket.  Returns 0 or a negative errno value.  The IP-task is
+ * asked to update the group memberships of the stack.
+ */
+BaseType_t xIGMPSocketSetMembership( FreeRTOS_Socket_t *pxSocket, uint32_t ulGroupAddress, BaseType_t xJoin );
+
+#endif /* ipconfigUSE_IGMP */
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* FREERTOS_IGMP_H */
@@ -132,8 +132,12 @@ typedef struct xNETWORK_BUFFER
 	size_t xDataLength; 			/* Starts by holding the total Ethernet frame length, then the UDP/TCP payload length. */
 	uint16_t usPort;				/* Source or destination port, depending on usage scenario. */
 	uint16_t usBoundPort;			/* The port to which a transmitting socket is bound. */
-	#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
-		struct xNETWORK_BUFFER *pxNextBuffer; /* Possible optimisation for expert users - requires network driver support. */
+	#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) || ( ipconfigUSE_IP_REASSEMBLY != 0 )
+		struct xNETWORK_BUFFER *pxNextBuffer; /* Possible optimisation for expert users - requires network driver support.  Also links the fragments of a reassembled datagram. */
+	#endif
+	#if( ipconfigUSE_LATENCY_STATS != 0 )
+		uint32_t ulHandoffTime;			/* Time at which the driver passed the buffer to the stack, 0 when unknown. */
+		uint32_t ulStageTime;			/* Time at which the current stage started. */
 	#endif
 } NetworkBufferDescriptor_t;
 
@@ -146,6 +150,21 @@ struct xMAC_ADDRESS
 
 typedef struct xMAC_ADDRESS MACAddress_t;
 
+#if( ipconfigUSE_IPv6 != 0 )
+	#define ipSIZE_OF_IPv6_HEADER		40U
+	#define ipSIZE_OF_ICMPv6_HEADER		8U
+	#define ipSIZE_OF_IPv6_ADDRESS		16U
+
+	#include "pack_struct_start.h"
+	struct xIPv6_ADDRESS
+	{
+		uint8_t ucBytes[ ipSIZE_OF_IPv6_ADDRESS ];
+	}
+	#include "pack_struct_end.h"
+
+	typedef struct xIPv6_ADDRESS IPv6_Address_t;
+#endif /* ipconfigUSE_IPv6 */
+
 typedef enum eNETWORK_EVENTS
 {
 	eNetworkUp,		/* The network is configured. */
@@ -304,6 +323,22 @@ BaseType_t FreeRTOS_IsNetworkUp( void );
 	UBaseType_t uxGetMinimumIPQueueSpace( void );
 #endif
 
+#if( ipconfigEVENT_QUEUE_LANES != 0 )
+	/* The lanes of the IP event queue, see ipconfigEVENT_QUEUE_LANES. */
+	#define ipEVENT_LANE_CONTROL	( 0 )
+	#define ipEVENT_LANE_TX			( 1 )
+	#define ipEVENT_LANE_RX			( 2 )
+	#define ipEVENT_LANE_COUNT		( 3 )
+
+	#if( ipconfigCHECK_IP_QUEUE_SPACE != 0 )
+		/* The lowest amount of space seen in a lane. */
+		UBaseType_t uxGetMinimumIPLaneSpace( BaseType_t xLane );
+
+		/* The number of events that could not be added to a lane. */
+		uint32_t ulGetIPLaneDropCount( BaseType_t xLane );
+	#endif
+#endif /* ipconfigEVENT_QUEUE_LANES */
+
 /*
  * Defined in FreeRTOS_Sockets.c
  * //_RB_ Don't think this comment is correct.  If this is for internal use only it should appear after all the public API functions and not start with FreeRTOS_.
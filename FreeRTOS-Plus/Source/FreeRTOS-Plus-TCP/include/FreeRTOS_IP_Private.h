@@ -36,6 +36,9 @@ extern "C" {
 #include "FreeRTOS_Sockets.h"
 #include "IPTraceMacroDefaults.h"
 #include "FreeRTOS_Stream_Buffer.h"
+#include "FreeRTOS_IP_Stats.h"
+#include "tcp_latency_stats.h"
+#include "tcp_capture_ring.h"
 #if( ipconfigUSE_TCP == 1 )
 	#include "FreeRTOS_TCP_WIN.h"
 	#include "FreeRTOS_TCP_IP.h"
@@ -199,6 +202,64 @@ struct xTCP_PACKET
 #include "pack_struct_end.h"
 typedef struct xTCP_PACKET TCPPacket_t;
 
+#if( ipconfigUSE_IPv6 != 0 )
+
+#include "pack_struct_start.h"
+struct xIP_HEADER_IPv6
+{
+	uint8_t ucVersionTrafficClass;		/*  0 +  1 =  1 */
+	uint8_t ucTrafficClassFlow;			/*  1 +  1 =  2 */
+	uint16_t usFlowLabel;				/*  2 +  2 =  4 */
+	uint16_t usPayloadLength;			/*  4 +  2 =  6 */
+	uint8_t ucNextHeader;				/*  6 +  1 =  7 */
+	uint8_t ucHopLimit;					/*  7 +  1 =  8 */
+	IPv6_Address_t xSourceAddress;		/*  8 + 16 = 24 */
+	IPv6_Address_t xDestinationAddress;	/* 24 + 16 = 40 */
+}
+#include "pack_struct_end.h"
+typedef struct xIP_HEADER_IPv6 IPHeader_IPv6_t;
+
+#include "pack_struct_start.h"
+struct xIP_PACKET_IPv6
+{
+	EthernetHeader_t xEthernetHeader;	/*  0 + 14 = 14 */
+	IPHeader_IPv6_t xIPHeader;			/* 14 + 40 = 54 */
+}
+#include "pack_struct_end.h"
+typedef struct xIP_PACKET_IPv6 IPPacket_IPv6_t;
+
+#include "pack_struct_start.h"
+struct xICMP_PACKET_IPv6
+{
+	EthernetHeader_t xEthernetHeader;	/*  0 + 14 = 14 */
+	IPHeader_IPv6_t xIPHeader;			/* 14 + 40 = 54 */
+	ICMPHeader_t xICMPHeader;			/* 54 +  8 = 62 */
+}
+#include "pack_struct_end.h"
+typedef struct xICMP_PACKET_IPv6 ICMPPacket_IPv6_t;
+
+#include "pack_struct_start.h"
+struct xUDP_PACKET_IPv6
+{
+	EthernetHeader_t xEthernetHeader;	/*  0 + 14 = 14 */
+	IPHeader_IPv6_t xIPHeader;			/* 14 + 40 = 54 */
+	UDPHeader_t xUDPHeader;				/* 54 +  8 = 62 */
+}
+#include "pack_struct_end.h"
+typedef struct xUDP_PACKET_IPv6 UDPPacket_IPv6_t;
+
+#include "pack_struct_start.h"
+struct xTCP_PACKET_IPv6
+{
+	EthernetHeader_t xEthernetHeader;	/*  0 + 14 = 14 */
+	IPHeader_IPv6_t xIPHeader;			/* 14 + 40 = 54 */
+	TCPHeader_t xTCPHeader;				/* 54 + 32 = 86 */
+}
+#include "pack_struct_end.h"
+typedef struct xTCP_PACKET_IPv6 TCPPacket_IPv6_t;
+
+#endif /* ipconfigUSE_IPv6 */
+
 typedef union XPROT_PACKET
 {
 	ARPPacket_t xARPPacket;
@@ -218,6 +279,11 @@ typedef union xPROT_HEADERS
 /* The maximum UDP payload length. */
 #define ipMAX_UDP_PAYLOAD_LENGTH ( ( ipconfigNETWORK_MTU - ipSIZE_OF_IPv4_HEADER ) - ipSIZE_OF_UDP_HEADER )
 
+#if( ipconfigUSE_IPv6 != 0 )
+	/* The maximum UDP payload length of an IPv6 packet. */
+	#define ipMAX_UDP_PAYLOAD_LENGTH_IPv6 ( ( ipconfigNETWORK_MTU - ipSIZE_OF_IPv6_HEADER ) - ipSIZE_OF_UDP_HEADER )
+#endif
+
 typedef enum
 {
 	eReleaseBuffer = 0,		/* Processing the frame did not find anything to do - just release the buffer. */
@@ -242,6 +308,9 @@ typedef enum
 	eSocketCloseEvent,		/*10: Send a message to the IP-task to close a socket. */
 	eSocketSelectEvent,		/*11: Send a message to the IP-task for select(). */
 	eSocketSignalEvent,		/*12: A socket must be signalled. */
+	eLoopbackRxEvent,		/*13: A packet was sent to this node and is handed back to the IP-task. */
+	eIGMPEvent,				/*14: The multicast groups joined by the UDP sockets have changed. */
+	eIPv6TxEvent			/*15: A task has built an IPv6 packet, the IP-task must look up the MAC address and send it. */
 } eIPEvent_t;
 
 typedef struct IP_TASK_COMMANDS
@@ -268,11 +337,17 @@ setting. */
 /* The offset into an IP packet into which the IP data (payload) starts. */
 #define ipIP_PAYLOAD_OFFSET		( sizeof( IPPacket_t ) )
 
+#if( ipconfigUSE_IPv6 != 0 )
+	/* The offset into an IPv6 UDP packet at which the UDP data starts. */
+	#define ipUDP_PAYLOAD_OFFSET_IPv6	( sizeof( UDPPacket_IPv6_t ) )
+#endif
+
 #if( ipconfigBYTE_ORDER == pdFREERTOS_LITTLE_ENDIAN )
 
 	/* Ethernet frame types. */
 	#define ipARP_FRAME_TYPE	( 0x0608U )
 	#define ipIPv4_FRAME_TYPE	( 0x0008U )
+	#define ipIPv6_FRAME_TYPE	( 0xDD86U )
 
 	/* ARP related definitions. */
 	#define ipARP_PROTOCOL_TYPE				( 0x0008U )
@@ -285,6 +360,7 @@ setting. */
 	/* Ethernet frame types. */
 	#define ipARP_FRAME_TYPE	( 0x0806U )
 	#define ipIPv4_FRAME_TYPE	( 0x0800U )
+	#define ipIPv6_FRAME_TYPE	( 0x86DDU )
 
 	/* ARP related definitions. */
 	#define ipARP_PROTOCOL_TYPE ( 0x0800U )
@@ -453,6 +529,14 @@ uint16_t usGenerateChecksum( uint16_t usSum, const uint8_t * pucNextData, size_t
  */
 BaseType_t xProcessReceivedUDPPacket( NetworkBufferDescriptor_t *pxNetworkBuffer, uint16_t usPort );
 
+#if( ipconfigUSE_IPv6 != 0 )
+	/*
+	 * The same as xProcessReceivedUDPPacket(), for IPv6 packets, which are only
+	 * delivered to IPv6 sockets.
+	 */
+	BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t *pxNetworkBuffer, uint16_t usPort );
+#endif
+
 /*
  * Initialize the socket list data structures for TCP and UDP. 
  */
@@ -498,7 +582,11 @@ BaseType_t xIPIsNetworkTaskReady( void );
 			/* The next field only serves to give 'ucLastPacket' a correct
 			alignment of 8 + 2.  See comments in FreeRTOS_IP.h */
 			uint8_t ucFillPacket[ ipconfigPACKET_FILLER_SIZE ];
-			uint8_t ucLastPacket[ sizeof( TCPPacket_t ) ];
+			#if( ipconfigUSE_IPv6 != 0 )
+				uint8_t ucLastPacket[ sizeof( TCPPacket_IPv6_t ) ];
+			#else
+				uint8_t ucLastPacket[ sizeof( TCPPacket_t ) ];
+			#endif
 		} u;
 	} LastTCPPacket_t;
 
@@ -512,6 +600,9 @@ BaseType_t xIPIsNetworkTaskReady( void );
 	{
 		uint32_t ulRemoteIP;		/* IP address of remote machine */
 		uint16_t usRemotePort;		/* Port on remote machine */
+		#if( ipconfigUSE_IPv6 != 0 )
+			IPv6_Address_t xRemoteIPv6Address;	/* IP address of remote machine, for an IPv6 socket */
+		#endif /* ipconfigUSE_IPv6 */
 		struct {
 			/* Most compilers do like bit-flags */
 			uint32_t
@@ -556,11 +647,21 @@ BaseType_t xIPIsNetworkTaskReady( void );
 		struct xSOCKET *pxPeerSocket;	/* for server socket: child, for child socket: parent */
 		#if( ipconfigTCP_KEEP_ALIVE == 1 )
 			uint8_t ucKeepRepCount;
+			uint8_t ucKeepEnabled;		/* FREERTOS_SO_KEEPALIVE: send keep-alive messages when the connection is idle */
+			uint8_t ucKeepCount;		/* FREERTOS_SO_TCP_KEEPCNT: unanswered keep-alive messages before giving up */
+			uint16_t usKeepIdle;		/* FREERTOS_SO_TCP_KEEPIDLE: seconds of silence before the first keep-alive message */
+			uint16_t usKeepInterval;	/* FREERTOS_SO_TCP_KEEPINTVL: seconds between unanswered keep-alive messages */
 			TickType_t xLastAliveTime;
 		#endif /* ipconfigTCP_KEEP_ALIVE */
 		#if( ipconfigTCP_HANG_PROTECTION == 1 )
 			TickType_t xLastActTime;
 		#endif /* ipconfigTCP_HANG_PROTECTION */
+		ListItem_t xTimerListItem;		/* Entry in xTCPTimerSocketsList while a time-out is running */
+		struct xSOCKET *pxTimerRequestNext;	/* Next socket for which the API requested a time-out */
+		uint8_t ucTimerRequested;		/* pdTRUE while the socket is in the list of requests */
+		#if( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 )
+			ListItem_t xAliveListItem;	/* Entry in the timer wheel of keep-alive and anti-hang checks, the value is the deadline */
+		#endif
 		size_t uxLittleSpace;
 		size_t uxEnoughSpace;
 		size_t uxRxStreamSize;
@@ -607,6 +708,13 @@ typedef struct UDPSOCKET
 											 */
 		FOnUDPSent_t pxHandleSent;
 	#endif /* ipconfigUSE_CALLBACKS */
+	#if( ipconfigUDP_DIRECT_SEND != 0 )
+		BaseType_t xDirectSend;	/* FREERTOS_SO_UDP_DIRECT_SEND: FreeRTOS_sendto() may call the driver directly. */
+	#endif /* ipconfigUDP_DIRECT_SEND */
+	#if( ipconfigUSE_IGMP != 0 )
+		uint32_t ulMulticastFilter;	/* A hash filter with a bit for every group in ulMulticastGroups[]. */
+		uint32_t ulMulticastGroups[ ipconfigIGMP_MAX_SOCKET_GROUPS ];	/* The groups joined, 0 for an unused entry. */
+	#endif /* ipconfigUSE_IGMP */
 } IPUDPSocket_t;
 
 /* Formally typedef'd as eSocketEvent_t. */
@@ -633,6 +741,9 @@ typedef struct xSOCKET
 	uint16_t usLocalPort;		/* Local port on this machine */
 	uint8_t ucSocketOptions;
 	uint8_t ucProtocol; /* choice of FREERTOS_IPPROTO_UDP/TCP */
+	#if( ipconfigUSE_IPv6 != 0 )
+		BaseType_t xIsIPv6;	/* pdTRUE for a socket that was created with FREERTOS_AF_INET6. */
+	#endif /* ipconfigUSE_IPv6 */
 	#if( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
 		SemaphoreHandle_t pxUserSemaphore;
 	#endif /* ipconfigSOCKET_HAS_USER_SEMAPHORE */
@@ -648,6 +759,9 @@ typedef struct xSOCKET
 		They are maintained by the IP-task */
 		EventBits_t xSocketBits;
 	#endif /* ipconfigSUPPORT_SELECT_FUNCTION */
+	#if( ipconfigUSE_IP_STATISTICS != 0 )
+		SocketCounters_t xCounters;
+	#endif /* ipconfigUSE_IP_STATISTICS */
 	/* TCP/UDP specific fields: */
 	/* Before accessing any member of this structure, it should be confirmed */
 	/* that the protocol corresponds with the type of structure */
@@ -664,6 +778,12 @@ typedef struct xSOCKET
 	} u;
 } FreeRTOS_Socket_t;
 
+#if( ipconfigUSE_IPv6 != 0 )
+	#define socketIS_IPv6( pxSocket )	( ( pxSocket )->xIsIPv6 != pdFALSE )
+#else
+	#define socketIS_IPv6( pxSocket )	( pdFALSE )
+#endif
+
 #if( ipconfigUSE_TCP == 1 )
 	/*
 	 * Lookup a TCP socket, using a multiple matching: both port numbers and
@@ -671,6 +791,13 @@ typedef struct xSOCKET
 	 */
 	FreeRTOS_Socket_t *pxTCPSocketLookup( uint32_t ulLocalIP, UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort );
 
+	#if( ipconfigUSE_IPv6 != 0 )
+		/*
+		 * The same as above, for IPv6 sockets.
+		 */
+		FreeRTOS_Socket_t *pxTCPSocketLookup_IPv6( UBaseType_t uxLocalPort, const IPv6_Address_t *pxRemoteAddress, UBaseType_t uxRemotePort );
+	#endif
+
 #endif /* ipconfigUSE_TCP */
 
 /*
@@ -683,6 +810,30 @@ FreeRTOS_Socket_t *pxUDPSocketLookup( UBaseType_t uxLocalPort );
  */
 void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer );
 
+#if( ipconfigUDP_DIRECT_SEND != 0 )
+	/*
+	 * Called by FreeRTOS_sendto() to send a UDP packet from the calling task.
+	 * Returns pdFAIL, without touching the buffer, if the destination MAC
+	 * address is not in the ARP cache.  The packet must then be passed to the
+	 * IP-task.
+	 */
+	BaseType_t xSendUDPPacketDirect( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+	/*
+	 * Called by a network driver, normally from xNetworkInterfaceInitialise(),
+	 * with pdTRUE when its xNetworkInterfaceOutput() may be called by several
+	 * tasks at the same time.  Until then FREERTOS_SO_UDP_DIRECT_SEND is
+	 * refused and all packets are sent by the IP-task.
+	 */
+	void vUDPDirectSendSetDriverSupport( BaseType_t xSupported );
+
+	/*
+	 * Returns pdTRUE when the network driver declared that it supports
+	 * FREERTOS_SO_UDP_DIRECT_SEND.
+	 */
+	BaseType_t xUDPDirectSendIsSupported( void );
+#endif /* ipconfigUDP_DIRECT_SEND */
+
 /*
  * Calculate the upper-layer checksum
  * Works both for UDP, ICMP and TCP packages
@@ -765,6 +916,11 @@ BaseType_t xSendEventToIPTask( eIPEvent_t eEvent );
  */
 BaseType_t xSendEventStructToIPTask( const IPStackEvent_t *pxEvent, TickType_t uxTimeout );
 
+/*
+ * The same as xSendEventStructToIPTask(), to be called from an ISR.
+ */
+BaseType_t xSendEventStructToIPTaskFromISR( const IPStackEvent_t *pxEvent, BaseType_t *pxHigherPriorityTaskWoken );
+
 /*
  * Returns a pointer to the original NetworkBuffer from a pointer to a UDP
  * payload buffer.
@@ -788,6 +944,28 @@ NetworkBufferDescriptor_t *pxUDPPayloadBuffer_to_NetworkBuffer( const void * pvB
 	void vTCPStateChange( FreeRTOS_Socket_t *pxSocket, enum eTCP_STATE eTCPState );
 #endif /* ipconfigUSE_TCP */
 
+/*
+ * Internal: only TCP sockets with a running time-out or with pending events
+ * are visited by xTCPTimerCheck().  Called by the IP-task when it gives a
+ * socket a new time-out.
+ */
+#if( ipconfigUSE_TCP == 1 )
+	void vTCPTimerAdd( FreeRTOS_Socket_t *pxSocket );
+#endif /* ipconfigUSE_TCP */
+
+#if( ipconfigUSE_TCP == 1 ) && ( ( ipconfigTCP_KEEP_ALIVE == 1 ) || ( ipconfigTCP_HANG_PROTECTION == 1 ) )
+	/*
+	 * Internal: the keep-alive messages and the anti-hang protection are
+	 * driven by a timer wheel, so that idle sockets do not have to be
+	 * visited periodically.  vTCPAliveTimerCheck() is called by the IP-task
+	 * every time the TCP timer expires, and only looks at the sockets whose
+	 * deadline has passed.
+	 */
+	void vTCPAliveTimerInit( void );
+	void vTCPAliveTimerCheck( void );
+	void vTCPAliveTimerRemove( FreeRTOS_Socket_t *pxSocket );
+#endif
+
 /* Returns pdTRUE is this function is called from the IP-task */
 BaseType_t xIsCallingFromIPTask( void );
 
@@ -815,6 +993,38 @@ void vIPReloadDHCPTimer( uint32_t ulLeaseTime );
 	void vIPReloadDNSTimer( uint32_t ulCheckTime );
 	void vIPSetDnsTimerEnableState( BaseType_t xEnableState );
 #endif
+#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+	void vIPSetReassemblyTimerEnableState( BaseType_t xEnableState );
+#endif
+#if( ipconfigUSE_IGMP != 0 )
+	void vIPSetIGMPTimerEnableState( BaseType_t xEnableState );
+
+	/* Collect the distinct multicast groups joined by the bound UDP sockets.
+	Returns the number of groups written to 'pulGroups'. */
+	UBaseType_t uxSocketGetMulticastGroups( uint32_t *pulGroups, UBaseType_t uxMaxGroups );
+#endif
+
+#if( ipconfigUSE_IPv6 != 0 )
+	void vIPSetIPv6TimerEnableState( BaseType_t xEnableState );
+#endif
+
+#if( ipconfigUSE_LOOPBACK != 0 )
+	/* The loopback network 127.0.0.0/8, in network byte order. */
+	#define ipLOOPBACK_ADDRESS		FreeRTOS_htonl( 0x7F000000UL )
+	#define ipLOOPBACK_NETMASK		FreeRTOS_htonl( 0xFF000000UL )
+	#define ipIS_LOOPBACK_NETWORK( ulIPAddress )	( ( ( ulIPAddress ) & ipLOOPBACK_NETMASK ) == ipLOOPBACK_ADDRESS )
+
+	/* Returns pdTRUE if the address (network order) is in 127.0.0.0/8 or is
+	the IP address of this node. */
+	BaseType_t xIsLoopbackAddress( uint32_t ulIPAddress );
+
+	/* To be called instead of xNetworkInterfaceOutput().  If the packet is
+	addressed to this node, it is passed back to the IP-task and pdTRUE is
+	returned.  If 'xReleaseAfterSend' is pdFALSE, the caller keeps its buffer and
+	a duplicate is passed.  Otherwise pdFALSE is returned and the packet must be
+	sent as usual. */
+	BaseType_t xLoopbackOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t xReleaseAfterSend );
+#endif
 
 /* Send the network-up event and start the ARP timer. */
 void vIPNetworkUpCalls( void );
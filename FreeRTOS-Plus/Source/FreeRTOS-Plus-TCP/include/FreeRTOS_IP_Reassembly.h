@@ -0,0 +1,104 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_IP_REASSEMBLY_H
+#define FREERTOS_IP_REASSEMBLY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Application level configuration options. */
+#include "FreeRTOSIPConfig.h"
+#include "FreeRTOSIPConfigDefaults.h"
+#include "IPTraceMacroDefaults.h"
+
+#if( ipconfigUSE_IP_REASSEMBLY != 0 )
+
+/* The bits of the IPv4 field 'usFragmentOffset', after conversion to host
+order: the "more fragments" flag and the offset in units of 8 bytes. */
+#define ipREASSEMBLY_MORE_FRAGMENTS		( ( uint16_t ) 0x2000U )
+#define ipREASSEMBLY_OFFSET_MASK		( ( uint16_t ) 0x1FFFU )
+
+/* Evaluates to non-zero when the IP header belongs to a fragment: either the
+offset is non-zero or more fragments will follow. */
+#define ipREASSEMBLY_IS_FRAGMENT( usFragmentOffset ) \
+	( ( FreeRTOS_ntohs( usFragmentOffset ) & ( ipREASSEMBLY_MORE_FRAGMENTS | ipREASSEMBLY_OFFSET_MASK ) ) != 0U )
+
+/* How often the IP-task checks for incomplete datagrams that have expired. */
+#define ipREASSEMBLY_TIMER_PERIOD_MS	( 500U )
+
+/*
+ * Called by the IP-task for every received IPv4 fragment that is addressed
+ * to this node.  'uxHeaderLength' is the length of the IP header, including
+ * options.  The fragment is stored and eFrameConsumed is returned.  When it
+ * completes a datagram, the datagram is passed to the UDP layer.  Fragments
+ * that can not be used are not stored, and eReleaseBuffer is returned.
+ */
+eFrameProcessingResult_t eIPReassemblyAddFragment( NetworkBufferDescriptor_t * const pxNetworkBuffer, UBaseType_t uxHeaderLength );
+
+/*
+ * Called by the IP-task from its reassembly timer: drop the incomplete
+ * datagrams that are older than ipconfigIP_REASSEMBLY_TIMEOUT_MS.
+ */
+void vIPReassemblyAgeDatagrams( void );
+
+/*
+ * A reassembled datagram that does not fit in a single network buffer is
+ * queued to its socket as a chain: the first buffer holds the Ethernet, IP and
+ * UDP headers, and 'pxNextBuffer' links the buffers of the next fragments.
+ * The following functions also accept a normal, unchained, UDP packet.
+ *
+ * uxIPReassemblyPayloadLength() returns the number of UDP payload bytes.
+ */
+size_t uxIPReassemblyPayloadLength( const NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+/*
+ * Copy at most 'uxMaxLength' bytes of UDP payload to 'pucTarget'.  Returns the
+ * number of bytes copied.
+ */
+size_t uxIPReassemblyCopyPayload( const NetworkBufferDescriptor_t *pxNetworkBuffer, uint8_t *pucTarget, size_t uxMaxLength );
+
+/*
+ * Release all network buffers of a datagram.
+ */
+void vIPReassemblyReleaseDatagram( NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+/*
+ * Copy a chained datagram into a single network buffer and release the chain.
+ * Returns the new network buffer, or 'pxNetworkBuffer' itself when it is not a
+ * chain, when no network buffer is available, or when the network buffers have
+ * a fixed size (BufferAllocation_1.c) and the datagram is longer than
+ * ipconfigNETWORK_MTU.
+ */
+NetworkBufferDescriptor_t *pxIPReassemblyFlattenDatagram( NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+#endif /* ipconfigUSE_IP_REASSEMBLY */
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* FREERTOS_IP_REASSEMBLY_H */
@@ -0,0 +1,144 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_IP_STATS_H
+#define FREERTOS_IP_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Application level configuration options. */
+#include "FreeRTOSIPConfig.h"
+#include "FreeRTOSIPConfigDefaults.h"
+#include "FreeRTOS_Sockets.h"
+
+/* Counters that are kept for every socket.  They are only written by the
+task that owns the event: the IP-task for all received packets and for TCP
+transmissions, the sending task for UDP transmissions. */
+typedef struct xSOCKET_COUNTERS
+{
+	uint32_t ulRxPackets;		/* UDP datagrams or TCP segments received. */
+	uint32_t ulRxBytes;			/* Payload bytes received. */
+	uint32_t ulRxDropped;		/* Received packets that could not be stored. */
+	uint32_t ulTxPackets;		/* UDP datagrams or TCP segments sent. */
+	uint32_t ulTxBytes;			/* Payload bytes sent, TCP retransmissions included. */
+} SocketCounters_t;
+
+/* A snapshot of a single socket, as returned by FreeRTOS_GetSocketStats(). */
+typedef struct xSOCKET_STATS
+{
+	uint8_t ucProtocol;			/* FREERTOS_IPPROTO_UDP or FREERTOS_IPPROTO_TCP. */
+	uint8_t ucTCPState;			/* eIPTCPState_t, TCP only. */
+	uint16_t usLocalPort;		/* Host-endian. */
+	uint16_t usRemotePort;		/* Host-endian, TCP only. */
+	uint32_t ulRemoteIP;		/* Host-endian, TCP only, 0 for an IPv6 peer. */
+	uint32_t ulSRTT;			/* Smoothed round-trip time in ms, TCP only. */
+	uint32_t ulRetransmits;		/* Segments sent more than once, TCP only. */
+	uint32_t ulRxWindow;		/* Size of our reception window, TCP only. */
+	uint32_t ulTxWindow;		/* Window size as advertised by the peer, TCP only. */
+	size_t uxRxWaiting;			/* Bytes (TCP) or datagrams (UDP) waiting to be read. */
+	size_t uxTxWaiting;			/* Bytes waiting to be sent, TCP only. */
+	SocketCounters_t xCounters;
+} SocketStats_t;
+
+/* The stack wide counters, as returned by FreeRTOS_GetIPStackStats(). */
+typedef struct xIP_STACK_STATS
+{
+	uint32_t ulRxFrames;				/* Ethernet frames processed by the stack. */
+	uint32_t ulRxFramesDropped;			/* Frames that were released without being used. */
+	uint32_t ulIPChecksumErrors;		/* IPv4 header checksum failures. */
+	uint32_t ulProtocolChecksumErrors;	/* TCP, UDP and ICMP checksum failures. */
+	uint32_t ulARPCacheMisses;			/* Packets held back or dropped to resolve an address. */
+	uint32_t ulEventQueueOverflows;		/* Events or packets that could not be passed to the IP-task. */
+	uint32_t ulNetworkBufferExhausted;	/* Failed attempts to obtain a network buffer. */
+	uint32_t ulUDPNoSocket;				/* UDP packets for a port without a socket. */
+	uint32_t ulTCPNoSocket;				/* TCP packets without an active socket. */
+	uint32_t ulTCPKeepAliveProbes;		/* TCP keep-alive messages sent. */
+	uint32_t ulTCPConnectionsReaped;	/* TCP connections closed by keep-alive or anti-hang protection. */
+	uint32_t ulDNSQueries;				/* DNS queries started by the asynchronous resolver. */
+	uint32_t ulDNSQueriesCoalesced;		/* Look-ups that joined a query that was already outstanding. */
+	uint32_t ulDNSRetransmissions;		/* DNS queries that were sent again. */
+	uint32_t ulDHCPTimeToAddress;		/* Milliseconds from the start of DHCP until the last address was bound. */
+	uint32_t ulDHCPInitReboots;			/* Stored leases that were confirmed in the INIT-REBOOT state. */
+	uint32_t ulDHCPRapidCommits;		/* Addresses that were bound with a Rapid Commit ACK. */
+	size_t uxNetworkBuffersFree;		/* Filled in by FreeRTOS_GetIPStackStats(). */
+	size_t uxNetworkBuffersMinimum;		/* Filled in by FreeRTOS_GetIPStackStats(). */
+} IPStackStats_t;
+
+#if( ipconfigUSE_IP_STATISTICS != 0 )
+
+	extern IPStackStats_t xIPStackStats;
+
+	/* For counters that are only written by the IP-task. */
+	#define ipSTATS_INCREMENT( xField )			( ( xIPStackStats.xField )++ )
+
+	/* For values that are only written by the IP-task. */
+	#define ipSTATS_SET( xField, xValue )		( ( xIPStackStats.xField ) = ( uint32_t ) ( xValue ) )
+
+	/* For counters that may be written by any task.  These all count failures,
+	so the critical section will not be entered on the normal paths. */
+	#define ipSTATS_INCREMENT_SHARED( xField )		\
+		do {										\
+			taskENTER_CRITICAL();					\
+			( xIPStackStats.xField )++;				\
+			taskEXIT_CRITICAL();					\
+		} while( ipFALSE_BOOL )
+
+	#define ipSOCKET_STATS_ADD( pxSocket, xField, xValue )	\
+		( ( pxSocket )->xCounters.xField += ( uint32_t ) ( xValue ) )
+
+	/*
+	 * Copy the stack wide counters to pxStats.  The copy is made within a
+	 * critical section, so all fields belong to the same moment.
+	 */
+	void FreeRTOS_GetIPStackStats( IPStackStats_t *pxStats );
+
+	/*
+	 * Copy the counters and the connection state of a single socket.  Returns
+	 * 0 on success, or -pdFREERTOS_ERRNO_EINVAL for an invalid socket.
+	 */
+	BaseType_t FreeRTOS_GetSocketStats( Socket_t xSocket, SocketStats_t *pxStats );
+
+	/*
+	 * Copy the statistics of all bound sockets, TCP sockets first, into an
+	 * array of uxMaxCount elements.  Returns the number of entries written.
+	 */
+	UBaseType_t FreeRTOS_GetAllSocketStats( SocketStats_t *pxStats, UBaseType_t uxMaxCount );
+
+#else
+
+	#define ipSTATS_INCREMENT( xField )						do{} while( ipFALSE_BOOL )
+	#define ipSTATS_SET( xField, xValue )					do{} while( ipFALSE_BOOL )
+	#define ipSTATS_INCREMENT_SHARED( xField )				do{} while( ipFALSE_BOOL )
+	#define ipSOCKET_STATS_ADD( pxSocket, xField, xValue )	do{} while( ipFALSE_BOOL )
+
+#endif /* ipconfigUSE_IP_STATISTICS */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* FREERTOS_IP_STATS_H */
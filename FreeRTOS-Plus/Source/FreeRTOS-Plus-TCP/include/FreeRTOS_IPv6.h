@@ -0,0 +1,287 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_IPv6_H
+#define FREERTOS_IPv6_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Application level configuration options. */
+#include "FreeRTOSIPConfig.h"
+#include "FreeRTOSIPConfigDefaults.h"
+#include "IPTraceMacroDefaults.h"
+
+#if( ipconfigUSE_IPv6 != 0 )
+
+/* The value of 'ucNextHeader' for an ICMPv6 message. */
+#define ipPROTOCOL_ICMP_IPv6			( 58U )
+
+/* ICMPv6 message types. */
+#define ipICMPv6_ECHO_REQUEST			( ( uint8_t ) 128U )
+#define ipICMPv6_ECHO_REPLY				( ( uint8_t ) 129U )
+#define ipICMPv6_ROUTER_SOLICITATION	( ( uint8_t ) 133U )
+#define ipICMPv6_ROUTER_ADVERTISEMENT	( ( uint8_t ) 134U )
+#define ipICMPv6_NEIGHBOUR_SOLICITATION	( ( uint8_t ) 135U )
+#define ipICMPv6_NEIGHBOUR_ADVERTISEMENT ( ( uint8_t ) 136U )
+
+/* Neighbour discovery option types. */
+#define ipND_OPTION_SOURCE_LINK_LAYER	( ( uint8_t ) 1U )
+#define ipND_OPTION_TARGET_LINK_LAYER	( ( uint8_t ) 2U )
+#define ipND_OPTION_PREFIX_INFO			( ( uint8_t ) 3U )
+
+/* Flags in the 'ulFlags' field of a neighbour advertisement, in host order. */
+#define ipND_FLAG_ROUTER				( 0x80000000UL )
+#define ipND_FLAG_SOLICITED				( 0x40000000UL )
+#define ipND_FLAG_OVERRIDE				( 0x20000000UL )
+
+/* The "autonomous address-configuration" flag of a prefix option. */
+#define ipND_PREFIX_FLAG_AUTONOMOUS		( ( uint8_t ) 0x40U )
+
+/* The IPv6 timer handles router solicitations and the lifetimes of the
+addresses and the router. */
+#define ipIPv6_TIMER_PERIOD_MS			( 1000U )
+
+/* A neighbour solicitation or advertisement, with a link-layer address option. */
+#include "pack_struct_start.h"
+struct xICMP_NEIGHBOUR_IPv6
+{
+	uint8_t ucTypeOfMessage;		/*  0 +  1 =  1 */
+	uint8_t ucTypeOfService;		/*  1 +  1 =  2 */
+	uint16_t usChecksum;			/*  2 +  2 =  4 */
+	uint32_t ulFlags;				/*  4 +  4 =  8 */
+	IPv6_Address_t xTargetAddress;	/*  8 + 16 = 24 */
+	uint8_t ucOptionType;			/* 24 +  1 = 25 */
+	uint8_t ucOptionLength;			/* 25 +  1 = 26 */
+	uint8_t ucOptionBytes[ ipMAC_ADDRESS_LENGTH_BYTES ];	/* 26 +  6 = 32 */
+}
+#include "pack_struct_end.h"
+typedef struct xICMP_NEIGHBOUR_IPv6 ICMPNeighbour_IPv6_t;
+
+/* A router solicitation, with a source link-layer address option. */
+#include "pack_struct_start.h"
+struct xICMP_ROUTER_SOLICITATION_IPv6
+{
+	uint8_t ucTypeOfMessage;		/*  0 +  1 =  1 */
+	uint8_t ucTypeOfService;		/*  1 +  1 =  2 */
+	uint16_t usChecksum;			/*  2 +  2 =  4 */
+	uint32_t ulReserved;			/*  4 +  4 =  8 */
+	uint8_t ucOptionType;			/*  8 +  1 =  9 */
+	uint8_t ucOptionLength;			/*  9 +  1 = 10 */
+	uint8_t ucOptionBytes[ ipMAC_ADDRESS_LENGTH_BYTES ];	/* 10 +  6 = 16 */
+}
+#include "pack_struct_end.h"
+typedef struct xICMP_ROUTER_SOLICITATION_IPv6 ICMPRouterSolicitation_IPv6_t;
+
+/* The fixed part of a router advertisement, the options follow. */
+#include "pack_struct_start.h"
+struct xICMP_ROUTER_ADVERTISEMENT_IPv6
+{
+	uint8_t ucTypeOfMessage;		/*  0 +  1 =  1 */
+	uint8_t ucTypeOfService;		/*  1 +  1 =  2 */
+	uint16_t usChecksum;			/*  2 +  2 =  4 */
+	uint8_t ucHopLimit;				/*  4 +  1 =  5 */
+	uint8_t ucFlags;				/*  5 +  1 =  6 */
+	uint16_t usLifetime;			/*  6 +  2 =  8 */
+	uint32_t ulReachableTime;		/*  8 +  4 = 12 */
+	uint32_t ulRetransmitTime;		/* 12 +  4 = 16 */
+}
+#include "pack_struct_end.h"
+typedef struct xICMP_ROUTER_ADVERTISEMENT_IPv6 ICMPRouterAdvertisement_IPv6_t;
+
+/* The prefix information option of a router advertisement. */
+#include "pack_struct_start.h"
+struct xND_PREFIX_OPTION_IPv6
+{
+	uint8_t ucType;					/*  0 +  1 =  1 */
+	uint8_t ucLength;				/*  1 +  1 =  2 */
+	uint8_t ucPrefixLength;			/*  2 +  1 =  3 */
+	uint8_t ucFlags;				/*  3 +  1 =  4 */
+	uint32_t ulValidLifeTime;		/*  4 +  4 =  8 */
+	uint32_t ulPreferredLifeTime;	/*  8 +  4 = 12 */
+	uint32_t ulReserved;			/* 12 +  4 = 16 */
+	IPv6_Address_t xPrefix;			/* 16 + 16 = 32 */
+}
+#include "pack_struct_end.h"
+typedef struct xND_PREFIX_OPTION_IPv6 NDPrefixOption_IPv6_t;
+
+/* An entry of the neighbour cache. */
+typedef struct xND_CACHE_TABLE_ROW
+{
+	IPv6_Address_t xIPAddress;	/* The IPv6 address of the neighbour. */
+	MACAddress_t xMACAddress;	/* Its MAC address. */
+	uint8_t ucAge;				/* Decremented by the ARP timer, the entry is removed when it reaches zero. */
+	uint8_t ucValid;			/* pdTRUE: xMACAddress is valid, pdFALSE: a solicitation was sent. */
+} NDCacheRow_t;
+
+/*
+ * Public API: set a static global IPv6 address, its prefix length, and a
+ * default router.  'pxGateway' may be NULL, a router will then be learned from
+ * router advertisements.  The link-local address is always derived from the
+ * MAC address.
+ */
+void FreeRTOS_SetIPv6Address( const IPv6_Address_t *pxAddress, UBaseType_t uxPrefixLength, const IPv6_Address_t *pxGateway );
+
+/*
+ * Public API: get the link-local and the global address of this node.  Either
+ * pointer may be NULL.  Returns pdTRUE if a global address is configured.
+ */
+BaseType_t FreeRTOS_GetIPv6Address( IPv6_Address_t *pxLinkLocal, IPv6_Address_t *pxGlobal );
+
+/*
+ * Returns pdTRUE if a packet for 'pxAddress' must be accepted: it is one of
+ * the addresses of this node, the all-nodes group or one of its
+ * solicited-node groups.
+ */
+BaseType_t xIPv6IsForThisNode( const IPv6_Address_t *pxAddress );
+
+/*
+ * Write the source address to be used for packets to 'pxDestination': the
+ * link-local address for link-local and multicast destinations, otherwise the
+ * global address when there is one.  May be called from any task.
+ */
+void vIPv6SelectSourceAddress( IPv6_Address_t *pxSource, const IPv6_Address_t *pxDestination );
+
+/*
+ * Returns pdTRUE if 'pxAddress' can be reached without a router: it is a
+ * link-local or multicast address, or it shares the prefix of the global
+ * address.
+ */
+BaseType_t xIPv6IsOnLink( const IPv6_Address_t *pxAddress );
+
+/*
+ * Replace an off-link address with the address of the default router.
+ * Returns pdFAIL if the address is off-link and there is no router.
+ */
+BaseType_t xIPv6GetNextHop( IPv6_Address_t *pxAddress );
+
+/*
+ * The hop limit for outgoing packets, ipconfigIPv6_HOP_LIMIT unless a router
+ * advertised another value.
+ */
+uint8_t ucIPv6GetHopLimit( void );
+
+/*
+ * Calculate the checksum of an ICMPv6, UDP or TCP packet, which includes the
+ * IPv6 pseudo header.  For outgoing packets, the checksum field is filled in.
+ * For incoming packets, 0xffff is returned when the checksum is right.
+ * Extension headers are not supported.
+ */
+uint16_t usGenerateProtocolChecksumIPv6( uint8_t * const pucEthernetBuffer, size_t uxBufferLength, BaseType_t xOutgoingPacket );
+
+/*
+ * Called by the IP-task for every ICMPv6 message that is addressed to this
+ * node.  Returns eReturnEthernetFrame when the buffer was turned into a reply.
+ */
+eFrameProcessingResult_t eProcessICMPv6Packet( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+/*
+ * Fill in the Ethernet, IPv6 and UDP headers of a packet that was built by
+ * FreeRTOS_sendto(), of which 'xDataLength' already holds the total length.
+ * The destination MAC address is filled in later, by vIPv6SendPacket().
+ */
+void vIPv6PrepareUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer, const IPv6_Address_t *pxDestination, uint16_t usDestinationPort, uint16_t usSourcePort, BaseType_t xCalculateChecksum );
+
+/*
+ * Called by the IP-task: look up the MAC address of the destination of a
+ * complete IPv6 packet, and pass the packet to the driver.  When the MAC
+ * address is not known yet, a neighbour solicitation is sent and the packet
+ * is dropped, as is done for IPv4 packets.  The buffer is always released.
+ */
+void vIPv6SendPacket( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+/*
+ * Called by the IP-task when the network goes up: the link-local address is
+ * formed and router solicitations are sent.
+ */
+void vIPv6NetworkUp( void );
+
+/*
+ * Called by the IP-task from its IPv6 timer, every ipIPv6_TIMER_PERIOD_MS.
+ */
+void vIPv6CheckTimers( void );
+
+/*
+ * Neighbour cache, see FreeRTOS_ND.c.
+ *
+ * Look up the MAC address for 'pxAddress'.  Like eARPGetCacheEntry(), an
+ * off-link address is replaced with the address of the router.  Multicast
+ * addresses are mapped to a 33:33:xx:xx:xx:xx MAC address.
+ */
+eARPLookupResult_t eNDGetCacheEntry( IPv6_Address_t *pxAddress, MACAddress_t * const pxMACAddress );
+
+/*
+ * Add or refresh an entry in the neighbour cache.
+ */
+void vNDRefreshCacheEntry( const MACAddress_t * pxMACAddress, const IPv6_Address_t *pxAddress );
+
+/*
+ * Called by the IP-task together with vARPAgeCache(): age the entries of the
+ * neighbour cache, and send solicitations for the entries that are about to
+ * expire.
+ */
+void vNDAgeCache( void );
+
+/*
+ * Remove all entries from the neighbour cache.
+ */
+void vNDClearCache( void );
+
+/*
+ * Send a neighbour solicitation for 'pxTarget'.  When 'xForDAD' is pdTRUE, it
+ * is a duplicate address detection probe, sent from the unspecified address.
+ */
+void vNDSendNeighbourSolicitation( const IPv6_Address_t *pxTarget, BaseType_t xForDAD );
+
+/*
+ * Send a neighbour advertisement for our address 'pxTarget' to 'pxDestination'.
+ * When 'pxDestinationMAC' is NULL, the MAC address is derived from the
+ * (multicast) destination.  'ulFlags' holds the ipND_FLAG_ bits.
+ */
+void vNDSendNeighbourAdvertisement( const IPv6_Address_t *pxTarget, const IPv6_Address_t *pxDestination, const MACAddress_t *pxDestinationMAC, uint32_t ulFlags );
+
+/*
+ * Send a router solicitation to the all-routers group.
+ */
+void vNDSendRouterSolicitation( void );
+
+/*
+ * Returns pdTRUE if the address is a multicast address, ff00::/8.
+ */
+#define xIPv6IsMulticast( pxAddress )	( ( pxAddress )->ucBytes[ 0 ] == 0xffU )
+
+/*
+ * Returns pdTRUE if the address is a link-local address, fe80::/10.
+ */
+#define xIPv6IsLinkLocal( pxAddress )	( ( ( pxAddress )->ucBytes[ 0 ] == 0xfeU ) && ( ( ( pxAddress )->ucBytes[ 1 ] & 0xc0U ) == 0x80U ) )
+
+#endif /* ipconfigUSE_IPv6 */
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* FREERTOS_IPv6_H */
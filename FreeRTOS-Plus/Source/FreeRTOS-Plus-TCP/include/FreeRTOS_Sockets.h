@@ -132,6 +132,22 @@ FreeRTOS_setsockopt(). */
 
 #define FREERTOS_SO_SET_LOW_HIGH_WATER	( 18 )
 
+#if( ipconfigUDP_DIRECT_SEND != 0 )
+	#define FREERTOS_SO_UDP_DIRECT_SEND	( 19 )		/* Let FreeRTOS_sendto() pass packets to the driver directly, when the destination MAC address is known (UDP only) */
+#endif
+
+#if( ipconfigUSE_IGMP != 0 )
+	#define FREERTOS_SO_IP_ADD_MEMBERSHIP	( 20 )		/* Join an IPv4 multicast group, the option value is a struct freertos_ip_mreq (UDP only) */
+	#define FREERTOS_SO_IP_DROP_MEMBERSHIP	( 21 )		/* Leave an IPv4 multicast group (UDP only) */
+#endif
+
+#if( ipconfigTCP_KEEP_ALIVE == 1 )
+	#define FREERTOS_SO_KEEPALIVE			( 22 )		/* Enable or disable the sending of keep-alive messages, the option value is a BaseType_t (TCP only) */
+	#define FREERTOS_SO_TCP_KEEPIDLE		( 23 )		/* Seconds of silence before the first keep-alive message, the option value is a BaseType_t (TCP only) */
+	#define FREERTOS_SO_TCP_KEEPINTVL		( 24 )		/* Seconds between unanswered keep-alive messages, the option value is a BaseType_t (TCP only) */
+	#define FREERTOS_SO_TCP_KEEPCNT			( 25 )		/* Number of unanswered keep-alive messages before the connection is closed, the option value is a BaseType_t (TCP only) */
+#endif
+
 #define FREERTOS_NOT_LAST_IN_FRAGMENTED_PACKET 	( 0x80 )  /* For internal use only, but also part of an 8-bit bitwise value. */
 #define FREERTOS_FRAGMENTED_PACKET				( 0x40 )  /* For internal use only, but also part of an 8-bit bitwise value. */
 
@@ -180,6 +196,32 @@ struct freertos_sockaddr
 	uint32_t sin_addr;
 };
 
+#if( ipconfigUSE_IPv6 != 0 )
+	/* The address of a socket that was created with FREERTOS_AF_INET6.  A
+	pointer to it is cast to 'struct freertos_sockaddr *' when it is passed to
+	the API functions, as in the Berkeley API.  'sin_port' is in network byte
+	order, 'sin_flowinfo' is not used. */
+	struct freertos_sockaddr6
+	{
+		uint8_t sin_len;		/* length of this structure. */
+		uint8_t sin_family;		/* FREERTOS_AF_INET6. */
+		uint16_t sin_port;
+		uint32_t sin_flowinfo;
+		IPv6_Address_t sin_addr6;
+	};
+#endif /* ipconfigUSE_IPv6 */
+
+#if( ipconfigUSE_IGMP != 0 )
+	/* The option value of FREERTOS_SO_IP_ADD_MEMBERSHIP and
+	FREERTOS_SO_IP_DROP_MEMBERSHIP.  The addresses are in network byte order.
+	There is only one interface, 'imr_interface' is not used. */
+	struct freertos_ip_mreq
+	{
+		uint32_t imr_multiaddr;
+		uint32_t imr_interface;
+	};
+#endif
+
 extern const char *FreeRTOS_inet_ntoa( uint32_t ulIPAddress, char *pcBuffer );
 
 #if ipconfigBYTE_ORDER == pdFREERTOS_LITTLE_ENDIAN
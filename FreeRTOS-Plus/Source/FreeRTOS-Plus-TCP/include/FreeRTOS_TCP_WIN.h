@@ -116,6 +116,9 @@ typedef struct xTCP_WINDOW
 	uint32_t ulUserDataLength;			/* Number of bytes in Rx buffer which may be passed to the user, after having received a 'missing packet' */
 	uint32_t ulNextTxSequenceNumber;	/* The sequence number given to the next byte to be added for transmission */
 	int32_t lSRTT;						/* Smoothed Round Trip Time, it may increment quickly and it decrements slower */
+#if( ipconfigUSE_IP_STATISTICS != 0 )
+	uint32_t ulRetransmitCount;			/* Number of segments that were sent more than once */
+#endif
 	uint8_t ucOptionLength;				/* Number of valid bytes in ulOptionsData[] */
 #if( ipconfigUSE_TCP_WIN == 1 )
 	List_t xPriorityQueue;				/* Priority queue: segments which must be sent immediately */
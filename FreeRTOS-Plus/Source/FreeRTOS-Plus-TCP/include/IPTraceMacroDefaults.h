@@ -216,6 +216,10 @@ http://www.FreeRTOS.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Trace.html */
 	#define ipconfigUSE_DUMP_PACKETS	0
 #endif
 
+#ifndef ipconfigUSE_CAPTURE_RING
+	#define ipconfigUSE_CAPTURE_RING	0
+#endif
+
 #if( ipconfigUSE_DUMP_PACKETS == 0 )
 
 	/* See tools/tcp_dump_packets.c */
@@ -224,10 +228,72 @@ http://www.FreeRTOS.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Trace.html */
 		#define iptraceDUMP_INIT( pcFileName, pxEntries )
 	#endif
 
+#endif	/* ( ipconfigUSE_DUMP_PACKETS != 0 ) */
+
+#if( ipconfigUSE_DUMP_PACKETS == 0 ) && ( ipconfigUSE_CAPTURE_RING == 0 )
+
 	#ifndef iptraceDUMP_PACKET
 		#define iptraceDUMP_PACKET( pucBuffer, uxLength, xIncoming )
 	#endif
 
-#endif	/* ( ipconfigUSE_DUMP_PACKETS != 0 ) */
+#endif
+
+#if( ipconfigUSE_CAPTURE_RING != 0 )
+
+	/* See tools/tcp_capture_ring.c */
+
+	/* The number of frames kept in the ring, must be a power of 2. */
+	#ifndef ipconfigCAPTURE_RING_SLOTS
+		#define ipconfigCAPTURE_RING_SLOTS		64
+	#endif
+
+	/* The maximum number of bytes stored of each frame.  128 bytes covers
+	the headers of all protocols that the stack handles. */
+	#ifndef ipconfigCAPTURE_SNAPLEN
+		#define ipconfigCAPTURE_SNAPLEN			128
+	#endif
+
+	/* The time stamp of the captured frames, in micro-seconds. */
+	#ifndef ipconfigCAPTURE_TIME_US
+		#define ipconfigCAPTURE_TIME_US()		( ( uint64_t ) xTaskGetTickCount() * ( uint64_t ) portTICK_PERIOD_MS * 1000ULL )
+	#endif
+
+#endif	/* ( ipconfigUSE_CAPTURE_RING != 0 ) */
+
+#ifndef ipconfigUSE_LATENCY_STATS
+	#define ipconfigUSE_LATENCY_STATS	0
+#endif
+
+#if( ipconfigUSE_LATENCY_STATS == 0 )
+
+	/* See tools/tcp_latency_stats.c */
+
+	#ifndef iptraceRX_HANDOFF_TO_IP_TASK
+		#define iptraceRX_HANDOFF_TO_IP_TASK( pxBuffer )
+	#endif
+
+	#ifndef iptraceRX_PROCESSING_STARTED
+		#define iptraceRX_PROCESSING_STARTED( pxBuffer )
+	#endif
+
+	#ifndef iptraceRX_DELIVERED_TO_SOCKET
+		#define iptraceRX_DELIVERED_TO_SOCKET( pxBuffer )
+	#endif
+
+	#ifndef iptraceRX_RECEIVED_BY_APPLICATION
+		#define iptraceRX_RECEIVED_BY_APPLICATION( pxBuffer )
+	#endif
+
+#else
+
+	/* The time source of the latency histograms.  The clock tick is too coarse
+	to be useful, a free running hardware counter or a cycle counter is a
+	better choice.  Drivers may hand received packets to the IP-task from an
+	interrupt, so it must be safe to read from an ISR. */
+	#ifndef ipconfigLATENCY_TIMER_VALUE
+		#define ipconfigLATENCY_TIMER_VALUE()	( ( uint32_t ) xTaskGetTickCountFromISR() )
+	#endif
+
+#endif	/* ( ipconfigUSE_LATENCY_STATS != 0 ) */
 
 #endif /* UDP_TRACE_MACRO_DEFAULTS_H */
@@ -42,6 +42,14 @@ void vNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkB
 /* coverity[misra_c_2012_rule_8_6_violation] */
 BaseType_t xGetPhyLinkStatus( void );
 
+#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+	/* Provided by the network driver when ipconfigIGMP_DRIVER_MAC_FILTER is 1.
+	Called by the IP-task to let the EMAC accept, or no longer accept, the
+	frames sent to a multicast MAC address. */
+	void vNetworkInterfaceAddAllowedMAC( const MACAddress_t *pxMACAddress );
+	void vNetworkInterfaceRemoveAllowedMAC( const MACAddress_t *pxMACAddress );
+#endif
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
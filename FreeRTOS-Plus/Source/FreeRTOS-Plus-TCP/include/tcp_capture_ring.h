@@ -0,0 +1,127 @@
+/*
+ * tcp_capture_ring.h
+ * Always-on capture of the last Ethernet frames in a memory ring, exported
+ * as pcapng on demand, see tools/tcp_capture_ring.c
+ */
+
+#ifndef TCP_CAPTURE_RING_H
+
+#define TCP_CAPTURE_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The filters are small programs in the style of the classic BSD packet
+ * filter.  The machine has an accumulator A and an index register X, both
+ * 32-bit.  Loads are big-endian, a load outside the frame rejects the frame.
+ * Jumps are relative to the next instruction and only go forward, so every
+ * program terminates.  A program ends with captureOP_RET: a return value of 0
+ * rejects the frame, any other value is the maximum number of bytes to store.
+ *
+ * As an example, a filter that only passes IPv4 UDP frames to or from port 53:
+ *
+ *	static const CaptureInsn_t xDNSInstructions[] =
+ *	{
+ *		captureSTMT( captureOP_LD_H, 12 ),				// 0: Frame type.
+ *		captureJUMP( captureOP_JEQ, 0x0800, 0, 8 ),		// 1: IPv4, else 10.
+ *		captureSTMT( captureOP_LD_B, 23 ),				// 2: Protocol.
+ *		captureJUMP( captureOP_JEQ, 17, 0, 6 ),			// 3: UDP, else 10.
+ *		captureSTMT( captureOP_LDX_MSH, 14 ),			// 4: X = IP header length.
+ *		captureSTMT( captureOP_LD_H_IND, 14 ),			// 5: Source port.
+ *		captureJUMP( captureOP_JEQ, 53, 2, 0 ),			// 6: Port 53, else 7.
+ *		captureSTMT( captureOP_LD_H_IND, 16 ),			// 7: Destination port.
+ *		captureJUMP( captureOP_JEQ, 53, 0, 1 ),			// 8: Port 53, else 10.
+ *		captureSTMT( captureOP_RET, 0xFFFFFFFFUL ),		// 9: Pass.
+ *		captureSTMT( captureOP_RET, 0 )					// 10: Reject.
+ *	};
+ *	static const CaptureFilter_t xDNSFilter =
+ *		{ xDNSInstructions, sizeof( xDNSInstructions ) / sizeof( xDNSInstructions[ 0 ] ) };
+ *
+ *	xCaptureRingSetFilter( pdTRUE, &xDNSFilter );
+ */
+#define captureOP_LD_B			0x01U	/* A = frame[ k ] */
+#define captureOP_LD_H			0x02U	/* A = frame[ k ... k + 1 ] */
+#define captureOP_LD_W			0x03U	/* A = frame[ k ... k + 3 ] */
+#define captureOP_LD_B_IND		0x04U	/* A = frame[ X + k ] */
+#define captureOP_LD_H_IND		0x05U	/* A = frame[ X + k ... X + k + 1 ] */
+#define captureOP_LD_W_IND		0x06U	/* A = frame[ X + k ... X + k + 3 ] */
+#define captureOP_LDX_MSH		0x07U	/* X = 4 * ( frame[ k ] & 0x0F ), the IPv4 header length. */
+#define captureOP_LD_LEN		0x08U	/* A = length of the frame. */
+#define captureOP_AND			0x09U	/* A = A & k */
+#define captureOP_JEQ			0x0AU	/* Jump over jt if A == k, else over jf. */
+#define captureOP_JGT			0x0BU	/* Jump over jt if A > k, else over jf. */
+#define captureOP_JGE			0x0CU	/* Jump over jt if A >= k, else over jf. */
+#define captureOP_JSET			0x0DU	/* Jump over jt if ( A & k ) != 0, else over jf. */
+#define captureOP_RET			0x0EU	/* Return k. */
+
+typedef struct xCAPTURE_INSN
+{
+	uint8_t ucOpcode;
+	uint8_t ucJumpTrue;
+	uint8_t ucJumpFalse;
+	uint32_t ulValue;
+} CaptureInsn_t;
+
+#define captureSTMT( ucOpcode, ulValue )	\
+	{ ( uint8_t ) ( ucOpcode ), 0U, 0U, ( uint32_t ) ( ulValue ) }
+
+#define captureJUMP( ucOpcode, ulValue, ucJumpTrue, ucJumpFalse )	\
+	{ ( uint8_t ) ( ucOpcode ), ( uint8_t ) ( ucJumpTrue ), ( uint8_t ) ( ucJumpFalse ), ( uint32_t ) ( ulValue ) }
+
+typedef struct xCAPTURE_FILTER
+{
+	const CaptureInsn_t *pxInstructions;
+	size_t uxCount;
+} CaptureFilter_t;
+
+/* Called for every chunk of the pcapng file that is being exported.  Returns
+pdFAIL to abort the export. */
+typedef BaseType_t ( * CaptureWriteFunction_t )( void *pvContext, const void *pvData, size_t uxLength );
+
+#if( ipconfigUSE_CAPTURE_RING != 0 )
+
+	/* Called by the network interface, through iptraceDUMP_PACKET(). */
+	void vCaptureRingPacket( const uint8_t *pucBuffer, size_t uxLength, BaseType_t xIncoming );
+
+	/*
+	 * Install a filter for the incoming ( xIncoming = pdTRUE ) or the outgoing
+	 * frames.  The filter and its instructions must remain valid until they
+	 * are replaced, so they are normally declared as 'static const'.  NULL
+	 * passes all frames.  Returns pdFAIL when the program is not valid, in
+	 * which case the old filter remains in place.
+	 */
+	BaseType_t xCaptureRingSetFilter( BaseType_t xIncoming, const CaptureFilter_t *pxFilter );
+
+	/*
+	 * Write the frames that are currently in the ring, oldest first, as a
+	 * pcapng file.  Capturing continues during the export, a frame that is
+	 * overwritten while it is being read is skipped.  Returns the number of
+	 * frames written, or -1 when pxWrite() failed.  Only one task at a time
+	 * may export.
+	 */
+	BaseType_t xCaptureRingExport( CaptureWriteFunction_t pxWrite, void *pvContext );
+
+	#if defined( __linux__ ) || defined( _WIN32 )
+		/* Export the ring to a file, with the same result as xCaptureRingExport(). */
+		BaseType_t xCaptureRingSaveFile( const char *pcFileName );
+	#endif
+
+	/* Forget all captured frames. */
+	void vCaptureRingClear( void );
+
+	#define iptraceDUMP_PACKET( pucBuffer, uxLength, xIncoming ) \
+		vCaptureRingPacket( pucBuffer, uxLength, xIncoming )
+
+#else
+
+	/* The header file 'IPTraceMacroDefaults.h' will define the default empty macro's. */
+
+#endif /* ipconfigUSE_CAPTURE_RING != 0 */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif	/* TCP_CAPTURE_RING_H */
@@ -56,8 +56,13 @@ typedef struct xDumpEntries
 		dump_packet_init( pcFileName, pxEntries )
 
 	extern void dump_packet( const uint8_t *pucBuffer, size_t uxLength, BaseType_t xIncoming );
-	#define iptraceDUMP_PACKET( pucBuffer, uxLength, xIncoming ) \
-		dump_packet( pucBuffer, uxLength, xIncoming )
+
+	/* When the capture ring is used, it will call dump_packet(), see
+	tcp_capture_ring.h. */
+	#if( ipconfigUSE_CAPTURE_RING == 0 )
+		#define iptraceDUMP_PACKET( pucBuffer, uxLength, xIncoming ) \
+			dump_packet( pucBuffer, uxLength, xIncoming )
+	#endif
 
 #endif
 
@@ -0,0 +1,76 @@
+/*
+ * tcp_latency_stats.h
+ * Histograms of the time that received packets spend in each stage of the
+ * stack, see tools/tcp_latency_stats.c
+ */
+
+#ifndef TCP_LATENCY_STATS_H
+
+#define TCP_LATENCY_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One bucket for 0, and one bucket for every power of 2 of a 32-bit value. */
+#define latencyBUCKET_COUNT		33
+
+/* The stages of which the duration is measured, in timer counts as returned
+by ipconfigLATENCY_TIMER_VALUE(). */
+typedef enum eLATENCY_STAGE
+{
+	eLatencyQueued = 0,		/* From the driver hand-off until the IP-task starts processing. */
+	eLatencyProcessing,		/* From the start of processing until the data is delivered to a socket. */
+	eLatencyWaiting,		/* From socket delivery until a UDP packet is read by the application. */
+	eLatencyTotal,			/* From the driver hand-off until a UDP packet is read by the application. */
+	eLatencyStageCount
+} eLatencyStage_t;
+
+typedef struct xLATENCY_HISTOGRAM
+{
+	uint32_t ulSamples;
+	uint32_t ulMinimum;
+	uint32_t ulMaximum;
+	uint64_t ullSum;		/* ullSum / ulSamples gives the average. */
+	/* ulBuckets[ 0 ] counts the value 0, ulBuckets[ n ] counts the values
+	from 2^(n-1) up to and including 2^n - 1. */
+	uint32_t ulBuckets[ latencyBUCKET_COUNT ];
+} LatencyHistogram_t;
+
+#if( ipconfigUSE_LATENCY_STATS != 0 )
+
+	/* Called by the stack, through the iptrace macros below. */
+	void vTCPLatencyHandoff( NetworkBufferDescriptor_t *pxBuffer );
+	void vTCPLatencyProcessing( NetworkBufferDescriptor_t *pxBuffer );
+	void vTCPLatencyDelivered( NetworkBufferDescriptor_t *pxBuffer );
+	void vTCPLatencyReceived( NetworkBufferDescriptor_t *pxBuffer );
+
+	/* Copy the histogram of a stage.  Returns pdFAIL for an invalid stage. */
+	BaseType_t xTCPLatencyGetHistogram( eLatencyStage_t eStage, LatencyHistogram_t *pxHistogram );
+
+	/* Clear all histograms. */
+	void vTCPLatencyReset( void );
+
+	#define iptraceRX_HANDOFF_TO_IP_TASK( pxBuffer ) \
+		vTCPLatencyHandoff( pxBuffer )
+
+	#define iptraceRX_PROCESSING_STARTED( pxBuffer ) \
+		vTCPLatencyProcessing( pxBuffer )
+
+	#define iptraceRX_DELIVERED_TO_SOCKET( pxBuffer ) \
+		vTCPLatencyDelivered( pxBuffer )
+
+	#define iptraceRX_RECEIVED_BY_APPLICATION( pxBuffer ) \
+		vTCPLatencyReceived( pxBuffer )
+
+#else
+
+	/* The header file 'IPTraceMacroDefaults.h' will define the default empty macro's. */
+
+#endif /* ipconfigUSE_LATENCY_STATS != 0 */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif	/* TCP_LATENCY_STATS_H */
@@ -268,13 +268,20 @@ UBaseType_t uxCount;
 
 				pxReturn->xDataLength = xRequestedSizeBytes;
 
+				#if( ipconfigUSE_LATENCY_STATS != 0 )
+				{
+					/* The buffer has not been handed to the IP-task yet. */
+					pxReturn->ulHandoffTime = 0UL;
+				}
+				#endif /* ipconfigUSE_LATENCY_STATS */
+
 				#if( ipconfigTCP_IP_SANITY != 0 )
 				{
 					prvShowWarnings();
 				}
 				#endif /* ipconfigTCP_IP_SANITY */
 
-				#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+				#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) || ( ipconfigUSE_IP_REASSEMBLY != 0 )
 				{
 					/* make sure the buffer is not linked */
 					pxReturn->pxNextBuffer = NULL;
@@ -287,6 +294,7 @@ UBaseType_t uxCount;
 		{
 			/* lint wants to see at least a comment. */
 			iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+			ipSTATS_INCREMENT_SHARED( ulNetworkBufferExhausted );
 		}
 	}
 
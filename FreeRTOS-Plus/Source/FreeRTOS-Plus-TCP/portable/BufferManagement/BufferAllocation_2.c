@@ -55,7 +55,11 @@ heap_4 can be used. */
 
 /* The obtained network buffer must be large enough to hold a packet that might
 replace the packet that was requested to be sent. */
-#if ipconfigUSE_TCP == 1
+#if( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_IPv6 != 0 ) )
+	/* A TCP socket copies this much of a received IPv6 packet to its
+	ucLastPacket. */
+	#define baMINIMAL_BUFFER_SIZE		sizeof( TCPPacket_IPv6_t )
+#elif ipconfigUSE_TCP == 1
 	#define baMINIMAL_BUFFER_SIZE		sizeof( TCPPacket_t )
 #else
 	#define baMINIMAL_BUFFER_SIZE		sizeof( ARPPacket_t )
@@ -246,6 +250,13 @@ size_t uxCount;
 				uxMinimumFreeNetworkBuffers = uxCount;
 			}
 
+			#if( ipconfigUSE_LATENCY_STATS != 0 )
+			{
+				/* The buffer has not been handed to the IP-task yet. */
+				pxReturn->ulHandoffTime = 0UL;
+			}
+			#endif /* ipconfigUSE_LATENCY_STATS */
+
 			/* Allocate storage of exactly the requested size to the buffer. */
 			configASSERT( pxReturn->pucEthernetBuffer == NULL );
 			if( xRequestedSizeBytes > 0 )
@@ -275,7 +286,7 @@ size_t uxCount;
 					greater than the original requested size. */
 					pxReturn->xDataLength = xRequestedSizeBytes;
 
-					#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+					#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) || ( ipconfigUSE_IP_REASSEMBLY != 0 )
 					{
 						/* make sure the buffer is not linked */
 						pxReturn->pxNextBuffer = NULL;
@@ -294,6 +305,7 @@ size_t uxCount;
 	if( pxReturn == NULL )
 	{
 		iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+		ipSTATS_INCREMENT_SHARED( ulNetworkBufferExhausted );
 	}
 	else
 	{
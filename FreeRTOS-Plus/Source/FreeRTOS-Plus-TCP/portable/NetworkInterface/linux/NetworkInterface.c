@@ -160,6 +160,8 @@ size_t xSpace;
 		( xSpace >= ( pxNetworkBuffer->xDataLength +
 					  sizeof( pxNetworkBuffer->xDataLength ) ) ) )
 	{
+		iptraceDUMP_PACKET( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdFALSE );
+
 		/* First write in the length of the data, then write in the data
 		itself. */
 		uxStreamBufferAdd( xSendBuffer,
@@ -779,6 +781,7 @@ static void prvInterruptSimulatorTask( void *pvParameters )
 					{
 						memcpy( pxNetworkBuffer->pucEthernetBuffer, pucPacketData, pxHeader->len );
 						pxNetworkBuffer->xDataLength = ( size_t ) pxHeader->len;
+						iptraceDUMP_PACKET( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
 
 						#if ( niDISRUPT_PACKETS == 1 )
 						{
@@ -0,0 +1,822 @@
+/*
+FreeRTOS+TCP V2.2.1
+Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ http://aws.amazon.com/freertos
+ http://www.FreeRTOS.org
+*/
+
+/*
+ * Network interface for the Posix port that talks to a Linux network device
+ * through an AF_PACKET socket with a TPACKET_V3 memory-mapped RX ring and a
+ * memory-mapped TX ring.
+ *
+ * The kernel fills whole blocks of the RX ring and flags them with
+ * TP_STATUS_USER.  The "MAC_ISR" task walks the ready blocks directly in the
+ * shared memory, copies every frame once into a network buffer and hands the
+ * block back to the kernel, so no system call is made per received packet.
+ * Transmitted frames are copied into a free slot of the TX ring by the sending
+ * task and a pthread flushes all pending slots with a single send() call.  The
+ * sending task is normally the IP-task, but with ipconfigUDP_DIRECT_SEND user
+ * tasks send as well.  A mutex makes them take the slots one at a time and in
+ * ring order.
+ *
+ * Received frames always take one copy: the network buffers are owned by the
+ * stack's buffer allocator, and a ring block can only be returned to the
+ * kernel as a whole, so ring memory can not be lent out to the stack as it is
+ * done by real zero-copy DMA drivers.  With ipconfigUSE_LINKED_RX_MESSAGES
+ * all frames found in one ring block are passed to the IP-task as a single
+ * chain of descriptors.
+ *
+ * The driver can be tested without any external network by using a veth pair,
+ * for example:
+ *
+ *   ip link add veth0 type veth peer name veth1
+ *   ip addr add 192.168.0.1/24 dev veth0
+ *   ip link set veth0 up
+ *   ip link set veth1 up
+ *
+ * Set configNETWORK_INTERFACE_NAME to "veth1" (the default) and give the
+ * FreeRTOS+TCP stack an address in the same subnet.  The host then reaches
+ * the stack through veth0.  Opening an AF_PACKET socket requires
+ * CAP_NET_RAW.
+ */
+
+/* ========================= FreeRTOS includes ============================== */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* ========================= FreeRTOS+TCP includes ========================== */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* ======================== Standard Library inludes ======================== */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <signal.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+
+/* ========================== Local includes =================================*/
+#include "utils/wait_for_event.h"
+
+/* ======================== Macro Definitions =============================== */
+#if ( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer )    eProcessBuffer
+#else
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) \
+	eConsiderFrameForProcessing( ( pucEthernetBuffer ) )
+#endif
+
+/* The name of the Linux network device to open, e.g. one end of a veth pair. */
+#ifndef configNETWORK_INTERFACE_NAME
+	#define configNETWORK_INTERFACE_NAME	"veth1"
+#endif
+
+/* Size of one ring block.  Must be a multiple of the page size and of
+niAF_PACKET_FRAME_SIZE. */
+#ifndef niAF_PACKET_BLOCK_SIZE
+	#define niAF_PACKET_BLOCK_SIZE			( 1U << 16 )
+#endif
+
+/* Number of blocks in the RX ring. */
+#ifndef niAF_PACKET_RX_BLOCK_COUNT
+	#define niAF_PACKET_RX_BLOCK_COUNT		16U
+#endif
+
+/* Number of blocks in the TX ring. */
+#ifndef niAF_PACKET_TX_BLOCK_COUNT
+	#define niAF_PACKET_TX_BLOCK_COUNT		2U
+#endif
+
+/* Size of a frame slot.  In the RX ring this is only a hint for the kernel,
+frames are packed back to back within a block.  In the TX ring every slot
+has this fixed size and must hold a header plus a full Ethernet frame. */
+#ifndef niAF_PACKET_FRAME_SIZE
+	#define niAF_PACKET_FRAME_SIZE			2048U
+#endif
+
+/* A partially filled RX block is handed to user space after this time.  It
+bounds the latency of a lonely packet. */
+#ifndef niAF_PACKET_BLOCK_TIMEOUT_MS
+	#define niAF_PACKET_BLOCK_TIMEOUT_MS	2U
+#endif
+
+/* Time the MAC_ISR task sleeps when the RX ring is empty. */
+#ifndef niAF_PACKET_RX_POLL_MS
+	#define niAF_PACKET_RX_POLL_MS			1U
+#endif
+
+/* The offset of the frame data within a TX slot, see tpacket_fill_skb() in
+the kernel. */
+#define niTX_DATA_OFFSET		TPACKET_ALIGN( sizeof( struct tpacket3_hdr ) )
+
+#define niTX_FRAME_COUNT		( ( niAF_PACKET_BLOCK_SIZE / niAF_PACKET_FRAME_SIZE ) * niAF_PACKET_TX_BLOCK_COUNT )
+#define niRX_RING_SIZE			( ( size_t ) niAF_PACKET_BLOCK_SIZE * niAF_PACKET_RX_BLOCK_COUNT )
+#define niTX_RING_SIZE			( ( size_t ) niAF_PACKET_BLOCK_SIZE * niAF_PACKET_TX_BLOCK_COUNT )
+
+/* ================== Static Function Prototypes ============================ */
+static int prvOpenSocket( void );
+static int prvAttachFilter( void );
+static int prvSetupRings( void );
+static int prvBindToInterface( void );
+static int prvCreateWorkerThreads( void );
+static void * prvLinuxPacketSendThread( void *pvParam );
+static void prvInterruptSimulatorTask( void *pvParameters );
+static BaseType_t prvProcessRxBlock( struct tpacket_block_desc *pxBlock );
+static void prvPassEthMessages( NetworkBufferDescriptor_t *pxDescriptor );
+#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+	static void prvSetMulticastMembership( const MACAddress_t *pxMACAddress, int iOption );
+#endif
+
+/* ======================== Static Global Variables ========================= */
+static int iPacketSocket = -1;
+static int iInterfaceIndex = 0;
+static uint8_t *pucRxRing = NULL;
+static uint8_t *pucTxRing = NULL;
+static size_t uxRxBlockIndex = 0;
+static size_t uxTxFrameIndex = 0;
+static struct event *pvSendEvent = NULL;
+
+/* Protects uxTxFrameIndex and the slot it points to. */
+static SemaphoreHandle_t xTxRingMutex = NULL;
+
+/* Statistics, only written by a single task or thread each.  The TX counters
+are written while holding xTxRingMutex. */
+static uint32_t ulRxDropped = 0;
+static uint32_t ulTxRingFull = 0;
+static uint32_t ulTxSendFailures = 0;
+static uint32_t ulTxRejected = 0;
+
+/* ======================= API Function definitions ========================= */
+
+/*!
+ * @brief API call, called from FreeRTOS_IP.c to open the AF_PACKET socket,
+ *        map its rings and start the worker threads
+ * @return pdPASS if successful else pdFAIL
+ */
+BaseType_t xNetworkInterfaceInitialise( void )
+{
+BaseType_t ret = pdPASS;
+
+	/* This function is called again after a network down event.  The socket
+	and its rings survive, only open them the first time. */
+	if( iPacketSocket < 0 )
+	{
+		ret = pdFAIL;
+
+		do
+		{
+			if( prvOpenSocket() != pdPASS )
+			{
+				break;
+			}
+
+			if( prvAttachFilter() != pdPASS )
+			{
+				break;
+			}
+
+			if( prvSetupRings() != pdPASS )
+			{
+				break;
+			}
+
+			if( prvBindToInterface() != pdPASS )
+			{
+				break;
+			}
+
+			ret = prvCreateWorkerThreads();
+		} while( 0 );
+
+		#if( ipconfigUDP_DIRECT_SEND != 0 )
+		{
+			/* xNetworkInterfaceOutput() may be called by user tasks. */
+			vUDPDirectSendSetDriverSupport( ret );
+		}
+		#endif /* ipconfigUDP_DIRECT_SEND */
+
+		if( ( ret != pdPASS ) && ( iPacketSocket >= 0 ) )
+		{
+			if( pucRxRing != NULL )
+			{
+				( void ) munmap( pucRxRing, niRX_RING_SIZE + niTX_RING_SIZE );
+				pucRxRing = NULL;
+				pucTxRing = NULL;
+			}
+
+			( void ) close( iPacketSocket );
+			iPacketSocket = -1;
+		}
+	}
+
+	return ret;
+}
+
+/*!
+ * @brief API call, called from FreeRTOS_IP.c to send a network packet over the
+ *        AF_PACKET TX ring.  With ipconfigUDP_DIRECT_SEND it is also called by
+ *        user tasks, possibly at the same time
+ * @return pdPASS, the packet is either queued in the ring or dropped
+ */
+BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer,
+									BaseType_t bReleaseAfterSend )
+{
+struct tpacket3_hdr *pxSlot;
+uint32_t ulStatus;
+
+	iptraceNETWORK_INTERFACE_TRANSMIT();
+
+	/* The kernel sends the slots in ring order, so a slot must be filled and
+	published before the next sender may claim the one after it. */
+	( void ) xSemaphoreTake( xTxRingMutex, portMAX_DELAY );
+
+	pxSlot = ( struct tpacket3_hdr * ) ( pucTxRing + ( uxTxFrameIndex * niAF_PACKET_FRAME_SIZE ) );
+	ulStatus = __atomic_load_n( &( pxSlot->tp_status ), __ATOMIC_ACQUIRE );
+
+	if( ulStatus == TP_STATUS_WRONG_FORMAT )
+	{
+		/* The kernel refused the previous frame in this slot, it may be
+		reused. */
+		ulTxRejected++;
+		ulStatus = TP_STATUS_AVAILABLE;
+	}
+
+	if( ( ulStatus == TP_STATUS_AVAILABLE ) &&
+		( pxNetworkBuffer->xDataLength <= ( niAF_PACKET_FRAME_SIZE - niTX_DATA_OFFSET ) ) )
+	{
+		iptraceDUMP_PACKET( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdFALSE );
+		memcpy( ( ( uint8_t * ) pxSlot ) + niTX_DATA_OFFSET,
+				pxNetworkBuffer->pucEthernetBuffer,
+				pxNetworkBuffer->xDataLength );
+		pxSlot->tp_len = ( uint32_t ) pxNetworkBuffer->xDataLength;
+		pxSlot->tp_snaplen = ( uint32_t ) pxNetworkBuffer->xDataLength;
+		pxSlot->tp_next_offset = 0U;
+
+		/* Publish the frame to the kernel only after it has been written. */
+		__atomic_store_n( &( pxSlot->tp_status ), TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE );
+
+		uxTxFrameIndex++;
+
+		if( uxTxFrameIndex == niTX_FRAME_COUNT )
+		{
+			uxTxFrameIndex = 0;
+		}
+
+		/* Wake up the thread that flushes the TX ring. */
+		event_signal( pvSendEvent );
+	}
+	else
+	{
+		ulTxRingFull++;
+		FreeRTOS_debug_printf( ( "xNetworkInterfaceOutput: TX ring full, %lu frames dropped\n",
+								 ( unsigned long ) ulTxRingFull ) );
+	}
+
+	( void ) xSemaphoreGive( xTxRingMutex );
+
+	if( bReleaseAfterSend != pdFALSE )
+	{
+		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+	}
+
+	return pdPASS;
+}
+
+#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+
+/*!
+ * @brief API call, called from the IP-task when a multicast group is joined:
+ *        let the device accept frames for its MAC address
+ * @param [in] pxMACAddress the multicast MAC address
+ */
+void vNetworkInterfaceAddAllowedMAC( const MACAddress_t *pxMACAddress )
+{
+	prvSetMulticastMembership( pxMACAddress, PACKET_ADD_MEMBERSHIP );
+}
+
+/*!
+ * @brief API call, called from the IP-task when a multicast group is left
+ * @param [in] pxMACAddress the multicast MAC address
+ */
+void vNetworkInterfaceRemoveAllowedMAC( const MACAddress_t *pxMACAddress )
+{
+	prvSetMulticastMembership( pxMACAddress, PACKET_DROP_MEMBERSHIP );
+}
+
+#endif /* ipconfigIGMP_DRIVER_MAC_FILTER */
+
+/* ====================== Static Function definitions ======================= */
+
+#if( ipconfigIGMP_DRIVER_MAC_FILTER != 0 )
+
+/*!
+ * @brief add or drop a multicast MAC address in the filter of the device.
+ *        The device runs in promiscuous mode, so this only matters when the
+ *        simulated MAC address is also the real one; frames of other groups
+ *        are dropped by eConsiderFrameForProcessing() before the IP-task
+ * @param [in] pxMACAddress the multicast MAC address
+ * @param [in] iOption PACKET_ADD_MEMBERSHIP or PACKET_DROP_MEMBERSHIP
+ */
+static void prvSetMulticastMembership( const MACAddress_t *pxMACAddress, int iOption )
+{
+struct packet_mreq xRequest;
+
+	if( iPacketSocket >= 0 )
+	{
+		memset( &xRequest, '\0', sizeof( xRequest ) );
+		xRequest.mr_ifindex = iInterfaceIndex;
+		xRequest.mr_type = PACKET_MR_MULTICAST;
+		xRequest.mr_alen = ipMAC_ADDRESS_LENGTH_BYTES;
+		memcpy( xRequest.mr_address, pxMACAddress->ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+
+		if( setsockopt( iPacketSocket, SOL_PACKET, iOption, &xRequest, sizeof( xRequest ) ) != 0 )
+		{
+			FreeRTOS_printf( ( "PACKET_MR_MULTICAST: errno %d\n", errno ) );
+		}
+	}
+}
+
+#endif /* ipconfigIGMP_DRIVER_MAC_FILTER */
+
+/*!
+ * @brief create the AF_PACKET socket and select TPACKET_V3
+ * @returns pdPASS on success pdFAIL on failure
+ */
+static int prvOpenSocket( void )
+{
+int ret = pdFAIL;
+int iVersion = TPACKET_V3;
+
+	iInterfaceIndex = ( int ) if_nametoindex( configNETWORK_INTERFACE_NAME );
+
+	if( iInterfaceIndex == 0 )
+	{
+		FreeRTOS_printf( ( "Network interface '%s' not found, errno %d\n",
+						   configNETWORK_INTERFACE_NAME, errno ) );
+	}
+	else
+	{
+		iPacketSocket = socket( AF_PACKET, SOCK_RAW, htons( ETH_P_ALL ) );
+
+		if( iPacketSocket < 0 )
+		{
+			FreeRTOS_printf( ( "AF_PACKET socket: errno %d (is CAP_NET_RAW missing?)\n", errno ) );
+		}
+		else if( setsockopt( iPacketSocket, SOL_PACKET, PACKET_VERSION, &iVersion, sizeof( iVersion ) ) != 0 )
+		{
+			FreeRTOS_printf( ( "PACKET_VERSION TPACKET_V3: errno %d\n", errno ) );
+		}
+		else
+		{
+			ret = pdPASS;
+		}
+	}
+
+	return ret;
+}
+
+/*!
+ * @brief attach a classic BPF program to the socket, so that the kernel only
+ *        queues frames sent to our MAC address, broadcasts and multicasts,
+ *        and no copies of the frames that we send ourselves
+ * @returns pdPASS on success pdFAIL on failure
+ */
+static int prvAttachFilter( void )
+{
+const uint8_t *pucMAC = FreeRTOS_GetMACAddress();
+const uint32_t ulMACHigh = ( ( uint32_t ) pucMAC[ 0 ] << 24 ) | ( ( uint32_t ) pucMAC[ 1 ] << 16 ) |
+						   ( ( uint32_t ) pucMAC[ 2 ] << 8 ) | ( uint32_t ) pucMAC[ 3 ];
+const uint32_t ulMACLow = ( ( uint32_t ) pucMAC[ 4 ] << 8 ) | ( uint32_t ) pucMAC[ 5 ];
+struct sock_filter xCode[] =
+{
+	/* 0: Drop what the kernel loops back from our own transmissions. */
+	BPF_STMT( BPF_LD | BPF_B | BPF_ABS, ( uint32_t ) ( SKF_AD_OFF + SKF_AD_PKTTYPE ) ),
+	BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, PACKET_OUTGOING, 7, 0 ),
+	/* 2: Accept frames sent to our MAC address. */
+	BPF_STMT( BPF_LD | BPF_W | BPF_ABS, 0 ),
+	BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ulMACHigh, 0, 2 ),
+	BPF_STMT( BPF_LD | BPF_H | BPF_ABS, 4 ),
+	BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ulMACLow, 2, 0 ),
+	/* 6: Accept broadcast and multicast frames. */
+	BPF_STMT( BPF_LD | BPF_B | BPF_ABS, 0 ),
+	BPF_JUMP( BPF_JMP | BPF_JSET | BPF_K, 0x01, 0, 1 ),
+	/* 8: Accept the whole frame. */
+	BPF_STMT( BPF_RET | BPF_K, 0x0000FFFFU ),
+	/* 9: Drop. */
+	BPF_STMT( BPF_RET | BPF_K, 0U )
+};
+struct sock_fprog xProgram;
+struct packet_mreq xRequest;
+int ret = pdFAIL;
+
+	xProgram.len = ( unsigned short ) ( sizeof( xCode ) / sizeof( xCode[ 0 ] ) );
+	xProgram.filter = xCode;
+
+	/* The MAC address of the stack is simulated, so the device must receive
+	frames for every address.  The filter removes the ones not for us. */
+	memset( &xRequest, '\0', sizeof( xRequest ) );
+	xRequest.mr_ifindex = iInterfaceIndex;
+	xRequest.mr_type = PACKET_MR_PROMISC;
+
+	if( setsockopt( iPacketSocket, SOL_SOCKET, SO_ATTACH_FILTER, &xProgram, sizeof( xProgram ) ) != 0 )
+	{
+		FreeRTOS_printf( ( "SO_ATTACH_FILTER: errno %d\n", errno ) );
+	}
+	else if( setsockopt( iPacketSocket, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &xRequest, sizeof( xRequest ) ) != 0 )
+	{
+		FreeRTOS_printf( ( "PACKET_MR_PROMISC: errno %d\n", errno ) );
+	}
+	else
+	{
+		ret = pdPASS;
+	}
+
+	return ret;
+}
+
+/*!
+ * @brief configure the RX and TX rings and map them into our address space,
+ *        the TX ring directly follows the RX ring in the mapping
+ * @returns pdPASS on success pdFAIL on failure
+ */
+static int prvSetupRings( void )
+{
+struct tpacket_req3 xRxRequest;
+struct tpacket_req3 xTxRequest;
+void *pvMapping;
+int ret = pdFAIL;
+
+	configASSERT( ( niAF_PACKET_BLOCK_SIZE % niAF_PACKET_FRAME_SIZE ) == 0U );
+	configASSERT( ( niAF_PACKET_FRAME_SIZE - niTX_DATA_OFFSET ) >= ipTOTAL_ETHERNET_FRAME_SIZE );
+
+	memset( &xRxRequest, '\0', sizeof( xRxRequest ) );
+	xRxRequest.tp_block_size = niAF_PACKET_BLOCK_SIZE;
+	xRxRequest.tp_block_nr = niAF_PACKET_RX_BLOCK_COUNT;
+	xRxRequest.tp_frame_size = niAF_PACKET_FRAME_SIZE;
+	xRxRequest.tp_frame_nr = ( niAF_PACKET_BLOCK_SIZE / niAF_PACKET_FRAME_SIZE ) * niAF_PACKET_RX_BLOCK_COUNT;
+	xRxRequest.tp_retire_blk_tov = niAF_PACKET_BLOCK_TIMEOUT_MS;
+
+	/* A TPACKET_V3 TX ring uses fixed size slots, a block timeout is not
+	allowed. */
+	memset( &xTxRequest, '\0', sizeof( xTxRequest ) );
+	xTxRequest.tp_block_size = niAF_PACKET_BLOCK_SIZE;
+	xTxRequest.tp_block_nr = niAF_PACKET_TX_BLOCK_COUNT;
+	xTxRequest.tp_frame_size = niAF_PACKET_FRAME_SIZE;
+	xTxRequest.tp_frame_nr = niTX_FRAME_COUNT;
+
+	if( setsockopt( iPacketSocket, SOL_PACKET, PACKET_RX_RING, &xRxRequest, sizeof( xRxRequest ) ) != 0 )
+	{
+		FreeRTOS_printf( ( "PACKET_RX_RING: errno %d\n", errno ) );
+	}
+	else if( setsockopt( iPacketSocket, SOL_PACKET, PACKET_TX_RING, &xTxRequest, sizeof( xTxRequest ) ) != 0 )
+	{
+		FreeRTOS_printf( ( "PACKET_TX_RING: errno %d (kernel 4.11 or later is needed)\n", errno ) );
+	}
+	else
+	{
+		pvMapping = mmap( NULL, niRX_RING_SIZE + niTX_RING_SIZE, PROT_READ | PROT_WRITE,
+						  MAP_SHARED | MAP_LOCKED, iPacketSocket, 0 );
+
+		if( pvMapping == MAP_FAILED )
+		{
+			/* MAP_LOCKED may fail because of RLIMIT_MEMLOCK, try without. */
+			pvMapping = mmap( NULL, niRX_RING_SIZE + niTX_RING_SIZE, PROT_READ | PROT_WRITE,
+							  MAP_SHARED, iPacketSocket, 0 );
+		}
+
+		if( pvMapping == MAP_FAILED )
+		{
+			FreeRTOS_printf( ( "mmap of the packet rings: errno %d\n", errno ) );
+		}
+		else
+		{
+			pucRxRing = ( uint8_t * ) pvMapping;
+			pucTxRing = pucRxRing + niRX_RING_SIZE;
+			uxRxBlockIndex = 0;
+			uxTxFrameIndex = 0;
+			ret = pdPASS;
+		}
+	}
+
+	return ret;
+}
+
+/*!
+ * @brief bind the socket to the selected network device
+ * @returns pdPASS on success pdFAIL on failure
+ */
+static int prvBindToInterface( void )
+{
+struct sockaddr_ll xAddress;
+int ret = pdFAIL;
+
+	memset( &xAddress, '\0', sizeof( xAddress ) );
+	xAddress.sll_family = AF_PACKET;
+	xAddress.sll_protocol = htons( ETH_P_ALL );
+	xAddress.sll_ifindex = iInterfaceIndex;
+
+	if( bind( iPacketSocket, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) != 0 )
+	{
+		FreeRTOS_printf( ( "bind to '%s': errno %d\n", configNETWORK_INTERFACE_NAME, errno ) );
+	}
+	else
+	{
+		FreeRTOS_printf( ( "AF_PACKET: opened '%s' with %u RX blocks and %u TX slots\n",
+						   configNETWORK_INTERFACE_NAME,
+						   ( unsigned ) niAF_PACKET_RX_BLOCK_COUNT,
+						   ( unsigned ) niTX_FRAME_COUNT ) );
+		ret = pdPASS;
+	}
+
+	return ret;
+}
+
+/*!
+ * @brief launch the Linux thread that flushes the TX ring and the FreeRTOS
+ *        task that simulates an interrupt by polling the RX ring
+ * @return pdPASS on success otherwise pdFAIL
+ */
+static int prvCreateWorkerThreads( void )
+{
+pthread_t vPacketSendThreadHandle;
+int ret = pdFAIL;
+
+	do
+	{
+		/* Create event used to signal the Tx thread. */
+		pvSendEvent = event_create();
+
+		if( pvSendEvent == NULL )
+		{
+			break;
+		}
+
+		xTxRingMutex = xSemaphoreCreateMutex();
+
+		if( xTxRingMutex == NULL )
+		{
+			break;
+		}
+
+		if( pthread_create( &vPacketSendThreadHandle, NULL, prvLinuxPacketSendThread, NULL ) != 0 )
+		{
+			FreeRTOS_printf( ( "pthread_create failed\n" ) );
+			break;
+		}
+
+		if( xTaskCreate( prvInterruptSimulatorTask,
+						 "MAC_ISR",
+						 configMINIMAL_STACK_SIZE,
+						 NULL,
+						 configMAC_ISR_SIMULATOR_PRIORITY,
+						 NULL ) != pdPASS )
+		{
+			FreeRTOS_printf( ( "xTaskCreate could not create a new task\n" ) );
+			break;
+		}
+
+		ret = pdPASS;
+	} while( 0 );
+
+	return ret;
+}
+
+/*!
+ * @brief Infinite loop thread that waits until frames were placed in the TX
+ *        ring and asks the kernel to transmit all of them with one call
+ * @param [in] pvParam not used
+ * @returns NULL
+ * @warning this is called from a Linux thread, do not attempt any FreeRTOS calls
+ */
+static void * prvLinuxPacketSendThread( void *pvParam )
+{
+const time_t xMaxMSToWait = 1000;
+sigset_t set;
+
+	( void ) pvParam;
+
+	/* Disable signals to avoid treating this thread as a FreeRTOS task and
+	putting it to sleep by the scheduler. */
+	sigfillset( &set );
+	pthread_sigmask( SIG_SETMASK, &set, NULL );
+
+	for( ; ; )
+	{
+		event_wait_timed( pvSendEvent, xMaxMSToWait );
+
+		/* A send() without data transmits every slot that is marked
+		TP_STATUS_SEND_REQUEST, including the ones that were added
+		while the previous call was busy. */
+		if( send( iPacketSocket, NULL, 0, 0 ) < 0 )
+		{
+			if( ( errno != EINTR ) && ( errno != ENOBUFS ) )
+			{
+				ulTxSendFailures++;
+				FreeRTOS_printf( ( "AF_PACKET send: errno %d, %lu failures\n",
+								   errno, ( unsigned long ) ulTxSendFailures ) );
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/*!
+ * @brief pass one or a chain of received network buffers to the IP-task
+ * @param [in] pxDescriptor the first buffer
+ */
+static void prvPassEthMessages( NetworkBufferDescriptor_t *pxDescriptor )
+{
+IPStackEvent_t xRxEvent;
+
+	xRxEvent.eEventType = eNetworkRxEvent;
+	xRxEvent.pvData = ( void * ) pxDescriptor;
+
+	if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+	{
+		/* The buffer could not be sent to the stack so must be released
+		again.  This is only an interrupt simulator, so it is ok to use the
+		task level function here. */
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			do
+			{
+				NetworkBufferDescriptor_t *pxNext = pxDescriptor->pxNextBuffer;
+				vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+				pxDescriptor = pxNext;
+			} while( pxDescriptor != NULL );
+		}
+		#else
+		{
+			vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+		}
+		#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+		iptraceETHERNET_RX_EVENT_LOST();
+	}
+}
+
+/*!
+ * @brief copy all frames of a block that was retired by the kernel into
+ *        network buffers and pass them to the IP-task
+ * @param [in] pxBlock the block, owned by user space
+ * @returns the number of frames that were found in the block
+ */
+static BaseType_t prvProcessRxBlock( struct tpacket_block_desc *pxBlock )
+{
+struct tpacket3_hdr *pxFrame;
+const uint8_t *pucPacketData;
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+uint32_t ulCount;
+uint32_t ulIndex;
+size_t uxLength;
+#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	NetworkBufferDescriptor_t *pxFirstDescriptor = NULL;
+	NetworkBufferDescriptor_t *pxLastDescriptor = NULL;
+#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+
+	ulCount = pxBlock->hdr.bh1.num_pkts;
+	pxFrame = ( struct tpacket3_hdr * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->hdr.bh1.offset_to_first_pkt );
+
+	for( ulIndex = 0U; ulIndex < ulCount; ulIndex++ )
+	{
+		pucPacketData = ( ( const uint8_t * ) pxFrame ) + pxFrame->tp_mac;
+		uxLength = ( size_t ) pxFrame->tp_snaplen;
+
+		iptraceNETWORK_INTERFACE_RECEIVE();
+
+		/* Truncated, oversized and undersized frames are dropped. */
+		if( ( pxFrame->tp_snaplen != pxFrame->tp_len ) ||
+			( uxLength > ipTOTAL_ETHERNET_FRAME_SIZE ) ||
+			( uxLength < sizeof( EthernetHeader_t ) ) ||
+			( ipCONSIDER_FRAME_FOR_PROCESSING( pucPacketData ) != eProcessBuffer ) )
+		{
+			pxNetworkBuffer = NULL;
+		}
+		else
+		{
+			/* This is only an interrupt simulator, not a real interrupt, so
+			it is ok to call the task level function here. */
+			pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxLength, 0 );
+
+			if( pxNetworkBuffer == NULL )
+			{
+				ulRxDropped++;
+				iptraceETHERNET_RX_EVENT_LOST();
+			}
+		}
+
+		if( pxNetworkBuffer != NULL )
+		{
+			memcpy( pxNetworkBuffer->pucEthernetBuffer, pucPacketData, uxLength );
+			pxNetworkBuffer->xDataLength = uxLength;
+			iptraceDUMP_PACKET( pxNetworkBuffer->pucEthernetBuffer, uxLength, pdTRUE );
+
+			#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+			{
+				pxNetworkBuffer->pxNextBuffer = NULL;
+
+				if( pxFirstDescriptor == NULL )
+				{
+					pxFirstDescriptor = pxNetworkBuffer;
+				}
+				else
+				{
+					pxLastDescriptor->pxNextBuffer = pxNetworkBuffer;
+				}
+
+				pxLastDescriptor = pxNetworkBuffer;
+			}
+			#else
+			{
+				prvPassEthMessages( pxNetworkBuffer );
+			}
+			#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+		}
+
+		pxFrame = ( struct tpacket3_hdr * ) ( ( ( uint8_t * ) pxFrame ) + pxFrame->tp_next_offset );
+	}
+
+	#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	{
+		if( pxFirstDescriptor != NULL )
+		{
+			prvPassEthMessages( pxFirstDescriptor );
+		}
+	}
+	#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+
+	return ( BaseType_t ) ulCount;
+}
+
+/*!
+ * @brief FreeRTOS infinite loop task that simulates a network interrupt: it
+ *        checks the status word of the next RX block in shared memory and
+ *        processes all blocks that the kernel has handed over
+ * @param [in] pvParameters not used
+ */
+static void prvInterruptSimulatorTask( void *pvParameters )
+{
+struct tpacket_block_desc *pxBlock;
+const TickType_t xPollDelay = ( pdMS_TO_TICKS( niAF_PACKET_RX_POLL_MS ) > 0U ) ? pdMS_TO_TICKS( niAF_PACKET_RX_POLL_MS ) : 1U;
+
+	/* Remove compiler warnings about unused parameters. */
+	( void ) pvParameters;
+
+	for( ; ; )
+	{
+		pxBlock = ( struct tpacket_block_desc * ) ( pucRxRing + ( uxRxBlockIndex * niAF_PACKET_BLOCK_SIZE ) );
+
+		if( ( __atomic_load_n( &( pxBlock->hdr.bh1.block_status ), __ATOMIC_ACQUIRE ) & TP_STATUS_USER ) != 0U )
+		{
+			( void ) prvProcessRxBlock( pxBlock );
+
+			/* Give the block back to the kernel once all frames were
+			copied. */
+			__atomic_store_n( &( pxBlock->hdr.bh1.block_status ), TP_STATUS_KERNEL, __ATOMIC_RELEASE );
+
+			uxRxBlockIndex++;
+
+			if( uxRxBlockIndex == niAF_PACKET_RX_BLOCK_COUNT )
+			{
+				uxRxBlockIndex = 0;
+			}
+		}
+		else
+		{
+			/* There is no real way of simulating an interrupt.  Make sure
+			other tasks can run. */
+			vTaskDelay( xPollDelay );
+		}
+	}
+}
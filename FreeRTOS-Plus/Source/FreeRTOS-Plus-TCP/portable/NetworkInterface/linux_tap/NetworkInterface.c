@@ -0,0 +1,652 @@
+/*
+FreeRTOS+TCP V2.2.1
+Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ http://aws.amazon.com/freertos
+ http://www.FreeRTOS.org
+*/
+
+/*
+ * Network interface for the Posix port that connects the stack to the host
+ * kernel through a multi-queue TAP device.  No libpcap and no physical NIC are
+ * needed: the TAP device is the "wire" and the host is the peer.
+ *
+ * Every queue of the TAP device is a non-blocking file descriptor.  The
+ * "MAC_ISR" task drains up to niTAP_RX_BATCH frames per queue and pass, each
+ * with one readv() that places the virtio-net header in a local variable and
+ * the frame directly in a network buffer.  xNetworkInterfaceOutput() writes a
+ * frame with one writev() on a queue that is selected by a hash of the flow,
+ * so that the frames of one connection are never reordered.  A writev() on a
+ * TAP queue passes exactly one frame to the host, so several tasks may call
+ * xNetworkInterfaceOutput() at the same time (ipconfigUDP_DIRECT_SEND).
+ *
+ * The device is opened with IFF_VNET_HDR and TUN_F_CSUM:
+ *  - Frames that the host hands over with a partial checksum are completed
+ *    here, or accepted unchecked when ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM
+ *    is 1.  Frames that the host marked as validated are accepted as well, the
+ *    remaining frames are verified by the driver in that case.
+ *  - When ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM is 1, the driver fills in the
+ *    IP header checksum and leaves the TCP/UDP checksum to the host.
+ * GSO is not negotiated: the stack never produces frames larger than the MTU.
+ *
+ * The TAP device may be created in advance, which also allows running without
+ * root privileges:
+ *
+ *   ip tuntap add dev tap0 mode tap multi_queue vnet_hdr user $USER
+ *   ip addr add 192.168.0.1/24 dev tap0
+ *   ip link set tap0 up
+ *
+ * Set configNETWORK_INTERFACE_NAME to "tap0" (the default) and give the
+ * FreeRTOS+TCP stack an address in the same subnet.
+ */
+
+/* ========================= FreeRTOS includes ============================== */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* ========================= FreeRTOS+TCP includes ========================== */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* ======================== Standard Library inludes ======================== */
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+#include <linux/virtio_net.h>
+
+/* ======================== Macro Definitions =============================== */
+#if ( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer )    eProcessBuffer
+#else
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) \
+	eConsiderFrameForProcessing( ( pucEthernetBuffer ) )
+#endif
+
+/* The name of the TAP device to open or create. */
+#ifndef configNETWORK_INTERFACE_NAME
+	#define configNETWORK_INTERFACE_NAME	"tap0"
+#endif
+
+/* Number of queues (file descriptors) to open on the TAP device. */
+#ifndef niTAP_QUEUE_COUNT
+	#define niTAP_QUEUE_COUNT				4
+#endif
+
+/* Maximum number of frames read from one queue before the next queue gets its
+turn. */
+#ifndef niTAP_RX_BATCH
+	#define niTAP_RX_BATCH					32
+#endif
+
+/* Time the MAC_ISR task sleeps when all queues are empty. */
+#ifndef niTAP_RX_POLL_MS
+	#define niTAP_RX_POLL_MS				1U
+#endif
+
+/* usGenerateChecksum() of a correct checksummed area. */
+#define niCORRECT_CRC					0xffffU
+
+/* ================== Static Function Prototypes ============================ */
+static int prvOpenQueue( void );
+static BaseType_t prvReadQueue( int iQueue );
+static BaseType_t prvCheckRxChecksum( const struct virtio_net_hdr *pxHeader,
+									  NetworkBufferDescriptor_t *pxNetworkBuffer );
+static void prvSetTxChecksum( struct virtio_net_hdr *pxHeader,
+							  NetworkBufferDescriptor_t *pxNetworkBuffer );
+static int prvSelectTxQueue( const uint8_t *pucEthernetBuffer, size_t uxLength );
+static void prvInterruptSimulatorTask( void *pvParameters );
+static void prvPassEthMessages( NetworkBufferDescriptor_t *pxDescriptor );
+
+/* ======================== Static Global Variables ========================= */
+static int iQueueDescriptors[ niTAP_QUEUE_COUNT ];
+static BaseType_t xQueueCount = 0;
+
+/* A buffer that was allocated for a read that found no data.  It is kept for
+the next attempt. */
+static NetworkBufferDescriptor_t *pxSpareBuffer = NULL;
+
+#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	static NetworkBufferDescriptor_t *pxFirstDescriptor = NULL;
+	static NetworkBufferDescriptor_t *pxLastDescriptor = NULL;
+#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+
+/* Statistics. */
+static uint32_t ulRxDropped = 0;
+static uint32_t ulRxChecksumErrors = 0;
+static uint32_t ulTxDropped = 0;
+
+/* ======================= API Function definitions ========================= */
+
+/*!
+ * @brief API call, called from FreeRTOS_IP.c to open all queues of the TAP
+ *        device and to start the task that receives from them
+ * @return pdPASS if successful else pdFAIL
+ */
+BaseType_t xNetworkInterfaceInitialise( void )
+{
+BaseType_t ret = pdPASS;
+int iDescriptor;
+
+	/* This function is called again after a network down event.  The queues
+	stay open, only open them the first time. */
+	if( xQueueCount == 0 )
+	{
+		while( xQueueCount < niTAP_QUEUE_COUNT )
+		{
+			iDescriptor = prvOpenQueue();
+
+			if( iDescriptor < 0 )
+			{
+				break;
+			}
+
+			iQueueDescriptors[ xQueueCount ] = iDescriptor;
+			xQueueCount++;
+		}
+
+		if( xQueueCount == 0 )
+		{
+			ret = pdFAIL;
+		}
+		else
+		{
+			FreeRTOS_printf( ( "TAP: opened '%s' with %d queues\n",
+							   configNETWORK_INTERFACE_NAME, ( int ) xQueueCount ) );
+
+			if( xTaskCreate( prvInterruptSimulatorTask,
+							 "MAC_ISR",
+							 configMINIMAL_STACK_SIZE,
+							 NULL,
+							 configMAC_ISR_SIMULATOR_PRIORITY,
+							 NULL ) != pdPASS )
+			{
+				FreeRTOS_printf( ( "xTaskCreate could not create a new task\n" ) );
+				ret = pdFAIL;
+			}
+		}
+	}
+
+	#if( ipconfigUDP_DIRECT_SEND != 0 )
+	{
+		/* xNetworkInterfaceOutput() may be called by user tasks. */
+		vUDPDirectSendSetDriverSupport( ret );
+	}
+	#endif /* ipconfigUDP_DIRECT_SEND */
+
+	return ret;
+}
+
+/*!
+ * @brief API call, called from FreeRTOS_IP.c to send a network packet on the
+ *        TAP queue that belongs to its flow.  With ipconfigUDP_DIRECT_SEND it is
+ *        also called by user tasks, possibly at the same time
+ * @return pdPASS, the frame is either written or dropped
+ */
+BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer,
+									BaseType_t bReleaseAfterSend )
+{
+struct virtio_net_hdr xHeader;
+struct iovec xVector[ 2 ];
+int iQueue;
+
+	iptraceNETWORK_INTERFACE_TRANSMIT();
+
+	memset( &xHeader, '\0', sizeof( xHeader ) );
+	xHeader.gso_type = VIRTIO_NET_HDR_GSO_NONE;
+	prvSetTxChecksum( &xHeader, pxNetworkBuffer );
+
+	xVector[ 0 ].iov_base = &xHeader;
+	xVector[ 0 ].iov_len = sizeof( xHeader );
+	xVector[ 1 ].iov_base = pxNetworkBuffer->pucEthernetBuffer;
+	xVector[ 1 ].iov_len = pxNetworkBuffer->xDataLength;
+
+	iQueue = prvSelectTxQueue( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength );
+	iptraceDUMP_PACKET( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdFALSE );
+
+	/* The descriptor is non-blocking, a full queue drops the frame just like
+	a NIC with a full TX ring would. */
+	if( writev( iQueueDescriptors[ iQueue ], xVector, 2 ) < 0 )
+	{
+		taskENTER_CRITICAL();
+		{
+			ulTxDropped++;
+		}
+		taskEXIT_CRITICAL();
+		FreeRTOS_debug_printf( ( "xNetworkInterfaceOutput: writev errno %d, %lu dropped\n",
+								 errno, ( unsigned long ) ulTxDropped ) );
+	}
+
+	if( bReleaseAfterSend != pdFALSE )
+	{
+		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+	}
+
+	return pdPASS;
+}
+
+/* ====================== Static Function definitions ======================= */
+
+/*!
+ * @brief open one more queue of the TAP device
+ * @returns a non-blocking file descriptor, or -1 on failure
+ */
+static int prvOpenQueue( void )
+{
+struct ifreq xRequest;
+int iDescriptor;
+int iHeaderSize = ( int ) sizeof( struct virtio_net_hdr );
+unsigned int uxOffloads = TUN_F_CSUM;
+
+	iDescriptor = open( "/dev/net/tun", O_RDWR | O_NONBLOCK );
+
+	if( iDescriptor < 0 )
+	{
+		FreeRTOS_printf( ( "open /dev/net/tun: errno %d\n", errno ) );
+	}
+	else
+	{
+		memset( &xRequest, '\0', sizeof( xRequest ) );
+		( void ) strncpy( xRequest.ifr_name, configNETWORK_INTERFACE_NAME, IFNAMSIZ - 1 );
+		xRequest.ifr_flags = IFF_TAP | IFF_NO_PI | IFF_VNET_HDR | IFF_MULTI_QUEUE;
+
+		if( ioctl( iDescriptor, TUNSETIFF, &xRequest ) < 0 )
+		{
+			FreeRTOS_printf( ( "TUNSETIFF '%s': errno %d\n", configNETWORK_INTERFACE_NAME, errno ) );
+			( void ) close( iDescriptor );
+			iDescriptor = -1;
+		}
+		else if( ( ioctl( iDescriptor, TUNSETVNETHDRSZ, &iHeaderSize ) < 0 ) ||
+				 ( ioctl( iDescriptor, TUNSETOFFLOAD, uxOffloads ) < 0 ) )
+		{
+			FreeRTOS_printf( ( "TAP offload settings: errno %d\n", errno ) );
+			( void ) close( iDescriptor );
+			iDescriptor = -1;
+		}
+		else
+		{
+			/* The queue is ready. */
+		}
+	}
+
+	return iDescriptor;
+}
+
+/*!
+ * @brief choose a TX queue for a frame, frames of the same TCP or UDP flow
+ *        always go to the same queue
+ * @param [in] pucEthernetBuffer the frame
+ * @param [in] uxLength length of the frame
+ * @returns the queue index
+ */
+static int prvSelectTxQueue( const uint8_t *pucEthernetBuffer, size_t uxLength )
+{
+const ProtocolPacket_t *pxPacket = ipPOINTER_CAST( const ProtocolPacket_t *, pucEthernetBuffer );
+uint32_t ulHash = 0U;
+
+	if( ( xQueueCount > 1 ) &&
+		( uxLength >= sizeof( UDPPacket_t ) ) &&
+		( pxPacket->xUDPPacket.xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE ) )
+	{
+		ulHash = pxPacket->xUDPPacket.xIPHeader.ulSourceIPAddress ^
+				 pxPacket->xUDPPacket.xIPHeader.ulDestinationIPAddress;
+
+		if( ( pxPacket->xUDPPacket.xIPHeader.ucProtocol == ( uint8_t ) ipPROTOCOL_TCP ) ||
+			( pxPacket->xUDPPacket.xIPHeader.ucProtocol == ( uint8_t ) ipPROTOCOL_UDP ) )
+		{
+			/* The port numbers are at the same place for TCP and UDP. */
+			ulHash ^= ( ( uint32_t ) pxPacket->xUDPPacket.xUDPHeader.usSourcePort << 16 ) |
+					  ( uint32_t ) pxPacket->xUDPPacket.xUDPHeader.usDestinationPort;
+		}
+
+		ulHash ^= ulHash >> 16;
+		ulHash ^= ulHash >> 8;
+	}
+
+	return ( int ) ( ulHash % ( uint32_t ) xQueueCount );
+}
+
+/*!
+ * @brief set the virtio-net header of an outgoing frame, and the IP header
+ *        checksum, when checksums are offloaded to the driver
+ * @param [out] pxHeader the virtio-net header
+ * @param [in] pxNetworkBuffer the outgoing frame
+ */
+static void prvSetTxChecksum( struct virtio_net_hdr *pxHeader,
+							  NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+	#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM != 0 )
+	{
+	ProtocolPacket_t *pxPacket = ipPOINTER_CAST( ProtocolPacket_t *, pxNetworkBuffer->pucEthernetBuffer );
+	IPHeader_t *pxIPHeader = &( pxPacket->xUDPPacket.xIPHeader );
+	size_t uxHeaderLength;
+	uint16_t usLength;
+	uint16_t usPartial;
+
+		if( ( pxNetworkBuffer->xDataLength >= sizeof( IPPacket_t ) ) &&
+			( pxPacket->xUDPPacket.xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE ) )
+		{
+			uxHeaderLength = ( size_t ) ( ( pxIPHeader->ucVersionHeaderLength & 0x0FU ) << 2 );
+
+			pxIPHeader->usHeaderChecksum = 0U;
+			pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), uxHeaderLength );
+			pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+
+			if( ( pxIPHeader->ucProtocol == ( uint8_t ) ipPROTOCOL_TCP ) ||
+				( pxIPHeader->ucProtocol == ( uint8_t ) ipPROTOCOL_UDP ) )
+			{
+				/* The host completes the checksum, starting from the sum of
+				the pseudo header that is placed in the checksum field. */
+				usLength = ( uint16_t ) ( FreeRTOS_ntohs( pxIPHeader->usLength ) - uxHeaderLength );
+				usPartial = usGenerateChecksum( ( uint16_t ) ( usLength + ( uint16_t ) pxIPHeader->ucProtocol ),
+												ipPOINTER_CAST( const uint8_t *, &( pxIPHeader->ulSourceIPAddress ) ),
+												2U * ipSIZE_OF_IPv4_ADDRESS );
+
+				pxHeader->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+				pxHeader->csum_start = ( uint16_t ) ( ipSIZE_OF_ETH_HEADER + uxHeaderLength );
+
+				if( pxIPHeader->ucProtocol == ( uint8_t ) ipPROTOCOL_TCP )
+				{
+					pxHeader->csum_offset = ( uint16_t ) offsetof( TCPHeader_t, usChecksum );
+				}
+				else
+				{
+					pxHeader->csum_offset = ( uint16_t ) offsetof( UDPHeader_t, usChecksum );
+				}
+
+				*( ipPOINTER_CAST( uint16_t *, &( pxNetworkBuffer->pucEthernetBuffer[ pxHeader->csum_start + pxHeader->csum_offset ] ) ) ) =
+					FreeRTOS_htons( usPartial );
+			}
+		}
+	}
+	#else
+	{
+		/* The stack has calculated all checksums. */
+		( void ) pxHeader;
+		( void ) pxNetworkBuffer;
+	}
+	#endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM */
+}
+
+/*!
+ * @brief handle the checksum information that the host passed along with a
+ *        received frame
+ * @param [in] pxHeader the virtio-net header of the frame
+ * @param [in] pxNetworkBuffer the received frame
+ * @returns pdPASS when the frame may be passed to the IP-task
+ */
+static BaseType_t prvCheckRxChecksum( const struct virtio_net_hdr *pxHeader,
+									  NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+BaseType_t xResult = pdPASS;
+size_t uxStart = ( size_t ) pxHeader->csum_start;
+size_t uxOffset = ( size_t ) pxHeader->csum_offset;
+uint16_t usChecksum;
+
+	if( ( pxHeader->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM ) != 0U )
+	{
+		/* The frame comes from the host itself and carries a partial checksum,
+		i.e. the sum of the pseudo header only. */
+		if( ( uxStart + uxOffset + sizeof( uint16_t ) ) > pxNetworkBuffer->xDataLength )
+		{
+			xResult = pdFAIL;
+		}
+		else
+		{
+			#if( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 )
+			{
+				/* The stack will verify the checksum, complete it first. */
+				usChecksum = ( uint16_t ) ~usGenerateChecksum( 0U,
+															   &( pxNetworkBuffer->pucEthernetBuffer[ uxStart ] ),
+															   pxNetworkBuffer->xDataLength - uxStart );
+
+				if( usChecksum == 0U )
+				{
+					usChecksum = 0xffffU;
+				}
+
+				*( ipPOINTER_CAST( uint16_t *, &( pxNetworkBuffer->pucEthernetBuffer[ uxStart + uxOffset ] ) ) ) =
+					FreeRTOS_htons( usChecksum );
+			}
+			#else
+			{
+				/* Nothing got corrupted on the way, the frame is accepted
+				without checking. */
+				( void ) usChecksum;
+			}
+			#endif /* ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM */
+		}
+	}
+	else
+	{
+		#if( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM != 0 )
+		{
+		const IPPacket_t *pxIPPacket = ipPOINTER_CAST( const IPPacket_t *, pxNetworkBuffer->pucEthernetBuffer );
+		size_t uxHeaderLength;
+
+			/* The stack relies on the driver to check the checksums of the
+			frames that the host did not validate already. */
+			if( ( ( pxHeader->flags & VIRTIO_NET_HDR_F_DATA_VALID ) == 0U ) &&
+				( pxNetworkBuffer->xDataLength >= sizeof( IPPacket_t ) ) &&
+				( pxIPPacket->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE ) )
+			{
+				uxHeaderLength = ( size_t ) ( ( pxIPPacket->xIPHeader.ucVersionHeaderLength & 0x0FU ) << 2 );
+
+				if( ( usGenerateChecksum( 0U, &( pxIPPacket->xIPHeader.ucVersionHeaderLength ), uxHeaderLength ) != niCORRECT_CRC ) ||
+					( usGenerateProtocolChecksum( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdFALSE ) != niCORRECT_CRC ) )
+				{
+					xResult = pdFAIL;
+				}
+			}
+		}
+		#else
+		{
+			/* The stack verifies all checksums. */
+			( void ) uxStart;
+			( void ) uxOffset;
+			( void ) usChecksum;
+		}
+		#endif /* ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM */
+	}
+
+	if( xResult != pdPASS )
+	{
+		ulRxChecksumErrors++;
+	}
+
+	return xResult;
+}
+
+/*!
+ * @brief pass one or a chain of received network buffers to the IP-task
+ * @param [in] pxDescriptor the first buffer
+ */
+static void prvPassEthMessages( NetworkBufferDescriptor_t *pxDescriptor )
+{
+IPStackEvent_t xRxEvent;
+
+	xRxEvent.eEventType = eNetworkRxEvent;
+	xRxEvent.pvData = ( void * ) pxDescriptor;
+
+	if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+	{
+		/* The buffer could not be sent to the stack so must be released
+		again.  This is only an interrupt simulator, so it is ok to use the
+		task level function here. */
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			do
+			{
+				NetworkBufferDescriptor_t *pxNext = pxDescriptor->pxNextBuffer;
+				vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+				pxDescriptor = pxNext;
+			} while( pxDescriptor != NULL );
+		}
+		#else
+		{
+			vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+		}
+		#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+		iptraceETHERNET_RX_EVENT_LOST();
+	}
+}
+
+/*!
+ * @brief read a batch of frames from one queue of the TAP device
+ * @param [in] iQueue the index of the queue
+ * @returns the number of frames read
+ */
+static BaseType_t prvReadQueue( int iQueue )
+{
+struct virtio_net_hdr xHeader;
+struct iovec xVector[ 2 ];
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+ssize_t xBytes;
+BaseType_t xCount;
+
+	for( xCount = 0; xCount < niTAP_RX_BATCH; xCount++ )
+	{
+		if( pxSpareBuffer != NULL )
+		{
+			pxNetworkBuffer = pxSpareBuffer;
+			pxSpareBuffer = NULL;
+		}
+		else
+		{
+			/* This is only an interrupt simulator, not a real interrupt, so
+			it is ok to call the task level function here. */
+			pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( ipTOTAL_ETHERNET_FRAME_SIZE, 0 );
+
+			if( pxNetworkBuffer == NULL )
+			{
+				/* Leave the frames in the queue of the TAP device, the host
+				will drop them when the queue overflows. */
+				iptraceETHERNET_RX_EVENT_LOST();
+				break;
+			}
+		}
+
+		/* Read the virtio-net header and the frame with a single call,
+		directly into the network buffer. */
+		xVector[ 0 ].iov_base = &xHeader;
+		xVector[ 0 ].iov_len = sizeof( xHeader );
+		xVector[ 1 ].iov_base = pxNetworkBuffer->pucEthernetBuffer;
+		xVector[ 1 ].iov_len = ipTOTAL_ETHERNET_FRAME_SIZE;
+
+		xBytes = readv( iQueueDescriptors[ iQueue ], xVector, 2 );
+
+		if( xBytes < ( ssize_t ) ( sizeof( xHeader ) + sizeof( EthernetHeader_t ) ) )
+		{
+			/* EAGAIN: the queue is empty.  Keep the buffer for the next read. */
+			pxSpareBuffer = pxNetworkBuffer;
+			break;
+		}
+
+		iptraceNETWORK_INTERFACE_RECEIVE();
+		pxNetworkBuffer->xDataLength = ( size_t ) xBytes - sizeof( xHeader );
+		iptraceDUMP_PACKET( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdTRUE );
+
+		if( ( xHeader.gso_type != VIRTIO_NET_HDR_GSO_NONE ) ||
+			( ipCONSIDER_FRAME_FOR_PROCESSING( pxNetworkBuffer->pucEthernetBuffer ) != eProcessBuffer ) ||
+			( prvCheckRxChecksum( &xHeader, pxNetworkBuffer ) != pdPASS ) )
+		{
+			ulRxDropped++;
+			pxSpareBuffer = pxNetworkBuffer;
+			continue;
+		}
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			pxNetworkBuffer->pxNextBuffer = NULL;
+
+			if( pxFirstDescriptor == NULL )
+			{
+				pxFirstDescriptor = pxNetworkBuffer;
+			}
+			else
+			{
+				pxLastDescriptor->pxNextBuffer = pxNetworkBuffer;
+			}
+
+			pxLastDescriptor = pxNetworkBuffer;
+		}
+		#else
+		{
+			prvPassEthMessages( pxNetworkBuffer );
+		}
+		#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+	}
+
+	return xCount;
+}
+
+/*!
+ * @brief FreeRTOS infinite loop task that simulates a network interrupt: it
+ *        reads batches of frames from all queues in turn
+ * @param [in] pvParameters not used
+ */
+static void prvInterruptSimulatorTask( void *pvParameters )
+{
+const TickType_t xPollDelay = ( pdMS_TO_TICKS( niTAP_RX_POLL_MS ) > 0U ) ? pdMS_TO_TICKS( niTAP_RX_POLL_MS ) : 1U;
+BaseType_t xQueue;
+BaseType_t xReceived;
+
+	/* Remove compiler warnings about unused parameters. */
+	( void ) pvParameters;
+
+	for( ; ; )
+	{
+		xReceived = 0;
+
+		for( xQueue = 0; xQueue < xQueueCount; xQueue++ )
+		{
+			xReceived += prvReadQueue( ( int ) xQueue );
+		}
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			/* All frames of this pass travel to the IP-task in one message. */
+			if( pxFirstDescriptor != NULL )
+			{
+				prvPassEthMessages( pxFirstDescriptor );
+				pxFirstDescriptor = NULL;
+				pxLastDescriptor = NULL;
+			}
+		}
+		#endif	/* ipconfigUSE_LINKED_RX_MESSAGES */
+
+		if( xReceived == 0 )
+		{
+			/* There is no real way of simulating an interrupt.  Make sure
+			other tasks can run. */
+			vTaskDelay( xPollDelay );
+		}
+	}
+}
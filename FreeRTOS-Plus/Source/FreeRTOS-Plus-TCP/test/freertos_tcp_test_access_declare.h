@@ -41,4 +41,66 @@ void TEST_FreeRTOS_TCP_prvCheckOptions( FreeRTOS_Socket_t * pxSocket,
 
 void TEST_FreeRTOS_TCP_prvTCPCreateWindow( FreeRTOS_Socket_t * pxSocket );
 
+#if ( ipconfigDNS_USE_ASYNC != 0 )
+    #include "FreeRTOS_DNS.h"
+
+    BaseType_t TEST_FreeRTOS_TCP_prvParseAnswers( const uint8_t * pucMessage,
+                                                  size_t uxLength,
+                                                  size_t uxOffset,
+                                                  uint16_t usAnswers,
+                                                  uint16_t usType,
+                                                  DNSAnswer_t * pxAnswers,
+                                                  BaseType_t xMaxAnswers );
+
+/* The state of an outstanding query of the asynchronous resolver. */
+    typedef struct xDNS_TEST_QUERY
+    {
+        uint16_t usIdentifier; /* The DNS identifier, as it is copied to the message. */
+        BaseType_t xAttempts;  /* The number of times that the query was sent. */
+        BaseType_t xServers;   /* The number of servers that may still answer. */
+        BaseType_t xWaiters;   /* The number of look-ups that wait for the answer. */
+    } DNSTestQuery_t;
+
+    BaseType_t TEST_FreeRTOS_TCP_xDNSTestBegin( uint32_t ulServerAddress,
+                                                const uint32_t * pulExtraServers,
+                                                BaseType_t xCount );
+
+    void TEST_FreeRTOS_TCP_vDNSTestEnd( void );
+
+    BaseType_t TEST_FreeRTOS_TCP_xDNSGetQuery( const char * pcName,
+                                               uint16_t usType,
+                                               DNSTestQuery_t * pxInfo );
+
+    void TEST_FreeRTOS_TCP_prvResolverReceive( void * pvData,
+                                               size_t uxLength,
+                                               const struct freertos_sockaddr * pxFrom );
+#endif
+
+#if ( ipconfigUSE_DHCP != 0 )
+    #include "FreeRTOS_DHCP.h"
+
+    void TEST_FreeRTOS_TCP_vDHCPTestBegin( eDHCPState_t eState,
+                                           BaseType_t xInitReboot,
+                                           uint32_t ulServerAddress );
+
+    void TEST_FreeRTOS_TCP_vDHCPTestEnd( void );
+
+    void TEST_FreeRTOS_TCP_vDHCPGetData( DHCPData_t * pxData );
+
+    BaseType_t TEST_FreeRTOS_TCP_prvProcessDHCPReplies( BaseType_t xExpectedMessageType );
+#endif
+
+#if ( ipconfigUSE_IPv6 != 0 )
+    #include "FreeRTOS_ARP.h"
+    #include "FreeRTOS_IPv6.h"
+
+    void TEST_FreeRTOS_TCP_vIPv6TestBegin( void );
+
+    void TEST_FreeRTOS_TCP_vIPv6TestEnd( void );
+
+    void TEST_FreeRTOS_TCP_vNDTestBegin( void );
+
+    void TEST_FreeRTOS_TCP_vNDTestEnd( void );
+#endif
+
 #endif /* ifndef _FREERTOS_TCP_TEST_ACCESS_DECLARE_H_ */
@@ -0,0 +1,90 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file freertos_tcp_test_access_dhcp_define.h
+ * @brief Function wrappers that access private methods in FreeRTOS_DHCP.c.
+ *
+ * Needed for testing private functions.
+ */
+
+#ifndef _FREERTOS_TCP_TEST_ACCESS_DHCP_DEFINE_H_
+#define _FREERTOS_TCP_TEST_ACCESS_DHCP_DEFINE_H_
+
+#include "freertos_tcp_test_access_declare.h"
+
+#if ( ipconfigUSE_DHCP != 0 )
+
+/* The state of the DHCP client before a test took it over. */
+    static DHCPData_t xTestSavedDHCPData;
+    static BaseType_t xTestCreatedDHCPSocket;
+
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vDHCPTestBegin( eDHCPState_t eState,
+                                           BaseType_t xInitReboot,
+                                           uint32_t ulServerAddress )
+    {
+        ( void ) memcpy( &( xTestSavedDHCPData ), &( EP_DHCPData ), sizeof( xTestSavedDHCPData ) );
+
+        EP_DHCPData.eDHCPState = eState;
+        EP_DHCPData.xInitReboot = xInitReboot;
+        EP_DHCPData.xRapidCommit = pdFALSE;
+        EP_DHCPData.ulDHCPServerAddress = ulServerAddress;
+        EP_DHCPData.ulOfferedIPAddress = 0UL;
+        EP_DHCPData.ulLeaseTime = 0UL;
+        ( void ) xApplicationGetRandomNumber( &( EP_DHCPData.ulTransactionId ) );
+
+        xTestCreatedDHCPSocket = ( xDHCPSocket == NULL ) ? pdTRUE : pdFALSE;
+        prvCreateDHCPSocket();
+    }
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vDHCPTestEnd( void )
+    {
+        if( xTestCreatedDHCPSocket != pdFALSE )
+        {
+            prvCloseDHCPSocket();
+        }
+
+        ( void ) memcpy( &( EP_DHCPData ), &( xTestSavedDHCPData ), sizeof( EP_DHCPData ) );
+    }
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vDHCPGetData( DHCPData_t * pxData )
+    {
+        ( void ) memcpy( pxData, &( EP_DHCPData ), sizeof( *pxData ) );
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t TEST_FreeRTOS_TCP_prvProcessDHCPReplies( BaseType_t xExpectedMessageType )
+    {
+        return prvProcessDHCPReplies( xExpectedMessageType );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_DHCP != 0 */
+
+#endif /* ifndef _FREERTOS_TCP_TEST_ACCESS_DHCP_DEFINE_H_ */
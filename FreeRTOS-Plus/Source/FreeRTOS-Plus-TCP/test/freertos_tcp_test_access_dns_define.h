@@ -45,4 +45,91 @@ uint32_t TEST_FreeRTOS_TCP_prvParseDNSReply( uint8_t * pucUDPPayloadBuffer,
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigDNS_USE_ASYNC != 0 )
+    BaseType_t TEST_FreeRTOS_TCP_prvParseAnswers( const uint8_t * pucMessage,
+                                                  size_t uxLength,
+                                                  size_t uxOffset,
+                                                  uint16_t usAnswers,
+                                                  uint16_t usType,
+                                                  DNSAnswer_t * pxAnswers,
+                                                  BaseType_t xMaxAnswers )
+    {
+        return prvParseAnswers( pucMessage, uxLength, uxOffset, usAnswers, usType, pxAnswers, xMaxAnswers );
+    }
+/*-----------------------------------------------------------*/
+
+/* The DNS servers of the resolver before a test took them over. */
+    static uint32_t ulTestSavedDNSServer;
+    static uint32_t ulTestSavedExtraDNSServers[ ipconfigDNS_MAX_SERVERS ];
+
+/*-----------------------------------------------------------*/
+
+    BaseType_t TEST_FreeRTOS_TCP_xDNSTestBegin( uint32_t ulServerAddress,
+                                                const uint32_t * pulExtraServers,
+                                                BaseType_t xCount )
+    {
+        ulTestSavedDNSServer = xNetworkAddressing.ulDNSServerAddress;
+        ( void ) memcpy( ulTestSavedExtraDNSServers, ulExtraDNSServers, sizeof( ulTestSavedExtraDNSServers ) );
+
+        xNetworkAddressing.ulDNSServerAddress = ulServerAddress;
+        FreeRTOS_dnsservers( pulExtraServers, xCount );
+
+        /* The resolver socket is created when the network goes up. */
+        return ( xResolverSocket != NULL ) ? pdPASS : pdFAIL;
+    }
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vDNSTestEnd( void )
+    {
+        xNetworkAddressing.ulDNSServerAddress = ulTestSavedDNSServer;
+        ( void ) memcpy( ulExtraDNSServers, ulTestSavedExtraDNSServers, sizeof( ulExtraDNSServers ) );
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t TEST_FreeRTOS_TCP_xDNSGetQuery( const char * pcName,
+                                               uint16_t usType,
+                                               DNSTestQuery_t * pxInfo )
+    {
+        DNSQuery_t * pxQuery;
+        BaseType_t xIndex;
+        BaseType_t xReturn = pdFALSE;
+
+        ( void ) memset( pxInfo, 0, sizeof( *pxInfo ) );
+
+        vTaskSuspendAll();
+        {
+            pxQuery = prvFindQueryByName( pcName, usType );
+
+            if( pxQuery != NULL )
+            {
+                pxInfo->usIdentifier = ( uint16_t ) listGET_LIST_ITEM_VALUE( &( pxQuery->xListItem ) );
+                pxInfo->xAttempts = pxQuery->xAttempts;
+                pxInfo->xWaiters = ( BaseType_t ) listCURRENT_LIST_LENGTH( &( pxQuery->xWaiterList ) );
+
+                for( xIndex = 0; xIndex < ( BaseType_t ) dnsASYNC_SERVER_COUNT; xIndex++ )
+                {
+                    if( pxQuery->ulServers[ xIndex ] != 0UL )
+                    {
+                        pxInfo->xServers++;
+                    }
+                }
+
+                xReturn = pdTRUE;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_prvResolverReceive( void * pvData,
+                                               size_t uxLength,
+                                               const struct freertos_sockaddr * pxFrom )
+    {
+        ( void ) prvResolverReceive( xResolverSocket, pvData, uxLength, pxFrom, NULL );
+    }
+#endif /* if ( ipconfigDNS_USE_ASYNC != 0 ) */
+/*-----------------------------------------------------------*/
+
 #endif /* ifndef _AWS_FREERTOS_TCP_TEST_ACCESS_DNS_DEFINE_H_ */
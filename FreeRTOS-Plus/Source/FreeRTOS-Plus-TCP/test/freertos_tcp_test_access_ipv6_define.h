@@ -0,0 +1,93 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file freertos_tcp_test_access_ipv6_define.h
+ * @brief Function wrappers that access private methods in FreeRTOS_IPv6.c.
+ *
+ * Needed for testing private functions.
+ */
+
+#ifndef _FREERTOS_TCP_TEST_ACCESS_IPV6_DEFINE_H_
+#define _FREERTOS_TCP_TEST_ACCESS_IPV6_DEFINE_H_
+
+#include "freertos_tcp_test_access_declare.h"
+
+#if ( ipconfigUSE_IPv6 != 0 )
+
+/* The addresses and the router before a test took them over. */
+    static IPv6_Address_t xTestSavedGlobalAddress;
+    static BaseType_t xTestSavedHasGlobalAddress;
+    static UBaseType_t uxTestSavedPrefixLength;
+    static BaseType_t xTestSavedGlobalIsStatic;
+    static uint32_t ulTestSavedGlobalLifetime;
+    static IPv6_Address_t xTestSavedRouterAddress;
+    static BaseType_t xTestSavedHasRouter;
+    static BaseType_t xTestSavedRouterIsStatic;
+    static uint32_t ulTestSavedRouterLifetime;
+    static uint8_t ucTestSavedHopLimit;
+
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vIPv6TestBegin( void )
+    {
+        xTestSavedGlobalAddress = xIPv6GlobalAddress;
+        xTestSavedHasGlobalAddress = xIPv6HasGlobalAddress;
+        uxTestSavedPrefixLength = uxIPv6PrefixLength;
+        xTestSavedGlobalIsStatic = xIPv6GlobalIsStatic;
+        ulTestSavedGlobalLifetime = ulIPv6GlobalLifetime;
+        xTestSavedRouterAddress = xIPv6RouterAddress;
+        xTestSavedHasRouter = xIPv6HasRouter;
+        xTestSavedRouterIsStatic = xIPv6RouterIsStatic;
+        ulTestSavedRouterLifetime = ulIPv6RouterLifetime;
+        ucTestSavedHopLimit = ucIPv6HopLimit;
+
+        /* Start without a global address and without a router, as after
+         * vIPv6NetworkUp(). */
+        xIPv6HasGlobalAddress = pdFALSE;
+        xIPv6GlobalIsStatic = pdFALSE;
+        xIPv6HasRouter = pdFALSE;
+        xIPv6RouterIsStatic = pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vIPv6TestEnd( void )
+    {
+        xIPv6GlobalAddress = xTestSavedGlobalAddress;
+        xIPv6HasGlobalAddress = xTestSavedHasGlobalAddress;
+        uxIPv6PrefixLength = uxTestSavedPrefixLength;
+        xIPv6GlobalIsStatic = xTestSavedGlobalIsStatic;
+        ulIPv6GlobalLifetime = ulTestSavedGlobalLifetime;
+        xIPv6RouterAddress = xTestSavedRouterAddress;
+        xIPv6HasRouter = xTestSavedHasRouter;
+        xIPv6RouterIsStatic = xTestSavedRouterIsStatic;
+        ulIPv6RouterLifetime = ulTestSavedRouterLifetime;
+        ucIPv6HopLimit = ucTestSavedHopLimit;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_IPv6 != 0 */
+
+#endif /* ifndef _FREERTOS_TCP_TEST_ACCESS_IPV6_DEFINE_H_ */
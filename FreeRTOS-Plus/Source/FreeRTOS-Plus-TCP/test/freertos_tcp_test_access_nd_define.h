@@ -0,0 +1,59 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file freertos_tcp_test_access_nd_define.h
+ * @brief Function wrappers that access private methods in FreeRTOS_ND.c.
+ *
+ * Needed for testing private functions.
+ */
+
+#ifndef _FREERTOS_TCP_TEST_ACCESS_ND_DEFINE_H_
+#define _FREERTOS_TCP_TEST_ACCESS_ND_DEFINE_H_
+
+#include "freertos_tcp_test_access_declare.h"
+
+#if ( ipconfigUSE_IPv6 != 0 )
+
+/* The neighbour cache before a test added its neighbours. */
+    static NDCacheRow_t xTestSavedNDCache[ ipconfigND_CACHE_ENTRIES ];
+
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vNDTestBegin( void )
+    {
+        ( void ) memcpy( xTestSavedNDCache, xNDCache, sizeof( xTestSavedNDCache ) );
+    }
+/*-----------------------------------------------------------*/
+
+    void TEST_FreeRTOS_TCP_vNDTestEnd( void )
+    {
+        ( void ) memcpy( xNDCache, xTestSavedNDCache, sizeof( xNDCache ) );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_IPv6 != 0 */
+
+#endif /* ifndef _FREERTOS_TCP_TEST_ACCESS_ND_DEFINE_H_ */
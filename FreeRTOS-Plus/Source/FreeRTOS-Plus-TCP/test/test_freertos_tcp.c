@@ -30,10 +30,12 @@
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 #include "list.h"
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_IP_Private.h"
 #include "FreeRTOS_DNS.h"
+#include "NetworkBufferManagement.h"
 
 /* Test includes. */
 #include "unity_fixture.h"
@@ -62,12 +64,40 @@ TEST_GROUP_RUNNER( Full_FREERTOS_TCP )
     /* Run a parser test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, prvParseDnsResponse );
     RUN_TEST_CASE( Full_FREERTOS_TCP, ulDNSHandlePacket );
+    #if ( ipconfigDNS_USE_ASYNC != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, prvParseAnswers );
+
+        /* Asynchronous resolver tests, against a stub DNS server. */
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNSAsyncCoalescing );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNSAsyncRacingServers );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNSAsyncRetransmission );
+    #endif
 
     /* prvCheckOptions test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, prvCheckOptions );
 
     /* xProcessReceivedUDPPacket test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, UDPPacketLength );
+
+    /* DHCP client tests. */
+    #if ( ipconfigUSE_DHCP != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DHCPInitRebootAck );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DHCPInitRebootNak );
+        #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+            RUN_TEST_CASE( Full_FREERTOS_TCP, DHCPRapidCommit );
+        #endif
+    #endif
+
+    /* IPv6 tests, with frames from neighbours on the link. */
+    #if ( ipconfigUSE_IPv6 != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, IPv6NeighbourDiscovery );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, IPv6RouterAdvertisement );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, IPv6DuplicateAddress );
+        #if ( ipconfigREPLY_TO_INCOMING_PINGS == 1 )
+            RUN_TEST_CASE( Full_FREERTOS_TCP, IPv6EchoRequest );
+        #endif
+        RUN_TEST_CASE( Full_FREERTOS_TCP, IPv6TCPHandshake );
+    #endif
 }
 
 TEST( Full_FREERTOS_TCP, prvParseDnsResponse )
@@ -288,6 +318,366 @@ TEST( Full_FREERTOS_TCP, prvParseDnsResponse )
     /* End test. */
 }
 
+#if ( ipconfigDNS_USE_ASYNC != 0 )
+TEST( Full_FREERTOS_TCP, prvParseAnswers )
+{
+    /* A reply from a stub server to "_sip._udp.ex.org" SRV: a CNAME that
+     * must be skipped, a SRV record of which the target is compressed, and a
+     * SRV record with a pointer to itself. */
+    uint8_t ucSrvResponse[] =
+    {
+        0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00,
+        0x04, 0x5f, 0x73, 0x69, 0x70, 0x04, 0x5f, 0x75, 0x64, 0x70, 0x02, 0x65,
+        0x78, 0x03, 0x6f, 0x72, 0x67, 0x00, 0x00, 0x21, 0x00, 0x01,
+        /* 34: CNAME */
+        0xc0, 0x0c, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x02,
+        0xc0, 0x0c,
+        /* 48: SRV 10 5 5060 srv.ex.org */
+        0xc0, 0x0c, 0x00, 0x21, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x0c,
+        0x00, 0x0a, 0x00, 0x05, 0x13, 0xc4, 0x03, 0x73, 0x72, 0x76, 0xc0, 0x16,
+        /* 72: SRV with a target that points to itself */
+        0xc0, 0x0c, 0x00, 0x21, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x08,
+        0x00, 0x0a, 0x00, 0x05, 0x13, 0xc4, 0xc0, 0x5a
+    };
+    /* A reply for "v6.ex.org" AAAA, with a record of the wrong length. */
+    uint8_t ucAAAAResponse[] =
+    {
+        0x12, 0x35, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+        0x02, 0x76, 0x36, 0x02, 0x65, 0x78, 0x03, 0x6f, 0x72, 0x67, 0x00, 0x00,
+        0x1c, 0x00, 0x01,
+        /* 27 */
+        0xc0, 0x0c, 0x00, 0x1c, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x04,
+        0x01, 0x02, 0x03, 0x04,
+        0xc0, 0x0c, 0x00, 0x1c, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x10,
+        0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x01
+    };
+    DNSAnswer_t xAnswers[ 3 ];
+    BaseType_t xCount;
+
+    xCount = TEST_FreeRTOS_TCP_prvParseAnswers( ucSrvResponse, sizeof( ucSrvResponse ), 34, 3,
+                                                ipDNS_TYPE_SRV, xAnswers, 3 );
+    TEST_ASSERT_EQUAL( 1, xCount );
+    TEST_ASSERT_EQUAL_UINT16( 10, xAnswers[ 0 ].u.xService.usPriority );
+    TEST_ASSERT_EQUAL_UINT16( 5, xAnswers[ 0 ].u.xService.usWeight );
+    TEST_ASSERT_EQUAL_UINT16( 5060, xAnswers[ 0 ].u.xService.usPort );
+    TEST_ASSERT_EQUAL_UINT32( 256, xAnswers[ 0 ].ulTTL );
+    TEST_ASSERT_EQUAL_STRING( "srv.ex.org", xAnswers[ 0 ].u.xService.pcTarget );
+
+    /* A truncated message should fail gracefully. */
+    xCount = TEST_FreeRTOS_TCP_prvParseAnswers( ucSrvResponse, 70, 34, 3,
+                                                ipDNS_TYPE_SRV, xAnswers, 3 );
+    TEST_ASSERT_EQUAL( 0, xCount );
+
+    #if ( ipconfigUSE_IPv6 != 0 )
+        xCount = TEST_FreeRTOS_TCP_prvParseAnswers( ucAAAAResponse, sizeof( ucAAAAResponse ), 27, 2,
+                                                    ipDNS_TYPE_AAAA, xAnswers, 3 );
+        TEST_ASSERT_EQUAL( 1, xCount );
+        TEST_ASSERT_EQUAL_UINT8( 0x20, xAnswers[ 0 ].u.xIPv6Address.ucBytes[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT8( 0x01, xAnswers[ 0 ].u.xIPv6Address.ucBytes[ 15 ] );
+    #else
+        /* AAAA records are ignored without IPv6 support. */
+        xCount = TEST_FreeRTOS_TCP_prvParseAnswers( ucAAAAResponse, sizeof( ucAAAAResponse ), 27, 2,
+                                                    ipDNS_TYPE_AAAA, xAnswers, 3 );
+        TEST_ASSERT_EQUAL( 0, xCount );
+    #endif
+}
+
+/* The servers of the stub DNS server, and the addresses that it gives. */
+    #define testDNS_SERVER_1        FreeRTOS_inet_addr_quick( 192, 0, 2, 1 )
+    #define testDNS_SERVER_2        FreeRTOS_inet_addr_quick( 192, 0, 2, 2 )
+    #define testDNS_SERVER_3        FreeRTOS_inet_addr_quick( 192, 0, 2, 3 )
+    #define testDNS_OTHER_SERVER    FreeRTOS_inet_addr_quick( 192, 0, 2, 99 )
+    #define testDNS_ADDRESS_1       FreeRTOS_inet_addr_quick( 198, 51, 100, 1 )
+    #define testDNS_ADDRESS_3       FreeRTOS_inet_addr_quick( 198, 51, 100, 3 )
+
+/* DNS flags and response codes, see RFC 1035. */
+    #define testDNS_FLAGS_REPLY     ( 0x8180U )
+    #define testDNS_FLAG_TRUNCATED  ( 0x0200U )
+    #define testDNS_RCODE_SERVFAIL  ( 2U )
+
+/* The time that a look-up may wait for an answer, in ms. */
+    #define testDNS_TIMEOUT_MS      ( 5000U )
+
+/* What the call-backs of the resolver have been given. */
+    static BaseType_t xDNSResults;
+    static BaseType_t xDNSLastCount;
+    static uint32_t ulDNSLastAddress;
+    static void * pvDNSLastSearchID;
+    static BaseType_t xDNSEvents;
+    static uint32_t ulDNSEventAddress;
+
+    static void prvDNSResult( const char * pcName,
+                              void * pvSearchID,
+                              BaseType_t xCount,
+                              const DNSAnswer_t * pxAnswers )
+    {
+        ( void ) pcName;
+
+        xDNSResults++;
+        xDNSLastCount = xCount;
+        pvDNSLastSearchID = pvSearchID;
+        ulDNSLastAddress = ( xCount > 0 ) ? pxAnswers[ 0 ].u.ulIPAddress : 0UL;
+    }
+
+    static void prvDNSEvent( const char * pcName,
+                             void * pvSearchID,
+                             uint32_t ulIPAddress )
+    {
+        ( void ) pcName;
+        ( void ) pvSearchID;
+
+        xDNSEvents++;
+        ulDNSEventAddress = ulIPAddress;
+    }
+
+    static void prvDNSClearResults( void )
+    {
+        xDNSResults = 0;
+        xDNSLastCount = -1;
+        ulDNSLastAddress = 0UL;
+        pvDNSLastSearchID = NULL;
+        xDNSEvents = 0;
+        ulDNSEventAddress = 0UL;
+    }
+
+/*
+ * A stub DNS server.  It answers the outstanding A query for pcName as if the
+ * reply came from ulServer, and passes the reply to the receive handler of the
+ * resolver socket, the same path that a reply from the network takes.  An
+ * answer with ulAddress is added when it is not zero.  The handler normally
+ * runs in the IP-task, the scheduler is suspended so that the IP-task does not
+ * work on the query at the same time.  Returns pdFALSE when no query for
+ * pcName is outstanding.
+ */
+    static BaseType_t prvDNSServerReply( const char * pcName,
+                                         uint32_t ulServer,
+                                         uint16_t usFlags,
+                                         uint32_t ulAddress )
+    {
+        uint8_t ucMessage[ 160 ];
+        const uint8_t ucAnswer[] =
+        {
+            0xc0, 0x0c,             /* A pointer to the name in the question. */
+            0x00, 0x01, 0x00, 0x01, /* Type A, class IN. */
+            0x00, 0x00, 0x00, 0x3c, /* TTL of 60 seconds. */
+            0x00, 0x04              /* The length of the address. */
+        };
+        struct freertos_sockaddr xFrom;
+        DNSTestQuery_t xQuery;
+        const char * pcLabel = pcName;
+        size_t uxLength, uxIndex = 12U;
+        BaseType_t xReturn = pdFALSE;
+
+        ( void ) memset( ucMessage, 0, sizeof( ucMessage ) );
+
+        /* The question, a name encoded as a sequence of labels. */
+        while( *pcLabel != '\0' )
+        {
+            uxLength = strcspn( pcLabel, "." );
+            ucMessage[ uxIndex++ ] = ( uint8_t ) uxLength;
+            ( void ) memcpy( &( ucMessage[ uxIndex ] ), pcLabel, uxLength );
+            uxIndex += uxLength;
+            pcLabel += uxLength;
+
+            if( *pcLabel == '.' )
+            {
+                pcLabel++;
+            }
+        }
+
+        ucMessage[ uxIndex++ ] = 0U;
+        ucMessage[ uxIndex++ ] = 0U;
+        ucMessage[ uxIndex++ ] = ( uint8_t ) ipDNS_TYPE_A;
+        ucMessage[ uxIndex++ ] = 0U;
+        ucMessage[ uxIndex++ ] = 1U; /* Class IN. */
+
+        ucMessage[ 2 ] = ( uint8_t ) ( usFlags >> 8 );
+        ucMessage[ 3 ] = ( uint8_t ) usFlags;
+        ucMessage[ 5 ] = 1U; /* One question. */
+
+        if( ulAddress != 0UL )
+        {
+            ucMessage[ 7 ] = 1U; /* One answer. */
+            ( void ) memcpy( &( ucMessage[ uxIndex ] ), ucAnswer, sizeof( ucAnswer ) );
+            uxIndex += sizeof( ucAnswer );
+            ( void ) memcpy( &( ucMessage[ uxIndex ] ), &( ulAddress ), sizeof( ulAddress ) );
+            uxIndex += sizeof( ulAddress );
+        }
+
+        ( void ) memset( &( xFrom ), 0, sizeof( xFrom ) );
+        xFrom.sin_addr = ulServer;
+        xFrom.sin_port = FreeRTOS_htons( 53U );
+
+        vTaskSuspendAll();
+        {
+            if( TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) ) != pdFALSE )
+            {
+                ( void ) memcpy( ucMessage, &( xQuery.usIdentifier ), sizeof( xQuery.usIdentifier ) );
+                TEST_FreeRTOS_TCP_prvResolverReceive( ucMessage, uxIndex, &( xFrom ) );
+                xReturn = pdTRUE;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xReturn;
+    }
+
+/* Let the resolver ask the stub DNS server and two extra servers. */
+    static void prvDNSTestBegin( void )
+    {
+        const uint32_t ulExtraServers[] = { testDNS_SERVER_2, testDNS_SERVER_3 };
+        BaseType_t xResult;
+
+        prvDNSClearResults();
+
+        vTaskSuspendAll();
+        {
+            xResult = TEST_FreeRTOS_TCP_xDNSTestBegin( testDNS_SERVER_1, ulExtraServers, 2 );
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL_MESSAGE( pdPASS, xResult, "The resolver socket has not been created" );
+    }
+
+    static void prvDNSTestEnd( void )
+    {
+        vTaskSuspendAll();
+        {
+            TEST_FreeRTOS_TCP_vDNSTestEnd();
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+    TEST( Full_FREERTOS_TCP, DNSAsyncCoalescing )
+    {
+        const char * pcName = "coalesce.freertos-test.invalid";
+        DNSTestQuery_t xQuery;
+        BaseType_t xResult;
+
+        prvDNSTestBegin();
+
+        /* Three look-ups of the same name, in any case, share one query. */
+        xResult = FreeRTOS_dnsquery_a( pcName, ipDNS_TYPE_A, prvDNSResult, ( void * ) 1, testDNS_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        xResult = FreeRTOS_dnsquery_a( "COALESCE.freertos-test.invalid", ipDNS_TYPE_A, prvDNSResult, ( void * ) 2, testDNS_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        ( void ) FreeRTOS_gethostbyname_a( pcName, prvDNSEvent, ( void * ) 3, testDNS_TIMEOUT_MS );
+
+        xResult = TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) );
+        TEST_ASSERT_EQUAL( pdTRUE, xResult );
+        TEST_ASSERT_EQUAL( 3, xQuery.xWaiters );
+        TEST_ASSERT_EQUAL( 1, xQuery.xAttempts );
+
+        /* A query of another type is not shared. */
+        xResult = TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_AAAA, &( xQuery ) );
+        TEST_ASSERT_EQUAL( pdFALSE, xResult );
+
+        /* One answer reaches all of them. */
+        xResult = prvDNSServerReply( pcName, testDNS_SERVER_1, testDNS_FLAGS_REPLY, testDNS_ADDRESS_1 );
+        TEST_ASSERT_EQUAL( pdTRUE, xResult );
+        TEST_ASSERT_EQUAL( 2, xDNSResults );
+        TEST_ASSERT_EQUAL( 1, xDNSLastCount );
+        TEST_ASSERT_EQUAL_UINT32( testDNS_ADDRESS_1, ulDNSLastAddress );
+        TEST_ASSERT_EQUAL( 1, xDNSEvents );
+        TEST_ASSERT_EQUAL_UINT32( testDNS_ADDRESS_1, ulDNSEventAddress );
+
+        xResult = TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) );
+        TEST_ASSERT_EQUAL( pdFALSE, xResult );
+
+        prvDNSTestEnd();
+    }
+
+    TEST( Full_FREERTOS_TCP, DNSAsyncRacingServers )
+    {
+        const char * pcName = "race.freertos-test.invalid";
+        DNSTestQuery_t xQuery;
+        BaseType_t xResult;
+
+        prvDNSTestBegin();
+
+        xResult = FreeRTOS_dnsquery_a( pcName, ipDNS_TYPE_A, prvDNSResult, ( void * ) 4, testDNS_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        ( void ) TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) );
+        TEST_ASSERT_EQUAL( 3, xQuery.xServers );
+
+        /* A server that fails only drops out of the race. */
+        ( void ) prvDNSServerReply( pcName, testDNS_SERVER_2, testDNS_FLAGS_REPLY | testDNS_RCODE_SERVFAIL, 0UL );
+        ( void ) TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) );
+        TEST_ASSERT_EQUAL( 2, xQuery.xServers );
+        TEST_ASSERT_EQUAL( 0, xDNSResults );
+
+        /* So does a server whose reply was truncated. */
+        ( void ) prvDNSServerReply( pcName, testDNS_SERVER_1, testDNS_FLAGS_REPLY | testDNS_FLAG_TRUNCATED, 0UL );
+        ( void ) TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) );
+        TEST_ASSERT_EQUAL( 1, xQuery.xServers );
+        TEST_ASSERT_EQUAL( 0, xDNSResults );
+
+        /* A server that was not asked is not heard. */
+        ( void ) prvDNSServerReply( pcName, testDNS_OTHER_SERVER, testDNS_FLAGS_REPLY, testDNS_ADDRESS_1 );
+        TEST_ASSERT_EQUAL( 0, xDNSResults );
+
+        /* The first answer wins, a later one is ignored. */
+        xResult = prvDNSServerReply( pcName, testDNS_SERVER_3, testDNS_FLAGS_REPLY, testDNS_ADDRESS_3 );
+        TEST_ASSERT_EQUAL( pdTRUE, xResult );
+        TEST_ASSERT_EQUAL( 1, xDNSResults );
+        TEST_ASSERT_EQUAL( 1, xDNSLastCount );
+        TEST_ASSERT_EQUAL_UINT32( testDNS_ADDRESS_3, ulDNSLastAddress );
+        TEST_ASSERT_EQUAL_PTR( ( void * ) 4, pvDNSLastSearchID );
+
+        xResult = prvDNSServerReply( pcName, testDNS_SERVER_1, testDNS_FLAGS_REPLY, testDNS_ADDRESS_1 );
+        TEST_ASSERT_EQUAL( pdFALSE, xResult );
+        TEST_ASSERT_EQUAL( 1, xDNSResults );
+
+        prvDNSTestEnd();
+    }
+
+    TEST( Full_FREERTOS_TCP, DNSAsyncRetransmission )
+    {
+        const char * pcName = "silent.freertos-test.invalid";
+        DNSTestQuery_t xQuery;
+        TickType_t xStart, xBackOff = 0U;
+        BaseType_t xAttempts = 1;
+        BaseType_t xResult;
+
+        prvDNSTestBegin();
+
+        /* None of the servers answers: the query is sent again after a time
+         * that doubles for every attempt, until all attempts have been made.
+         * xBackOff is the least time between the first send and the attempt
+         * that is expected next. */
+        xStart = xTaskGetTickCount();
+        xResult = FreeRTOS_dnsquery_a( pcName, ipDNS_TYPE_A, prvDNSResult, ( void * ) 5, 0U );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        xBackOff = pdMS_TO_TICKS( ipconfigDNS_ASYNC_RETRY_MS );
+
+        while( ( xDNSResults == 0 ) && ( ( xTaskGetTickCount() - xStart ) < ( pdMS_TO_TICKS( ipconfigDNS_ASYNC_RETRY_MS ) << ( ipconfigDNS_REQUEST_ATTEMPTS + 1 ) ) ) )
+        {
+            vTaskDelay( pdMS_TO_TICKS( 20U ) );
+
+            if( ( TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) ) != pdFALSE ) &&
+                ( xQuery.xAttempts != xAttempts ) )
+            {
+                TEST_ASSERT_EQUAL( xAttempts + 1, xQuery.xAttempts );
+                TEST_ASSERT_TRUE( ( xTaskGetTickCount() - xStart ) >= xBackOff );
+                xBackOff += pdMS_TO_TICKS( ipconfigDNS_ASYNC_RETRY_MS ) << xAttempts;
+                xAttempts = xQuery.xAttempts;
+            }
+        }
+
+        /* The query failed once the last attempt had its time. */
+        TEST_ASSERT_EQUAL( ipconfigDNS_REQUEST_ATTEMPTS, xAttempts );
+        TEST_ASSERT_EQUAL( 1, xDNSResults );
+        TEST_ASSERT_EQUAL( 0, xDNSLastCount );
+        TEST_ASSERT_TRUE( ( xTaskGetTickCount() - xStart ) >= xBackOff );
+
+        xResult = TEST_FreeRTOS_TCP_xDNSGetQuery( pcName, ( uint16_t ) ipDNS_TYPE_A, &( xQuery ) );
+        TEST_ASSERT_EQUAL( pdFALSE, xResult );
+
+        prvDNSTestEnd();
+    }
+#endif /* if ( ipconfigDNS_USE_ASYNC != 0 ) */
+
 TEST( Full_FREERTOS_TCP, ulDNSHandlePacket )
 {
     NetworkBufferDescriptor_t xNetworkBuffer = { 0 };
@@ -367,3 +757,707 @@ TEST( Full_FREERTOS_TCP, UDPPacketLength )
     xReturn = xProcessReceivedUDPPacket( &xNetworkBuffer, usPort );
     TEST_ASSERT_EQUAL_UINT32( pdFAIL, xReturn );
 }
+
+#if ( ipconfigUSE_DHCP != 0 )
+
+/* The DHCP messages that the local DHCP server sends, see RFC 2131. */
+    #define testDHCP_MESSAGE_TYPE_OFFER    ( 2U )
+    #define testDHCP_MESSAGE_TYPE_ACK      ( 5U )
+    #define testDHCP_MESSAGE_TYPE_NACK     ( 6U )
+
+/* The fixed part of a DHCP message, including the magic cookie, followed by
+ * room for the options. */
+    #define testDHCP_MESSAGE_LENGTH        ( 240U )
+    #define testDHCP_OPTIONS_LENGTH        ( 32U )
+
+    #define testDHCP_SERVER_ADDRESS        FreeRTOS_inet_addr_quick( 10, 0, 77, 1 )
+    #define testDHCP_OTHER_SERVER_ADDRESS  FreeRTOS_inet_addr_quick( 10, 0, 77, 2 )
+    #define testDHCP_OFFERED_ADDRESS       FreeRTOS_inet_addr_quick( 10, 0, 77, 42 )
+    #define testDHCP_LEASE_SECONDS         ( 3600UL )
+
+/*
+ * A local DHCP server.  It answers the transaction that the DHCP client of the
+ * stack has open, and passes the reply to xProcessReceivedUDPPacket(), the same
+ * path that a reply from the network driver takes.  A Rapid Commit option
+ * (RFC 4039) is added when ucRapidCommitLength is not zero; its length is
+ * ucRapidCommitLength - 1, so that an option that unexpectedly carries data
+ * can be sent too.  The option comes before the server identifier and the
+ * lease time, which are only found when it is skipped correctly.
+ */
+    static BaseType_t prvDHCPServerReply( uint8_t ucMessageType,
+                                          uint8_t ucRapidCommitLength )
+    {
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        UDPPacket_t * pxUDPPacket;
+        DHCPData_t xDHCPData;
+        uint8_t * pucMessage;
+        uint8_t * pucOption;
+        uint32_t ulValue;
+        const uint8_t ucCookie[] = { 0x63, 0x82, 0x53, 0x63 };
+        const MACAddress_t xServerMAC = { { 0x02, 0x00, 0x00, 0x00, 0x4d, 0x01 } };
+        size_t uxLength = ipUDP_PAYLOAD_OFFSET_IPv4 + testDHCP_MESSAGE_LENGTH + testDHCP_OPTIONS_LENGTH;
+        BaseType_t xReturn = pdFAIL;
+
+        TEST_FreeRTOS_TCP_vDHCPGetData( &xDHCPData );
+        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxLength, 0U );
+
+        if( pxNetworkBuffer != NULL )
+        {
+            ( void ) memset( pxNetworkBuffer->pucEthernetBuffer, 0, uxLength );
+
+            pxUDPPacket = ( UDPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+            ( void ) memcpy( &( pxUDPPacket->xEthernetHeader.xDestinationAddress ), ipLOCAL_MAC_ADDRESS, sizeof( MACAddress_t ) );
+            ( void ) memcpy( &( pxUDPPacket->xEthernetHeader.xSourceAddress ), &( xServerMAC ), sizeof( MACAddress_t ) );
+            pxUDPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+            pxUDPPacket->xIPHeader.ucVersionHeaderLength = 0x45U; /* IPv4, 20-byte header. */
+            pxUDPPacket->xIPHeader.ucProtocol = ( uint8_t ) ipPROTOCOL_UDP;
+            pxUDPPacket->xIPHeader.ulSourceIPAddress = testDHCP_SERVER_ADDRESS;
+            pxUDPPacket->xIPHeader.ulDestinationIPAddress = ipBROADCAST_IP_ADDRESS;
+            pxUDPPacket->xUDPHeader.usSourcePort = FreeRTOS_htons( 67U );
+            pxUDPPacket->xUDPHeader.usDestinationPort = FreeRTOS_htons( 68U );
+
+            pucMessage = &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] );
+            pucMessage[ 0 ] = 2U; /* BOOTREPLY */
+            pucMessage[ 1 ] = 1U; /* Ethernet */
+            pucMessage[ 2 ] = ( uint8_t ) sizeof( MACAddress_t );
+            ulValue = FreeRTOS_htonl( xDHCPData.ulTransactionId );
+            ( void ) memcpy( &( pucMessage[ 4 ] ), &( ulValue ), sizeof( ulValue ) );
+
+            if( ucMessageType != testDHCP_MESSAGE_TYPE_NACK )
+            {
+                ulValue = testDHCP_OFFERED_ADDRESS;
+                ( void ) memcpy( &( pucMessage[ 16 ] ), &( ulValue ), sizeof( ulValue ) );
+            }
+
+            ( void ) memcpy( &( pucMessage[ 28 ] ), ipLOCAL_MAC_ADDRESS, sizeof( MACAddress_t ) );
+            ( void ) memcpy( &( pucMessage[ 236 ] ), ucCookie, sizeof( ucCookie ) );
+
+            pucOption = &( pucMessage[ testDHCP_MESSAGE_LENGTH ] );
+            *( pucOption++ ) = 53U;
+            *( pucOption++ ) = 1U;
+            *( pucOption++ ) = ucMessageType;
+
+            if( ucRapidCommitLength != 0U )
+            {
+                *( pucOption++ ) = 80U;
+                *( pucOption++ ) = ucRapidCommitLength - 1U;
+                /* Data bytes that look like the start of another option. */
+                ( void ) memset( pucOption, 51, ucRapidCommitLength - 1U );
+                pucOption += ucRapidCommitLength - 1U;
+            }
+
+            *( pucOption++ ) = 54U;
+            *( pucOption++ ) = ( uint8_t ) sizeof( ulValue );
+            ulValue = testDHCP_SERVER_ADDRESS;
+            ( void ) memcpy( pucOption, &( ulValue ), sizeof( ulValue ) );
+            pucOption += sizeof( ulValue );
+
+            if( ucMessageType != testDHCP_MESSAGE_TYPE_NACK )
+            {
+                *( pucOption++ ) = 51U;
+                *( pucOption++ ) = ( uint8_t ) sizeof( ulValue );
+                ulValue = FreeRTOS_htonl( testDHCP_LEASE_SECONDS );
+                ( void ) memcpy( pucOption, &( ulValue ), sizeof( ulValue ) );
+                pucOption += sizeof( ulValue );
+            }
+
+            *pucOption = 0xffU;
+
+            pxNetworkBuffer->xDataLength = uxLength;
+            pxNetworkBuffer->ulIPAddress = testDHCP_SERVER_ADDRESS;
+            pxNetworkBuffer->usPort = FreeRTOS_htons( 67U );
+
+            xReturn = xProcessReceivedUDPPacket( pxNetworkBuffer, FreeRTOS_htons( 68U ) );
+
+            if( xReturn != pdPASS )
+            {
+                vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+            }
+        }
+
+        return xReturn;
+    }
+
+/*
+ * Let the DHCP client wait in state 'eState' for a reply of type
+ * 'xExpectedMessageType', have the local DHCP server send a message of type
+ * 'ucMessageType', and return what the client made of it.  The DHCP client
+ * normally runs in the IP-task, the scheduler is suspended so that the IP-task
+ * does not see the borrowed state nor consume the reply.  The state of the
+ * client is restored afterwards.
+ */
+    static BaseType_t prvDHCPExchange( eDHCPState_t eState,
+                                       BaseType_t xInitReboot,
+                                       uint32_t ulServerAddress,
+                                       uint8_t ucMessageType,
+                                       uint8_t ucRapidCommitLength,
+                                       BaseType_t xExpectedMessageType,
+                                       DHCPData_t * pxDHCPData )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        vTaskSuspendAll();
+        {
+            TEST_FreeRTOS_TCP_vDHCPTestBegin( eState, xInitReboot, ulServerAddress );
+
+            if( prvDHCPServerReply( ucMessageType, ucRapidCommitLength ) == pdPASS )
+            {
+                xReturn = TEST_FreeRTOS_TCP_prvProcessDHCPReplies( xExpectedMessageType );
+            }
+
+            TEST_FreeRTOS_TCP_vDHCPGetData( pxDHCPData );
+            TEST_FreeRTOS_TCP_vDHCPTestEnd();
+        }
+        ( void ) xTaskResumeAll();
+
+        return xReturn;
+    }
+
+    TEST( Full_FREERTOS_TCP, DHCPInitRebootAck )
+    {
+        DHCPData_t xDHCPData;
+        BaseType_t xResult;
+
+        /* A stored lease is confirmed without an offer, the server that answers
+         * takes the lease over. */
+        xResult = prvDHCPExchange( eWaitingAcknowledge, pdTRUE, testDHCP_OTHER_SERVER_ADDRESS,
+                                   testDHCP_MESSAGE_TYPE_ACK, 0U, testDHCP_MESSAGE_TYPE_ACK, &xDHCPData );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        TEST_ASSERT_EQUAL_UINT32( testDHCP_OFFERED_ADDRESS, xDHCPData.ulOfferedIPAddress );
+        TEST_ASSERT_EQUAL_UINT32( testDHCP_SERVER_ADDRESS, xDHCPData.ulDHCPServerAddress );
+        TEST_ASSERT_EQUAL_UINT32( ( testDHCP_LEASE_SECONDS / 2UL ) * configTICK_RATE_HZ, xDHCPData.ulLeaseTime );
+        TEST_ASSERT_EQUAL( eWaitingAcknowledge, xDHCPData.eDHCPState );
+
+        /* Outside INIT-REBOOT, an ACK from another server is ignored. */
+        xResult = prvDHCPExchange( eWaitingAcknowledge, pdFALSE, testDHCP_OTHER_SERVER_ADDRESS,
+                                   testDHCP_MESSAGE_TYPE_ACK, 0U, testDHCP_MESSAGE_TYPE_ACK, &xDHCPData );
+        TEST_ASSERT_EQUAL( pdFALSE, xResult );
+        TEST_ASSERT_EQUAL_UINT32( testDHCP_OTHER_SERVER_ADDRESS, xDHCPData.ulDHCPServerAddress );
+    }
+
+    TEST( Full_FREERTOS_TCP, DHCPInitRebootNak )
+    {
+        DHCPData_t xDHCPData;
+        BaseType_t xResult;
+
+        /* The device moved to another network: the stored address is refused
+         * and DHCP must start over with a DISCOVER. */
+        xResult = prvDHCPExchange( eWaitingAcknowledge, pdTRUE, 0UL,
+                                   testDHCP_MESSAGE_TYPE_NACK, 0U, testDHCP_MESSAGE_TYPE_ACK, &xDHCPData );
+        TEST_ASSERT_EQUAL( pdFALSE, xResult );
+        TEST_ASSERT_EQUAL( eWaitingSendFirstDiscover, xDHCPData.eDHCPState );
+        TEST_ASSERT_EQUAL_UINT32( 0UL, xDHCPData.ulOfferedIPAddress );
+    }
+
+    #if ( ipconfigDHCP_USE_RAPID_COMMIT != 0 )
+        TEST( Full_FREERTOS_TCP, DHCPRapidCommit )
+        {
+            DHCPData_t xDHCPData;
+            BaseType_t xResult;
+
+            /* An ACK with the Rapid Commit option answers a DISCOVER. */
+            xResult = prvDHCPExchange( eWaitingOffer, pdFALSE, 0UL,
+                                       testDHCP_MESSAGE_TYPE_ACK, 1U, testDHCP_MESSAGE_TYPE_OFFER, &xDHCPData );
+            TEST_ASSERT_EQUAL( pdPASS, xResult );
+            TEST_ASSERT_EQUAL( pdTRUE, xDHCPData.xRapidCommit );
+            TEST_ASSERT_EQUAL_UINT32( testDHCP_OFFERED_ADDRESS, xDHCPData.ulOfferedIPAddress );
+            TEST_ASSERT_EQUAL_UINT32( testDHCP_SERVER_ADDRESS, xDHCPData.ulDHCPServerAddress );
+            TEST_ASSERT_EQUAL_UINT32( ( testDHCP_LEASE_SECONDS / 2UL ) * configTICK_RATE_HZ, xDHCPData.ulLeaseTime );
+
+            /* Data in the option is skipped, the options that follow are still
+             * parsed. */
+            xResult = prvDHCPExchange( eWaitingOffer, pdFALSE, 0UL,
+                                       testDHCP_MESSAGE_TYPE_ACK, 3U, testDHCP_MESSAGE_TYPE_OFFER, &xDHCPData );
+            TEST_ASSERT_EQUAL( pdPASS, xResult );
+            TEST_ASSERT_EQUAL( pdTRUE, xDHCPData.xRapidCommit );
+            TEST_ASSERT_EQUAL_UINT32( ( testDHCP_LEASE_SECONDS / 2UL ) * configTICK_RATE_HZ, xDHCPData.ulLeaseTime );
+
+            /* An ACK without the option is not an answer to a DISCOVER. */
+            xResult = prvDHCPExchange( eWaitingOffer, pdFALSE, 0UL,
+                                       testDHCP_MESSAGE_TYPE_ACK, 0U, testDHCP_MESSAGE_TYPE_OFFER, &xDHCPData );
+            TEST_ASSERT_EQUAL( pdFALSE, xResult );
+
+            /* A server without Rapid Commit still makes an offer. */
+            xResult = prvDHCPExchange( eWaitingOffer, pdFALSE, 0UL,
+                                       testDHCP_MESSAGE_TYPE_OFFER, 0U, testDHCP_MESSAGE_TYPE_OFFER, &xDHCPData );
+            TEST_ASSERT_EQUAL( pdPASS, xResult );
+            TEST_ASSERT_EQUAL( pdFALSE, xDHCPData.xRapidCommit );
+        }
+    #endif /* ipconfigDHCP_USE_RAPID_COMMIT != 0 */
+
+#endif /* ipconfigUSE_DHCP != 0 */
+
+#if ( ipconfigUSE_IPv6 != 0 )
+
+/* The time that the IP-task gets to process a packet. */
+    #define testIPv6_PROCESS_MS         ( 50U )
+
+/* Neighbour discovery messages with another hop limit may have been forwarded
+ * by a router, see RFC 4861. */
+    #define testIPv6_ND_HOP_LIMIT       ( 255U )
+    #define testIPv6_HOP_LIMIT          ( 64U )
+
+    #define testIPv6_TCP_SERVER_PORT    ( 7180U )
+    #define testIPv6_TCP_CLIENT_PORT    ( 49180U )
+    #define testIPv6_TCP_CLIENT_ISN     ( 0x10000000UL )
+    #define testTCP_FLAG_SYN            ( 0x02U )
+    #define testTCP_FLAG_ACK            ( 0x10U )
+
+/* Neighbours on the local link, with the link-local addresses that they derive
+ * from their MAC addresses. */
+    static const MACAddress_t xTestNeighbourMAC = { { 0x02, 0x00, 0x00, 0x00, 0x36, 0x01 } };
+    static const MACAddress_t xTestOtherMAC = { { 0x02, 0x00, 0x00, 0x00, 0x36, 0x02 } };
+    static const MACAddress_t xTestRouterMAC = { { 0x02, 0x00, 0x00, 0x00, 0x36, 0x03 } };
+    static const IPv6_Address_t xTestNeighbourAddress = { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x36, 0x01 } };
+    static const IPv6_Address_t xTestOtherAddress = { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x36, 0x02 } };
+    static const IPv6_Address_t xTestRouterAddress = { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x36, 0x03 } };
+    static const IPv6_Address_t xTestAllNodesAddress = { { 0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01 } };
+
+/* The /64 prefix that the router advertises, from the documentation range
+ * 2001:db8::/32, and an address that is not on the link. */
+    static const IPv6_Address_t xTestPrefix = { { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x36, 0x00, 0x00, 0, 0, 0, 0, 0, 0, 0, 0 } };
+    static const IPv6_Address_t xTestRemoteAddress = { { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x99, 0x00, 0x00, 0, 0, 0, 0, 0, 0, 0, 0x01 } };
+
+/*
+ * Let the IPv6 tests take over the addresses, the router and the neighbour
+ * cache of the IP-task.  The test starts without a global address and without
+ * a router, as after vIPv6NetworkUp().  'pxLinkLocal' receives the link-local
+ * address of this node.
+ */
+    static void prvIPv6TestBegin( IPv6_Address_t * pxLinkLocal )
+    {
+        vTaskSuspendAll();
+        {
+            TEST_FreeRTOS_TCP_vIPv6TestBegin();
+            TEST_FreeRTOS_TCP_vNDTestBegin();
+        }
+        ( void ) xTaskResumeAll();
+
+        ( void ) FreeRTOS_GetIPv6Address( pxLinkLocal, NULL );
+    }
+
+    static void prvIPv6TestEnd( void )
+    {
+        vTaskSuspendAll();
+        {
+            TEST_FreeRTOS_TCP_vIPv6TestEnd();
+            TEST_FreeRTOS_TCP_vNDTestEnd();
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+/*
+ * Build an IPv6 packet from the neighbour at 'pxSourceMAC' to this node.
+ * 'pvPayload' is the ICMPv6 or TCP message of 'uxPayloadLength' bytes, its
+ * checksum is calculated here.  Returns NULL when there is no network buffer.
+ */
+    static NetworkBufferDescriptor_t * prvIPv6Packet( const MACAddress_t * pxSourceMAC,
+                                                      const IPv6_Address_t * pxSource,
+                                                      const IPv6_Address_t * pxDestination,
+                                                      uint8_t ucNextHeader,
+                                                      uint8_t ucHopLimit,
+                                                      const void * pvPayload,
+                                                      size_t uxPayloadLength )
+    {
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        IPPacket_IPv6_t * pxIPPacket;
+        size_t uxLength = sizeof( IPPacket_IPv6_t ) + uxPayloadLength;
+
+        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxLength, 0U );
+
+        if( pxNetworkBuffer != NULL )
+        {
+            pxIPPacket = ( IPPacket_IPv6_t * ) pxNetworkBuffer->pucEthernetBuffer;
+            ( void ) memset( pxIPPacket, 0, sizeof( *pxIPPacket ) );
+
+            if( xIPv6IsMulticast( pxDestination ) )
+            {
+                /* The MAC address of a group is 33:33 followed by the last 32
+                 * bits of its address. */
+                pxIPPacket->xEthernetHeader.xDestinationAddress.ucBytes[ 0 ] = 0x33U;
+                pxIPPacket->xEthernetHeader.xDestinationAddress.ucBytes[ 1 ] = 0x33U;
+                ( void ) memcpy( &( pxIPPacket->xEthernetHeader.xDestinationAddress.ucBytes[ 2 ] ), &( pxDestination->ucBytes[ 12 ] ), 4U );
+            }
+            else
+            {
+                ( void ) memcpy( &( pxIPPacket->xEthernetHeader.xDestinationAddress ), ipLOCAL_MAC_ADDRESS, sizeof( MACAddress_t ) );
+            }
+
+            ( void ) memcpy( &( pxIPPacket->xEthernetHeader.xSourceAddress ), pxSourceMAC, sizeof( MACAddress_t ) );
+            pxIPPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+            pxIPPacket->xIPHeader.ucVersionTrafficClass = 0x60U;
+            pxIPPacket->xIPHeader.usPayloadLength = FreeRTOS_htons( ( uint16_t ) uxPayloadLength );
+            pxIPPacket->xIPHeader.ucNextHeader = ucNextHeader;
+            pxIPPacket->xIPHeader.ucHopLimit = ucHopLimit;
+            pxIPPacket->xIPHeader.xSourceAddress = *pxSource;
+            pxIPPacket->xIPHeader.xDestinationAddress = *pxDestination;
+            ( void ) memcpy( &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) ] ), pvPayload, uxPayloadLength );
+
+            pxNetworkBuffer->xDataLength = uxLength;
+            ( void ) usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, uxLength, pdTRUE );
+        }
+
+        return pxNetworkBuffer;
+    }
+
+/*
+ * Pass an IPv6 packet to the IP-task, the same path that a packet from the
+ * network driver takes, and give the IP-task time to process it.  The replies
+ * of the IP-task go out through the network driver.
+ */
+    static BaseType_t prvIPv6Receive( const MACAddress_t * pxSourceMAC,
+                                      const IPv6_Address_t * pxSource,
+                                      const IPv6_Address_t * pxDestination,
+                                      uint8_t ucNextHeader,
+                                      uint8_t ucHopLimit,
+                                      const void * pvPayload,
+                                      size_t uxPayloadLength )
+    {
+        IPStackEvent_t xRxEvent;
+        BaseType_t xReturn = pdFAIL;
+
+        xRxEvent.eEventType = eNetworkRxEvent;
+        xRxEvent.pvData = prvIPv6Packet( pxSourceMAC, pxSource, pxDestination, ucNextHeader, ucHopLimit, pvPayload, uxPayloadLength );
+
+        if( xRxEvent.pvData != NULL )
+        {
+            xReturn = xSendEventStructToIPTask( &( xRxEvent ), 0U );
+
+            if( xReturn == pdPASS )
+            {
+                vTaskDelay( pdMS_TO_TICKS( testIPv6_PROCESS_MS ) );
+            }
+            else
+            {
+                vReleaseNetworkBufferAndDescriptor( ( NetworkBufferDescriptor_t * ) xRxEvent.pvData );
+            }
+        }
+
+        return xReturn;
+    }
+
+/*
+ * Fill in a neighbour solicitation or advertisement for 'pxTarget', with a
+ * link-layer address option of type 'ucOptionType', and return its length.
+ */
+    static size_t prvNDMessage( ICMPNeighbour_IPv6_t * pxMessage,
+                                uint8_t ucTypeOfMessage,
+                                uint32_t ulFlags,
+                                const IPv6_Address_t * pxTarget,
+                                uint8_t ucOptionType,
+                                const MACAddress_t * pxOptionMAC )
+    {
+        ( void ) memset( pxMessage, 0, sizeof( *pxMessage ) );
+        pxMessage->ucTypeOfMessage = ucTypeOfMessage;
+        pxMessage->ulFlags = FreeRTOS_htonl( ulFlags );
+        pxMessage->xTargetAddress = *pxTarget;
+        pxMessage->ucOptionType = ucOptionType;
+        pxMessage->ucOptionLength = 1U; /* In units of 8 bytes. */
+        ( void ) memcpy( pxMessage->ucOptionBytes, pxOptionMAC, sizeof( MACAddress_t ) );
+
+        return sizeof( *pxMessage );
+    }
+
+/*
+ * Let the router advertise itself as the default router, and the prefix
+ * xTestPrefix for stateless address autoconfiguration.
+ */
+    static BaseType_t prvRouterAdvertisement( void )
+    {
+        uint8_t ucMessage[ sizeof( ICMPRouterAdvertisement_IPv6_t ) + 8U + sizeof( NDPrefixOption_IPv6_t ) ];
+        ICMPRouterAdvertisement_IPv6_t * pxAdvertisement = ( ICMPRouterAdvertisement_IPv6_t * ) ucMessage;
+        uint8_t * pucOption = &( ucMessage[ sizeof( ICMPRouterAdvertisement_IPv6_t ) ] );
+        NDPrefixOption_IPv6_t * pxPrefix = ( NDPrefixOption_IPv6_t * ) &( ucMessage[ sizeof( ICMPRouterAdvertisement_IPv6_t ) + 8U ] );
+
+        ( void ) memset( ucMessage, 0, sizeof( ucMessage ) );
+        pxAdvertisement->ucTypeOfMessage = ipICMPv6_ROUTER_ADVERTISEMENT;
+        pxAdvertisement->ucHopLimit = testIPv6_HOP_LIMIT;
+        pxAdvertisement->usLifetime = FreeRTOS_htons( 1800U );
+
+        pucOption[ 0 ] = ipND_OPTION_SOURCE_LINK_LAYER;
+        pucOption[ 1 ] = 1U;
+        ( void ) memcpy( &( pucOption[ 2 ] ), &( xTestRouterMAC ), sizeof( MACAddress_t ) );
+
+        pxPrefix->ucType = ipND_OPTION_PREFIX_INFO;
+        pxPrefix->ucLength = ( uint8_t ) ( sizeof( NDPrefixOption_IPv6_t ) / 8U );
+        pxPrefix->ucPrefixLength = 64U;
+        pxPrefix->ucFlags = ipND_PREFIX_FLAG_AUTONOMOUS;
+        pxPrefix->ulValidLifeTime = FreeRTOS_htonl( 3600UL );
+        pxPrefix->ulPreferredLifeTime = FreeRTOS_htonl( 1800UL );
+        pxPrefix->xPrefix = xTestPrefix;
+
+        return prvIPv6Receive( &( xTestRouterMAC ), &( xTestRouterAddress ), &( xTestAllNodesAddress ),
+                               ipPROTOCOL_ICMP_IPv6, testIPv6_ND_HOP_LIMIT, ucMessage, sizeof( ucMessage ) );
+    }
+
+/*
+ * Look up 'pxAddress' in the neighbour cache, which belongs to the IP-task.
+ */
+    static eARPLookupResult_t prvNDLookup( const IPv6_Address_t * pxAddress,
+                                           MACAddress_t * pxMACAddress )
+    {
+        IPv6_Address_t xAddress = *pxAddress;
+        eARPLookupResult_t eResult;
+
+        vTaskSuspendAll();
+        {
+            eResult = eNDGetCacheEntry( &( xAddress ), pxMACAddress );
+        }
+        ( void ) xTaskResumeAll();
+
+        return eResult;
+    }
+
+    TEST( Full_FREERTOS_TCP, IPv6NeighbourDiscovery )
+    {
+        IPv6_Address_t xLinkLocal, xSolicitedNode;
+        ICMPNeighbour_IPv6_t xMessage;
+        MACAddress_t xMACAddress;
+        size_t uxLength;
+        BaseType_t xResult;
+
+        prvIPv6TestBegin( &( xLinkLocal ) );
+
+        /* A solicitation for our link-local address is sent to its
+         * solicited-node group, ff02::1:ffXX:XXXX.  The MAC address of the
+         * sender is learned from its option. */
+        ( void ) memset( &( xSolicitedNode ), 0, sizeof( xSolicitedNode ) );
+        xSolicitedNode.ucBytes[ 0 ] = 0xffU;
+        xSolicitedNode.ucBytes[ 1 ] = 0x02U;
+        xSolicitedNode.ucBytes[ 11 ] = 0x01U;
+        xSolicitedNode.ucBytes[ 12 ] = 0xffU;
+        ( void ) memcpy( &( xSolicitedNode.ucBytes[ 13 ] ), &( xLinkLocal.ucBytes[ 13 ] ), 3U );
+
+        uxLength = prvNDMessage( &( xMessage ), ipICMPv6_NEIGHBOUR_SOLICITATION, 0UL, &( xLinkLocal ),
+                                 ipND_OPTION_SOURCE_LINK_LAYER, &( xTestNeighbourMAC ) );
+        xResult = prvIPv6Receive( &( xTestNeighbourMAC ), &( xTestNeighbourAddress ), &( xSolicitedNode ),
+                                  ipPROTOCOL_ICMP_IPv6, testIPv6_ND_HOP_LIMIT, &( xMessage ), uxLength );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        TEST_ASSERT_EQUAL( eARPCacheHit, prvNDLookup( &( xTestNeighbourAddress ), &( xMACAddress ) ) );
+        TEST_ASSERT_EQUAL( 0, memcmp( &( xMACAddress ), &( xTestNeighbourMAC ), sizeof( xMACAddress ) ) );
+
+        /* An advertisement gives the MAC address of its target. */
+        uxLength = prvNDMessage( &( xMessage ), ipICMPv6_NEIGHBOUR_ADVERTISEMENT, ipND_FLAG_SOLICITED | ipND_FLAG_OVERRIDE,
+                                 &( xTestOtherAddress ), ipND_OPTION_TARGET_LINK_LAYER, &( xTestOtherMAC ) );
+        xResult = prvIPv6Receive( &( xTestOtherMAC ), &( xTestOtherAddress ), &( xLinkLocal ),
+                                  ipPROTOCOL_ICMP_IPv6, testIPv6_ND_HOP_LIMIT, &( xMessage ), uxLength );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        TEST_ASSERT_EQUAL( eARPCacheHit, prvNDLookup( &( xTestOtherAddress ), &( xMACAddress ) ) );
+        TEST_ASSERT_EQUAL( 0, memcmp( &( xMACAddress ), &( xTestOtherMAC ), sizeof( xMACAddress ) ) );
+
+        /* An advertisement that may have passed a router is ignored. */
+        uxLength = prvNDMessage( &( xMessage ), ipICMPv6_NEIGHBOUR_ADVERTISEMENT, ipND_FLAG_SOLICITED | ipND_FLAG_OVERRIDE,
+                                 &( xTestRouterAddress ), ipND_OPTION_TARGET_LINK_LAYER, &( xTestRouterMAC ) );
+        xResult = prvIPv6Receive( &( xTestRouterMAC ), &( xTestRouterAddress ), &( xLinkLocal ),
+                                  ipPROTOCOL_ICMP_IPv6, testIPv6_HOP_LIMIT, &( xMessage ), uxLength );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        TEST_ASSERT_EQUAL( eARPCacheMiss, prvNDLookup( &( xTestRouterAddress ), &( xMACAddress ) ) );
+
+        prvIPv6TestEnd();
+    }
+
+    TEST( Full_FREERTOS_TCP, IPv6RouterAdvertisement )
+    {
+        IPv6_Address_t xLinkLocal, xGlobal, xExpected, xNextHop;
+        MACAddress_t xMACAddress;
+        BaseType_t xResult;
+
+        prvIPv6TestBegin( &( xLinkLocal ) );
+
+        /* The global address is the advertised prefix followed by the
+         * interface ID of the link-local address. */
+        TEST_ASSERT_EQUAL( pdPASS, prvRouterAdvertisement() );
+        xResult = FreeRTOS_GetIPv6Address( NULL, &( xGlobal ) );
+        TEST_ASSERT_EQUAL( pdTRUE, xResult );
+        ( void ) memcpy( xExpected.ucBytes, xTestPrefix.ucBytes, 8U );
+        ( void ) memcpy( &( xExpected.ucBytes[ 8 ] ), &( xLinkLocal.ucBytes[ 8 ] ), 8U );
+        TEST_ASSERT_EQUAL( 0, memcmp( &( xGlobal ), &( xExpected ), sizeof( xGlobal ) ) );
+
+        /* The router became the default router, and its MAC address is known. */
+        xNextHop = xTestRemoteAddress;
+        vTaskSuspendAll();
+        {
+            xResult = xIPv6GetNextHop( &( xNextHop ) );
+        }
+        ( void ) xTaskResumeAll();
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        TEST_ASSERT_EQUAL( 0, memcmp( &( xNextHop ), &( xTestRouterAddress ), sizeof( xNextHop ) ) );
+        TEST_ASSERT_EQUAL( eARPCacheHit, prvNDLookup( &( xTestRouterAddress ), &( xMACAddress ) ) );
+        TEST_ASSERT_EQUAL( 0, memcmp( &( xMACAddress ), &( xTestRouterMAC ), sizeof( xMACAddress ) ) );
+        TEST_ASSERT_EQUAL( testIPv6_HOP_LIMIT, ucIPv6GetHopLimit() );
+
+        prvIPv6TestEnd();
+    }
+
+    TEST( Full_FREERTOS_TCP, IPv6DuplicateAddress )
+    {
+        IPv6_Address_t xLinkLocal, xGlobal;
+        ICMPNeighbour_IPv6_t xMessage;
+        size_t uxLength;
+        BaseType_t xResult;
+
+        prvIPv6TestBegin( &( xLinkLocal ) );
+
+        TEST_ASSERT_EQUAL( pdPASS, prvRouterAdvertisement() );
+        xResult = FreeRTOS_GetIPv6Address( NULL, &( xGlobal ) );
+        TEST_ASSERT_EQUAL( pdTRUE, xResult );
+
+        /* Another node defends the address that was made with SLAAC, which is
+         * given up. */
+        uxLength = prvNDMessage( &( xMessage ), ipICMPv6_NEIGHBOUR_ADVERTISEMENT, ipND_FLAG_OVERRIDE,
+                                 &( xGlobal ), ipND_OPTION_TARGET_LINK_LAYER, &( xTestOtherMAC ) );
+        xResult = prvIPv6Receive( &( xTestOtherMAC ), &( xTestOtherAddress ), &( xTestAllNodesAddress ),
+                                  ipPROTOCOL_ICMP_IPv6, testIPv6_ND_HOP_LIMIT, &( xMessage ), uxLength );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        TEST_ASSERT_EQUAL( pdFALSE, FreeRTOS_GetIPv6Address( NULL, NULL ) );
+
+        /* A static address is kept, the conflict can only be reported. */
+        FreeRTOS_SetIPv6Address( &( xGlobal ), 64U, NULL );
+        xResult = prvIPv6Receive( &( xTestOtherMAC ), &( xTestOtherAddress ), &( xTestAllNodesAddress ),
+                                  ipPROTOCOL_ICMP_IPv6, testIPv6_ND_HOP_LIMIT, &( xMessage ), uxLength );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+        TEST_ASSERT_EQUAL( pdTRUE, FreeRTOS_GetIPv6Address( NULL, NULL ) );
+
+        prvIPv6TestEnd();
+    }
+
+    #if ( ipconfigREPLY_TO_INCOMING_PINGS == 1 )
+        TEST( Full_FREERTOS_TCP, IPv6EchoRequest )
+        {
+            uint8_t ucRequest[ sizeof( ICMPHeader_t ) + 8U ] =
+            {
+                ipICMPv6_ECHO_REQUEST, 0x00, 0x00, 0x00, /* Type, code and checksum. */
+                0x12, 0x34, 0x00, 0x01,                  /* Identifier and sequence number. */
+                'F', 'r', 'e', 'e', 'R', 'T', 'O', 'S'
+            };
+            const IPv6_Address_t * pxDestinations[ 2 ];
+            NetworkBufferDescriptor_t * pxNetworkBuffer;
+            ICMPPacket_IPv6_t * pxICMPPacket;
+            IPv6_Address_t xLinkLocal;
+            eFrameProcessingResult_t eResult;
+            size_t x;
+
+            ( void ) FreeRTOS_GetIPv6Address( &( xLinkLocal ), NULL );
+
+            /* A request to our address, and one to the group of all nodes,
+             * are both answered from our link-local address. */
+            pxDestinations[ 0 ] = &( xLinkLocal );
+            pxDestinations[ 1 ] = &( xTestAllNodesAddress );
+
+            for( x = 0U; x < ( sizeof( pxDestinations ) / sizeof( pxDestinations[ 0 ] ) ); x++ )
+            {
+                pxNetworkBuffer = prvIPv6Packet( &( xTestNeighbourMAC ), &( xTestNeighbourAddress ), pxDestinations[ x ],
+                                                 ipPROTOCOL_ICMP_IPv6, testIPv6_HOP_LIMIT, ucRequest, sizeof( ucRequest ) );
+                TEST_ASSERT_TRUE( pxNetworkBuffer != NULL );
+
+                /* The reply is made in the same buffer, the caller would
+                 * return it to the sender. */
+                eResult = eProcessICMPv6Packet( pxNetworkBuffer );
+                TEST_ASSERT_EQUAL( eReturnEthernetFrame, eResult );
+
+                pxICMPPacket = ( ICMPPacket_IPv6_t * ) pxNetworkBuffer->pucEthernetBuffer;
+                TEST_ASSERT_EQUAL_UINT8( ipICMPv6_ECHO_REPLY, pxICMPPacket->xICMPHeader.ucTypeOfMessage );
+                TEST_ASSERT_EQUAL( 0, memcmp( &( pxICMPPacket->xIPHeader.xSourceAddress ), &( xLinkLocal ), sizeof( xLinkLocal ) ) );
+                TEST_ASSERT_EQUAL( 0, memcmp( &( pxICMPPacket->xIPHeader.xDestinationAddress ), &( xTestNeighbourAddress ), sizeof( xLinkLocal ) ) );
+                TEST_ASSERT_EQUAL( 0, memcmp( &( pxNetworkBuffer->pucEthernetBuffer[ sizeof( IPPacket_IPv6_t ) + 4U ] ), &( ucRequest[ 4 ] ), sizeof( ucRequest ) - 4U ) );
+
+                #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                    TEST_ASSERT_EQUAL_UINT16( 0xffffU, usGenerateProtocolChecksumIPv6( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength, pdFALSE ) );
+                #endif
+
+                vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+            }
+        }
+    #endif /* ipconfigREPLY_TO_INCOMING_PINGS == 1 */
+
+/*
+ * Fill in a TCP segment without options or data from the client at
+ * xTestNeighbourAddress to the server.
+ */
+    static void prvTCPSegment( TCPHeader_t * pxTCPHeader,
+                               uint8_t ucTCPFlags,
+                               uint32_t ulSequenceNumber,
+                               uint32_t ulAckNumber )
+    {
+        ( void ) memset( pxTCPHeader, 0, sizeof( *pxTCPHeader ) );
+        pxTCPHeader->usSourcePort = FreeRTOS_htons( testIPv6_TCP_CLIENT_PORT );
+        pxTCPHeader->usDestinationPort = FreeRTOS_htons( testIPv6_TCP_SERVER_PORT );
+        pxTCPHeader->ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+        pxTCPHeader->ulAckNr = FreeRTOS_htonl( ulAckNumber );
+        pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ipSIZE_OF_TCP_HEADER << 2 );
+        pxTCPHeader->ucTCPFlags = ucTCPFlags;
+        pxTCPHeader->usWindow = FreeRTOS_htons( 8192U );
+    }
+
+    TEST( Full_FREERTOS_TCP, IPv6TCPHandshake )
+    {
+        struct freertos_sockaddr6 xAddress;
+        socklen_t xAddressLength = sizeof( xAddress );
+        TickType_t xTimeout = pdMS_TO_TICKS( testIPv6_PROCESS_MS );
+        IPv6_Address_t xLinkLocal;
+        TCPHeader_t xTCPHeader;
+        FreeRTOS_Socket_t * pxChild;
+        Socket_t xServer, xClient;
+        uint8_t ucState = ( uint8_t ) eCLOSED;
+        uint32_t ulServerISN = 0UL;
+        BaseType_t xResult;
+
+        xServer = FreeRTOS_socket( FREERTOS_AF_INET6, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        TEST_ASSERT_TRUE( xServer != FREERTOS_INVALID_SOCKET );
+        ( void ) FreeRTOS_setsockopt( xServer, 0, FREERTOS_SO_RCVTIMEO, &( xTimeout ), sizeof( xTimeout ) );
+
+        ( void ) memset( &( xAddress ), 0, sizeof( xAddress ) );
+        xAddress.sin_len = ( uint8_t ) sizeof( xAddress );
+        xAddress.sin_family = FREERTOS_AF_INET6;
+        xAddress.sin_port = FreeRTOS_htons( testIPv6_TCP_SERVER_PORT );
+        xResult = FreeRTOS_bind( xServer, ( struct freertos_sockaddr * ) &( xAddress ), sizeof( xAddress ) );
+        TEST_ASSERT_EQUAL( 0, xResult );
+        xResult = FreeRTOS_listen( xServer, 1 );
+        TEST_ASSERT_EQUAL( 0, xResult );
+
+        prvIPv6TestBegin( &( xLinkLocal ) );
+
+        /* The SYN creates a socket, which answers with a SYN+ACK. */
+        prvTCPSegment( &( xTCPHeader ), testTCP_FLAG_SYN, testIPv6_TCP_CLIENT_ISN, 0UL );
+        xResult = prvIPv6Receive( &( xTestNeighbourMAC ), &( xTestNeighbourAddress ), &( xLinkLocal ),
+                                  ipPROTOCOL_TCP, testIPv6_HOP_LIMIT, &( xTCPHeader ), ipSIZE_OF_TCP_HEADER );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+
+        vTaskSuspendAll();
+        {
+            pxChild = pxTCPSocketLookup_IPv6( testIPv6_TCP_SERVER_PORT, &( xTestNeighbourAddress ), testIPv6_TCP_CLIENT_PORT );
+
+            if( pxChild != NULL )
+            {
+                ucState = pxChild->u.xTCP.ucTCPState;
+                ulServerISN = pxChild->u.xTCP.xTCPWindow.tx.ulFirstSequenceNumber;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_TRUE( ( pxChild != NULL ) && ( pxChild != ( FreeRTOS_Socket_t * ) xServer ) );
+        TEST_ASSERT_EQUAL( eSYN_RECEIVED, ucState );
+
+        /* The ACK of the SYN+ACK completes the handshake. */
+        prvTCPSegment( &( xTCPHeader ), testTCP_FLAG_ACK, testIPv6_TCP_CLIENT_ISN + 1UL, ulServerISN + 1UL );
+        xResult = prvIPv6Receive( &( xTestNeighbourMAC ), &( xTestNeighbourAddress ), &( xLinkLocal ),
+                                  ipPROTOCOL_TCP, testIPv6_HOP_LIMIT, &( xTCPHeader ), ipSIZE_OF_TCP_HEADER );
+        TEST_ASSERT_EQUAL( pdPASS, xResult );
+
+        ( void ) memset( &( xAddress ), 0, sizeof( xAddress ) );
+        xClient = FreeRTOS_accept( xServer, ( struct freertos_sockaddr * ) &( xAddress ), &( xAddressLength ) );
+        TEST_ASSERT_EQUAL_PTR( pxChild, xClient );
+        TEST_ASSERT_EQUAL( pdTRUE, FreeRTOS_issocketconnected( xClient ) );
+        TEST_ASSERT_EQUAL( sizeof( xAddress ), xAddressLength );
+        TEST_ASSERT_EQUAL( FREERTOS_AF_INET6, xAddress.sin_family );
+        TEST_ASSERT_EQUAL_UINT16( FreeRTOS_htons( testIPv6_TCP_CLIENT_PORT ), xAddress.sin_port );
+        TEST_ASSERT_EQUAL( 0, memcmp( &( xAddress.sin_addr6 ), &( xTestNeighbourAddress ), sizeof( xAddress.sin_addr6 ) ) );
+
+        ( void ) FreeRTOS_closesocket( xClient );
+        ( void ) FreeRTOS_closesocket( xServer );
+        vTaskDelay( pdMS_TO_TICKS( testIPv6_PROCESS_MS ) );
+
+        prvIPv6TestEnd();
+    }
+
+#endif /* ipconfigUSE_IPv6 != 0 */
@@ -0,0 +1,528 @@
+/*
+ * tcp_capture_ring.c
+ * Keeps the last ipconfigCAPTURE_RING_SLOTS Ethernet frames in memory, so
+ * that the traffic that led to a problem can be inspected after the fact.
+ * The contents of the ring can be exported as a pcapng file at any time,
+ * while capturing continues.
+ *
+ * Add this file to the project and define in FreeRTOSIPConfig.h:
+ *
+ *     #define ipconfigUSE_CAPTURE_RING		1
+ *
+ * The frames are passed by the network interface through the same macro
+ * iptraceDUMP_PACKET() that is used by tools/tcp_dump_packets.c.  When
+ * ipconfigUSE_DUMP_PACKETS is also defined, every frame is passed on to
+ * dump_packet() as well.
+ *
+ * Frames are copied into fixed-size slots, truncated to ipconfigCAPTURE_SNAPLEN
+ * bytes.  The slots are claimed with an atomic counter, so no lock is taken
+ * and the driver tasks and the IP-task may capture at the same time.  Every
+ * slot has a sequence number that works as a sequence lock: the exporter only
+ * uses a slot when its sequence number did not change while it was copied.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+#if defined( __linux__ ) || defined( _WIN32 )
+	#include <stdio.h>
+#endif
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "tcp_dump_packets.h"
+
+#if( ipconfigUSE_CAPTURE_RING != 0 )
+
+#if( ( ipconfigCAPTURE_RING_SLOTS & ( ipconfigCAPTURE_RING_SLOTS - 1 ) ) != 0 )
+	#error ipconfigCAPTURE_RING_SLOTS must be a power of 2
+#endif
+
+#if defined( __GNUC__ )
+	#define captureFETCH_AND_INCREMENT( pulValue )	__atomic_fetch_add( ( pulValue ), 1UL, __ATOMIC_RELAXED )
+	#define captureLOAD_ACQUIRE( pulValue )			__atomic_load_n( ( pulValue ), __ATOMIC_ACQUIRE )
+	#define captureLOAD_RELAXED( pulValue )			__atomic_load_n( ( pulValue ), __ATOMIC_RELAXED )
+	#define captureSTORE_RELEASE( pulValue, ulNew )	__atomic_store_n( ( pulValue ), ( ulNew ), __ATOMIC_RELEASE )
+	#define captureSTORE_RELAXED( pulValue, ulNew )	__atomic_store_n( ( pulValue ), ( ulNew ), __ATOMIC_RELAXED )
+	#define captureFENCE_ACQUIRE()					__atomic_thread_fence( __ATOMIC_ACQUIRE )
+	#define captureFENCE_RELEASE()					__atomic_thread_fence( __ATOMIC_RELEASE )
+#else
+	/* A single core without atomic builtins: the counter is incremented
+	within a critical section, the other accesses are plain volatile accesses. */
+	static uint32_t prvFetchAndIncrement( volatile uint32_t *pulValue )
+	{
+	uint32_t ulReturn;
+
+		taskENTER_CRITICAL();
+		{
+			ulReturn = *pulValue;
+			*pulValue = ulReturn + 1UL;
+		}
+		taskEXIT_CRITICAL();
+
+		return ulReturn;
+	}
+	#define captureFETCH_AND_INCREMENT( pulValue )	prvFetchAndIncrement( pulValue )
+	#define captureLOAD_ACQUIRE( pulValue )			( *( pulValue ) )
+	#define captureLOAD_RELAXED( pulValue )			( *( pulValue ) )
+	#define captureSTORE_RELEASE( pulValue, ulNew )	( *( pulValue ) = ( ulNew ) )
+	#define captureSTORE_RELAXED( pulValue, ulNew )	( *( pulValue ) = ( ulNew ) )
+	#define captureFENCE_ACQUIRE()
+	#define captureFENCE_RELEASE()
+#endif
+
+/* pcapng block types and constants. */
+#define capturePCAPNG_SECTION_HEADER	0x0A0D0D0AUL
+#define capturePCAPNG_INTERFACE			0x00000001UL
+#define capturePCAPNG_ENHANCED_PACKET	0x00000006UL
+#define capturePCAPNG_BYTE_ORDER_MAGIC	0x1A2B3C4DUL
+#define capturePCAPNG_LINKTYPE_ETHERNET	1U
+#define capturePCAPNG_OPT_EPB_FLAGS		2U
+#define capturePCAPNG_FLAG_INBOUND		0x00000001UL
+#define capturePCAPNG_FLAG_OUTBOUND		0x00000002UL
+
+/* The fixed part of an Enhanced Packet Block: type, length, interface,
+2 x time stamp, captured and original length.  It is followed by the data,
+the epb_flags option, the end-of-options marker and the length again. */
+#define capturePCAPNG_EPB_HEADER_SIZE	28U
+#define capturePCAPNG_EPB_TRAILER_SIZE	16U
+
+#define captureRING_MASK				( ( uint32_t ) ipconfigCAPTURE_RING_SLOTS - 1UL )
+
+typedef struct xCAPTURE_SLOT
+{
+	uint32_t ulSequence;		/* 0 while being written, otherwise the ticket + 1. */
+	uint32_t ulOriginalLength;
+	uint64_t ullTimeUs;
+	uint16_t usCapturedLength;
+	uint8_t ucIncoming;
+	uint8_t ucData[ ipconfigCAPTURE_SNAPLEN ];
+} CaptureSlot_t;
+
+static CaptureSlot_t xSlots[ ipconfigCAPTURE_RING_SLOTS ];
+
+/* The ticket of the next frame to be captured. */
+static uint32_t ulNextTicket = 0UL;
+
+/* Frames that were captured before the last call to vCaptureRingClear() are
+not exported. */
+static uint32_t ulFirstTicket = 0UL;
+
+/* The filters for the outgoing [ 0 ] and incoming [ 1 ] direction. */
+static const CaptureFilter_t * volatile pxFilters[ 2 ] = { NULL, NULL };
+
+/* Used by the exporter only. */
+static CaptureSlot_t xExportSlot;
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvLoad( const uint8_t *pucBuffer, size_t uxLength, uint32_t ulOffset,
+	size_t uxSize, uint32_t *pulValue )
+{
+BaseType_t xReturn = pdFAIL;
+uint32_t ulValue = 0UL;
+size_t uxIndex;
+
+	if( ( ( size_t ) ulOffset < uxLength ) && ( uxSize <= ( uxLength - ( size_t ) ulOffset ) ) )
+	{
+		for( uxIndex = 0U; uxIndex < uxSize; uxIndex++ )
+		{
+			ulValue = ( ulValue << 8 ) | ( uint32_t ) pucBuffer[ ( size_t ) ulOffset + uxIndex ];
+		}
+
+		*pulValue = ulValue;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Run a filter program that has been checked by prvFilterIsValid().  Returns
+the number of bytes to capture, 0 to reject the frame. */
+static uint32_t prvRunFilter( const CaptureFilter_t *pxFilter, const uint8_t *pucBuffer, size_t uxLength )
+{
+const CaptureInsn_t *pxInsn;
+size_t uxPC = 0U;
+uint32_t ulA = 0UL, ulX = 0UL, ulReturn = 0UL;
+BaseType_t xRunning = pdTRUE;
+BaseType_t xCondition;
+
+	while( ( xRunning != pdFALSE ) && ( uxPC < pxFilter->uxCount ) )
+	{
+		pxInsn = &( pxFilter->pxInstructions[ uxPC ] );
+		uxPC++;
+		xCondition = -1;
+
+		switch( pxInsn->ucOpcode )
+		{
+			case captureOP_LD_B:
+				xRunning = prvLoad( pucBuffer, uxLength, pxInsn->ulValue, 1U, &ulA );
+				break;
+			case captureOP_LD_H:
+				xRunning = prvLoad( pucBuffer, uxLength, pxInsn->ulValue, 2U, &ulA );
+				break;
+			case captureOP_LD_W:
+				xRunning = prvLoad( pucBuffer, uxLength, pxInsn->ulValue, 4U, &ulA );
+				break;
+			case captureOP_LD_B_IND:
+				xRunning = prvLoad( pucBuffer, uxLength, ulX + pxInsn->ulValue, 1U, &ulA );
+				break;
+			case captureOP_LD_H_IND:
+				xRunning = prvLoad( pucBuffer, uxLength, ulX + pxInsn->ulValue, 2U, &ulA );
+				break;
+			case captureOP_LD_W_IND:
+				xRunning = prvLoad( pucBuffer, uxLength, ulX + pxInsn->ulValue, 4U, &ulA );
+				break;
+			case captureOP_LDX_MSH:
+				xRunning = prvLoad( pucBuffer, uxLength, pxInsn->ulValue, 1U, &ulX );
+				ulX = ( ulX & 0x0FUL ) * 4UL;
+				break;
+			case captureOP_LD_LEN:
+				ulA = ( uint32_t ) uxLength;
+				break;
+			case captureOP_AND:
+				ulA &= pxInsn->ulValue;
+				break;
+			case captureOP_JEQ:
+				xCondition = ( ulA == pxInsn->ulValue ) ? 1 : 0;
+				break;
+			case captureOP_JGT:
+				xCondition = ( ulA > pxInsn->ulValue ) ? 1 : 0;
+				break;
+			case captureOP_JGE:
+				xCondition = ( ulA >= pxInsn->ulValue ) ? 1 : 0;
+				break;
+			case captureOP_JSET:
+				xCondition = ( ( ulA & pxInsn->ulValue ) != 0UL ) ? 1 : 0;
+				break;
+			default:	/* captureOP_RET */
+				ulReturn = pxInsn->ulValue;
+				xRunning = pdFALSE;
+				break;
+		}
+
+		if( xCondition > 0 )
+		{
+			uxPC += ( size_t ) pxInsn->ucJumpTrue;
+		}
+		else if( xCondition == 0 )
+		{
+			uxPC += ( size_t ) pxInsn->ucJumpFalse;
+		}
+		else
+		{
+			/* Not a jump. */
+		}
+	}
+
+	/* A load outside the frame stopped the program with ulReturn = 0. */
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvFilterIsValid( const CaptureFilter_t *pxFilter )
+{
+const CaptureInsn_t *pxInsn;
+size_t uxPC;
+BaseType_t xReturn = pdPASS;
+
+	if( ( pxFilter->pxInstructions == NULL ) || ( pxFilter->uxCount == 0U ) )
+	{
+		xReturn = pdFAIL;
+	}
+	else if( pxFilter->pxInstructions[ pxFilter->uxCount - 1U ].ucOpcode != captureOP_RET )
+	{
+		/* Every path must end with a return. */
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		for( uxPC = 0U; uxPC < pxFilter->uxCount; uxPC++ )
+		{
+			pxInsn = &( pxFilter->pxInstructions[ uxPC ] );
+
+			if( ( pxInsn->ucOpcode < captureOP_LD_B ) || ( pxInsn->ucOpcode > captureOP_RET ) )
+			{
+				xReturn = pdFAIL;
+			}
+			else if( ( pxInsn->ucOpcode >= captureOP_JEQ ) && ( pxInsn->ucOpcode <= captureOP_JSET ) )
+			{
+				/* Both targets must be within the program. */
+				if( ( ( uxPC + 1U + ( size_t ) pxInsn->ucJumpTrue ) >= pxFilter->uxCount ) ||
+					( ( uxPC + 1U + ( size_t ) pxInsn->ucJumpFalse ) >= pxFilter->uxCount ) )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+			else
+			{
+				/* Not a jump. */
+			}
+
+			if( xReturn == pdFAIL )
+			{
+				break;
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vCaptureRingPacket( const uint8_t *pucBuffer, size_t uxLength, BaseType_t xIncoming )
+{
+const CaptureFilter_t *pxFilter = pxFilters[ ( xIncoming != pdFALSE ) ? 1 : 0 ];
+uint32_t ulKeep = ( uint32_t ) ipconfigCAPTURE_SNAPLEN;
+uint32_t ulTicket;
+CaptureSlot_t *pxSlot;
+
+	#if( ipconfigUSE_DUMP_PACKETS != 0 )
+	{
+		dump_packet( pucBuffer, uxLength, xIncoming );
+	}
+	#endif
+
+	if( pxFilter != NULL )
+	{
+		ulKeep = prvRunFilter( pxFilter, pucBuffer, uxLength );
+	}
+
+	if( ulKeep != 0UL )
+	{
+		if( ulKeep > ( uint32_t ) ipconfigCAPTURE_SNAPLEN )
+		{
+			ulKeep = ( uint32_t ) ipconfigCAPTURE_SNAPLEN;
+		}
+
+		if( ( size_t ) ulKeep > uxLength )
+		{
+			ulKeep = ( uint32_t ) uxLength;
+		}
+
+		ulTicket = captureFETCH_AND_INCREMENT( &ulNextTicket );
+		pxSlot = &( xSlots[ ulTicket & captureRING_MASK ] );
+
+		/* Invalidate the slot before it is overwritten. */
+		captureSTORE_RELAXED( &( pxSlot->ulSequence ), 0UL );
+		captureFENCE_RELEASE();
+
+		pxSlot->ullTimeUs = ipconfigCAPTURE_TIME_US();
+		pxSlot->ulOriginalLength = ( uint32_t ) uxLength;
+		pxSlot->usCapturedLength = ( uint16_t ) ulKeep;
+		pxSlot->ucIncoming = ( xIncoming != pdFALSE ) ? 1U : 0U;
+		( void ) memcpy( pxSlot->ucData, pucBuffer, ( size_t ) ulKeep );
+
+		captureSTORE_RELEASE( &( pxSlot->ulSequence ), ulTicket + 1UL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCaptureRingSetFilter( BaseType_t xIncoming, const CaptureFilter_t *pxFilter )
+{
+BaseType_t xReturn = pdPASS;
+
+	if( pxFilter != NULL )
+	{
+		xReturn = prvFilterIsValid( pxFilter );
+	}
+
+	if( xReturn != pdFAIL )
+	{
+		pxFilters[ ( xIncoming != pdFALSE ) ? 1 : 0 ] = pxFilter;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vCaptureRingClear( void )
+{
+	ulFirstTicket = captureLOAD_ACQUIRE( &ulNextTicket );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWriteWords( CaptureWriteFunction_t pxWrite, void *pvContext,
+	const uint32_t *pulWords, size_t uxCount )
+{
+	return pxWrite( pvContext, pulWords, uxCount * sizeof( uint32_t ) );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWriteHeaders( CaptureWriteFunction_t pxWrite, void *pvContext )
+{
+uint32_t ulSectionHeader[ 7 ];
+uint32_t ulInterface[ 5 ];
+uint16_t usVersion[ 2 ] = { 1U, 0U };
+uint16_t usLinkType[ 2 ] = { capturePCAPNG_LINKTYPE_ETHERNET, 0U };
+BaseType_t xReturn;
+
+	/* pcapng is written in the byte order of the host, the reader detects it
+	with the byte order magic. */
+	ulSectionHeader[ 0 ] = capturePCAPNG_SECTION_HEADER;
+	ulSectionHeader[ 1 ] = sizeof( ulSectionHeader );
+	ulSectionHeader[ 2 ] = capturePCAPNG_BYTE_ORDER_MAGIC;
+	( void ) memcpy( &( ulSectionHeader[ 3 ] ), usVersion, sizeof( usVersion ) );
+	/* The length of the section is not known. */
+	ulSectionHeader[ 4 ] = 0xFFFFFFFFUL;
+	ulSectionHeader[ 5 ] = 0xFFFFFFFFUL;
+	ulSectionHeader[ 6 ] = sizeof( ulSectionHeader );
+
+	ulInterface[ 0 ] = capturePCAPNG_INTERFACE;
+	ulInterface[ 1 ] = sizeof( ulInterface );
+	( void ) memcpy( &( ulInterface[ 2 ] ), usLinkType, sizeof( usLinkType ) );
+	ulInterface[ 3 ] = ( uint32_t ) ipconfigCAPTURE_SNAPLEN;
+	ulInterface[ 4 ] = sizeof( ulInterface );
+
+	xReturn = prvWriteWords( pxWrite, pvContext, ulSectionHeader, sizeof( ulSectionHeader ) / sizeof( ulSectionHeader[ 0 ] ) );
+
+	if( xReturn != pdFAIL )
+	{
+		xReturn = prvWriteWords( pxWrite, pvContext, ulInterface, sizeof( ulInterface ) / sizeof( ulInterface[ 0 ] ) );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWritePacket( CaptureWriteFunction_t pxWrite, void *pvContext, const CaptureSlot_t *pxSlot )
+{
+uint32_t ulHeader[ capturePCAPNG_EPB_HEADER_SIZE / sizeof( uint32_t ) ];
+uint32_t ulTrailer[ capturePCAPNG_EPB_TRAILER_SIZE / sizeof( uint32_t ) ];
+uint32_t ulPadding = 0UL;
+size_t uxPadding = ( 4U - ( ( size_t ) pxSlot->usCapturedLength & 3U ) ) & 3U;
+uint32_t ulBlockLength = ( uint32_t ) ( capturePCAPNG_EPB_HEADER_SIZE + ( size_t ) pxSlot->usCapturedLength + uxPadding + capturePCAPNG_EPB_TRAILER_SIZE );
+uint16_t usOption[ 2 ] = { capturePCAPNG_OPT_EPB_FLAGS, 4U };
+BaseType_t xReturn;
+
+	ulHeader[ 0 ] = capturePCAPNG_ENHANCED_PACKET;
+	ulHeader[ 1 ] = ulBlockLength;
+	ulHeader[ 2 ] = 0UL;	/* Interface 0. */
+	ulHeader[ 3 ] = ( uint32_t ) ( pxSlot->ullTimeUs >> 32 );
+	ulHeader[ 4 ] = ( uint32_t ) ( pxSlot->ullTimeUs & 0xFFFFFFFFULL );
+	ulHeader[ 5 ] = ( uint32_t ) pxSlot->usCapturedLength;
+	ulHeader[ 6 ] = pxSlot->ulOriginalLength;
+
+	( void ) memcpy( &( ulTrailer[ 0 ] ), usOption, sizeof( usOption ) );
+	ulTrailer[ 1 ] = ( pxSlot->ucIncoming != 0U ) ? capturePCAPNG_FLAG_INBOUND : capturePCAPNG_FLAG_OUTBOUND;
+	ulTrailer[ 2 ] = 0UL;	/* opt_endofopt */
+	ulTrailer[ 3 ] = ulBlockLength;
+
+	xReturn = prvWriteWords( pxWrite, pvContext, ulHeader, sizeof( ulHeader ) / sizeof( ulHeader[ 0 ] ) );
+
+	if( xReturn != pdFAIL )
+	{
+		xReturn = pxWrite( pvContext, pxSlot->ucData, ( size_t ) pxSlot->usCapturedLength );
+	}
+
+	if( ( xReturn != pdFAIL ) && ( uxPadding != 0U ) )
+	{
+		xReturn = pxWrite( pvContext, &ulPadding, uxPadding );
+	}
+
+	if( xReturn != pdFAIL )
+	{
+		xReturn = prvWriteWords( pxWrite, pvContext, ulTrailer, sizeof( ulTrailer ) / sizeof( ulTrailer[ 0 ] ) );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCaptureRingExport( CaptureWriteFunction_t pxWrite, void *pvContext )
+{
+uint32_t ulEnd = captureLOAD_ACQUIRE( &ulNextTicket );
+uint32_t ulTicket = ulFirstTicket;
+const CaptureSlot_t *pxSlot;
+uint32_t ulSequence;
+BaseType_t xCount = 0;
+BaseType_t xReturn;
+
+	/* Only the last ipconfigCAPTURE_RING_SLOTS frames are still present. */
+	if( ( ulEnd - ulTicket ) > ( uint32_t ) ipconfigCAPTURE_RING_SLOTS )
+	{
+		ulTicket = ulEnd - ( uint32_t ) ipconfigCAPTURE_RING_SLOTS;
+	}
+
+	xReturn = prvWriteHeaders( pxWrite, pvContext );
+
+	while( ( xReturn != pdFAIL ) && ( ulTicket != ulEnd ) )
+	{
+		pxSlot = &( xSlots[ ulTicket & captureRING_MASK ] );
+
+		ulSequence = captureLOAD_ACQUIRE( &( pxSlot->ulSequence ) );
+
+		if( ulSequence == ( ulTicket + 1UL ) )
+		{
+			( void ) memcpy( &xExportSlot, pxSlot, sizeof( xExportSlot ) );
+			captureFENCE_ACQUIRE();
+
+			/* Skip the frame if it was overwritten during the copy. */
+			if( captureLOAD_RELAXED( &( pxSlot->ulSequence ) ) == ulSequence )
+			{
+				xReturn = prvWritePacket( pxWrite, pvContext, &xExportSlot );
+				xCount++;
+			}
+		}
+
+		ulTicket++;
+	}
+
+	if( xReturn == pdFAIL )
+	{
+		xCount = -1;
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+#if defined( __linux__ ) || defined( _WIN32 )
+
+	static BaseType_t prvWriteFile( void *pvContext, const void *pvData, size_t uxLength )
+	{
+	BaseType_t xReturn = pdPASS;
+
+		if( fwrite( pvData, 1U, uxLength, ( FILE * ) pvContext ) != uxLength )
+		{
+			xReturn = pdFAIL;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xCaptureRingSaveFile( const char *pcFileName )
+	{
+	FILE *pxFile;
+	BaseType_t xReturn = -1;
+
+		pxFile = fopen( pcFileName, "wb" );
+
+		if( pxFile != NULL )
+		{
+			xReturn = xCaptureRingExport( prvWriteFile, ( void * ) pxFile );
+
+			if( ( fclose( pxFile ) != 0 ) && ( xReturn >= 0 ) )
+			{
+				xReturn = -1;
+			}
+		}
+		else
+		{
+			FreeRTOS_printf( ( "xCaptureRingSaveFile: can not open %s\n", pcFileName ) );
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* defined( __linux__ ) || defined( _WIN32 ) */
+
+#endif /* ipconfigUSE_CAPTURE_RING != 0 */
@@ -0,0 +1,185 @@
+/*
+ * tcp_latency_stats.c
+ * Keeps histograms of the time that received packets spend in each stage of
+ * the stack: queued for the IP-task, processed by the IP-task, and waiting
+ * in a UDP socket until the application reads them.
+ *
+ * Add this file to the project and define in FreeRTOSIPConfig.h:
+ *
+ *     #define ipconfigUSE_LATENCY_STATS		1
+ *     #define ipconfigLATENCY_TIMER_VALUE()	ulGetCycleCounter()
+ *
+ * The timer must be safe to read from an interrupt, because the handoff stage
+ * is also entered from xSendEventStructToIPTaskFromISR().
+ *
+ * The time stamps are stored in the network buffer descriptor.  The stages
+ * are entered through the iptrace macros that are defined in
+ * tcp_latency_stats.h.  When ipconfigUSE_LATENCY_STATS is 0, the macros are
+ * empty and this module is not compiled.
+ *
+ * A histogram has a bucket for every power of 2, so the distribution of the
+ * latency is visible without storing individual samples.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+
+#if( ipconfigUSE_LATENCY_STATS != 0 )
+
+static LatencyHistogram_t xHistograms[ eLatencyStageCount ];
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGetTime( void )
+{
+uint32_t ulTime = ipconfigLATENCY_TIMER_VALUE();
+
+	/* The value 0 is used for 'no time stamp'. */
+	if( ulTime == 0UL )
+	{
+		ulTime = 1UL;
+	}
+
+	return ulTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddSample( eLatencyStage_t eStage, uint32_t ulValue )
+{
+LatencyHistogram_t *pxHistogram = &( xHistograms[ eStage ] );
+uint32_t ulRemaining = ulValue;
+BaseType_t xBucket = 0;
+
+	/* The bucket is the number of significant bits in the value. */
+	while( ulRemaining != 0UL )
+	{
+		ulRemaining >>= 1;
+		xBucket++;
+	}
+
+	/* The application stages are entered by any task. */
+	taskENTER_CRITICAL();
+	{
+		if( ( pxHistogram->ulSamples == 0UL ) || ( ulValue < pxHistogram->ulMinimum ) )
+		{
+			pxHistogram->ulMinimum = ulValue;
+		}
+
+		if( ulValue > pxHistogram->ulMaximum )
+		{
+			pxHistogram->ulMaximum = ulValue;
+		}
+
+		pxHistogram->ulSamples++;
+		pxHistogram->ullSum += ( uint64_t ) ulValue;
+		pxHistogram->ulBuckets[ xBucket ]++;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vTCPLatencyHandoff( NetworkBufferDescriptor_t *pxBuffer )
+{
+NetworkBufferDescriptor_t *pxNext = pxBuffer;
+uint32_t ulNow = prvGetTime();
+
+	/* With ipconfigUSE_LINKED_RX_MESSAGES, the driver may pass a chain of
+	buffers. */
+	while( pxNext != NULL )
+	{
+		pxNext->ulHandoffTime = ulNow;
+		pxNext->ulStageTime = ulNow;
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			pxNext = pxNext->pxNextBuffer;
+		}
+		#else
+		{
+			pxNext = NULL;
+		}
+		#endif
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTCPLatencyProcessing( NetworkBufferDescriptor_t *pxBuffer )
+{
+uint32_t ulNow;
+
+	if( pxBuffer->ulHandoffTime != 0UL )
+	{
+		ulNow = prvGetTime();
+		prvAddSample( eLatencyQueued, ulNow - pxBuffer->ulStageTime );
+		pxBuffer->ulStageTime = ulNow;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTCPLatencyDelivered( NetworkBufferDescriptor_t *pxBuffer )
+{
+uint32_t ulNow;
+
+	if( pxBuffer->ulHandoffTime != 0UL )
+	{
+		ulNow = prvGetTime();
+		prvAddSample( eLatencyProcessing, ulNow - pxBuffer->ulStageTime );
+		pxBuffer->ulStageTime = ulNow;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTCPLatencyReceived( NetworkBufferDescriptor_t *pxBuffer )
+{
+uint32_t ulNow;
+
+	if( pxBuffer->ulHandoffTime != 0UL )
+	{
+		ulNow = prvGetTime();
+		prvAddSample( eLatencyWaiting, ulNow - pxBuffer->ulStageTime );
+		prvAddSample( eLatencyTotal, ulNow - pxBuffer->ulHandoffTime );
+
+		/* This was the last stage. */
+		pxBuffer->ulHandoffTime = 0UL;
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTCPLatencyGetHistogram( eLatencyStage_t eStage, LatencyHistogram_t *pxHistogram )
+{
+BaseType_t xReturn = pdFAIL;
+
+	if( ( ( BaseType_t ) eStage >= 0 ) && ( eStage < eLatencyStageCount ) && ( pxHistogram != NULL ) )
+	{
+		taskENTER_CRITICAL();
+		{
+			( void ) memcpy( pxHistogram, &( xHistograms[ eStage ] ), sizeof( *pxHistogram ) );
+		}
+		taskEXIT_CRITICAL();
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTCPLatencyReset( void )
+{
+	taskENTER_CRITICAL();
+	{
+		( void ) memset( xHistograms, 0, sizeof( xHistograms ) );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_LATENCY_STATS != 0 */
@@ -29,8 +29,10 @@
     sized buffers which are used to store data from a given block (identified
     by both block number and volume number: this cache is shared among all
     volumes).  Block buffers may be either dirty or clean.  Most I/O passes
-    through this module.  When a buffer is needed for a block which is not in
-    the cache, a "victim" is selected via a simple LRU scheme.
+    through this module.  Buffers are found through a hash table keyed by
+    block number.  When a buffer is needed for a block which is not in the
+    cache, a "victim" is selected via a simple LRU scheme, kept as a linked
+    list so that it costs the same no matter how many buffers there are.
 */
 #include <redfs.h>
 #include <redcore.h>
@@ -104,10 +106,34 @@
 #define BBLK_INVALID UINT32_MAX
 
 
+/*  An invalid buffer index.  Used to terminate the LRU list and the hash
+    chains.
+*/
+#define BIDX_INVALID UINT16_MAX
+
+
+/*  Number of hash buckets used to find the buffer for a block.  With a bucket
+    for every buffer, the chains stay short enough that finding a block (or
+    learning that it is not buffered) takes about the same time regardless of
+    the number of buffers.
+*/
+#define BUFFER_HASH_BUCKETS REDCONF_BUFFER_COUNT
+
+
+/*  Number of blocks in the staging area, through which several buffers are
+    written, or read ahead, with a single request.
+*/
+#if (REDCONF_READ_ONLY == 0) && (REDCONF_BUFFER_WRITE_GATHER > REDCONF_READ_AHEAD)
+  #define BUFFER_STAGE_BLOCKS REDCONF_BUFFER_WRITE_GATHER
+#else
+  #define BUFFER_STAGE_BLOCKS REDCONF_READ_AHEAD
+#endif
+
+
 /** @brief Metadata stored for each block buffer.
 
-    To make better use of CPU caching when searching the BUFFERHEAD array, this
-    structure should be kept small.
+    To make better use of CPU caching when walking the hash chains and the LRU
+    list, this structure should be kept small.
 */
 typedef struct
 {
@@ -115,6 +141,9 @@ typedef struct
     uint8_t     bVolNum;    /**< Volume the block resides on. */
     uint8_t     bRefCount;  /**< Number of references. */
     uint16_t    uFlags;     /**< Buffer flags: mask of BFLAG_* values. */
+    uint16_t    uPrev;      /**< Next more recently used buffer; BIDX_INVALID if this is the MRU buffer. */
+    uint16_t    uNext;      /**< Next less recently used buffer; BIDX_INVALID if this is the LRU buffer. */
+    uint16_t    uHashNext;  /**< Next buffer in the same hash chain; BIDX_INVALID if last. */
 } BUFFERHEAD;
 
 
@@ -126,13 +155,25 @@ typedef struct
     */
     uint16_t    uNumUsed;
 
-    /** MRU array.  Each element of the array stores a buffer index; each buffer
-        index appears in the array once and only once.  The first element of the
-        array is the most-recently-used (MRU) buffer, followed by the next most
-        recently used, and so on, till the last element, which is the least-
-        recently-used (LRU) buffer.
+    /** Index of the most-recently-used (MRU) buffer.  The buffers form a
+        doubly-linked list through the uPrev and uNext members of their heads,
+        starting with the MRU buffer, followed by the next most recently used,
+        and so on, till the least-recently-used (LRU) buffer.  Each buffer,
+        valid or not, appears in the list once and only once.
+    */
+    uint16_t    uMRU;
+
+    /** Index of the least-recently-used (LRU) buffer: the other end of the
+        list which starts at uMRU.
+    */
+    uint16_t    uLRU;
+
+    /** Hash buckets.  Each stores the index of the first of a chain of buffers,
+        linked through the uHashNext members of their heads, whose volume and
+        block number hash to the bucket; or BIDX_INVALID if there are none.
+        Only valid buffers (ulBlock != BBLK_INVALID) are in a chain.
     */
-    uint8_t     abMRU[REDCONF_BUFFER_COUNT];
+    uint16_t    auHash[BUFFER_HASH_BUCKETS];
 
     /** Buffer heads, storing metadata for each buffer.
     */
@@ -144,18 +185,53 @@ typedef struct
         to cast buffer pointers to node structure pointers.
     */
     ALIGNED_2D_BYTE_ARRAY(b, aabBuffer, REDCONF_BUFFER_COUNT, REDCONF_BLOCK_SIZE);
+
+  #if (REDCONF_READ_ONLY == 0) && (REDCONF_BUFFER_WRITE_GATHER > 1U)
+    /** Indexes of the buffers being gathered into a single write.
+    */
+    uint16_t    auGather[REDCONF_BUFFER_WRITE_GATHER];
+  #endif
+
+  #if BUFFER_STAGE_BLOCKS > 1U
+    /** Staging area for consecutive blocks: dirty buffers are copied here so
+        that they can be written with one request, and blocks being read ahead
+        are read here with one request before being copied into buffers.
+    */
+    ALIGNED_2D_BYTE_ARRAY(s, aabStage, BUFFER_STAGE_BLOCKS, REDCONF_BLOCK_SIZE);
+  #endif
+
+  #if REDCONF_BUFFER_STATS == 1
+    /** Number of times RedBufferGet() found the block already buffered.
+    */
+    uint32_t    ulHits;
+
+    /** Number of times RedBufferGet() read the block from disk.
+    */
+    uint32_t    ulMisses;
+  #endif
 } BUFFERCTX;
 
 
 static bool BufferIsValid(const uint8_t  *pbBuffer, uint16_t uFlags);
-static bool BufferToIdx(const void *pBuffer, uint8_t *pbIdx);
+static bool BufferToIdx(const void *pBuffer, uint16_t *puIdx);
 #if REDCONF_READ_ONLY == 0
-static REDSTATUS BufferWrite(uint8_t bIdx);
+static bool BufferIsDirty(uint32_t ulBlock, uint16_t *puIdx);
+static REDSTATUS BufferWriteRun(uint16_t uIdx, uint32_t ulBlockEnd, bool fReferenced, uint32_t *pulBlocks);
+static REDSTATUS BufferWrite(uint16_t uIdx);
 static REDSTATUS BufferFinalize(uint8_t *pbBuffer, uint16_t uFlags);
 #endif
-static void BufferMakeLRU(uint8_t bIdx);
-static void BufferMakeMRU(uint8_t bIdx);
-static bool BufferFind(uint32_t ulBlock, uint8_t *pbIdx);
+static REDSTATUS BufferDiscard(uint16_t uIdx);
+static void BufferInvalidate(uint16_t uIdx);
+#if REDCONF_READ_AHEAD > 0U
+static uint16_t BufferVictim(uint16_t uIdx, uint32_t ulBlockStart, uint32_t ulBlockEnd);
+#endif
+static void BufferMakeLRU(uint16_t uIdx);
+static void BufferMakeMRU(uint16_t uIdx);
+static void BufferUnlink(uint16_t uIdx);
+static uint16_t BufferHashBucket(uint8_t bVolNum, uint32_t ulBlock);
+static void BufferHashInsert(uint16_t uIdx);
+static void BufferHashRemove(uint16_t uIdx);
+static bool BufferFind(uint32_t ulBlock, uint16_t *puIdx);
 
 #ifdef REDCONF_ENDIAN_SWAP
 static void BufferEndianSwap(const void *pBuffer, uint16_t uFlags);
@@ -174,18 +250,31 @@ static BUFFERCTX gBufCtx;
 */
 void RedBufferInit(void)
 {
-    uint8_t bIdx;
+    uint16_t uIdx;
 
     RedMemSet(&gBufCtx, 0U, sizeof(gBufCtx));
 
-    for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+    for(uIdx = 0U; uIdx < BUFFER_HASH_BUCKETS; uIdx++)
+    {
+        gBufCtx.auHash[uIdx] = BIDX_INVALID;
+    }
+
+    for(uIdx = 0U; uIdx < REDCONF_BUFFER_COUNT; uIdx++)
     {
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+
         /*  When the buffers have been freshly initialized, acquire the buffers
-            in the order in which they appear in the array.
+            in the order in which they appear in the array: the first buffer is
+            the LRU buffer and the last buffer is the MRU buffer.
         */
-        gBufCtx.abMRU[bIdx] = (uint8_t)((REDCONF_BUFFER_COUNT - bIdx) - 1U);
-        gBufCtx.aHead[bIdx].ulBlock = BBLK_INVALID;
+        pHead->uPrev = (uIdx == (REDCONF_BUFFER_COUNT - 1U)) ? BIDX_INVALID : (uint16_t)(uIdx + 1U);
+        pHead->uNext = (uIdx == 0U) ? BIDX_INVALID : (uint16_t)(uIdx - 1U);
+        pHead->uHashNext = BIDX_INVALID;
+        pHead->ulBlock = BBLK_INVALID;
     }
+
+    gBufCtx.uMRU = (uint16_t)(REDCONF_BUFFER_COUNT - 1U);
+    gBufCtx.uLRU = 0U;
 }
 
 
@@ -208,7 +297,7 @@ REDSTATUS RedBufferGet(
     void      **ppBuffer)
 {
     REDSTATUS   ret = 0;
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
     if((ulBlock >= gpRedVolume->ulBlockCount) || ((uFlags & BFLAG_MASK) != uFlags) || (ppBuffer == NULL))
     {
@@ -217,7 +306,7 @@ REDSTATUS RedBufferGet(
     }
     else
     {
-        if(BufferFind(ulBlock, &bIdx))
+        if(BufferFind(ulBlock, &uIdx))
         {
             /*  Error if the buffer exists and BFLAG_NEW was specified, since
                 the new flag is used when a block is newly allocated/created, so
@@ -228,11 +317,17 @@ REDSTATUS RedBufferGet(
                 was requested.
             */
             if(    ((uFlags & BFLAG_NEW) != 0U)
-                || ((uFlags & BFLAG_META_MASK) != (gBufCtx.aHead[bIdx].uFlags & BFLAG_META_MASK)))
+                || ((uFlags & BFLAG_META_MASK) != (gBufCtx.aHead[uIdx].uFlags & BFLAG_META_MASK)))
             {
                 CRITICAL_ERROR();
                 ret = -RED_EFUBAR;
             }
+          #if REDCONF_BUFFER_STATS == 1
+            else
+            {
+                gBufCtx.ulHits++;
+            }
+          #endif
         }
         else if(gBufCtx.uNumUsed == REDCONF_BUFFER_COUNT)
         {
@@ -244,26 +339,33 @@ REDSTATUS RedBufferGet(
         }
         else
         {
-            BUFFERHEAD *pHead;
-
             /*  Search for the least recently used buffer which is not
-                referenced.
+                referenced.  Referenced buffers were recently used, so this
+                usually stops at or near the LRU buffer.
             */
-            for(bIdx = (uint8_t)(REDCONF_BUFFER_COUNT - 1U); bIdx > 0U; bIdx--)
+            uIdx = gBufCtx.uLRU;
+            while((uIdx != BIDX_INVALID) && (gBufCtx.aHead[uIdx].bRefCount != 0U))
             {
-                if(gBufCtx.aHead[gBufCtx.abMRU[bIdx]].bRefCount == 0U)
-                {
-                    break;
-                }
+                uIdx = gBufCtx.aHead[uIdx].uPrev;
             }
 
-            bIdx = gBufCtx.abMRU[bIdx];
-            pHead = &gBufCtx.aHead[bIdx];
-
-            if(pHead->bRefCount == 0U)
+            if(uIdx == BIDX_INVALID)
+            {
+                /*  All the buffers are used, which should have been caught by
+                    checking gBufCtx.uNumUsed.
+                */
+                CRITICAL_ERROR();
+                ret = -RED_EBUSY;
+            }
+            else
             {
+                const BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+
                 /*  If the LRU buffer is valid and dirty, write it out before
-                    repurposing it.
+                    repurposing it.  Dirty buffers for the blocks which follow
+                    it are written along with it, since they are likely to be
+                    evicted soon as well; referenced buffers are left alone,
+                    since their owners may still be changing them.
                 */
                 if(((pHead->uFlags & BFLAG_DIRTY) != 0U) && (pHead->ulBlock != BBLK_INVALID))
                 {
@@ -271,39 +373,37 @@ REDSTATUS RedBufferGet(
                     CRITICAL_ERROR();
                     ret = -RED_EFUBAR;
                   #else
-                    ret = BufferWrite(bIdx);
+                    uint32_t ulBlocks;
+
+                    ret = BufferWriteRun(uIdx, gpRedVolume->ulBlockCount, false, &ulBlocks);
                   #endif
                 }
             }
-            else
-            {
-                /*  All the buffers are used, which should have been caught by
-                    checking gBufCtx.uNumUsed.
-                */
-                CRITICAL_ERROR();
-                ret = -RED_EBUSY;
-            }
 
             if(ret == 0)
             {
+                /*  Invalidate the LRU buffer.  If the read fails, we do not
+                    want the buffer head to continue to refer to the old block
+                    number, since the read, even if it fails, may have partially
+                    overwritten the buffer data (consider the case where block
+                    size exceeds sector size, and some but not all of the
+                    sectors are read successfully), and if the buffer were to be
+                    used subsequently with its partially erroneous contents, bad
+                    things could happen.
+                */
+                BufferInvalidate(uIdx);
+
                 if((uFlags & BFLAG_NEW) == 0U)
                 {
-                    /*  Invalidate the LRU buffer.  If the read fails, we do not
-                        want the buffer head to continue to refer to the old
-                        block number, since the read, even if it fails, may have
-                        partially overwritten the buffer data (consider the case
-                        where block size exceeds sector size, and some but not
-                        all of the sectors are read successfully), and if the
-                        buffer were to be used subsequently with its partially
-                        erroneous contents, bad things could happen.
-                    */
-                    pHead->ulBlock = BBLK_INVALID;
-
-                    ret = RedIoRead(gbRedVolNum, ulBlock, 1U, gBufCtx.b.aabBuffer[bIdx]);
+                  #if REDCONF_BUFFER_STATS == 1
+                    gBufCtx.ulMisses++;
+                  #endif
+
+                    ret = RedIoRead(gbRedVolNum, ulBlock, 1U, gBufCtx.b.aabBuffer[uIdx]);
 
                     if((ret == 0) && ((uFlags & BFLAG_META) != 0U))
                     {
-                        if(!BufferIsValid(gBufCtx.b.aabBuffer[bIdx], uFlags))
+                        if(!BufferIsValid(gBufCtx.b.aabBuffer[uIdx], uFlags))
                         {
                             /*  A corrupt metadata node is usually a critical
                                 error.  The master block is an exception since
@@ -319,21 +419,25 @@ REDSTATUS RedBufferGet(
                   #ifdef REDCONF_ENDIAN_SWAP
                     if(ret == 0)
                     {
-                        BufferEndianSwap(gBufCtx.b.aabBuffer[bIdx], uFlags);
+                        BufferEndianSwap(gBufCtx.b.aabBuffer[uIdx], uFlags);
                     }
                   #endif
                 }
                 else
                 {
-                    RedMemSet(gBufCtx.b.aabBuffer[bIdx], 0U, REDCONF_BLOCK_SIZE);
+                    RedMemSet(gBufCtx.b.aabBuffer[uIdx], 0U, REDCONF_BLOCK_SIZE);
                 }
             }
 
             if(ret == 0)
             {
+                BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+
                 pHead->bVolNum = gbRedVolNum;
                 pHead->ulBlock = ulBlock;
                 pHead->uFlags = 0U;
+
+                BufferHashInsert(uIdx);
             }
         }
 
@@ -344,7 +448,7 @@ REDSTATUS RedBufferGet(
         */
         if(ret == 0)
         {
-            BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+            BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
             pHead->bRefCount++;
 
@@ -359,9 +463,9 @@ REDSTATUS RedBufferGet(
             */
             pHead->uFlags |= (uFlags & (~BFLAG_NEW));
 
-            BufferMakeMRU(bIdx);
+            BufferMakeMRU(uIdx);
 
-            *ppBuffer = gBufCtx.b.aabBuffer[bIdx];
+            *ppBuffer = gBufCtx.b.aabBuffer[uIdx];
         }
     }
 
@@ -376,18 +480,18 @@ REDSTATUS RedBufferGet(
 void RedBufferPut(
     const void *pBuffer)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(!BufferToIdx(pBuffer, &bIdx))
+    if(!BufferToIdx(pBuffer, &uIdx))
     {
         REDERROR();
     }
     else
     {
-        REDASSERT(gBufCtx.aHead[bIdx].bRefCount > 0U);
-        gBufCtx.aHead[bIdx].bRefCount--;
+        REDASSERT(gBufCtx.aHead[uIdx].bRefCount > 0U);
+        gBufCtx.aHead[uIdx].bRefCount--;
 
-        if(gBufCtx.aHead[bIdx].bRefCount == 0U)
+        if(gBufCtx.aHead[uIdx].bRefCount == 0U)
         {
             REDASSERT(gBufCtx.uNumUsed > 0U);
             gBufCtx.uNumUsed--;
@@ -396,9 +500,160 @@ void RedBufferPut(
 }
 
 
+#if REDCONF_BUFFER_STATS == 1
+/** @brief Report how often RedBufferGet() found blocks already buffered.
+
+    The counts are for all volumes, since the buffers were initialized.  They
+    wrap around, so only the difference between two calls is meaningful.
+
+    @param pulHits      Populated with the number of times the block was found
+                        in a buffer.
+    @param pulMisses    Populated with the number of times the block was read
+                        from disk.  Newly allocated blocks, which are not read,
+                        are not counted; nor are blocks read ahead, which count
+                        as hits once they are used.
+*/
+void RedBufferStats(
+    uint32_t   *pulHits,
+    uint32_t   *pulMisses)
+{
+    REDASSERT((pulHits != NULL) && (pulMisses != NULL));
+
+    *pulHits = gBufCtx.ulHits;
+    *pulMisses = gBufCtx.ulMisses;
+}
+#endif
+
+
+#if REDCONF_READ_AHEAD > 0U
+/** @brief Read blocks into buffers ahead of their use.
+
+    Blocks which are not already buffered are read with as few requests as
+    possible, into buffers which are neither referenced nor dirty, so that
+    subsequent calls to RedBufferGet() for those blocks will not need to read
+    from disk.  Blocks for which there is no such buffer are not read ahead.
+
+    @param ulBlockStart First block number to read ahead.
+    @param ulBlockCount Number of blocks, starting at @p ulBlockStart, to read
+                        ahead.  Must not be zero or greater than
+                        ::REDCONF_READ_AHEAD.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL Invalid parameters.
+*/
+REDSTATUS RedBufferReadAhead(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockCount)
+{
+    REDSTATUS   ret = 0;
+
+    if(    (ulBlockStart >= gpRedVolume->ulBlockCount)
+        || ((gpRedVolume->ulBlockCount - ulBlockStart) < ulBlockCount)
+        || (ulBlockCount == 0U)
+        || (ulBlockCount > REDCONF_READ_AHEAD))
+    {
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint32_t    ulBlockEnd = ulBlockStart + ulBlockCount;
+        uint32_t    ulBlock = ulBlockStart;
+        uint16_t    uVictim = BufferVictim(gBufCtx.uLRU, ulBlockStart, ulBlockEnd);
+
+        while((ret == 0) && (ulBlock < ulBlockEnd) && (uVictim != BIDX_INVALID))
+        {
+            uint16_t    auIdx[REDCONF_READ_AHEAD];
+            uint32_t    ulRunLen = 0U;
+            uint32_t    ulRunIdx;
+            uint16_t    uIdx;
+
+            /*  Find the run of blocks which are not buffered, and a buffer for
+                each of them.  The run is cut short if there are not enough
+                buffers.
+            */
+            while(    ((ulBlock + ulRunLen) < ulBlockEnd)
+                   && (uVictim != BIDX_INVALID)
+                   && !BufferFind(ulBlock + ulRunLen, &uIdx))
+            {
+                auIdx[ulRunLen] = uVictim;
+                ulRunLen++;
+                uVictim = BufferVictim(gBufCtx.aHead[uVictim].uPrev, ulBlockStart, ulBlockEnd);
+            }
+
+            /*  See RedBufferGet() for why the buffers are invalidated before
+                they are read into.
+            */
+            for(ulRunIdx = 0U; ulRunIdx < ulRunLen; ulRunIdx++)
+            {
+                BufferInvalidate(auIdx[ulRunIdx]);
+            }
+
+          #if BUFFER_STAGE_BLOCKS > 1U
+            if(ulRunLen == 0U)
+            {
+                /*  The block is already buffered.
+                */
+            }
+            else if(ulRunLen > 1U)
+            {
+                ret = RedIoRead(gbRedVolNum, ulBlock, ulRunLen, gBufCtx.s.aabStage[0U]);
+
+                if(ret == 0)
+                {
+                    for(ulRunIdx = 0U; ulRunIdx < ulRunLen; ulRunIdx++)
+                    {
+                        RedMemCpy(gBufCtx.b.aabBuffer[auIdx[ulRunIdx]], gBufCtx.s.aabStage[ulRunIdx], REDCONF_BLOCK_SIZE);
+                    }
+                }
+            }
+            else
+          #else
+            if(ulRunLen == 0U)
+            {
+                /*  The block is already buffered.
+                */
+            }
+            else
+          #endif
+            {
+                ret = RedIoRead(gbRedVolNum, ulBlock, 1U, gBufCtx.b.aabBuffer[auIdx[0U]]);
+            }
+
+            /*  Since the blocks are about to be used, they become the most
+                recently used buffers.  Buffers for blocks in the range are
+                never victims, so these will not be chosen again.
+            */
+            for(ulRunIdx = 0U; (ret == 0) && (ulRunIdx < ulRunLen); ulRunIdx++)
+            {
+                BUFFERHEAD *pHead = &gBufCtx.aHead[auIdx[ulRunIdx]];
+
+                pHead->bVolNum = gbRedVolNum;
+                pHead->ulBlock = ulBlock + ulRunIdx;
+                pHead->uFlags = 0U;
+
+                BufferHashInsert(auIdx[ulRunIdx]);
+                BufferMakeMRU(auIdx[ulRunIdx]);
+            }
+
+            ulBlock += (ulRunLen == 0U) ? 1U : ulRunLen;
+        }
+    }
+
+    return ret;
+}
+#endif /* REDCONF_READ_AHEAD > 0U */
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Flush all buffers for the active volume in the given range of blocks.
 
+    Dirty buffers for consecutive blocks are written together, up to
+    ::REDCONF_BUFFER_WRITE_GATHER blocks at a time.
+
     @param ulBlockStart Starting block number to flush.
     @param ulBlockCount Count of blocks, starting at @p ulBlockStart, to flush.
                         Must not be zero.
@@ -422,30 +677,67 @@ REDSTATUS RedBufferFlush(
         REDERROR();
         ret = -RED_EINVAL;
     }
-    else
+    else if(ulBlockCount < REDCONF_BUFFER_COUNT)
     {
-        uint8_t bIdx;
+        uint32_t ulBlockEnd = ulBlockStart + ulBlockCount;
+        uint32_t ulBlock = ulBlockStart;
 
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        /*  A short range, such as the extent flushed before a file data write
+            bypasses the buffers: look up each block rather than examining
+            every buffer.
+        */
+        while(ulBlock < ulBlockEnd)
         {
-            BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+            uint16_t uIdx;
+            uint32_t ulBlocks = 1U;
 
-            if(    (pHead->bVolNum == gbRedVolNum)
-                && (pHead->ulBlock != BBLK_INVALID)
-                && ((pHead->uFlags & BFLAG_DIRTY) != 0U)
-                && (pHead->ulBlock >= ulBlockStart)
-                && (pHead->ulBlock < (ulBlockStart + ulBlockCount)))
+            if(BufferIsDirty(ulBlock, &uIdx))
             {
-                ret = BufferWrite(bIdx);
+                ret = BufferWriteRun(uIdx, ulBlockEnd, true, &ulBlocks);
 
-                if(ret == 0)
+                if(ret != 0)
                 {
-                    pHead->uFlags &= (~BFLAG_DIRTY);
+                    break;
                 }
-                else
+            }
+
+            ulBlock += ulBlocks;
+        }
+    }
+    else
+    {
+        uint32_t ulBlockEnd = ulBlockStart + ulBlockCount;
+        uint16_t uIdx;
+
+        for(uIdx = 0U; (ret == 0) && (uIdx < REDCONF_BUFFER_COUNT); uIdx++)
+        {
+            const BUFFERHEAD   *pHead = &gBufCtx.aHead[uIdx];
+            uint32_t            ulBlock = pHead->ulBlock;
+            uint16_t            uRunIdx;
+
+            /*  Each run of dirty buffers for consecutive blocks is written when
+                the buffer for its first block is reached; buffers in the middle
+                of a run are skipped, and will be clean by the time the loop
+                gets to them if their run has already been written.
+            */
+            if(    (pHead->bVolNum == gbRedVolNum)
+                && (ulBlock != BBLK_INVALID)
+                && ((pHead->uFlags & BFLAG_DIRTY) != 0U)
+                && (ulBlock >= ulBlockStart)
+                && (ulBlock < ulBlockEnd)
+                && ((ulBlock == ulBlockStart) || !BufferIsDirty(ulBlock - 1U, &uRunIdx)))
+            {
+                uRunIdx = uIdx;
+
+                do
                 {
-                    break;
+                    uint32_t ulBlocks;
+
+                    ret = BufferWriteRun(uRunIdx, ulBlockEnd, true, &ulBlocks);
+
+                    ulBlock += ulBlocks;
                 }
+                while((ret == 0) && (ulBlock < ulBlockEnd) && BufferIsDirty(ulBlock, &uRunIdx));
             }
         }
     }
@@ -461,17 +753,17 @@ REDSTATUS RedBufferFlush(
 void RedBufferDirty(
     const void *pBuffer)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(!BufferToIdx(pBuffer, &bIdx))
+    if(!BufferToIdx(pBuffer, &uIdx))
     {
         REDERROR();
     }
     else
     {
-        REDASSERT(gBufCtx.aHead[bIdx].bRefCount > 0U);
+        REDASSERT(gBufCtx.aHead[uIdx].bRefCount > 0U);
 
-        gBufCtx.aHead[bIdx].uFlags |= BFLAG_DIRTY;
+        gBufCtx.aHead[uIdx].uFlags |= BFLAG_DIRTY;
     }
 }
 
@@ -485,22 +777,28 @@ void RedBufferBranch(
     const void *pBuffer,
     uint32_t    ulBlockNew)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(    !BufferToIdx(pBuffer, &bIdx)
+    if(    !BufferToIdx(pBuffer, &uIdx)
         || (ulBlockNew >= gpRedVolume->ulBlockCount))
     {
         REDERROR();
     }
     else
     {
-        BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
         REDASSERT(pHead->bRefCount > 0U);
         REDASSERT((pHead->uFlags & BFLAG_DIRTY) == 0U);
 
+        /*  The buffer moves to the hash chain for its new block number.
+        */
+        BufferHashRemove(uIdx);
+
         pHead->uFlags |= BFLAG_DIRTY;
         pHead->ulBlock = ulBlockNew;
+
+        BufferHashInsert(uIdx);
     }
 }
 
@@ -513,23 +811,23 @@ void RedBufferBranch(
 void RedBufferDiscard(
     const void *pBuffer)
 {
-    uint8_t     bIdx;
+    uint16_t    uIdx;
 
-    if(!BufferToIdx(pBuffer, &bIdx))
+    if(!BufferToIdx(pBuffer, &uIdx))
     {
         REDERROR();
     }
     else
     {
-        REDASSERT(gBufCtx.aHead[bIdx].bRefCount == 1U);
+        REDASSERT(gBufCtx.aHead[uIdx].bRefCount == 1U);
         REDASSERT(gBufCtx.uNumUsed > 0U);
 
-        gBufCtx.aHead[bIdx].bRefCount = 0U;
-        gBufCtx.aHead[bIdx].ulBlock = BBLK_INVALID;
+        gBufCtx.aHead[uIdx].bRefCount = 0U;
+        BufferInvalidate(uIdx);
 
         gBufCtx.uNumUsed--;
 
-        BufferMakeLRU(bIdx);
+        BufferMakeLRU(uIdx);
     }
 }
 #endif
@@ -561,43 +859,45 @@ REDSTATUS RedBufferDiscardRange(
         REDERROR();
         ret = -RED_EINVAL;
     }
+    else if(ulBlockCount < REDCONF_BUFFER_COUNT)
+    {
+        uint32_t ulBlock;
+
+        /*  A short range, most often the single block which was just freed:
+            look up each block rather than examining every buffer.
+        */
+        for(ulBlock = ulBlockStart; ulBlock < (ulBlockStart + ulBlockCount); ulBlock++)
+        {
+            uint16_t uIdx;
+
+            if(BufferFind(ulBlock, &uIdx))
+            {
+                ret = BufferDiscard(uIdx);
+
+                if(ret != 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
     else
     {
-        uint8_t bIdx;
+        uint16_t uIdx;
 
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        for(uIdx = 0U; uIdx < REDCONF_BUFFER_COUNT; uIdx++)
         {
-            BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+            const BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
             if(    (pHead->bVolNum == gbRedVolNum)
                 && (pHead->ulBlock != BBLK_INVALID)
                 && (pHead->ulBlock >= ulBlockStart)
                 && (pHead->ulBlock < (ulBlockStart + ulBlockCount)))
             {
-                if(pHead->bRefCount == 0U)
-                {
-                    pHead->ulBlock = BBLK_INVALID;
+                ret = BufferDiscard(uIdx);
 
-                    BufferMakeLRU(bIdx);
-                }
-                else
+                if(ret != 0)
                 {
-                    /*  This should never happen.  There are three general cases
-                        when this function is used:
-
-                        1) Discarding every block, as happens during unmount
-                           and at the end of format.  There should no longer be
-                           any referenced buffers at those points.
-                        2) Discarding a block which has become free.  All
-                           buffers for such blocks should be put or branched
-                           beforehand.
-                        3) Discarding of blocks that were just written straight
-                           to disk, leaving stale data in the buffer.  The write
-                           code should never reference buffers for these blocks,
-                           since they would not be needed or used.
-                    */
-                    CRITICAL_ERROR();
-                    ret = -RED_EBUSY;
                     break;
                 }
             }
@@ -718,7 +1018,7 @@ static bool BufferIsValid(
 /** @brief Derive the index of the buffer.
 
     @param pBuffer  The buffer to derive the index of.
-    @param pbIdx    On success, populated with the index of the buffer.
+    @param puIdx    On success, populated with the index of the buffer.
 
     @return Boolean indicating result.
 
@@ -727,47 +1027,228 @@ static bool BufferIsValid(
 */
 static bool BufferToIdx(
     const void *pBuffer,
-    uint8_t    *pbIdx)
+    uint16_t   *puIdx)
 {
     bool        fRet = false;
 
-    if((pBuffer != NULL) && (pbIdx != NULL))
+    if((pBuffer != NULL) && (puIdx != NULL))
     {
-        uint8_t bIdx;
+        uintptr_t   ulIdx;
+
+        /*  pBuffer should be a pointer to one of the block buffers.  Derive the
+            index from its distance to the first buffer, then make sure that the
+            buffer at that index really is pBuffer: this rejects pointers which
+            are outside of the array or which point into the middle of a buffer.
+        */
+        ulIdx = PTR_BYTE_DISTANCE(pBuffer, &gBufCtx.b.aabBuffer[0U][0U]) / REDCONF_BLOCK_SIZE;
+
+        if(    (ulIdx < REDCONF_BUFFER_COUNT)
+            && (pBuffer == &gBufCtx.b.aabBuffer[ulIdx][0U])
+            && (gBufCtx.aHead[ulIdx].ulBlock != BBLK_INVALID)
+            && (gBufCtx.aHead[ulIdx].bVolNum == gbRedVolNum))
+        {
+            *puIdx = (uint16_t)ulIdx;
+            fRet = true;
+        }
+    }
+
+    return fRet;
+}
+
+
+/** @brief Discard a buffer which is not referenced, marking it invalid.
+
+    @param uIdx The index of the buffer to discard.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EBUSY  The buffer is referenced.
+*/
+static REDSTATUS BufferDiscard(
+    uint16_t    uIdx)
+{
+    REDSTATUS   ret = 0;
 
-        /*  pBuffer should be a pointer to one of the block buffers.
+    if(gBufCtx.aHead[uIdx].bRefCount == 0U)
+    {
+        BufferInvalidate(uIdx);
 
-            A good compiler should optimize this loop into a bounds check and an
-            alignment check, although GCC has been observed to not do so; if the
-            number of buffers is small, it should not make much difference.  The
-            alternative is to use pointer comparisons, but this both deviates
-            from MISRA-C:2012 and involves undefined behavior.
+        BufferMakeLRU(uIdx);
+    }
+    else
+    {
+        /*  This should never happen.  There are three general cases when
+            RedBufferDiscardRange() is used:
+
+            1) Discarding every block, as happens during unmount and at the end
+               of format.  There should no longer be any referenced buffers at
+               those points.
+            2) Discarding a block which has become free.  All buffers for such
+               blocks should be put or branched beforehand.
+            3) Discarding of blocks that were just written straight to disk,
+               leaving stale data in the buffer.  The write code should never
+               reference buffers for these blocks, since they would not be
+               needed or used.
         */
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        CRITICAL_ERROR();
+        ret = -RED_EBUSY;
+    }
+
+    return ret;
+}
+
+
+/** @brief Mark a buffer invalid, removing it from its hash chain.
+
+    Does nothing if the buffer is already invalid.
+
+    @param uIdx The index of the buffer to invalidate.
+*/
+static void BufferInvalidate(
+    uint16_t    uIdx)
+{
+    if(gBufCtx.aHead[uIdx].ulBlock != BBLK_INVALID)
+    {
+        BufferHashRemove(uIdx);
+
+        gBufCtx.aHead[uIdx].ulBlock = BBLK_INVALID;
+    }
+}
+
+
+#if REDCONF_READ_ONLY == 0
+/** @brief Determine whether a block of the active volume has a dirty buffer.
+
+    @param ulBlock  The block number to look up.
+    @param puIdx    If the block has a dirty buffer (true is returned),
+                    populated with the index of the buffer.
+
+    @return Whether @p ulBlock has a dirty buffer.
+*/
+static bool BufferIsDirty(
+    uint32_t    ulBlock,
+    uint16_t   *puIdx)
+{
+    return BufferFind(ulBlock, puIdx) && ((gBufCtx.aHead[*puIdx].uFlags & BFLAG_DIRTY) != 0U);
+}
+
+
+/** @brief Write out a dirty buffer, along with the dirty buffers for the blocks
+           which follow it, and mark them clean.
+
+    Up to ::REDCONF_BUFFER_WRITE_GATHER buffers for consecutive blocks are
+    copied into a staging area and written with a single request, rather than
+    one request per block.
+
+    @param uIdx         The index of the dirty buffer for the first block.
+    @param ulBlockEnd   The block number at which the run must end.  Only used
+                        if the buffer belongs to the active volume.
+    @param fReferenced  Whether buffers after the first may be written while
+                        they are referenced.
+    @param pulBlocks    On success, populated with the number of blocks
+                        written; otherwise, populated with one.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL Invalid parameters.
+*/
+static REDSTATUS BufferWriteRun(
+    uint16_t    uIdx,
+    uint32_t    ulBlockEnd,
+    bool        fReferenced,
+    uint32_t   *pulBlocks)
+{
+    REDSTATUS   ret = 0;
+    BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+    uint32_t    ulCount = 1U;
+
+  #if REDCONF_BUFFER_WRITE_GATHER > 1U
+    gBufCtx.auGather[0U] = uIdx;
+
+    /*  The buffers are looked up by block number on the active volume, so
+        there is no gathering for buffers which belong to another volume.
+    */
+    while(    (pHead->bVolNum == gbRedVolNum)
+           && (ulCount < REDCONF_BUFFER_WRITE_GATHER)
+           && ((pHead->ulBlock + ulCount) < ulBlockEnd))
+    {
+        uint16_t uNextIdx;
+
+        if(    !BufferIsDirty(pHead->ulBlock + ulCount, &uNextIdx)
+            || (!fReferenced && (gBufCtx.aHead[uNextIdx].bRefCount != 0U)))
+        {
+            break;
+        }
+
+        gBufCtx.auGather[ulCount] = uNextIdx;
+        ulCount++;
+    }
+
+    if(ulCount > 1U)
+    {
+        uint32_t ulRunIdx;
+
+        for(ulRunIdx = 0U; ulRunIdx < ulCount; ulRunIdx++)
         {
-            if(pBuffer == &gBufCtx.b.aabBuffer[bIdx][0U])
+            uint16_t uRunIdx = gBufCtx.auGather[ulRunIdx];
+            uint16_t uFlags = gBufCtx.aHead[uRunIdx].uFlags;
+
+            if((uFlags & BFLAG_META) != 0U)
+            {
+                ret = BufferFinalize(gBufCtx.b.aabBuffer[uRunIdx], uFlags);
+            }
+
+            if(ret != 0)
             {
                 break;
             }
+
+            RedMemCpy(gBufCtx.s.aabStage[ulRunIdx], gBufCtx.b.aabBuffer[uRunIdx], REDCONF_BLOCK_SIZE);
+
+          #ifdef REDCONF_ENDIAN_SWAP
+            BufferEndianSwap(gBufCtx.b.aabBuffer[uRunIdx], uFlags);
+          #endif
         }
 
-        if(    (bIdx < REDCONF_BUFFER_COUNT)
-            && (gBufCtx.aHead[bIdx].ulBlock != BBLK_INVALID)
-            && (gBufCtx.aHead[bIdx].bVolNum == gbRedVolNum))
+        if(ret == 0)
         {
-            *pbIdx = bIdx;
-            fRet = true;
+            ret = RedIoWrite(pHead->bVolNum, pHead->ulBlock, ulCount, gBufCtx.s.aabStage[0U]);
+        }
+
+        if(ret == 0)
+        {
+            for(ulRunIdx = 0U; ulRunIdx < ulCount; ulRunIdx++)
+            {
+                gBufCtx.aHead[gBufCtx.auGather[ulRunIdx]].uFlags &= (~BFLAG_DIRTY);
+            }
         }
     }
+    else
+  #else
+    (void)ulBlockEnd;
+    (void)fReferenced;
+  #endif
+    {
+        ret = BufferWrite(uIdx);
 
-    return fRet;
+        if(ret == 0)
+        {
+            pHead->uFlags &= (~BFLAG_DIRTY);
+        }
+    }
+
+    *pulBlocks = (ret == 0) ? ulCount : 1U;
+
+    return ret;
 }
 
 
-#if REDCONF_READ_ONLY == 0
 /** @brief Write out a dirty buffer.
 
-    @param bIdx The index of the buffer to write.
+    @param uIdx The index of the buffer to write.
 
     @return A negated ::REDSTATUS code indicating the operation result.
 
@@ -776,27 +1257,27 @@ static bool BufferToIdx(
     @retval -RED_EINVAL Invalid parameters.
 */
 static REDSTATUS BufferWrite(
-    uint8_t     bIdx)
+    uint16_t    uIdx)
 {
     REDSTATUS   ret = 0;
 
-    if(bIdx < REDCONF_BUFFER_COUNT)
+    if(uIdx < REDCONF_BUFFER_COUNT)
     {
-        const BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+        const BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
         REDASSERT((pHead->uFlags & BFLAG_DIRTY) != 0U);
 
         if((pHead->uFlags & BFLAG_META) != 0U)
         {
-            ret = BufferFinalize(gBufCtx.b.aabBuffer[bIdx], pHead->uFlags);
+            ret = BufferFinalize(gBufCtx.b.aabBuffer[uIdx], pHead->uFlags);
         }
 
         if(ret == 0)
         {
-            ret = RedIoWrite(pHead->bVolNum, pHead->ulBlock, 1U, gBufCtx.b.aabBuffer[bIdx]);
+            ret = RedIoWrite(pHead->bVolNum, pHead->ulBlock, 1U, gBufCtx.b.aabBuffer[uIdx]);
 
           #ifdef REDCONF_ENDIAN_SWAP
-            BufferEndianSwap(gBufCtx.b.aabBuffer[bIdx], pHead->uFlags);
+            BufferEndianSwap(gBufCtx.b.aabBuffer[uIdx], pHead->uFlags);
           #endif
         }
     }
@@ -1072,45 +1553,73 @@ static void BufferEndianSwapIndir(
 #endif /* #ifdef REDCONF_ENDIAN_SWAP */
 
 
+#if REDCONF_READ_AHEAD > 0U
+/** @brief Find a buffer into which a block can be read ahead.
+
+    Such a buffer is neither referenced nor dirty, and does not hold one of the
+    blocks being read ahead.
+
+    @param uIdx         The index of the buffer at which to start looking.  The
+                        search proceeds toward the most recently used buffer.
+    @param ulBlockStart First block number being read ahead.
+    @param ulBlockEnd   Block number after the last block being read ahead.
+
+    @return The index of the buffer, or BIDX_INVALID if there is none.
+*/
+static uint16_t BufferVictim(
+    uint16_t    uIdx,
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockEnd)
+{
+    uint16_t    uVictim = uIdx;
+
+    while(uVictim != BIDX_INVALID)
+    {
+        const BUFFERHEAD *pHead = &gBufCtx.aHead[uVictim];
+
+        if(    (pHead->bRefCount == 0U)
+            && ((pHead->uFlags & BFLAG_DIRTY) == 0U)
+            && (    (pHead->ulBlock == BBLK_INVALID)
+                 || (pHead->bVolNum != gbRedVolNum)
+                 || (pHead->ulBlock < ulBlockStart)
+                 || (pHead->ulBlock >= ulBlockEnd)))
+        {
+            break;
+        }
+
+        uVictim = pHead->uPrev;
+    }
+
+    return uVictim;
+}
+#endif /* REDCONF_READ_AHEAD > 0U */
+
+
 /** @brief Mark a buffer as least recently used.
 
-    @param bIdx The index of the buffer to make LRU.
+    @param uIdx The index of the buffer to make LRU.
 */
 static void BufferMakeLRU(
-    uint8_t bIdx)
+    uint16_t    uIdx)
 {
-    if(bIdx >= REDCONF_BUFFER_COUNT)
+    if(uIdx >= REDCONF_BUFFER_COUNT)
     {
         REDERROR();
     }
-    else if(bIdx != gBufCtx.abMRU[REDCONF_BUFFER_COUNT - 1U])
+    else if(uIdx != gBufCtx.uLRU)
     {
-        uint8_t bMruIdx;
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
-        /*  Find the current position of the buffer in the MRU array.  We do not
-            need to check the last slot, since we already know from the above
-            check that the index is not there.
+        /*  Move the buffer to the back of the list, making it the LRU buffer.
+            Since the buffer is not the LRU buffer, unlinking it leaves uLRU
+            unchanged.
         */
-        for(bMruIdx = 0U; bMruIdx < (REDCONF_BUFFER_COUNT - 1U); bMruIdx++)
-        {
-            if(bIdx == gBufCtx.abMRU[bMruIdx])
-            {
-                break;
-            }
-        }
+        BufferUnlink(uIdx);
 
-        if(bMruIdx < (REDCONF_BUFFER_COUNT - 1U))
-        {
-            /*  Move the buffer index to the back of the MRU array, making it
-                the LRU buffer.
-            */
-            RedMemMove(&gBufCtx.abMRU[bMruIdx], &gBufCtx.abMRU[bMruIdx + 1U], REDCONF_BUFFER_COUNT - ((uint32_t)bMruIdx + 1U));
-            gBufCtx.abMRU[REDCONF_BUFFER_COUNT - 1U] = bIdx;
-        }
-        else
-        {
-            REDERROR();
-        }
+        pHead->uPrev = gBufCtx.uLRU;
+        pHead->uNext = BIDX_INVALID;
+        gBufCtx.aHead[gBufCtx.uLRU].uNext = uIdx;
+        gBufCtx.uLRU = uIdx;
     }
     else
     {
@@ -1122,43 +1631,29 @@ static void BufferMakeLRU(
 
 /** @brief Mark a buffer as most recently used.
 
-    @param bIdx The index of the buffer to make MRU.
+    @param uIdx The index of the buffer to make MRU.
 */
 static void BufferMakeMRU(
-    uint8_t bIdx)
+    uint16_t    uIdx)
 {
-    if(bIdx >= REDCONF_BUFFER_COUNT)
+    if(uIdx >= REDCONF_BUFFER_COUNT)
     {
         REDERROR();
     }
-    else if(bIdx != gBufCtx.abMRU[0U])
+    else if(uIdx != gBufCtx.uMRU)
     {
-        uint8_t bMruIdx;
+        BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
-        /*  Find the current position of the buffer in the MRU array.  We do not
-            need to check the first slot, since we already know from the above
-            check that the index is not there.
+        /*  Move the buffer to the front of the list, making it the MRU buffer.
+            Since the buffer is not the MRU buffer, unlinking it leaves uMRU
+            unchanged.
         */
-        for(bMruIdx = 1U; bMruIdx < REDCONF_BUFFER_COUNT; bMruIdx++)
-        {
-            if(bIdx == gBufCtx.abMRU[bMruIdx])
-            {
-                break;
-            }
-        }
+        BufferUnlink(uIdx);
 
-        if(bMruIdx < REDCONF_BUFFER_COUNT)
-        {
-            /*  Move the buffer index to the front of the MRU array, making it
-                the MRU buffer.
-            */
-            RedMemMove(&gBufCtx.abMRU[1U], &gBufCtx.abMRU[0U], bMruIdx);
-            gBufCtx.abMRU[0U] = bIdx;
-        }
-        else
-        {
-            REDERROR();
-        }
+        pHead->uPrev = BIDX_INVALID;
+        pHead->uNext = gBufCtx.uMRU;
+        gBufCtx.aHead[gBufCtx.uMRU].uPrev = uIdx;
+        gBufCtx.uMRU = uIdx;
     }
     else
     {
@@ -1168,45 +1663,142 @@ static void BufferMakeMRU(
 }
 
 
+/** @brief Remove a buffer from the LRU list.
+
+    The caller must put the buffer back into the list.
+
+    @param uIdx The index of the buffer to remove.
+*/
+static void BufferUnlink(
+    uint16_t    uIdx)
+{
+    const BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+
+    if(pHead->uPrev == BIDX_INVALID)
+    {
+        gBufCtx.uMRU = pHead->uNext;
+    }
+    else
+    {
+        gBufCtx.aHead[pHead->uPrev].uNext = pHead->uNext;
+    }
+
+    if(pHead->uNext == BIDX_INVALID)
+    {
+        gBufCtx.uLRU = pHead->uPrev;
+    }
+    else
+    {
+        gBufCtx.aHead[pHead->uNext].uPrev = pHead->uPrev;
+    }
+}
+
+
+/** @brief Determine the hash bucket for a block.
+
+    @param bVolNum  The volume the block resides on.
+    @param ulBlock  The block number.
+
+    @return The index of the hash bucket for the block.
+*/
+static uint16_t BufferHashBucket(
+    uint8_t     bVolNum,
+    uint32_t    ulBlock)
+{
+    /*  Consecutive blocks hash to consecutive buckets, so a run of blocks does
+        not share a chain until it wraps around.  The volume number is scaled
+        by a large odd constant so that the low-numbered blocks of each volume
+        (the master block and the metaroots) do not all share the same chains.
+    */
+    return (uint16_t)((ulBlock + ((uint32_t)bVolNum * 0x9E3779B1U)) % BUFFER_HASH_BUCKETS);
+}
+
+
+/** @brief Insert a valid buffer into the hash chain for its block.
+
+    @param uIdx The index of the buffer to insert.
+*/
+static void BufferHashInsert(
+    uint16_t    uIdx)
+{
+    BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
+    uint16_t    uBucket = BufferHashBucket(pHead->bVolNum, pHead->ulBlock);
+
+    REDASSERT(pHead->ulBlock != BBLK_INVALID);
+
+    pHead->uHashNext = gBufCtx.auHash[uBucket];
+    gBufCtx.auHash[uBucket] = uIdx;
+}
+
+
+/** @brief Remove a valid buffer from the hash chain for its block.
+
+    @param uIdx The index of the buffer to remove.
+*/
+static void BufferHashRemove(
+    uint16_t    uIdx)
+{
+    const BUFFERHEAD   *pHead = &gBufCtx.aHead[uIdx];
+    uint16_t           *puLink = &gBufCtx.auHash[BufferHashBucket(pHead->bVolNum, pHead->ulBlock)];
+
+    while((*puLink != BIDX_INVALID) && (*puLink != uIdx))
+    {
+        puLink = &gBufCtx.aHead[*puLink].uHashNext;
+    }
+
+    if(*puLink == uIdx)
+    {
+        *puLink = pHead->uHashNext;
+    }
+    else
+    {
+        /*  The buffer was valid, so it should have been in the chain.
+        */
+        REDERROR();
+    }
+}
+
+
 /** @brief Find a block in the buffers.
 
     @param ulBlock  The block number to find.
-    @param pbIdx    If the block is buffered (true is returned), populated with
+    @param puIdx    If the block is buffered (true is returned), populated with
                     the index of the buffer.
 
     @return Boolean indicating whether or not the block is buffered.
 
     @retval true    @p ulBlock is buffered, and its index has been stored in
-                    @p pbIdx.
+                    @p puIdx.
     @retval false   @p ulBlock is not buffered.
 */
 static bool BufferFind(
-    uint32_t ulBlock,
-    uint8_t *pbIdx)
+    uint32_t    ulBlock,
+    uint16_t   *puIdx)
 {
-    bool     ret = false;
+    bool        ret = false;
 
-    if((ulBlock >= gpRedVolume->ulBlockCount) || (pbIdx == NULL))
+    if((ulBlock >= gpRedVolume->ulBlockCount) || (puIdx == NULL))
     {
         REDERROR();
     }
     else
     {
-        uint8_t bIdx;
+        uint16_t uIdx = gBufCtx.auHash[BufferHashBucket(gbRedVolNum, ulBlock)];
 
-        for(bIdx = 0U; bIdx < REDCONF_BUFFER_COUNT; bIdx++)
+        while(uIdx != BIDX_INVALID)
         {
-            const BUFFERHEAD *pHead = &gBufCtx.aHead[bIdx];
+            const BUFFERHEAD *pHead = &gBufCtx.aHead[uIdx];
 
             if((pHead->bVolNum == gbRedVolNum) && (pHead->ulBlock == ulBlock))
             {
-                *pbIdx = bIdx;
+                *puIdx = uIdx;
                 ret = true;
                 break;
             }
+
+            uIdx = pHead->uHashNext;
         }
     }
 
     return ret;
 }
-
@@ -277,6 +277,19 @@ REDSTATUS RedCoreInit(void)
             }
         }
       #endif
+
+      #if (REDCONF_TRANSACT_GROUP_MS > 0U) || (REDCONF_TRANSACT_BG_MS > 0U)
+        if(ret == 0)
+        {
+            ret = RedOsTimestampInit();
+
+            if(ret != 0)
+            {
+                (void)RedOsMutexUninit();
+                (void)RedOsClockUninit();
+            }
+        }
+      #endif
     }
 
     return ret;
@@ -301,6 +314,10 @@ REDSTATUS RedCoreUninit(void)
 {
     REDSTATUS ret;
 
+  #if (REDCONF_TRANSACT_GROUP_MS > 0U) || (REDCONF_TRANSACT_BG_MS > 0U)
+    (void)RedOsTimestampUninit();
+  #endif
+
   #if REDCONF_TASK_COUNT > 1U
     ret = RedOsMutexUninit();
 
@@ -388,6 +405,12 @@ REDSTATUS RedCoreVolFormat(void)
 */
 REDSTATUS RedCoreVolMount(void)
 {
+  #if (REDCONF_API_POSIX == 1) && ((REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U))
+    /*  The directories may have been modified while the volume was unmounted.
+    */
+    RedDirCacheReset();
+  #endif
+
     return RedVolMount();
 }
 
@@ -414,6 +437,10 @@ REDSTATUS RedCoreVolUnmount(void)
 {
     REDSTATUS ret = 0;
 
+  #if REDCONF_CONCURRENT_IO == 1
+    RedVolIoDrain();
+  #endif
+
   #if REDCONF_READ_ONLY == 0
     if(!gpRedVolume->fReadOnly && ((gpRedVolume->ulTransMask & RED_TRANSACT_UMOUNT) != 0U))
     {
@@ -451,6 +478,12 @@ REDSTATUS RedCoreVolUnmount(void)
     mount is the most recent committed state.  Nothing from the committed
     state is ever missing, and nothing from the working state is ever included.
 
+    When REDCONF_TRANSACT_GROUP_MS is nonzero, the transaction point may be
+    shared with other tasks which ask for one within that many milliseconds,
+    and the file system mutex is released while waiting for them; see
+    RedVolTransactGroup().  The changes made before the call are committed by
+    the time it returns, just as without grouping.
+
     @return A negated ::REDSTATUS code indicating the operation result.
 
     @retval 0           Operation was successful.
@@ -472,11 +505,60 @@ REDSTATUS RedCoreVolTransact(void)
     }
     else
     {
+      #if REDCONF_TRANSACT_GROUP_MS > 0U
+        ret = RedVolTransactGroup();
+      #else
         ret = RedVolTransact();
+      #endif
+    }
+
+    return ret;
+}
+
+
+#if REDCONF_TRANSACT_BG_MS > 0U
+/** @brief Make a transaction point on behalf of the background transaction
+           task, if one is due.
+
+    A transaction point is due when the volume has changed since the last one,
+    and either @p fIntervalOver is true or, if REDCONF_TRANSACT_BG_BLOCKS is
+    nonzero, at least that many blocks have been allocated since the last one.
+    Volumes which are not mounted, or are read-only, are skipped.
+
+    @param fIntervalOver    Whether REDCONF_TRANSACT_BG_MS has passed since the
+                            background transaction task last checked the
+                            volume.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+REDSTATUS RedCoreVolTransactBackground(
+    bool        fIntervalOver)
+{
+    REDSTATUS   ret = 0;
+
+    if(gpRedVolume->fMounted && !gpRedVolume->fReadOnly && gpRedCoreVol->fBranched)
+    {
+        bool fDue = fIntervalOver;
+
+      #if REDCONF_TRANSACT_BG_BLOCKS > 0U
+        if(gpRedCoreVol->ulDirtyBlocks >= REDCONF_TRANSACT_BG_BLOCKS)
+        {
+            fDue = true;
+        }
+      #endif
+
+        if(fDue)
+        {
+            ret = RedVolTransact();
+        }
     }
 
     return ret;
 }
+#endif
 #endif /* REDCONF_READ_ONLY == 0 */
 
 
@@ -535,6 +617,45 @@ REDSTATUS RedCoreVolStat(
 #endif /* REDCONF_API_POSIX == 1 */
 
 
+#if REDCONF_BUFFER_STATS == 1
+/** @brief Report how often blocks were found in the block buffers.
+
+    Meant for benchmarks and tuning REDCONF_BUFFER_COUNT.  The counts are for
+    all volumes, and wrap around, so only the difference between two calls is
+    meaningful.  Unlike other core functions, this may be called without the
+    file system mutex, in which case the counts may be slightly stale.
+
+    @param pulHits      Populated with the number of block lookups which found
+                        the block already buffered.
+    @param pulMisses    Populated with the number of block lookups which read
+                        the block from disk.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL @p pulHits or @p pulMisses is `NULL`.
+*/
+REDSTATUS RedCoreBufferStats(
+    uint32_t   *pulHits,
+    uint32_t   *pulMisses)
+{
+    REDSTATUS   ret;
+
+    if((pulHits == NULL) || (pulMisses == NULL))
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        RedBufferStats(pulHits, pulMisses);
+        ret = 0;
+    }
+
+    return ret;
+}
+#endif
+
+
 #if (REDCONF_READ_ONLY == 0) && ((REDCONF_API_POSIX == 1) || (REDCONF_API_FSE_TRANSMASKSET == 1))
 /** @brief Update the transaction mask.
 
@@ -1591,6 +1712,10 @@ REDSTATUS RedCoreFileRead(
         ret = RedInodeMount(&ino, FTYPE_FILE, fUpdateAtime);
         if(ret == 0)
         {
+          #if REDCONF_CONCURRENT_IO == 1
+            ino.fIoUnlock = RedVolIoEntered(ulInode, false);
+          #endif
+
             ret = RedInodeDataRead(&ino, ullStart, pulLen, pBuffer);
 
           #if (REDCONF_ATIME == 1) && (REDCONF_READ_ONLY == 0)
@@ -1605,6 +1730,76 @@ REDSTATUS RedCoreFileRead(
 }
 
 
+#if REDCONF_READ_AHEAD > 0U
+/** @brief Read from a file which may be being read sequentially.
+
+    Behaves like RedCoreFileRead(), except that when the reads made with the
+    same @p pReadAhead are sequential, the file data which follows is read
+    ahead; see RedInodeDataReadSeq().
+
+    @param ulInode      The inode number of the file to read.
+    @param ullStart     The file offset to read from.
+    @param pulLen       On entry, contains the number of bytes to read; on
+                        successful exit, contains the number of bytes actually
+                        read.
+    @param pBuffer      The buffer to populate with the data read.  Must be big
+                        enough for the read request.
+    @param pReadAhead   The sequential read state for the handle being read.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EBADF  @p ulInode is not a valid inode number.
+    @retval -RED_EINVAL The volume is not mounted; or @p pBuffer is `NULL`; or
+                        @p pReadAhead is `NULL`.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EISDIR The inode is a directory inode.
+*/
+REDSTATUS RedCoreFileReadSeq(
+    uint32_t        ulInode,
+    uint64_t        ullStart,
+    uint32_t       *pulLen,
+    void           *pBuffer,
+    REDREADAHEAD   *pReadAhead)
+{
+    REDSTATUS       ret;
+
+    if(!gpRedVolume->fMounted || (pulLen == NULL))
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+      #if (REDCONF_ATIME == 1) && (REDCONF_READ_ONLY == 0)
+        bool    fUpdateAtime = (*pulLen > 0U) && !gpRedVolume->fReadOnly;
+      #else
+        bool    fUpdateAtime = false;
+      #endif
+        CINODE  ino;
+
+        ino.ulInode = ulInode;
+        ret = RedInodeMount(&ino, FTYPE_FILE, fUpdateAtime);
+        if(ret == 0)
+        {
+          #if REDCONF_CONCURRENT_IO == 1
+            ino.fIoUnlock = RedVolIoEntered(ulInode, false);
+          #endif
+
+            ret = RedInodeDataReadSeq(&ino, ullStart, pulLen, pBuffer, pReadAhead);
+
+          #if (REDCONF_ATIME == 1) && (REDCONF_READ_ONLY == 0)
+            RedInodePut(&ino, ((ret == 0) && fUpdateAtime) ? IPUT_UPDATE_ATIME : 0U);
+          #else
+            RedInodePut(&ino, 0U);
+          #endif
+        }
+    }
+
+    return ret;
+}
+#endif /* REDCONF_READ_AHEAD > 0U */
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Write to a file.
 
@@ -1726,6 +1921,10 @@ static REDSTATUS CoreFileWrite(
         ret = RedInodeMount(&ino, FTYPE_FILE, true);
         if(ret == 0)
         {
+          #if REDCONF_CONCURRENT_IO == 1
+            ino.fIoUnlock = RedVolIoEntered(ulInode, true);
+          #endif
+
             ret = RedInodeDataWrite(&ino, ullStart, pulLen, pBuffer);
 
             RedInodePut(&ino, (ret == 0) ? (uint8_t)(IPUT_UPDATE_MTIME | IPUT_UPDATE_CTIME) : 0U);
@@ -1852,6 +2051,73 @@ static REDSTATUS CoreFileTruncate(
 #endif /* TRUNCATE_SUPPORTED */
 
 
+#if REDCONF_CONCURRENT_IO == 1
+/** @brief Start reading, writing, or truncating a file.
+
+    Waits until no other task is writing the file, and, when @p fWrite is true,
+    until no other task is reading it either.  Then, until the matching
+    RedCoreFileIoLeave(), RedCoreFileRead() and RedCoreFileWrite() release the
+    file system mutex while they transfer whole blocks of the file's data to or
+    from the block device, so that other tasks can use the file system in the
+    meantime.  The block device must therefore accept concurrent requests.
+
+    Must be called with the file system mutex held, and at most once per task
+    before the matching RedCoreFileIoLeave().  The mutex is released while
+    waiting; the current volume is set again before returning.
+
+    @param ulInode  The inode number of the file.
+    @param fWrite   Whether the file is to be written or truncated.
+*/
+void RedCoreFileIoEnter(
+    uint32_t    ulInode,
+    bool        fWrite)
+{
+    RedVolIoEnter(ulInode, fWrite);
+}
+
+
+/** @brief Finish reading, writing, or truncating a file.
+
+    @param ulInode  The inode number given to RedCoreFileIoEnter().
+    @param fWrite   The @p fWrite value given to RedCoreFileIoEnter().
+*/
+void RedCoreFileIoLeave(
+    uint32_t    ulInode,
+    bool        fWrite)
+{
+    RedVolIoLeave(ulInode, fWrite);
+}
+
+
+/** @brief Wait until no file on the current volume is being read or written,
+           and no transaction point on it is waiting.
+
+    Once this returns, and until the file system mutex is released, unmounting
+    the volume does not release the mutex.  The mutex is released while
+    waiting; the current volume is set again before returning.
+*/
+void RedCoreVolIoDrain(void)
+{
+    RedVolIoDrain();
+}
+
+
+#if REDCONF_READ_ONLY == 0
+/** @brief Wait until no file data is being written with the file system mutex
+           released, on any volume.
+
+    Once this returns, and until the mutex is released, transaction points do
+    not release the mutex.  The mutex is released while waiting; the current
+    volume is left unchanged.
+*/
+void RedCoreVolIoQuiesce(void)
+{
+    RedVolIoQuiesce();
+}
+#endif
+#endif /* REDCONF_CONCURRENT_IO == 1 */
+
+
 #if (REDCONF_API_POSIX == 1) && (REDCONF_API_POSIX_READDIR == 1)
 /** @brief Read from a directory.
 
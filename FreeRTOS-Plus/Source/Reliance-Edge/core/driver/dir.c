@@ -68,6 +68,109 @@ typedef struct
 } DIRENT;
 
 
+#if REDCONF_DIRENT_CACHE_COUNT > 0U
+/** @brief A cached directory entry.
+
+    Recently used names are remembered along with their position and inode
+    number, so that looking them up again does not require reading the
+    directory.  The cache is direct-mapped by a hash of the name and parent
+    directory.
+*/
+typedef struct
+{
+    /** The inode number of the directory containing the entry, or
+        INODE_INVALID if this cache entry is unused.
+    */
+    uint32_t    ulPInode;
+
+    /** The position of the entry within the directory.
+    */
+    uint32_t    ulIdx;
+
+    /** The inode number that the entry points at, in native byte order.
+    */
+    uint32_t    ulInode;
+
+    /** The volume containing the directory.
+    */
+    uint8_t     bVolNum;
+
+    /** The name of the entry, formatted like the on-disk directory entry.
+    */
+    char        acName[REDCONF_NAME_MAX];
+} DIRCACHEENT;
+#endif
+
+#if REDCONF_DIR_FILTER_COUNT > 0U
+/** @brief A negative lookup filter for a large directory.
+
+    This is a Bloom filter: each name in the directory sets two bits, chosen by
+    hashing the name.  If either bit is clear for a name, the name cannot exist
+    in the directory, and a lookup (such as the one which precedes creating a
+    new entry) can fail without reading the directory.  The filter is built by
+    a lookup which reads the whole directory without finding the name, and
+    afterward is kept current as entries are written.  Deleted names leave
+    their bits set, which costs nothing but an occasional needless scan; once
+    such a scan happens, the filter is rebuilt.
+
+    The filter uses a power of two number of bits, DIR_FILTER_BITS_PER_NAME
+    for each entry of the directory when it is built, up to the size of abBits.
+    When the directory grows to more than one name for every
+    DIR_FILTER_MIN_BITS_PER_NAME bits, the filter rules out too few names and is
+    invalidated, so that the next search rebuilds it with more bits.  A
+    directory with more than DIR_FILTER_MAX_NAMES entries gets no filter at all,
+    since even the largest one would let nearly every name through.
+*/
+typedef struct
+{
+    /** The inode number of the directory, or INODE_INVALID if the filter is
+        unused.
+    */
+    uint32_t    ulPInode;
+
+    /** The position of the first available entry in the directory, as would
+        be returned by RedDirEntryLookup() with -RED_ENOENT.
+    */
+    uint32_t    ulFreeIdx;
+
+    /** Value of gulDirFilterUses when the filter was last used; the least
+        recently used filter is replaced to make room for another.
+    */
+    uint32_t    ulLastUse;
+
+    /** The number of filter bits in use, minus one.
+    */
+    uint32_t    ulBitMask;
+
+    /** The number of names added to the filter.
+    */
+    uint32_t    ulNames;
+
+    /** The volume containing the directory.
+    */
+    uint8_t     bVolNum;
+
+    /** Whether the filter and ulFreeIdx are complete and can be trusted.
+    */
+    bool        fValid;
+
+    /** Whether entries have been deleted since the filter was built, leaving
+        bits set for names which no longer exist.
+    */
+    bool        fStale;
+
+    /** The filter bits.
+    */
+    uint8_t     abBits[REDCONF_DIR_FILTER_BYTES];
+} DIRFILTER;
+
+#define DIR_FILTER_MAX_BITS             (REDCONF_DIR_FILTER_BYTES * 8U)
+#define DIR_FILTER_BITS_PER_NAME        16U
+#define DIR_FILTER_MIN_BITS_PER_NAME    8U
+#define DIR_FILTER_MAX_NAMES            (DIR_FILTER_MAX_BITS / DIR_FILTER_MIN_BITS_PER_NAME)
+#endif
+
+
 #if (REDCONF_READ_ONLY == 0) && (REDCONF_API_POSIX_RENAME == 1)
 static REDSTATUS DirCyclicRenameCheck(uint32_t ulSrcInode, const CINODE *pDstPInode);
 #endif
@@ -76,6 +179,42 @@ static REDSTATUS DirEntryWrite(CINODE *pPInode, uint32_t ulIdx, uint32_t ulInode
 static uint64_t DirEntryIndexToOffset(uint32_t ulIdx);
 #endif
 static uint32_t DirOffsetToEntryIndex(uint64_t ullOffset);
+static REDSTATUS DirEntryScan(CINODE *pPInode, const char *pszName, uint32_t ulNameLen, uint32_t *pulEntryIdx, uint32_t *pulInode);
+#if (REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U)
+static uint32_t DirNameHash(const char *pszName, uint32_t ulNameLen);
+#endif
+#if REDCONF_DIRENT_CACHE_COUNT > 0U
+static bool DirNameCacheFind(uint32_t ulPInode, const char *pszName, uint32_t ulNameLen, uint32_t *pulEntryIdx, uint32_t *pulInode);
+static void DirNameCacheInsert(uint32_t ulPInode, const char *pszName, uint32_t ulNameLen, uint32_t ulIdx, uint32_t ulInode);
+#if REDCONF_READ_ONLY == 0
+static void DirNameCacheRemove(uint32_t ulPInode, uint32_t ulIdx);
+#endif
+static DIRCACHEENT *DirNameCacheSlot(uint32_t ulPInode, const char *pszName, uint32_t ulNameLen);
+#endif
+#if REDCONF_DIR_FILTER_COUNT > 0U
+static bool DirFilterExcludes(uint32_t ulPInode, const char *pszName, uint32_t ulNameLen, uint32_t *pulFreeIdx);
+static DIRFILTER *DirFilterClaim(uint32_t ulPInode);
+static DIRFILTER *DirFilterFind(uint32_t ulPInode);
+static void DirFilterSize(DIRFILTER *pFilter, uint32_t ulDirentCount);
+static void DirFilterAdd(DIRFILTER *pFilter, const char *pszName, uint32_t ulNameLen);
+static bool DirFilterTest(const DIRFILTER *pFilter, const char *pszName, uint32_t ulNameLen);
+#endif
+#if (REDCONF_READ_ONLY == 0) && ((REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U))
+static void DirCacheEntryWritten(const CINODE *pPInode, uint32_t ulIdx, uint32_t ulInode, const char *pszName, uint32_t ulNameLen, uint32_t ulOldCount);
+#if DELETE_SUPPORTED
+static void DirCacheTruncated(const CINODE *pPInode, uint32_t ulDeleteIdx, uint32_t ulTruncIdx);
+#endif
+static void DirCacheDiscard(const CINODE *pPInode);
+#endif
+
+
+#if REDCONF_DIRENT_CACHE_COUNT > 0U
+static DIRCACHEENT gaDirNameCache[REDCONF_DIRENT_CACHE_COUNT];
+#endif
+#if REDCONF_DIR_FILTER_COUNT > 0U
+static DIRFILTER gaDirFilter[REDCONF_DIR_FILTER_COUNT];
+static uint32_t gulDirFilterUses;
+#endif
 
 
 #if REDCONF_READ_ONLY == 0
@@ -257,6 +396,17 @@ REDSTATUS RedDirEntryDelete(
         {
             ret = RedInodeDataTruncate(pPInode, DirEntryIndexToOffset(ulTruncIdx));
         }
+
+      #if (REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U)
+        if(ret == 0)
+        {
+            DirCacheTruncated(pPInode, ulDeleteIdx, ulTruncIdx);
+        }
+        else
+        {
+            DirCacheDiscard(pPInode);
+        }
+      #endif
     }
     else
     {
@@ -332,126 +482,71 @@ REDSTATUS RedDirEntryLookup(
         }
         else
         {
-            uint32_t    ulIdx = 0U;
-            uint32_t    ulDirentCount = DirOffsetToEntryIndex(pPInode->pInodeBuf->ullSize);
-            uint32_t    ulFreeIdx = DIR_INDEX_INVALID;  /* Index of first free dirent. */
+            bool fResolved = false;
 
-            /*  Loop over the directory blocks, searching each block for a
-                dirent that matches the given name.
-            */
-            while((ret == 0) && (ulIdx < ulDirentCount))
+          #if REDCONF_DIRENT_CACHE_COUNT > 0U
+            if(DirNameCacheFind(pPInode->ulInode, pszName, ulNameLen, pulEntryIdx, pulInode))
             {
-                ret = RedInodeDataSeekAndRead(pPInode, ulIdx / DIRENTS_PER_BLOCK);
+                fResolved = true;
+            }
+          #endif
 
-                if(ret == 0)
-                {
-                    const DIRENT *pDirents = CAST_CONST_DIRENT_PTR(pPInode->pbData);
-                    uint32_t      ulBlockLastIdx = REDMIN(DIRENTS_PER_BLOCK, ulDirentCount - ulIdx);
-                    uint32_t      ulBlockIdx;
+          #if REDCONF_DIR_FILTER_COUNT > 0U
+            if(!fResolved && DirFilterExcludes(pPInode->ulInode, pszName, ulNameLen, pulEntryIdx))
+            {
+                ret = -RED_ENOENT;
+                fResolved = true;
+            }
+          #endif
 
-                    for(ulBlockIdx = 0U; ulBlockIdx < ulBlockLastIdx; ulBlockIdx++)
-                    {
-                        const DIRENT *pDirent = &pDirents[ulBlockIdx];
-
-                        if(pDirent->ulInode != INODE_INVALID)
-                        {
-                            /*  The name in the dirent will not be null
-                                terminated if it is of the maximum length, so
-                                use a bounded string compare and then make sure
-                                there is nothing more to the name.
-                            */
-                            if(    (RedStrNCmp(pDirent->acName, pszName, ulNameLen) == 0)
-                                && ((ulNameLen == REDCONF_NAME_MAX) || (pDirent->acName[ulNameLen] == '\0')))
-                            {
-                                /*  Found a matching dirent, stop and return its
-                                    information.
-                                */
-                                if(pulInode != NULL)
-                                {
-                                    *pulInode = pDirent->ulInode;
-
-                                  #ifdef REDCONF_ENDIAN_SWAP
-                                    *pulInode = RedRev32(*pulInode);
-                                  #endif
-                                }
-
-                                ulIdx += ulBlockIdx;
-                                break;
-                            }
-                        }
-                        else if(ulFreeIdx == DIR_INDEX_INVALID)
-                        {
-                            ulFreeIdx = ulIdx + ulBlockIdx;
-                        }
-                        else
-                        {
-                            /*  The directory entry is free, but we already found a free one, so there's
-                                nothing to do here.
-                            */
-                        }
-                    }
+            if(!fResolved)
+            {
+                ret = DirEntryScan(pPInode, pszName, ulNameLen, pulEntryIdx, pulInode);
+            }
+        }
+    }
 
-                    if(ulBlockIdx < ulBlockLastIdx)
-                    {
-                        /*  If we broke out of the for loop, we found a matching
-                            dirent and can stop the search.
-                        */
-                        break;
-                    }
+    return ret;
+}
 
-                    ulIdx += ulBlockLastIdx;
-                }
-                else if(ret == -RED_ENODATA)
-                {
-                    if(ulFreeIdx == DIR_INDEX_INVALID)
-                    {
-                        ulFreeIdx = ulIdx;
-                    }
 
-                    ret = 0;
-                    ulIdx += DIRENTS_PER_BLOCK;
-                }
-                else
-                {
-                    /*  Unexpected error, let the loop terminate, no action
-                        here.
-                    */
-                }
-            }
+#if (REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U)
+/** @brief Forget everything cached about the directories of the current
+           volume.
 
-            if(ret == 0)
-            {
-                /*  If we made it all the way to the end of the directory
-                    without stopping, then the given name does not exist in the
-                    directory.
-                */
-                if(ulIdx == ulDirentCount)
-                {
-                    /*  If the directory had no sparse dirents, then the first
-                        free dirent is beyond the end of the directory.  If the
-                        directory is already the maximum size, then there is no
-                        free dirent.
-                    */
-                    if((ulFreeIdx == DIR_INDEX_INVALID) && (ulDirentCount < DIRENTS_MAX))
-                    {
-                        ulFreeIdx = ulDirentCount;
-                    }
+    Must be called when the volume is mounted, since the contents of its
+    directories may have changed while it was unmounted.
+*/
+void RedDirCacheReset(void)
+{
+  #if REDCONF_DIRENT_CACHE_COUNT > 0U
+    uint32_t ulEnt;
 
-                    ulIdx = ulFreeIdx;
+    for(ulEnt = 0U; ulEnt < REDCONF_DIRENT_CACHE_COUNT; ulEnt++)
+    {
+        if(gaDirNameCache[ulEnt].bVolNum == gbRedVolNum)
+        {
+            gaDirNameCache[ulEnt].ulPInode = INODE_INVALID;
+        }
+    }
+  #endif
 
-                    ret = -RED_ENOENT;
-                }
+  #if REDCONF_DIR_FILTER_COUNT > 0U
+    {
+        uint32_t ulFilter;
 
-                if(pulEntryIdx != NULL)
-                {
-                    *pulEntryIdx = ulIdx;
-                }
+        for(ulFilter = 0U; ulFilter < REDCONF_DIR_FILTER_COUNT; ulFilter++)
+        {
+            if(gaDirFilter[ulFilter].bVolNum == gbRedVolNum)
+            {
+                gaDirFilter[ulFilter].ulPInode = INODE_INVALID;
+                gaDirFilter[ulFilter].fValid = false;
             }
         }
     }
-
-    return ret;
+  #endif
 }
+#endif
 
 
 #if (REDCONF_API_POSIX_READDIR == 1) || (REDCONF_CHECKER == 1)
@@ -889,6 +984,9 @@ static REDSTATUS DirEntryWrite(
     {
         uint64_t        ullOffset = DirEntryIndexToOffset(ulIdx);
         uint32_t        ulLen = DIRENT_SIZE;
+      #if (REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U)
+        uint32_t        ulOldCount = DirOffsetToEntryIndex(pPInode->pInodeBuf->ullSize);
+      #endif
         static DIRENT   de;
 
         RedMemSet(&de, 0U, sizeof(de));
@@ -902,6 +1000,17 @@ static REDSTATUS DirEntryWrite(
         RedStrNCpy(de.acName, pszName, ulNameLen);
 
         ret = RedInodeDataWrite(pPInode, ullOffset, &ulLen, &de);
+
+      #if (REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U)
+        if(ret == 0)
+        {
+            DirCacheEntryWritten(pPInode, ulIdx, ulInode, pszName, ulNameLen, ulOldCount);
+        }
+        else
+        {
+            DirCacheDiscard(pPInode);
+        }
+      #endif
     }
 
     return ret;
@@ -953,6 +1062,730 @@ static uint32_t DirOffsetToEntryIndex(
     return ulIdx;
 }
 
+/** @brief Search a directory for a given name by reading it.
+
+    Implements the search for RedDirEntryLookup(), for names which could not be
+    resolved from the name cache or the directory filter.  Populates both with
+    what is learned along the way.
+
+    @param pPInode      A pointer to the cached inode structure of the directory
+                        to search.
+    @param pszName      The name of the desired entry, terminated by either a
+                        null or a path separator.
+    @param ulNameLen    The length of @p pszName.
+    @param pulEntryIdx  On success, populated with the position of the entry; on
+                        -RED_ENOENT, populated with the position of the first
+                        available entry, or DIR_INDEX_INVALID if the directory
+                        is full.  Optional.
+    @param pulInode     On success, populated with the inode number that the
+                        name points to.  Optional.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_ENOENT @p pszName does not name an existing file or directory.
+*/
+static REDSTATUS DirEntryScan(
+    CINODE     *pPInode,
+    const char *pszName,
+    uint32_t    ulNameLen,
+    uint32_t   *pulEntryIdx,
+    uint32_t   *pulInode)
+{
+    REDSTATUS   ret = 0;
+    uint32_t    ulIdx = 0U;
+    uint32_t    ulDirentCount = DirOffsetToEntryIndex(pPInode->pInodeBuf->ullSize);
+    uint32_t    ulFreeIdx = DIR_INDEX_INVALID;  /* Index of first free dirent. */
+    uint32_t    ulInode = INODE_INVALID;
+  #if REDCONF_DIR_FILTER_COUNT > 0U
+    DIRFILTER  *pFilter = NULL;
+
+    /*  A directory which fits in one block is searched quickly enough without a
+        filter, and one with more than DIR_FILTER_MAX_NAMES entries would
+        saturate it.  For other directories, record the names seen by this
+        search, so that if it finds nothing, the filter can answer the next
+        lookup for a name that does not exist.  A directory with a valid filter
+        is being searched because its filter could not exclude the name, and
+        rebuilding it now would throw the filter away if the name is found; an
+        invalid filter is rebuilt.
+    */
+    if((ulDirentCount > DIRENTS_PER_BLOCK) && (ulDirentCount <= DIR_FILTER_MAX_NAMES))
+    {
+        pFilter = DirFilterFind(pPInode->ulInode);
+
+        if(pFilter == NULL)
+        {
+            pFilter = DirFilterClaim(pPInode->ulInode);
+        }
+        else if(pFilter->fValid)
+        {
+            pFilter = NULL;
+        }
+
+        if(pFilter != NULL)
+        {
+            DirFilterSize(pFilter, ulDirentCount);
+        }
+    }
+  #endif
+
+    /*  Loop over the directory blocks, searching each block for a dirent that
+        matches the given name.
+    */
+    while((ret == 0) && (ulIdx < ulDirentCount))
+    {
+        ret = RedInodeDataSeekAndRead(pPInode, ulIdx / DIRENTS_PER_BLOCK);
+
+        if(ret == 0)
+        {
+            const DIRENT *pDirents = CAST_CONST_DIRENT_PTR(pPInode->pbData);
+            uint32_t      ulBlockLastIdx = REDMIN(DIRENTS_PER_BLOCK, ulDirentCount - ulIdx);
+            uint32_t      ulBlockIdx;
+
+            for(ulBlockIdx = 0U; ulBlockIdx < ulBlockLastIdx; ulBlockIdx++)
+            {
+                const DIRENT *pDirent = &pDirents[ulBlockIdx];
+
+                if(pDirent->ulInode != INODE_INVALID)
+                {
+                    /*  The name in the dirent will not be null terminated if it
+                        is of the maximum length, so use a bounded string
+                        compare and then make sure there is nothing more to the
+                        name.
+                    */
+                    if(    (RedStrNCmp(pDirent->acName, pszName, ulNameLen) == 0)
+                        && ((ulNameLen == REDCONF_NAME_MAX) || (pDirent->acName[ulNameLen] == '\0')))
+                    {
+                        /*  Found a matching dirent, stop and return its
+                            information.
+                        */
+                        ulInode = pDirent->ulInode;
+
+                      #ifdef REDCONF_ENDIAN_SWAP
+                        ulInode = RedRev32(ulInode);
+                      #endif
+
+                        ulIdx += ulBlockIdx;
+                        break;
+                    }
+
+                  #if REDCONF_DIR_FILTER_COUNT > 0U
+                    if(pFilter != NULL)
+                    {
+                        DirFilterAdd(pFilter, pDirent->acName, REDCONF_NAME_MAX);
+                    }
+                  #endif
+                }
+                else if(ulFreeIdx == DIR_INDEX_INVALID)
+                {
+                    ulFreeIdx = ulIdx + ulBlockIdx;
+                }
+                else
+                {
+                    /*  The directory entry is free, but we already found a free
+                        one, so there's nothing to do here.
+                    */
+                }
+            }
+
+            if(ulBlockIdx < ulBlockLastIdx)
+            {
+                /*  If we broke out of the for loop, we found a matching dirent
+                    and can stop the search.
+                */
+                break;
+            }
+
+            ulIdx += ulBlockLastIdx;
+        }
+        else if(ret == -RED_ENODATA)
+        {
+            if(ulFreeIdx == DIR_INDEX_INVALID)
+            {
+                ulFreeIdx = ulIdx;
+            }
+
+            ret = 0;
+            ulIdx += DIRENTS_PER_BLOCK;
+        }
+        else
+        {
+            /*  Unexpected error, let the loop terminate, no action here.
+            */
+        }
+    }
+
+    if(ret == 0)
+    {
+        /*  If we made it all the way to the end of the directory without
+            stopping, then the given name does not exist in the directory.
+        */
+        if(ulIdx == ulDirentCount)
+        {
+            /*  If the directory had no sparse dirents, then the first free
+                dirent is beyond the end of the directory.  If the directory is
+                already the maximum size, then there is no free dirent.
+            */
+            if((ulFreeIdx == DIR_INDEX_INVALID) && (ulDirentCount < DIRENTS_MAX))
+            {
+                ulFreeIdx = ulDirentCount;
+            }
+
+            ulIdx = ulFreeIdx;
+
+            ret = -RED_ENOENT;
+
+          #if REDCONF_DIR_FILTER_COUNT > 0U
+            if(pFilter != NULL)
+            {
+                /*  Every name in the directory has been added to the filter.
+                */
+                pFilter->ulFreeIdx = ulFreeIdx;
+                pFilter->fValid = true;
+                pFilter->fStale = false;
+            }
+            else
+            {
+                /*  If the directory has a valid filter, the filter failed to
+                    exclude a name which does not exist.  If that might be due
+                    to the bits of deleted names, invalidate the filter, and the
+                    next search which finds nothing will rebuild it without
+                    them.  Otherwise, rebuilding it would not help.
+                */
+                pFilter = DirFilterFind(pPInode->ulInode);
+
+                if((pFilter != NULL) && pFilter->fStale)
+                {
+                    pFilter->fValid = false;
+                }
+            }
+          #endif
+        }
+        else
+        {
+            if(pulInode != NULL)
+            {
+                *pulInode = ulInode;
+            }
+
+          #if REDCONF_DIRENT_CACHE_COUNT > 0U
+            DirNameCacheInsert(pPInode->ulInode, pszName, ulNameLen, ulIdx, ulInode);
+          #endif
+        }
+
+        if(pulEntryIdx != NULL)
+        {
+            *pulEntryIdx = ulIdx;
+        }
+    }
+
+    return ret;
+}
+
+
+#if (REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U)
+/** @brief Hash a name.
+
+    @param pszName      The name to hash, terminated by a null or by reaching
+                        @p ulNameLen.
+    @param ulNameLen    The maximum number of characters to hash.
+
+    @return The hash of the name.
+*/
+static uint32_t DirNameHash(
+    const char *pszName,
+    uint32_t    ulNameLen)
+{
+    uint32_t    ulHash = 2166136261U;
+    uint32_t    ulIdx = 0U;
+
+    /*  32-bit FNV-1a.
+    */
+    while((ulIdx < ulNameLen) && (pszName[ulIdx] != '\0'))
+    {
+        ulHash ^= (uint8_t)pszName[ulIdx];
+        ulHash *= 16777619U;
+        ulIdx++;
+    }
+
+    return ulHash;
+}
+#endif
+
+
+#if REDCONF_DIRENT_CACHE_COUNT > 0U
+/** @brief Look up a name in the name cache.
+
+    @param ulPInode     The inode number of the directory to search.
+    @param pszName      The name of the desired entry, terminated by either a
+                        null or a path separator.
+    @param ulNameLen    The length of @p pszName.
+    @param pulEntryIdx  If the name is cached, populated with the position of
+                        the entry.  Optional.
+    @param pulInode     If the name is cached, populated with the inode number
+                        that the name points to.  Optional.
+
+    @return Whether the name was found in the cache.
+*/
+static bool DirNameCacheFind(
+    uint32_t    ulPInode,
+    const char *pszName,
+    uint32_t    ulNameLen,
+    uint32_t   *pulEntryIdx,
+    uint32_t   *pulInode)
+{
+    const DIRCACHEENT  *pEnt = DirNameCacheSlot(ulPInode, pszName, ulNameLen);
+    bool                fFound = false;
+
+    if(    (pEnt->ulPInode == ulPInode)
+        && (pEnt->bVolNum == gbRedVolNum)
+        && (RedStrNCmp(pEnt->acName, pszName, ulNameLen) == 0)
+        && ((ulNameLen == REDCONF_NAME_MAX) || (pEnt->acName[ulNameLen] == '\0')))
+    {
+        if(pulEntryIdx != NULL)
+        {
+            *pulEntryIdx = pEnt->ulIdx;
+        }
+
+        if(pulInode != NULL)
+        {
+            *pulInode = pEnt->ulInode;
+        }
+
+        fFound = true;
+    }
+
+    return fFound;
+}
+
+
+/** @brief Add a directory entry to the name cache.
+
+    Replaces whatever was cached in the same slot.
+
+    @param ulPInode     The inode number of the directory containing the entry.
+    @param pszName      The name of the entry, terminated by either a null or a
+                        path separator.
+    @param ulNameLen    The length of @p pszName.
+    @param ulIdx        The position of the entry within the directory.
+    @param ulInode      The inode number that the entry points at.
+*/
+static void DirNameCacheInsert(
+    uint32_t    ulPInode,
+    const char *pszName,
+    uint32_t    ulNameLen,
+    uint32_t    ulIdx,
+    uint32_t    ulInode)
+{
+    DIRCACHEENT *pEnt = DirNameCacheSlot(ulPInode, pszName, ulNameLen);
+
+    pEnt->ulPInode = ulPInode;
+    pEnt->ulIdx = ulIdx;
+    pEnt->ulInode = ulInode;
+    pEnt->bVolNum = gbRedVolNum;
+    RedMemSet(pEnt->acName, 0U, sizeof(pEnt->acName));
+    RedStrNCpy(pEnt->acName, pszName, ulNameLen);
+}
+
+
+#if REDCONF_READ_ONLY == 0
+/** @brief Remove the name cached for a directory entry, if any.
+
+    @param ulPInode The inode number of the directory containing the entry.
+    @param ulIdx    The position of the entry within the directory, or
+                    DIR_INDEX_INVALID to remove every entry cached for the
+                    directory.
+*/
+static void DirNameCacheRemove(
+    uint32_t    ulPInode,
+    uint32_t    ulIdx)
+{
+    uint32_t    ulEnt;
+
+    /*  The cache is indexed by name, which the caller might not know, so
+        examine every slot.  The cache is small and this only happens when the
+        directory is modified, which costs far more.
+    */
+    for(ulEnt = 0U; ulEnt < REDCONF_DIRENT_CACHE_COUNT; ulEnt++)
+    {
+        DIRCACHEENT *pEnt = &gaDirNameCache[ulEnt];
+
+        if(    (pEnt->ulPInode == ulPInode)
+            && (pEnt->bVolNum == gbRedVolNum)
+            && ((ulIdx == DIR_INDEX_INVALID) || (pEnt->ulIdx == ulIdx)))
+        {
+            pEnt->ulPInode = INODE_INVALID;
+        }
+    }
+}
+#endif
+
+
+/** @brief Find the name cache slot for a name.
+
+    @param ulPInode     The inode number of the directory containing the name.
+    @param pszName      The name, terminated by either a null or a path
+                        separator.
+    @param ulNameLen    The length of @p pszName.
+
+    @return A pointer to the slot in which the name is cached, if it is cached.
+*/
+static DIRCACHEENT *DirNameCacheSlot(
+    uint32_t    ulPInode,
+    const char *pszName,
+    uint32_t    ulNameLen)
+{
+    uint32_t    ulHash = DirNameHash(pszName, ulNameLen);
+
+    /*  Mix in the directory and volume, so that common names like "tmp" in
+        different directories do not evict one another.
+    */
+    ulHash ^= (ulPInode + ((uint32_t)gbRedVolNum << 24U)) * 0x9E3779B1U;
+
+    return &gaDirNameCache[ulHash % REDCONF_DIRENT_CACHE_COUNT];
+}
+#endif /* REDCONF_DIRENT_CACHE_COUNT > 0U */
+
+
+#if REDCONF_DIR_FILTER_COUNT > 0U
+/** @brief Determine from the directory filter that a name does not exist.
+
+    @param ulPInode     The inode number of the directory to search.
+    @param pszName      The name of the desired entry, terminated by either a
+                        null or a path separator.
+    @param ulNameLen    The length of @p pszName.
+    @param pulFreeIdx   If the name does not exist (true is returned), populated
+                        with the position of the first available entry, or
+                        DIR_INDEX_INVALID if the directory is full.  Optional.
+
+    @return Whether the name is known not to exist.  When false is returned, the
+            name might or might not exist, and the directory must be searched.
+*/
+static bool DirFilterExcludes(
+    uint32_t    ulPInode,
+    const char *pszName,
+    uint32_t    ulNameLen,
+    uint32_t   *pulFreeIdx)
+{
+    DIRFILTER  *pFilter = DirFilterFind(ulPInode);
+    bool        fExcluded = false;
+
+    if((pFilter != NULL) && pFilter->fValid)
+    {
+        gulDirFilterUses++;
+        pFilter->ulLastUse = gulDirFilterUses;
+
+        if(!DirFilterTest(pFilter, pszName, ulNameLen))
+        {
+            if(pulFreeIdx != NULL)
+            {
+                *pulFreeIdx = pFilter->ulFreeIdx;
+            }
+
+            fExcluded = true;
+        }
+    }
+
+    return fExcluded;
+}
+
+
+/** @brief Take a directory filter for a directory, replacing the least recently
+           used filter.
+
+    @param ulPInode The inode number of the directory.
+
+    @return A pointer to the filter, which is not yet valid.
+*/
+static DIRFILTER *DirFilterClaim(
+    uint32_t    ulPInode)
+{
+    DIRFILTER  *pFilter = NULL;
+    uint32_t    ulFilter;
+
+    for(ulFilter = 0U; ulFilter < REDCONF_DIR_FILTER_COUNT; ulFilter++)
+    {
+        DIRFILTER *pCandidate = &gaDirFilter[ulFilter];
+
+        if(pCandidate->ulPInode == INODE_INVALID)
+        {
+            /*  An unused filter is the best choice.
+            */
+            pFilter = pCandidate;
+            break;
+        }
+
+        if((pFilter == NULL) || ((gulDirFilterUses - pCandidate->ulLastUse) > (gulDirFilterUses - pFilter->ulLastUse)))
+        {
+            pFilter = pCandidate;
+        }
+    }
+
+    gulDirFilterUses++;
+
+    pFilter->ulPInode = ulPInode;
+    pFilter->ulFreeIdx = DIR_INDEX_INVALID;
+    pFilter->ulLastUse = gulDirFilterUses;
+    pFilter->bVolNum = gbRedVolNum;
+    pFilter->fValid = false;
+    pFilter->fStale = false;
+
+    return pFilter;
+}
+
+
+/** @brief Find the directory filter for a directory.
+
+    @param ulPInode The inode number of the directory.
+
+    @return A pointer to the filter for the directory, which might not be valid;
+            or NULL if the directory has no filter.
+*/
+static DIRFILTER *DirFilterFind(
+    uint32_t    ulPInode)
+{
+    DIRFILTER  *pFilter = NULL;
+    uint32_t    ulFilter;
+
+    for(ulFilter = 0U; ulFilter < REDCONF_DIR_FILTER_COUNT; ulFilter++)
+    {
+        if((gaDirFilter[ulFilter].ulPInode == ulPInode) && (gaDirFilter[ulFilter].bVolNum == gbRedVolNum))
+        {
+            pFilter = &gaDirFilter[ulFilter];
+            break;
+        }
+    }
+
+    return pFilter;
+}
+
+
+/** @brief Clear a directory filter and size it for a directory.
+
+    @param pFilter          The filter to clear.
+    @param ulDirentCount    The number of directory entries, including available
+                            entries, in the directory.
+*/
+static void DirFilterSize(
+    DIRFILTER  *pFilter,
+    uint32_t    ulDirentCount)
+{
+    uint32_t    ulBits = 8U;
+
+    while((ulBits < DIR_FILTER_MAX_BITS) && ((ulBits / DIR_FILTER_BITS_PER_NAME) < ulDirentCount))
+    {
+        ulBits <<= 1U;
+    }
+
+    pFilter->ulBitMask = ulBits - 1U;
+    pFilter->ulNames = 0U;
+    RedMemSet(pFilter->abBits, 0U, ulBits / 8U);
+}
+
+
+/** @brief Add a name to a directory filter.
+
+    @param pFilter      The filter to update.
+    @param pszName      The name, terminated by a null or by reaching
+                        @p ulNameLen.
+    @param ulNameLen    The maximum length of @p pszName.
+*/
+static void DirFilterAdd(
+    DIRFILTER  *pFilter,
+    const char *pszName,
+    uint32_t    ulNameLen)
+{
+    uint32_t    ulHash = DirNameHash(pszName, ulNameLen);
+    uint32_t    ulHash2 = (ulHash ^ (ulHash >> 15U)) * 0x9E3779B1U;
+    uint32_t    ulBit1 = ulHash & pFilter->ulBitMask;
+    uint32_t    ulBit2 = ((ulHash2 >> 16U) | (ulHash2 << 16U)) & pFilter->ulBitMask;
+
+    pFilter->abBits[ulBit1 >> 3U] |= (uint8_t)(1U << (ulBit1 & 7U));
+    pFilter->abBits[ulBit2 >> 3U] |= (uint8_t)(1U << (ulBit2 & 7U));
+
+    pFilter->ulNames++;
+
+    /*  If the filter has outgrown its bits, most names would pass the test.
+        Let the next search rebuild it at a size suited to the directory, or
+        leave it unused if the directory is too large for any filter.
+    */
+    if(pFilter->ulNames > ((pFilter->ulBitMask + 1U) / DIR_FILTER_MIN_BITS_PER_NAME))
+    {
+        pFilter->fValid = false;
+    }
+}
+
+
+/** @brief Test whether a name might be in a directory filter.
+
+    @param pFilter      The filter to test.
+    @param pszName      The name, terminated by a null or by reaching
+                        @p ulNameLen.
+    @param ulNameLen    The maximum length of @p pszName.
+
+    @return Whether the name might have been added to the filter.
+*/
+static bool DirFilterTest(
+    const DIRFILTER    *pFilter,
+    const char         *pszName,
+    uint32_t            ulNameLen)
+{
+    uint32_t            ulHash = DirNameHash(pszName, ulNameLen);
+    uint32_t            ulHash2 = (ulHash ^ (ulHash >> 15U)) * 0x9E3779B1U;
+    uint32_t            ulBit1 = ulHash & pFilter->ulBitMask;
+    uint32_t            ulBit2 = ((ulHash2 >> 16U) | (ulHash2 << 16U)) & pFilter->ulBitMask;
+
+    return ((pFilter->abBits[ulBit1 >> 3U] & (1U << (ulBit1 & 7U))) != 0U)
+        && ((pFilter->abBits[ulBit2 >> 3U] & (1U << (ulBit2 & 7U))) != 0U);
+}
+#endif /* REDCONF_DIR_FILTER_COUNT > 0U */
+
+
+#if (REDCONF_READ_ONLY == 0) && ((REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U))
+/** @brief Update the name cache and directory filter after writing a directory
+           entry.
+
+    @param pPInode      A pointer to the cached inode structure of the directory
+                        whose entry was written.
+    @param ulIdx        The index of the directory entry which was written.
+    @param ulInode      The inode number the directory entry now points at, or
+                        INODE_INVALID if the entry was deleted.
+    @param pszName      The name of the directory entry.
+    @param ulNameLen    The length of @p pszName.
+    @param ulOldCount   The number of directory entries, including available
+                        entries, before the write.
+*/
+static void DirCacheEntryWritten(
+    const CINODE   *pPInode,
+    uint32_t        ulIdx,
+    uint32_t        ulInode,
+    const char     *pszName,
+    uint32_t        ulNameLen,
+    uint32_t        ulOldCount)
+{
+  #if REDCONF_DIR_FILTER_COUNT > 0U
+    DIRFILTER      *pFilter = DirFilterFind(pPInode->ulInode);
+  #endif
+
+  #if REDCONF_DIRENT_CACHE_COUNT > 0U
+    DirNameCacheRemove(pPInode->ulInode, ulIdx);
+
+    if(ulInode != INODE_INVALID)
+    {
+        DirNameCacheInsert(pPInode->ulInode, pszName, ulNameLen, ulIdx, ulInode);
+    }
+  #endif
+
+  #if REDCONF_DIR_FILTER_COUNT > 0U
+    if(pFilter == NULL)
+    {
+        /*  The directory has no filter, nothing to update.
+        */
+    }
+    else if(ulInode == INODE_INVALID)
+    {
+        /*  The deleted entry is available; its name stays in the filter.
+        */
+        pFilter->ulFreeIdx = REDMIN(pFilter->ulFreeIdx, ulIdx);
+        pFilter->fStale = true;
+    }
+    else
+    {
+        DirFilterAdd(pFilter, pszName, ulNameLen);
+
+        if(ulIdx == pFilter->ulFreeIdx)
+        {
+            /*  The first available entry was used.  Every entry before it is
+                in use, so if it was the last entry, the next one is the end of
+                the directory.  Otherwise, finding the next available entry
+                would require reading the directory; leave that for the next
+                search.
+            */
+            if((ulIdx + 1U) >= ulOldCount)
+            {
+                pFilter->ulFreeIdx = ((ulIdx + 1U) < DIRENTS_MAX) ? (ulIdx + 1U) : DIR_INDEX_INVALID;
+            }
+            else
+            {
+                pFilter->fValid = false;
+            }
+        }
+    }
+  #else
+    (void)ulOldCount;
+  #endif
+}
+
+
+#if DELETE_SUPPORTED
+/** @brief Update the name cache and directory filter after truncating a
+           directory to delete its last entry.
+
+    @param pPInode      A pointer to the cached inode structure of the directory
+                        which was truncated.
+    @param ulDeleteIdx  The index of the deleted directory entry.
+    @param ulTruncIdx   The index of the first directory entry which was
+                        truncated; the new number of directory entries.
+*/
+static void DirCacheTruncated(
+    const CINODE   *pPInode,
+    uint32_t        ulDeleteIdx,
+    uint32_t        ulTruncIdx)
+{
+  #if REDCONF_DIRENT_CACHE_COUNT > 0U
+    /*  The entries truncated along with the deleted entry were available, so
+        none of them were cached.
+    */
+    DirNameCacheRemove(pPInode->ulInode, ulDeleteIdx);
+  #else
+    (void)ulDeleteIdx;
+  #endif
+
+  #if REDCONF_DIR_FILTER_COUNT > 0U
+    {
+        DIRFILTER *pFilter = DirFilterFind(pPInode->ulInode);
+
+        if(pFilter != NULL)
+        {
+            pFilter->ulFreeIdx = REDMIN(pFilter->ulFreeIdx, ulTruncIdx);
+            pFilter->fStale = true;
+        }
+    }
+  #else
+    (void)ulTruncIdx;
+  #endif
+}
+#endif /* DELETE_SUPPORTED */
+
+
+/** @brief Forget everything cached about a directory.
+
+    Used when modifying the directory failed, leaving its contents uncertain.
+
+    @param pPInode  A pointer to the cached inode structure of the directory.
+*/
+static void DirCacheDiscard(
+    const CINODE   *pPInode)
+{
+  #if REDCONF_DIRENT_CACHE_COUNT > 0U
+    DirNameCacheRemove(pPInode->ulInode, DIR_INDEX_INVALID);
+  #endif
+
+  #if REDCONF_DIR_FILTER_COUNT > 0U
+    {
+        DIRFILTER *pFilter = DirFilterFind(pPInode->ulInode);
+
+        if(pFilter != NULL)
+        {
+            pFilter->fValid = false;
+        }
+    }
+  #endif
+}
+#endif
+
+
 
 #endif /* REDCONF_API_POSIX == 1 */
 
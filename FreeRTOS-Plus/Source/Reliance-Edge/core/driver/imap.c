@@ -33,6 +33,26 @@
 #include <redcore.h>
 
 
+#if REDCONF_READ_ONLY == 0
+/** The number of runs of free blocks which RedImapAllocSeek() examines.
+*/
+#define IMAP_SEEK_RUNS          4U
+
+/** How far past the next block to be allocated RedImapAllocSeek() will look for
+    a run of free blocks.
+*/
+#define IMAP_SEEK_BLOCKS        512U
+
+/** The smallest number of blocks for which RedImapAllocSeek() moves the
+    allocator.  For shorter writes, moving the allocator leaves behind small
+    runs of free blocks which later fragment other files.
+*/
+#define IMAP_SEEK_MIN_BLOCKS    32U
+
+static REDSTATUS ImapBlockFind(uint32_t ulBlockStart, uint32_t ulBlockEnd, bool fFree, uint32_t *pulBlock);
+#endif
+
+
 /** @brief Get the allocation bit of a block from either metaroot.
 
     Will pass the call down either to the inline imap or to the external imap
@@ -187,6 +207,13 @@ REDSTATUS RedImapBlockSet(
                 {
                     gpRedMR->ulFreeBlocks++;
                 }
+
+              #if REDCONF_IMAP_EXTERNAL == 1
+                if(!gpRedCoreVol->fImapInline)
+                {
+                    RedImapESummaryFree(ulBlock, fWasAllocated);
+                }
+              #endif
             }
         }
     }
@@ -223,40 +250,33 @@ REDSTATUS RedImapAllocBlock(
     }
     else
     {
-        uint32_t ulStopBlock = gpRedMR->ulAllocNextBlock;
-        bool     fAllocated = false;
+        uint32_t ulBlock;
+        bool     fFound = false;
 
-        do
-        {
-            ALLOCSTATE state;
+        /*  Search from the next block to the end of the volume, then wrap
+            around and search from the first allocable block up to where the
+            first search began.
+        */
+        ret = ImapBlockFind(gpRedMR->ulAllocNextBlock, gpRedVolume->ulBlockCount, true, &ulBlock);
 
-            ret = RedImapBlockState(gpRedMR->ulAllocNextBlock, &state);
-            CRITICAL_ASSERT(ret == 0);
+        if(ret == 0)
+        {
+            fFound = ulBlock < gpRedVolume->ulBlockCount;
 
-            if(ret == 0)
+            if(!fFound)
             {
-                if(state == ALLOCSTATE_FREE)
-                {
-                    ret = RedImapBlockSet(gpRedMR->ulAllocNextBlock, true);
-                    CRITICAL_ASSERT(ret == 0);
-
-                    *pulBlock = gpRedMR->ulAllocNextBlock;
-                    fAllocated = true;
-                }
+                ret = ImapBlockFind(gpRedCoreVol->ulFirstAllocableBN, gpRedMR->ulAllocNextBlock, true, &ulBlock);
 
-                /*  Increment the next block number, wrapping it when the end of
-                    the volume is reached.
-                */
-                gpRedMR->ulAllocNextBlock++;
-                if(gpRedMR->ulAllocNextBlock == gpRedVolume->ulBlockCount)
+                if(ret == 0)
                 {
-                    gpRedMR->ulAllocNextBlock = gpRedCoreVol->ulFirstAllocableBN;
+                    fFound = ulBlock < gpRedMR->ulAllocNextBlock;
                 }
             }
         }
-        while((ret == 0) && !fAllocated && (gpRedMR->ulAllocNextBlock != ulStopBlock));
 
-        if((ret == 0) && !fAllocated)
+        CRITICAL_ASSERT(ret == 0);
+
+        if((ret == 0) && !fFound)
         {
             /*  The free block count was already determined to be non-zero, no
                 error occurred while looking for free blocks, but no free blocks
@@ -265,6 +285,166 @@ REDSTATUS RedImapAllocBlock(
             CRITICAL_ERROR();
             ret = -RED_EFUBAR;
         }
+
+        if(ret == 0)
+        {
+            ret = RedImapBlockSet(ulBlock, true);
+            CRITICAL_ASSERT(ret == 0);
+        }
+
+        if(ret == 0)
+        {
+            *pulBlock = ulBlock;
+
+            /*  The next search starts after the allocated block, wrapping
+                when the end of the volume is reached.
+            */
+            gpRedMR->ulAllocNextBlock = ulBlock + 1U;
+            if(gpRedMR->ulAllocNextBlock == gpRedVolume->ulBlockCount)
+            {
+                gpRedMR->ulAllocNextBlock = gpRedCoreVol->ulFirstAllocableBN;
+            }
+
+          #if REDCONF_TRANSACT_BG_BLOCKS > 0U
+            /*  Wake the background transaction task once enough blocks have
+                been written to make a transaction point due.
+            */
+            gpRedCoreVol->ulDirtyBlocks++;
+            if(gpRedCoreVol->ulDirtyBlocks == REDCONF_TRANSACT_BG_BLOCKS)
+            {
+                RedOsMutexWakeAll();
+            }
+          #endif
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Move the allocator to the start of a run of free blocks.
+
+    Blocks are allocated one at a time, each one being the first free block
+    after the previous allocation.  When several blocks are about to be
+    allocated for a large write of file data, starting at a run of free blocks long enough to
+    hold all of them keeps the new blocks contiguous, so that they can be
+    written with a single request.
+
+    Only the first few runs near the next block to be allocated are examined,
+    since moving the allocator far away scatters the blocks of other files and
+    of metadata.  If none of the runs is long enough, the allocator is moved to
+    the longest one.
+
+    @param ulBlockCount The number of blocks which are about to be allocated.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+REDSTATUS RedImapAllocSeek(
+    uint32_t    ulBlockCount)
+{
+    REDSTATUS   ret = 0;
+
+    if((ulBlockCount >= IMAP_SEEK_MIN_BLOCKS) && (gpRedMR->ulFreeBlocks >= ulBlockCount))
+    {
+        uint32_t ulBlock = gpRedMR->ulAllocNextBlock;
+        uint32_t ulSeekEnd = ulBlock + REDMIN(IMAP_SEEK_BLOCKS, gpRedVolume->ulBlockCount - ulBlock);
+        uint32_t ulBestStart = ulBlock;
+        uint32_t ulBestCount = 0U;
+        uint32_t ulRuns = 0U;
+
+        while(    (ret == 0)
+               && (ulBlock < ulSeekEnd)
+               && (ulBestCount < ulBlockCount)
+               && (ulRuns < IMAP_SEEK_RUNS))
+        {
+            uint32_t ulRunStart;
+
+            ret = ImapBlockFind(ulBlock, ulSeekEnd, true, &ulRunStart);
+
+            if(ret == 0)
+            {
+                uint32_t ulRunEnd;
+
+                ret = ImapBlockFind(ulRunStart, ulRunStart + REDMIN(ulBlockCount, gpRedVolume->ulBlockCount - ulRunStart), false, &ulRunEnd);
+
+                if(ret == 0)
+                {
+                    if((ulRunEnd - ulRunStart) > ulBestCount)
+                    {
+                        ulBestStart = ulRunStart;
+                        ulBestCount = ulRunEnd - ulRunStart;
+                    }
+
+                    ulBlock = ulRunEnd;
+                    ulRuns++;
+                }
+            }
+        }
+
+        if((ret == 0) && (ulBestCount > 0U))
+        {
+            gpRedMR->ulAllocNextBlock = ulBestStart;
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Find the first block in a range which is free, or which is not free.
+
+    Will pass the call down either to the inline imap or to the external imap
+    implementation, whichever is appropriate for the current volume.
+
+    @param ulBlockStart The first block to examine.
+    @param ulBlockEnd   The block after the last block to examine.
+    @param fFree        Whether to find a free block (true) or a block which is
+                        not free (false).
+    @param pulBlock     On successful return, populated with the block number
+                        which was found, or with @p ulBlockEnd if there is no
+                        such block in the range.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The range is invalid; or @p pulBlock is `NULL`.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS ImapBlockFind(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockEnd,
+    bool        fFree,
+    uint32_t   *pulBlock)
+{
+    REDSTATUS   ret;
+
+    if(    (ulBlockStart < gpRedCoreVol->ulFirstAllocableBN)
+        || (ulBlockStart > ulBlockEnd)
+        || (ulBlockEnd > gpRedVolume->ulBlockCount)
+        || (pulBlock == NULL))
+    {
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+      #if (REDCONF_IMAP_INLINE == 1) && (REDCONF_IMAP_EXTERNAL == 1)
+        if(gpRedCoreVol->fImapInline)
+        {
+            ret = RedImapIBlockFind(ulBlockStart, ulBlockEnd, fFree, pulBlock);
+        }
+        else
+        {
+            ret = RedImapEBlockFind(ulBlockStart, ulBlockEnd, fFree, pulBlock);
+        }
+      #elif REDCONF_IMAP_INLINE == 1
+        ret = RedImapIBlockFind(ulBlockStart, ulBlockEnd, fFree, pulBlock);
+      #else
+        ret = RedImapEBlockFind(ulBlockStart, ulBlockEnd, fFree, pulBlock);
+      #endif
     }
 
     return ret;
@@ -38,6 +38,8 @@
 
 
 #if REDCONF_READ_ONLY == 0
+static REDSTATUS ImapNodeFind(uint32_t ulImapNode, uint32_t ulEntryStart, uint32_t ulEntryEnd, bool fFree, uint32_t *pulEntry);
+static REDSTATUS ImapNodeBitFind(uint8_t bMR, uint32_t ulImapNode, uint32_t ulEntryStart, uint32_t ulEntryEnd, bool fSet, uint32_t *pulEntry);
 static REDSTATUS ImapNodeBranch(uint32_t ulImapNode, IMAPNODE **ppImap);
 static bool ImapNodeIsBranched(uint32_t ulImapNode);
 #endif
@@ -173,6 +175,282 @@ REDSTATUS RedImapEBlockSet(
 }
 
 
+/** @brief Find the first block in a range which is free, or which is not free.
+
+    When looking for a free block, imap nodes which the imap summary records as
+    full are skipped without being read, and imap nodes which are found to
+    contain no free blocks are recorded as full.
+
+    @param ulBlockStart The first block to examine.
+    @param ulBlockEnd   The block after the last block to examine.
+    @param fFree        Whether to find a free block (true) or a block which is
+                        not free (false).
+    @param pulBlock     On successful return, populated with the block number
+                        which was found, or with @p ulBlockEnd if there is no
+                        such block in the range.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The range is invalid; or @p pulBlock is `NULL`.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+REDSTATUS RedImapEBlockFind(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockEnd,
+    bool        fFree,
+    uint32_t   *pulBlock)
+{
+    REDSTATUS   ret = 0;
+
+    if(    gpRedCoreVol->fImapInline
+        || (ulBlockStart < gpRedCoreVol->ulInodeTableStartBN)
+        || (ulBlockStart > ulBlockEnd)
+        || (ulBlockEnd > gpRedVolume->ulBlockCount)
+        || (pulBlock == NULL))
+    {
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint32_t    ulOffset = ulBlockStart - gpRedCoreVol->ulInodeTableStartBN;
+        uint32_t    ulOffsetEnd = ulBlockEnd - gpRedCoreVol->ulInodeTableStartBN;
+        uint32_t    ulAllocableOffset = gpRedCoreVol->ulFirstAllocableBN - gpRedCoreVol->ulInodeTableStartBN;
+        uint32_t    ulImapEntries = gpRedVolume->ulBlockCount - gpRedCoreVol->ulInodeTableStartBN;
+
+        while((ret == 0) && (ulOffset < ulOffsetEnd))
+        {
+            uint32_t ulImapNode = ulOffset / IMAPNODE_ENTRIES;
+            uint32_t ulNodeOffset = ulImapNode * IMAPNODE_ENTRIES;
+            uint32_t ulNodeEnd = REDMIN(ulNodeOffset + IMAPNODE_ENTRIES, ulOffsetEnd);
+            uint32_t ulFound = ulNodeEnd;
+
+            if(fFree && RedBitGet(gpRedCoreVol->abImapFull, ulImapNode))
+            {
+                /*  The imap node is known to be full: skip it.
+                */
+            }
+            else
+            {
+                uint32_t ulEntry;
+
+                ret = ImapNodeFind(ulImapNode, ulOffset - ulNodeOffset, ulNodeEnd - ulNodeOffset, fFree, &ulEntry);
+
+                if(ret == 0)
+                {
+                    ulFound = ulNodeOffset + ulEntry;
+
+                    /*  If every allocable block in the imap node was examined
+                        and none of them was free, remember that the node is
+                        full.
+                    */
+                    if(    fFree
+                        && (ulFound == ulNodeEnd)
+                        && ((ulOffset == ulNodeOffset) || (ulOffset <= ulAllocableOffset))
+                        && (ulNodeEnd == REDMIN(ulNodeOffset + IMAPNODE_ENTRIES, ulImapEntries)))
+                    {
+                        RedBitSet(gpRedCoreVol->abImapFull, ulImapNode);
+                    }
+                }
+            }
+
+            if(ret == 0)
+            {
+                /*  If a block was found, stop searching.
+                */
+                if(ulFound < ulNodeEnd)
+                {
+                    ulOffsetEnd = ulFound;
+                }
+
+                ulOffset = ulFound;
+            }
+        }
+
+        if(ret == 0)
+        {
+            *pulBlock = ulOffset + gpRedCoreVol->ulInodeTableStartBN;
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Record in the imap summary that a block has been freed.
+
+    @param ulBlock      The block which was freed.
+    @param fAlmostFree  Whether the block is almost free (true), and will only
+                        become free after the next transaction; or whether it
+                        is free now (false).
+*/
+void RedImapESummaryFree(
+    uint32_t    ulBlock,
+    bool        fAlmostFree)
+{
+    if(    gpRedCoreVol->fImapInline
+        || (ulBlock < gpRedCoreVol->ulInodeTableStartBN)
+        || (ulBlock >= gpRedVolume->ulBlockCount))
+    {
+        REDERROR();
+    }
+    else
+    {
+        uint32_t ulImapNode = (ulBlock - gpRedCoreVol->ulInodeTableStartBN) / IMAPNODE_ENTRIES;
+
+        if(fAlmostFree)
+        {
+            RedBitSet(gpRedCoreVol->abImapAFree, ulImapNode);
+        }
+        else
+        {
+            RedBitClear(gpRedCoreVol->abImapFull, ulImapNode);
+        }
+    }
+}
+
+
+/** @brief Update the imap summary after a transaction.
+
+    The blocks which were almost free are now free, so the imap nodes which
+    contain them are no longer full.
+*/
+void RedImapESummaryTransact(void)
+{
+    uint32_t ulIdx;
+
+    for(ulIdx = 0U; ulIdx < ((gpRedCoreVol->ulImapNodeCount + 7U) / 8U); ulIdx++)
+    {
+        gpRedCoreVol->abImapFull[ulIdx] &= (uint8_t)(~gpRedCoreVol->abImapAFree[ulIdx]);
+        gpRedCoreVol->abImapAFree[ulIdx] = 0U;
+    }
+}
+
+
+/** @brief Forget everything in the imap summary.
+
+    Called when the volume is mounted, at which point nothing is known about
+    which imap nodes are full.
+*/
+void RedImapESummaryReset(void)
+{
+    RedMemSet(gpRedCoreVol->abImapFull, 0U, sizeof(gpRedCoreVol->abImapFull));
+    RedMemSet(gpRedCoreVol->abImapAFree, 0U, sizeof(gpRedCoreVol->abImapAFree));
+}
+
+
+/** @brief Find the first entry in a range of an imap node whose block is free,
+           or is not free.
+
+    @param ulImapNode   The imap node to examine.
+    @param ulEntryStart The first entry to examine.
+    @param ulEntryEnd   The entry after the last entry to examine.
+    @param fFree        Whether to find a free block (true) or a block which is
+                        not free (false).
+    @param pulEntry     On successful return, populated with the entry which was
+                        found, or with @p ulEntryEnd if there is no such entry.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS ImapNodeFind(
+    uint32_t    ulImapNode,
+    uint32_t    ulEntryStart,
+    uint32_t    ulEntryEnd,
+    bool        fFree,
+    uint32_t   *pulEntry)
+{
+    REDSTATUS   ret;
+    uint32_t    ulEntry;
+
+    ret = ImapNodeBitFind(gpRedCoreVol->bCurMR, ulImapNode, ulEntryStart, ulEntryEnd, !fFree, &ulEntry);
+
+    /*  If the imap node is not branched, both metaroots point at the same copy
+        of it, so there is nothing more to examine.  Otherwise the committed
+        state copy must be examined too.  Only one imap node buffer is certain
+        to be available, so the two copies are examined one at a time.
+    */
+    if((ret == 0) && ImapNodeIsBranched(ulImapNode))
+    {
+        uint8_t bOldMR = 1U - gpRedCoreVol->bCurMR;
+
+        if(fFree)
+        {
+            uint32_t ulNext;
+
+            /*  Skip to the next clear bit in each copy in turn, until both
+                copies agree on an entry (or the end of the range).
+            */
+            do
+            {
+                ret = ImapNodeBitFind(bOldMR, ulImapNode, ulEntry, ulEntryEnd, false, &ulNext);
+
+                if((ret == 0) && (ulNext != ulEntry))
+                {
+                    ret = ImapNodeBitFind(gpRedCoreVol->bCurMR, ulImapNode, ulNext, ulEntryEnd, false, &ulEntry);
+                }
+            }
+            while((ret == 0) && (ulNext != ulEntry));
+        }
+        else
+        {
+            ret = ImapNodeBitFind(bOldMR, ulImapNode, ulEntryStart, ulEntry, true, &ulEntry);
+        }
+    }
+
+    if(ret == 0)
+    {
+        *pulEntry = ulEntry;
+    }
+
+    return ret;
+}
+
+
+/** @brief Find the first set or clear bit in a range of one copy of an imap
+           node.
+
+    @param bMR          The metaroot index which selects the copy: either 0 or
+                        1.
+    @param ulImapNode   The imap node to examine.
+    @param ulEntryStart The first entry to examine.
+    @param ulEntryEnd   The entry after the last entry to examine.
+    @param fSet         Whether to find a set bit (true) or a clear bit (false).
+    @param pulEntry     On successful return, populated with the entry which was
+                        found, or with @p ulEntryEnd if there is no such entry.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS ImapNodeBitFind(
+    uint8_t     bMR,
+    uint32_t    ulImapNode,
+    uint32_t    ulEntryStart,
+    uint32_t    ulEntryEnd,
+    bool        fSet,
+    uint32_t   *pulEntry)
+{
+    REDSTATUS   ret;
+    IMAPNODE   *pImap;
+
+    ret = RedBufferGet(RedImapNodeBlock(bMR, ulImapNode), BFLAG_META_IMAP, CAST_VOID_PTR_PTR(&pImap));
+
+    if(ret == 0)
+    {
+        *pulEntry = RedBitFind(pImap->abEntries, ulEntryStart, ulEntryEnd, fSet);
+
+        RedBufferPut(pImap);
+    }
+
+    return ret;
+}
+
+
 /** @brief Branch an imap node and get a buffer for it.
 
     If the imap node is already branched, it can be overwritten in its current
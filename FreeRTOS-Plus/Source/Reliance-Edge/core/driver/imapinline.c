@@ -127,6 +127,81 @@ REDSTATUS RedImapIBlockSet(
 
     return ret;
 }
+
+
+/** @brief Find the first block in a range which is free, or which is not free.
+
+    A block is free when its allocation bit is clear in both metaroots.
+
+    @param ulBlockStart The first block to examine.
+    @param ulBlockEnd   The block after the last block to examine.
+    @param fFree        Whether to find a free block (true) or a block which is
+                        not free (false).
+    @param pulBlock     On successful return, populated with the block number
+                        which was found, or with @p ulBlockEnd if there is no
+                        such block in the range.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The range is invalid; @p pulBlock is `NULL`; or the
+                        current volume does not use the inline imap.
+*/
+REDSTATUS RedImapIBlockFind(
+    uint32_t    ulBlockStart,
+    uint32_t    ulBlockEnd,
+    bool        fFree,
+    uint32_t   *pulBlock)
+{
+    REDSTATUS   ret;
+
+    if(    (!gpRedCoreVol->fImapInline)
+        || (ulBlockStart < gpRedCoreVol->ulInodeTableStartBN)
+        || (ulBlockStart > ulBlockEnd)
+        || (ulBlockEnd > gpRedVolume->ulBlockCount)
+        || (pulBlock == NULL))
+    {
+        REDERROR();
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        const uint8_t  *pbCurrent = gpRedCoreVol->aMR[gpRedCoreVol->bCurMR].abEntries;
+        const uint8_t  *pbOld = gpRedCoreVol->aMR[1U - gpRedCoreVol->bCurMR].abEntries;
+        uint32_t        ulOffset = ulBlockStart - gpRedCoreVol->ulInodeTableStartBN;
+        uint32_t        ulOffsetEnd = ulBlockEnd - gpRedCoreVol->ulInodeTableStartBN;
+
+        if(fFree)
+        {
+            uint32_t ulNext = ulOffset;
+
+            /*  Skip to the next clear bit in each bitmap in turn, until both
+                bitmaps agree on a block (or the end of the range).
+            */
+            do
+            {
+                ulOffset = RedBitFind(pbCurrent, ulNext, ulOffsetEnd, false);
+                ulNext = RedBitFind(pbOld, ulOffset, ulOffsetEnd, false);
+            }
+            while(ulNext != ulOffset);
+        }
+        else
+        {
+            /*  The first block which is not free is whichever comes first: the
+                first set bit in the working-state bitmap, or the first set bit
+                in the committed-state bitmap.
+            */
+            uint32_t ulSetCurrent = RedBitFind(pbCurrent, ulOffset, ulOffsetEnd, true);
+
+            ulOffset = RedBitFind(pbOld, ulOffset, ulSetCurrent, true);
+        }
+
+        *pulBlock = ulOffset + gpRedCoreVol->ulInodeTableStartBN;
+        ret = 0;
+    }
+
+    return ret;
+}
 #endif
 
 #endif /* REDCONF_IMAP_INLINE == 1 */
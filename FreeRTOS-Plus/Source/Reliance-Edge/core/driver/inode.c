@@ -466,6 +466,14 @@ REDSTATUS RedInodeFree(
             }
         }
 
+        /*  The inode number can be allocated again, so the search for a free
+            inode must not skip it.
+        */
+        if(pInode->ulInode < gpRedCoreVol->ulInodeFreeHint)
+        {
+            gpRedCoreVol->ulInodeFreeHint = pInode->ulInode;
+        }
+
         pInode->ulInode = INODE_INVALID;
 
         if(ret == 0)
@@ -808,7 +816,10 @@ static REDSTATUS InodeFindFree(
 
         ret = 0;
 
-        for(ulInode = INODE_FIRST_FREE; ulInode < (INODE_FIRST_VALID + gpRedVolConf->ulInodeCount); ulInode++)
+        /*  Every inode number below the hint is allocated, so start there
+            rather than examining the allocated inodes again each time.
+        */
+        for(ulInode = gpRedCoreVol->ulInodeFreeHint; ulInode < (INODE_FIRST_VALID + gpRedVolConf->ulInodeCount); ulInode++)
         {
             bool fFree;
 
@@ -824,6 +835,10 @@ static REDSTATUS InodeFindFree(
         {
             if(ulInode < (INODE_FIRST_VALID + gpRedVolConf->ulInodeCount))
             {
+                /*  The caller might not allocate the inode after all, so the
+                    hint cannot move past it.
+                */
+                gpRedCoreVol->ulInodeFreeHint = ulInode;
                 *pulInode = ulInode;
             }
             else
@@ -69,11 +69,22 @@ static REDSTATUS ExpandPrepare(CINODE *pInode);
 static void SeekCoord(CINODE *pInode, uint32_t ulBlock);
 static REDSTATUS ReadUnaligned(CINODE *pInode, uint64_t ullStart, uint32_t ulLen, uint8_t *pbBuffer);
 static REDSTATUS ReadAligned(CINODE *pInode, uint32_t ulBlockStart, uint32_t ulBlockCount, uint8_t *pbBuffer);
+static REDSTATUS ReadExtent(CINODE *pInode, uint32_t ulExtentStart, uint32_t ulExtentLen, uint8_t *pbBuffer);
+#if REDCONF_READ_AHEAD > 0U
+static bool ReadAheadCovers(const REDREADAHEAD *pReadAhead, uint32_t ulBlockFirst, uint32_t ulBlockLast);
+static REDSTATUS ReadAhead(CINODE *pInode, uint32_t ulBlockStart, REDREADAHEAD *pReadAhead);
+static REDSTATUS ReadMapped(const REDREADAHEAD *pReadAhead, uint64_t ullStart, uint32_t ulLen, uint8_t *pbBuffer);
+#endif
 #if REDCONF_READ_ONLY == 0
 static REDSTATUS WriteUnaligned(CINODE *pInode, uint64_t ullStart, uint32_t ulLen, const uint8_t *pbBuffer);
 static REDSTATUS WriteAligned(CINODE *pInode, uint32_t ulBlockStart, uint32_t *pulBlockCount, const uint8_t *pbBuffer);
+static REDSTATUS WriteExtent(CINODE *pInode, uint32_t ulExtentStart, uint32_t ulExtentLen, const uint8_t *pbBuffer);
 #endif
 static REDSTATUS GetExtent(CINODE *pInode, uint32_t ulBlockStart, uint32_t *pulExtentStart, uint32_t *pulExtentLen);
+#if REDCONF_CONCURRENT_IO == 1
+static bool IoUnlock(CINODE *pInode, bool fWrite);
+static REDSTATUS IoRelock(CINODE *pInode, uint8_t bVolNum, bool fWrite, bool fBranch);
+#endif
 #if REDCONF_READ_ONLY == 0
 static REDSTATUS BranchBlock(CINODE *pInode, BRANCHDEPTH depth, bool fBuffer);
 static REDSTATUS BranchOneBlock(uint32_t *pulBlock, void **ppBuffer, uint16_t uBFlag);
@@ -192,6 +203,113 @@ REDSTATUS RedInodeDataRead(
 }
 
 
+#if REDCONF_READ_AHEAD > 0U
+/** @brief Read data from an inode which may be being read sequentially.
+
+    A read which starts where the previous read with the same @p pReadAhead
+    ended, and which spans fewer than ::REDCONF_READ_AHEAD blocks, is treated
+    as sequential: the blocks it needs, and the blocks which follow them, are
+    read ahead into the block buffers, and their locations are saved in
+    @p pReadAhead.  The sequential reads which follow are then copied from the
+    buffers without seeking through the inode, until they move beyond the
+    blocks which were read ahead.  Other reads behave like RedInodeDataRead().
+
+    @param pInode       A pointer to the cached inode structure of the inode
+                        from which to read.
+    @param ullStart     The file offset at which to read.
+    @param pulLen       On input, the number of bytes to attempt to read.  On
+                        successful return, populated with the number of bytes
+                        actually read.
+    @param pBuffer      The buffer to read into.
+    @param pReadAhead   The sequential read state for the handle being read.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL @p pInode is not a mounted cached inode pointer; or
+                        @p pulLen is `NULL`; or @p pBuffer is `NULL`; or
+                        @p pReadAhead is `NULL`.
+*/
+REDSTATUS RedInodeDataReadSeq(
+    CINODE         *pInode,
+    uint64_t        ullStart,
+    uint32_t       *pulLen,
+    void           *pBuffer,
+    REDREADAHEAD   *pReadAhead)
+{
+    REDSTATUS       ret = 0;
+
+    if(!CINODE_IS_MOUNTED(pInode) || (pulLen == NULL) || (pBuffer == NULL) || (pReadAhead == NULL))
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        bool fDone = false;
+
+        /*  If the file data might have moved since the blocks were read ahead,
+            forget where they were.
+        */
+        if(pReadAhead->ulMapSeq != gpRedCoreVol->ulMapSeq)
+        {
+            pReadAhead->ulMapCount = 0U;
+        }
+
+        if(    (ullStart == pReadAhead->ullNextOffset)
+            && (ullStart < pInode->pInodeBuf->ullSize)
+            && (*pulLen > 0U))
+        {
+            uint32_t ulLen = *pulLen;
+            uint32_t ulBlockFirst = (uint32_t)(ullStart >> BLOCK_SIZE_P2);
+            uint32_t ulBlockLast;
+
+            if((pInode->pInodeBuf->ullSize - ullStart) < ulLen)
+            {
+                ulLen = (uint32_t)(pInode->pInodeBuf->ullSize - ullStart);
+            }
+
+            ulBlockLast = (uint32_t)(((ullStart + ulLen) - 1U) >> BLOCK_SIZE_P2);
+
+            /*  Larger reads are left to RedInodeDataRead(), which reads whole
+                blocks straight from disk, a contiguous extent at a time.
+            */
+            if((ulBlockLast - ulBlockFirst) < REDCONF_READ_AHEAD)
+            {
+                if(!ReadAheadCovers(pReadAhead, ulBlockFirst, ulBlockLast))
+                {
+                    ret = ReadAhead(pInode, ulBlockFirst, pReadAhead);
+                }
+
+                if((ret == 0) && ReadAheadCovers(pReadAhead, ulBlockFirst, ulBlockLast))
+                {
+                    ret = ReadMapped(pReadAhead, ullStart, ulLen, CAST_VOID_PTR_TO_UINT8_PTR(pBuffer));
+
+                    if(ret == 0)
+                    {
+                        *pulLen = ulLen;
+                        fDone = true;
+                    }
+                }
+            }
+        }
+
+        if((ret == 0) && !fDone)
+        {
+            ret = RedInodeDataRead(pInode, ullStart, pulLen, pBuffer);
+        }
+
+        if(ret == 0)
+        {
+            pReadAhead->ullNextOffset = ullStart + *pulLen;
+        }
+    }
+
+    return ret;
+}
+#endif /* REDCONF_READ_AHEAD > 0U */
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Write to an inode.
 
@@ -243,6 +361,12 @@ REDSTATUS RedInodeDataWrite(
         uint32_t        ulLen = *pulLen;
         uint32_t        ulRemaining;
 
+      #if REDCONF_READ_AHEAD > 0U
+        /*  Writing branches file data to new blocks.
+        */
+        gpRedCoreVol->ulMapSeq++;
+      #endif
+
         if((INODE_SIZE_MAX - ullStart) < ulLen)
         {
             ulLen = (uint32_t)(INODE_SIZE_MAX - ullStart);
@@ -381,6 +505,13 @@ REDSTATUS RedInodeDataTruncate(
     }
     else
     {
+      #if REDCONF_READ_AHEAD > 0U
+        /*  Truncating frees file data blocks, and expanding may branch the
+            last one.
+        */
+        gpRedCoreVol->ulMapSeq++;
+      #endif
+
         if(ullSize > pInode->pInodeBuf->ullSize)
         {
             ret = ExpandPrepare(pInode);
@@ -1235,7 +1366,7 @@ static REDSTATUS ReadAligned(
                 if(ret == 0)
               #endif
                 {
-                    ret = RedIoRead(gbRedVolNum, ulExtentStart, ulExtentLen, &pbBuffer[ulBlockIndex << BLOCK_SIZE_P2]);
+                    ret = ReadExtent(pInode, ulExtentStart, ulExtentLen, &pbBuffer[ulBlockIndex << BLOCK_SIZE_P2]);
 
                     if(ret == 0)
                     {
@@ -1263,6 +1394,226 @@ static REDSTATUS ReadAligned(
 }
 
 
+/** @brief Read a contiguous extent of file data straight from disk.
+
+    If the file was entered with RedCoreFileIoEnter(), the file system mutex is
+    released during the read; see IoUnlock().
+
+    @param pInode           A pointer to the cached inode structure.
+    @param ulExtentStart    The physical block number of the extent.
+    @param ulExtentLen      The number of blocks in the extent.
+    @param pbBuffer         The buffer to read into.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL Invalid parameters.
+*/
+static REDSTATUS ReadExtent(
+    CINODE     *pInode,
+    uint32_t    ulExtentStart,
+    uint32_t    ulExtentLen,
+    uint8_t    *pbBuffer)
+{
+    REDSTATUS   ret;
+
+  #if REDCONF_CONCURRENT_IO == 1
+    if(pInode->fIoUnlock)
+    {
+        uint8_t     bVolNum = gbRedVolNum;
+        bool        fBranch = IoUnlock(pInode, false);
+        REDSTATUS   relockRet;
+
+        ret = RedIoRead(bVolNum, ulExtentStart, ulExtentLen, pbBuffer);
+
+        relockRet = IoRelock(pInode, bVolNum, false, fBranch);
+        if(ret == 0)
+        {
+            ret = relockRet;
+        }
+    }
+    else
+  #else
+    (void)pInode;
+  #endif
+    {
+        ret = RedIoRead(gbRedVolNum, ulExtentStart, ulExtentLen, pbBuffer);
+    }
+
+    return ret;
+}
+
+
+#if REDCONF_READ_AHEAD > 0U
+/** @brief Determine whether the blocks which were read ahead include a range.
+
+    @param pReadAhead   The sequential read state.
+    @param ulBlockFirst The first file block offset in the range.
+    @param ulBlockLast  The last file block offset in the range.
+
+    @return Whether the locations of all of the blocks in the range are known.
+*/
+static bool ReadAheadCovers(
+    const REDREADAHEAD *pReadAhead,
+    uint32_t            ulBlockFirst,
+    uint32_t            ulBlockLast)
+{
+    return (pReadAhead->ulMapCount > 0U)
+        && (ulBlockFirst >= pReadAhead->ulMapStart)
+        && ((ulBlockLast - pReadAhead->ulMapStart) < pReadAhead->ulMapCount);
+}
+
+
+/** @brief Read blocks of an inode into the block buffers ahead of their use.
+
+    Seeks to each of up to ::REDCONF_READ_AHEAD blocks, stopping at the end of
+    the file, saving their locations in @p pReadAhead.  The blocks are then
+    read into the buffers with one request for each contiguous extent.
+
+    @param pInode       A pointer to the cached inode structure.
+    @param ulBlockStart The file block offset at which to start.
+    @param pReadAhead   The sequential read state, in which to save the block
+                        locations.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL Invalid parameters.
+*/
+static REDSTATUS ReadAhead(
+    CINODE         *pInode,
+    uint32_t        ulBlockStart,
+    REDREADAHEAD   *pReadAhead)
+{
+    REDSTATUS       ret = 0;
+    uint32_t        ulFileBlocks = (uint32_t)((pInode->pInodeBuf->ullSize + (REDCONF_BLOCK_SIZE - 1U)) >> BLOCK_SIZE_P2);
+    uint32_t        ulBlockCount = REDCONF_READ_AHEAD;
+    uint32_t        ulIdx;
+
+    REDASSERT(ulBlockStart < ulFileBlocks);
+
+    if((ulFileBlocks - ulBlockStart) < ulBlockCount)
+    {
+        ulBlockCount = ulFileBlocks - ulBlockStart;
+    }
+
+    pReadAhead->ulMapCount = 0U;
+
+    /*  Consecutive blocks usually share an indirect node, so the seeks after
+        the first are cheap.
+    */
+    for(ulIdx = 0U; ulIdx < ulBlockCount; ulIdx++)
+    {
+        ret = RedInodeDataSeek(pInode, ulBlockStart + ulIdx);
+
+        if(ret == 0)
+        {
+            pReadAhead->aulMap[ulIdx] = pInode->ulDataBlock;
+        }
+        else if(ret == -RED_ENODATA)
+        {
+            pReadAhead->aulMap[ulIdx] = BLOCK_SPARSE;
+            ret = 0;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if(ret == 0)
+    {
+        pReadAhead->ulMapSeq = gpRedCoreVol->ulMapSeq;
+        pReadAhead->ulMapStart = ulBlockStart;
+        pReadAhead->ulMapCount = ulBlockCount;
+
+        ulIdx = 0U;
+        while(ulIdx < ulBlockCount)
+        {
+            uint32_t ulExtentLen = 1U;
+
+            if(pReadAhead->aulMap[ulIdx] != BLOCK_SPARSE)
+            {
+                while(    ((ulIdx + ulExtentLen) < ulBlockCount)
+                       && (pReadAhead->aulMap[ulIdx + ulExtentLen] == (pReadAhead->aulMap[ulIdx] + ulExtentLen)))
+                {
+                    ulExtentLen++;
+                }
+
+                /*  Reading ahead is only an optimization.  If it fails, the
+                    error will be reported when the block is actually read.
+                */
+                (void)RedBufferReadAhead(pReadAhead->aulMap[ulIdx], ulExtentLen);
+            }
+
+            ulIdx += ulExtentLen;
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Read data from blocks which were read ahead.
+
+    @param pReadAhead   The sequential read state, which must cover every block
+                        in the range being read.
+    @param ullStart     The file offset at which to read.
+    @param ulLen        The number of bytes to read.
+    @param pbBuffer     The buffer to read into.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL Invalid parameters.
+*/
+static REDSTATUS ReadMapped(
+    const REDREADAHEAD *pReadAhead,
+    uint64_t            ullStart,
+    uint32_t            ulLen,
+    uint8_t            *pbBuffer)
+{
+    REDSTATUS           ret = 0;
+    uint32_t            ulReadIndex = 0U;
+
+    while((ret == 0) && (ulReadIndex < ulLen))
+    {
+        uint64_t    ullOffset = ullStart + ulReadIndex;
+        uint32_t    ulBlockOffset = (uint32_t)(ullOffset & (REDCONF_BLOCK_SIZE - 1U));
+        uint32_t    ulThisRead = REDMIN(ulLen - ulReadIndex, REDCONF_BLOCK_SIZE - ulBlockOffset);
+        uint32_t    ulBlock = pReadAhead->aulMap[(uint32_t)(ullOffset >> BLOCK_SIZE_P2) - pReadAhead->ulMapStart];
+
+        if(ulBlock == BLOCK_SPARSE)
+        {
+            /*  Sparse block, return zeroed data.
+            */
+            RedMemSet(&pbBuffer[ulReadIndex], 0U, ulThisRead);
+        }
+        else
+        {
+            uint8_t *pbData;
+
+            ret = RedBufferGet(ulBlock, 0U, CAST_VOID_PTR_PTR(&pbData));
+
+            if(ret == 0)
+            {
+                RedMemCpy(&pbBuffer[ulReadIndex], &pbData[ulBlockOffset], ulThisRead);
+
+                RedBufferPut(pbData);
+            }
+        }
+
+        ulReadIndex += ulThisRead;
+    }
+
+    return ret;
+}
+#endif /* REDCONF_READ_AHEAD > 0U */
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Write an unaligned portion of a block.
 
@@ -1350,9 +1701,15 @@ static REDSTATUS WriteAligned(
         uint32_t ulBlockCount = *pulBlockCount;
         uint32_t ulBlockIndex;
 
+        /*  Move the allocator to a run of free blocks long enough for the whole
+            write, so that the data blocks allocated below are contiguous and
+            can be written with fewer requests.
+        */
+        ret = RedImapAllocSeek(ulBlockCount);
+
         /*  Branch all of the file data blocks in advance.
         */
-        for(ulBlockIndex = 0U; (ulBlockIndex < ulBlockCount) && !fFull; ulBlockIndex++)
+        for(ulBlockIndex = 0U; (ret == 0) && (ulBlockIndex < ulBlockCount) && !fFull; ulBlockIndex++)
         {
             ret = RedInodeDataSeek(pInode, ulBlockStart + ulBlockIndex);
 
@@ -1396,7 +1753,7 @@ static REDSTATUS WriteAligned(
 
             if(ret == 0)
             {
-                ret = RedIoWrite(gbRedVolNum, ulExtentStart, ulExtentLen, &pbBuffer[ulBlockIndex << BLOCK_SIZE_P2]);
+                ret = WriteExtent(pInode, ulExtentStart, ulExtentLen, &pbBuffer[ulBlockIndex << BLOCK_SIZE_P2]);
 
                 if(ret == 0)
                 {
@@ -1421,6 +1778,59 @@ static REDSTATUS WriteAligned(
 
     return ret;
 }
+
+
+/** @brief Write a contiguous extent of file data straight to disk.
+
+    If the file was entered for writing with RedCoreFileIoEnter(), the file
+    system mutex is released during the write, unless a transaction point is
+    waiting for the writes already in progress; see IoUnlock().
+
+    @param pInode           A pointer to the cached inode structure.  The
+                            blocks in the extent must already be branched.
+    @param ulExtentStart    The physical block number of the extent.
+    @param ulExtentLen      The number of blocks in the extent.
+    @param pbBuffer         The buffer to write from.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_EINVAL Invalid parameters.
+*/
+static REDSTATUS WriteExtent(
+    CINODE         *pInode,
+    uint32_t        ulExtentStart,
+    uint32_t        ulExtentLen,
+    const uint8_t  *pbBuffer)
+{
+    REDSTATUS       ret;
+
+  #if REDCONF_CONCURRENT_IO == 1
+    if(pInode->fIoUnlock && (gpRedCoreVol->uIoTransactWaiters == 0U))
+    {
+        uint8_t     bVolNum = gbRedVolNum;
+        bool        fBranch = IoUnlock(pInode, true);
+        REDSTATUS   relockRet;
+
+        ret = RedIoWrite(bVolNum, ulExtentStart, ulExtentLen, pbBuffer);
+
+        relockRet = IoRelock(pInode, bVolNum, true, fBranch);
+        if(ret == 0)
+        {
+            ret = relockRet;
+        }
+    }
+    else
+  #else
+    (void)pInode;
+  #endif
+    {
+        ret = RedIoWrite(gbRedVolNum, ulExtentStart, ulExtentLen, pbBuffer);
+    }
+
+    return ret;
+}
 #endif /* REDCONF_READ_ONLY == 0 */
 
 
@@ -1493,6 +1903,74 @@ static REDSTATUS GetExtent(
 }
 
 
+#if REDCONF_CONCURRENT_IO == 1
+/** @brief Put a cached inode and release the file system mutex, so that file
+           data can be transferred while other tasks use the file system.
+
+    Since no buffers are held while the mutex is released, the transfer does
+    not take any buffers away from the other tasks.  Meanwhile, no other task
+    can write the file (see RedVolIoEnter()), so the blocks being transferred
+    stay part of it; and when the data is being written, transaction points
+    wait until it has been (see RedVolIoUnlock()).
+
+    @param pInode   A pointer to the cached inode structure, which is put.
+    @param fWrite   Whether data is being written, rather than read.
+
+    @return Whether the inode must be branched when it is mounted again.
+*/
+static bool IoUnlock(
+    CINODE *pInode,
+    bool    fWrite)
+{
+  #if REDCONF_READ_ONLY == 0
+    bool    fBranch = pInode->fDirty;
+  #else
+    bool    fBranch = false;
+  #endif
+
+    RedInodePut(pInode, 0U);
+
+    RedVolIoUnlock(fWrite);
+
+    return fBranch;
+}
+
+
+/** @brief Acquire the file system mutex after IoUnlock() and mount the cached
+           inode again.
+
+    The seek coordinates are not preserved, so the next seek starts over.
+
+    @param pInode   A pointer to the cached inode structure given to
+                    IoUnlock().
+    @param bVolNum  The volume on which the inode resides.
+    @param fWrite   The @p fWrite value given to IoUnlock().
+    @param fBranch  The value returned by IoUnlock().
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS IoRelock(
+    CINODE     *pInode,
+    uint8_t     bVolNum,
+    bool        fWrite,
+    bool        fBranch)
+{
+    REDSTATUS   ret;
+
+    RedVolIoRelock(bVolNum, fWrite);
+
+    ret = RedInodeMount(pInode, FTYPE_FILE, fBranch);
+
+    pInode->fIoUnlock = true;
+
+    return ret;
+}
+#endif /* REDCONF_CONCURRENT_IO == 1 */
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Allocate or branch the file metadata path and data block if necessary.
 
@@ -29,10 +29,44 @@
 #include <redcore.h>
 
 
+#if REDCONF_TRANSACT_GROUP_MS > 0U
+/*  After a group of transaction points which no other task joined, this many
+    groups are committed without waiting for other tasks, before trying again.
+*/
+#define GROUP_SKIPS_MAX 8U
+#endif
+
+
+#if REDCONF_CONCURRENT_IO == 1
+/*  A file read or write which has been started with RedVolIoEnter().
+*/
+typedef struct
+{
+    uint32_t    ulInode;    /* The file being read or written; INODE_INVALID if the slot is free. */
+    uint8_t     bVolNum;    /* The volume on which the file resides. */
+    bool        fWrite;     /* Whether the file is being written. */
+} VOLIO;
+#endif
+
+
 static bool MetarootIsValid(METAROOT *pMR, bool *pfSectorCRCIsValid);
 #ifdef REDCONF_ENDIAN_SWAP
 static void MetaRootEndianSwap(METAROOT *pMetaRoot);
 #endif
+#if REDCONF_CONCURRENT_IO == 1
+static uint32_t VolIoSlot(uint32_t ulInode, bool fWrite);
+static void VolIoWait(uint8_t bVolNum);
+#if REDCONF_READ_ONLY == 0
+static void VolIoTransactWait(void);
+#endif
+#endif
+
+
+#if REDCONF_CONCURRENT_IO == 1
+/*  The file reads and writes in progress, at most one per task.
+*/
+static VOLIO gaVolIo[REDCONF_TASK_COUNT];
+#endif
 
 
 /** @brief Mount a file system volume.
@@ -261,6 +295,18 @@ REDSTATUS RedVolMountMetaroot(void)
       #endif
         gpRedCoreVol->ulAlmostFreeBlocks = 0U;
 
+      #if REDCONF_TRANSACT_BG_BLOCKS > 0U
+        gpRedCoreVol->ulDirtyBlocks = 0U;
+      #endif
+
+      #if (REDCONF_IMAP_EXTERNAL == 1) && (REDCONF_READ_ONLY == 0)
+        RedImapESummaryReset();
+      #endif
+
+      #if (REDCONF_READ_ONLY == 0) && (REDCONF_API_POSIX == 1)
+        gpRedCoreVol->ulInodeFreeHint = INODE_FIRST_FREE;
+      #endif
+
         gpRedCoreVol->aMR[1U - gpRedCoreVol->bCurMR] = *gpRedMR;
         gpRedCoreVol->bCurMR = 1U - gpRedCoreVol->bCurMR;
         gpRedMR = &gpRedCoreVol->aMR[gpRedCoreVol->bCurMR];
@@ -355,6 +401,10 @@ REDSTATUS RedVolTransact(void)
 {
     REDSTATUS ret = 0;
 
+  #if REDCONF_CONCURRENT_IO == 1
+    VolIoTransactWait();
+  #endif
+
     REDASSERT(!gpRedVolume->fReadOnly); /* Should be checked by caller. */
 
     if(gpRedCoreVol->fBranched)
@@ -440,6 +490,17 @@ REDSTATUS RedVolTransact(void)
             gpRedMR = &gpRedCoreVol->aMR[gpRedCoreVol->bCurMR];
 
             gpRedCoreVol->fBranched = false;
+
+          #if REDCONF_TRANSACT_BG_BLOCKS > 0U
+            gpRedCoreVol->ulDirtyBlocks = 0U;
+          #endif
+
+          #if REDCONF_IMAP_EXTERNAL == 1
+            if(!gpRedCoreVol->fImapInline)
+            {
+                RedImapESummaryTransact();
+            }
+          #endif
         }
 
         CRITICAL_ASSERT(ret == 0);
@@ -450,6 +511,126 @@ REDSTATUS RedVolTransact(void)
 #endif
 
 
+#if REDCONF_TRANSACT_GROUP_MS > 0U
+/** @brief Commit a transaction point which may be shared with other tasks.
+
+    Rather than each task making a transaction point of its own, the first task
+    to get here while the volume has changes waits for up to
+    REDCONF_TRANSACT_GROUP_MS, with the file system mutex released, then makes
+    one transaction point for every task which got here in the meantime.  Those
+    tasks wait for it and return its result, so that many small changes cost
+    one metaroot write and two flushes, rather than one of each per task.
+
+    A group stops waiting early once it has as many tasks as the last group
+    which waited.  When no other task joined that group, the next few groups
+    are committed without waiting, so that a task making transaction points on
+    its own is not slowed down for nothing.
+
+    Durability is the same as with RedVolTransact(): when this function returns
+    success, every change made before it was called has been committed.  Only
+    the latency increases, by up to REDCONF_TRANSACT_GROUP_MS.
+
+    The file system mutex is released while waiting, so the caller must not
+    depend on state which the mutex protects from before until after this call.
+    The current volume is left unchanged; a volume with tasks waiting here is
+    not unmounted until they are done, see RedVolIoDrain().
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+REDSTATUS RedVolTransactGroup(void)
+{
+    REDSTATUS   ret = 0;
+    uint8_t     bVolNum = gbRedVolNum;
+
+    REDASSERT(!gpRedVolume->fReadOnly); /* Should be checked by caller. */
+
+    gpRedCoreVol->uGroupTasks++;
+
+    if(gpRedCoreVol->fGroupOpen)
+    {
+        uint32_t ulGroupSeq = gpRedCoreVol->ulGroupSeq;
+
+        gpRedCoreVol->uGroupJoined++;
+
+        if((gpRedCoreVol->uGroupJoined + 1U) >= gpRedCoreVol->uGroupSize)
+        {
+            RedOsMutexWakeAll();
+        }
+
+        /*  The group's transaction point has not been started, so it will
+            include the changes made by this task.
+        */
+        while(gpRedCoreVol->ulGroupSeq == ulGroupSeq)
+        {
+            VolIoWait(bVolNum);
+        }
+
+        ret = gpRedCoreVol->groupRet;
+    }
+    else if(gpRedCoreVol->fBranched)
+    {
+        gpRedCoreVol->fGroupOpen = true;
+        gpRedCoreVol->uGroupJoined = 0U;
+
+        if((gpRedCoreVol->uGroupSize > 1U) || (gpRedCoreVol->bGroupSkips >= GROUP_SKIPS_MAX))
+        {
+            REDTIMESTAMP    tsOpen = RedOsTimestamp();
+            uint64_t        ullWaitedMs = 0U;
+
+            while(    (ullWaitedMs < REDCONF_TRANSACT_GROUP_MS)
+                   && (    (gpRedCoreVol->uGroupSize < 2U)
+                        || ((gpRedCoreVol->uGroupJoined + 1U) < gpRedCoreVol->uGroupSize)))
+            {
+                RedOsMutexWaitTimeout((uint32_t)(REDCONF_TRANSACT_GROUP_MS - ullWaitedMs));
+
+                (void)RedCoreVolSetCurrent(bVolNum);
+
+                ullWaitedMs = RedOsTimePassed(tsOpen) / 1000U;
+            }
+
+            gpRedCoreVol->uGroupSize = gpRedCoreVol->uGroupJoined + 1U;
+            gpRedCoreVol->bGroupSkips = 0U;
+        }
+        else
+        {
+            gpRedCoreVol->bGroupSkips++;
+        }
+
+        /*  The group stays open until the transaction point is finished, since
+            the changes of a task joining while RedVolTransact() waits for file
+            writes are still included.
+        */
+        ret = RedVolTransact();
+
+        gpRedCoreVol->groupRet = ret;
+        gpRedCoreVol->ulGroupSeq++;
+        gpRedCoreVol->fGroupOpen = false;
+
+        RedOsMutexWakeAll();
+    }
+    else
+    {
+        /*  Nothing has changed since the last transaction point.
+        */
+    }
+
+    gpRedCoreVol->uGroupTasks--;
+
+    /*  A volume being unmounted waits for the groups.
+    */
+    if(gpRedCoreVol->uGroupTasks == 0U)
+    {
+        RedOsMutexWakeAll();
+    }
+
+    return ret;
+}
+#endif
+
+
 #ifdef REDCONF_ENDIAN_SWAP
 static void MetaRootEndianSwap(
     METAROOT *pMetaRoot)
@@ -538,3 +719,336 @@ REDSTATUS RedVolSeqNumIncrement(void)
     return ret;
 }
 
+
+#if REDCONF_CONCURRENT_IO == 1
+/** @brief Start reading or writing a file on the current volume.
+
+    Waits until the file is not being written by another task, and, if the
+    file is to be written, until it is not being read either.  Until the
+    matching RedVolIoLeave(), RedVolIoUnlock() may then be used to transfer
+    the file's data with the file system mutex released.  A task must not
+    start more than one read or write at a time.
+
+    The file system mutex must be held; it is released while waiting, so the
+    current volume is set again before returning.
+
+    @param ulInode  The inode number of the file.  If it is not a valid inode
+                    number, nothing is done, and the read or write itself is
+                    left to reject it.
+    @param fWrite   Whether the file is to be written (or truncated), rather
+                    than read.
+*/
+void RedVolIoEnter(
+    uint32_t    ulInode,
+    bool        fWrite)
+{
+    if(INODE_IS_VALID(ulInode))
+    {
+        uint8_t     bVolNum = gbRedVolNum;
+        uint32_t    ulIdx = VolIoSlot(ulInode, fWrite);
+
+        while(ulIdx == REDCONF_TASK_COUNT)
+        {
+            VolIoWait(bVolNum);
+
+            ulIdx = VolIoSlot(ulInode, fWrite);
+        }
+
+        gaVolIo[ulIdx].ulInode = ulInode;
+        gaVolIo[ulIdx].bVolNum = bVolNum;
+        gaVolIo[ulIdx].fWrite = fWrite;
+    }
+}
+
+
+/** @brief Finish reading or writing a file on the current volume.
+
+    Wakes the tasks waiting for the file.
+
+    @param ulInode  The inode number given to RedVolIoEnter().
+    @param fWrite   The @p fWrite value given to RedVolIoEnter().
+*/
+void RedVolIoLeave(
+    uint32_t    ulInode,
+    bool        fWrite)
+{
+    uint32_t    ulIdx;
+
+    for(ulIdx = 0U; ulIdx < REDCONF_TASK_COUNT; ulIdx++)
+    {
+        VOLIO *pIo = &gaVolIo[ulIdx];
+
+        if((pIo->ulInode == ulInode) && (pIo->bVolNum == gbRedVolNum) && (pIo->fWrite == fWrite))
+        {
+            pIo->ulInode = INODE_INVALID;
+            break;
+        }
+    }
+
+    REDASSERT((ulIdx < REDCONF_TASK_COUNT) || !INODE_IS_VALID(ulInode));
+
+    RedOsMutexWakeAll();
+}
+
+
+/** @brief Determine whether a file has been entered with RedVolIoEnter().
+
+    @param ulInode  The inode number of the file.
+    @param fWrite   Whether the file must have been entered for writing.
+
+    @return Whether the file's data may be transferred with RedVolIoUnlock().
+*/
+bool RedVolIoEntered(
+    uint32_t    ulInode,
+    bool        fWrite)
+{
+    bool        fEntered = false;
+    uint32_t    ulIdx;
+
+    for(ulIdx = 0U; ulIdx < REDCONF_TASK_COUNT; ulIdx++)
+    {
+        const VOLIO *pIo = &gaVolIo[ulIdx];
+
+        if((pIo->ulInode == ulInode) && (pIo->bVolNum == gbRedVolNum) && (pIo->fWrite || !fWrite))
+        {
+            fEntered = true;
+            break;
+        }
+    }
+
+    return fEntered;
+}
+
+
+/** @brief Release the file system mutex while file data is transferred.
+
+    The caller must not hold any buffers, and must call RedVolIoRelock() once
+    the transfer is complete.  While a write is in progress, transaction points
+    on the volume wait for it, so that a transaction point never commits
+    blocks which do not yet contain their data.
+
+    @param fWrite   Whether data is being written, rather than read.
+*/
+void RedVolIoUnlock(
+    bool    fWrite)
+{
+  #if REDCONF_READ_ONLY == 0
+    if(fWrite)
+    {
+        REDASSERT(gpRedCoreVol->uIoWriters < UINT16_MAX);
+        gpRedCoreVol->uIoWriters++;
+    }
+  #else
+    REDASSERT(!fWrite);
+  #endif
+
+    RedOsMutexRelease();
+}
+
+
+/** @brief Acquire the file system mutex after a transfer started with
+           RedVolIoUnlock().
+
+    @param bVolNum  The volume on which the data was transferred, which is made
+                    the current volume.
+    @param fWrite   The @p fWrite value given to RedVolIoUnlock().
+*/
+void RedVolIoRelock(
+    uint8_t     bVolNum,
+    bool        fWrite)
+{
+    RedOsMutexAcquire();
+
+    (void)RedCoreVolSetCurrent(bVolNum);
+
+  #if REDCONF_READ_ONLY == 0
+    if(fWrite)
+    {
+        REDASSERT(gpRedCoreVol->uIoWriters > 0U);
+        gpRedCoreVol->uIoWriters--;
+
+        if((gpRedCoreVol->uIoWriters == 0U) && (gpRedCoreVol->uIoTransactWaiters > 0U))
+        {
+            RedOsMutexWakeAll();
+        }
+    }
+  #else
+    (void)fWrite;
+  #endif
+}
+
+
+/** @brief Wait until no file on the current volume is being read or written,
+           and no transaction point on it is waiting.
+
+    Used before unmounting the volume.  The file system mutex must be held; it
+    is released while waiting, so the current volume is set again before
+    returning.
+*/
+void RedVolIoDrain(void)
+{
+    uint8_t bVolNum = gbRedVolNum;
+    bool    fBusy;
+
+    do
+    {
+        uint32_t ulIdx;
+
+      #if REDCONF_READ_ONLY == 0
+        fBusy = gpRedCoreVol->uIoTransactWaiters > 0U;
+      #else
+        fBusy = false;
+      #endif
+
+      #if REDCONF_TRANSACT_GROUP_MS > 0U
+        if(gpRedCoreVol->uGroupTasks > 0U)
+        {
+            fBusy = true;
+        }
+      #endif
+
+        for(ulIdx = 0U; !fBusy && (ulIdx < REDCONF_TASK_COUNT); ulIdx++)
+        {
+            fBusy = (gaVolIo[ulIdx].ulInode != INODE_INVALID) && (gaVolIo[ulIdx].bVolNum == bVolNum);
+        }
+
+        if(fBusy)
+        {
+            VolIoWait(bVolNum);
+        }
+    } while(fBusy);
+}
+
+
+#if REDCONF_READ_ONLY == 0
+/** @brief Wait until no file data is being written with the file system mutex
+           released, on any volume.
+
+    Transaction points wait for such writes, which releases the mutex in the
+    middle of the operation that makes the transaction point.  Operations which
+    depend on state that the mutex protects, from before until after a
+    transaction point, use this first: once it returns, and until the mutex is
+    released, no transaction point waits.
+
+    The file system mutex must be held; it is released while waiting.  The
+    current volume is left unchanged.
+*/
+void RedVolIoQuiesce(void)
+{
+    uint8_t bVolNum = gbRedVolNum;
+    bool    fWaited;
+
+    do
+    {
+        uint8_t bQuiesceVolNum;
+
+        fWaited = false;
+
+        for(bQuiesceVolNum = 0U; bQuiesceVolNum < REDCONF_VOLUME_COUNT; bQuiesceVolNum++)
+        {
+            (void)RedCoreVolSetCurrent(bQuiesceVolNum);
+
+            if(gpRedCoreVol->uIoWriters > 0U)
+            {
+                /*  Other volumes might gain writers while the mutex is
+                    released, so check them all again afterward.
+                */
+                VolIoTransactWait();
+                fWaited = true;
+            }
+        }
+    } while(fWaited);
+
+    (void)RedCoreVolSetCurrent(bVolNum);
+}
+#endif
+
+
+/** @brief Find a slot for a file read or write on the current volume.
+
+    @param ulInode  The inode number of the file.
+    @param fWrite   Whether the file is to be written.
+
+    @return The index of a free slot in gaVolIo, or REDCONF_TASK_COUNT if the
+            read or write must wait, either because it conflicts with one in
+            progress or because no slot is free.
+*/
+static uint32_t VolIoSlot(
+    uint32_t    ulInode,
+    bool        fWrite)
+{
+    uint32_t    ulFree = REDCONF_TASK_COUNT;
+    uint32_t    ulIdx;
+
+    for(ulIdx = 0U; ulIdx < REDCONF_TASK_COUNT; ulIdx++)
+    {
+        const VOLIO *pIo = &gaVolIo[ulIdx];
+
+        if(pIo->ulInode == INODE_INVALID)
+        {
+            if(ulFree == REDCONF_TASK_COUNT)
+            {
+                ulFree = ulIdx;
+            }
+        }
+        else if((pIo->ulInode == ulInode) && (pIo->bVolNum == gbRedVolNum) && (fWrite || pIo->fWrite))
+        {
+            ulFree = REDCONF_TASK_COUNT;
+            break;
+        }
+        else
+        {
+            /*  A read or write of another file, which does not conflict.
+            */
+        }
+    }
+
+    return ulFree;
+}
+
+
+/** @brief Wait for another task to change the state of the file reads and
+           writes, then make a volume current again.
+
+    @param bVolNum  The volume to make current after waiting.
+*/
+static void VolIoWait(
+    uint8_t bVolNum)
+{
+    RedOsMutexWait();
+
+    (void)RedCoreVolSetCurrent(bVolNum);
+}
+
+
+#if REDCONF_READ_ONLY == 0
+/** @brief Wait for the file writes which are transferring data on the current
+           volume with the file system mutex released.
+
+    While any task is waiting here, writes transfer their data without
+    releasing the mutex, so that the transaction point is not held off
+    indefinitely.
+*/
+static void VolIoTransactWait(void)
+{
+    if(gpRedCoreVol->uIoWriters > 0U)
+    {
+        uint8_t bVolNum = gbRedVolNum;
+
+        gpRedCoreVol->uIoTransactWaiters++;
+
+        while(gpRedCoreVol->uIoWriters > 0U)
+        {
+            VolIoWait(bVolNum);
+        }
+
+        gpRedCoreVol->uIoTransactWaiters--;
+
+        /*  A volume being unmounted waits for the transaction points.
+        */
+        RedOsMutexWakeAll();
+    }
+}
+#endif
+#endif /* REDCONF_CONCURRENT_IO == 1 */
+
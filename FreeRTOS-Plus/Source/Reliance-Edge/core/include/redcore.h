@@ -29,6 +29,7 @@
 
 
 #include <redstat.h>
+#include <redcoreapi.h>
 #include <redvolume.h>
 #include "rednodes.h"
 #include "redcoremacs.h"
@@ -91,6 +92,9 @@ REDSTATUS RedIoFlush(uint8_t bVolNum);
 void RedBufferInit(void);
 REDSTATUS RedBufferGet(uint32_t ulBlock, uint16_t uFlags, void **ppBuffer);
 void RedBufferPut(const void *pBuffer);
+#if REDCONF_READ_AHEAD > 0U
+REDSTATUS RedBufferReadAhead(uint32_t ulBlockStart, uint32_t ulBlockCount);
+#endif
 #if REDCONF_READ_ONLY == 0
 REDSTATUS RedBufferFlush(uint32_t ulBlockStart, uint32_t ulBlockCount);
 void RedBufferDirty(const void *pBuffer);
@@ -100,6 +104,9 @@ void RedBufferDiscard(const void *pBuffer);
 #endif
 #endif
 REDSTATUS RedBufferDiscardRange(uint32_t ulBlockStart, uint32_t ulBlockCount);
+#if REDCONF_BUFFER_STATS == 1
+void RedBufferStats(uint32_t *pulHits, uint32_t *pulMisses);
+#endif
 
 
 /** @brief Allocation state of a block.
@@ -116,17 +123,23 @@ REDSTATUS RedImapBlockGet(uint8_t bMR, uint32_t ulBlock, bool *pfAllocated);
 #if REDCONF_READ_ONLY == 0
 REDSTATUS RedImapBlockSet(uint32_t ulBlock, bool fAllocated);
 REDSTATUS RedImapAllocBlock(uint32_t *pulBlock);
+REDSTATUS RedImapAllocSeek(uint32_t ulBlockCount);
 #endif
 REDSTATUS RedImapBlockState(uint32_t ulBlock, ALLOCSTATE *pState);
 
 #if REDCONF_IMAP_INLINE == 1
 REDSTATUS RedImapIBlockGet(uint8_t bMR, uint32_t ulBlock, bool *pfAllocated);
 REDSTATUS RedImapIBlockSet(uint32_t ulBlock, bool fAllocated);
+REDSTATUS RedImapIBlockFind(uint32_t ulBlockStart, uint32_t ulBlockEnd, bool fFree, uint32_t *pulBlock);
 #endif
 
 #if REDCONF_IMAP_EXTERNAL == 1
 REDSTATUS RedImapEBlockGet(uint8_t bMR, uint32_t ulBlock, bool *pfAllocated);
 REDSTATUS RedImapEBlockSet(uint32_t ulBlock, bool fAllocated);
+REDSTATUS RedImapEBlockFind(uint32_t ulBlockStart, uint32_t ulBlockEnd, bool fFree, uint32_t *pulBlock);
+void RedImapESummaryFree(uint32_t ulBlock, bool fAlmostFree);
+void RedImapESummaryTransact(void);
+void RedImapESummaryReset(void);
 uint32_t RedImapNodeBlock(uint8_t bMR, uint32_t ulImapNode);
 #endif
 
@@ -144,6 +157,9 @@ typedef struct
     bool        fDirty;         /**< True if the inode buffer is dirty. */
   #endif
     bool        fCoordInited;   /**< True after the first seek. */
+  #if REDCONF_CONCURRENT_IO == 1
+    bool        fIoUnlock;      /**< True if data may be transferred with the mutex released; see RedVolIoUnlock(). */
+  #endif
 
     INODE      *pInodeBuf;      /**< Pointer to the inode buffer. */
   #if DINDIR_POINTERS > 0U
@@ -214,6 +230,9 @@ REDSTATUS RedInodeIsFree(uint32_t ulInode, bool *pfFree);
 REDSTATUS RedInodeBitGet(uint8_t bMR, uint32_t ulInode, uint8_t bWhich, bool *pfAllocated);
 
 REDSTATUS RedInodeDataRead(CINODE *pInode, uint64_t ullStart, uint32_t *pulLen, void *pBuffer);
+#if REDCONF_READ_AHEAD > 0U
+REDSTATUS RedInodeDataReadSeq(CINODE *pInode, uint64_t ullStart, uint32_t *pulLen, void *pBuffer, REDREADAHEAD *pReadAhead);
+#endif
 #if REDCONF_READ_ONLY == 0
 REDSTATUS RedInodeDataWrite(CINODE *pInode, uint64_t ullStart, uint32_t *pulLen, const void *pBuffer);
 #if DELETE_SUPPORTED || TRUNCATE_SUPPORTED
@@ -234,6 +253,9 @@ REDSTATUS RedDirEntryLookup(CINODE *pPInode, const char *pszName, uint32_t *pulE
 #if (REDCONF_API_POSIX_READDIR == 1) || (REDCONF_CHECKER == 1)
 REDSTATUS RedDirEntryRead(CINODE *pPInode, uint32_t *pulIdx, char *pszName, uint32_t *pulInode);
 #endif
+#if (REDCONF_DIRENT_CACHE_COUNT > 0U) || (REDCONF_DIR_FILTER_COUNT > 0U)
+void RedDirCacheReset(void);
+#endif
 #if (REDCONF_READ_ONLY == 0) && (REDCONF_API_POSIX_RENAME == 1)
 REDSTATUS RedDirEntryRename(CINODE *pSrcPInode, const char *pszSrcName, CINODE *pSrcInode, CINODE *pDstPInode, const char *pszDstName, CINODE *pDstInode);
 #endif
@@ -245,8 +267,22 @@ REDSTATUS RedVolMountMetaroot(void);
 #if REDCONF_READ_ONLY == 0
 REDSTATUS RedVolTransact(void);
 #endif
+#if REDCONF_TRANSACT_GROUP_MS > 0U
+REDSTATUS RedVolTransactGroup(void);
+#endif
 void RedVolCriticalError(const char *pszFileName, uint32_t ulLineNum);
 REDSTATUS RedVolSeqNumIncrement(void);
+#if REDCONF_CONCURRENT_IO == 1
+void RedVolIoEnter(uint32_t ulInode, bool fWrite);
+void RedVolIoLeave(uint32_t ulInode, bool fWrite);
+bool RedVolIoEntered(uint32_t ulInode, bool fWrite);
+void RedVolIoUnlock(bool fWrite);
+void RedVolIoRelock(uint8_t bVolNum, bool fWrite);
+void RedVolIoDrain(void);
+#if REDCONF_READ_ONLY == 0
+void RedVolIoQuiesce(void);
+#endif
+#endif
 
 #if FORMAT_SUPPORTED
 REDSTATUS RedVolFormat(void);
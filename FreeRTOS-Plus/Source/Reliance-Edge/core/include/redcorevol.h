@@ -72,12 +72,90 @@ typedef struct
     */
     uint32_t    ulAlmostFreeBlocks;
 
+  #if (REDCONF_IMAP_EXTERNAL == 1) && (REDCONF_READ_ONLY == 0)
+    /** One bit per imap node, set when the node is known to contain no free
+        blocks, so that the allocator can skip it without reading it.  Valid
+        only when fImapInline is false.
+    */
+    uint8_t     abImapFull[METAROOT_ENTRY_BYTES];
+
+    /** One bit per imap node, set when the node contains blocks which will
+        become free after the next transaction.
+    */
+    uint8_t     abImapAFree[METAROOT_ENTRY_BYTES];
+  #endif
+
+  #if (REDCONF_READ_ONLY == 0) && (REDCONF_API_POSIX == 1)
+    /** The lowest inode number which might be free; every inode number below
+        it is allocated.
+    */
+    uint32_t    ulInodeFreeHint;
+  #endif
+
+  #if REDCONF_READ_AHEAD > 0U
+    /** Incremented whenever a file's data might be moved to different blocks,
+        which makes the block numbers saved in each ::REDREADAHEAD stale.
+    */
+    uint32_t    ulMapSeq;
+  #endif
+
   #if RESERVED_BLOCKS > 0U
     /** Whether to use the blocks reserved for operations that create free
         space.
     */
     bool        fUseReservedBlocks;
   #endif
+
+  #if (REDCONF_CONCURRENT_IO == 1) && (REDCONF_READ_ONLY == 0)
+    /** The number of file writes transferring data with the file system mutex
+        released.  Transaction points wait for these to finish.
+    */
+    uint16_t    uIoWriters;
+
+    /** The number of tasks waiting in RedVolTransact() for uIoWriters to reach
+        zero.  While it is nonzero, file writes hold the mutex throughout.
+    */
+    uint16_t    uIoTransactWaiters;
+  #endif
+
+  #if REDCONF_TRANSACT_GROUP_MS > 0U
+    /** The number of tasks in RedVolTransactGroup(), including the one which
+        makes the transaction point for the group.
+    */
+    uint16_t    uGroupTasks;
+
+    /** Whether a task is waiting to make the transaction point for a group,
+        which other tasks may join.
+    */
+    bool        fGroupOpen;
+
+    /** The number of tasks which joined the open group.
+    */
+    uint16_t    uGroupJoined;
+
+    /** The number of tasks in the last group which waited for other tasks.
+        A group stops waiting once it is as large.
+    */
+    uint16_t    uGroupSize;
+
+    /** The number of groups since the last one which waited for other tasks.
+    */
+    uint8_t     bGroupSkips;
+
+    /** Incremented whenever a group's transaction point is finished.
+    */
+    uint32_t    ulGroupSeq;
+
+    /** The result of the last group's transaction point.
+    */
+    REDSTATUS   groupRet;
+  #endif
+
+  #if REDCONF_TRANSACT_BG_BLOCKS > 0U
+    /** The number of blocks allocated since the last transaction point.
+    */
+    uint32_t    ulDirtyBlocks;
+  #endif
 } COREVOLUME;
 
 /*  Pointer to the core volume currently being accessed; populated during
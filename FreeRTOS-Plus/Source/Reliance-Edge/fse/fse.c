@@ -320,8 +320,16 @@ int32_t RedFseRead(
     {
         uint32_t ulReadLen = ulLength;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        RedCoreFileIoEnter(ulFileNum, false);
+      #endif
+
         ret = RedCoreFileRead(ulFileNum, ullFileOffset, &ulReadLen, pBuffer);
 
+      #if REDCONF_CONCURRENT_IO == 1
+        RedCoreFileIoLeave(ulFileNum, false);
+      #endif
+
         FseLeave();
 
         if(ret == 0)
@@ -395,8 +403,16 @@ int32_t RedFseWrite(
     {
         uint32_t ulWriteLen = ulLength;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        RedCoreFileIoEnter(ulFileNum, true);
+      #endif
+
         ret = RedCoreFileWrite(ulFileNum, ullFileOffset, &ulWriteLen, pBuffer);
 
+      #if REDCONF_CONCURRENT_IO == 1
+        RedCoreFileIoLeave(ulFileNum, true);
+      #endif
+
         FseLeave();
 
         if(ret == 0)
@@ -451,8 +467,16 @@ REDSTATUS RedFseTruncate(
 
     if(ret == 0)
     {
+      #if REDCONF_CONCURRENT_IO == 1
+        RedCoreFileIoEnter(ulFileNum, true);
+      #endif
+
         ret = RedCoreFileTruncate(ulFileNum, ullNewFileSize);
 
+      #if REDCONF_CONCURRENT_IO == 1
+        RedCoreFileIoLeave(ulFileNum, true);
+      #endif
+
         FseLeave();
     }
 
@@ -171,6 +171,71 @@
 #ifndef REDCONF_CHECKER
   #error "Configuration error: REDCONF_CHECKER must be defined."
 #endif
+#ifndef REDCONF_BUFFER_WRITE_GATHER
+    /*  REDCONF_BUFFER_WRITE_GATHER is optional, since it is newer than the
+        Configuration Utility; when it is not defined, each dirty buffer is
+        written with a separate request.
+    */
+  #define REDCONF_BUFFER_WRITE_GATHER 0U
+#endif
+#ifndef REDCONF_READ_AHEAD
+    /*  REDCONF_READ_AHEAD is optional, since it is newer than the Configuration
+        Utility; when it is not defined, file data is never read ahead.
+    */
+  #define REDCONF_READ_AHEAD 0U
+#endif
+#ifndef REDCONF_DIRENT_CACHE_COUNT
+    /*  REDCONF_DIRENT_CACHE_COUNT is optional, since it is newer than the
+        Configuration Utility; when it is not defined, names are always looked
+        up by reading the directory.
+    */
+  #define REDCONF_DIRENT_CACHE_COUNT 0U
+#endif
+#ifndef REDCONF_DIR_FILTER_COUNT
+    /*  REDCONF_DIR_FILTER_COUNT and REDCONF_DIR_FILTER_BYTES are optional,
+        since they are newer than the Configuration Utility; when they are not
+        defined, creating a name reads the whole directory to make sure that the
+        name does not already exist.
+    */
+  #define REDCONF_DIR_FILTER_COUNT 0U
+#endif
+#ifndef REDCONF_DIR_FILTER_BYTES
+  #define REDCONF_DIR_FILTER_BYTES 0U
+#endif
+#ifndef REDCONF_CONCURRENT_IO
+    /*  REDCONF_CONCURRENT_IO is optional, since it is newer than the
+        Configuration Utility; when it is not defined, the file system mutex is
+        held while file data is transferred to or from the block device.
+    */
+  #define REDCONF_CONCURRENT_IO 0
+#endif
+#ifndef REDCONF_TRANSACT_GROUP_MS
+    /*  REDCONF_TRANSACT_GROUP_MS is optional, since it is newer than the
+        Configuration Utility; when it is not defined, each transaction point
+        requested with red_transact(), red_fsync(), or red_close() is made
+        right away, rather than shared with the requests of other tasks.
+    */
+  #define REDCONF_TRANSACT_GROUP_MS 0U
+#endif
+#ifndef REDCONF_TRANSACT_BG_MS
+    /*  REDCONF_TRANSACT_BG_MS and REDCONF_TRANSACT_BG_BLOCKS are optional,
+        since they are newer than the Configuration Utility; when they are not
+        defined, there is no background transaction task, and transaction
+        points are made only as the transaction mask and red_transact()
+        direct.
+    */
+  #define REDCONF_TRANSACT_BG_MS 0U
+#endif
+#ifndef REDCONF_TRANSACT_BG_BLOCKS
+  #define REDCONF_TRANSACT_BG_BLOCKS 0U
+#endif
+#ifndef REDCONF_BUFFER_STATS
+    /*  REDCONF_BUFFER_STATS is optional, since it is newer than the
+        Configuration Utility; when it is not defined, the block buffers do not
+        count how often a block is found among them.
+    */
+  #define REDCONF_BUFFER_STATS 0
+#endif
 
 
 #if (REDCONF_READ_ONLY != 0) && (REDCONF_READ_ONLY != 1)
@@ -326,8 +391,44 @@
 
 /*  REDCONF_BUFFER_COUNT lower limit checked in buffer.c
 */
-#if REDCONF_BUFFER_COUNT > 255U
-  #error "REDCONF_BUFFER_COUNT cannot be greater than 255"
+#if REDCONF_BUFFER_COUNT > 65535U
+  #error "REDCONF_BUFFER_COUNT cannot be greater than 65535"
+#endif
+
+#if REDCONF_BUFFER_WRITE_GATHER > REDCONF_BUFFER_COUNT
+  #error "Configuration error: REDCONF_BUFFER_WRITE_GATHER cannot be greater than REDCONF_BUFFER_COUNT."
+#endif
+
+#if REDCONF_READ_AHEAD > (REDCONF_BUFFER_COUNT / 2U)
+  #error "Configuration error: REDCONF_READ_AHEAD cannot be greater than half of REDCONF_BUFFER_COUNT."
+#endif
+
+#if (REDCONF_DIR_FILTER_COUNT > 0U) && ((REDCONF_DIR_FILTER_BYTES == 0U) || (REDCONF_DIR_FILTER_BYTES > 16777216U) || ((REDCONF_DIR_FILTER_BYTES & (REDCONF_DIR_FILTER_BYTES - 1U)) != 0U))
+  #error "Configuration error: REDCONF_DIR_FILTER_BYTES must be a power of two between 1 and 16777216 when REDCONF_DIR_FILTER_COUNT is nonzero."
+#endif
+
+#if (REDCONF_CONCURRENT_IO != 0) && (REDCONF_CONCURRENT_IO != 1)
+  #error "Configuration error: REDCONF_CONCURRENT_IO must be either 0 or 1."
+#endif
+
+#if (REDCONF_CONCURRENT_IO == 1) && (REDCONF_TASK_COUNT == 1U)
+  #error "Configuration error: REDCONF_CONCURRENT_IO must be 0 when REDCONF_TASK_COUNT is 1."
+#endif
+
+#if (REDCONF_TRANSACT_GROUP_MS > 0U) && ((REDCONF_CONCURRENT_IO == 0) || (REDCONF_READ_ONLY == 1))
+  #error "Configuration error: REDCONF_TRANSACT_GROUP_MS must be 0 unless REDCONF_CONCURRENT_IO is 1 and REDCONF_READ_ONLY is 0."
+#endif
+
+#if (REDCONF_TRANSACT_BG_MS > 0U) && ((REDCONF_CONCURRENT_IO == 0) || (REDCONF_READ_ONLY == 1) || (REDCONF_API_POSIX == 0))
+  #error "Configuration error: REDCONF_TRANSACT_BG_MS must be 0 unless REDCONF_CONCURRENT_IO and REDCONF_API_POSIX are 1 and REDCONF_READ_ONLY is 0."
+#endif
+
+#if (REDCONF_TRANSACT_BG_BLOCKS > 0U) && (REDCONF_TRANSACT_BG_MS == 0U)
+  #error "Configuration error: REDCONF_TRANSACT_BG_BLOCKS must be 0 when REDCONF_TRANSACT_BG_MS is 0."
+#endif
+
+#if (REDCONF_BUFFER_STATS != 0) && (REDCONF_BUFFER_STATS != 1)
+  #error "Configuration error: REDCONF_BUFFER_STATS must be either 0 or 1."
 #endif
 
 #if (REDCONF_IMAGE_BUILDER != 0) && (REDCONF_IMAGE_BUILDER != 1)
@@ -31,6 +31,25 @@
 #include <redstat.h>
 
 
+#if REDCONF_READ_AHEAD > 0U
+/** @brief Per-handle state for reading files sequentially.
+
+    Used to recognize reads which continue where the previous read on the same
+    handle ended, and to remember where the blocks which were read ahead are
+    located, so that reading them does not involve seeking through the inode.
+    Must be zeroed before the first read.
+*/
+typedef struct
+{
+    uint64_t    ullNextOffset;                  /**< Offset at which a sequential read would start. */
+    uint32_t    ulMapSeq;                       /**< Volume map sequence number when aulMap was populated. */
+    uint32_t    ulMapStart;                     /**< File block offset of the first entry in aulMap. */
+    uint32_t    ulMapCount;                     /**< Number of valid entries in aulMap. */
+    uint32_t    aulMap[REDCONF_READ_AHEAD];     /**< Physical block numbers for the blocks read ahead. */
+} REDREADAHEAD;
+#endif
+
+
 REDSTATUS RedCoreInit(void);
 REDSTATUS RedCoreUninit(void);
 
@@ -47,9 +66,15 @@ REDSTATUS RedCoreVolUnmount(void);
 #if REDCONF_READ_ONLY == 0
 REDSTATUS RedCoreVolTransact(void);
 #endif
+#if REDCONF_TRANSACT_BG_MS > 0U
+REDSTATUS RedCoreVolTransactBackground(bool fIntervalOver);
+#endif
 #if REDCONF_API_POSIX == 1
 REDSTATUS RedCoreVolStat(REDSTATFS *pStatFS);
 #endif
+#if REDCONF_BUFFER_STATS == 1
+REDSTATUS RedCoreBufferStats(uint32_t *pulHits, uint32_t *pulMisses);
+#endif
 
 #if (REDCONF_READ_ONLY == 0) && ((REDCONF_API_POSIX == 1) || (REDCONF_API_FSE_TRANSMASKSET == 1))
 REDSTATUS RedCoreTransMaskSet(uint32_t ulEventMask);
@@ -81,12 +106,23 @@ REDSTATUS RedCoreFileSizeGet(uint32_t ulInode, uint64_t *pullSize);
 #endif
 
 REDSTATUS RedCoreFileRead(uint32_t ulInode, uint64_t ullStart, uint32_t *pulLen, void *pBuffer);
+#if REDCONF_READ_AHEAD > 0U
+REDSTATUS RedCoreFileReadSeq(uint32_t ulInode, uint64_t ullStart, uint32_t *pulLen, void *pBuffer, REDREADAHEAD *pReadAhead);
+#endif
 #if REDCONF_READ_ONLY == 0
 REDSTATUS RedCoreFileWrite(uint32_t ulInode, uint64_t ullStart, uint32_t *pulLen, const void *pBuffer);
 #endif
 #if TRUNCATE_SUPPORTED
 REDSTATUS RedCoreFileTruncate(uint32_t ulInode, uint64_t ullSize);
 #endif
+#if REDCONF_CONCURRENT_IO == 1
+void RedCoreFileIoEnter(uint32_t ulInode, bool fWrite);
+void RedCoreFileIoLeave(uint32_t ulInode, bool fWrite);
+void RedCoreVolIoDrain(void);
+#if REDCONF_READ_ONLY == 0
+void RedCoreVolIoQuiesce(void);
+#endif
+#endif
 
 #if (REDCONF_API_POSIX == 1) && (REDCONF_API_POSIX_READDIR == 1)
 REDSTATUS RedCoreDirRead(uint32_t ulInode, uint32_t *pulPos, char *pszName, uint32_t *pulInode);
@@ -185,6 +185,28 @@
 #define CAST_CONST_DIRENT_PTR(PTR) ((const DIRENT *)(PTR))
 
 
+/** @brief Compute the distance in bytes from one pointer to another.
+
+    This is used by the block buffer module to derive the index of a buffer from
+    a pointer into the buffer array, which would otherwise require comparing the
+    pointer against every buffer in turn.  The caller divides the distance by
+    the buffer size and then confirms, with a pointer equality comparison, that
+    the resulting buffer is the one it was given; so a pointer which is not a
+    buffer (including one which precedes the array, for which the unsigned
+    subtraction wraps around) is still rejected.
+
+    Usage of this macro deviates from MISRA C:2012 Rule 11.4 (advisory), for
+    the reasons described for IS_ALIGNED_PTR() below: the integer values are
+    never converted back into pointers.  Subtracting the pointers directly would
+    be undefined behavior unless both point into the same array, which is
+    exactly what is being determined.
+
+    As Rule 11.4 is advisory, a deviation record is not required.  This notice
+    is the only record of the deviation.
+*/
+#define PTR_BYTE_DISTANCE(ptr, base) ((uintptr_t)(ptr) - (uintptr_t)(base))
+
+
 /** @brief Determine whether a pointer is aligned.
 
     A pointer is aligned if its address is an even multiple of
@@ -60,8 +60,19 @@ REDSTATUS RedOsMutexUninit(void);
 void RedOsMutexAcquire(void);
 void RedOsMutexRelease(void);
 #endif
+#if (REDCONF_TASK_COUNT > 1U) && (REDCONF_CONCURRENT_IO == 1)
+void RedOsMutexWait(void);
+void RedOsMutexWakeAll(void);
+#endif
+#if (REDCONF_TASK_COUNT > 1U) && ((REDCONF_TRANSACT_GROUP_MS > 0U) || (REDCONF_TRANSACT_BG_MS > 0U))
+void RedOsMutexWaitTimeout(uint32_t ulMilliseconds);
+#endif
 #if (REDCONF_TASK_COUNT > 1U) && (REDCONF_API_POSIX == 1)
 uint32_t RedOsTaskId(void);
+
+/*  Non-standard API: for multitasking tests only.
+*/
+REDSTATUS RedOsTaskRun(uint32_t ulTaskCount, void (*pfnEntry)(uint32_t ulTaskIdx, void *pContext), void *pContext);
 #endif
 
 REDSTATUS RedOsClockInit(void);
@@ -143,6 +143,9 @@ int32_t red_format(const char *pszVolume);
 #if REDCONF_READ_ONLY == 0
 int32_t red_transact(const char *pszVolume);
 #endif
+#if REDCONF_TRANSACT_BG_MS > 0U
+int32_t red_bgtransact(void);
+#endif
 #if REDCONF_READ_ONLY == 0
 int32_t red_settransmask(const char *pszVolume, uint32_t ulEventMask);
 #endif
@@ -45,6 +45,12 @@
       && (REDCONF_API_POSIX_RMDIR == 1) && (REDCONF_API_POSIX_RENAME == 1) && (REDCONF_API_POSIX_LINK == 1) \
       && (REDCONF_API_POSIX_FTRUNCATE == 1) && (REDCONF_API_POSIX_READDIR == 1))
 
+#define FSBENCH_SUPPORTED  \
+    (    ((RED_KIT == RED_KIT_GPL) || (RED_KIT == RED_KIT_SANDBOX)) \
+      && (REDCONF_OUTPUT == 1) && (REDCONF_READ_ONLY == 0) && (REDCONF_PATH_SEPARATOR == '/') \
+      && (REDCONF_API_POSIX == 1) && (REDCONF_API_POSIX_UNLINK == 1) && (REDCONF_API_POSIX_MKDIR == 1) \
+      && (REDCONF_API_POSIX_RMDIR == 1) && (REDCONF_API_POSIX_READDIR == 1))
+
 #define FSE_STRESS_TEST_SUPPORTED \
     (    ((RED_KIT == RED_KIT_COMMERCIAL) || (RED_KIT == RED_KIT_SANDBOX)) \
       && (REDCONF_OUTPUT == 1) && (REDCONF_READ_ONLY == 0) && (REDCONF_API_FSE == 1) \
@@ -106,6 +112,33 @@ void FsstressDefaultParams(FSSTRESSPARAM *pParam);
 int FsstressStart(const FSSTRESSPARAM *pParam);
 #endif
 
+#if FSBENCH_SUPPORTED
+typedef struct
+{
+    const char *pszVolume;      /**< Volume path prefix. */
+    bool        fMetadata;      /**< --meta */
+    bool        fSequential;    /**< --seq */
+    bool        fLargeDir;      /**< --large-dir */
+    bool        fCrc;           /**< --crc */
+    bool        fMulti;         /**< --multi */
+    bool        fRandom;        /**< --random */
+    bool        fLatency;       /**< --latency */
+    uint32_t    ulDirs;         /**< --dirs */
+    uint32_t    ulFiles;        /**< --files */
+    uint32_t    ulEntries;      /**< --entries */
+    uint32_t    ulFileSizeKB;   /**< --size */
+    uint32_t    ulIoSize;       /**< --io */
+    uint32_t    ulTasks;        /**< --tasks */
+    bool        fAutoTransact;  /**< --transact */
+    uint32_t    ulSeed;         /**< --seed */
+    bool        fCsv;           /**< --csv */
+} FSBENCHPARAM;
+
+PARAMSTATUS FsbenchParseParams(int argc, char *argv[], FSBENCHPARAM *pParam, uint8_t *pbVolNum, const char **ppszDevice);
+void FsbenchDefaultParams(FSBENCHPARAM *pParam);
+int FsbenchStart(const FSBENCHPARAM *pParam);
+#endif
+
 #if STOCH_POSIX_TEST_SUPPORTED
 typedef struct
 {
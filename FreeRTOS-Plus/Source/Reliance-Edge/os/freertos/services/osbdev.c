@@ -102,6 +102,23 @@
 */
 #define BDEV_RAM_DISK       (4U)
 
+/** @brief The Linux host file example implementation.
+
+    This implementation is for the FreeRTOS POSIX/Linux simulator port.  Each
+    volume is stored in an image file or a raw block device on the host, named
+    with RedOsBDevConfig() (by default, red0.bin for volume zero, red1.bin for
+    volume one, and so on), and accessed with pread() and pwrite().  Flushes
+    use fdatasync(), so a transaction point survives a power loss of the host,
+    as it would on target hardware.  This allows the tests and benchmarks to be
+    run on a workstation, against real storage.
+
+    If #BDEV_HOST_FILE_DIRECT is 1, the host page cache is bypassed with
+    O_DIRECT, so that results reflect the storage rather than the host's RAM.
+    The sector size of each volume must then be a multiple of the logical
+    sector size of the storage.
+*/
+#define BDEV_HOST_FILE      (5U)
+
 /** @brief Pick which example implementation is compiled.
 
     Must be one of:
@@ -110,6 +127,7 @@
     - #BDEV_ATMEL_SDMMC
     - #BDEV_STM32_SDIO
     - #BDEV_RAM_DISK
+    - #BDEV_HOST_FILE
 */
 #define BDEV_EXAMPLE_IMPLEMENTATION BDEV_RAM_DISK
 
@@ -1545,6 +1563,492 @@ static REDSTATUS DiskFlush(
 }
 #endif /* REDCONF_READ_ONLY == 0 */
 
+#elif BDEV_EXAMPLE_IMPLEMENTATION == BDEV_HOST_FILE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+
+/** @brief Whether the host file example implementation bypasses the host
+           page cache with O_DIRECT.
+*/
+#ifndef BDEV_HOST_FILE_DIRECT
+#define BDEV_HOST_FILE_DIRECT 0
+#endif
+
+#if (BDEV_HOST_FILE_DIRECT == 1) && !defined(O_DIRECT)
+  #error "BDEV_HOST_FILE_DIRECT requires O_DIRECT: define _GNU_SOURCE when compiling osbdev.c"
+#endif
+
+/*  With O_DIRECT, a transfer to or from a buffer which is not aligned on a
+    sector boundary is copied through an aligned buffer of up to this size,
+    which must be at least the largest sector size, 64 KB.
+*/
+#define HOST_BOUNCE_SIZE    (64U * 1024U)
+
+/*  The maximum length of a default image file name.
+*/
+#define HOST_NAME_MAX_LEN   16U
+
+
+static REDSTATUS HostTransfer(uint8_t bVolNum, uint64_t ullSectorStart, uint32_t ulSectorCount, void *pBuffer, bool fWrite);
+static REDSTATUS HostPio(int iFd, uint64_t ullOffset, uint32_t ulByteCount, void *pBuffer, bool fWrite);
+
+
+static const char *gapszHostFile[REDCONF_VOLUME_COUNT];
+static int gaiHostFd[REDCONF_VOLUME_COUNT];
+static bool gafHostOpen[REDCONF_VOLUME_COUNT];
+
+
+/** @brief Name the image file or block device used for a volume.
+
+    Must be called while the volume's block device is closed.  The string is
+    not copied, so it must remain valid until the block device is closed.
+
+    @param bVolNum      The volume number of the volume to configure.
+    @param pszBDevSpec  The path of the image file or block device, or `NULL`
+                        to use the default name.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EBUSY  The block device is open.
+    @retval -RED_EINVAL @p bVolNum is an invalid volume number.
+*/
+REDSTATUS RedOsBDevConfig(
+    uint8_t     bVolNum,
+    const char *pszBDevSpec)
+{
+    REDSTATUS   ret;
+
+    if(bVolNum >= REDCONF_VOLUME_COUNT)
+    {
+        ret = -RED_EINVAL;
+    }
+    else if(gafHostOpen[bVolNum])
+    {
+        ret = -RED_EBUSY;
+    }
+    else
+    {
+        gapszHostFile[bVolNum] = pszBDevSpec;
+        ret = 0;
+    }
+
+    return ret;
+}
+
+
+/** @brief Initialize a disk.
+
+    An image file which does not exist is created when opened for writing, and
+    an image file which is too small is extended; a block device must already
+    be large enough.
+
+    @param bVolNum  The volume number of the volume whose block device is being
+                    initialized.
+    @param mode     The open mode, indicating the type of access required.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The file or device is too small for the volume, or its
+                        sector size is incompatible.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS DiskOpen(
+    uint8_t         bVolNum,
+    BDEVOPENMODE    mode)
+{
+    const VOLCONF  *pVolConf = &gaRedVolConf[bVolNum];
+    uint64_t        ullNeeded = pVolConf->ullSectorCount * pVolConf->ulSectorSize;
+    char            szDefault[HOST_NAME_MAX_LEN];
+    const char     *pszPath = gapszHostFile[bVolNum];
+    int             iFlags;
+    int             iFd;
+    REDSTATUS       ret = 0;
+
+    if(pszPath == NULL)
+    {
+        (void)snprintf(szDefault, sizeof(szDefault), "red%u.bin", (unsigned)bVolNum);
+        pszPath = szDefault;
+    }
+
+    switch(mode)
+    {
+        case BDEV_O_RDONLY:
+            iFlags = O_RDONLY;
+            break;
+        case BDEV_O_WRONLY:
+            iFlags = O_WRONLY | O_CREAT;
+            break;
+        default:
+            iFlags = O_RDWR | O_CREAT;
+            break;
+    }
+
+  #if BDEV_HOST_FILE_DIRECT == 1
+    iFlags |= O_DIRECT;
+  #endif
+
+    do
+    {
+        iFd = open(pszPath, iFlags, 0644);
+    } while((iFd == -1) && (errno == EINTR));
+
+    if(iFd == -1)
+    {
+        ret = -RED_EIO;
+    }
+    else
+    {
+        struct stat st;
+
+        if(fstat(iFd, &st) != 0)
+        {
+            ret = -RED_EIO;
+        }
+        else if(S_ISBLK(st.st_mode))
+        {
+            uint64_t    ullDevSize;
+            int         iDevSectorSize;
+
+            if(    (ioctl(iFd, BLKGETSIZE64, &ullDevSize) != 0)
+                || (ioctl(iFd, BLKSSZGET, &iDevSectorSize) != 0))
+            {
+                ret = -RED_EIO;
+            }
+            else if(    (ullDevSize < ullNeeded)
+                     || (iDevSectorSize <= 0)
+                     || ((pVolConf->ulSectorSize % (uint32_t)iDevSectorSize) != 0U))
+            {
+                ret = -RED_EINVAL;
+            }
+            else
+            {
+                /*  The device is large enough.
+                */
+            }
+        }
+        else if((uint64_t)st.st_size < ullNeeded)
+        {
+            /*  Extend the image file.  The new space reads as zeros, and is
+                only allocated on the host once it is written.
+            */
+            if(mode == BDEV_O_RDONLY)
+            {
+                ret = -RED_EINVAL;
+            }
+            else if(ftruncate(iFd, (off_t)ullNeeded) != 0)
+            {
+                ret = -RED_EIO;
+            }
+            else
+            {
+                /*  The file is now large enough.
+                */
+            }
+        }
+        else
+        {
+            /*  The file is large enough.
+            */
+        }
+
+        if(ret == 0)
+        {
+            gaiHostFd[bVolNum] = iFd;
+            gafHostOpen[bVolNum] = true;
+        }
+        else
+        {
+            (void)close(iFd);
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Uninitialize a disk.
+
+    @param bVolNum  The volume number of the volume whose block device is being
+                    uninitialized.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The block device is not open.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS DiskClose(
+    uint8_t     bVolNum)
+{
+    REDSTATUS   ret;
+
+    if(!gafHostOpen[bVolNum])
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        gafHostOpen[bVolNum] = false;
+
+        ret = (close(gaiHostFd[bVolNum]) == 0) ? 0 : -RED_EIO;
+    }
+
+    return ret;
+}
+
+
+/** @brief Read sectors from a disk.
+
+    @param bVolNum          The volume number of the volume whose block device
+                            is being read from.
+    @param ullSectorStart   The starting sector number.
+    @param ulSectorCount    The number of sectors to read.
+    @param pBuffer          The buffer into which to read the sector data.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The block device is not open.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_ENOMEM Insufficient memory for an aligned buffer.
+*/
+static REDSTATUS DiskRead(
+    uint8_t     bVolNum,
+    uint64_t    ullSectorStart,
+    uint32_t    ulSectorCount,
+    void       *pBuffer)
+{
+    return HostTransfer(bVolNum, ullSectorStart, ulSectorCount, pBuffer, false);
+}
+
+
+#if REDCONF_READ_ONLY == 0
+/** @brief Write sectors to a disk.
+
+    @param bVolNum          The volume number of the volume whose block device
+                            is being written to.
+    @param ullSectorStart   The starting sector number.
+    @param ulSectorCount    The number of sectors to write.
+    @param pBuffer          The buffer from which to write the sector data.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The block device is not open.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_ENOMEM Insufficient memory for an aligned buffer.
+*/
+static REDSTATUS DiskWrite(
+    uint8_t     bVolNum,
+    uint64_t    ullSectorStart,
+    uint32_t    ulSectorCount,
+    const void *pBuffer)
+{
+    /*  HostTransfer() does not modify the buffer when writing.
+    */
+    return HostTransfer(bVolNum, ullSectorStart, ulSectorCount, CAST_AWAY_CONST(void, pBuffer), true);
+}
+
+
+/** @brief Flush any caches beneath the file system.
+
+    @param bVolNum  The volume number of the volume whose block device is being
+                    flushed.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The block device is not open.
+    @retval -RED_EIO    A disk I/O error occurred.
+*/
+static REDSTATUS DiskFlush(
+    uint8_t     bVolNum)
+{
+    REDSTATUS   ret;
+
+    if(!gafHostOpen[bVolNum])
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        int iResult;
+
+        /*  Even with O_DIRECT, the data might be in the storage's write cache,
+            which fdatasync() flushes.
+        */
+        do
+        {
+            iResult = fdatasync(gaiHostFd[bVolNum]);
+        } while((iResult != 0) && (errno == EINTR));
+
+        ret = (iResult == 0) ? 0 : -RED_EIO;
+    }
+
+    return ret;
+}
+#endif /* REDCONF_READ_ONLY == 0 */
+
+
+/** @brief Read or write sectors of a disk.
+
+    Several tasks may transfer data at once when REDCONF_CONCURRENT_IO is 1, so
+    no state is shared between transfers.
+
+    @param bVolNum          The volume number of the volume whose block device
+                            is being accessed.
+    @param ullSectorStart   The starting sector number.
+    @param ulSectorCount    The number of sectors to transfer.
+    @param pBuffer          The buffer to read into, or to write from.
+    @param fWrite           Whether to write, rather than read.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL The block device is not open.
+    @retval -RED_EIO    A disk I/O error occurred.
+    @retval -RED_ENOMEM Insufficient memory for an aligned buffer.
+*/
+static REDSTATUS HostTransfer(
+    uint8_t     bVolNum,
+    uint64_t    ullSectorStart,
+    uint32_t    ulSectorCount,
+    void       *pBuffer,
+    bool        fWrite)
+{
+    REDSTATUS   ret;
+
+    if(!gafHostOpen[bVolNum])
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        uint32_t    ulSectorSize = gaRedVolConf[bVolNum].ulSectorSize;
+        uint64_t    ullOffset = ullSectorStart * ulSectorSize;
+        uint32_t    ulByteCount = ulSectorCount * ulSectorSize;
+        int         iFd = gaiHostFd[bVolNum];
+
+      #if BDEV_HOST_FILE_DIRECT == 1
+        if(((uintptr_t)pBuffer % ulSectorSize) != 0U)
+        {
+            /*  The sector size is a power of two no larger than the bounce
+                buffer, so each piece is a whole number of sectors.
+            */
+            uint32_t    ulBounceSize = REDMIN(ulByteCount, HOST_BOUNCE_SIZE);
+            void       *pBounce;
+
+            if(posix_memalign(&pBounce, ulSectorSize, ulBounceSize) != 0)
+            {
+                ret = -RED_ENOMEM;
+            }
+            else
+            {
+                uint8_t    *pbBuffer = CAST_VOID_PTR_TO_UINT8_PTR(pBuffer);
+                uint32_t    ulDone = 0U;
+
+                ret = 0;
+
+                while((ret == 0) && (ulDone < ulByteCount))
+                {
+                    uint32_t ulThis = REDMIN(ulByteCount - ulDone, ulBounceSize);
+
+                    if(fWrite)
+                    {
+                        RedMemCpy(pBounce, &pbBuffer[ulDone], ulThis);
+                    }
+
+                    ret = HostPio(iFd, ullOffset + ulDone, ulThis, pBounce, fWrite);
+
+                    if((ret == 0) && !fWrite)
+                    {
+                        RedMemCpy(&pbBuffer[ulDone], pBounce, ulThis);
+                    }
+
+                    ulDone += ulThis;
+                }
+
+                free(pBounce);
+            }
+        }
+        else
+      #endif
+        {
+            ret = HostPio(iFd, ullOffset, ulByteCount, pBuffer, fWrite);
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Read or write a range of bytes of a file or device, finishing
+           transfers which were cut short or interrupted by a signal.
+
+    @param iFd          The file descriptor.
+    @param ullOffset    The byte offset to start at.
+    @param ulByteCount  The number of bytes to transfer.
+    @param pBuffer      The buffer to read into, or to write from.
+    @param fWrite       Whether to write, rather than read.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EIO    A disk I/O error occurred, or the end of the file or
+                        device was reached.
+*/
+static REDSTATUS HostPio(
+    int         iFd,
+    uint64_t    ullOffset,
+    uint32_t    ulByteCount,
+    void       *pBuffer,
+    bool        fWrite)
+{
+    uint8_t    *pbBuffer = CAST_VOID_PTR_TO_UINT8_PTR(pBuffer);
+    uint32_t    ulDone = 0U;
+    REDSTATUS   ret = 0;
+
+    while((ret == 0) && (ulDone < ulByteCount))
+    {
+        ssize_t iResult;
+
+        if(fWrite)
+        {
+            iResult = pwrite(iFd, &pbBuffer[ulDone], ulByteCount - ulDone, (off_t)(ullOffset + ulDone));
+        }
+        else
+        {
+            iResult = pread(iFd, &pbBuffer[ulDone], ulByteCount - ulDone, (off_t)(ullOffset + ulDone));
+        }
+
+        if(iResult > 0)
+        {
+            ulDone += (uint32_t)iResult;
+        }
+        else if((iResult == -1) && (errno == EINTR))
+        {
+            /*  The FreeRTOS POSIX port uses signals, which can interrupt the
+                transfer before anything is transferred; try again.
+            */
+        }
+        else
+        {
+            ret = -RED_EIO;
+        }
+    }
+
+    return ret;
+}
+
 #else
 
 #error "Invalid BDEV_EXAMPLE_IMPLEMENTATION value"
@@ -27,6 +27,7 @@
 */
 #include <FreeRTOS.h>
 #include <semphr.h>
+#include <task.h>
 
 #include <redfs.h>
 #include <redosdeviations.h>
@@ -39,6 +40,27 @@ static SemaphoreHandle_t xMutex;
 static StaticSemaphore_t xMutexBuffer;
 #endif
 
+#if REDCONF_CONCURRENT_IO == 1
+static void MutexWait(TickType_t xTicksToWait);
+
+
+/*  States of a waiter slot used by RedOsMutexWait().
+*/
+#define WAITER_FREE     0U  /* Not in use. */
+#define WAITER_WAITING  1U  /* A task is waiting on the slot's semaphore. */
+#define WAITER_WOKEN    2U  /* The semaphore has been given; the task has yet to wake. */
+
+/*  One binary semaphore for each task which might wait in RedOsMutexWait().
+    A slot is only freed by the task which waited on it, after it has taken
+    the semaphore, so a wakeup is never consumed by the wrong task.
+*/
+static SemaphoreHandle_t axWaiter[REDCONF_TASK_COUNT];
+static uint8_t abWaiterState[REDCONF_TASK_COUNT];
+#if defined(configSUPPORT_STATIC_ALLOCATION) && (configSUPPORT_STATIC_ALLOCATION == 1)
+static StaticSemaphore_t axWaiterBuffer[REDCONF_TASK_COUNT];
+#endif
+#endif
+
 
 /** @brief Initialize the mutex.
 
@@ -75,6 +97,42 @@ REDSTATUS RedOsMutexInit(void)
     }
   #endif
 
+  #if REDCONF_CONCURRENT_IO == 1
+    if(ret == 0)
+    {
+        uint32_t ulIdx;
+
+        for(ulIdx = 0U; ulIdx < REDCONF_TASK_COUNT; ulIdx++)
+        {
+          #if defined(configSUPPORT_STATIC_ALLOCATION) && (configSUPPORT_STATIC_ALLOCATION == 1)
+            axWaiter[ulIdx] = xSemaphoreCreateBinaryStatic(&axWaiterBuffer[ulIdx]);
+          #else
+            axWaiter[ulIdx] = xSemaphoreCreateBinary();
+          #endif
+            abWaiterState[ulIdx] = WAITER_FREE;
+
+            if(axWaiter[ulIdx] == NULL)
+            {
+                ret = -RED_ENOMEM;
+                break;
+            }
+        }
+
+        if(ret != 0)
+        {
+            while(ulIdx > 0U)
+            {
+                ulIdx--;
+                vSemaphoreDelete(axWaiter[ulIdx]);
+                axWaiter[ulIdx] = NULL;
+            }
+
+            vSemaphoreDelete(xMutex);
+            xMutex = NULL;
+        }
+    }
+  #endif
+
     return ret;
 }
 
@@ -91,6 +149,16 @@ REDSTATUS RedOsMutexInit(void)
 */
 REDSTATUS RedOsMutexUninit(void)
 {
+  #if REDCONF_CONCURRENT_IO == 1
+    uint32_t ulIdx;
+
+    for(ulIdx = 0U; ulIdx < REDCONF_TASK_COUNT; ulIdx++)
+    {
+        vSemaphoreDelete(axWaiter[ulIdx]);
+        axWaiter[ulIdx] = NULL;
+    }
+  #endif
+
     vSemaphoreDelete(xMutex);
     xMutex = NULL;
 
@@ -130,5 +198,134 @@ void RedOsMutexRelease(void)
     IGNORE_ERRORS(xSuccess);
 }
 
+
+#if REDCONF_CONCURRENT_IO == 1
+/** @brief Release the mutex, wait to be woken by RedOsMutexWakeAll(), and
+           acquire the mutex again.
+
+    The mutex must be held by the calling task.  The caller must check the
+    condition it is waiting for after this function returns, since the task
+    may also be woken for a reason which does not concern it.
+*/
+void RedOsMutexWait(void)
+{
+    MutexWait(portMAX_DELAY);
+}
+
+
+#if (REDCONF_TRANSACT_GROUP_MS > 0U) || (REDCONF_TRANSACT_BG_MS > 0U)
+/** @brief Release the mutex, wait to be woken by RedOsMutexWakeAll() or for
+           a time to pass, and acquire the mutex again.
+
+    Like RedOsMutexWait(), the task may also be woken for a reason which does
+    not concern it, and may wait somewhat longer than asked.
+
+    @param ulMilliseconds   The longest time to wait, in milliseconds.
+*/
+void RedOsMutexWaitTimeout(
+    uint32_t    ulMilliseconds)
+{
+    TickType_t  xTicks = pdMS_TO_TICKS(ulMilliseconds);
+
+    /*  Round short waits up to a tick, so that the task does yield.
+    */
+    MutexWait((xTicks == 0U) ? 1U : xTicks);
+}
+#endif
+
+
+/** @brief Wake every task waiting in RedOsMutexWait().
+
+    The mutex must be held by the calling task.  The woken tasks run once the
+    mutex is released.
+*/
+void RedOsMutexWakeAll(void)
+{
+    uint32_t ulIdx;
+
+    for(ulIdx = 0U; ulIdx < REDCONF_TASK_COUNT; ulIdx++)
+    {
+        if(abWaiterState[ulIdx] == WAITER_WAITING)
+        {
+            BaseType_t xSuccess;
+
+            abWaiterState[ulIdx] = WAITER_WOKEN;
+
+            xSuccess = xSemaphoreGive(axWaiter[ulIdx]);
+            REDASSERT(xSuccess == pdTRUE);
+            IGNORE_ERRORS(xSuccess);
+        }
+    }
+}
+
+
+/** @brief Release the mutex, wait on a waiter slot, and acquire the mutex
+           again.
+
+    @param xTicksToWait The longest time to wait, in ticks; portMAX_DELAY to
+                        wait until woken.
+*/
+static void MutexWait(
+    TickType_t  xTicksToWait)
+{
+    uint32_t    ulIdx;
+
+    for(ulIdx = 0U; ulIdx < REDCONF_TASK_COUNT; ulIdx++)
+    {
+        if(abWaiterState[ulIdx] == WAITER_FREE)
+        {
+            break;
+        }
+    }
+
+    if(ulIdx < REDCONF_TASK_COUNT)
+    {
+        bool fWoken;
+
+        abWaiterState[ulIdx] = WAITER_WAITING;
+
+        RedOsMutexRelease();
+
+        if(xTicksToWait == portMAX_DELAY)
+        {
+            while(xSemaphoreTake(axWaiter[ulIdx], portMAX_DELAY) != pdTRUE)
+            {
+            }
+
+            fWoken = true;
+        }
+        else
+        {
+            fWoken = xSemaphoreTake(axWaiter[ulIdx], xTicksToWait) == pdTRUE;
+        }
+
+        RedOsMutexAcquire();
+
+        /*  If the wait timed out, but the slot was woken before the mutex was
+            acquired again, take the semaphore, so that the next task to use
+            the slot is not woken by it.
+        */
+        if(!fWoken && (abWaiterState[ulIdx] == WAITER_WOKEN))
+        {
+            while(xSemaphoreTake(axWaiter[ulIdx], portMAX_DELAY) != pdTRUE)
+            {
+            }
+        }
+
+        abWaiterState[ulIdx] = WAITER_FREE;
+    }
+    else
+    {
+        /*  More tasks are waiting than there are task slots, which can only
+            happen when REDCONF_TASK_COUNT is exceeded.  Rather than blocking
+            indefinitely, let the other tasks run for a tick.
+        */
+        RedOsMutexRelease();
+        vTaskDelay(1U);
+        RedOsMutexAcquire();
+    }
+}
+#endif
+
 #endif
 
@@ -27,6 +27,7 @@
 */
 #include <FreeRTOS.h>
 #include <task.h>
+#include <semphr.h>
 
 #include <redfs.h>
 
@@ -38,6 +39,27 @@
   #error "INCLUDE_xTaskGetCurrentTaskHandle must be 1 when REDCONF_TASK_COUNT > 1 and REDCONF_API_POSIX == 1"
 #endif
 
+/*  Stack depth, in words, of the tasks created by RedOsTaskRun().
+*/
+#define TASK_RUN_STACK_DEPTH    (configMINIMAL_STACK_SIZE * 4U)
+
+
+/*  Parameters for a task created by RedOsTaskRun().
+*/
+typedef struct
+{
+    void              (*pfnEntry)(uint32_t ulTaskIdx, void *pContext);
+    void               *pContext;
+    uint32_t            ulTaskIdx;
+    SemaphoreHandle_t   xDone;
+} TASKRUN;
+
+
+static void TaskRunEntry(void *pvParameters);
+
+
+static TASKRUN aTaskRun[REDCONF_TASK_COUNT];
+
 
 /** @brief Get the current task ID.
 
@@ -64,5 +86,97 @@ uint32_t RedOsTaskId(void)
     return ulTaskPtr + 1U;
 }
 
+
+/** @brief Run a function in several tasks at once and wait for all of them to
+           return.
+
+    The tasks are created with the priority of the calling task.  Each task
+    which uses the file system occupies one of the REDCONF_TASK_COUNT task
+    slots, so @p ulTaskCount must be less than REDCONF_TASK_COUNT.  This
+    function is not reentrant.
+
+    @param ulTaskCount  The number of tasks to run.
+    @param pfnEntry     The function to run in each task.
+    @param pContext     The context pointer passed to each task.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           Operation was successful.
+    @retval -RED_EINVAL @p ulTaskCount is zero or not less than
+                        REDCONF_TASK_COUNT, or @p pfnEntry is `NULL`.
+    @retval -RED_ENOMEM Insufficient memory to create the tasks.
+*/
+REDSTATUS RedOsTaskRun(
+    uint32_t    ulTaskCount,
+    void      (*pfnEntry)(uint32_t ulTaskIdx, void *pContext),
+    void       *pContext)
+{
+    REDSTATUS   ret = 0;
+
+    if((ulTaskCount == 0U) || (ulTaskCount >= REDCONF_TASK_COUNT) || (pfnEntry == NULL))
+    {
+        ret = -RED_EINVAL;
+    }
+    else
+    {
+        SemaphoreHandle_t   xDone = xSemaphoreCreateCounting(ulTaskCount, 0U);
+        uint32_t            ulStarted;
+
+        if(xDone == NULL)
+        {
+            ret = -RED_ENOMEM;
+        }
+        else
+        {
+            for(ulStarted = 0U; ulStarted < ulTaskCount; ulStarted++)
+            {
+                aTaskRun[ulStarted].pfnEntry = pfnEntry;
+                aTaskRun[ulStarted].pContext = pContext;
+                aTaskRun[ulStarted].ulTaskIdx = ulStarted;
+                aTaskRun[ulStarted].xDone = xDone;
+
+                if(xTaskCreate(TaskRunEntry, "RedTaskRun", TASK_RUN_STACK_DEPTH, &aTaskRun[ulStarted], uxTaskPriorityGet(NULL), NULL) != pdPASS)
+                {
+                    ret = -RED_ENOMEM;
+                    break;
+                }
+            }
+
+            /*  Wait for the tasks which were started, even if not all of them
+                could be.
+            */
+            while(ulStarted > 0U)
+            {
+                while(xSemaphoreTake(xDone, portMAX_DELAY) != pdTRUE)
+                {
+                }
+
+                ulStarted--;
+            }
+
+            vSemaphoreDelete(xDone);
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Entry point of a task created by RedOsTaskRun().
+
+    @param pvParameters The ::TASKRUN structure for the task.
+*/
+static void TaskRunEntry(
+    void       *pvParameters)
+{
+    const TASKRUN *pRun = (const TASKRUN *)pvParameters;
+
+    pRun->pfnEntry(pRun->ulTaskIdx, pRun->pContext);
+
+    (void)xSemaphoreGive(pRun->xDone);
+
+    vTaskDelete(NULL);
+}
+
 #endif
 
@@ -85,6 +85,7 @@
 #define HFLAG_READABLE  0x02U   /* Handle is readable. */
 #define HFLAG_WRITEABLE 0x04U   /* Handle is writeable. */
 #define HFLAG_APPENDING 0x08U   /* Handle was opened in append mode. */
+#define HFLAG_BUSY      0x10U   /* Handle is being read or written by a task; see HandleIoEnter(). */
 
 /*  @brief Handle structure, used to implement file descriptors and directory
            streams.
@@ -98,6 +99,9 @@ typedef struct sREDHANDLE
   #if REDCONF_API_POSIX_READDIR == 1
     REDDIRENT       dirent;     /**< Dirent structure returned by red_readdir(). */
   #endif
+  #if REDCONF_READ_AHEAD > 0U
+    REDREADAHEAD    ra;         /**< Sequential read state used by red_read(). */
+  #endif
 } REDHANDLE;
 
 /*-------------------------------------------------------------------
@@ -124,7 +128,13 @@ static REDSTATUS UnlinkSub(const char *pszPath, FTYPE type);
 static REDSTATUS FildesOpen(const char *pszPath, uint32_t ulOpenMode, FTYPE type, int32_t *piFildes);
 static REDSTATUS FildesClose(int32_t iFildes);
 static REDSTATUS FildesToHandle(int32_t iFildes, FTYPE expectedType, REDHANDLE **ppHandle);
+#if REDCONF_CONCURRENT_IO == 1
+static REDSTATUS FildesToIdleHandle(int32_t iFildes, FTYPE expectedType, REDHANDLE **ppHandle);
+static void HandleIoEnter(REDHANDLE *pHandle, bool fWrite);
+static void HandleIoLeave(REDHANDLE *pHandle, bool fWrite);
+#endif
 static int32_t FildesPack(uint16_t uHandleIdx, uint8_t bVolNum);
+static REDSTATUS VolHandlesCheck(uint8_t bVolNum);
 static void FildesUnpack(int32_t iFildes, uint16_t *puHandleIdx, uint8_t *pbVolNum, uint16_t *puGeneration);
 #if REDCONF_API_POSIX_READDIR == 1
 static bool DirStreamIsValid(const REDDIR *pDirStream);
@@ -149,6 +159,9 @@ static REDHANDLE gaHandle[REDCONF_HANDLE_COUNT];        /* Array of all handles.
 #if REDCONF_TASK_COUNT > 1U
 static TASKSLOT gaTask[REDCONF_TASK_COUNT];             /* Array of task slots. */
 #endif
+#if REDCONF_TRANSACT_BG_MS > 0U
+static bool gfBgTransact;                               /* Whether red_bgtransact() is running. */
+#endif
 
 /*  Array of volume mount "generations".  These are incremented for a volume
     each time that volume is mounted.  The generation number (along with the
@@ -255,6 +268,18 @@ int32_t red_uninit(void)
                     driver uninitialized with a mounted volume.
                 */
                 gfPosixInited = false;
+
+              #if REDCONF_TRANSACT_BG_MS > 0U
+                /*  Wake the background transaction task, which returns when it
+                    finds the driver uninitialized, and wait for it to do so.
+                */
+                RedOsMutexWakeAll();
+
+                while(gfBgTransact)
+                {
+                    RedOsMutexWait();
+                }
+              #endif
             }
 
             /*  The FS mutex must be released before we uninitialize the core,
@@ -423,22 +448,11 @@ int32_t red_umount(
             ret = -RED_EINVAL;
         }
 
+        /*  Do not unmount the volume if it still has open handles.
+        */
         if(ret == 0)
         {
-            uint16_t    uHandleIdx;
-
-            /*  Do not unmount the volume if it still has open handles.
-            */
-            for(uHandleIdx = 0U; uHandleIdx < REDCONF_HANDLE_COUNT; uHandleIdx++)
-            {
-                const REDHANDLE *pHandle = &gaHandle[uHandleIdx];
-
-                if((pHandle->ulInode != INODE_INVALID) && (pHandle->bVolNum == bVolNum))
-                {
-                    ret = -RED_EBUSY;
-                    break;
-                }
-            }
+            ret = VolHandlesCheck(bVolNum);
         }
 
       #if REDCONF_VOLUME_COUNT > 1U
@@ -448,6 +462,20 @@ int32_t red_umount(
         }
       #endif
 
+      #if REDCONF_CONCURRENT_IO == 1
+        /*  With no open handles, no file on the volume is being read or
+            written, but transaction points might still be waiting for writes
+            which have since finished.  Let them finish first, then check the
+            handles again, since the mutex was released in the meantime.
+        */
+        if(ret == 0)
+        {
+            RedCoreVolIoDrain();
+
+            ret = VolHandlesCheck(bVolNum);
+        }
+      #endif
+
         if(ret == 0)
         {
             ret = RedCoreVolUnmount();
@@ -566,6 +594,102 @@ int32_t red_transact(
 #endif
 
 
+#if REDCONF_TRANSACT_BG_MS > 0U
+/** @brief Make transaction points in the background.
+
+    This function is the body of a background transaction task: the application
+    creates a task which calls it after red_init(), and it does not return
+    until red_uninit() is called, or an error occurs.  Every
+    #REDCONF_TRANSACT_BG_MS milliseconds, it makes a transaction point on each
+    mounted volume which has changed since its last transaction point.  If
+    #REDCONF_TRANSACT_BG_BLOCKS is nonzero, it also makes one as soon as that
+    many blocks have been written on a volume since its last transaction point.
+    The file system mutex is released while the task waits, and the task
+    occupies one of the #REDCONF_TASK_COUNT task slots.
+
+    The task only bounds how much work a power loss can take away: changes
+    which are not covered by a transaction point made some other way are
+    committed within about #REDCONF_TRANSACT_BG_MS milliseconds, plus the time
+    to make the transaction point.  Transaction points made because of the
+    transaction mask, red_transact(), or red_fsync() are unaffected, so it is
+    usual to clear #RED_TRANSACT_CLOSE, #RED_TRANSACT_WRITE, and similar events
+    from the mask, and keep red_fsync() for data which must be committed at
+    once.
+
+    Only one task at a time may run this function.
+
+    @return On success, zero is returned.  On error, -1 is returned and
+            #red_errno is set appropriately.
+
+    <b>Errno values</b>
+    - #RED_EBUSY: Another task is already running red_bgtransact().
+    - #RED_EINVAL: The driver is not initialized.
+    - #RED_EIO: I/O error during a transaction point.
+    - #RED_EUSERS: Cannot become a file system user: too many users.
+*/
+int32_t red_bgtransact(void)
+{
+    REDSTATUS   ret;
+
+    ret = PosixEnter();
+    if(ret == 0)
+    {
+        if(gfBgTransact)
+        {
+            ret = -RED_EBUSY;
+        }
+        else
+        {
+            REDTIMESTAMP tsInterval = RedOsTimestamp();
+
+            gfBgTransact = true;
+
+            while((ret == 0) && gfPosixInited)
+            {
+                uint64_t    ullWaitedMs = RedOsTimePassed(tsInterval) / 1000U;
+                bool        fIntervalOver = ullWaitedMs >= REDCONF_TRANSACT_BG_MS;
+                uint8_t     bVolNum;
+
+                for(bVolNum = 0U; (ret == 0) && (bVolNum < REDCONF_VOLUME_COUNT); bVolNum++)
+                {
+                    ret = RedCoreVolSetCurrent(bVolNum);
+
+                    if(ret == 0)
+                    {
+                        ret = RedCoreVolTransactBackground(fIntervalOver);
+                    }
+                }
+
+                if(fIntervalOver)
+                {
+                    tsInterval = RedOsTimestamp();
+                    ullWaitedMs = 0U;
+                }
+
+                if(ret == 0)
+                {
+                    RedOsMutexWaitTimeout((uint32_t)(REDCONF_TRANSACT_BG_MS - ullWaitedMs));
+                }
+            }
+
+            gfBgTransact = false;
+
+            /*  red_uninit() waits for the task to return.
+            */
+            RedOsMutexWakeAll();
+        }
+
+        /*  Don't use PosixLeave() if red_uninit() was called, since it asserts
+            gfPosixInited is true.
+        */
+        RedOsMutexRelease();
+    }
+
+    return PosixReturn(ret);
+}
+#endif
+
+
 #if REDCONF_READ_ONLY == 0
 /** @brief Update the transaction mask.
 
@@ -957,6 +1081,12 @@ int32_t red_mkdir(
         const char *pszLocalPath;
         uint8_t     bVolNum;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        /*  The parent directory must not change after it is looked up.
+        */
+        RedCoreVolIoQuiesce();
+      #endif
+
         ret = RedPathSplit(pszPath, &bVolNum, &pszLocalPath);
 
       #if REDCONF_VOLUME_COUNT > 1U
@@ -1127,6 +1257,12 @@ int32_t red_rename(
         const char *pszOldLocalPath;
         uint8_t     bOldVolNum;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        /*  The inodes must not change after they are looked up and checked.
+        */
+        RedCoreVolIoQuiesce();
+      #endif
+
         ret = RedPathSplit(pszOldPath, &bOldVolNum, &pszOldLocalPath);
 
         if(ret == 0)
@@ -1253,6 +1389,12 @@ int32_t red_link(
         const char *pszLocalPath;
         uint8_t     bVolNum;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        /*  The inodes must not change after they are looked up.
+        */
+        RedCoreVolIoQuiesce();
+      #endif
+
         ret = RedPathSplit(pszPath, &bVolNum, &pszLocalPath);
 
         if(ret == 0)
@@ -1382,7 +1524,11 @@ int32_t red_read(
     {
         REDHANDLE  *pHandle;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        ret = FildesToIdleHandle(iFildes, FTYPE_FILE, &pHandle);
+      #else
         ret = FildesToHandle(iFildes, FTYPE_FILE, &pHandle);
+      #endif
 
         if((ret == 0) && ((pHandle->bFlags & HFLAG_READABLE) == 0U))
         {
@@ -1398,8 +1544,20 @@ int32_t red_read(
 
         if(ret == 0)
         {
+          #if REDCONF_CONCURRENT_IO == 1
+            HandleIoEnter(pHandle, false);
+          #endif
+
             ulLenRead = ulLength;
+          #if REDCONF_READ_AHEAD > 0U
+            ret = RedCoreFileReadSeq(pHandle->ulInode, pHandle->ullOffset, &ulLenRead, pBuffer, &pHandle->ra);
+          #else
             ret = RedCoreFileRead(pHandle->ulInode, pHandle->ullOffset, &ulLenRead, pBuffer);
+          #endif
+
+          #if REDCONF_CONCURRENT_IO == 1
+            HandleIoLeave(pHandle, false);
+          #endif
         }
 
         if(ret == 0)
@@ -1488,7 +1646,11 @@ int32_t red_write(
     {
         REDHANDLE *pHandle;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        ret = FildesToIdleHandle(iFildes, FTYPE_FILE, &pHandle);
+      #else
         ret = FildesToHandle(iFildes, FTYPE_FILE, &pHandle);
+      #endif
         if(ret == -RED_EISDIR)
         {
             /*  POSIX says that if a file descriptor is not writable, the
@@ -1512,21 +1674,35 @@ int32_t red_write(
         }
       #endif
 
-        if((ret == 0) && ((pHandle->bFlags & HFLAG_APPENDING) != 0U))
+        if(ret == 0)
         {
-            REDSTAT s;
+            /*  When writes can run concurrently, the file size is only stable
+                once the write has been entered.
+            */
+          #if REDCONF_CONCURRENT_IO == 1
+            HandleIoEnter(pHandle, true);
+          #endif
+
+            if((pHandle->bFlags & HFLAG_APPENDING) != 0U)
+            {
+                REDSTAT s;
+
+                ret = RedCoreStat(pHandle->ulInode, &s);
+                if(ret == 0)
+                {
+                    pHandle->ullOffset = s.st_size;
+                }
+            }
 
-            ret = RedCoreStat(pHandle->ulInode, &s);
             if(ret == 0)
             {
-                pHandle->ullOffset = s.st_size;
+                ulLenWrote = ulLength;
+                ret = RedCoreFileWrite(pHandle->ulInode, pHandle->ullOffset, &ulLenWrote, pBuffer);
             }
-        }
 
-        if(ret == 0)
-        {
-            ulLenWrote = ulLength;
-            ret = RedCoreFileWrite(pHandle->ulInode, pHandle->ullOffset, &ulLenWrote, pBuffer);
+          #if REDCONF_CONCURRENT_IO == 1
+            HandleIoLeave(pHandle, true);
+          #endif
         }
 
         if(ret == 0)
@@ -1681,7 +1857,11 @@ int64_t red_lseek(
 
         /*  Unlike POSIX, we disallow lseek() on directory handles.
         */
+      #if REDCONF_CONCURRENT_IO == 1
+        ret = FildesToIdleHandle(iFildes, FTYPE_FILE, &pHandle);
+      #else
         ret = FildesToHandle(iFildes, FTYPE_FILE, &pHandle);
+      #endif
 
       #if REDCONF_VOLUME_COUNT > 1U
         if(ret == 0)
@@ -1815,7 +1995,11 @@ int32_t red_ftruncate(
     {
         REDHANDLE *pHandle;
 
+      #if REDCONF_CONCURRENT_IO == 1
+        ret = FildesToIdleHandle(iFildes, FTYPE_FILE, &pHandle);
+      #else
         ret = FildesToHandle(iFildes, FTYPE_FILE, &pHandle);
+      #endif
         if(ret == -RED_EISDIR)
         {
             /*  Similar to red_write() (see comment there), the RED_EBADF error
@@ -1838,7 +2022,15 @@ int32_t red_ftruncate(
 
         if(ret == 0)
         {
+          #if REDCONF_CONCURRENT_IO == 1
+            HandleIoEnter(pHandle, true);
+          #endif
+
             ret = RedCoreFileTruncate(pHandle->ulInode, ullSize);
+
+          #if REDCONF_CONCURRENT_IO == 1
+            HandleIoLeave(pHandle, true);
+          #endif
         }
 
         PosixLeave();
@@ -2277,6 +2469,12 @@ static REDSTATUS UnlinkSub(
     const char *pszLocalPath;
     REDSTATUS   ret;
 
+  #if REDCONF_CONCURRENT_IO == 1
+    /*  The inode must not be opened after it is checked below.
+    */
+    RedCoreVolIoQuiesce();
+  #endif
+
     ret = RedPathSplit(pszPath, &bVolNum, &pszLocalPath);
 
   #if REDCONF_VOLUME_COUNT > 1U
@@ -2398,6 +2596,17 @@ static REDSTATUS FildesOpen(
             uint16_t    uHandleIdx;
             REDHANDLE  *pHandle = NULL;
 
+          #if (REDCONF_CONCURRENT_IO == 1) && (REDCONF_READ_ONLY == 0)
+            /*  Creating the file may make a transaction point.  Transaction
+                points wait for writes in progress, releasing the mutex, and in
+                the meantime, another open could take the handle found below.
+            */
+            if((ulOpenMode & RED_O_CREAT) != 0U)
+            {
+                RedCoreVolIoQuiesce();
+            }
+          #endif
+
             /*  Search for an unused handle.
             */
             for(uHandleIdx = 0U; uHandleIdx < REDCONF_HANDLE_COUNT; uHandleIdx++)
@@ -2496,7 +2705,27 @@ static REDSTATUS FildesOpen(
                   #if (REDCONF_READ_ONLY == 0) && (REDCONF_API_POSIX_FTRUNCATE == 1)
                     if((ret == 0) && ((ulOpenMode & RED_O_TRUNC) != 0U))
                     {
+                      #if REDCONF_CONCURRENT_IO == 1
+                        /*  Waiting for reads and writes through other handles
+                            releases the mutex, so reserve the handle first.
+                            That keeps another open from taking it, and, since
+                            the file is then open, keeps it from being deleted
+                            and the volume from being unmounted.
+                        */
+                        pHandle->ulInode = ulInode;
+                        pHandle->bVolNum = bVolNum;
+                        pHandle->bFlags = HFLAG_BUSY;
+
+                        RedCoreFileIoEnter(ulInode, true);
+                      #endif
+
                         ret = RedCoreFileTruncate(ulInode, UINT64_SUFFIX(0));
+
+                      #if REDCONF_CONCURRENT_IO == 1
+                        RedCoreFileIoLeave(ulInode, true);
+
+                        pHandle->ulInode = INODE_INVALID;
+                      #endif
                     }
                   #endif
                 }
@@ -2572,7 +2801,11 @@ static REDSTATUS FildesClose(
     REDHANDLE  *pHandle;
     REDSTATUS   ret;
 
+  #if REDCONF_CONCURRENT_IO == 1
+    ret = FildesToIdleHandle(iFildes, FTYPE_EITHER, &pHandle);
+  #else
     ret = FildesToHandle(iFildes, FTYPE_EITHER, &pHandle);
+  #endif
 
   #if REDCONF_READ_ONLY == 0
   #if REDCONF_VOLUME_COUNT > 1U
@@ -2593,7 +2826,23 @@ static REDSTATUS FildesClose(
 
         if((ret == 0) && ((ulTransMask & RED_TRANSACT_CLOSE) != 0U))
         {
+          #if REDCONF_CONCURRENT_IO == 1
+            /*  The transaction point may release the mutex while it waits for
+                writes in progress, so keep other tasks from using the handle
+                in the meantime.
+            */
+            pHandle->bFlags |= HFLAG_BUSY;
+          #endif
+
             ret = RedCoreVolTransact();
+
+          #if REDCONF_CONCURRENT_IO == 1
+            /*  The tasks waiting for the handle run once the mutex is released,
+                and will find it closed, or idle if the transaction failed.
+            */
+            pHandle->bFlags &= (uint8_t)~HFLAG_BUSY;
+            RedOsMutexWakeAll();
+          #endif
         }
     }
   #endif
@@ -2680,6 +2929,81 @@ static REDSTATUS FildesToHandle(
 }
 
 
+#if REDCONF_CONCURRENT_IO == 1
+/** @brief Convert a file descriptor into a handle pointer, waiting until the
+           handle is not being read or written by another task.
+
+    The file offset of a handle is only stable while no other task is reading
+    or writing through the handle.
+
+    @param iFildes  The file descriptor for which to get a handle.
+    @param expectedType The expected type of the file descriptor: ::FTYPE_DIR,
+                        ::FTYPE_FILE, or ::FTYPE_EITHER.
+    @param ppHandle     On successful return, populated with a pointer to the
+                        handle associated with @p iFildes.
+
+    @return A negated ::REDSTATUS code indicating the operation result.  See
+            FildesToHandle() for the possible values.
+*/
+static REDSTATUS FildesToIdleHandle(
+    int32_t     iFildes,
+    FTYPE       expectedType,
+    REDHANDLE **ppHandle)
+{
+    REDSTATUS   ret = FildesToHandle(iFildes, expectedType, ppHandle);
+
+    while((ret == 0) && (((*ppHandle)->bFlags & HFLAG_BUSY) != 0U))
+    {
+        RedOsMutexWait();
+
+        /*  The handle may have been closed while the mutex was released.
+        */
+        ret = FildesToHandle(iFildes, expectedType, ppHandle);
+    }
+
+    return ret;
+}
+
+
+/** @brief Start reading or writing a file through a handle.
+
+    Marks the handle as busy, then waits for any conflicting read or write of
+    the file; see RedCoreFileIoEnter().  The current volume must be the
+    handle's volume.
+
+    @param pHandle  The handle, which must not be busy.
+    @param fWrite   Whether the file is to be written.
+*/
+static void HandleIoEnter(
+    REDHANDLE  *pHandle,
+    bool        fWrite)
+{
+    REDASSERT((pHandle->bFlags & HFLAG_BUSY) == 0U);
+
+    pHandle->bFlags |= HFLAG_BUSY;
+
+    RedCoreFileIoEnter(pHandle->ulInode, fWrite);
+}
+
+
+/** @brief Finish reading or writing a file through a handle.
+
+    @param pHandle  The handle given to HandleIoEnter().
+    @param fWrite   The @p fWrite value given to HandleIoEnter().
+*/
+static void HandleIoLeave(
+    REDHANDLE  *pHandle,
+    bool        fWrite)
+{
+    pHandle->bFlags &= (uint8_t)~HFLAG_BUSY;
+
+    /*  This also wakes any tasks waiting for the handle.
+    */
+    RedCoreFileIoLeave(pHandle->ulInode, fWrite);
+}
+#endif
+
+
 /** @brief Pack a file descriptor.
 
     @param uHandleIdx   The index of the file handle that will be associated
@@ -2879,6 +3203,36 @@ static void PosixLeave(void)
 }
 
 
+/** @brief Check whether a volume has open handles.
+
+    @param bVolNum  The volume number of the volume to check.
+
+    @return A negated ::REDSTATUS code indicating the operation result.
+
+    @retval 0           The volume has no open handles.
+    @retval -RED_EBUSY  The volume has open handles.
+*/
+static REDSTATUS VolHandlesCheck(
+    uint8_t     bVolNum)
+{
+    REDSTATUS   ret = 0;
+    uint16_t    uHandleIdx;
+
+    for(uHandleIdx = 0U; uHandleIdx < REDCONF_HANDLE_COUNT; uHandleIdx++)
+    {
+        const REDHANDLE *pHandle = &gaHandle[uHandleIdx];
+
+        if((pHandle->ulInode != INODE_INVALID) && (pHandle->bVolNum == bVolNum))
+        {
+            ret = -RED_EBUSY;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+
 /** @brief Check that a mode is consistent with the given expected type.
 
     @param uMode        An inode mode, indicating whether the inode is a file
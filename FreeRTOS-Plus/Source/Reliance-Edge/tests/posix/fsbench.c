@@ -0,0 +1,2182 @@
+/*             ----> DO NOT REMOVE THE FOLLOWING NOTICE <----
+
+                   Copyright (c) 2014-2015 Datalight, Inc.
+                       All Rights Reserved Worldwide.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; use version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but "AS-IS," WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+/*  Businesses and individuals that for commercial or other reasons cannot
+    comply with the terms of the GPLv2 license may obtain a commercial license
+    before incorporating Reliance Edge into proprietary software for
+    distribution in any form.  Visit http://www.datalight.com/reliance-edge for
+    more information.
+*/
+/** @file
+    @brief File system benchmark.
+
+    Times common workloads through the POSIX-like API, so that the effect of a
+    configuration change (such as the number of block buffers) can be measured
+    by running the same benchmark against builds which differ only in that
+    setting.  Each workload runs in a directory of its own, which is removed
+    afterwards.  The CRC workload instead times the checksum which protects
+    every metadata block, so that the REDCONF_CRC_ALGORITHM settings can be
+    compared.  The multitasking workload reads and writes files from several
+    tasks at once, so that the REDCONF_CONCURRENT_IO settings can be compared.
+    The random workload reads and writes a file at a range of I/O sizes, and
+    the latency workload times transaction points one at a time.
+
+    Results are printed as a table, or with --csv as comma-separated values, so
+    that a script can record them and compare them between builds.  Builds
+    with REDCONF_BUFFER_STATS enabled also report, for each phase, how often the
+    blocks it used were found in the block buffers.
+*/
+#include <redposix.h>
+#include <redtests.h>
+
+#if FSBENCH_SUPPORTED
+
+#include <redosserv.h>
+#include <redutils.h>
+#include <redmacs.h>
+#include <redvolume.h>
+#include <redgetopt.h>
+#include <redtoolcmn.h>
+#include <redcoreapi.h>
+
+
+/*  Name of the directory in which the workloads run, below the volume root.
+*/
+#define BENCH_DIR "fsbench"
+
+/*  Size of the path buffers.
+*/
+#define BENCH_PATH_MAX 256U
+
+/*  Largest I/O size for the sequential workload, and the size of the small
+    writes with which it appends to a file, and then reads the file back.
+*/
+#define BENCH_IO_MAX (16U * REDCONF_BLOCK_SIZE)
+#define BENCH_APPEND_SIZE 100U
+
+/*  Smallest I/O size for the random workload, which doubles the size up to
+    BENCH_IO_MAX.
+*/
+#define BENCH_RANDOM_MIN 512U
+
+/*  Number of transaction points timed by each phase of the latency workload.
+*/
+#define BENCH_LATENCY_COUNT 1000U
+
+/*  Whether the multitasking workload can be run: it needs at least two tasks
+    besides the one running the benchmark, and each task uses a task slot.
+*/
+#define BENCH_MULTI_SUPPORTED (REDCONF_TASK_COUNT > 2U)
+
+
+/*  State used to report the results of each phase.
+*/
+typedef struct
+{
+    bool        fCsv;           /* Whether to print comma-separated values. */
+    const char *pszWorkload;    /* Name of the workload being run. */
+  #if REDCONF_BUFFER_STATS == 1
+    uint32_t    ulHits;         /* Buffer hits when the phase started. */
+    uint32_t    ulMisses;       /* Buffer misses when the phase started. */
+  #endif
+} BENCHSTATE;
+
+
+#if BENCH_MULTI_SUPPORTED
+/*  State shared with the tasks of the multitasking workload.
+*/
+typedef struct
+{
+    const FSBENCHPARAM *pParam;                         /* fsbench parameters. */
+    uint32_t            ulReaders;                      /* Tasks below this index read; the rest write. */
+    int                 aiResult[REDCONF_TASK_COUNT];   /* Result of each task. */
+} BENCHMULTI;
+#endif
+
+
+static int BenchMetadata(const FSBENCHPARAM *pParam);
+static int BenchSequential(const FSBENCHPARAM *pParam);
+static int BenchLargeDir(const FSBENCHPARAM *pParam);
+static int BenchCrc(const FSBENCHPARAM *pParam);
+static int BenchRandom(const FSBENCHPARAM *pParam);
+static int BenchLatency(const FSBENCHPARAM *pParam);
+#if BENCH_MULTI_SUPPORTED
+static int BenchMulti(const FSBENCHPARAM *pParam);
+static void BenchMultiTask(uint32_t ulTaskIdx, void *pContext);
+#endif
+static int BenchFileIo(const FSBENCHPARAM *pParam, const char *pszPath, bool fWrite, uint32_t ulIoSize, uint8_t *pbBuffer, uint32_t *pulOps);
+static int BenchPath(char *pszPath, const FSBENCHPARAM *pParam, uint32_t ulDir, uint32_t ulFile);
+static void BenchClearWorkloads(FSBENCHPARAM *pParam);
+static void BenchBegin(const char *pszWorkload);
+static REDTIMESTAMP BenchPhaseStart(void);
+static void BenchReport(const char *pszPhase, uint32_t ulOps, uint64_t ullMicrosec);
+static void BenchReportThroughput(const char *pszPhase, uint32_t ulKB, uint64_t ullMicrosec);
+static void BenchReportLatency(const char *pszPhase, uint32_t *paulMicrosec, uint32_t ulCount, uint64_t ullMicrosec);
+static void BenchReportRow(const char *pszPhase, uint32_t ulCount, const char *pszUnit, uint64_t ullMicrosec, const uint32_t *paulPercentile);
+static int BenchError(const char *pszOp, const char *pszPath);
+static void BenchUsage(const char *pszProgName);
+
+
+static uint8_t gabBuffer[BENCH_IO_MAX];
+static uint32_t gaulLatency[BENCH_LATENCY_COUNT];
+static BENCHSTATE gBench;
+#if BENCH_MULTI_SUPPORTED
+static uint8_t gabReadBuffer[BENCH_IO_MAX];
+static BENCHMULTI gMulti;
+#endif
+
+
+/** @brief Parse parameters for fsbench.
+
+    @param argc         The number of arguments from main().
+    @param argv         The vector of arguments from main().
+    @param pParam       Populated with the fsbench parameters.
+    @param pbVolNum     If non-NULL, populated with the volume number.
+    @param ppszDevice   If non-NULL, populated with the device name argument or
+                        NULL if no device argument is provided.
+
+    @return The result of parsing the parameters.
+*/
+PARAMSTATUS FsbenchParseParams(
+    int             argc,
+    char           *argv[],
+    FSBENCHPARAM   *pParam,
+    uint8_t        *pbVolNum,
+    const char    **ppszDevice)
+{
+    int             c;
+    uint8_t         bVolNum;
+    bool            fTestSelected = false;
+    const REDOPTION aLongopts[] =
+    {
+        { "meta", red_no_argument, NULL, 'm' },
+        { "seq", red_no_argument, NULL, 'q' },
+        { "large-dir", red_no_argument, NULL, 'l' },
+        { "crc", red_no_argument, NULL, 'c' },
+        { "multi", red_no_argument, NULL, 'M' },
+        { "random", red_no_argument, NULL, 'r' },
+        { "latency", red_no_argument, NULL, 'L' },
+        { "dirs", red_required_argument, NULL, 'd' },
+        { "files", red_required_argument, NULL, 'f' },
+        { "entries", red_required_argument, NULL, 'e' },
+        { "size", red_required_argument, NULL, 'z' },
+        { "io", red_required_argument, NULL, 'i' },
+        { "tasks", red_required_argument, NULL, 'T' },
+        { "transact", red_no_argument, NULL, 't' },
+        { "seed", red_required_argument, NULL, 's' },
+        { "csv", red_no_argument, NULL, 'x' },
+        { "dev", red_required_argument, NULL, 'D' },
+        { "help", red_no_argument, NULL, 'H' },
+        { NULL }
+    };
+
+    /*  If run without parameters, treat as a help request.
+    */
+    if(argc <= 1)
+    {
+        goto Help;
+    }
+
+    /*  Assume no device argument to start with.
+    */
+    if(ppszDevice != NULL)
+    {
+        *ppszDevice = NULL;
+    }
+
+    /*  Set default parameters.
+    */
+    FsbenchDefaultParams(pParam);
+
+    while((c = RedGetoptLong(argc, argv, "mqlcMrLd:f:e:z:i:T:ts:xD:H", aLongopts, NULL)) != -1)
+    {
+        switch(c)
+        {
+            case 'm': /* --meta */
+                /*  Naming a workload runs only the named workloads, rather than
+                    all of them.
+                */
+                if(!fTestSelected)
+                {
+                    BenchClearWorkloads(pParam);
+                    fTestSelected = true;
+                }
+                pParam->fMetadata = true;
+                break;
+            case 'q': /* --seq */
+                if(!fTestSelected)
+                {
+                    BenchClearWorkloads(pParam);
+                    fTestSelected = true;
+                }
+                pParam->fSequential = true;
+                break;
+            case 'l': /* --large-dir */
+                if(!fTestSelected)
+                {
+                    BenchClearWorkloads(pParam);
+                    fTestSelected = true;
+                }
+                pParam->fLargeDir = true;
+                break;
+            case 'c': /* --crc */
+                if(!fTestSelected)
+                {
+                    BenchClearWorkloads(pParam);
+                    fTestSelected = true;
+                }
+                pParam->fCrc = true;
+                break;
+            case 'M': /* --multi */
+                if(!fTestSelected)
+                {
+                    BenchClearWorkloads(pParam);
+                    fTestSelected = true;
+                }
+                pParam->fMulti = true;
+                break;
+            case 'r': /* --random */
+                if(!fTestSelected)
+                {
+                    BenchClearWorkloads(pParam);
+                    fTestSelected = true;
+                }
+                pParam->fRandom = true;
+                break;
+            case 'L': /* --latency */
+                if(!fTestSelected)
+                {
+                    BenchClearWorkloads(pParam);
+                    fTestSelected = true;
+                }
+                pParam->fLatency = true;
+                break;
+            case 'd': /* --dirs */
+                pParam->ulDirs = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'f': /* --files */
+                pParam->ulFiles = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'e': /* --entries */
+                pParam->ulEntries = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'z': /* --size */
+                pParam->ulFileSizeKB = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'i': /* --io */
+                pParam->ulIoSize = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'T': /* --tasks */
+                pParam->ulTasks = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 't': /* --transact */
+                pParam->fAutoTransact = true;
+                break;
+            case 's': /* --seed */
+                pParam->ulSeed = (uint32_t)RedAtoI(red_optarg);
+                break;
+            case 'x': /* --csv */
+                pParam->fCsv = true;
+                break;
+            case 'D': /* --dev */
+                if(ppszDevice != NULL)
+                {
+                    *ppszDevice = red_optarg;
+                }
+                break;
+            case 'H': /* --help */
+                goto Help;
+            case '?': /* Unknown or ambiguous option */
+            case ':': /* Option missing required argument */
+            default:
+                goto BadOpt;
+        }
+    }
+
+    if((pParam->ulDirs == 0U) || (pParam->ulFiles == 0U) || (pParam->ulEntries == 0U))
+    {
+        RedPrintf("Error: the directory, file, and entry counts must not be zero.\n");
+        goto BadOpt;
+    }
+
+    if((pParam->ulFileSizeKB == 0U) || (pParam->ulFileSizeKB > (UINT32_MAX / 1024U)))
+    {
+        RedPrintf("Error: the file size must be between 1 and %lu KB.\n", (unsigned long)(UINT32_MAX / 1024U));
+        goto BadOpt;
+    }
+
+    if((pParam->ulIoSize == 0U) || (pParam->ulIoSize > BENCH_IO_MAX))
+    {
+        RedPrintf("Error: the I/O size must be between 1 and %lu bytes.\n", (unsigned long)BENCH_IO_MAX);
+        goto BadOpt;
+    }
+
+    if(pParam->fMulti && ((pParam->ulTasks < 2U) || (pParam->ulTasks >= REDCONF_TASK_COUNT)))
+    {
+      #if BENCH_MULTI_SUPPORTED
+        RedPrintf("Error: the task count must be between 2 and %lu.\n", (unsigned long)(REDCONF_TASK_COUNT - 1U));
+      #else
+        RedPrintf("Error: the multitasking workload needs REDCONF_TASK_COUNT to be at least 3.\n");
+      #endif
+        goto BadOpt;
+    }
+
+    /*  RedGetoptLong() has permuted argv to move all non-option arguments to
+        the end.  We expect to find a volume identifier.
+    */
+    if(red_optind >= argc)
+    {
+        RedPrintf("Missing volume argument\n");
+        goto BadOpt;
+    }
+
+    bVolNum = RedFindVolumeNumber(argv[red_optind]);
+    if(bVolNum == REDCONF_VOLUME_COUNT)
+    {
+        RedPrintf("Error: \"%s\" is not a valid volume identifier.\n", argv[red_optind]);
+        goto BadOpt;
+    }
+
+    pParam->pszVolume = gaRedVolConf[bVolNum].pszPathPrefix;
+
+    if(pbVolNum != NULL)
+    {
+        *pbVolNum = bVolNum;
+    }
+
+    red_optind++; /* Move past volume parameter. */
+    if(red_optind < argc)
+    {
+        int32_t ii;
+
+        for(ii = red_optind; ii < argc; ii++)
+        {
+            RedPrintf("Error: Unexpected command-line argument \"%s\".\n", argv[ii]);
+        }
+
+        goto BadOpt;
+    }
+
+    return PARAMSTATUS_OK;
+
+  BadOpt:
+
+    RedPrintf("%s - invalid parameters\n", argv[0U]);
+    BenchUsage(argv[0U]);
+    return PARAMSTATUS_BAD;
+
+  Help:
+
+    BenchUsage(argv[0U]);
+    return PARAMSTATUS_HELP;
+}
+
+
+/** @brief Set default fsbench parameters.
+
+    All workloads are selected (except the multitasking workload, if the
+    configuration does not allow enough tasks), and run on the first volume.
+
+    @param pParam   Populated with the default fsbench parameters.
+*/
+void FsbenchDefaultParams(
+    FSBENCHPARAM *pParam)
+{
+    RedMemSet(pParam, 0U, sizeof(*pParam));
+    pParam->pszVolume = gaRedVolConf[0U].pszPathPrefix;
+    pParam->fMetadata = true;
+    pParam->fSequential = true;
+    pParam->fLargeDir = true;
+    pParam->fCrc = true;
+    pParam->fMulti = BENCH_MULTI_SUPPORTED;
+    pParam->fRandom = true;
+    pParam->fLatency = true;
+    pParam->ulDirs = 4U;
+    pParam->ulFiles = 50U;
+    pParam->ulEntries = 1000U;
+    pParam->ulFileSizeKB = 1024U;
+    pParam->ulIoSize = BENCH_IO_MAX;
+    pParam->ulTasks = REDMIN(4U, REDCONF_TASK_COUNT - 1U);
+    pParam->ulSeed = 1U;
+}
+
+
+/** @brief Start fsbench.
+
+    The volume must be mounted, and should have been freshly formatted, so that
+    the results of different builds can be compared.
+
+    @param pParam   fsbench parameters, either from FsbenchParseParams() or
+                    constructed programatically.
+
+    @return Zero on success, otherwise nonzero.
+*/
+int FsbenchStart(
+    const FSBENCHPARAM *pParam)
+{
+    int         ret = 0;
+    uint32_t    ulOrigMask;
+
+    RedMemSet(&gBench, 0U, sizeof(gBench));
+    gBench.fCsv = pParam->fCsv;
+
+    if(red_gettransmask(pParam->pszVolume, &ulOrigMask) != 0)
+    {
+        ret = BenchError("red_gettransmask", pParam->pszVolume);
+    }
+    else
+    {
+        /*  With --csv, everything but the results is printed as a comment, and
+            the results follow a header line naming the columns.
+        */
+        RedPrintf("%sfsbench: %u byte blocks, %u block buffers, automatic transactions %s\n",
+            gBench.fCsv ? "# " : "", (unsigned)REDCONF_BLOCK_SIZE, (unsigned)REDCONF_BUFFER_COUNT,
+            pParam->fAutoTransact ? "on" : "off");
+
+        if(gBench.fCsv)
+        {
+            RedPrintf("workload,phase,count,unit,microsec,per_sec,p50_us,p90_us,p99_us,max_us,buffer_hits,buffer_misses\n");
+        }
+
+        /*  Unless asked otherwise, the workloads transact once at the end of
+            each phase, so that the results reflect the file system rather than
+            the speed with which the block device commits.
+        */
+        if(!pParam->fAutoTransact && (red_settransmask(pParam->pszVolume, RED_TRANSACT_MANUAL) != 0))
+        {
+            ret = BenchError("red_settransmask", pParam->pszVolume);
+        }
+
+        if((ret == 0) && pParam->fMetadata)
+        {
+            ret = BenchMetadata(pParam);
+        }
+
+        if((ret == 0) && pParam->fSequential)
+        {
+            ret = BenchSequential(pParam);
+        }
+
+        if((ret == 0) && pParam->fRandom)
+        {
+            ret = BenchRandom(pParam);
+        }
+
+        if((ret == 0) && pParam->fLargeDir)
+        {
+            ret = BenchLargeDir(pParam);
+        }
+
+        if((ret == 0) && pParam->fLatency)
+        {
+            ret = BenchLatency(pParam);
+        }
+
+        if((ret == 0) && pParam->fCrc)
+        {
+            ret = BenchCrc(pParam);
+        }
+
+      #if BENCH_MULTI_SUPPORTED
+        if((ret == 0) && pParam->fMulti)
+        {
+            ret = BenchMulti(pParam);
+        }
+      #endif
+
+        (void)red_settransmask(pParam->pszVolume, ulOrigMask);
+    }
+
+    return ret;
+}
+
+
+/** @brief Time a metadata-heavy workload.
+
+    Creates a number of directories containing a number of empty files each,
+    looks the files up in random order, reads the directories, and then deletes
+    everything.  Once the metadata no longer fits in the block buffers, the
+    times are dominated by the cost of finding and replacing buffers, which
+    makes this workload sensitive to the buffer count.
+
+    @param pParam   fsbench parameters.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchMetadata(
+    const FSBENCHPARAM *pParam)
+{
+    int                 ret;
+    char                szPath[BENCH_PATH_MAX];
+    uint32_t            ulTotal = pParam->ulDirs * pParam->ulFiles;
+    uint32_t            ulSeed = pParam->ulSeed;
+    uint32_t            ulDir;
+    uint32_t            ulFile;
+    uint32_t            ulOp;
+    REDTIMESTAMP        ts;
+    REDSTATFS           sfs;
+
+    BenchBegin("metadata");
+    RedPrintf("metadata: %lu directories of %lu files\n", (unsigned long)pParam->ulDirs, (unsigned long)pParam->ulFiles);
+
+    if(red_statvfs(pParam->pszVolume, &sfs) != 0)
+    {
+        ret = BenchError("red_statvfs", pParam->pszVolume);
+    }
+    else if((sfs.f_ffree <= pParam->ulDirs) || ((sfs.f_ffree - pParam->ulDirs) <= ulTotal))
+    {
+        /*  One inode for each file and directory, plus the directory which
+            contains them.
+        */
+        RedPrintf("fsbench: the volume has only %lu free inodes\n", (unsigned long)sfs.f_ffree);
+        ret = 1;
+    }
+    else
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    ts = BenchPhaseStart();
+    for(ulDir = 0U; (ret == 0) && (ulDir < pParam->ulDirs); ulDir++)
+    {
+        ret = BenchPath(szPath, pParam, ulDir, UINT32_MAX);
+        if((ret == 0) && (red_mkdir(szPath) != 0))
+        {
+            ret = BenchError("red_mkdir", szPath);
+        }
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("mkdir", pParam->ulDirs, RedOsTimePassed(ts));
+    }
+
+    ts = BenchPhaseStart();
+    for(ulDir = 0U; (ret == 0) && (ulDir < pParam->ulDirs); ulDir++)
+    {
+        for(ulFile = 0U; (ret == 0) && (ulFile < pParam->ulFiles); ulFile++)
+        {
+            int32_t iFildes;
+
+            ret = BenchPath(szPath, pParam, ulDir, ulFile);
+            if(ret == 0)
+            {
+                iFildes = red_open(szPath, RED_O_WRONLY | RED_O_CREAT | RED_O_EXCL);
+                if(iFildes < 0)
+                {
+                    ret = BenchError("red_open", szPath);
+                }
+                else if(red_close(iFildes) != 0)
+                {
+                    ret = BenchError("red_close", szPath);
+                }
+                else
+                {
+                    /*  File created.
+                    */
+                }
+            }
+        }
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("create", ulTotal, RedOsTimePassed(ts));
+    }
+
+    /*  Look the files up in random order, so that the accesses are spread over
+        all of the inodes and directory blocks.
+    */
+    ts = BenchPhaseStart();
+    for(ulOp = 0U; (ret == 0) && (ulOp < ulTotal); ulOp++)
+    {
+        uint32_t    ulRand = RedRand32(&ulSeed);
+        int32_t     iFildes;
+        REDSTAT     st;
+
+        ret = BenchPath(szPath, pParam, ulRand % pParam->ulDirs, (ulRand / pParam->ulDirs) % pParam->ulFiles);
+        if(ret == 0)
+        {
+            iFildes = red_open(szPath, RED_O_RDONLY);
+            if(iFildes < 0)
+            {
+                ret = BenchError("red_open", szPath);
+            }
+            else
+            {
+                if(red_fstat(iFildes, &st) != 0)
+                {
+                    ret = BenchError("red_fstat", szPath);
+                }
+
+                if(red_close(iFildes) != 0)
+                {
+                    ret = BenchError("red_close", szPath);
+                }
+            }
+        }
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("lookup", ulTotal, RedOsTimePassed(ts));
+    }
+
+    ts = BenchPhaseStart();
+    for(ulDir = 0U; (ret == 0) && (ulDir < pParam->ulDirs); ulDir++)
+    {
+        ret = BenchPath(szPath, pParam, ulDir, UINT32_MAX);
+        if(ret == 0)
+        {
+            REDDIR *pDir = red_opendir(szPath);
+
+            if(pDir == NULL)
+            {
+                ret = BenchError("red_opendir", szPath);
+            }
+            else
+            {
+                ulFile = 0U;
+                red_errno = 0;
+                while(red_readdir(pDir) != NULL)
+                {
+                    ulFile++;
+                }
+
+                if(red_errno != 0)
+                {
+                    ret = BenchError("red_readdir", szPath);
+                }
+                else if(ulFile != pParam->ulFiles)
+                {
+                    RedPrintf("fsbench: found %lu files in %s, expected %lu\n", (unsigned long)ulFile, szPath, (unsigned long)pParam->ulFiles);
+                    ret = 1;
+                }
+                else
+                {
+                    /*  All of the files were found.
+                    */
+                }
+
+                (void)red_closedir(pDir);
+            }
+        }
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("readdir", ulTotal, RedOsTimePassed(ts));
+    }
+
+    ts = BenchPhaseStart();
+    for(ulDir = 0U; (ret == 0) && (ulDir < pParam->ulDirs); ulDir++)
+    {
+        for(ulFile = 0U; (ret == 0) && (ulFile < pParam->ulFiles); ulFile++)
+        {
+            ret = BenchPath(szPath, pParam, ulDir, ulFile);
+            if((ret == 0) && (red_unlink(szPath) != 0))
+            {
+                ret = BenchError("red_unlink", szPath);
+            }
+        }
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("unlink", ulTotal, RedOsTimePassed(ts));
+    }
+
+    ts = BenchPhaseStart();
+    for(ulDir = 0U; (ret == 0) && (ulDir < pParam->ulDirs); ulDir++)
+    {
+        ret = BenchPath(szPath, pParam, ulDir, UINT32_MAX);
+        if((ret == 0) && (red_rmdir(szPath) != 0))
+        {
+            ret = BenchError("red_rmdir", szPath);
+        }
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("rmdir", pParam->ulDirs, RedOsTimePassed(ts));
+
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+        if((ret == 0) && (red_rmdir(szPath) != 0))
+        {
+            ret = BenchError("red_rmdir", szPath);
+        }
+    }
+
+    return ret;
+}
+
+
+/** @brief Time a sequential file I/O workload.
+
+    Writes a file with large writes, reads it back with large reads, and then
+    writes a second file of the same size by appending small amounts at a time,
+    and reads it back the same way, like a log being replayed.  The large
+    transfers measure how well multiple blocks are read and written with single
+    requests; the small appends leave runs of dirty buffers for consecutive
+    blocks, which measures how well those are written back; and the small reads
+    measure how well the file data is read ahead.
+
+    @param pParam   fsbench parameters.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchSequential(
+    const FSBENCHPARAM *pParam)
+{
+    int                 ret;
+    char                szPath[BENCH_PATH_MAX];
+    uint32_t            ulOps;
+    uint32_t            ulIdx;
+    REDTIMESTAMP        ts;
+    REDSTATFS           sfs;
+
+    BenchBegin("sequential");
+    RedPrintf("sequential: %lu KB files, %lu byte I/O\n", (unsigned long)pParam->ulFileSizeKB, (unsigned long)pParam->ulIoSize);
+
+    /*  Fill the buffer with something other than zeroes, in case the block
+        device treats those differently.
+    */
+    for(ulIdx = 0U; ulIdx < BENCH_IO_MAX; ulIdx++)
+    {
+        gabBuffer[ulIdx] = (uint8_t)(ulIdx % 251U);
+    }
+
+    if(red_statvfs(pParam->pszVolume, &sfs) != 0)
+    {
+        ret = BenchError("red_statvfs", pParam->pszVolume);
+    }
+    else if(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U <= (2U * (uint64_t)pParam->ulFileSizeKB))
+    {
+        /*  Both files exist at the same time, and need room for their
+            metadata as well as their data.
+        */
+        RedPrintf("fsbench: the volume has only %lu KB free\n",
+            (unsigned long)(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U));
+        ret = 1;
+    }
+    else
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, 0U);
+    }
+
+    ts = BenchPhaseStart();
+    if(ret == 0)
+    {
+        ret = BenchFileIo(pParam, szPath, true, pParam->ulIoSize, gabBuffer, &ulOps);
+    }
+
+    if(ret == 0)
+    {
+        BenchReportThroughput("write", pParam->ulFileSizeKB, RedOsTimePassed(ts));
+    }
+
+    ts = BenchPhaseStart();
+    if(ret == 0)
+    {
+        ret = BenchFileIo(pParam, szPath, false, pParam->ulIoSize, gabBuffer, &ulOps);
+    }
+
+    if(ret == 0)
+    {
+        BenchReportThroughput("read", pParam->ulFileSizeKB, RedOsTimePassed(ts));
+
+        ret = BenchPath(szPath, pParam, 0U, 1U);
+    }
+
+    ts = BenchPhaseStart();
+    if(ret == 0)
+    {
+        ret = BenchFileIo(pParam, szPath, true, BENCH_APPEND_SIZE, gabBuffer, &ulOps);
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("append", ulOps, RedOsTimePassed(ts));
+    }
+
+    ts = BenchPhaseStart();
+    if(ret == 0)
+    {
+        ret = BenchFileIo(pParam, szPath, false, BENCH_APPEND_SIZE, gabBuffer, &ulOps);
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("replay", ulOps, RedOsTimePassed(ts));
+    }
+
+    for(ulIdx = 0U; (ret == 0) && (ulIdx < 2U); ulIdx++)
+    {
+        ret = BenchPath(szPath, pParam, 0U, ulIdx);
+        if((ret == 0) && (red_unlink(szPath) != 0))
+        {
+            ret = BenchError("red_unlink", szPath);
+        }
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    return ret;
+}
+
+
+/** @brief Time a workload on one large directory.
+
+    Creates a number of empty files in a single directory, reporting the rate
+    for each quarter of the files, so that it shows how the cost of adding a
+    name grows with the size of the directory.  Then looks up every file in
+    random order, looks up as many names which do not exist, and deletes the
+    files.  Every create must first make sure that the name does not already
+    exist, so without some way of ruling names out, each create and each
+    failed lookup reads the whole directory.
+
+    @param pParam   fsbench parameters.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchLargeDir(
+    const FSBENCHPARAM *pParam)
+{
+    int                 ret;
+    char                szPath[BENCH_PATH_MAX];
+    uint32_t            ulSeed = pParam->ulSeed;
+    uint32_t            ulFile = 0U;
+    uint32_t            ulQuarter;
+    uint32_t            ulOp;
+    REDTIMESTAMP        ts;
+    REDSTATFS           sfs;
+
+    BenchBegin("large-dir");
+    RedPrintf("large directory: %lu files\n", (unsigned long)pParam->ulEntries);
+
+    if(red_statvfs(pParam->pszVolume, &sfs) != 0)
+    {
+        ret = BenchError("red_statvfs", pParam->pszVolume);
+    }
+    else if((sfs.f_ffree <= 2U) || ((sfs.f_ffree - 2U) < pParam->ulEntries))
+    {
+        /*  One inode for each file, plus two directories.
+        */
+        RedPrintf("fsbench: the volume has only %lu free inodes\n", (unsigned long)sfs.f_ffree);
+        ret = 1;
+    }
+    else
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    for(ulQuarter = 1U; (ret == 0) && (ulQuarter <= 4U); ulQuarter++)
+    {
+        uint32_t    ulStart = ulFile;
+        uint32_t    ulEnd = (uint32_t)(((uint64_t)pParam->ulEntries * ulQuarter) / 4U);
+        char        szPhase[16U];
+
+        ts = BenchPhaseStart();
+        for(; (ret == 0) && (ulFile < ulEnd); ulFile++)
+        {
+            int32_t iFildes;
+
+            ret = BenchPath(szPath, pParam, 0U, ulFile);
+            if(ret == 0)
+            {
+                iFildes = red_open(szPath, RED_O_WRONLY | RED_O_CREAT | RED_O_EXCL);
+                if(iFildes < 0)
+                {
+                    ret = BenchError("red_open", szPath);
+                }
+                else if(red_close(iFildes) != 0)
+                {
+                    ret = BenchError("red_close", szPath);
+                }
+                else
+                {
+                    /*  File created.
+                    */
+                }
+            }
+        }
+
+        if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+        {
+            ret = BenchError("red_transact", pParam->pszVolume);
+        }
+
+        if((ret == 0) && (ulFile > ulStart))
+        {
+            (void)RedSNPrintf(szPhase, sizeof(szPhase), "create%lu/4", (unsigned long)ulQuarter);
+            BenchReport(szPhase, ulFile - ulStart, RedOsTimePassed(ts));
+        }
+    }
+
+    ts = BenchPhaseStart();
+    for(ulOp = 0U; (ret == 0) && (ulOp < pParam->ulEntries); ulOp++)
+    {
+        int32_t iFildes;
+
+        ret = BenchPath(szPath, pParam, 0U, RedRand32(&ulSeed) % pParam->ulEntries);
+        if(ret == 0)
+        {
+            iFildes = red_open(szPath, RED_O_RDONLY);
+            if(iFildes < 0)
+            {
+                ret = BenchError("red_open", szPath);
+            }
+            else if(red_close(iFildes) != 0)
+            {
+                ret = BenchError("red_close", szPath);
+            }
+            else
+            {
+                /*  File found.
+                */
+            }
+        }
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("lookup", pParam->ulEntries, RedOsTimePassed(ts));
+    }
+
+    /*  Look up names numbered past the last file, none of which exist.
+    */
+    ts = BenchPhaseStart();
+    for(ulOp = 0U; (ret == 0) && (ulOp < pParam->ulEntries); ulOp++)
+    {
+        int32_t iFildes;
+
+        ret = BenchPath(szPath, pParam, 0U, pParam->ulEntries + ulOp);
+        if(ret == 0)
+        {
+            iFildes = red_open(szPath, RED_O_RDONLY);
+            if(iFildes >= 0)
+            {
+                RedPrintf("fsbench: %s should not exist\n", szPath);
+                (void)red_close(iFildes);
+                ret = 1;
+            }
+            else if(red_errno != RED_ENOENT)
+            {
+                ret = BenchError("red_open", szPath);
+            }
+            else
+            {
+                /*  File not found, as expected.
+                */
+            }
+        }
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("miss", pParam->ulEntries, RedOsTimePassed(ts));
+    }
+
+    ts = BenchPhaseStart();
+    for(ulFile = 0U; (ret == 0) && (ulFile < pParam->ulEntries); ulFile++)
+    {
+        ret = BenchPath(szPath, pParam, 0U, ulFile);
+        if((ret == 0) && (red_unlink(szPath) != 0))
+        {
+            ret = BenchError("red_unlink", szPath);
+        }
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    if(ret == 0)
+    {
+        BenchReport("unlink", pParam->ulEntries, RedOsTimePassed(ts));
+
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    return ret;
+}
+
+
+/** @brief Time the CRC which protects metadata blocks.
+
+    Computes the CRC over the size of the sequential workload's file, a buffer
+    at a time, for each power-of-two buffer size from 128 bytes up to the
+    largest I/O size.  Metadata blocks are checksummed whole, so the result for
+    the block size is the one which matters most; the smaller sizes show the
+    overhead of each call.  The volume is not used.
+
+    @param pParam   fsbench parameters.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchCrc(
+    const FSBENCHPARAM *pParam)
+{
+    uint32_t            ulSize;
+    uint32_t            ulIdx;
+    uint32_t            ulCrc = 0U;
+
+    BenchBegin("crc");
+    RedPrintf("crc: %lu KB per buffer size\n", (unsigned long)pParam->ulFileSizeKB);
+
+    for(ulIdx = 0U; ulIdx < BENCH_IO_MAX; ulIdx++)
+    {
+        gabBuffer[ulIdx] = (uint8_t)(ulIdx % 251U);
+    }
+
+    for(ulSize = 128U; ulSize <= BENCH_IO_MAX; ulSize *= 2U)
+    {
+        uint64_t        ullBytes = (uint64_t)pParam->ulFileSizeKB * 1024U;
+        uint64_t        ullDone = 0U;
+        char            szPhase[16U];
+        REDTIMESTAMP    ts;
+
+        ts = BenchPhaseStart();
+
+        while(ullDone < ullBytes)
+        {
+            ulCrc = RedCrc32Update(ulCrc, gabBuffer, ulSize);
+            ullDone += ulSize;
+        }
+
+        RedSNPrintf(szPhase, sizeof(szPhase), "%lu B", (unsigned long)ulSize);
+        BenchReportThroughput(szPhase, pParam->ulFileSizeKB, RedOsTimePassed(ts));
+    }
+
+    /*  Print the result, so that the compiler cannot discard the CRCs.
+    */
+    RedPrintf("%scrc        %08lx\n", gBench.fCsv ? "# " : "  ", (unsigned long)ulCrc);
+
+    return 0;
+}
+
+
+/** @brief Time reads and writes of a file at a range of I/O sizes.
+
+    Writes a file, which is not timed, and then, for each power-of-two I/O size
+    from ::BENCH_RANDOM_MIN bytes up to the largest I/O size, reads the whole
+    file sequentially, reads as much at random offsets, overwrites the whole
+    file sequentially, and overwrites as much at random offsets.  The offsets
+    are multiples of the I/O size.  Comparing the sizes shows the overhead of
+    each call and of partial block writes; comparing the random phases with the
+    sequential ones shows how much is gained from read ahead and write
+    gathering, and what each random overwrite costs in copied-on-write
+    metadata.
+
+    @param pParam   fsbench parameters.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchRandom(
+    const FSBENCHPARAM *pParam)
+{
+    static const char * const apszPhase[] = { "seqrd", "rndrd", "seqwr", "rndwr" };
+    int                 ret;
+    char                szPath[BENCH_PATH_MAX];
+    uint32_t            ulSeed = pParam->ulSeed;
+    uint32_t            ulOps;
+    uint32_t            ulIdx;
+    uint32_t            ulSize;
+    int32_t             iFildes = -1;
+    REDTIMESTAMP        ts;
+    REDSTATFS           sfs;
+
+    BenchBegin("random");
+    RedPrintf("random: %lu KB file, %lu to %lu byte I/O\n", (unsigned long)pParam->ulFileSizeKB,
+        (unsigned long)BENCH_RANDOM_MIN, (unsigned long)BENCH_IO_MAX);
+
+    for(ulIdx = 0U; ulIdx < BENCH_IO_MAX; ulIdx++)
+    {
+        gabBuffer[ulIdx] = (uint8_t)(ulIdx % 251U);
+    }
+
+    if(red_statvfs(pParam->pszVolume, &sfs) != 0)
+    {
+        ret = BenchError("red_statvfs", pParam->pszVolume);
+    }
+    else if(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U <= (2U * (uint64_t)pParam->ulFileSizeKB))
+    {
+        /*  Until the volume is transacted, every block which is overwritten
+            is written somewhere else, so the file may need twice its size.
+        */
+        RedPrintf("fsbench: the volume has only %lu KB free\n",
+            (unsigned long)(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U));
+        ret = 1;
+    }
+    else
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, 0U);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchFileIo(pParam, szPath, true, BENCH_IO_MAX, gabBuffer, &ulOps);
+    }
+
+    if(ret == 0)
+    {
+        iFildes = red_open(szPath, RED_O_RDWR);
+        if(iFildes < 0)
+        {
+            ret = BenchError("red_open", szPath);
+        }
+    }
+
+    for(ulSize = BENCH_RANDOM_MIN; (ret == 0) && (ulSize <= BENCH_IO_MAX); ulSize *= 2U)
+    {
+        uint32_t    ulCount = (uint32_t)(((uint64_t)pParam->ulFileSizeKB * 1024U) / ulSize);
+        uint32_t    ulPhase;
+
+        /*  Larger I/O sizes would not fit in the file.
+        */
+        if(ulCount == 0U)
+        {
+            break;
+        }
+
+        for(ulPhase = 0U; (ret == 0) && (ulPhase < 4U); ulPhase++)
+        {
+            bool        fWrite = (ulPhase >= 2U);
+            bool        fRandom = ((ulPhase & 1U) != 0U);
+            char        szPhase[16U];
+            uint32_t    ulOp;
+
+            ts = BenchPhaseStart();
+            for(ulOp = 0U; (ret == 0) && (ulOp < ulCount); ulOp++)
+            {
+                uint32_t    ulSlot = fRandom ? (RedRand32(&ulSeed) % ulCount) : ulOp;
+                int32_t     iLen;
+
+                if(red_lseek(iFildes, (int64_t)ulSlot * ulSize, RED_SEEK_SET) < 0)
+                {
+                    ret = BenchError("red_lseek", szPath);
+                }
+                else
+                {
+                    if(fWrite)
+                    {
+                        iLen = red_write(iFildes, gabBuffer, ulSize);
+                    }
+                    else
+                    {
+                        iLen = red_read(iFildes, gabBuffer, ulSize);
+                    }
+
+                    if(iLen != (int32_t)ulSize)
+                    {
+                        ret = BenchError(fWrite ? "red_write" : "red_read", szPath);
+                    }
+                }
+            }
+
+            if((ret == 0) && fWrite && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+            {
+                ret = BenchError("red_transact", pParam->pszVolume);
+            }
+
+            if(ret == 0)
+            {
+                (void)RedSNPrintf(szPhase, sizeof(szPhase), "%s %lu", apszPhase[ulPhase], (unsigned long)ulSize);
+                BenchReportThroughput(szPhase, (uint32_t)(((uint64_t)ulCount * ulSize) / 1024U), RedOsTimePassed(ts));
+            }
+        }
+    }
+
+    if((iFildes >= 0) && (red_close(iFildes) != 0) && (ret == 0))
+    {
+        ret = BenchError("red_close", szPath);
+    }
+
+    if((ret == 0) && (red_unlink(szPath) != 0))
+    {
+        ret = BenchError("red_unlink", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    return ret;
+}
+
+
+/** @brief Time transaction points one at a time.
+
+    Makes ::BENCH_LATENCY_COUNT small changes of each of two kinds, timing only
+    the transaction point which follows each change, and reports how long the
+    transaction points took at the 50th, 90th, and 99th percentiles, and at
+    most.  The "data" phase overwrites a few bytes of a file at a random
+    offset, which rewrites a data block and the metadata above it; the "meta"
+    phase alternately creates and deletes an empty file, which rewrites the
+    directory, an inode, and the allocation metadata.  The time includes
+    flushing the block device, so on a slow device this workload measures the
+    device more than the file system.  With --transact, the changes may have
+    been transacted already, so the times are only meaningful without it.
+
+    @param pParam   fsbench parameters.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchLatency(
+    const FSBENCHPARAM *pParam)
+{
+    int                 ret;
+    char                szPath[BENCH_PATH_MAX];
+    char                szFile[BENCH_PATH_MAX];
+    uint32_t            ulSeed = pParam->ulSeed;
+    uint32_t            ulOps;
+    uint32_t            ulIdx;
+    uint32_t            ulPhase;
+    int32_t             iFildes = -1;
+    REDSTATFS           sfs;
+
+    BenchBegin("latency");
+    RedPrintf("latency: %lu transaction points per phase\n", (unsigned long)BENCH_LATENCY_COUNT);
+
+    for(ulIdx = 0U; ulIdx < BENCH_IO_MAX; ulIdx++)
+    {
+        gabBuffer[ulIdx] = (uint8_t)(ulIdx % 251U);
+    }
+
+    if(red_statvfs(pParam->pszVolume, &sfs) != 0)
+    {
+        ret = BenchError("red_statvfs", pParam->pszVolume);
+    }
+    else if(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U <= (2U * (uint64_t)pParam->ulFileSizeKB))
+    {
+        RedPrintf("fsbench: the volume has only %lu KB free\n",
+            (unsigned long)(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U));
+        ret = 1;
+    }
+    else
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szFile, pParam, 0U, 1U);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, 0U);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchFileIo(pParam, szPath, true, BENCH_IO_MAX, gabBuffer, &ulOps);
+    }
+
+    if(ret == 0)
+    {
+        iFildes = red_open(szPath, RED_O_WRONLY);
+        if(iFildes < 0)
+        {
+            ret = BenchError("red_open", szPath);
+        }
+    }
+
+    for(ulPhase = 0U; (ret == 0) && (ulPhase < 2U); ulPhase++)
+    {
+        uint64_t ullMicrosec = 0U;
+
+        (void)BenchPhaseStart();
+
+        for(ulIdx = 0U; (ret == 0) && (ulIdx < BENCH_LATENCY_COUNT); ulIdx++)
+        {
+            REDTIMESTAMP ts;
+
+            if(ulPhase == 0U)
+            {
+                uint64_t ullOffset = RedRand32(&ulSeed) % (((uint64_t)pParam->ulFileSizeKB * 1024U) - BENCH_APPEND_SIZE);
+
+                if(red_lseek(iFildes, (int64_t)ullOffset, RED_SEEK_SET) < 0)
+                {
+                    ret = BenchError("red_lseek", szPath);
+                }
+                else if(red_write(iFildes, gabBuffer, BENCH_APPEND_SIZE) != (int32_t)BENCH_APPEND_SIZE)
+                {
+                    ret = BenchError("red_write", szPath);
+                }
+                else
+                {
+                    /*  File changed.
+                    */
+                }
+            }
+            else if((ulIdx & 1U) == 0U)
+            {
+                int32_t iNewFildes = red_open(szFile, RED_O_WRONLY | RED_O_CREAT | RED_O_EXCL);
+
+                if(iNewFildes < 0)
+                {
+                    ret = BenchError("red_open", szFile);
+                }
+                else if(red_close(iNewFildes) != 0)
+                {
+                    ret = BenchError("red_close", szFile);
+                }
+                else
+                {
+                    /*  File created.
+                    */
+                }
+            }
+            else if(red_unlink(szFile) != 0)
+            {
+                ret = BenchError("red_unlink", szFile);
+            }
+            else
+            {
+                /*  File deleted.
+                */
+            }
+
+            ts = RedOsTimestamp();
+            if((ret == 0) && (red_transact(pParam->pszVolume) != 0))
+            {
+                ret = BenchError("red_transact", pParam->pszVolume);
+            }
+
+            if(ret == 0)
+            {
+                uint64_t ullElapsed = RedOsTimePassed(ts);
+
+                gaulLatency[ulIdx] = (uint32_t)REDMIN(ullElapsed, UINT32_MAX);
+                ullMicrosec += ullElapsed;
+            }
+        }
+
+        if(ret == 0)
+        {
+            BenchReportLatency((ulPhase == 0U) ? "data" : "meta", gaulLatency, BENCH_LATENCY_COUNT, ullMicrosec);
+        }
+    }
+
+    if((iFildes >= 0) && (red_close(iFildes) != 0) && (ret == 0))
+    {
+        ret = BenchError("red_close", szPath);
+    }
+
+    if((ret == 0) && (red_unlink(szPath) != 0))
+    {
+        ret = BenchError("red_unlink", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    return ret;
+}
+
+
+#if BENCH_MULTI_SUPPORTED
+/** @brief Time a workload of several tasks reading and writing at once.
+
+    The first half of the tasks each read a file, which is written beforehand,
+    while the other half each write a new file, all in the same directory.  The
+    throughput is that of all the tasks together.  With REDCONF_CONCURRENT_IO
+    disabled, each read and write call waits for the calls of the other tasks
+    to finish, so the throughput is about the same as with one task.
+
+    @param pParam   fsbench parameters.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchMulti(
+    const FSBENCHPARAM *pParam)
+{
+    int                 ret;
+    char                szPath[BENCH_PATH_MAX];
+    uint32_t            ulOps;
+    uint32_t            ulIdx;
+    REDTIMESTAMP        ts;
+    REDSTATFS           sfs;
+
+    BenchBegin("multi");
+    RedPrintf("multi: %lu tasks, %lu KB files, %lu byte I/O\n", (unsigned long)pParam->ulTasks,
+        (unsigned long)pParam->ulFileSizeKB, (unsigned long)pParam->ulIoSize);
+
+    RedMemSet(&gMulti, 0U, sizeof(gMulti));
+    gMulti.pParam = pParam;
+    gMulti.ulReaders = pParam->ulTasks / 2U;
+
+    for(ulIdx = 0U; ulIdx < BENCH_IO_MAX; ulIdx++)
+    {
+        gabBuffer[ulIdx] = (uint8_t)(ulIdx % 251U);
+    }
+
+    if(red_statvfs(pParam->pszVolume, &sfs) != 0)
+    {
+        ret = BenchError("red_statvfs", pParam->pszVolume);
+    }
+    else if(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U <= ((uint64_t)pParam->ulTasks * pParam->ulFileSizeKB))
+    {
+        RedPrintf("fsbench: the volume has only %lu KB free\n",
+            (unsigned long)(((uint64_t)sfs.f_bfree * sfs.f_frsize) / 1024U));
+        ret = 1;
+    }
+    else
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_mkdir(szPath) != 0))
+    {
+        ret = BenchError("red_mkdir", szPath);
+    }
+
+    /*  Write the files to be read, which is not timed.
+    */
+    for(ulIdx = 0U; (ret == 0) && (ulIdx < gMulti.ulReaders); ulIdx++)
+    {
+        ret = BenchPath(szPath, pParam, 0U, ulIdx);
+        if(ret == 0)
+        {
+            ret = BenchFileIo(pParam, szPath, true, pParam->ulIoSize, gabBuffer, &ulOps);
+        }
+    }
+
+    if(ret == 0)
+    {
+        REDSTATUS taskRet;
+
+        ts = BenchPhaseStart();
+
+        taskRet = RedOsTaskRun(pParam->ulTasks, BenchMultiTask, &gMulti);
+        if(taskRet != 0)
+        {
+            RedPrintf("fsbench: RedOsTaskRun() failed with error %d\n", (int)taskRet);
+            ret = 1;
+        }
+        else
+        {
+            uint64_t ullMicrosec = RedOsTimePassed(ts);
+
+            for(ulIdx = 0U; (ret == 0) && (ulIdx < pParam->ulTasks); ulIdx++)
+            {
+                ret = gMulti.aiResult[ulIdx];
+            }
+
+            if(ret == 0)
+            {
+                uint32_t ulWriters = pParam->ulTasks - gMulti.ulReaders;
+
+                BenchReportThroughput("read", gMulti.ulReaders * pParam->ulFileSizeKB, ullMicrosec);
+                BenchReportThroughput("write", ulWriters * pParam->ulFileSizeKB, ullMicrosec);
+                BenchReportThroughput("total", pParam->ulTasks * pParam->ulFileSizeKB, ullMicrosec);
+            }
+        }
+    }
+
+    for(ulIdx = 0U; (ret == 0) && (ulIdx < pParam->ulTasks); ulIdx++)
+    {
+        ret = BenchPath(szPath, pParam, 0U, ulIdx);
+        if((ret == 0) && (red_unlink(szPath) != 0))
+        {
+            ret = BenchError("red_unlink", szPath);
+        }
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, 0U, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if(ret == 0)
+    {
+        ret = BenchPath(szPath, pParam, UINT32_MAX, UINT32_MAX);
+    }
+
+    if((ret == 0) && (red_rmdir(szPath) != 0))
+    {
+        ret = BenchError("red_rmdir", szPath);
+    }
+
+    if((ret == 0) && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    return ret;
+}
+
+
+/** @brief Entry point of each task of the multitasking workload.
+
+    @param ulTaskIdx    The index of the task.
+    @param pContext     The ::BENCHMULTI state of the workload.
+*/
+static void BenchMultiTask(
+    uint32_t            ulTaskIdx,
+    void               *pContext)
+{
+    BENCHMULTI         *pMulti = pContext;
+    char                szPath[BENCH_PATH_MAX];
+    uint32_t            ulOps;
+    int                 ret;
+
+    ret = BenchPath(szPath, pMulti->pParam, 0U, ulTaskIdx);
+    if(ret == 0)
+    {
+        if(ulTaskIdx < pMulti->ulReaders)
+        {
+            /*  The data read is not checked, so the readers share a buffer.
+            */
+            ret = BenchFileIo(pMulti->pParam, szPath, false, pMulti->pParam->ulIoSize, gabReadBuffer, &ulOps);
+        }
+        else
+        {
+            ret = BenchFileIo(pMulti->pParam, szPath, true, pMulti->pParam->ulIoSize, gabBuffer, &ulOps);
+        }
+    }
+
+    pMulti->aiResult[ulTaskIdx] = ret;
+}
+#endif /* BENCH_MULTI_SUPPORTED */
+
+
+/** @brief Write or read a whole benchmark file sequentially.
+
+    When writing, the file is created, and the volume is transacted once the
+    file is closed, so that the time includes writing back the buffers.
+
+    @param pParam   fsbench parameters.
+    @param pszPath  The path of the file.
+    @param fWrite   Whether to write the file, rather than read it.
+    @param ulIoSize The number of bytes to transfer with each call.
+    @param pbBuffer The buffer to write from or read into; at least @p ulIoSize
+                    bytes.
+    @param pulOps   Populated with the number of read or write calls.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchFileIo(
+    const FSBENCHPARAM *pParam,
+    const char         *pszPath,
+    bool                fWrite,
+    uint32_t            ulIoSize,
+    uint8_t            *pbBuffer,
+    uint32_t           *pulOps)
+{
+    int                 ret = 0;
+    uint32_t            ulRemaining = pParam->ulFileSizeKB * 1024U;
+    int32_t             iFildes;
+
+    *pulOps = 0U;
+
+    iFildes = red_open(pszPath, fWrite ? (RED_O_WRONLY | RED_O_CREAT | RED_O_EXCL) : RED_O_RDONLY);
+    if(iFildes < 0)
+    {
+        ret = BenchError("red_open", pszPath);
+    }
+    else
+    {
+        while((ret == 0) && (ulRemaining > 0U))
+        {
+            uint32_t    ulLen = REDMIN(ulRemaining, ulIoSize);
+            int32_t     iLen;
+
+            if(fWrite)
+            {
+                iLen = red_write(iFildes, pbBuffer, ulLen);
+            }
+            else
+            {
+                iLen = red_read(iFildes, pbBuffer, ulLen);
+            }
+
+            if(iLen != (int32_t)ulLen)
+            {
+                ret = BenchError(fWrite ? "red_write" : "red_read", pszPath);
+            }
+            else
+            {
+                ulRemaining -= ulLen;
+                (*pulOps)++;
+            }
+        }
+
+        if(red_close(iFildes) != 0)
+        {
+            ret = BenchError("red_close", pszPath);
+        }
+    }
+
+    if((ret == 0) && fWrite && !pParam->fAutoTransact && (red_transact(pParam->pszVolume) != 0))
+    {
+        ret = BenchError("red_transact", pParam->pszVolume);
+    }
+
+    return ret;
+}
+
+
+/** @brief Build the path of a benchmark directory or file.
+
+    @param pszPath  Populated with the path; must be ::BENCH_PATH_MAX bytes.
+    @param pParam   fsbench parameters.
+    @param ulDir    The directory number, or UINT32_MAX for the directory which
+                    contains all of the benchmark directories.
+    @param ulFile   The file number, or UINT32_MAX for the directory itself.
+
+    @return Zero on success, otherwise nonzero.
+*/
+static int BenchPath(
+    char               *pszPath,
+    const FSBENCHPARAM *pParam,
+    uint32_t            ulDir,
+    uint32_t            ulFile)
+{
+    int32_t             iLen;
+
+    if(ulDir == UINT32_MAX)
+    {
+        iLen = RedSNPrintf(pszPath, BENCH_PATH_MAX, "%s/" BENCH_DIR, pParam->pszVolume);
+    }
+    else if(ulFile == UINT32_MAX)
+    {
+        iLen = RedSNPrintf(pszPath, BENCH_PATH_MAX, "%s/" BENCH_DIR "/d%lu", pParam->pszVolume, (unsigned long)ulDir);
+    }
+    else
+    {
+        iLen = RedSNPrintf(pszPath, BENCH_PATH_MAX, "%s/" BENCH_DIR "/d%lu/f%lu", pParam->pszVolume, (unsigned long)ulDir, (unsigned long)ulFile);
+    }
+
+    if(iLen < 0)
+    {
+        RedPrintf("fsbench: path too long\n");
+    }
+
+    return (iLen < 0) ? 1 : 0;
+}
+
+
+/** @brief Deselect all of the workloads.
+
+    @param pParam   fsbench parameters.
+*/
+static void BenchClearWorkloads(
+    FSBENCHPARAM   *pParam)
+{
+    pParam->fMetadata = false;
+    pParam->fSequential = false;
+    pParam->fLargeDir = false;
+    pParam->fCrc = false;
+    pParam->fMulti = false;
+    pParam->fRandom = false;
+    pParam->fLatency = false;
+}
+
+
+/** @brief Start a workload.
+
+    The caller prints a line describing the workload right after; with --csv,
+    this makes it a comment.
+
+    @param pszWorkload  The name of the workload, as reported with --csv.
+*/
+static void BenchBegin(
+    const char *pszWorkload)
+{
+    gBench.pszWorkload = pszWorkload;
+
+    if(gBench.fCsv)
+    {
+        RedPrintf("# ");
+    }
+}
+
+
+/** @brief Start timing a benchmark phase.
+
+    @return The timestamp to give RedOsTimePassed() once the phase is over.
+*/
+static REDTIMESTAMP BenchPhaseStart(void)
+{
+  #if REDCONF_BUFFER_STATS == 1
+    (void)RedCoreBufferStats(&gBench.ulHits, &gBench.ulMisses);
+  #endif
+
+    return RedOsTimestamp();
+}
+
+
+/** @brief Print the results of a benchmark phase.
+
+    @param pszPhase     The name of the phase.
+    @param ulOps        The number of operations performed.
+    @param ullMicrosec  The time the operations took, in microseconds.
+*/
+static void BenchReport(
+    const char *pszPhase,
+    uint32_t    ulOps,
+    uint64_t    ullMicrosec)
+{
+    BenchReportRow(pszPhase, ulOps, "ops", ullMicrosec, NULL);
+}
+
+
+/** @brief Print the results of a benchmark phase which transfers file data.
+
+    @param pszPhase     The name of the phase.
+    @param ulKB         The number of kilobytes transferred.
+    @param ullMicrosec  The time the transfer took, in microseconds.
+*/
+static void BenchReportThroughput(
+    const char *pszPhase,
+    uint32_t    ulKB,
+    uint64_t    ullMicrosec)
+{
+    BenchReportRow(pszPhase, ulKB, "KB", ullMicrosec, NULL);
+}
+
+
+/** @brief Print the results of a benchmark phase which timed each operation.
+
+    @param pszPhase     The name of the phase.
+    @param paulMicrosec The time each operation took, in microseconds; sorted
+                        by this function.
+    @param ulCount      The number of operations; must be nonzero.
+    @param ullMicrosec  The time all of the operations took, in microseconds.
+*/
+static void BenchReportLatency(
+    const char *pszPhase,
+    uint32_t   *paulMicrosec,
+    uint32_t    ulCount,
+    uint64_t    ullMicrosec)
+{
+    static const uint32_t aulPercent[4U] = { 50U, 90U, 99U, 100U };
+    uint32_t    aulPercentile[4U];
+    uint32_t    ulIdx;
+
+    REDASSERT(ulCount > 0U);
+
+    /*  An insertion sort, which is quick enough for the number of samples.
+    */
+    for(ulIdx = 1U; ulIdx < ulCount; ulIdx++)
+    {
+        uint32_t    ulValue = paulMicrosec[ulIdx];
+        uint32_t    ulPos = ulIdx;
+
+        while((ulPos > 0U) && (paulMicrosec[ulPos - 1U] > ulValue))
+        {
+            paulMicrosec[ulPos] = paulMicrosec[ulPos - 1U];
+            ulPos--;
+        }
+
+        paulMicrosec[ulPos] = ulValue;
+    }
+
+    /*  Nearest-rank percentiles: the smallest sample which is at least as
+        large as the given percentage of the samples.
+    */
+    for(ulIdx = 0U; ulIdx < 4U; ulIdx++)
+    {
+        uint32_t ulRank = (uint32_t)((((uint64_t)ulCount * aulPercent[ulIdx]) + 99U) / 100U);
+
+        aulPercentile[ulIdx] = paulMicrosec[ulRank - 1U];
+    }
+
+    BenchReportRow(pszPhase, ulCount, "ops", ullMicrosec, aulPercentile);
+}
+
+
+/** @brief Print a line of results, as a table row or as comma-separated
+           values.
+
+    @param pszPhase         The name of the phase.
+    @param ulCount          The number of operations or kilobytes.
+    @param pszUnit          What @p ulCount counts: "ops" or "KB".
+    @param ullMicrosec      The time the phase took, in microseconds.
+    @param paulPercentile   The 50th, 90th, and 99th percentile and maximum
+                            time of each operation, in microseconds; or NULL if
+                            they were not measured.
+*/
+static void BenchReportRow(
+    const char     *pszPhase,
+    uint32_t        ulCount,
+    const char     *pszUnit,
+    uint64_t        ullMicrosec,
+    const uint32_t *paulPercentile)
+{
+    uint64_t        ullPerSec = 0U;
+  #if REDCONF_BUFFER_STATS == 1
+    uint32_t        ulHits;
+    uint32_t        ulMisses;
+
+    /*  The counts wrap around, which the subtraction allows for.
+    */
+    (void)RedCoreBufferStats(&ulHits, &ulMisses);
+    ulHits -= gBench.ulHits;
+    ulMisses -= gBench.ulMisses;
+  #endif
+
+    if(ullMicrosec != 0U)
+    {
+        ullPerSec = RedMulDiv64(ulCount, 1000000U, ullMicrosec);
+    }
+
+    if(gBench.fCsv)
+    {
+        RedPrintf("%s,%s,%lu,%s,%llu,%llu,", gBench.pszWorkload, pszPhase, (unsigned long)ulCount, pszUnit,
+            (unsigned long long)ullMicrosec, (unsigned long long)ullPerSec);
+
+        if(paulPercentile != NULL)
+        {
+            RedPrintf("%lu,%lu,%lu,%lu,", (unsigned long)paulPercentile[0U], (unsigned long)paulPercentile[1U],
+                (unsigned long)paulPercentile[2U], (unsigned long)paulPercentile[3U]);
+        }
+        else
+        {
+            RedPrintf(",,,,");
+        }
+
+      #if REDCONF_BUFFER_STATS == 1
+        RedPrintf("%lu,%lu\n", (unsigned long)ulHits, (unsigned long)ulMisses);
+      #else
+        RedPrintf(",\n");
+      #endif
+    }
+    else
+    {
+        RedPrintf("  %-10s %9lu %-3s %12llu us %10llu %s/sec", pszPhase, (unsigned long)ulCount, pszUnit,
+            (unsigned long long)ullMicrosec, (unsigned long long)ullPerSec, pszUnit);
+
+        if(paulPercentile != NULL)
+        {
+            RedPrintf("  p50 %lu p90 %lu p99 %lu max %lu us", (unsigned long)paulPercentile[0U],
+                (unsigned long)paulPercentile[1U], (unsigned long)paulPercentile[2U], (unsigned long)paulPercentile[3U]);
+        }
+
+      #if REDCONF_BUFFER_STATS == 1
+        if((ulHits != 0U) || (ulMisses != 0U))
+        {
+            uint32_t ulPermille = (uint32_t)(((uint64_t)ulHits * 1000U) / ((uint64_t)ulHits + ulMisses));
+
+            RedPrintf("  %3lu.%lu%% hit", (unsigned long)(ulPermille / 10U), (unsigned long)(ulPermille % 10U));
+        }
+      #endif
+
+        RedPrintf("\n");
+    }
+}
+
+
+/** @brief Report a failed file system call.
+
+    @param pszOp    The name of the call which failed.
+    @param pszPath  The path or volume it was given.
+
+    @return Always 1, to be returned by the caller.
+*/
+static int BenchError(
+    const char *pszOp,
+    const char *pszPath)
+{
+    RedPrintf("fsbench: %s(\"%s\") failed with error %d\n", pszOp, pszPath, (int)red_errno);
+
+    return 1;
+}
+
+
+/** @brief Print usage information.
+
+    @param pszProgName  The name of the program.
+*/
+static void BenchUsage(
+    const char *pszProgName)
+{
+    RedPrintf("usage: %s VolumeID [Options]\n", pszProgName);
+    RedPrintf("File system benchmark.\n\n");
+    RedPrintf("Where:\n");
+    RedPrintf("  VolumeID\n");
+    RedPrintf("      A volume number (e.g., 2) or a volume path prefix (e.g., VOL1: or /data)\n");
+    RedPrintf("      of the volume to test.\n");
+    RedPrintf("And 'Options' are any of the following:\n");
+    RedPrintf("  --meta, -m\n");
+    RedPrintf("      Run the metadata workload: create, look up, list, and delete many\n");
+    RedPrintf("      empty files.  If no workload is named, all workloads are run.\n");
+    RedPrintf("  --seq, -q\n");
+    RedPrintf("      Run the sequential workload: write and read a file with large I/O, then\n");
+    RedPrintf("      write and read another %u bytes at a time.\n", (unsigned)BENCH_APPEND_SIZE);
+    RedPrintf("  --large-dir, -l\n");
+    RedPrintf("      Run the large directory workload: create many empty files in one\n");
+    RedPrintf("      directory, reporting how the rate changes as the directory grows, then\n");
+    RedPrintf("      look up existing and nonexistent names, and delete the files.\n");
+    RedPrintf("  --crc, -c\n");
+    RedPrintf("      Run the CRC workload: time the metadata checksum over buffers of each\n");
+    RedPrintf("      power-of-two size from 128 bytes up to %lu bytes.\n", (unsigned long)BENCH_IO_MAX);
+    RedPrintf("  --multi, -M\n");
+    RedPrintf("      Run the multitasking workload: half of the tasks each read a file while\n");
+    RedPrintf("      the others each write one, all at once.  Each task uses one of the\n");
+    RedPrintf("      REDCONF_TASK_COUNT task slots, and keeps it until the driver is\n");
+    RedPrintf("      uninitialized.\n");
+    RedPrintf("  --random, -r\n");
+    RedPrintf("      Run the random workload: for each power-of-two I/O size from %u bytes\n", (unsigned)BENCH_RANDOM_MIN);
+    RedPrintf("      up to %lu bytes, read and then overwrite a file, sequentially and at\n", (unsigned long)BENCH_IO_MAX);
+    RedPrintf("      random offsets.\n");
+    RedPrintf("  --latency, -L\n");
+    RedPrintf("      Run the latency workload: time %u transaction points after small file\n", (unsigned)BENCH_LATENCY_COUNT);
+    RedPrintf("      data changes, and as many after creating or deleting a file, and report\n");
+    RedPrintf("      the 50th, 90th, and 99th percentile and maximum times.\n");
+    RedPrintf("  --dirs=count, -d count\n");
+    RedPrintf("      Specifies the number of directories for the metadata workload\n");
+    RedPrintf("      (default 4).\n");
+    RedPrintf("  --files=count, -f count\n");
+    RedPrintf("      Specifies the number of files in each directory (default 50).\n");
+    RedPrintf("  --entries=count, -e count\n");
+    RedPrintf("      Specifies the number of files for the large directory workload\n");
+    RedPrintf("      (default 1000).\n");
+    RedPrintf("  --size=KB, -z KB\n");
+    RedPrintf("      Specifies the size of the files for the sequential, random, latency, and\n");
+    RedPrintf("      multitasking workloads, and the amount of data checksummed per size by\n");
+    RedPrintf("      the CRC workload, in kilobytes (default 1024).\n");
+    RedPrintf("  --io=bytes, -i bytes\n");
+    RedPrintf("      Specifies the size of each read and write for the sequential and\n");
+    RedPrintf("      multitasking workloads (default and maximum %lu).\n", (unsigned long)BENCH_IO_MAX);
+    RedPrintf("  --tasks=count, -T count\n");
+    RedPrintf("      Specifies the number of tasks for the multitasking workload (default 4,\n");
+    RedPrintf("      or REDCONF_TASK_COUNT minus one if that is smaller).\n");
+    RedPrintf("  --transact, -t\n");
+    RedPrintf("      Leave the volume's automatic transaction settings in effect.  Without\n");
+    RedPrintf("      this, the benchmark transacts only at the end of each phase.\n");
+    RedPrintf("  --seed=value, -s value\n");
+    RedPrintf("      Specifies the seed for the random number generator (default 1).\n");
+    RedPrintf("  --csv, -x\n");
+    RedPrintf("      Print the results as comma-separated values, one line per phase after\n");
+    RedPrintf("      a line naming the columns, and everything else as comments starting\n");
+    RedPrintf("      with #.  The buffer hit and miss columns are empty unless\n");
+    RedPrintf("      REDCONF_BUFFER_STATS is enabled.\n");
+    RedPrintf("  --dev=devname, -D devname\n");
+    RedPrintf("      Specifies the device name.  This is typically only meaningful when\n");
+    RedPrintf("      running the test on a host machine.  This can be \"ram\" to test on a RAM\n");
+    RedPrintf("      disk, the path and name of a file disk (e.g., red.bin); or an OS-specific\n");
+    RedPrintf("      reference to a device (on Windows, a drive letter like G: or a device name\n");
+    RedPrintf("      like \\\\.\\PhysicalDrive7).  To compare the file system with and\n");
+    RedPrintf("      without the cost of a real device, run once with \"ram\" and once with a\n");
+    RedPrintf("      file disk.\n");
+    RedPrintf("  --help, -H\n");
+    RedPrintf("      Prints this usage text and exits.\n\n");
+    RedPrintf("Warning: The volume should be freshly formatted, so that results can be compared.\n\n");
+}
+
+#endif /* FSBENCH_SUPPORTED */
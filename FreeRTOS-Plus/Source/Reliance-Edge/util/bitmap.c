@@ -99,3 +99,72 @@ void RedBitClear(
     }
 }
 
+
+/** @brief Find the first bit in a range of a bitmap which is set or clear.
+
+    Bits are counted from most significant to least significant.  Thus, the mask
+    for bit zero is 0x80 applied to the first byte in the bitmap.
+
+    Bytes which cannot contain a match are skipped four at a time, and then one
+    at a time, so that long runs of identical bits are crossed quickly.
+
+    @param pbBitmap     Pointer to the bitmap.
+    @param ulBitStart   The first bit to examine.
+    @param ulBitEnd     The bit after the last bit to examine.
+    @param fSet         Whether to find a set bit (true) or a clear bit (false).
+
+    @return The first bit in the range [@p ulBitStart, @p ulBitEnd) which is set
+            (if @p fSet is true) or clear (if @p fSet is false); or @p ulBitEnd
+            if there is no such bit.
+*/
+uint32_t RedBitFind(
+    const uint8_t *pbBitmap,
+    uint32_t       ulBitStart,
+    uint32_t       ulBitEnd,
+    bool           fSet)
+{
+    uint32_t       ulBit = ulBitStart;
+
+    if((pbBitmap == NULL) || (ulBitStart > ulBitEnd))
+    {
+        REDERROR();
+        ulBit = ulBitEnd;
+    }
+    else
+    {
+        /*  A byte with this value has no bits which match.
+        */
+        uint8_t bSkip = fSet ? 0x00U : 0xFFU;
+        bool    fFound = false;
+
+        while((ulBit < ulBitEnd) && !fFound)
+        {
+            uint32_t ulByte = ulBit >> 3U;
+
+            if(    ((ulBit & 7U) == 0U)
+                && ((ulBitEnd - ulBit) >= 32U)
+                && ((   (uint8_t)(pbBitmap[ulByte] ^ bSkip)
+                      | (uint8_t)(pbBitmap[ulByte + 1U] ^ bSkip)
+                      | (uint8_t)(pbBitmap[ulByte + 2U] ^ bSkip)
+                      | (uint8_t)(pbBitmap[ulByte + 3U] ^ bSkip)) == 0U))
+            {
+                ulBit += 32U;
+            }
+            else if(((ulBit & 7U) == 0U) && ((ulBitEnd - ulBit) >= 8U) && (pbBitmap[ulByte] == bSkip))
+            {
+                ulBit += 8U;
+            }
+            else if(((pbBitmap[ulByte] & (0x80U >> (ulBit & 7U))) != 0U) == fSet)
+            {
+                fFound = true;
+            }
+            else
+            {
+                ulBit++;
+            }
+        }
+    }
+
+    return ulBit;
+}
+
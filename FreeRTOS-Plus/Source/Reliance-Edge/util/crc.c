@@ -39,6 +39,27 @@
 #define CRC_BITWISE     (0U)
 #define CRC_SARWATE     (1U)
 #define CRC_SLICEBY8    (2U)
+#define CRC_HARDWARE    (3U)
+
+
+/*  CRC_HARDWARE computes the same CRC as the other algorithms, so it does not
+    affect the on-disk format, but uses processor instructions to do so when the
+    compiler targets a processor which has them: carry-less multiplication
+    (PCLMULQDQ) on x86, or the CRC-32 instructions of ARMv8.  Note that the
+    SSE4.2 CRC32 instruction on x86 cannot be used, since it computes CRC-32C,
+    which uses a different polynomial.  Any bytes which the instructions do not
+    handle, and all bytes on other processors, are handled by slicing-by-8.
+*/
+#if REDCONF_CRC_ALGORITHM == CRC_HARDWARE
+  #if defined(__ARM_FEATURE_CRC32) && (REDCONF_ENDIAN_BIG == 0)
+    #include <arm_acle.h>
+    #define CRC_HW_ARM
+  #elif defined(__PCLMUL__) && defined(__SSE4_1__)
+    #include <wmmintrin.h>
+    #include <smmintrin.h>
+    #define CRC_HW_PCLMUL
+  #endif
+#endif
 
 
 #if REDCONF_CRC_ALGORITHM == CRC_BITWISE
@@ -183,8 +204,36 @@ uint32_t RedCrc32Update(
     return ulCrc32;
 }
 
-#elif REDCONF_CRC_ALGORITHM == CRC_SLICEBY8
+#elif (REDCONF_CRC_ALGORITHM == CRC_SLICEBY8) || (REDCONF_CRC_ALGORITHM == CRC_HARDWARE)
+
+static uint32_t CrcSliceBy8(uint32_t ulInitCrc32, const void *pBuffer, uint32_t ulLength);
+#ifdef CRC_HW_PCLMUL
+static uint32_t CrcFoldPclmul(uint32_t ulCrc32, const uint8_t *pbBuffer, uint32_t ulLength);
+#endif
+
+
+#if REDCONF_CRC_ALGORITHM == CRC_SLICEBY8
+
+/** @brief Compute a CRC32 for the given data buffer.
+
+    For CCITT-32 compliance, the initial CRC must be set to 0.  To CRC multiple
+    buffers, call this function with the previously returned CRC value.
+
+    @param ulInitCrc32  Starting CRC value.
+    @param pBuffer      Data buffer to calculate the CRC from.
+    @param ulLength     Number of bytes of data in the given buffer.
+
+    @return The updated CRC value.
+*/
+uint32_t RedCrc32Update(
+    uint32_t    ulInitCrc32,
+    const void *pBuffer,
+    uint32_t    ulLength)
+{
+    return CrcSliceBy8(ulInitCrc32, pBuffer, ulLength);
+}
 
+#else
 
 /** @brief Compute a CRC32 for the given data buffer.
 
@@ -201,6 +250,174 @@ uint32_t RedCrc32Update(
     uint32_t    ulInitCrc32,
     const void *pBuffer,
     uint32_t    ulLength)
+{
+    uint32_t    ulCrc32;
+
+    if(pBuffer == NULL)
+    {
+        REDERROR();
+        ulCrc32 = SUSPICIOUS_CRC_VALUE;
+    }
+    else
+    {
+        const uint8_t  *pbBuffer = CAST_VOID_PTR_TO_CONST_UINT8_PTR(pBuffer);
+        uint32_t        ulIdx = 0U;
+
+        ulCrc32 = ulInitCrc32;
+
+      #if defined(CRC_HW_PCLMUL)
+        /*  The folding needs at least four 16-byte blocks, and handles only
+            whole blocks.
+        */
+        if(ulLength >= 64U)
+        {
+            ulIdx = ulLength & ~15U;
+            ulCrc32 = ~CrcFoldPclmul(~ulCrc32, pbBuffer, ulIdx);
+        }
+      #elif defined(CRC_HW_ARM)
+        ulCrc32 = ~ulCrc32;
+
+        while((ulIdx < ulLength) && !IS_ALIGNED_PTR(&pbBuffer[ulIdx]))
+        {
+            ulCrc32 = __crc32b(ulCrc32, pbBuffer[ulIdx]);
+            ulIdx++;
+        }
+
+        while((ulLength - ulIdx) >= 4U)
+        {
+            ulCrc32 = __crc32w(ulCrc32, *CAST_CONST_UINT32_PTR(&pbBuffer[ulIdx]));
+            ulIdx += 4U;
+        }
+
+        ulCrc32 = ~ulCrc32;
+      #endif
+
+        ulCrc32 = CrcSliceBy8(ulCrc32, &pbBuffer[ulIdx], ulLength - ulIdx);
+    }
+
+    return ulCrc32;
+}
+
+
+#ifdef CRC_HW_PCLMUL
+/** @brief Compute a CRC32 using carry-less multiplication.
+
+    Folds the data 64 bytes at a time, then 16 bytes at a time, and reduces the
+    remaining 128 bits to the CRC, as described in "Fast CRC Computation for
+    Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).  The
+    constants are those given there for the bit-reflected CRC-32 polynomial.
+
+    Unlike RedCrc32Update(), the CRC is neither inverted on entry nor on exit.
+
+    @param ulCrc32  Starting CRC value.
+    @param pbBuffer Data buffer to calculate the CRC from.
+    @param ulLength Number of bytes of data in the given buffer; must be a
+                    multiple of 16, and at least 64.
+
+    @return The updated CRC value.
+*/
+static uint32_t CrcFoldPclmul(
+    uint32_t        ulCrc32,
+    const uint8_t  *pbBuffer,
+    uint32_t        ulLength)
+{
+    const __m128i   xK1K2 = _mm_set_epi64x((long long)UINT64_SUFFIX(0x01C6E41596), (long long)UINT64_SUFFIX(0x0154442BD4));
+    const __m128i   xK3K4 = _mm_set_epi64x((long long)UINT64_SUFFIX(0x00CCAA009E), (long long)UINT64_SUFFIX(0x01751997D0));
+    const __m128i   xK5 = _mm_set_epi64x(0, (long long)UINT64_SUFFIX(0x0163CD6124));
+    const __m128i   xPoly = _mm_set_epi64x((long long)UINT64_SUFFIX(0x01F7011641), (long long)UINT64_SUFFIX(0x01DB710641));
+    const __m128i   xMask32 = _mm_setr_epi32(-1, 0, -1, 0);
+    __m128i         x1;
+    __m128i         x2;
+    __m128i         x3;
+    __m128i         x4;
+    __m128i         xTmp;
+    uint32_t        ulIdx = 64U;
+
+    REDASSERT((ulLength >= 64U) && ((ulLength % 16U) == 0U));
+
+    x1 = _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[0U]);
+    x2 = _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[16U]);
+    x3 = _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[32U]);
+    x4 = _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[48U]);
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)ulCrc32));
+
+    /*  Fold four 128-bit lanes in parallel, 64 bytes at a time.
+    */
+    while((ulLength - ulIdx) >= 64U)
+    {
+        __m128i x5 = _mm_clmulepi64_si128(x1, xK1K2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, xK1K2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, xK1K2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, xK1K2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, xK1K2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, xK1K2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, xK1K2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, xK1K2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[ulIdx]));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[ulIdx + 16U]));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[ulIdx + 32U]));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[ulIdx + 48U]));
+
+        ulIdx += 64U;
+    }
+
+    /*  Fold the four lanes into one.
+    */
+    xTmp = _mm_clmulepi64_si128(x1, xK3K4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, xK3K4, 0x11), x2), xTmp);
+    xTmp = _mm_clmulepi64_si128(x1, xK3K4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, xK3K4, 0x11), x3), xTmp);
+    xTmp = _mm_clmulepi64_si128(x1, xK3K4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, xK3K4, 0x11), x4), xTmp);
+
+    /*  Fold in the remaining data 16 bytes at a time.
+    */
+    while(ulIdx < ulLength)
+    {
+        xTmp = _mm_clmulepi64_si128(x1, xK3K4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, xK3K4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, xTmp), _mm_loadu_si128((const __m128i *)(const void *)&pbBuffer[ulIdx]));
+
+        ulIdx += 16U;
+    }
+
+    /*  Fold 128 bits down to 64 bits.
+    */
+    xTmp = _mm_clmulepi64_si128(x1, xK3K4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), xTmp);
+
+    xTmp = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, xMask32), xK5, 0x00);
+    x1 = _mm_xor_si128(x1, xTmp);
+
+    /*  Barrett reduction to 32 bits.
+    */
+    xTmp = _mm_clmulepi64_si128(_mm_and_si128(x1, xMask32), xPoly, 0x10);
+    xTmp = _mm_clmulepi64_si128(_mm_and_si128(xTmp, xMask32), xPoly, 0x00);
+    x1 = _mm_xor_si128(x1, xTmp);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif /* CRC_HW_PCLMUL */
+
+#endif
+
+
+/** @brief Compute a CRC32 for the given data buffer using slicing-by-8.
+
+    @param ulInitCrc32  Starting CRC value.
+    @param pBuffer      Data buffer to calculate the CRC from.
+    @param ulLength     Number of bytes of data in the given buffer.
+
+    @return The updated CRC value.
+*/
+static uint32_t CrcSliceBy8(
+    uint32_t    ulInitCrc32,
+    const void *pBuffer,
+    uint32_t    ulLength)
 {
     /*  CRC32 XOR table, with slicing-by-8 extensions.
 
@@ -560,7 +777,7 @@ uint32_t RedCrc32Update(
 
 #else
 
-#error "REDCONF_CRC_ALGORITHM must be set to CRC_BITWISE, CRC_SARWATE, or CRC_SLICEBY8"
+#error "REDCONF_CRC_ALGORITHM must be set to CRC_BITWISE, CRC_SARWATE, CRC_SLICEBY8, or CRC_HARDWARE"
 
 #endif
 
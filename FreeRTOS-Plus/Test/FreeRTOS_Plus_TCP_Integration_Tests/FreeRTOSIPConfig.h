@@ -151,6 +151,11 @@ reason.  The static configuration used is that passed into the stack by the
 FreeRTOS_IPInit() function call. */
 #define ipconfigUSE_DHCP	1
 
+/* Accept an ACK with the Rapid Commit option (RFC 4039) as the answer to a
+DISCOVER, which saves the OFFER/REQUEST exchange.  Also enables the tests of the
+option in test_freertos_tcp.c. */
+#define ipconfigDHCP_USE_RAPID_COMMIT	1
+
 /* When ipconfigUSE_DHCP is set to 1, DHCP requests will be sent out at
 increasing time intervals until either a reply is received from a DHCP server
 and accepted, or the interval between transmissions reaches
@@ -242,6 +247,13 @@ be divisible by 8. */
 through the FreeRTOS_gethostbyname() API function. */
 #define ipconfigUSE_DNS			1
 
+/* Use the asynchronous resolver, so that the tests of FreeRTOS_dnsquery_a()
+and of the resolver against a stub DNS server are built.  It relies on the
+call-back mechanisms of the stack. */
+#define ipconfigUSE_CALLBACKS		1
+#define ipconfigDNS_USE_CALLBACKS	1
+#define ipconfigDNS_USE_ASYNC		1
+
 /* If ipconfigREPLY_TO_INCOMING_PINGS is set to 1 then the IP stack will
 generate replies to incoming ICMP echo (ping) requests. */
 #define ipconfigREPLY_TO_INCOMING_PINGS				1
@@ -305,6 +317,9 @@ disconnecting stage will timeout after a period of non-activity. */
 #define ipconfigTCP_KEEP_ALIVE				( 1 )
 #define ipconfigTCP_KEEP_ALIVE_INTERVAL		( 20 ) /* in seconds */
 
+/* Include IPv6, so that the IPv6 tests in test_freertos_tcp.c are run. */
+#define ipconfigUSE_IPv6					( 1 )
+
 #define portINLINE __inline
 
 #endif /* FREERTOS_IP_CONFIG_H */
@@ -159,6 +159,12 @@ used with multiple project configurations.  If it is
 #define ipconfigUSE_NETWORK_EVENT_HOOK 1
 //#define ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME  pdMS_TO_TICKS(5000)
 #define configNETWORK_INTERFACE_TO_USE 1L
+/* The Linux network device opened by the AF_PACKET network interface, which is
+used when the demo is built with "scons --af-packet".  "scons --tap" sets it to
+the name of the TAP device instead. */
+#ifndef configNETWORK_INTERFACE_NAME
+	#define configNETWORK_INTERFACE_NAME "veth1"
+#endif
 
 /* The address of an echo server that will be used by the two demo echo client
 tasks.
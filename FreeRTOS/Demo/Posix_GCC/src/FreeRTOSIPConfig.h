@@ -302,6 +302,11 @@ disconnecting stage will timeout after a period of non-activity. */
 #define ipconfigTCP_KEEP_ALIVE				( 1 )
 #define ipconfigTCP_KEEP_ALIVE_INTERVAL		( 20 ) /* in seconds */
 
+/* Let FreeRTOS_sendto() pass UDP packets to the network driver directly when
+a socket has the option FREERTOS_SO_UDP_DIRECT_SEND.  Only the linux_af_packet
+and linux_tap drivers allow it, see UDPDirectSendThroughput.c. */
+#define ipconfigUDP_DIRECT_SEND				1
+
 #define portINLINE __inline
 
 #endif /* FREERTOS_IP_CONFIG_H */
@@ -0,0 +1,223 @@
+/*
+ * FreeRTOS Kernel V10.3.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures the throughput of a TCP connection between two tasks of this node.
+ * A server task accepts connections and discards all data, a client task
+ * connects to it and sends loopbackBYTES_PER_RUN bytes as fast as it can.
+ *
+ * When ipconfigUSE_LOOPBACK is 1 in FreeRTOSIPConfig.h, the packets are passed
+ * back to the IP-task at the IP layer, without ARP and without checksums.
+ * When it is 0, the packets are given to the network driver, and the test only
+ * works if the driver returns packets addressed to this node, e.g. by calling
+ * xCheckLoopback().  Run the test both ways to compare the two paths.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+#include "TCPLoopbackThroughput.h"
+
+/* Exclude the whole file if FreeRTOSIPConfig.h is configured to use UDP only. */
+#if ( ipconfigUSE_TCP == 1 )
+
+/* The port number used by the server task. */
+	#define loopbackPORT				  ( 5006 )
+
+/* The number of bytes sent for each measurement. */
+	#define loopbackBYTES_PER_RUN		  ( 16UL * 1024UL * 1024UL )
+
+/* The size of the buffers passed to FreeRTOS_send() and FreeRTOS_recv(). */
+	#define loopbackBUFFER_SIZE			  ( ipconfigTCP_MSS * 4 )
+
+/* The time between two measurements. */
+	#define loopbackRUN_DELAY			  pdMS_TO_TICKS( 5000 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Accepts a connection and receives until the peer closes it.
+ */
+	static void prvLoopbackServerTask( void *pvParameters );
+
+/*
+ * Connects to the server task and sends loopbackBYTES_PER_RUN bytes.
+ */
+	static void prvLoopbackClientTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+	static const TickType_t xReceiveTimeOut = pdMS_TO_TICKS( 4000 );
+	static const TickType_t xSendTimeOut = pdMS_TO_TICKS( 4000 );
+
+/* Large windows give the best throughput. */
+	static const WinProperties_t xWinProps =
+	{
+		.lTxBufSize = 8 * ipconfigTCP_MSS,
+		.lTxWinSize = 4,
+		.lRxBufSize = 8 * ipconfigTCP_MSS,
+		.lRxWinSize = 4
+	};
+
+	static char cTxBuffer[ loopbackBUFFER_SIZE ], cRxBuffer[ loopbackBUFFER_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+	void vStartTCPLoopbackThroughputTasks( uint16_t usTaskStackSize,
+										   UBaseType_t uxTaskPriority )
+	{
+		xTaskCreate( prvLoopbackServerTask, "LbServer", usTaskStackSize, NULL, uxTaskPriority, NULL );
+		xTaskCreate( prvLoopbackClientTask, "LbClient", usTaskStackSize, NULL, uxTaskPriority, NULL );
+	}
+/*-----------------------------------------------------------*/
+
+	static void prvLoopbackServerTask( void *pvParameters )
+	{
+	Socket_t xListeningSocket, xConnectedSocket;
+	struct freertos_sockaddr xBindAddress, xClient;
+	socklen_t xSize = sizeof( xClient );
+	BaseType_t xReceived;
+
+		( void ) pvParameters;
+
+		xListeningSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+		configASSERT( xListeningSocket != FREERTOS_INVALID_SOCKET );
+
+		FreeRTOS_setsockopt( xListeningSocket, 0, FREERTOS_SO_RCVTIMEO, &xReceiveTimeOut, sizeof( xReceiveTimeOut ) );
+		FreeRTOS_setsockopt( xListeningSocket, 0, FREERTOS_SO_WIN_PROPERTIES, ( void * ) &xWinProps, sizeof( xWinProps ) );
+
+		xBindAddress.sin_port = FreeRTOS_htons( loopbackPORT );
+		FreeRTOS_bind( xListeningSocket, &xBindAddress, sizeof( xBindAddress ) );
+		FreeRTOS_listen( xListeningSocket, 1 );
+
+		for( ;; )
+		{
+			xConnectedSocket = FreeRTOS_accept( xListeningSocket, &xClient, &xSize );
+
+			if( ( xConnectedSocket == NULL ) || ( xConnectedSocket == FREERTOS_INVALID_SOCKET ) )
+			{
+				continue;
+			}
+
+			/* Discard everything until the client closes the connection. */
+			do
+			{
+				xReceived = FreeRTOS_recv( xConnectedSocket, cRxBuffer, sizeof( cRxBuffer ), 0 );
+			} while( xReceived > 0 );
+
+			FreeRTOS_shutdown( xConnectedSocket, FREERTOS_SHUT_RDWR );
+			FreeRTOS_closesocket( xConnectedSocket );
+		}
+	}
+/*-----------------------------------------------------------*/
+
+	static void prvLoopbackClientTask( void *pvParameters )
+	{
+	Socket_t xSocket;
+	struct freertos_sockaddr xServerAddress;
+	uint32_t ulBytesSent;
+	BaseType_t xSent;
+	TickType_t xStartTime, xElapsed;
+
+		( void ) pvParameters;
+
+		for( ;; )
+		{
+			vTaskDelay( loopbackRUN_DELAY );
+
+			/* Connect through the IP address of this node. */
+			xServerAddress.sin_addr = FreeRTOS_GetIPAddress();
+			xServerAddress.sin_port = FreeRTOS_htons( loopbackPORT );
+
+			xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+			configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+
+			FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xReceiveTimeOut, sizeof( xReceiveTimeOut ) );
+			FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, &xSendTimeOut, sizeof( xSendTimeOut ) );
+			FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_WIN_PROPERTIES, ( void * ) &xWinProps, sizeof( xWinProps ) );
+
+			if( FreeRTOS_connect( xSocket, &xServerAddress, sizeof( xServerAddress ) ) == 0 )
+			{
+				xStartTime = xTaskGetTickCount();
+
+				for( ulBytesSent = 0UL; ulBytesSent < loopbackBYTES_PER_RUN; ulBytesSent += ( uint32_t ) xSent )
+				{
+					xSent = FreeRTOS_send( xSocket, cTxBuffer, sizeof( cTxBuffer ), 0 );
+
+					if( xSent <= 0 )
+					{
+						break;
+					}
+				}
+
+				xElapsed = xTaskGetTickCount() - xStartTime;
+
+				if( xElapsed == 0U )
+				{
+					xElapsed = 1U;
+				}
+
+				printf( "Loopback: %lu bytes in %lu ms, %lu KB/s (ipconfigUSE_LOOPBACK = %d)\n",
+						( unsigned long ) ulBytesSent,
+						( unsigned long ) ( xElapsed * portTICK_PERIOD_MS ),
+						( unsigned long ) ( ( ( uint64_t ) ulBytesSent * configTICK_RATE_HZ ) / ( ( uint64_t ) xElapsed * 1024U ) ),
+						( int ) ipconfigUSE_LOOPBACK );
+
+				FreeRTOS_shutdown( xSocket, FREERTOS_SHUT_RDWR );
+
+				/* Expect FreeRTOS_recv() to return an error once the shutdown is
+				complete. */
+				xStartTime = xTaskGetTickCount();
+
+				while( ( xTaskGetTickCount() - xStartTime ) < xReceiveTimeOut )
+				{
+					if( FreeRTOS_recv( xSocket, cTxBuffer, sizeof( cTxBuffer ), 0 ) < 0 )
+					{
+						break;
+					}
+				}
+			}
+			else
+			{
+				printf( "Loopback: could not connect to the server task\n" );
+			}
+
+			FreeRTOS_closesocket( xSocket );
+		}
+	}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_TCP */
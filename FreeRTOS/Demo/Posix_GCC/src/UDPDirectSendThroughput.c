@@ -0,0 +1,207 @@
+/*
+ * FreeRTOS Kernel V10.3.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures what FREERTOS_SO_UDP_DIRECT_SEND gains.  udpdirectTASK_COUNT tasks
+ * send udpdirectDATAGRAMS_PER_RUN datagrams each to the discard port (port 9)
+ * of the echo server that is configured by configECHO_SERVER_ADDR0 to
+ * configECHO_SERVER_ADDR3.  Every task first sends a run through the IP-task,
+ * then a run with the option set, so that the driver is called by all tasks at
+ * the same time.  For each run the minimum, average and maximum time spent in
+ * FreeRTOS_sendto() and the number of datagrams per second are printed.
+ *
+ * The times are taken with ulGetRunTimeCounterValue(), which counts
+ * nanoseconds in this demo.  When the network driver does not declare that it
+ * can be called by several tasks, FreeRTOS_setsockopt() refuses the option and
+ * only the first run is made.  The linux_af_packet and linux_tap drivers
+ * support it, the libpcap driver does not.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+#include "UDPDirectSendThroughput.h"
+
+/* Exclude the whole file if FreeRTOSIPConfig.h does not offer the option. */
+#if ( ipconfigUDP_DIRECT_SEND != 0 )
+
+/* The port to which the datagrams are sent. */
+	#define udpdirectDISCARD_PORT		  ( 9 )
+
+/* The number of tasks that send at the same time. */
+	#define udpdirectTASK_COUNT			  ( 2 )
+
+/* The number of datagrams sent by each task in one run. */
+	#define udpdirectDATAGRAMS_PER_RUN	  ( 20000UL )
+
+/* The number of bytes of UDP payload in each datagram. */
+	#define udpdirectDATAGRAM_SIZE		  ( 512 )
+
+/* The time between two measurements. */
+	#define udpdirectRUN_DELAY			  pdMS_TO_TICKS( 5000 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Sends a run through the IP-task and a run directly to the driver, and
+ * prints the results of both.
+ */
+	static void prvUDPDirectSendTask( void *pvParameters );
+
+/*
+ * Sends udpdirectDATAGRAMS_PER_RUN datagrams on xSocket and prints the
+ * results.
+ */
+	static void prvSendRun( Socket_t xSocket,
+							const struct freertos_sockaddr *pxDestination,
+							BaseType_t xInstance,
+							const char *pcMode );
+
+/*-----------------------------------------------------------*/
+
+	static const TickType_t xSendTimeOut = pdMS_TO_TICKS( 1000 );
+
+	static char cTxBuffers[ udpdirectTASK_COUNT ][ udpdirectDATAGRAM_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+	void vStartUDPDirectSendThroughputTasks( uint16_t usTaskStackSize,
+											 UBaseType_t uxTaskPriority )
+	{
+	BaseType_t x;
+
+		for( x = 0; x < udpdirectTASK_COUNT; x++ )
+		{
+			xTaskCreate( prvUDPDirectSendTask, "UDPDirect", usTaskStackSize, ( void * ) x, uxTaskPriority, NULL );
+		}
+	}
+/*-----------------------------------------------------------*/
+
+	static void prvUDPDirectSendTask( void *pvParameters )
+	{
+	Socket_t xSocket;
+	struct freertos_sockaddr xDestination;
+	BaseType_t xInstance = ( BaseType_t ) pvParameters;
+
+		xDestination.sin_port = FreeRTOS_htons( udpdirectDISCARD_PORT );
+		xDestination.sin_addr = FreeRTOS_inet_addr_quick( configECHO_SERVER_ADDR0,
+														  configECHO_SERVER_ADDR1,
+														  configECHO_SERVER_ADDR2,
+														  configECHO_SERVER_ADDR3 );
+
+		xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+		configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+
+		FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, &xSendTimeOut, sizeof( xSendTimeOut ) );
+
+		for( ;; )
+		{
+			vTaskDelay( udpdirectRUN_DELAY );
+
+			/* The first datagram may have to wait for an ARP reply, make sure
+			that the address is resolved before measuring. */
+			FreeRTOS_sendto( xSocket, cTxBuffers[ xInstance ], sizeof( cTxBuffers[ xInstance ] ), 0, &xDestination, sizeof( xDestination ) );
+			vTaskDelay( pdMS_TO_TICKS( 100 ) );
+
+			FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_UDP_DIRECT_SEND, ( void * ) pdFALSE, 0 );
+			prvSendRun( xSocket, &xDestination, xInstance, "IP-task" );
+
+			if( FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_UDP_DIRECT_SEND, ( void * ) pdTRUE, 0 ) == 0 )
+			{
+				prvSendRun( xSocket, &xDestination, xInstance, "direct" );
+			}
+			else
+			{
+				printf( "UDP direct send %d: not supported by the network driver\n", ( int ) xInstance );
+			}
+		}
+	}
+/*-----------------------------------------------------------*/
+
+	static void prvSendRun( Socket_t xSocket,
+							const struct freertos_sockaddr *pxDestination,
+							BaseType_t xInstance,
+							const char *pcMode )
+	{
+	uint32_t ulCount, ulSent = 0UL;
+	unsigned long ulRunStart, ulStart, ulTime, ulRunTime;
+	unsigned long ulMinTime = ~0UL, ulMaxTime = 0UL, ulTotalTime = 0UL;
+
+		ulRunStart = ulGetRunTimeCounterValue();
+
+		for( ulCount = 0UL; ulCount < udpdirectDATAGRAMS_PER_RUN; ulCount++ )
+		{
+			ulStart = ulGetRunTimeCounterValue();
+
+			if( FreeRTOS_sendto( xSocket, cTxBuffers[ xInstance ], sizeof( cTxBuffers[ xInstance ] ), 0, pxDestination, sizeof( *pxDestination ) ) > 0 )
+			{
+				ulTime = ulGetRunTimeCounterValue() - ulStart;
+				ulSent++;
+				ulTotalTime += ulTime;
+
+				if( ulTime < ulMinTime )
+				{
+					ulMinTime = ulTime;
+				}
+
+				if( ulTime > ulMaxTime )
+				{
+					ulMaxTime = ulTime;
+				}
+			}
+		}
+
+		ulRunTime = ulGetRunTimeCounterValue() - ulRunStart;
+
+		if( ( ulSent == 0UL ) || ( ulRunTime == 0UL ) )
+		{
+			printf( "UDP direct send %d (%s): nothing sent\n", ( int ) xInstance, pcMode );
+		}
+		else
+		{
+			printf( "UDP direct send %d (%s): %lu datagrams, sendto() min/avg/max %lu/%lu/%lu us, %lu datagrams/s\n",
+					( int ) xInstance,
+					pcMode,
+					( unsigned long ) ulSent,
+					ulMinTime / 1000UL,
+					( ulTotalTime / ulSent ) / 1000UL,
+					ulMaxTime / 1000UL,
+					( unsigned long ) ( ( ( uint64_t ) ulSent * 1000000000ULL ) / ( uint64_t ) ulRunTime ) );
+		}
+	}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUDP_DIRECT_SEND */
@@ -49,6 +49,8 @@
 /*#include "TCPEchoClient_SingleTasks.h" */
 /*#include "demo_logging.h" */
 #include "TCPEchoClient_SingleTasks.h"
+#include "TCPLoopbackThroughput.h"
+#include "UDPDirectSendThroughput.h"
 
 /* Simple UDP client and server task parameters. */
 #define mainSIMPLE_UDP_CLIENT_SERVER_TASK_PRIORITY	  ( tskIDLE_PRIORITY )
@@ -76,8 +78,21 @@ same RTOS task).  The IP address of the echo server must be configured using the
 configECHO_SERVER_ADDR0 to configECHO_SERVER_ADDR3 constants in
 FreeRTOSConfig.h.
 
+mainCREATE_TCP_LOOPBACK_THROUGHPUT_TASKS:  When set to 1 a TCP client and server
+task are created that connect through the IP address of this node, and the
+client prints the throughput it measured.  Compare the results with
+ipconfigUSE_LOOPBACK set to 1 and to 0 in FreeRTOSIPConfig.h.
+
+mainCREATE_UDP_DIRECT_SEND_THROUGHPUT_TASKS:  When set to 1 tasks are created
+that send UDP datagrams to the discard port of the echo server, first through
+the IP-task and then with FREERTOS_SO_UDP_DIRECT_SEND, and print the latency of
+FreeRTOS_sendto() and the throughput of both.  Build with "scons --af-packet"
+or "scons --tap", the libpcap driver does not support the option.
+
 */
 #define mainCREATE_TCP_ECHO_TASKS_SINGLE			  1
+#define mainCREATE_TCP_LOOPBACK_THROUGHPUT_TASKS	  0
+#define mainCREATE_UDP_DIRECT_SEND_THROUGHPUT_TASKS	  0
 /*-----------------------------------------------------------*/
 
 /*
@@ -191,6 +206,18 @@ static BaseType_t xTasksAlreadyCreated = pdFALSE;
 			}
 			#endif /* mainCREATE_TCP_ECHO_TASKS_SINGLE */
 
+			#if ( mainCREATE_TCP_LOOPBACK_THROUGHPUT_TASKS == 1 )
+			{
+				vStartTCPLoopbackThroughputTasks( mainECHO_SERVER_TASK_STACK_SIZE, mainECHO_SERVER_TASK_PRIORITY );
+			}
+			#endif /* mainCREATE_TCP_LOOPBACK_THROUGHPUT_TASKS */
+
+			#if ( mainCREATE_UDP_DIRECT_SEND_THROUGHPUT_TASKS == 1 )
+			{
+				vStartUDPDirectSendThroughputTasks( mainECHO_CLIENT_TASK_STACK_SIZE, mainECHO_CLIENT_TASK_PRIORITY );
+			}
+			#endif /* mainCREATE_UDP_DIRECT_SEND_THROUGHPUT_TASKS */
+
 			xTasksAlreadyCreated = pdTRUE;
 		}
 